@@ -0,0 +1,102 @@
+"""
+Reader of the binary columnar files written by ns3::ColumnarAggregator.
+
+The module only uses the standard library and, if available, numpy.  It is
+installed with the python bindings as ``ns.columnar``.  It can also be run as
+a script, which prints the datasets of a file as space separated values::
+
+    python3 ns_columnar.py file.bin [context]
+
+The values are returned as numpy arrays if numpy is available, otherwise as
+lists of floats.
+"""
+
+import struct
+import sys
+
+try:
+    import numpy
+except ImportError:
+    numpy = None
+
+MAGIC = b"NS3COLS\0"
+VERSION = 1
+DATASET = 1
+CHUNK = 2
+
+
+def read_columnar(file_name: str) -> dict:
+    """!
+    Read a columnar file.
+    @param file_name: the name of the file
+    @return a dictionary mapping the context of each dataset to the list of its
+    columns, in the order of the arguments of the Write functions
+    """
+    with open(file_name, "rb") as f:
+        data = f.read()
+
+    if data[0:8] != MAGIC:
+        raise ValueError("%s is not a columnar file" % file_name)
+    # The file is written in the byte order of the machine running ns-3
+    for order in ("<", ">"):
+        if struct.unpack_from(order + "I", data, 8)[0] == VERSION:
+            break
+    else:
+        raise ValueError("%s has an unsupported version" % file_name)
+
+    contexts = {}
+    chunks = {}
+    offset = 16
+    while offset + 8 <= len(data):
+        record_type, length = struct.unpack_from(order + "II", data, offset)
+        payload = offset + 8
+        if payload + length > len(data):
+            raise ValueError("%s is truncated" % file_name)
+        if record_type == DATASET:
+            dataset_id, n_columns, context_length = struct.unpack_from(order + "III", data, payload)
+            context = data[payload + 12 : payload + 12 + context_length].decode()
+            contexts[dataset_id] = context
+            chunks[dataset_id] = [[] for _ in range(n_columns)]
+        elif record_type == CHUNK:
+            dataset_id, n_rows = struct.unpack_from(order + "II", data, payload)
+            columns = chunks[dataset_id]
+            start = payload + 8
+            for column in columns:
+                if numpy is not None:
+                    column.append(numpy.frombuffer(data, numpy.dtype(order + "f8"), n_rows, start))
+                else:
+                    column.append(struct.unpack_from(order + "%dd" % n_rows, data, start))
+                start += 8 * n_rows
+        # The records of unknown types are skipped
+        offset = payload + length
+
+    datasets = {}
+    for dataset_id, context in contexts.items():
+        if numpy is not None:
+            datasets[context] = [
+                numpy.concatenate(column) if column else numpy.empty(0)
+                for column in chunks[dataset_id]
+            ]
+        else:
+            datasets[context] = [
+                [value for chunk in column for value in chunk] for column in chunks[dataset_id]
+            ]
+    return datasets
+
+
+def main(argv):
+    if len(argv) < 2:
+        print("Usage: %s file [context]" % argv[0])
+        return 1
+    datasets = read_columnar(argv[1])
+    for context, columns in datasets.items():
+        if len(argv) > 2 and context != argv[2]:
+            continue
+        print("# %s" % context)
+        for row in zip(*columns):
+            print(" ".join(repr(float(value)) for value in row))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -176,6 +176,9 @@ macro(write_configtable)
   string(APPEND out "SQLite support                : ")
   check_on_or_off("${NS3_SQLITE}" "${ENABLE_SQLITE}")
 
+  string(APPEND out "zlib support                  : ")
+  check_on_or_off("${NS3_ZLIB}" "${ENABLE_ZLIB}")
+
   string(APPEND out "Eigen3 support                : ")
   check_on_or_off("${NS3_EIGEN}" "${ENABLE_EIGEN}")
 
@@ -681,6 +681,18 @@ macro(process_options)
     endif()
   endif()
 
+  set(ENABLE_ZLIB False)
+  if(${NS3_ZLIB})
+    find_package(ZLIB QUIET)
+    if(${ZLIB_FOUND})
+      set(ENABLE_ZLIB True)
+      add_definitions(-DHAVE_ZLIB)
+      include_directories(${ZLIB_INCLUDE_DIRS})
+    else()
+      message(${HIGHLIGHTED_STATUS} "zlib was not found")
+    endif()
+  endif()
+
   if(${NS3_NATIVE_OPTIMIZATIONS} AND ${GCC})
     add_compile_options(-march=native -mtune=native)
   endif()
@@ -923,6 +935,9 @@ macro(process_options)
       configure_file(
         bindings/python/ns__init__.py ${destination_dir}/__init__.py COPYONLY
       )
+      configure_file(
+        bindings/python/ns_columnar.py ${destination_dir}/columnar.py COPYONLY
+      )
 
       # And create an install target for the bindings
       if(NOT NS3_BINDINGS_INSTALL_DIR)
@@ -951,6 +966,9 @@ macro(process_options)
         install(FILES bindings/python/ns__init__.py
                 DESTINATION ${NS3_BINDINGS_INSTALL_DIR}/ns RENAME __init__.py
         )
+        install(FILES bindings/python/ns_columnar.py
+                DESTINATION ${NS3_BINDINGS_INSTALL_DIR}/ns RENAME columnar.py
+        )
         add_custom_target(
           uninstall_bindings COMMAND rm -R ${NS3_BINDINGS_INSTALL_DIR}/ns
         )
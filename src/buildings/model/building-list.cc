@@ -28,6 +28,11 @@
 #include "ns3/object-vector.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
 namespace ns3
 {
 
@@ -78,6 +83,29 @@ class BuildingListPriv : public Object
      */
     uint32_t GetNBuildings();
 
+    /**
+     * Invalidate the grid index, which is rebuilt at the next query
+     */
+    void InvalidateGrid();
+
+    /**
+     * Gets the buildings containing a position
+     * \param position the position
+     * \returns the buildings containing the position, sorted by id
+     */
+    std::vector<Ptr<Building>> GetBuildingsContaining(const Vector& position);
+
+    /**
+     * Gets the buildings intersected by a line segment
+     * \param l1 the first end of the line segment
+     * \param l2 the second end of the line segment
+     * \param stopAtFirst if true, return as soon as an intersecting building is found
+     * \returns the buildings intersected by the line segment, sorted by id
+     */
+    std::vector<Ptr<Building>> GetIntersectingBuildings(const Vector& l1,
+                                                        const Vector& l2,
+                                                        bool stopAtFirst);
+
     /**
      * Get the Singleton instance of BuildingListPriv (or create one)
      * \return the BuildingListPriv instance
@@ -98,7 +126,56 @@ class BuildingListPriv : public Object
      *
      */
     static void Delete();
+
+    /**
+     * Build the uniform grid over the footprints of the buildings, if it is
+     * not up to date.
+     *
+     * The grid covers the bounding rectangle of all the buildings and its
+     * cell size is chosen so that there is about one building per cell.
+     * Each building is registered in every cell overlapped by its footprint.
+     */
+    void UpdateGrid();
+
+    /**
+     * \param x the x coordinate
+     * \returns the index of the grid column containing x, clamped to the grid
+     */
+    uint32_t GetColumn(double x) const;
+
+    /**
+     * \param y the y coordinate
+     * \returns the index of the grid row containing y, clamped to the grid
+     */
+    uint32_t GetRow(double y) const;
+
+    /**
+     * Invoke a function on each building registered in the grid cells
+     * crossed by the 2D projection of a line segment. Each building is
+     * visited at most once. The set of cells is conservative, i.e., it may
+     * include cells adjacent to the segment.
+     *
+     * \param l1 the first end of the line segment
+     * \param l2 the second end of the line segment
+     * \param visit the function to invoke; the visit stops when it returns true
+     */
+    void VisitSegmentCandidates(const Vector& l1,
+                                const Vector& l2,
+                                const std::function<bool(Ptr<Building>)>& visit);
+
     std::vector<Ptr<Building>> m_buildings; //!< Container of Building
+
+    bool m_gridValid{false};                   //!< true if the grid index is up to date
+    double m_gridXMin{0};                      //!< x coordinate of the grid origin
+    double m_gridYMin{0};                      //!< y coordinate of the grid origin
+    double m_gridXMax{0};                      //!< maximum x coordinate covered by the grid
+    double m_gridYMax{0};                      //!< maximum y coordinate covered by the grid
+    double m_cellSize{1};                      //!< side of the (square) grid cells
+    uint32_t m_nColumns{0};                    //!< number of grid columns
+    uint32_t m_nRows{0};                       //!< number of grid rows
+    std::vector<std::vector<uint32_t>> m_grid; //!< building indices per cell, row-major
+    std::vector<uint32_t> m_visitStamp;        //!< last query in which each building was visited
+    uint32_t m_currentStamp{0};                //!< stamp of the current query
 };
 
 NS_OBJECT_ENSURE_REGISTERED(BuildingListPriv);
@@ -165,6 +242,9 @@ BuildingListPriv::DoDispose()
         *i = nullptr;
     }
     m_buildings.erase(m_buildings.begin(), m_buildings.end());
+    m_grid.clear();
+    m_visitStamp.clear();
+    m_gridValid = false;
     Object::DoDispose();
 }
 
@@ -173,6 +253,7 @@ BuildingListPriv::Add(Ptr<Building> building)
 {
     uint32_t index = m_buildings.size();
     m_buildings.push_back(building);
+    m_gridValid = false;
     Simulator::ScheduleWithContext(index, TimeStep(0), &Building::Initialize, building);
     return index;
 }
@@ -204,6 +285,204 @@ BuildingListPriv::GetBuilding(uint32_t n)
     return m_buildings.at(n);
 }
 
+void
+BuildingListPriv::InvalidateGrid()
+{
+    m_gridValid = false;
+}
+
+void
+BuildingListPriv::UpdateGrid()
+{
+    if (m_gridValid)
+    {
+        return;
+    }
+    NS_LOG_FUNCTION(this << m_buildings.size());
+
+    m_grid.clear();
+    m_visitStamp.assign(m_buildings.size(), 0);
+    m_currentStamp = 0;
+    m_gridValid = true;
+    if (m_buildings.empty())
+    {
+        m_nColumns = 0;
+        m_nRows = 0;
+        return;
+    }
+
+    m_gridXMin = std::numeric_limits<double>::max();
+    m_gridYMin = std::numeric_limits<double>::max();
+    m_gridXMax = std::numeric_limits<double>::lowest();
+    m_gridYMax = std::numeric_limits<double>::lowest();
+    for (const auto& building : m_buildings)
+    {
+        Box box = building->GetBoundaries();
+        m_gridXMin = std::min(m_gridXMin, box.xMin);
+        m_gridYMin = std::min(m_gridYMin, box.yMin);
+        m_gridXMax = std::max(m_gridXMax, box.xMax);
+        m_gridYMax = std::max(m_gridYMax, box.yMax);
+    }
+
+    // about one building per cell, but no more than maxCellsPerSide cells per side
+    const double maxCellsPerSide = 1024;
+    double width = m_gridXMax - m_gridXMin;
+    double height = m_gridYMax - m_gridYMin;
+    m_cellSize = std::sqrt(width * height / m_buildings.size());
+    m_cellSize = std::max(m_cellSize, std::max(width, height) / maxCellsPerSide);
+    if (m_cellSize <= 0)
+    {
+        // all the buildings lie on a single point
+        m_cellSize = 1;
+    }
+    m_nColumns = static_cast<uint32_t>(std::floor(width / m_cellSize)) + 1;
+    m_nRows = static_cast<uint32_t>(std::floor(height / m_cellSize)) + 1;
+    m_grid.resize(static_cast<size_t>(m_nColumns) * m_nRows);
+
+    for (uint32_t index = 0; index < m_buildings.size(); ++index)
+    {
+        Box box = m_buildings[index]->GetBoundaries();
+        for (uint32_t row = GetRow(box.yMin); row <= GetRow(box.yMax); ++row)
+        {
+            for (uint32_t col = GetColumn(box.xMin); col <= GetColumn(box.xMax); ++col)
+            {
+                m_grid[static_cast<size_t>(row) * m_nColumns + col].push_back(index);
+            }
+        }
+    }
+    NS_LOG_LOGIC("Grid of " << m_nColumns << "x" << m_nRows << " cells of size " << m_cellSize
+                            << " for " << m_buildings.size() << " buildings");
+}
+
+uint32_t
+BuildingListPriv::GetColumn(double x) const
+{
+    double col = std::floor((x - m_gridXMin) / m_cellSize);
+    return static_cast<uint32_t>(std::clamp(col, 0.0, m_nColumns - 1.0));
+}
+
+uint32_t
+BuildingListPriv::GetRow(double y) const
+{
+    double row = std::floor((y - m_gridYMin) / m_cellSize);
+    return static_cast<uint32_t>(std::clamp(row, 0.0, m_nRows - 1.0));
+}
+
+std::vector<Ptr<Building>>
+BuildingListPriv::GetBuildingsContaining(const Vector& position)
+{
+    UpdateGrid();
+    std::vector<Ptr<Building>> buildings;
+    if (m_buildings.empty() || position.x < m_gridXMin || position.x > m_gridXMax ||
+        position.y < m_gridYMin || position.y > m_gridYMax)
+    {
+        return buildings;
+    }
+    const auto& cell =
+        m_grid[static_cast<size_t>(GetRow(position.y)) * m_nColumns + GetColumn(position.x)];
+    for (uint32_t index : cell)
+    {
+        if (m_buildings[index]->IsInside(position))
+        {
+            buildings.push_back(m_buildings[index]);
+        }
+    }
+    return buildings;
+}
+
+void
+BuildingListPriv::VisitSegmentCandidates(const Vector& l1,
+                                         const Vector& l2,
+                                         const std::function<bool(Ptr<Building>)>& visit)
+{
+    UpdateGrid();
+    if (m_buildings.empty())
+    {
+        return;
+    }
+
+    // margin used to make the selection of the cells robust to rounding errors
+    const double margin = 1e-6 * m_cellSize;
+    double xLow = std::min(l1.x, l2.x);
+    double xHigh = std::max(l1.x, l2.x);
+    double yLow = std::min(l1.y, l2.y);
+    double yHigh = std::max(l1.y, l2.y);
+    if (xHigh < m_gridXMin - margin || xLow > m_gridXMax + margin ||
+        yHigh < m_gridYMin - margin || yLow > m_gridYMax + margin)
+    {
+        return;
+    }
+
+    if (++m_currentStamp == 0)
+    {
+        std::fill(m_visitStamp.begin(), m_visitStamp.end(), 0);
+        m_currentStamp = 1;
+    }
+
+    // walk the columns crossed by the segment and, in each of them, the rows
+    // spanned by the portion of the segment falling in the column
+    double dx = l2.x - l1.x;
+    double dy = l2.y - l1.y;
+    uint32_t firstCol = GetColumn(xLow - margin);
+    uint32_t lastCol = GetColumn(xHigh + margin);
+    for (uint32_t col = firstCol; col <= lastCol; ++col)
+    {
+        double rowYLow = yLow;
+        double rowYHigh = yHigh;
+        if (std::abs(dx) > margin)
+        {
+            double colXLow = std::max(xLow, m_gridXMin + col * m_cellSize);
+            double colXHigh = std::min(xHigh, m_gridXMin + (col + 1) * m_cellSize);
+            if (col == firstCol)
+            {
+                colXLow = xLow;
+            }
+            if (col == lastCol)
+            {
+                colXHigh = xHigh;
+            }
+            double yA = l1.y + (colXLow - l1.x) * dy / dx;
+            double yB = l1.y + (colXHigh - l1.x) * dy / dx;
+            rowYLow = std::max(yLow, std::min(yA, yB));
+            rowYHigh = std::min(yHigh, std::max(yA, yB));
+        }
+        for (uint32_t row = GetRow(rowYLow - margin); row <= GetRow(rowYHigh + margin); ++row)
+        {
+            for (uint32_t index : m_grid[static_cast<size_t>(row) * m_nColumns + col])
+            {
+                if (m_visitStamp[index] == m_currentStamp)
+                {
+                    continue;
+                }
+                m_visitStamp[index] = m_currentStamp;
+                if (visit(m_buildings[index]))
+                {
+                    return;
+                }
+            }
+        }
+    }
+}
+
+std::vector<Ptr<Building>>
+BuildingListPriv::GetIntersectingBuildings(const Vector& l1, const Vector& l2, bool stopAtFirst)
+{
+    std::vector<Ptr<Building>> buildings;
+    VisitSegmentCandidates(l1, l2, [&](Ptr<Building> building) {
+        if (building->IsIntersect(l1, l2))
+        {
+            buildings.push_back(building);
+            return stopAtFirst;
+        }
+        return false;
+    });
+    auto byId = [](const Ptr<Building>& a, const Ptr<Building>& b) {
+        return a->GetId() < b->GetId();
+    };
+    std::sort(buildings.begin(), buildings.end(), byId);
+    return buildings;
+}
+
 } // namespace ns3
 
 /**
@@ -244,4 +523,28 @@ BuildingList::GetNBuildings()
     return BuildingListPriv::Get()->GetNBuildings();
 }
 
+void
+BuildingList::NotifyBoundariesChanged()
+{
+    BuildingListPriv::Get()->InvalidateGrid();
+}
+
+std::vector<Ptr<Building>>
+BuildingList::GetBuildingsContaining(const Vector& position)
+{
+    return BuildingListPriv::Get()->GetBuildingsContaining(position);
+}
+
+std::vector<Ptr<Building>>
+BuildingList::GetIntersectingBuildings(const Vector& l1, const Vector& l2)
+{
+    return BuildingListPriv::Get()->GetIntersectingBuildings(l1, l2, false);
+}
+
+bool
+BuildingList::IsIntersectingAnyBuilding(const Vector& l1, const Vector& l2)
+{
+    return !BuildingListPriv::Get()->GetIntersectingBuildings(l1, l2, true).empty();
+}
+
 } // namespace ns3
@@ -23,6 +23,7 @@
 #define BUILDING_LIST_H_
 
 #include "ns3/ptr.h"
+#include "ns3/vector.h"
 
 #include <vector>
 
@@ -67,6 +68,41 @@ class BuildingList
      * \returns the number of buildings currently in the list.
      */
     static uint32_t GetNBuildings();
+    /**
+     * Invalidate the spatial index of the buildings, which is rebuilt
+     * at the next query.
+     *
+     * This method is called automatically from Building::SetBoundaries so
+     * the user has little reason to call it himself.
+     */
+    static void NotifyBoundariesChanged();
+    /**
+     * \param position the position to check.
+     * \returns the buildings whose boundaries contain the given position,
+     *          sorted by building id.
+     *
+     * The query is resolved through a uniform grid built over the footprints
+     * of the buildings, hence only the buildings overlapping the grid cell
+     * of the position are checked.
+     */
+    static std::vector<Ptr<Building>> GetBuildingsContaining(const Vector& position);
+    /**
+     * \param l1 the first end of the line segment.
+     * \param l2 the second end of the line segment.
+     * \returns the buildings intersected by the line segment between l1 and
+     *          l2, sorted by building id.
+     *
+     * Only the buildings overlapping the grid cells crossed by the line
+     * segment are checked.
+     */
+    static std::vector<Ptr<Building>> GetIntersectingBuildings(const Vector& l1, const Vector& l2);
+    /**
+     * \param l1 the first end of the line segment.
+     * \param l2 the second end of the line segment.
+     * \returns true if the line segment between l1 and l2 intersects at
+     *          least one building.
+     */
+    static bool IsIntersectingAnyBuilding(const Vector& l1, const Vector& l2);
 };
 
 } // namespace ns3
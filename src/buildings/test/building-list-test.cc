@@ -0,0 +1,194 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/building-list.h"
+#include "ns3/building.h"
+#include "ns3/log.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("BuildingListTest");
+
+/**
+ * \ingroup building-test
+ * \ingroup tests
+ *
+ * Test that the spatial queries of the BuildingList, which are resolved
+ * through a grid index, return the same buildings found by checking all
+ * the buildings in the list one by one.
+ */
+class BuildingListQueryTestCase : public TestCase
+{
+  public:
+    BuildingListQueryTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Get the buildings containing a position by checking all the buildings
+     * \param position the position
+     * \return the buildings containing the position, sorted by id
+     */
+    std::vector<Ptr<Building>> BruteForceContaining(const Vector& position) const;
+
+    /**
+     * Get the buildings intersected by a line segment by checking all the buildings
+     * \param l1 the first end of the line segment
+     * \param l2 the second end of the line segment
+     * \return the buildings intersected by the line segment, sorted by id
+     */
+    std::vector<Ptr<Building>> BruteForceIntersecting(const Vector& l1, const Vector& l2) const;
+};
+
+BuildingListQueryTestCase::BuildingListQueryTestCase()
+    : TestCase("Check the grid-based BuildingList queries against a linear search")
+{
+}
+
+std::vector<Ptr<Building>>
+BuildingListQueryTestCase::BruteForceContaining(const Vector& position) const
+{
+    std::vector<Ptr<Building>> buildings;
+    for (auto bit = BuildingList::Begin(); bit != BuildingList::End(); ++bit)
+    {
+        if ((*bit)->IsInside(position))
+        {
+            buildings.push_back(*bit);
+        }
+    }
+    return buildings;
+}
+
+std::vector<Ptr<Building>>
+BuildingListQueryTestCase::BruteForceIntersecting(const Vector& l1, const Vector& l2) const
+{
+    std::vector<Ptr<Building>> buildings;
+    for (auto bit = BuildingList::Begin(); bit != BuildingList::End(); ++bit)
+    {
+        if ((*bit)->IsIntersect(l1, l2))
+        {
+            buildings.push_back(*bit);
+        }
+    }
+    return buildings;
+}
+
+void
+BuildingListQueryTestCase::DoRun()
+{
+    NS_TEST_ASSERT_MSG_EQ(BuildingList::GetBuildingsContaining(Vector(0, 0, 0)).size(),
+                          0,
+                          "No building should be found in an empty list");
+    NS_TEST_ASSERT_MSG_EQ(BuildingList::IsIntersectingAnyBuilding(Vector(0, 0, 0),
+                                                                  Vector(10, 10, 0)),
+                          false,
+                          "No building should be intersected in an empty list");
+
+    Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable>();
+    rv->SetStream(1);
+
+    // a city block layout, with buildings of random size and height placed in
+    // 20x20 m lots, some of them sharing their walls with the neighbors
+    for (uint32_t i = 0; i < 20; i++)
+    {
+        for (uint32_t j = 0; j < 20; j++)
+        {
+            double xMin = i * 20 + rv->GetInteger(0, 3);
+            double yMin = j * 20 + rv->GetInteger(0, 3);
+            double xMax = (i + 1) * 20 - rv->GetInteger(0, 3);
+            double yMax = (j + 1) * 20 - rv->GetInteger(0, 3);
+            Ptr<Building> b = CreateObject<Building>();
+            b->SetBoundaries(Box(xMin, xMax, yMin, yMax, 0, rv->GetValue(3, 30)));
+        }
+    }
+    // a large building spanning several lots
+    Ptr<Building> large = CreateObject<Building>();
+    large->SetBoundaries(Box(-50, 150, 410, 500, 0, 60));
+
+    for (uint32_t k = 0; k < 2000; k++)
+    {
+        // random positions, and positions on the lot boundaries
+        Vector position(rv->GetValue(-60, 460), rv->GetValue(-60, 520), rv->GetValue(0, 40));
+        if (k % 4 == 0)
+        {
+            position.x = 20 * rv->GetInteger(0, 20);
+        }
+        bool sameBuildings =
+            BuildingList::GetBuildingsContaining(position) == BruteForceContaining(position);
+        NS_TEST_ASSERT_MSG_EQ(sameBuildings,
+                              true,
+                              "Wrong buildings containing " << position);
+
+        // random segments, and axis-aligned segments on the lot boundaries
+        Vector l1(rv->GetValue(-60, 460), rv->GetValue(-60, 520), rv->GetValue(1, 40));
+        Vector l2(rv->GetValue(-60, 460), rv->GetValue(-60, 520), rv->GetValue(1, 40));
+        if (k % 4 == 1)
+        {
+            l1.x = 20 * rv->GetInteger(0, 20);
+            l2.x = l1.x;
+        }
+        else if (k % 4 == 2)
+        {
+            l1.y = 20 * rv->GetInteger(0, 20);
+            l2.y = l1.y;
+        }
+        std::vector<Ptr<Building>> expected = BruteForceIntersecting(l1, l2);
+        sameBuildings = BuildingList::GetIntersectingBuildings(l1, l2) == expected;
+        NS_TEST_ASSERT_MSG_EQ(sameBuildings,
+                              true,
+                              "Wrong buildings intersecting the segment " << l1 << " - " << l2);
+        NS_TEST_ASSERT_MSG_EQ(BuildingList::IsIntersectingAnyBuilding(l1, l2),
+                              !expected.empty(),
+                              "Wrong intersection of the segment " << l1 << " - " << l2);
+    }
+
+    // moving a building must be reflected by the index
+    large->SetBoundaries(Box(1000, 1010, 1000, 1010, 0, 10));
+    NS_TEST_ASSERT_MSG_EQ(BuildingList::GetBuildingsContaining(Vector(1005, 1005, 5)).size(),
+                          1,
+                          "The moved building should be found in its new position");
+    NS_TEST_ASSERT_MSG_EQ(BuildingList::GetBuildingsContaining(Vector(-40, 450, 5)).size(),
+                          0,
+                          "The moved building should not be found in its old position");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup building-test
+ * \ingroup tests
+ *
+ * \brief BuildingList TestSuite
+ */
+class BuildingListTestSuite : public TestSuite
+{
+  public:
+    BuildingListTestSuite();
+};
+
+BuildingListTestSuite::BuildingListTestSuite()
+    : TestSuite("building-list", UNIT)
+{
+    AddTestCase(new BuildingListQueryTestCase, TestCase::QUICK);
+}
+
+/// Static variable for test initialization
+static BuildingListTestSuite g_buildingListTestSuite;
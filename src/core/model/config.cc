@@ -25,8 +25,14 @@
 #include "object.h"
 #include "pointer.h"
 #include "singleton.h"
+#include "trace-source-accessor.h"
 
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <map>
 #include <sstream>
+#include <unordered_map>
 
 /**
  * \file
@@ -197,6 +203,8 @@ MatchContainer::DisconnectWithoutContext(std::string name, const CallbackBase& c
 /**
  * \ingroup config-impl
  * Helper to test if an array entry matches a config path specification.
+ *
+ * The specification is parsed once, when the matcher is constructed.
  */
 class ArrayMatcher
 {
@@ -214,8 +222,22 @@ class ArrayMatcher
      * \returns \c true if the index matches the Config Path.
      */
     bool Matches(std::size_t i) const;
+    /**
+     * Get the index matched by the Config path specification, if it matches
+     * a single index.
+     *
+     * \param [out] index The index.
+     * \returns \c true if the specification matches a single index.
+     */
+    bool GetIndex(std::size_t* index) const;
 
   private:
+    /**
+     * Parse a Config path specification, or an alternative of it.
+     *
+     * \param [in] element The Config path specification.
+     */
+    void Parse(std::string element);
     /**
      * Convert a string to an \c uint32_t.
      *
@@ -226,77 +248,96 @@ class ArrayMatcher
     bool StringToUint32(std::string str, uint32_t* value) const;
     /** The Config path element. */
     std::string m_element;
+    /** Whether the element matches all the indexes. */
+    bool m_all;
+    /** The ranges of indexes matched by the element, as [min, max] pairs. */
+    std::vector<std::pair<uint32_t, uint32_t>> m_ranges;
 
 }; // class ArrayMatcher
 
 ArrayMatcher::ArrayMatcher(std::string element)
-    : m_element(element)
+    : m_element(element),
+      m_all(false)
 {
     NS_LOG_FUNCTION(this << element);
+    Parse(element);
 }
 
-bool
-ArrayMatcher::Matches(std::size_t i) const
+void
+ArrayMatcher::Parse(std::string element)
 {
-    NS_LOG_FUNCTION(this << i);
-    if (m_element == "*")
+    NS_LOG_FUNCTION(this << element);
+    if (element == "*")
     {
-        NS_LOG_DEBUG("Array " << i << " matches *");
-        return true;
+        m_all = true;
+        return;
     }
     std::string::size_type tmp;
-    tmp = m_element.find('|');
+    tmp = element.find('|');
     if (tmp != std::string::npos)
     {
-        std::string left = m_element.substr(0, tmp - 0);
-        std::string right = m_element.substr(tmp + 1, m_element.size() - (tmp + 1));
-        ArrayMatcher matcher = ArrayMatcher(left);
-        if (matcher.Matches(i))
-        {
-            NS_LOG_DEBUG("Array " << i << " matches " << left);
-            return true;
-        }
-        matcher = ArrayMatcher(right);
-        if (matcher.Matches(i))
-        {
-            NS_LOG_DEBUG("Array " << i << " matches " << right);
-            return true;
-        }
-        NS_LOG_DEBUG("Array " << i << " does not match " << m_element);
-        return false;
+        std::string left = element.substr(0, tmp - 0);
+        std::string right = element.substr(tmp + 1, element.size() - (tmp + 1));
+        Parse(left);
+        Parse(right);
+        return;
     }
-    std::string::size_type leftBracket = m_element.find('[');
-    std::string::size_type rightBracket = m_element.find(']');
-    std::string::size_type dash = m_element.find('-');
-    if (leftBracket == 0 && rightBracket == m_element.size() - 1 && dash > leftBracket &&
+    std::string::size_type leftBracket = element.find('[');
+    std::string::size_type rightBracket = element.find(']');
+    std::string::size_type dash = element.find('-');
+    if (leftBracket == 0 && rightBracket == element.size() - 1 && dash > leftBracket &&
         dash < rightBracket)
     {
-        std::string lowerBound = m_element.substr(leftBracket + 1, dash - (leftBracket + 1));
-        std::string upperBound = m_element.substr(dash + 1, rightBracket - (dash + 1));
+        std::string lowerBound = element.substr(leftBracket + 1, dash - (leftBracket + 1));
+        std::string upperBound = element.substr(dash + 1, rightBracket - (dash + 1));
         uint32_t min;
         uint32_t max;
-        if (StringToUint32(lowerBound, &min) && StringToUint32(upperBound, &max) && i >= min &&
-            i <= max)
+        if (StringToUint32(lowerBound, &min) && StringToUint32(upperBound, &max))
         {
-            NS_LOG_DEBUG("Array " << i << " matches " << m_element);
-            return true;
-        }
-        else
-        {
-            NS_LOG_DEBUG("Array " << i << " does not " << m_element);
-            return false;
+            m_ranges.emplace_back(min, max);
         }
+        return;
     }
     uint32_t value;
-    if (StringToUint32(m_element, &value) && i == value)
+    if (StringToUint32(element, &value))
+    {
+        m_ranges.emplace_back(value, value);
+    }
+}
+
+bool
+ArrayMatcher::Matches(std::size_t i) const
+{
+    NS_LOG_FUNCTION(this << i);
+    if (m_all)
     {
-        NS_LOG_DEBUG("Array " << i << " matches " << m_element);
+        NS_LOG_DEBUG("Array " << i << " matches *");
         return true;
     }
+    for (const auto& range : m_ranges)
+    {
+        if (i >= range.first && i <= range.second)
+        {
+            NS_LOG_DEBUG("Array " << i << " matches " << m_element);
+            return true;
+        }
+    }
     NS_LOG_DEBUG("Array " << i << " does not match " << m_element);
     return false;
 }
 
+bool
+ArrayMatcher::GetIndex(std::size_t* index) const
+{
+    NS_LOG_FUNCTION(this << index);
+    if (m_all || m_ranges.size() != 1 || m_ranges[0].first != m_ranges[0].second)
+    {
+        return false;
+    }
+    *index = m_ranges[0].first;
+    return true;
+}
+
 bool
 ArrayMatcher::StringToUint32(std::string str, uint32_t* value) const
 {
@@ -309,145 +350,380 @@ ArrayMatcher::StringToUint32(std::string str, uint32_t* value) const
 
 /**
  * \ingroup config-impl
- * Abstract class to parse Config paths into object references.
+ * An attribute leading to the objects matched by an element of a Config
+ * path.
+ */
+struct PathAttribute
+{
+    std::string name; //!< Name of the attribute
+    bool container;   //!< Whether the attribute is a container, or a pointer
+    /** Accessor used to get a pointer, or null to use ObjectBase::GetAttribute. */
+    Ptr<const AttributeAccessor> accessor;
+    /** Accessor used to get a container, or null to use ObjectBase::GetAttribute. */
+    Ptr<const ObjectPtrContainerAccessor> containerAccessor;
+};
+
+/**
+ * \ingroup config-impl
+ * The attributes matched by an element of a Config path, by uid of the
+ * instance TypeId of the objects.
+ */
+typedef std::unordered_map<uint16_t, std::vector<PathAttribute>> PathAttributeCache;
+
+/**
+ * \ingroup config-impl
+ * The trace sources named by the last element of a Config path, by uid of
+ * the instance TypeId of the objects.
+ */
+typedef std::unordered_map<uint16_t, Ptr<const TraceSourceAccessor>> PathTraceSourceCache;
+
+/**
+ * \ingroup config-impl
+ * The attributes named by the last element of a Config path, by uid of the
+ * instance TypeId of the objects.  The accessor of an attribute is null if
+ * it does not exist.
+ */
+typedef std::unordered_map<uint16_t, TypeId::AttributeInformation> PathSetCache;
+
+/**
+ * \ingroup config-impl
+ * Find the pointer and container attributes matched by an element of a
+ * Config path, in a TypeId and its parents.
+ *
+ * \param [in] instanceTid The instance TypeId of the objects.
+ * \param [in] item The element of the path.
+ * \returns The attributes.
+ */
+static std::vector<PathAttribute>
+FindPathAttributes(TypeId instanceTid, const std::string& item)
+{
+    NS_LOG_FUNCTION(instanceTid << item);
+    std::vector<PathAttribute> attributes;
+    TypeId tid;
+    TypeId nextTid = instanceTid;
+    do
+    {
+        tid = nextTid;
+        for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+        {
+            TypeId::AttributeInformation info = tid.GetAttribute(i);
+            if (info.name != item && item != "*")
+            {
+                continue;
+            }
+            PathAttribute attribute;
+            if (dynamic_cast<const PointerChecker*>(PeekPointer(info.checker)) != nullptr)
+            {
+                attribute.container = false;
+            }
+            else if (dynamic_cast<const ObjectPtrContainerChecker*>(PeekPointer(info.checker)) !=
+                     nullptr)
+            {
+                attribute.container = true;
+            }
+            else
+            {
+                // this could be anything else and we don't know what to do with it.
+                // So, we just ignore it.
+                continue;
+            }
+            attribute.name = info.name;
+            // The attribute is read as ObjectBase::GetAttribute reads it, which
+            // reports the errors if it cannot be read directly.
+            TypeId::AttributeInformation resolved;
+            if (instanceTid.LookupAttributeByName(info.name, &resolved) &&
+                (resolved.flags & TypeId::ATTR_GET) && resolved.accessor->HasGetter())
+            {
+                attribute.accessor = resolved.accessor;
+                attribute.containerAccessor =
+                    DynamicCast<const ObjectPtrContainerAccessor>(resolved.accessor);
+            }
+            attributes.push_back(attribute);
+        }
+        nextTid = tid.GetParent();
+    } while (nextTid != tid);
+    return attributes;
+}
+
+/**
+ * \ingroup config-impl
+ * Config system implementation class.
  */
-class Resolver
+class ConfigImpl : public Singleton<ConfigImpl>
 {
   public:
-    /**
-     * Construct from a base Config path.
-     *
-     * \param [in] path The Config path.
-     */
-    Resolver(std::string path);
-    /** Destructor. */
-    virtual ~Resolver();
+    // Keep Set and SetFailSafe since their errors are triggered
+    // by the underlying ObjectBase functions.
+    /** \copydoc ns3::Config::Set() */
+    void Set(std::string path, const AttributeValue& value);
+    /** \copydoc ns3::Config::SetFailSafe() */
+    bool SetFailSafe(std::string path, const AttributeValue& value);
+    /** \copydoc ns3::Config::ConnectWithoutContextFailSafe() */
+    bool ConnectWithoutContextFailSafe(std::string path, const CallbackBase& cb);
+    /** \copydoc ns3::Config::ConnectFailSafe() */
+    bool ConnectFailSafe(std::string path, const CallbackBase& cb);
+    /** \copydoc ns3::Config::DisconnectWithoutContext() */
+    void DisconnectWithoutContext(std::string path, const CallbackBase& cb);
+    /** \copydoc ns3::Config::Disconnect() */
+    void Disconnect(std::string path, const CallbackBase& cb);
+    /** \copydoc ns3::Config::LookupMatches() */
+    MatchContainer LookupMatches(std::string path);
 
-    /**
-     * Parse the stored Config path into an object reference,
-     * beginning at the indicated root object.
-     *
-     * \param [in] root The object corresponding to the current position in
-     *                  in the Config path.
-     */
-    void Resolve(Ptr<Object> root);
+    /** \copydoc ns3::Config::RegisterRootNamespaceObject() */
+    void RegisterRootNamespaceObject(Ptr<Object> obj);
+    /** \copydoc ns3::Config::UnregisterRootNamespaceObject() */
+    void UnregisterRootNamespaceObject(Ptr<Object> obj);
+
+    /** \copydoc ns3::Config::GetRootNamespaceObjectN() */
+    std::size_t GetRootNamespaceObjectN() const;
+    /** \copydoc ns3::Config::GetRootNamespaceObject() */
+    Ptr<Object> GetRootNamespaceObject(std::size_t i) const;
 
-  private:
-    /** Ensure the Config path starts and ends with a '/'. */
-    void Canonicalize();
     /**
-     * Parse the next element in the Config path.
-     *
-     * \param [in] path The remaining portion of the Config path.
-     * \param [in] root The object corresponding to the current position
-     *                  in the Config path.
+     * Get the cache of the attributes matched by an element of a path.
+     * \param [in] item The element of the path.
+     * \returns The cache, which lives as long as the ConfigImpl.
      */
-    void DoResolve(std::string path, Ptr<Object> root);
+    PathAttributeCache& GetAttributeCache(const std::string& item);
     /**
-     * Parse an index on the Config path.
-     *
-     * \param [in] path The remaining Config path.
-     * \param [in,out] vector The resulting list of matching objects.
+     * Get the cache of the trace sources named by the last element of a path.
+     * \param [in] name The last element of the path.
+     * \returns The cache, which lives as long as the ConfigImpl.
      */
-    void DoArrayResolve(std::string path, const ObjectPtrContainerValue& vector);
+    PathTraceSourceCache& GetTraceSourceCache(const std::string& name);
     /**
-     * Handle one object found on the path.
-     *
-     * \param [in] object The current object on the Config path.
+     * Get the cache of the attributes named by the last element of a path.
+     * \param [in] name The last element of the path.
+     * \returns The cache, which lives as long as the ConfigImpl.
      */
-    void DoResolveOne(Ptr<Object> object);
+    PathSetCache& GetSetCache(const std::string& name);
+
+    /** \copydoc ns3::Config::EnableTimingReport() */
+    void EnableTimingReport(bool enable);
+    /** \copydoc ns3::Config::PrintTimingReport() */
+    void PrintTimingReport(std::ostream& os) const;
+
+  private:
+    /** ConfigCallTimer records the measures. */
+    friend class ConfigCallTimer;
+
+    /** The measures of the calls of a function on a path. */
+    struct Timing
+    {
+        uint64_t calls{0};   //!< Number of calls
+        uint64_t objects{0}; //!< Number of objects matched by the calls
+        int64_t totalNs{0};  //!< Total time of the calls, in nanoseconds
+        int64_t maxNs{0};    //!< Time of the longest call, in nanoseconds
+    };
+
+    /** Container type to hold the root Config path tokens. */
+    typedef std::vector<Ptr<Object>> Roots;
+
+    /** The list of Config path roots. */
+    Roots m_roots;
+
+    /** The attributes matched by the elements of the paths, by element. */
+    std::unordered_map<std::string, PathAttributeCache> m_attributeCaches;
+    /** The trace sources named by the last elements of the paths, by name. */
+    std::unordered_map<std::string, PathTraceSourceCache> m_traceSourceCaches;
+    /** The attributes named by the last elements of the paths, by name. */
+    std::unordered_map<std::string, PathSetCache> m_setCaches;
+
+    bool m_timingEnabled{false};    //!< Whether the calls are measured
+    uint32_t m_timingDepth{0};      //!< Number of measured calls in progress
+    std::size_t m_timingObjectN{0}; //!< Number of objects matched by the current call
+    /** The measures, by function and path. */
+    std::map<std::pair<std::string, std::string>, Timing> m_timings;
+
+}; // class ConfigImpl
+
+/**
+ * \ingroup config-impl
+ * Measure the time taken by a call to a Config function, if
+ * Config::EnableTimingReport was called.
+ *
+ * The calls made while measuring another call, e.g., by Config::Set to
+ * Config::Path::Set, are part of the outer call.
+ */
+class ConfigCallTimer
+{
+  public:
     /**
-     * Get the current Config path.
+     * Start measuring a call.
      *
-     * \returns The current Config path.
+     * \param [in] function The name of the function.
+     * \param [in] path The path given to the function.
      */
-    std::string GetResolvedPath() const;
+    ConfigCallTimer(const char* function, const std::string& path);
+    /** Stop measuring the call, and record the measure. */
+    ~ConfigCallTimer();
     /**
-     * Handle one found object.
-     *
-     * \param [in] object The found object.
-     * \param [in] path The matching Config path context.
+     * Set the number of objects matched by the call.
+     * \param [in] n The number of objects.
      */
-    virtual void DoOne(Ptr<Object> object, std::string path) = 0;
+    void SetObjectN(std::size_t n);
 
-    /** Current list of path tokens. */
-    std::vector<std::string> m_workStack;
-    /** The Config path. */
-    std::string m_path;
+  private:
+    ConfigImpl* m_impl;        //!< The Config implementation
+    const char* m_function;    //!< The name of the function
+    const std::string& m_path; //!< The path given to the function
+    bool m_counted;            //!< Whether the call is measured, maybe as part of another one
+    bool m_outermost;          //!< Whether the call is not part of another measured call
+    /** The start of the call. */
+    std::chrono::steady_clock::time_point m_start;
+};
+
+ConfigCallTimer::ConfigCallTimer(const char* function, const std::string& path)
+    : m_impl(ConfigImpl::Get()),
+      m_function(function),
+      m_path(path),
+      m_counted(m_impl->m_timingEnabled),
+      m_outermost(m_counted && m_impl->m_timingDepth == 0)
+{
+    if (m_counted)
+    {
+        m_impl->m_timingDepth++;
+    }
+    if (m_outermost)
+    {
+        m_impl->m_timingObjectN = 0;
+        m_start = std::chrono::steady_clock::now();
+    }
+}
 
-}; // class Resolver
+ConfigCallTimer::~ConfigCallTimer()
+{
+    if (m_counted)
+    {
+        m_impl->m_timingDepth--;
+    }
+    if (m_outermost)
+    {
+        int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - m_start)
+                         .count();
+        ConfigImpl::Timing& timing = m_impl->m_timings[std::make_pair(m_function, m_path)];
+        timing.calls++;
+        timing.objects += m_impl->m_timingObjectN;
+        timing.totalNs += ns;
+        timing.maxNs = std::max(timing.maxNs, ns);
+    }
+}
 
-Resolver::Resolver(std::string path)
-    : m_path(path)
+void
+ConfigCallTimer::SetObjectN(std::size_t n)
 {
-    NS_LOG_FUNCTION(this << path);
-    Canonicalize();
+    if (m_counted)
+    {
+        m_impl->m_timingObjectN = n;
+    }
 }
 
-Resolver::~Resolver()
+/**
+ * \ingroup config-impl
+ * An element of a Config::Path.
+ */
+struct Path::Element
 {
-    NS_LOG_FUNCTION(this);
+    /**
+     * Parse an element.
+     * \param [in] element The element.
+     */
+    Element(const std::string& element);
+
+    std::string item;     //!< The element
+    bool hasTid;          //!< Whether tid holds the TypeId of a "$" element
+    TypeId tid;           //!< The TypeId of a "$" element
+    ArrayMatcher matcher; //!< The indexes matched by the element, after a container
+    /** The attributes matched by the element, or null until they are needed. */
+    mutable PathAttributeCache* attributes;
+};
+
+Path::Element::Element(const std::string& element)
+    : item(element),
+      hasTid(false),
+      matcher(element),
+      attributes(nullptr)
+{
+    if (item.find('$') == 0)
+    {
+        // The type may be registered later; it is then looked up when needed.
+        hasTid = TypeId::LookupByNameFailSafe(item.substr(1, item.size() - 1), &tid);
+    }
 }
 
-void
-Resolver::Canonicalize()
+Path::Path(std::string path)
+    : m_path(path)
 {
-    NS_LOG_FUNCTION(this);
+    NS_LOG_FUNCTION(this << path);
+
+    std::string::size_type slash = path.find_last_of('/');
+    NS_ASSERT_MSG(slash != std::string::npos, "Invalid Config path " << path);
+    m_root = path.substr(0, slash);
+    m_leaf = path.substr(slash + 1, path.size() - (slash + 1));
 
     // ensure that we start and end with a '/'
-    std::string::size_type tmp = m_path.find('/');
-    if (tmp != 0)
+    std::string root = m_root;
+    if (root.find('/') != 0)
+    {
+        root = "/" + root;
+    }
+    if (root.find_last_of('/') != (root.size() - 1))
     {
-        // no slash at start
-        m_path = "/" + m_path;
+        root = root + "/";
     }
-    tmp = m_path.find_last_of('/');
-    if (tmp != (m_path.size() - 1))
+    std::string::size_type start = 0;
+    std::string::size_type next;
+    while ((next = root.find('/', start + 1)) != std::string::npos)
     {
-        // no slash at end
-        m_path = m_path + "/";
+        m_elements.emplace_back(root.substr(start + 1, next - (start + 1)));
+        start = next;
     }
 }
 
-void
-Resolver::Resolve(Ptr<Object> root)
-{
-    NS_LOG_FUNCTION(this << root);
+Path::Path(const Path& other) = default;
 
-    DoResolve(m_path, root);
-}
+Path& Path::operator=(const Path& other) = default;
+
+Path::~Path() = default;
 
 std::string
-Resolver::GetResolvedPath() const
+Path::GetPath() const
 {
     NS_LOG_FUNCTION(this);
-
-    std::string fullPath = "/";
-    for (std::vector<std::string>::const_iterator i = m_workStack.begin(); i != m_workStack.end();
-         i++)
-    {
-        fullPath += *i + "/";
-    }
-    return fullPath;
+    return m_path;
 }
 
 void
-Resolver::DoResolveOne(Ptr<Object> object)
+Path::Resolve(std::vector<Ptr<Object>>& objects, std::vector<std::string>& contexts) const
 {
-    NS_LOG_FUNCTION(this << object);
+    NS_LOG_FUNCTION(this);
+
+    ConfigImpl* impl = ConfigImpl::Get();
+    std::string context = "/";
+    for (std::size_t i = 0; i < impl->GetRootNamespaceObjectN(); i++)
+    {
+        DoResolve(impl->GetRootNamespaceObject(i), 0, context, objects, contexts);
+    }
 
-    NS_LOG_DEBUG("resolved=" << GetResolvedPath());
-    DoOne(object, GetResolvedPath());
+    //
+    // See if we can do something with the object name service.  Starting with
+    // the root pointer zeroed indicates to the resolver that it should start
+    // looking at the root of the "/Names" namespace during this go.
+    //
+    DoResolve(nullptr, 0, context, objects, contexts);
 }
 
 void
-Resolver::DoResolve(std::string path, Ptr<Object> root)
+Path::DoResolve(Ptr<Object> root,
+                std::size_t depth,
+                std::string& context,
+                std::vector<Ptr<Object>>& objects,
+                std::vector<std::string>& contexts) const
 {
-    NS_LOG_FUNCTION(this << path << root);
-    NS_ASSERT((path.find('/')) == 0);
-    std::string::size_type next = path.find('/', 1);
+    NS_LOG_FUNCTION(this << root << depth << context);
 
-    if (next == std::string::npos)
+    if (depth == m_elements.size())
     {
         //
         // If root is zero, we're beginning to see if we can use the object name
@@ -459,12 +735,15 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
         //
         if (root)
         {
-            DoResolveOne(root);
+            NS_LOG_DEBUG("resolved=" << context);
+            objects.push_back(root);
+            contexts.push_back(context);
         }
         return;
     }
-    std::string item = path.substr(1, next - 1);
-    std::string pathLeft = path.substr(next, path.size() - next);
+    const Element& element = m_elements[depth];
+    const std::string& item = element.item;
+    std::size_t length = context.size();
 
     //
     // If root is zero, we're beginning to see if we can use the object name
@@ -473,16 +752,12 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
     // the root of the "/Names" namespace, so we just ignore it and move on to
     // the next segment.
     //
-    if (!root)
+    if (!root && item.compare(0, 5, "Names") == 0)
     {
-        std::string::size_type offset = path.find("/Names");
-        if (offset == 0)
-        {
-            m_workStack.push_back(item);
-            DoResolve(pathLeft, root);
-            m_workStack.pop_back();
-            return;
-        }
+        context.append(item).push_back('/');
+        DoResolve(root, depth + 1, context, objects, contexts);
+        context.resize(length);
+        return;
     }
 
     //
@@ -495,9 +770,9 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
     if (namedObject)
     {
         NS_LOG_DEBUG("Name system resolved item = " << item << " to " << namedObject);
-        m_workStack.push_back(item);
-        DoResolve(pathLeft, namedObject);
-        m_workStack.pop_back();
+        context.append(item).push_back('/');
+        DoResolve(namedObject, depth + 1, context, objects, contexts);
+        context.resize(length);
         return;
     }
 
@@ -512,308 +787,433 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
     {
         return;
     }
-    std::string::size_type dollarPos = item.find('$');
-    if (dollarPos == 0)
+    if (item.find('$') == 0)
     {
         // This is a call to GetObject
-        std::string tidString = item.substr(1, item.size() - 1);
-        NS_LOG_DEBUG("GetObject=" << tidString << " on path=" << GetResolvedPath());
-        TypeId tid = TypeId::LookupByName(tidString);
+        NS_LOG_DEBUG("GetObject=" << item << " on path=" << context);
+        TypeId tid =
+            element.hasTid ? element.tid : TypeId::LookupByName(item.substr(1, item.size() - 1));
         Ptr<Object> object = root->GetObject<Object>(tid);
         if (!object)
         {
-            NS_LOG_DEBUG("GetObject (" << tidString << ") failed on path=" << GetResolvedPath());
+            NS_LOG_DEBUG("GetObject (" << item << ") failed on path=" << context);
             return;
         }
-        m_workStack.push_back(item);
-        DoResolve(pathLeft, object);
-        m_workStack.pop_back();
+        context.append(item).push_back('/');
+        DoResolve(object, depth + 1, context, objects, contexts);
+        context.resize(length);
+        return;
     }
-    else
-    {
-        // this is a normal attribute.
-        TypeId tid;
-        TypeId nextTid = root->GetInstanceTypeId();
-        bool foundMatch = false;
 
-        do
+    // this is a normal attribute.
+    if (element.attributes == nullptr)
+    {
+        element.attributes = &ConfigImpl::Get()->GetAttributeCache(item);
+    }
+    TypeId instanceTid = root->GetInstanceTypeId();
+    auto it = element.attributes->find(instanceTid.GetUid());
+    if (it == element.attributes->end())
+    {
+        it = element.attributes
+                 ->emplace(instanceTid.GetUid(), FindPathAttributes(instanceTid, item))
+                 .first;
+    }
+    // The references to the elements of the cache stay valid when it grows
+    const std::vector<PathAttribute>& attributes = it->second;
+    if (attributes.empty())
+    {
+        NS_LOG_DEBUG("Requested item=" << item << " does not exist on path=" << context);
+        return;
+    }
+    for (const PathAttribute& attribute : attributes)
+    {
+        if (attribute.container)
         {
-            tid = nextTid;
-
-            for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
-            {
-                TypeId::AttributeInformation info;
-                info = tid.GetAttribute(i);
-                if (info.name != item && item != "*")
-                {
-                    continue;
-                }
-                // attempt to cast to a pointer checker.
-                const PointerChecker* pChecker =
-                    dynamic_cast<const PointerChecker*>(PeekPointer(info.checker));
-                if (pChecker != nullptr)
-                {
-                    NS_LOG_DEBUG("GetAttribute(ptr)=" << info.name
-                                                      << " on path=" << GetResolvedPath());
-                    PointerValue pValue;
-                    root->GetAttribute(info.name, pValue);
-                    Ptr<Object> object = pValue.Get<Object>();
-                    if (!object)
-                    {
-                        NS_LOG_ERROR("Requested object name=\"" << item << "\" exists on path=\""
-                                                                << GetResolvedPath()
-                                                                << "\""
-                                                                   " but is null.");
-                        continue;
-                    }
-                    foundMatch = true;
-                    m_workStack.push_back(info.name);
-                    DoResolve(pathLeft, object);
-                    m_workStack.pop_back();
-                }
-                // attempt to cast to an object vector.
-                const ObjectPtrContainerChecker* vectorChecker =
-                    dynamic_cast<const ObjectPtrContainerChecker*>(PeekPointer(info.checker));
-                if (vectorChecker != nullptr)
-                {
-                    NS_LOG_DEBUG("GetAttribute(vector)=" << info.name << " on path="
-                                                         << GetResolvedPath() << pathLeft);
-                    foundMatch = true;
-                    ObjectPtrContainerValue vector;
-                    root->GetAttribute(info.name, vector);
-                    m_workStack.push_back(info.name);
-                    DoArrayResolve(pathLeft, vector);
-                    m_workStack.pop_back();
-                }
-                // this could be anything else and we don't know what to do with it.
-                // So, we just ignore it.
-            }
-
-            nextTid = tid.GetParent();
-        } while (nextTid != tid);
-
-        if (!foundMatch)
+            NS_LOG_DEBUG("GetAttribute(vector)=" << attribute.name << " on path=" << context);
+            context.append(attribute.name).push_back('/');
+            DoArrayResolve(root,
+                           attribute.name,
+                           PeekPointer(attribute.containerAccessor),
+                           depth + 1,
+                           context,
+                           objects,
+                           contexts);
+            context.resize(length);
+            continue;
+        }
+        NS_LOG_DEBUG("GetAttribute(ptr)=" << attribute.name << " on path=" << context);
+        PointerValue pValue;
+        if (!attribute.accessor || !attribute.accessor->Get(PeekPointer(root), pValue))
         {
-            NS_LOG_DEBUG("Requested item=" << item
-                                           << " does not exist on path=" << GetResolvedPath());
-            return;
+            root->GetAttribute(attribute.name, pValue);
         }
+        Ptr<Object> object = pValue.Get<Object>();
+        if (!object)
+        {
+            NS_LOG_ERROR("Requested object name=\"" << item << "\" exists on path=\"" << context
+                                                    << "\" but is null.");
+            continue;
+        }
+        context.append(attribute.name).push_back('/');
+        DoResolve(object, depth + 1, context, objects, contexts);
+        context.resize(length);
     }
 }
 
 void
-Resolver::DoArrayResolve(std::string path, const ObjectPtrContainerValue& container)
+Path::DoArrayResolve(Ptr<Object> root,
+                     const std::string& name,
+                     const ObjectPtrContainerAccessor* accessor,
+                     std::size_t depth,
+                     std::string& context,
+                     std::vector<Ptr<Object>>& objects,
+                     std::vector<std::string>& contexts) const
 {
-    NS_LOG_FUNCTION(this << path << &container);
-    NS_ASSERT(!path.empty());
-    NS_ASSERT((path.find('/')) == 0);
-    std::string::size_type next = path.find('/', 1);
-    if (next == std::string::npos)
+    NS_LOG_FUNCTION(this << root << name << accessor << depth << context);
+    if (depth == m_elements.size())
     {
         return;
     }
-    std::string item = path.substr(1, next - 1);
-    std::string pathLeft = path.substr(next, path.size() - next);
+    const ArrayMatcher& matcher = m_elements[depth].matcher;
+    std::size_t length = context.size();
+
+    // The containers usually hold the object of index i at position i: get
+    // the object of a single index without copying the container.
+    std::size_t index;
+    std::size_t n;
+    if (accessor != nullptr && matcher.GetIndex(&index) &&
+        accessor->GetItemN(PeekPointer(root), &n) && index < n)
+    {
+        std::size_t itemIndex;
+        Ptr<Object> object = accessor->GetItem(PeekPointer(root), index, &itemIndex);
+        if (itemIndex == index)
+        {
+            context.append(std::to_string(index)).push_back('/');
+            DoResolve(object, depth + 1, context, objects, contexts);
+            context.resize(length);
+            return;
+        }
+    }
 
-    ArrayMatcher matcher = ArrayMatcher(item);
-    ObjectPtrContainerValue::Iterator it;
-    for (it = container.Begin(); it != container.End(); ++it)
+    ObjectPtrContainerValue container;
+    if (accessor == nullptr || !accessor->Get(PeekPointer(root), container))
+    {
+        root->GetAttribute(name, container);
+    }
+    for (auto it = container.Begin(); it != container.End(); ++it)
     {
         if (matcher.Matches((*it).first))
         {
-            std::ostringstream oss;
-            oss << (*it).first;
-            m_workStack.push_back(oss.str());
-            DoResolve(pathLeft, (*it).second);
-            m_workStack.pop_back();
+            context.append(std::to_string((*it).first)).push_back('/');
+            DoResolve((*it).second, depth + 1, context, objects, contexts);
+            context.resize(length);
         }
     }
 }
 
+MatchContainer
+Path::LookupMatches() const
+{
+    NS_LOG_FUNCTION(this);
+    ConfigCallTimer timer("Path::LookupMatches", m_path);
+    std::vector<Ptr<Object>> objects;
+    std::vector<std::string> contexts;
+    Resolve(objects, contexts);
+    timer.SetObjectN(objects.size());
+    return MatchContainer(objects, contexts, m_root);
+}
+
 /**
  * \ingroup config-impl
- * Config system implementation class.
+ * Set an attribute of objects.
+ *
+ * \param [in] objects The objects.
+ * \param [in] name The name of the attribute.
+ * \param [in] value The value of the attribute.
+ * \param [in] failSafe Whether to ignore the objects whose attribute cannot
+ *   be set, instead of raising a fatal error.
+ * \returns \c true if any attribute could be set.
  */
-class ConfigImpl : public Singleton<ConfigImpl>
+static bool
+SetPathAttributes(const std::vector<Ptr<Object>>& objects,
+                  const std::string& name,
+                  const AttributeValue& value,
+                  bool failSafe)
 {
-  public:
-    // Keep Set and SetFailSafe since their errors are triggered
-    // by the underlying ObjectBase functions.
-    /** \copydoc ns3::Config::Set() */
-    void Set(std::string path, const AttributeValue& value);
-    /** \copydoc ns3::Config::SetFailSafe() */
-    bool SetFailSafe(std::string path, const AttributeValue& value);
-    /** \copydoc ns3::Config::ConnectWithoutContextFailSafe() */
-    bool ConnectWithoutContextFailSafe(std::string path, const CallbackBase& cb);
-    /** \copydoc ns3::Config::ConnectFailSafe() */
-    bool ConnectFailSafe(std::string path, const CallbackBase& cb);
-    /** \copydoc ns3::Config::DisconnectWithoutContext() */
-    void DisconnectWithoutContext(std::string path, const CallbackBase& cb);
-    /** \copydoc ns3::Config::Disconnect() */
-    void Disconnect(std::string path, const CallbackBase& cb);
-    /** \copydoc ns3::Config::LookupMatches() */
-    MatchContainer LookupMatches(std::string path);
+    NS_LOG_FUNCTION(&objects << name << &value << failSafe);
+    PathSetCache& cache = ConfigImpl::Get()->GetSetCache(name);
+    Ptr<const AttributeChecker> checker;
+    Ptr<AttributeValue> validValue;
+    bool ok = false;
+    for (const Ptr<Object>& object : objects)
+    {
+        TypeId tid = object->GetInstanceTypeId();
+        auto it = cache.find(tid.GetUid());
+        if (it == cache.end())
+        {
+            TypeId::AttributeInformation info;
+            if (!tid.LookupAttributeByName(name, &info))
+            {
+                info.accessor = nullptr;
+            }
+            it = cache.emplace(tid.GetUid(), info).first;
+        }
+        const TypeId::AttributeInformation& info = it->second;
+        bool done = false;
+        if (info.accessor && (info.flags & TypeId::ATTR_SET) && info.accessor->HasSetter())
+        {
+            // The objects of a path usually share the checker of the attribute
+            if (info.checker != checker)
+            {
+                checker = info.checker;
+                validValue = checker->CreateValidValue(value);
+            }
+            done = validValue && info.accessor->Set(PeekPointer(object), *validValue);
+        }
+        if (!done && !failSafe)
+        {
+            // Let ObjectBase::SetAttribute raise any errors
+            object->SetAttribute(name, value);
+        }
+        ok |= done;
+    }
+    return ok;
+}
 
-    /** \copydoc ns3::Config::RegisterRootNamespaceObject() */
-    void RegisterRootNamespaceObject(Ptr<Object> obj);
-    /** \copydoc ns3::Config::UnregisterRootNamespaceObject() */
-    void UnregisterRootNamespaceObject(Ptr<Object> obj);
+void
+Path::Set(const AttributeValue& value) const
+{
+    NS_LOG_FUNCTION(this << &value);
+    ConfigCallTimer timer("Path::Set", m_path);
+    std::vector<Ptr<Object>> objects;
+    std::vector<std::string> contexts;
+    Resolve(objects, contexts);
+    timer.SetObjectN(objects.size());
+    SetPathAttributes(objects, m_leaf, value, false);
+}
 
-    /** \copydoc ns3::Config::GetRootNamespaceObjectN() */
-    std::size_t GetRootNamespaceObjectN() const;
-    /** \copydoc ns3::Config::GetRootNamespaceObject() */
-    Ptr<Object> GetRootNamespaceObject(std::size_t i) const;
+bool
+Path::SetFailSafe(const AttributeValue& value) const
+{
+    NS_LOG_FUNCTION(this << &value);
+    ConfigCallTimer timer("Path::SetFailSafe", m_path);
+    std::vector<Ptr<Object>> objects;
+    std::vector<std::string> contexts;
+    Resolve(objects, contexts);
+    timer.SetObjectN(objects.size());
+    return SetPathAttributes(objects, m_leaf, value, true);
+}
 
-  private:
-    /**
-     * Break a Config path into the leading path and the last leaf token.
-     * \param [in] path The Config path.
-     * \param [in,out] root The leading part of the \pname{path},
-     *   up to the final slash.
-     * \param [in,out] leaf The trailing part of the \pname{path}.
-     */
-    void ParsePath(std::string path, std::string* root, std::string* leaf) const;
+bool
+Path::DoConnect(const CallbackBase& cb, bool withContext, bool connect) const
+{
+    NS_LOG_FUNCTION(this << &cb << withContext << connect);
+    const char* function = connect ? (withContext ? "Path::Connect" : "Path::ConnectWithoutContext")
+                                   : (withContext ? "Path::Disconnect"
+                                                  : "Path::DisconnectWithoutContext");
+    ConfigCallTimer timer(function, m_path);
+    std::vector<Ptr<Object>> objects;
+    std::vector<std::string> contexts;
+    Resolve(objects, contexts);
+    timer.SetObjectN(objects.size());
+    if (!connect && objects.empty())
+    {
+        std::size_t lastFwdSlash = m_root.rfind('/');
+        NS_LOG_WARN("Failed to disconnect "
+                    << m_leaf << ", the Requested object name = " << m_root.substr(lastFwdSlash + 1)
+                    << " does not exits on path " << m_root.substr(0, lastFwdSlash));
+    }
 
-    /** Container type to hold the root Config path tokens. */
-    typedef std::vector<Ptr<Object>> Roots;
+    PathTraceSourceCache& cache = ConfigImpl::Get()->GetTraceSourceCache(m_leaf);
+    bool ok = false;
+    for (std::size_t i = 0; i < objects.size(); i++)
+    {
+        TypeId tid = objects[i]->GetInstanceTypeId();
+        auto it = cache.find(tid.GetUid());
+        if (it == cache.end())
+        {
+            it = cache.emplace(tid.GetUid(), tid.LookupTraceSourceByName(m_leaf)).first;
+        }
+        const Ptr<const TraceSourceAccessor>& accessor = it->second;
+        if (!accessor)
+        {
+            continue;
+        }
+        ObjectBase* object = PeekPointer(objects[i]);
+        if (connect)
+        {
+            ok |= withContext ? accessor->Connect(object, contexts[i] + m_leaf, cb)
+                              : accessor->ConnectWithoutContext(object, cb);
+        }
+        else
+        {
+            ok |= withContext ? accessor->Disconnect(object, contexts[i] + m_leaf, cb)
+                              : accessor->DisconnectWithoutContext(object, cb);
+        }
+    }
+    return ok;
+}
 
-    /** The list of Config path roots. */
-    Roots m_roots;
+void
+Path::Connect(const CallbackBase& cb) const
+{
+    NS_LOG_FUNCTION(this << &cb);
+    if (!ConnectFailSafe(cb))
+    {
+        NS_FATAL_ERROR("Could not connect callback to " << m_path);
+    }
+}
 
-}; // class ConfigImpl
+bool
+Path::ConnectFailSafe(const CallbackBase& cb) const
+{
+    NS_LOG_FUNCTION(this << &cb);
+    return DoConnect(cb, true, true);
+}
 
 void
-ConfigImpl::ParsePath(std::string path, std::string* root, std::string* leaf) const
+Path::ConnectWithoutContext(const CallbackBase& cb) const
+{
+    NS_LOG_FUNCTION(this << &cb);
+    if (!ConnectWithoutContextFailSafe(cb))
+    {
+        NS_FATAL_ERROR("Could not connect callback to " << m_path);
+    }
+}
+
+bool
+Path::ConnectWithoutContextFailSafe(const CallbackBase& cb) const
 {
-    NS_LOG_FUNCTION(this << path << root << leaf);
+    NS_LOG_FUNCTION(this << &cb);
+    return DoConnect(cb, false, true);
+}
 
-    std::string::size_type slash = path.find_last_of('/');
-    NS_ASSERT(slash != std::string::npos);
-    *root = path.substr(0, slash);
-    *leaf = path.substr(slash + 1, path.size() - (slash + 1));
-    NS_LOG_FUNCTION(path << *root << *leaf);
+void
+Path::Disconnect(const CallbackBase& cb) const
+{
+    NS_LOG_FUNCTION(this << &cb);
+    DoConnect(cb, true, false);
+}
+
+void
+Path::DisconnectWithoutContext(const CallbackBase& cb) const
+{
+    NS_LOG_FUNCTION(this << &cb);
+    DoConnect(cb, false, false);
 }
 
 void
 ConfigImpl::Set(std::string path, const AttributeValue& value)
 {
     NS_LOG_FUNCTION(this << path << &value);
-
-    std::string root;
-    std::string leaf;
-    ParsePath(path, &root, &leaf);
-    MatchContainer container = LookupMatches(root);
-    container.Set(leaf, value);
+    ConfigCallTimer timer("Set", path);
+    Path(path).Set(value);
 }
 
 bool
 ConfigImpl::SetFailSafe(std::string path, const AttributeValue& value)
 {
     NS_LOG_FUNCTION(this << path << &value);
-
-    std::string root;
-    std::string leaf;
-    ParsePath(path, &root, &leaf);
-    MatchContainer container = LookupMatches(root);
-    return container.SetFailSafe(leaf, value);
+    ConfigCallTimer timer("SetFailSafe", path);
+    return Path(path).SetFailSafe(value);
 }
 
 bool
 ConfigImpl::ConnectWithoutContextFailSafe(std::string path, const CallbackBase& cb)
 {
     NS_LOG_FUNCTION(this << path << &cb);
-    std::string root;
-    std::string leaf;
-    ParsePath(path, &root, &leaf);
-    MatchContainer container = LookupMatches(root);
-    return container.ConnectWithoutContextFailSafe(leaf, cb);
+    ConfigCallTimer timer("ConnectWithoutContext", path);
+    return Path(path).ConnectWithoutContextFailSafe(cb);
 }
 
 void
 ConfigImpl::DisconnectWithoutContext(std::string path, const CallbackBase& cb)
 {
     NS_LOG_FUNCTION(this << path << &cb);
-    std::string root;
-    std::string leaf;
-    ParsePath(path, &root, &leaf);
-    MatchContainer container = LookupMatches(root);
-    if (container.GetN() == 0)
-    {
-        std::size_t lastFwdSlash = root.rfind('/');
-        NS_LOG_WARN("Failed to disconnect "
-                    << leaf << ", the Requested object name = " << root.substr(lastFwdSlash + 1)
-                    << " does not exits on path " << root.substr(0, lastFwdSlash));
-    }
-    container.DisconnectWithoutContext(leaf, cb);
+    ConfigCallTimer timer("DisconnectWithoutContext", path);
+    Path(path).DisconnectWithoutContext(cb);
 }
 
 bool
 ConfigImpl::ConnectFailSafe(std::string path, const CallbackBase& cb)
 {
     NS_LOG_FUNCTION(this << path << &cb);
-
-    std::string root;
-    std::string leaf;
-    ParsePath(path, &root, &leaf);
-    MatchContainer container = LookupMatches(root);
-    return container.ConnectFailSafe(leaf, cb);
+    ConfigCallTimer timer("Connect", path);
+    return Path(path).ConnectFailSafe(cb);
 }
 
 void
 ConfigImpl::Disconnect(std::string path, const CallbackBase& cb)
 {
     NS_LOG_FUNCTION(this << path << &cb);
-
-    std::string root;
-    std::string leaf;
-    ParsePath(path, &root, &leaf);
-    MatchContainer container = LookupMatches(root);
-    if (container.GetN() == 0)
-    {
-        std::size_t lastFwdSlash = root.rfind('/');
-        NS_LOG_WARN("Failed to disconnect "
-                    << leaf << ", the Requested object name = " << root.substr(lastFwdSlash + 1)
-                    << " does not exits on path " << root.substr(0, lastFwdSlash));
-    }
-    container.Disconnect(leaf, cb);
+    ConfigCallTimer timer("Disconnect", path);
+    Path(path).Disconnect(cb);
 }
 
 MatchContainer
 ConfigImpl::LookupMatches(std::string path)
 {
     NS_LOG_FUNCTION(this << path);
+    ConfigCallTimer timer("LookupMatches", path);
+    // The path of the objects is the path of a Path without its last element
+    return Path(path + "/").LookupMatches();
+}
 
-    class LookupMatchesResolver : public Resolver
-    {
-      public:
-        LookupMatchesResolver(std::string path)
-            : Resolver(path)
-        {
-        }
+PathAttributeCache&
+ConfigImpl::GetAttributeCache(const std::string& item)
+{
+    NS_LOG_FUNCTION(this << item);
+    return m_attributeCaches[item];
+}
 
-        void DoOne(Ptr<Object> object, std::string path) override
-        {
-            m_objects.push_back(object);
-            m_contexts.push_back(path);
-        }
+PathTraceSourceCache&
+ConfigImpl::GetTraceSourceCache(const std::string& name)
+{
+    NS_LOG_FUNCTION(this << name);
+    return m_traceSourceCaches[name];
+}
 
-        std::vector<Ptr<Object>> m_objects;
-        std::vector<std::string> m_contexts;
-    } resolver = LookupMatchesResolver(path);
+PathSetCache&
+ConfigImpl::GetSetCache(const std::string& name)
+{
+    NS_LOG_FUNCTION(this << name);
+    return m_setCaches[name];
+}
 
-    for (Roots::const_iterator i = m_roots.begin(); i != m_roots.end(); i++)
+void
+ConfigImpl::EnableTimingReport(bool enable)
+{
+    NS_LOG_FUNCTION(this << enable);
+    m_timingEnabled = enable;
+    if (enable)
     {
-        resolver.Resolve(*i);
+        m_timings.clear();
     }
+}
 
-    //
-    // See if we can do something with the object name service.  Starting with
-    // the root pointer zeroed indicates to the resolver that it should start
-    // looking at the root of the "/Names" namespace during this go.
-    //
-    resolver.Resolve(nullptr);
-
-    return MatchContainer(resolver.m_objects, resolver.m_contexts, path);
+void
+ConfigImpl::PrintTimingReport(std::ostream& os) const
+{
+    NS_LOG_FUNCTION(this << &os);
+    std::vector<std::pair<std::pair<std::string, std::string>, Timing>> timings(m_timings.begin(),
+                                                                                m_timings.end());
+    std::stable_sort(timings.begin(), timings.end(), [](const auto& a, const auto& b) {
+        return a.second.totalNs > b.second.totalNs;
+    });
+
+    std::ios_base::fmtflags flags = os.flags();
+    os << std::setw(12) << "total (ms)" << std::setw(12) << "max (us)" << std::setw(10)
+       << "calls" << std::setw(10) << "objects"
+       << "  function path" << std::endl;
+    os << std::fixed;
+    for (const auto& timing : timings)
+    {
+        os << std::setprecision(3) << std::setw(12) << timing.second.totalNs / 1e6
+           << std::setprecision(1) << std::setw(12) << timing.second.maxNs / 1e3 << std::setw(10)
+           << timing.second.calls << std::setw(10) << timing.second.objects << "  "
+           << timing.first.first << " " << timing.first.second << std::endl;
+    }
+    os.flags(flags);
 }
 
 void
@@ -1016,6 +1416,20 @@ UnregisterRootNamespaceObject(Ptr<Object> obj)
     ConfigImpl::Get()->UnregisterRootNamespaceObject(obj);
 }
 
+void
+EnableTimingReport(bool enable)
+{
+    NS_LOG_FUNCTION(enable);
+    ConfigImpl::Get()->EnableTimingReport(enable);
+}
+
+void
+PrintTimingReport(std::ostream& os)
+{
+    NS_LOG_FUNCTION(&os);
+    ConfigImpl::Get()->PrintTimingReport(os);
+}
+
 std::size_t
 GetRootNamespaceObjectN()
 {
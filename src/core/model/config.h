@@ -21,6 +21,7 @@
 
 #include "ptr.h"
 
+#include <ostream>
 #include <string>
 #include <vector>
 
@@ -35,6 +36,7 @@ namespace ns3
 
 class AttributeValue;
 class Object;
+class ObjectPtrContainerAccessor;
 class CallbackBase;
 
 /**
@@ -353,6 +355,171 @@ class MatchContainer
     std::string m_path;
 };
 
+/**
+ * \ingroup config
+ * \brief A Config path, parsed once to be resolved many times.
+ *
+ * Config::Set, Config::Connect and the other functions taking a path as a
+ * string parse it on each call.  A Path splits the path into its elements
+ * once, looks up the TypeIds of its "$" elements and the index ranges of its
+ * array elements once, and is then resolved with few string operations.
+ *
+ * The attributes matched by the elements of all the paths, and the trace
+ * sources and attributes at their end, are looked up once per instance
+ * TypeId and cached.  The functions taking a path as a string use a
+ * temporary Path, and so benefit from the caches too.
+ *
+ * \code
+ *   Config::Path path("/NodeList/[0-9]/DeviceList/0/$ns3::WifiNetDevice/Phy/PhyTxBegin");
+ *   path.Connect(MakeCallback(&PhyTxBegin));
+ * \endcode
+ */
+class Path
+{
+  public:
+    /**
+     * Parse a Config path.
+     *
+     * \param [in] path The path, ending with the name of an attribute or
+     *   of a trace source, as given to Config::Set or Config::Connect.
+     */
+    Path(std::string path);
+    /** Copy constructor. \param [in] other The path to copy. */
+    Path(const Path& other);
+    /**
+     * Assignment operator.
+     * \param [in] other The path to copy.
+     * \returns This path.
+     */
+    Path& operator=(const Path& other);
+    /** Destructor. */
+    ~Path();
+
+    /**
+     * \returns The path.
+     */
+    std::string GetPath() const;
+    /**
+     * \returns A container which contains all the objects which match the
+     *   path without its last element, i.e., the objects holding the
+     *   attribute or trace source of the path.
+     */
+    MatchContainer LookupMatches() const;
+
+    /**
+     * \copybrief Config::Set
+     * \param [in] value The value to set in all matching attributes.
+     * \sa Config::Set
+     */
+    void Set(const AttributeValue& value) const;
+    /**
+     * \copybrief Config::SetFailSafe
+     * \param [in] value The value to set in all matching attributes.
+     * \returns \c true if any matching attributes could be set.
+     * \sa Config::SetFailSafe
+     */
+    bool SetFailSafe(const AttributeValue& value) const;
+    /**
+     * \copybrief Config::Connect
+     * \param [in] cb The callback to connect to the matching trace sources.
+     * \sa Config::Connect
+     */
+    void Connect(const CallbackBase& cb) const;
+    /**
+     * \copybrief Config::ConnectFailSafe
+     * \param [in] cb The callback to connect to the matching trace sources.
+     * \returns \c true if any trace sources could be connected.
+     * \sa Config::ConnectFailSafe
+     */
+    bool ConnectFailSafe(const CallbackBase& cb) const;
+    /**
+     * \copybrief Config::ConnectWithoutContext
+     * \param [in] cb The callback to connect to the matching trace sources.
+     * \sa Config::ConnectWithoutContext
+     */
+    void ConnectWithoutContext(const CallbackBase& cb) const;
+    /**
+     * \copybrief Config::ConnectWithoutContextFailSafe
+     * \param [in] cb The callback to connect to the matching trace sources.
+     * \returns \c true if any trace sources could be connected.
+     * \sa Config::ConnectWithoutContextFailSafe
+     */
+    bool ConnectWithoutContextFailSafe(const CallbackBase& cb) const;
+    /**
+     * \copybrief Config::Disconnect
+     * \param [in] cb The callback to disconnect from the matching trace sources.
+     * \sa Config::Disconnect
+     */
+    void Disconnect(const CallbackBase& cb) const;
+    /**
+     * \copybrief Config::DisconnectWithoutContext
+     * \param [in] cb The callback to disconnect from the matching trace sources.
+     * \sa Config::DisconnectWithoutContext
+     */
+    void DisconnectWithoutContext(const CallbackBase& cb) const;
+
+  private:
+    /** An element of the path, defined in config.cc. */
+    struct Element;
+
+    /**
+     * Find the objects holding the attribute or trace source of the path.
+     *
+     * \param [out] objects The objects.
+     * \param [out] contexts The context of each object, ending with a '/'.
+     */
+    void Resolve(std::vector<Ptr<Object>>& objects, std::vector<std::string>& contexts) const;
+    /**
+     * Resolve the remaining elements of the path.
+     *
+     * \param [in] root The object matched by the previous element, or null
+     *   to look in the "/Names" name space.
+     * \param [in] depth The index of the next element.
+     * \param [in,out] context The path to root.
+     * \param [out] objects The objects.
+     * \param [out] contexts The context of each object.
+     */
+    void DoResolve(Ptr<Object> root,
+                   std::size_t depth,
+                   std::string& context,
+                   std::vector<Ptr<Object>>& objects,
+                   std::vector<std::string>& contexts) const;
+    /**
+     * Resolve the remaining elements of the path, from an index in a
+     * container attribute.
+     *
+     * \param [in] root The object holding the container.
+     * \param [in] name The name of the container attribute.
+     * \param [in] accessor The accessor of the container, or null to get
+     *   the container through ObjectBase::GetAttribute.
+     * \param [in] depth The index of the element matching the indexes.
+     * \param [in,out] context The path to the container.
+     * \param [out] objects The objects.
+     * \param [out] contexts The context of each object.
+     */
+    void DoArrayResolve(Ptr<Object> root,
+                        const std::string& name,
+                        const ObjectPtrContainerAccessor* accessor,
+                        std::size_t depth,
+                        std::string& context,
+                        std::vector<Ptr<Object>>& objects,
+                        std::vector<std::string>& contexts) const;
+    /**
+     * Connect or disconnect a callback to the matching trace sources.
+     *
+     * \param [in] cb The callback.
+     * \param [in] withContext Whether the callback gets the context.
+     * \param [in] connect Whether to connect or to disconnect.
+     * \returns \c true if any trace sources could be connected or disconnected.
+     */
+    bool DoConnect(const CallbackBase& cb, bool withContext, bool connect) const;
+
+    std::string m_path;              //!< The path
+    std::string m_root;              //!< The path without its last element
+    std::string m_leaf;              //!< The last element of the path
+    std::vector<Element> m_elements; //!< The elements of m_root
+};
+
 /**
  * \ingroup config
  * \param [in] path The path to perform a match against
@@ -377,6 +544,26 @@ void RegisterRootNamespaceObject(Ptr<Object> obj);
  */
 void UnregisterRootNamespaceObject(Ptr<Object> obj);
 
+/**
+ * \ingroup config
+ * \param [in] enable Whether to measure the calls.
+ *
+ * Measure the wall clock time taken by each call to Config::Set,
+ * Config::Connect, Config::LookupMatches, the variants of these functions,
+ * and the functions of Config::Path.  The measures are summed by function
+ * and path, and printed by Config::PrintTimingReport.
+ */
+void EnableTimingReport(bool enable = true);
+/**
+ * \ingroup config
+ * \param [in,out] os The output stream.
+ *
+ * Print the number of calls, of matched objects, and the time taken by the
+ * calls measured since Config::EnableTimingReport, by function and path,
+ * starting with the longest.
+ */
+void PrintTimingReport(std::ostream& os);
+
 /**
  * \ingroup config
  * \returns The number of registered root namespace objects.
@@ -138,11 +138,27 @@ EnvironmentVariable::Instance()
     return instance;
 }
 
+/* static */
+uint32_t&
+EnvironmentVariable::Generation()
+{
+    static uint32_t generation = 0;
+    return generation;
+}
+
+/* static */
+uint32_t
+EnvironmentVariable::GetGeneration()
+{
+    return Generation();
+}
+
 /* static */
 void
 EnvironmentVariable::Clear()
 {
     Instance().clear();
+    Generation()++;
 }
 
 /* static */
@@ -189,6 +189,17 @@ class EnvironmentVariable
      */
     static bool Unset(const std::string& variable);
 
+    /**
+     * Get the generation of the cached dictionaries, which changes when they
+     * are cleared and the environment variables are parsed again.
+     *
+     * The users caching the values of the environment variables compare it
+     * to the generation of their cache.
+     *
+     * eturns The generation of the cached dictionaries.
+     */
+    static uint32_t GetGeneration();
+
     /**
      * \name Singleton
      *
@@ -219,6 +230,12 @@ class EnvironmentVariable
      */
     static DictionaryList& Instance();
 
+    /**
+     * Access the generation of the cached dictionaries.
+     * \returns the generation.
+     */
+    static uint32_t& Generation();
+
     // Test needs to clear the instance
     friend class tests::EnvVarTestCase;
 
@@ -20,7 +20,6 @@
 
 #include "assert.h"
 #include "attribute-construction-list.h"
-#include "environment-variable.h"
 #include "log.h"
 #include "string.h"
 #include "trace-source-accessor.h"
@@ -80,104 +79,102 @@ ObjectBase::NotifyConstructionCompleted()
 void
 ObjectBase::ConstructSelf(const AttributeConstructionList& attributes)
 {
-    // loop over the inheritance tree back to the Object base class.
     NS_LOG_FUNCTION(this << &attributes);
-    TypeId tid = GetInstanceTypeId();
-    do // Do this tid and all parents
+    // the attributes of this tid and of all parents
+    std::shared_ptr<const TypeId::ConstructionList> construction =
+        GetInstanceTypeId().GetConstructionList();
+    std::vector<Ptr<const AttributeValue>> values;
+    if (attributes.Begin() != attributes.End())
     {
-        // loop over all attributes in object type
-        NS_LOG_DEBUG("construct tid=" << tid.GetName() << ", params=" << tid.GetAttributeN());
-        for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+        // is each attribute stored in this AttributeConstructionList instance ?
+        values.reserve(construction->size());
+        for (const auto& info : *construction)
         {
-            TypeId::AttributeInformation info = tid.GetAttribute(i);
-            NS_LOG_DEBUG("try to construct \"" << tid.GetName() << "::" << info.name << "\"");
-            // is this attribute stored in this AttributeConstructionList instance ?
-            Ptr<const AttributeValue> value = attributes.Find(info.checker);
-            std::string where = "argument";
+            values.emplace_back(attributes.Find(info.checker));
+        }
+    }
+    ConstructSelf(*construction, values);
+}
 
-            // See if this attribute should not be set here in the
-            // constructor.
-            if (!(info.flags & TypeId::ATTR_CONSTRUCT))
-            {
-                // Handle this attribute if it should not be
-                // set here.
-                if (!value)
-                {
-                    // Skip this attribute if it's not in the
-                    // AttributeConstructionList.
-                    NS_LOG_DEBUG("skipping, not settable at construction");
-                    continue;
-                }
-                else
-                {
-                    // This is an error because this attribute is not
-                    // settable in its constructor but is present in
-                    // the AttributeConstructionList.
-                    NS_FATAL_ERROR("Attribute name="
-                                   << info.name << " tid=" << tid.GetName()
-                                   << ": initial value cannot be set using attributes");
-                }
-            }
+void
+ObjectBase::ConstructSelf(const TypeId::ConstructionList& construction,
+                          const std::vector<Ptr<const AttributeValue>>& values)
+{
+    NS_LOG_FUNCTION(this << &construction << values.size());
+    NS_ASSERT(values.empty() || values.size() == construction.size());
+    for (std::size_t i = 0; i < construction.size(); i++)
+    {
+        const TypeId::ConstructionInformation& info = construction[i];
+        NS_LOG_DEBUG("try to construct \"" << info.name << "\"");
+        const AttributeValue* value = values.empty() ? nullptr : PeekPointer(values[i]);
+        [[maybe_unused]] const char* where = "argument";
 
+        // See if this attribute should not be set here in the
+        // constructor.
+        if (!(info.flags & TypeId::ATTR_CONSTRUCT))
+        {
+            // Handle this attribute if it should not be
+            // set here.
             if (!value)
             {
-                NS_LOG_DEBUG("trying to set from environment variable NS_ATTRIBUTE_DEFAULT");
-                auto [found, val] =
-                    EnvironmentVariable::Get("NS_ATTRIBUTE_DEFAULT", tid.GetAttributeFullName(i));
-                if (found)
-                {
-                    NS_LOG_DEBUG("found in environment: " << val);
-                    value = Create<StringValue>(val);
-                    where = "env var";
-                }
+                // Skip this attribute if it's not in the
+                // AttributeConstructionList.
+                NS_LOG_DEBUG("skipping, not settable at construction");
+                continue;
             }
-
-            bool initial{false};
-            if (!value)
+            else
             {
-                // This is guaranteed to exist
-                NS_LOG_DEBUG("falling back to initial value from tid");
-                value = info.initialValue;
-                where = "initial value";
-                initial = true;
+                // This is an error because this attribute is not
+                // settable in its constructor but is present in
+                // the AttributeConstructionList.
+                NS_FATAL_ERROR("Attribute " << info.name
+                                            << ": initial value cannot be set using attributes");
             }
+        }
 
-            // We have a matching attribute value, if only from the initialValue
-            if (DoSet(info.accessor, info.checker, *value) || initial)
-            {
-                // Setting from initial value may fail, e.g. setting
-                // ObjectVectorValue from ""
-                // That's ok, so we still report success since construction is complete
-                NS_LOG_DEBUG("construct \"" << tid.GetName() << "::" << info.name << "\" from "
-                                            << where);
-            }
-            else
-            {
-                /*
-                  One would think this is an error...
+        bool initial{false};
+        if (!value)
+        {
+            // This is guaranteed to exist, resolved once per TypeId from
+            // the environment variable NS_ATTRIBUTE_DEFAULT or the initial value
+            value = PeekPointer(info.value);
+            where = info.initial ? "initial value" : "env var";
+            initial = info.initial;
+        }
 
-                  but there are cases where `attributes.Find(info.checker)`
-                  returns a non-null value which still fails the `DoSet()` call.
-                  For example, `value` is sometimes a real `PointerValue`
-                  containing 0 as the pointed-to address.  Since value
-                  is not null (it just contains null) the initial
-                  value is not used, the DoSet fails, and we end up
-                  here.
+        // We have a matching attribute value, if only from the initialValue
+        if (DoSet(info.accessor, info.checker, *value) || initial)
+        {
+            // Setting from initial value may fail, e.g. setting
+            // ObjectVectorValue from ""
+            // That's ok, so we still report success since construction is complete
+            NS_LOG_DEBUG("construct \"" << info.name << "\" from " << where);
+        }
+        else
+        {
+            /*
+              One would think this is an error...
 
-                  If we were adventurous we might try to fix this deep
-                  below DoSet, but there be dragons.
-                */
-                /*
-                NS_ASSERT_MSG(false,
-                              "Failed to set attribute '" << info.name << "' from '"
-                                                          << value->SerializeToString(info.checker)
-                                                          << "'");
-                */
-            }
+              but there are cases where `attributes.Find(info.checker)`
+              returns a non-null value which still fails the `DoSet()` call.
+              For example, `value` is sometimes a real `PointerValue`
+              containing 0 as the pointed-to address.  Since value
+              is not null (it just contains null) the initial
+              value is not used, the DoSet fails, and we end up
+              here.
+
+              If we were adventurous we might try to fix this deep
+              below DoSet, but there be dragons.
+            */
+            /*
+            NS_ASSERT_MSG(false,
+                          "Failed to set attribute '" << info.name << "' from '"
+                                                      << value->SerializeToString(info.checker)
+                                                      << "'");
+            */
+        }
 
-        } // for i attributes
-        tid = tid.GetParent();
-    } while (tid != ObjectBase::GetTypeId());
+    } // for i attributes
     NotifyConstructionCompleted();
 }
 
@@ -25,6 +25,7 @@
 
 #include <list>
 #include <string>
+#include <vector>
 
 /**
  * \file
@@ -318,6 +319,22 @@ class ObjectBase
      *        the member variables of this object's instance.
      */
     void ConstructSelf(const AttributeConstructionList& attributes);
+    /**
+     * Complete construction of ObjectBase from resolved attribute values.
+     *
+     * This is the implementation of the previous method, for the callers
+     * which resolve the values of the attributes once for many objects,
+     * like ns3::ObjectFactory.
+     *
+     * \param [in] construction The attributes set at construction, as
+     *        returned by TypeId::GetConstructionList() for the TypeId
+     *        of this object.
+     * \param [in] values The value of each attribute of \pname{construction},
+     *        or \c nullptr to use its default value.  If empty, all the
+     *        attributes use their default value.
+     */
+    void ConstructSelf(const TypeId::ConstructionList& construction,
+                       const std::vector<Ptr<const AttributeValue>>& values);
 
   private:
     /**
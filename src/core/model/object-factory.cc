@@ -43,6 +43,7 @@ ObjectFactory::SetTypeId(TypeId tid)
 {
     NS_LOG_FUNCTION(this << tid.GetName());
     m_tid = tid;
+    m_construction = nullptr;
 }
 
 void
@@ -50,6 +51,7 @@ ObjectFactory::SetTypeId(std::string tid)
 {
     NS_LOG_FUNCTION(this << tid);
     m_tid = TypeId::LookupByName(tid);
+    m_construction = nullptr;
 }
 
 bool
@@ -80,6 +82,7 @@ ObjectFactory::DoSet(const std::string& name, const AttributeValue& value)
         return;
     }
     m_parameters.Add(name, info.checker, value.Copy());
+    m_construction = nullptr;
 }
 
 TypeId
@@ -98,7 +101,23 @@ ObjectFactory::Create() const
     Object* derived = dynamic_cast<Object*>(base);
     NS_ASSERT(derived != nullptr);
     derived->SetTypeId(m_tid);
-    derived->Construct(m_parameters);
+    std::shared_ptr<const TypeId::ConstructionList> construction = m_tid.GetConstructionList();
+    if (construction != m_construction)
+    {
+        // Find the value of each attribute once, for all the objects created
+        NS_LOG_LOGIC("resolving the attributes of " << m_tid.GetName());
+        m_values.clear();
+        if (m_parameters.Begin() != m_parameters.End())
+        {
+            m_values.reserve(construction->size());
+            for (const auto& info : *construction)
+            {
+                m_values.emplace_back(m_parameters.Find(info.checker));
+            }
+        }
+        m_construction = construction;
+    }
+    derived->Construct(*construction, m_values);
     Ptr<Object> object = Ptr<Object>(derived, false);
     return object;
 }
@@ -188,6 +207,7 @@ operator>>(std::istream& is, ObjectFactory& factory)
                 else
                 {
                     factory.m_parameters.Add(name, info.checker, val);
+                    factory.m_construction = nullptr;
                 }
             }
         }
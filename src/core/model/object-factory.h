@@ -23,6 +23,9 @@
 #include "object.h"
 #include "type-id.h"
 
+#include <memory>
+#include <vector>
+
 /**
  * \file
  * \ingroup object
@@ -115,6 +118,10 @@ class ObjectFactory
     /**
      * Create an Object instance of the configured TypeId.
      *
+     * The attributes of the factory are matched against the attributes
+     * of the TypeId once, and the result is reused by the next calls,
+     * until the factory or the attributes of the TypeId change.
+     *
      * \returns A new object instance.
      */
     Ptr<Object> Create() const;
@@ -169,6 +176,13 @@ class ObjectFactory
      * objects by this factory.
      */
     AttributeConstructionList m_parameters;
+    /**
+     * The attributes of m_tid set at construction, when m_values was
+     * last resolved, or \c nullptr if m_values must be resolved.
+     */
+    mutable std::shared_ptr<const TypeId::ConstructionList> m_construction;
+    /** The value in m_parameters of each attribute of m_construction, or \c nullptr. */
+    mutable std::vector<Ptr<const AttributeValue>> m_values;
 };
 
 std::ostream& operator<<(std::ostream& os, const ObjectFactory& factory);
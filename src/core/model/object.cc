@@ -147,6 +147,14 @@ Object::Construct(const AttributeConstructionList& attributes)
     ConstructSelf(attributes);
 }
 
+void
+Object::Construct(const TypeId::ConstructionList& construction,
+                  const std::vector<Ptr<const AttributeValue>>& values)
+{
+    NS_LOG_FUNCTION(this << &construction << values.size());
+    ConstructSelf(construction, values);
+}
+
 Ptr<Object>
 Object::DoGetObject(TypeId tid) const
 {
@@ -397,6 +397,19 @@ class Object : public SimpleRefCount<Object, ObjectBase, ObjectDeleter>
      * registered with the associated TypeId.
      */
     void Construct(const AttributeConstructionList& attributes);
+    /**
+     * Initialize all member variables registered as Attributes of this TypeId,
+     * from resolved values.
+     *
+     * \param [in] construction The attributes of this Object's TypeId set
+     *        at construction.
+     * \param [in] values The value of each attribute of \pname{construction},
+     *        or \c nullptr to use its default value.
+     *
+     * Invoked from ns3::ObjectFactory::Create only.
+     */
+    void Construct(const TypeId::ConstructionList& construction,
+                   const std::vector<Ptr<const AttributeValue>>& values);
 
     /**
      * Keep the list of aggregates in most-recently-used order
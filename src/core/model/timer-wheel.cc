@@ -0,0 +1,525 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "timer-wheel.h"
+
+#include "log.h"
+#include "simulator.h"
+#include "uinteger.h"
+
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::TimerWheel class implementation.
+ */
+
+namespace
+{
+
+/**
+ * \param word a word other than zero
+ * \return the number of trailing zero bits of the word
+ */
+uint32_t
+CountTrailingZeros(uint64_t word)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(word);
+#else
+    uint32_t n = 0;
+    for (; (word & 1) == 0; word >>= 1)
+    {
+        n++;
+    }
+    return n;
+#endif
+}
+
+} // namespace
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TimerWheel");
+
+NS_OBJECT_ENSURE_REGISTERED(TimerWheel);
+
+TypeId
+TimerWheel::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::TimerWheel")
+            .SetParent<Object>()
+            .SetGroupName("Core")
+            .AddConstructor<TimerWheel>()
+            .AddAttribute("Granularity",
+                          "The length of the period covered by each slot of the wheel. "
+                          "It does not affect the expiration times of the timers.",
+                          TimeValue(MilliSeconds(1)),
+                          MakeTimeAccessor(&TimerWheel::m_granularity),
+                          MakeTimeChecker(TimeStep(1)))
+            .AddAttribute("Slots",
+                          "The number of slots of the wheel.",
+                          UintegerValue(1024),
+                          MakeUintegerAccessor(&TimerWheel::m_nSlots),
+                          MakeUintegerChecker<uint32_t>(1));
+    return tid;
+}
+
+TimerWheel::TimerWheel()
+    : m_currentTick(0),
+      m_nRunning(0),
+      m_sequence(0),
+      m_expiring(false),
+      m_disposed(false),
+      m_nEvents(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TimerWheel::~TimerWheel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+TimerWheel::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_event.Cancel();
+    m_timers.clear();
+    m_freeTimers.clear();
+    m_slots.clear();
+    m_occupied.clear();
+    m_expired.clear();
+    m_nRunning = 0;
+    m_disposed = true;
+    Object::DoDispose();
+}
+
+Ptr<TimerWheel>
+TimerWheel::GetTimerWheel(Ptr<Object> object)
+{
+    NS_LOG_FUNCTION(object);
+    Ptr<TimerWheel> wheel = object->GetObject<TimerWheel>();
+    if (!wheel)
+    {
+        wheel = CreateObject<TimerWheel>();
+        object->AggregateObject(wheel);
+    }
+    return wheel;
+}
+
+TimerWheel::TimerId
+TimerWheel::CreateTimer(const Callback<void>& callback)
+{
+    NS_LOG_FUNCTION(this);
+    if (m_disposed)
+    {
+        return NONE;
+    }
+    if (m_slots.empty())
+    {
+        m_slots.assign(m_nSlots, NONE);
+        m_occupied.assign((m_nSlots + 63) / 64, 0);
+    }
+
+    TimerId id;
+    if (m_freeTimers.empty())
+    {
+        id = m_timers.size();
+        m_timers.emplace_back();
+    }
+    else
+    {
+        id = m_freeTimers.back();
+        m_freeTimers.pop_back();
+    }
+    Entry& entry = m_timers[id];
+    entry.callback = callback;
+    entry.running = false;
+    entry.used = true;
+    return id;
+}
+
+void
+TimerWheel::DestroyTimer(TimerId id)
+{
+    NS_LOG_FUNCTION(this << id);
+    // the timers of a disposed wheel are already gone
+    if (id >= m_timers.size() || !m_timers[id].used)
+    {
+        return;
+    }
+    Cancel(id);
+    m_timers[id].callback = Callback<void>();
+    m_timers[id].used = false;
+    m_freeTimers.push_back(id);
+}
+
+void
+TimerWheel::SetFunction(TimerId id, const Callback<void>& callback)
+{
+    NS_LOG_FUNCTION(this << id);
+    if (m_disposed)
+    {
+        return;
+    }
+    NS_ASSERT(id < m_timers.size() && m_timers[id].used);
+    m_timers[id].callback = callback;
+}
+
+void
+TimerWheel::Schedule(TimerId id, const Time& delay)
+{
+    NS_LOG_FUNCTION(this << id << delay);
+    if (m_disposed)
+    {
+        return;
+    }
+    NS_ASSERT(id < m_timers.size() && m_timers[id].used);
+    NS_ASSERT(delay.IsPositive());
+
+    Entry& entry = m_timers[id];
+    if (entry.running)
+    {
+        Unlink(id);
+    }
+    entry.deadline = Simulator::Now() + delay;
+    entry.sequence = m_sequence++;
+    Link(id);
+
+    // a later deadline is handled by the pending event, when it expires
+    if (!m_expiring && (!m_event.IsRunning() ||
+                        static_cast<uint64_t>(entry.deadline.GetTimeStep()) < m_event.GetTs()))
+    {
+        m_event.Cancel();
+        m_event = Simulator::Schedule(delay, &TimerWheel::Expire, this);
+        m_nEvents++;
+    }
+}
+
+void
+TimerWheel::Cancel(TimerId id)
+{
+    NS_LOG_FUNCTION(this << id);
+    if (id < m_timers.size() && m_timers[id].running)
+    {
+        Unlink(id);
+    }
+}
+
+bool
+TimerWheel::IsRunning(TimerId id) const
+{
+    return id < m_timers.size() && m_timers[id].running;
+}
+
+Time
+TimerWheel::GetDelayLeft(TimerId id) const
+{
+    if (!IsRunning(id))
+    {
+        return Time(0);
+    }
+    return m_timers[id].deadline - Simulator::Now();
+}
+
+uint32_t
+TimerWheel::GetNRunning() const
+{
+    return m_nRunning;
+}
+
+uint64_t
+TimerWheel::GetNEvents() const
+{
+    return m_nEvents;
+}
+
+int64_t
+TimerWheel::GetTick(const Time& deadline) const
+{
+    return deadline.GetTimeStep() / m_granularity.GetTimeStep();
+}
+
+void
+TimerWheel::Link(TimerId id)
+{
+    Entry& entry = m_timers[id];
+    int64_t tick = GetTick(entry.deadline);
+    if (m_nRunning == 0 || tick < m_currentTick)
+    {
+        m_currentTick = tick;
+    }
+    uint32_t slot = tick % m_nSlots;
+    TimerId& head = m_slots[slot];
+    m_occupied[slot / 64] |= uint64_t(1) << (slot % 64);
+    entry.prev = NONE;
+    entry.next = head;
+    if (head != NONE)
+    {
+        m_timers[head].prev = id;
+    }
+    head = id;
+    entry.running = true;
+    m_nRunning++;
+}
+
+void
+TimerWheel::Unlink(TimerId id)
+{
+    Entry& entry = m_timers[id];
+    if (entry.prev != NONE)
+    {
+        m_timers[entry.prev].next = entry.next;
+    }
+    else
+    {
+        uint32_t slot = GetTick(entry.deadline) % m_nSlots;
+        m_slots[slot] = entry.next;
+        if (entry.next == NONE)
+        {
+            m_occupied[slot / 64] &= ~(uint64_t(1) << (slot % 64));
+        }
+    }
+    if (entry.next != NONE)
+    {
+        m_timers[entry.next].prev = entry.prev;
+    }
+    entry.running = false;
+    m_nRunning--;
+}
+
+uint32_t
+TimerWheel::FindOccupied(uint32_t from, uint32_t to) const
+{
+    for (uint32_t slot = from; slot < to; slot = (slot / 64 + 1) * 64)
+    {
+        uint64_t word = m_occupied[slot / 64] >> (slot % 64);
+        if (word != 0)
+        {
+            return std::min(slot + CountTrailingZeros(word), to);
+        }
+    }
+    return to;
+}
+
+void
+TimerWheel::ScheduleNext()
+{
+    NS_LOG_FUNCTION(this);
+    m_event.Cancel();
+    if (m_nRunning == 0)
+    {
+        return;
+    }
+
+    // Look for the earliest deadline in the slots of the next turn of the
+    // wheel, skipping the empty ones. The timers beyond the next turn are met
+    // on the way, and the earliest of them is used if there is none.
+    Time next = Time::Max();
+    Time later = Time::Max();
+    uint32_t first = m_currentTick % m_nSlots;
+    auto findNext = [&](uint32_t from, uint32_t to) {
+        for (uint32_t slot = FindOccupied(from, to); slot < to; slot = FindOccupied(slot + 1, to))
+        {
+            int64_t tick = m_currentTick + (slot + m_nSlots - first) % m_nSlots;
+            for (TimerId id = m_slots[slot]; id != NONE; id = m_timers[id].next)
+            {
+                if (GetTick(m_timers[id].deadline) == tick)
+                {
+                    next = std::min(next, m_timers[id].deadline);
+                }
+                else
+                {
+                    later = std::min(later, m_timers[id].deadline);
+                }
+            }
+            if (next != Time::Max())
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+    if (!findNext(first, m_nSlots) && !findNext(0, first))
+    {
+        next = later;
+    }
+    m_currentTick = GetTick(next);
+
+    m_event = Simulator::Schedule(next - Simulator::Now(), &TimerWheel::Expire, this);
+    m_nEvents++;
+}
+
+void
+TimerWheel::Expire()
+{
+    NS_LOG_FUNCTION(this);
+    Time now = Simulator::Now();
+    int64_t nowTick = GetTick(now);
+
+    // The running timers are not earlier than m_currentTick
+    m_expired.clear();
+    int64_t lastTick = std::min<int64_t>(nowTick, m_currentTick + m_nSlots - 1);
+    for (int64_t tick = m_currentTick; tick <= lastTick; tick++)
+    {
+        for (TimerId id = m_slots[tick % m_nSlots]; id != NONE; id = m_timers[id].next)
+        {
+            if (m_timers[id].deadline <= now)
+            {
+                m_expired.push_back(id);
+            }
+        }
+    }
+    m_currentTick = nowTick;
+
+    // Invoke the timers in the order of their deadlines and of their arming
+    std::sort(m_expired.begin(), m_expired.end(), [this](TimerId a, TimerId b) {
+        return m_timers[a].deadline < m_timers[b].deadline ||
+               (m_timers[a].deadline == m_timers[b].deadline &&
+                m_timers[a].sequence < m_timers[b].sequence);
+    });
+    std::vector<TimerId> expired;
+    expired.swap(m_expired);
+    m_expiring = true;
+    for (TimerId id : expired)
+    {
+        // the previous callbacks may have re-armed or cancelled the timer
+        if (id < m_timers.size() && m_timers[id].running && m_timers[id].deadline <= now)
+        {
+            Unlink(id);
+            Callback<void> callback = m_timers[id].callback;
+            callback();
+        }
+    }
+    m_expiring = false;
+    expired.clear();
+    expired.swap(m_expired);
+
+    ScheduleNext();
+}
+
+TimerWheelEvent::TimerWheelEvent()
+    : m_wheel(nullptr),
+      m_id(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TimerWheelEvent::~TimerWheelEvent()
+{
+    NS_LOG_FUNCTION(this);
+    Cancel();
+    SetTimerWheel(nullptr);
+}
+
+void
+TimerWheelEvent::SetTimerWheel(Ptr<TimerWheel> wheel)
+{
+    NS_LOG_FUNCTION(this << wheel);
+    if (wheel == m_wheel)
+    {
+        return;
+    }
+    Cancel();
+    if (m_wheel)
+    {
+        m_wheel->DestroyTimer(m_id);
+    }
+    m_wheel = wheel;
+    if (m_wheel)
+    {
+        m_id = m_wheel->CreateTimer(m_callback);
+    }
+}
+
+Ptr<TimerWheel>
+TimerWheelEvent::GetTimerWheel() const
+{
+    return m_wheel;
+}
+
+void
+TimerWheelEvent::SetFunction(const Callback<void>& callback)
+{
+    NS_LOG_FUNCTION(this);
+    m_callback = callback;
+    if (m_wheel)
+    {
+        m_wheel->SetFunction(m_id, callback);
+    }
+}
+
+void
+TimerWheelEvent::Schedule(const Time& delay)
+{
+    NS_LOG_FUNCTION(this << delay);
+    m_event.Cancel();
+    if (m_wheel)
+    {
+        m_wheel->Schedule(m_id, delay);
+    }
+    else
+    {
+        m_event = Simulator::Schedule(delay, m_callback);
+    }
+}
+
+TimerWheelEvent&
+TimerWheelEvent::operator=(const EventId& event)
+{
+    NS_LOG_FUNCTION(this);
+    Cancel();
+    m_event = event;
+    return *this;
+}
+
+void
+TimerWheelEvent::Cancel()
+{
+    NS_LOG_FUNCTION(this);
+    m_event.Cancel();
+    if (m_wheel)
+    {
+        m_wheel->Cancel(m_id);
+    }
+}
+
+bool
+TimerWheelEvent::IsExpired() const
+{
+    return !IsRunning();
+}
+
+bool
+TimerWheelEvent::IsRunning() const
+{
+    return m_event.IsRunning() || (m_wheel && m_wheel->IsRunning(m_id));
+}
+
+Time
+TimerWheelEvent::GetDelayLeft() const
+{
+    if (m_wheel && m_wheel->IsRunning(m_id))
+    {
+        return m_wheel->GetDelayLeft(m_id);
+    }
+    return Simulator::GetDelayLeft(m_event);
+}
+
+} // namespace ns3
@@ -0,0 +1,311 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "callback.h"
+#include "event-id.h"
+#include "nstime.h"
+#include "object.h"
+
+#include <vector>
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::TimerWheel class declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup timer
+ * \brief A set of timers sharing a single simulator event.
+ *
+ * The timers of the wheel expire exactly at their deadline, but the wheel
+ * keeps at most one event in the simulator, for the earliest deadline.
+ * Re-arming a timer
+ * (i.e., calling Schedule on a running timer) updates its deadline in place:
+ * no simulator event is cancelled or scheduled, unless the new deadline is
+ * earlier than the one of the pending event. When the pending event finds
+ * no expired timer, because they have been re-armed or cancelled in the
+ * meantime, it is scheduled again for the earliest deadline.
+ *
+ * This suits the timers that are pushed forward much more often than they
+ * expire, e.g., the retransmission timer of a transport protocol, which is
+ * re-armed by every acknowledgment.
+ *
+ * The timers expiring at the same time are invoked in the order in which
+ * they were armed. This is not the order of Simulator::Schedule with
+ * respect to the other events of the simulator, though: the timers are
+ * invoked by the event of the wheel, which was scheduled when the earliest
+ * deadline was set, so that they may run before or after the other events
+ * expiring at the same time.
+ *
+ * The timers are kept in a hashed wheel of slots, each one covering a
+ * period of length Granularity, and a bitmap of the slots holding timers
+ * lets finding the earliest deadline skip the empty slots. The granularity
+ * does not affect the expiration times.
+ *
+ * A wheel is usually shared by all the users of a Node, see GetTimerWheel.
+ * The callbacks of the timers are invoked in the context that was current
+ * when the pending event was scheduled.
+ */
+class TimerWheel : public Object
+{
+  public:
+    /// Identifier of a timer of the wheel
+    typedef uint32_t TimerId;
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    TimerWheel();
+    ~TimerWheel() override;
+
+    /**
+     * \brief Get the timer wheel aggregated to an object
+     *
+     * A new timer wheel is aggregated to the object if it has none.
+     *
+     * \param object the object, e.g., a Node
+     * \return the timer wheel of the object
+     */
+    static Ptr<TimerWheel> GetTimerWheel(Ptr<Object> object);
+
+    /**
+     * \brief Create a timer
+     *
+     * The timers created after the wheel is disposed never run.
+     *
+     * \param callback the function invoked when the timer expires
+     * \return the identifier of the timer
+     */
+    TimerId CreateTimer(const Callback<void>& callback);
+
+    /**
+     * \brief Destroy a timer, cancelling it if it is running
+     *
+     * The identifier may be reused by the timers created afterwards.
+     *
+     * \param id the identifier of the timer
+     */
+    void DestroyTimer(TimerId id);
+
+    /**
+     * \brief Set the function invoked when a timer expires
+     *
+     * Nothing is done if the wheel has been disposed.
+     *
+     * \param id the identifier of the timer
+     * \param callback the function
+     */
+    void SetFunction(TimerId id, const Callback<void>& callback);
+
+    /**
+     * \brief Arm a timer, or re-arm it if it is running
+     *
+     * Nothing is done if the wheel has been disposed.
+     *
+     * \param id the identifier of the timer
+     * \param delay the delay after which the timer expires
+     */
+    void Schedule(TimerId id, const Time& delay);
+
+    /**
+     * \brief Cancel a timer
+     * \param id the identifier of the timer
+     */
+    void Cancel(TimerId id);
+
+    /**
+     * \param id the identifier of the timer
+     * \return true if the timer is running, false otherwise
+     */
+    bool IsRunning(TimerId id) const;
+
+    /**
+     * \param id the identifier of the timer
+     * \return the time left before the timer expires, or zero if it is not
+     *         running
+     */
+    Time GetDelayLeft(TimerId id) const;
+
+    /**
+     * \return the number of running timers
+     */
+    uint32_t GetNRunning() const;
+
+    /**
+     * \return the number of events scheduled in the simulator by the wheel
+     */
+    uint64_t GetNEvents() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// Marks the end of the list of timers of a slot
+    static const TimerId NONE = 0xffffffff;
+
+    /// A timer of the wheel
+    struct Entry
+    {
+        Callback<void> callback; //!< Function invoked when the timer expires
+        Time deadline;           //!< Expiration time
+        uint64_t sequence;       //!< Order of arming, to break the ties of the deadlines
+        TimerId prev;            //!< Previous timer in the slot
+        TimerId next;            //!< Next timer in the slot
+        bool running;            //!< Whether the timer is running
+        bool used;               //!< Whether the timer has been created and not destroyed
+    };
+
+    /**
+     * \param deadline an expiration time
+     * \return the tick of the wheel containing the time
+     */
+    int64_t GetTick(const Time& deadline) const;
+
+    /**
+     * \brief Insert a running timer in the slot of its deadline
+     * \param id the identifier of the timer
+     */
+    void Link(TimerId id);
+
+    /**
+     * \brief Remove a running timer from its slot
+     * \param id the identifier of the timer
+     */
+    void Unlink(TimerId id);
+
+    /**
+     * \param from the first slot
+     * \param to the slot after the last one
+     * \return the first slot holding timers in [from, to), or to if there is
+     *         none
+     */
+    uint32_t FindOccupied(uint32_t from, uint32_t to) const;
+
+    /**
+     * \brief Schedule the event of the wheel for the earliest deadline
+     */
+    void ScheduleNext();
+
+    /**
+     * \brief Invoke the expired timers and schedule the next event
+     */
+    void Expire();
+
+    Time m_granularity;                //!< Length of the period covered by a slot
+    uint32_t m_nSlots;                 //!< Number of slots
+    std::vector<Entry> m_timers;       //!< The timers, indexed by identifier
+    std::vector<TimerId> m_freeTimers; //!< Identifiers of the destroyed timers
+    std::vector<TimerId> m_slots;      //!< First timer of each slot
+    std::vector<uint64_t> m_occupied;  //!< Bitmap of the slots holding timers
+    std::vector<TimerId> m_expired;    //!< Timers found expired by Expire
+    int64_t m_currentTick;             //!< Earliest tick that may hold a running timer
+    uint32_t m_nRunning;               //!< Number of running timers
+    uint64_t m_sequence;               //!< Counter of the arming of the timers
+    EventId m_event;                   //!< Event of the earliest deadline
+    bool m_expiring;                   //!< Whether Expire is invoking the timers
+    bool m_disposed;                   //!< Whether the wheel has been disposed
+    uint64_t m_nEvents;                //!< Number of events scheduled
+};
+
+/**
+ * \ingroup timer
+ * \brief A timer of a TimerWheel, used like an EventId.
+ *
+ * The timer is armed with Schedule, which re-arms it in place in the wheel.
+ * Without a wheel, e.g., before the owner of the timer knows its Node, the
+ * timer is an ordinary simulator event. An EventId returned by
+ * Simulator::Schedule can also be assigned to the timer, which then behaves
+ * as that event until it is cancelled or armed again.
+ */
+class TimerWheelEvent
+{
+  public:
+    TimerWheelEvent();
+    ~TimerWheelEvent();
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    TimerWheelEvent(const TimerWheelEvent&) = delete;
+    TimerWheelEvent& operator=(const TimerWheelEvent&) = delete;
+
+    /**
+     * \brief Move the timer to a timer wheel, cancelling it
+     * \param wheel the timer wheel, or nullptr to use simulator events
+     */
+    void SetTimerWheel(Ptr<TimerWheel> wheel);
+
+    /**
+     * \return the timer wheel of the timer, or nullptr if it has none
+     */
+    Ptr<TimerWheel> GetTimerWheel() const;
+
+    /**
+     * \brief Set the function invoked when the timer expires
+     * \param callback the function
+     */
+    void SetFunction(const Callback<void>& callback);
+
+    /**
+     * \brief Arm the timer, or re-arm it if it is running
+     * \param delay the delay after which the timer expires
+     */
+    void Schedule(const Time& delay);
+
+    /**
+     * \brief Replace the timer with a simulator event
+     * \param event the event
+     * \return this timer
+     */
+    TimerWheelEvent& operator=(const EventId& event);
+
+    /**
+     * \brief Cancel the timer
+     */
+    void Cancel();
+
+    /**
+     * \return true if the timer is not running, false otherwise
+     */
+    bool IsExpired() const;
+
+    /**
+     * \return true if the timer is running, false otherwise
+     */
+    bool IsRunning() const;
+
+    /**
+     * \return the time left before the timer expires, or zero if it is not
+     *         running
+     */
+    Time GetDelayLeft() const;
+
+  private:
+    Ptr<TimerWheel> m_wheel;   //!< Timer wheel, if any
+    TimerWheel::TimerId m_id;  //!< Timer of the wheel
+    Callback<void> m_callback; //!< Function invoked when the timer expires
+    EventId m_event;           //!< Simulator event used instead of the wheel
+};
+
+} // namespace ns3
+
+#endif /* TIMER_WHEEL_H */
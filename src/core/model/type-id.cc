@@ -18,14 +18,17 @@
  */
 #include "type-id.h"
 
+#include "environment-variable.h"
 #include "hash.h"
 #include "log.h" // NS_ASSERT and NS_LOG
 #include "singleton.h"
+#include "string.h"
 #include "trace-source-accessor.h"
 
 #include <iomanip>
 #include <map>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 
 /**
@@ -53,6 +56,11 @@ NS_LOG_COMPONENT_DEFINE("TypeId");
  * Information records are stored in a vector.  Name and hash lookup
  * are performed by maps to the vector index.
  *
+ * The attribute and trace source names are interned: each distinct name
+ * is given a small integer, and each record indexes its attributes and
+ * trace sources by interned name.  A lookup by name hashes the name once,
+ * then walks the parent chain with one integer lookup per TypeId.
+ *
  * \internal
  * <b>Hash Chaining</b>
  *
@@ -269,22 +277,55 @@ class IidManager : public Singleton<IidManager>
      * \returns \c true if this TypeId should be hidden from the user.
      */
     bool MustHideFromDocumentation(uint16_t uid) const;
+    /**
+     * Intern an attribute or trace source name.
+     * \param [in] name The name.
+     * \returns The interned name.
+     */
+    TypeId::name_t InternName(const std::string& name);
+    /**
+     * Get an interned name, without interning it.
+     * \param [in] name The name.
+     * \returns The interned name, or 0 if \pname{name} was never interned.
+     */
+    TypeId::name_t FindName(const std::string& name) const;
+    /**
+     * Find an attribute of a type id or of its parents.
+     * \param [in] uid The id.
+     * \param [in] name The interned attribute name.
+     * \returns The attribute information, or \c nullptr if not found.
+     */
+    const TypeId::AttributeInformation* LookupAttribute(uint16_t uid, TypeId::name_t name) const;
+    /**
+     * Find a trace source of a type id or of its parents.
+     * \param [in] uid The id.
+     * \param [in] name The interned trace source name.
+     * \returns The trace source information, or \c nullptr if not found.
+     */
+    const TypeId::TraceSourceInformation* LookupTraceSource(uint16_t uid,
+                                                            TypeId::name_t name) const;
+    /**
+     * Get the attributes set when constructing an object of a type id.
+     * \param [in] uid The id.
+     * \returns The attributes of the type id and of its parents.
+     */
+    std::shared_ptr<const TypeId::ConstructionList> GetConstructionList(uint16_t uid);
 
   private:
     /**
      * Check if a type id has a given TraceSource.
      * \param [in] uid The id.
-     * \param [in] name The TraceSource name.
+     * \param [in] name The interned TraceSource name.
      * \returns \c true if \pname{uid} has the TraceSource \pname{name}.
      */
-    bool HasTraceSource(uint16_t uid, std::string name);
+    bool HasTraceSource(uint16_t uid, TypeId::name_t name);
     /**
      * Check if a type id has a given Attribute.
      * \param [in] uid The id.
-     * \param [in] name The Attribute name.
+     * \param [in] name The interned Attribute name.
      * \returns \c true if \pname{uid} has the Attribute \pname{name}.
      */
-    bool HasAttribute(uint16_t uid, std::string name);
+    bool HasAttribute(uint16_t uid, TypeId::name_t name);
     /**
      * Hashing function.
      * \param [in] name The type id name.
@@ -319,6 +360,19 @@ class IidManager : public Singleton<IidManager>
         TypeId::SupportLevel supportLevel;
         /** Support message. */
         std::string supportMsg;
+        /** The index of the Attributes, by interned name. */
+        std::unordered_map<TypeId::name_t, std::size_t> attributeIndex;
+        /** The index of the TraceSources, by interned name. */
+        std::unordered_map<TypeId::name_t, std::size_t> traceSourceIndex;
+        /** The attributes set at construction, built on demand. */
+        std::shared_ptr<const TypeId::ConstructionList> construction;
+        /** The value of m_generation when \c construction was built. */
+        uint32_t constructionGeneration;
+        /**
+         * The generation of the EnvironmentVariable cache when \c construction
+         * was built.
+         */
+        uint32_t constructionEnvGeneration;
     };
 
     /** Iterator type. */
@@ -344,6 +398,15 @@ class IidManager : public Singleton<IidManager>
     /** The by-hash index. */
     hashmap_t m_hashmap;
 
+    /** The interned attribute and trace source names. */
+    std::unordered_map<std::string, TypeId::name_t> m_names;
+
+    /**
+     * Incremented when an attribute, an initial value or a parent changes,
+     * to rebuild the construction lists.
+     */
+    uint32_t m_generation{0};
+
     /** IidManager constants. */
     enum
     {
@@ -440,6 +503,8 @@ IidManager::AllocateUid(std::string name)
     information.hasConstructor = false;
     information.mustHideFromDocumentation = false;
     information.supportLevel = TypeId::SUPPORTED;
+    information.constructionGeneration = 0;
+    information.constructionEnvGeneration = 0;
     m_information.push_back(information);
     std::size_t tuid = m_information.size();
     NS_ASSERT(tuid <= 0xffff);
@@ -468,6 +533,7 @@ IidManager::SetParent(uint16_t uid, uint16_t parent)
     NS_ASSERT(parent <= m_information.size());
     IidInformation* information = LookupInformation(uid);
     information->parent = parent;
+    m_generation++;
 }
 
 void
@@ -621,35 +687,12 @@ IidManager::GetRegistered(uint16_t i) const
 }
 
 bool
-IidManager::HasAttribute(uint16_t uid, std::string name)
+IidManager::HasAttribute(uint16_t uid, TypeId::name_t name)
 {
     NS_LOG_FUNCTION(IID << uid << name);
-    IidInformation* information = LookupInformation(uid);
-    while (true)
-    {
-        for (std::vector<TypeId::AttributeInformation>::const_iterator i =
-                 information->attributes.begin();
-             i != information->attributes.end();
-             ++i)
-        {
-            if (i->name == name)
-            {
-                NS_LOG_LOGIC(IIDL << true);
-                return true;
-            }
-        }
-        IidInformation* parent = LookupInformation(information->parent);
-        if (parent == information)
-        {
-            // top of inheritance tree
-            NS_LOG_LOGIC(IIDL << false);
-            return false;
-        }
-        // check parent
-        information = parent;
-    }
-    NS_LOG_LOGIC(IIDL << false);
-    return false;
+    bool has = LookupAttribute(uid, name) != nullptr;
+    NS_LOG_LOGIC(IIDL << has);
+    return has;
 }
 
 void
@@ -672,7 +715,8 @@ IidManager::AddAttribute(uint16_t uid,
                                            << "encountered when registering TypeId \""
                                            << information->name << "\"");
     }
-    if (HasAttribute(uid, name))
+    TypeId::name_t id = InternName(name);
+    if (HasAttribute(uid, id))
     {
         NS_FATAL_ERROR("Attribute \"" << name << "\" already registered on tid=\""
                                       << information->name << "\"");
@@ -688,6 +732,8 @@ IidManager::AddAttribute(uint16_t uid,
     info.supportLevel = supportLevel;
     info.supportMsg = supportMsg;
     information->attributes.push_back(info);
+    information->attributeIndex[id] = information->attributes.size() - 1;
+    m_generation++;
     NS_LOG_LOGIC(IIDL << information->attributes.size() - 1);
 }
 
@@ -700,6 +746,7 @@ IidManager::SetAttributeInitialValue(uint16_t uid,
     IidInformation* information = LookupInformation(uid);
     NS_ASSERT(i < information->attributes.size());
     information->attributes[i].initialValue = initialValue;
+    m_generation++;
 }
 
 std::size_t
@@ -723,35 +770,12 @@ IidManager::GetAttribute(uint16_t uid, std::size_t i) const
 }
 
 bool
-IidManager::HasTraceSource(uint16_t uid, std::string name)
+IidManager::HasTraceSource(uint16_t uid, TypeId::name_t name)
 {
     NS_LOG_FUNCTION(IID << uid << name);
-    IidInformation* information = LookupInformation(uid);
-    while (true)
-    {
-        for (std::vector<TypeId::TraceSourceInformation>::const_iterator i =
-                 information->traceSources.begin();
-             i != information->traceSources.end();
-             ++i)
-        {
-            if (i->name == name)
-            {
-                NS_LOG_LOGIC(IIDL << true);
-                return true;
-            }
-        }
-        IidInformation* parent = LookupInformation(information->parent);
-        if (parent == information)
-        {
-            // top of inheritance tree
-            NS_LOG_LOGIC(IIDL << false);
-            return false;
-        }
-        // check parent
-        information = parent;
-    }
-    NS_LOG_LOGIC(IIDL << false);
-    return false;
+    bool has = LookupTraceSource(uid, name) != nullptr;
+    NS_LOG_LOGIC(IIDL << has);
+    return has;
 }
 
 void
@@ -766,7 +790,8 @@ IidManager::AddTraceSource(uint16_t uid,
     NS_LOG_FUNCTION(IID << uid << name << help << accessor << callback << supportLevel
                         << supportMsg);
     IidInformation* information = LookupInformation(uid);
-    if (HasTraceSource(uid, name))
+    TypeId::name_t id = InternName(name);
+    if (HasTraceSource(uid, id))
     {
         NS_FATAL_ERROR("Trace source \"" << name << "\" already registered on tid=\""
                                          << information->name << "\"");
@@ -779,6 +804,7 @@ IidManager::AddTraceSource(uint16_t uid,
     source.supportLevel = supportLevel;
     source.supportMsg = supportMsg;
     information->traceSources.push_back(source);
+    information->traceSourceIndex[id] = information->traceSources.size() - 1;
     NS_LOG_LOGIC(IIDL << information->traceSources.size() - 1);
 }
 
@@ -812,6 +838,127 @@ IidManager::MustHideFromDocumentation(uint16_t uid) const
     return hide;
 }
 
+TypeId::name_t
+IidManager::InternName(const std::string& name)
+{
+    NS_LOG_FUNCTION(IID << name);
+    // The interned names start at 1, 0 is never interned
+    auto it = m_names.emplace(name, static_cast<TypeId::name_t>(m_names.size() + 1)).first;
+    NS_LOG_LOGIC(IIDL << it->second);
+    return it->second;
+}
+
+TypeId::name_t
+IidManager::FindName(const std::string& name) const
+{
+    NS_LOG_FUNCTION(IID << name);
+    auto it = m_names.find(name);
+    TypeId::name_t id = (it != m_names.end()) ? it->second : 0;
+    NS_LOG_LOGIC(IIDL << id);
+    return id;
+}
+
+const TypeId::AttributeInformation*
+IidManager::LookupAttribute(uint16_t uid, TypeId::name_t name) const
+{
+    NS_LOG_FUNCTION(IID << uid << name);
+    IidInformation* information = LookupInformation(uid);
+    while (true)
+    {
+        auto it = information->attributeIndex.find(name);
+        if (it != information->attributeIndex.end())
+        {
+            return &information->attributes[it->second];
+        }
+        IidInformation* parent = LookupInformation(information->parent);
+        if (parent == information)
+        {
+            // top of inheritance tree
+            return nullptr;
+        }
+        // check parent
+        information = parent;
+    }
+}
+
+const TypeId::TraceSourceInformation*
+IidManager::LookupTraceSource(uint16_t uid, TypeId::name_t name) const
+{
+    NS_LOG_FUNCTION(IID << uid << name);
+    IidInformation* information = LookupInformation(uid);
+    while (true)
+    {
+        auto it = information->traceSourceIndex.find(name);
+        if (it != information->traceSourceIndex.end())
+        {
+            return &information->traceSources[it->second];
+        }
+        IidInformation* parent = LookupInformation(information->parent);
+        if (parent == information)
+        {
+            // top of inheritance tree
+            return nullptr;
+        }
+        // check parent
+        information = parent;
+    }
+}
+
+std::shared_ptr<const TypeId::ConstructionList>
+IidManager::GetConstructionList(uint16_t uid)
+{
+    NS_LOG_FUNCTION(IID << uid);
+    IidInformation* information = LookupInformation(uid);
+    // NS_ATTRIBUTE_DEFAULT is read again when the cached environment
+    // variables are cleared
+    uint32_t envGeneration = EnvironmentVariable::GetGeneration();
+    if (information->construction && information->constructionGeneration == m_generation &&
+        information->constructionEnvGeneration == envGeneration)
+    {
+        return information->construction;
+    }
+
+    NS_LOG_LOGIC(IIDL << "building the construction list of " << information->name);
+    auto construction = std::make_shared<TypeId::ConstructionList>();
+    IidInformation* current = information;
+    while (true)
+    {
+        for (const auto& attribute : current->attributes)
+        {
+            TypeId::ConstructionInformation info;
+            info.name = current->name + "::" + attribute.name;
+            info.flags = attribute.flags;
+            info.initial = true;
+            info.accessor = attribute.accessor;
+            info.checker = attribute.checker;
+            if (attribute.flags & TypeId::ATTR_CONSTRUCT)
+            {
+                auto [found, val] = EnvironmentVariable::Get("NS_ATTRIBUTE_DEFAULT", info.name);
+                if (found)
+                {
+                    info.value = Create<StringValue>(val);
+                    info.initial = false;
+                }
+                else
+                {
+                    info.value = attribute.initialValue;
+                }
+            }
+            construction->push_back(info);
+        }
+        IidInformation* parent = LookupInformation(current->parent);
+        if (parent == current)
+        {
+            break;
+        }
+        current = parent;
+    }
+    information->construction = construction;
+    information->constructionGeneration = m_generation;
+    information->constructionEnvGeneration = envGeneration;
+    return construction;
+}
+
 } // namespace ns3
 
 namespace ns3
@@ -845,6 +992,13 @@ TypeId::LookupByName(std::string name)
     return TypeId(uid);
 }
 
+TypeId::name_t
+TypeId::InternName(const std::string& name)
+{
+    NS_LOG_FUNCTION(name);
+    return IidManager::Get()->InternName(name);
+}
+
 bool
 TypeId::LookupByNameFailSafe(std::string name, TypeId* tid)
 {
@@ -898,38 +1052,36 @@ bool
 TypeId::LookupAttributeByName(std::string name, TypeId::AttributeInformation* info) const
 {
     NS_LOG_FUNCTION(this << name << info);
-    TypeId tid;
-    TypeId nextTid = *this;
-    do
+    name_t id = IidManager::Get()->FindName(name);
+    if (id == 0)
     {
-        tid = nextTid;
-        for (std::size_t i = 0; i < tid.GetAttributeN(); i++)
-        {
-            TypeId::AttributeInformation tmp = tid.GetAttribute(i);
-            if (tmp.name == name)
-            {
-                if (tmp.supportLevel == TypeId::SUPPORTED)
-                {
-                    *info = tmp;
-                    return true;
-                }
-                else if (tmp.supportLevel == TypeId::DEPRECATED)
-                {
-                    std::cerr << "Attribute '" << name << "' is deprecated: " << tmp.supportMsg
-                              << std::endl;
-                    *info = tmp;
-                    return true;
-                }
-                else if (tmp.supportLevel == TypeId::OBSOLETE)
-                {
-                    NS_FATAL_ERROR("Attribute '" << name << "' is obsolete, with no fallback: "
-                                                 << tmp.supportMsg);
-                }
-            }
-        }
-        nextTid = tid.GetParent();
-    } while (nextTid != tid);
-    return false;
+        // No TypeId has an attribute with this name
+        return false;
+    }
+    return LookupAttributeByName(id, info);
+}
+
+bool
+TypeId::LookupAttributeByName(name_t name, TypeId::AttributeInformation* info) const
+{
+    NS_LOG_FUNCTION(this << name << info);
+    const AttributeInformation* tmp = IidManager::Get()->LookupAttribute(m_tid, name);
+    if (tmp == nullptr)
+    {
+        return false;
+    }
+    if (tmp->supportLevel == TypeId::DEPRECATED)
+    {
+        std::cerr << "Attribute '" << tmp->name << "' is deprecated: " << tmp->supportMsg
+                  << std::endl;
+    }
+    else if (tmp->supportLevel == TypeId::OBSOLETE)
+    {
+        NS_FATAL_ERROR("Attribute '" << tmp->name
+                                     << "' is obsolete, with no fallback: " << tmp->supportMsg);
+    }
+    *info = *tmp;
+    return true;
 }
 
 TypeId
@@ -1164,39 +1316,43 @@ Ptr<const TraceSourceAccessor>
 TypeId::LookupTraceSourceByName(std::string name, TraceSourceInformation* info) const
 {
     NS_LOG_FUNCTION(this << name);
-    TypeId tid;
-    TypeId nextTid = *this;
-    TypeId::TraceSourceInformation tmp;
-    do
+    name_t id = IidManager::Get()->FindName(name);
+    if (id == 0)
     {
-        tid = nextTid;
-        for (std::size_t i = 0; i < tid.GetTraceSourceN(); i++)
-        {
-            tmp = tid.GetTraceSource(i);
-            if (tmp.name == name)
-            {
-                if (tmp.supportLevel == TypeId::SUPPORTED)
-                {
-                    *info = tmp;
-                    return tmp.accessor;
-                }
-                else if (tmp.supportLevel == TypeId::DEPRECATED)
-                {
-                    std::cerr << "TraceSource '" << name << "' is deprecated: " << tmp.supportMsg
-                              << std::endl;
-                    *info = tmp;
-                    return tmp.accessor;
-                }
-                else if (tmp.supportLevel == TypeId::OBSOLETE)
-                {
-                    NS_FATAL_ERROR("TraceSource '" << name << "' is obsolete, with no fallback: "
-                                                   << tmp.supportMsg);
-                }
-            }
-        }
-        nextTid = tid.GetParent();
-    } while (nextTid != tid);
-    return nullptr;
+        // No TypeId has a trace source with this name
+        return nullptr;
+    }
+    return LookupTraceSourceByName(id, info);
+}
+
+Ptr<const TraceSourceAccessor>
+TypeId::LookupTraceSourceByName(name_t name, TraceSourceInformation* info) const
+{
+    NS_LOG_FUNCTION(this << name);
+    const TraceSourceInformation* tmp = IidManager::Get()->LookupTraceSource(m_tid, name);
+    if (tmp == nullptr)
+    {
+        return nullptr;
+    }
+    if (tmp->supportLevel == TypeId::DEPRECATED)
+    {
+        std::cerr << "TraceSource '" << tmp->name << "' is deprecated: " << tmp->supportMsg
+                  << std::endl;
+    }
+    else if (tmp->supportLevel == TypeId::OBSOLETE)
+    {
+        NS_FATAL_ERROR("TraceSource '" << tmp->name
+                                       << "' is obsolete, with no fallback: " << tmp->supportMsg);
+    }
+    *info = *tmp;
+    return tmp->accessor;
+}
+
+std::shared_ptr<const TypeId::ConstructionList>
+TypeId::GetConstructionList() const
+{
+    NS_LOG_FUNCTION(this);
+    return IidManager::Get()->GetConstructionList(m_tid);
 }
 
 Ptr<const TraceSourceAccessor>
@@ -26,8 +26,10 @@
 #include "hash.h"
 #include "trace-source-accessor.h"
 
+#include <memory>
 #include <stdint.h>
 #include <string>
+#include <vector>
 
 /**
  * \file
@@ -116,9 +118,38 @@ class TypeId
         std::string supportMsg;
     };
 
+    /**
+     * Attribute set when constructing an object, with the value it gets
+     * when the attributes of the construction do not provide one.
+     */
+    struct ConstructionInformation
+    {
+        /** Attribute full name, for logging. */
+        std::string name;
+        /** AttributeFlags value. */
+        uint32_t flags;
+        /**
+         * The value from the NS_ATTRIBUTE_DEFAULT environment variable,
+         * otherwise the configured initial value.
+         */
+        Ptr<const AttributeValue> value;
+        /** \c true if \c value is the configured initial value. */
+        bool initial;
+        /** Accessor object. */
+        Ptr<const AttributeAccessor> accessor;
+        /** Checker object. */
+        Ptr<const AttributeChecker> checker;
+    };
+
+    /** The attributes set when constructing an object, in the order they are set. */
+    typedef std::vector<ConstructionInformation> ConstructionList;
+
     /** Type of hash values. */
     typedef uint32_t hash_t;
 
+    /** Type of the interned attribute and trace source names. */
+    typedef uint32_t name_t;
+
     /**
      * Get a TypeId by name.
      *
@@ -158,6 +189,20 @@ class TypeId
      */
     static bool LookupByHashFailSafe(hash_t hash, TypeId* tid);
 
+    /**
+     * Intern an attribute or trace source name.
+     *
+     * \param [in] name The name of an attribute or trace source.
+     * \returns The interned name.
+     *
+     * Equal names are interned to equal values, which can be looked up
+     * with LookupAttributeByName(name_t, AttributeInformation*) and
+     * LookupTraceSourceByName(name_t, TraceSourceInformation*) without
+     * hashing or comparing strings.  Code looking up the same names many
+     * times should intern them once.
+     */
+    static name_t InternName(const std::string& name);
+
     /**
      * Get the number of registered TypeIds.
      *
@@ -474,6 +519,18 @@ class TypeId
      * \returns \c true if the requested attribute could be found.
      */
     bool LookupAttributeByName(std::string name, AttributeInformation* info) const;
+    /**
+     * Find an Attribute by interned name, retrieving the associated
+     * AttributeInformation.
+     *
+     * \param [in]  name The interned name of the requested attribute,
+     *              see InternName().
+     * \param [in,out] info A pointer to the TypeId::AttributeInformation
+     *              data structure where the result value of this method
+     *              will be stored.
+     * \returns \c true if the requested attribute could be found.
+     */
+    bool LookupAttributeByName(name_t name, AttributeInformation* info) const;
     /**
      * Find a TraceSource by name.
      *
@@ -498,6 +555,34 @@ class TypeId
      */
     Ptr<const TraceSourceAccessor> LookupTraceSourceByName(std::string name,
                                                            TraceSourceInformation* info) const;
+    /**
+     * Find a TraceSource by interned name, retrieving the associated
+     * TraceSourceInformation.
+     *
+     * \param [in]  name The interned name of the requested trace source,
+     *              see InternName().
+     * \param [out] info A pointer to the TypeId::TraceSourceInformation
+     *              data structure where the result value of this method
+     *              will be stored.
+     * \return The trace source accessor which can be used to connect
+     *  and disconnect trace sinks with the requested trace source on
+     *  an object instance.
+     */
+    Ptr<const TraceSourceAccessor> LookupTraceSourceByName(name_t name,
+                                                           TraceSourceInformation* info) const;
+
+    /**
+     * Get the attributes set when constructing an object of this TypeId.
+     *
+     * \returns The attributes of this TypeId and of its parents, in the
+     *          order they are set by ObjectBase::ConstructSelf.
+     *
+     * The list is built on the first call and shared by all the objects
+     * of this TypeId, until an attribute or an initial value of this
+     * TypeId or of its parents changes.  This is really an internal
+     * method which users are not expected to use.
+     */
+    std::shared_ptr<const ConstructionList> GetConstructionList() const;
 
     /**
      * Get the internal id of this TypeId.
@@ -864,6 +864,140 @@ SearchAttributesOfParentObjectsTestCase::DoRun()
     NS_TEST_ASSERT_MSG_EQ(iv.Get(), 42, "Object Attribute \"X\" not settable in derived class");
 }
 
+/**
+ * \ingroup config-tests
+ * Test for the paths parsed once with Config::Path.
+ */
+class PathConfigTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    PathConfigTestCase();
+
+    /** Destructor. */
+    ~PathConfigTestCase() override
+    {
+    }
+
+    /**
+     * Trace callback with context path.
+     * \param path The context path.
+     * \param old The old value.
+     * \param newValue The new value.
+     */
+    void TraceWithPath(std::string path, int16_t old [[maybe_unused]], int16_t newValue)
+    {
+        m_newValue = newValue;
+        m_path = path;
+    }
+
+  private:
+    void DoRun() override;
+
+    int16_t m_newValue; //!< Flag to detect tracing result.
+    std::string m_path; //!< The context path.
+};
+
+PathConfigTestCase::PathConfigTestCase()
+    : TestCase("Check that Config::Path resolves the paths as the Config functions")
+{
+}
+
+void
+PathConfigTestCase::DoRun()
+{
+    IntegerValue iv;
+
+    Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject>();
+    Config::RegisterRootNamespaceObject(root);
+    Ptr<ConfigTestObject> a = CreateObject<ConfigTestObject>();
+    root->SetNodeA(a);
+    Ptr<ConfigTestObject> b = CreateObject<ConfigTestObject>();
+    a->SetNodeB(b);
+    std::vector<Ptr<ConfigTestObject>> objs;
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        objs.push_back(CreateObject<ConfigTestObject>());
+        b->AddNodeB(objs.back());
+    }
+
+    //
+    // A single index, then a wildcard on a path used twice
+    //
+    Config::EnableTimingReport();
+    Config::Path setPath("/NodeA/NodeB/NodesB/2/A");
+    setPath.Set(IntegerValue(-20));
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        objs[i]->GetAttribute("A", iv);
+        NS_TEST_ASSERT_MSG_EQ(iv.Get(), (i == 2 ? -20 : 10), "Wrong attribute A of " << i);
+    }
+    Config::Path setAllPath("/NodeA/NodeB/NodesB/*/B");
+    setAllPath.Set(IntegerValue(-21));
+    setAllPath.Set(IntegerValue(-22));
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        objs[i]->GetAttribute("B", iv);
+        NS_TEST_ASSERT_MSG_EQ(iv.Get(), -22, "Wrong attribute B of " << i);
+    }
+    NS_TEST_ASSERT_MSG_EQ(setAllPath.SetFailSafe(IntegerValue(1000)),
+                          false,
+                          "Attribute set to an invalid value");
+
+    //
+    // The paths match the same objects as the string functions
+    //
+    Config::MatchContainer matches = Config::LookupMatches("/NodeA/NodeB/NodesB/[1-3]");
+    Config::Path lookupPath("/NodeA/NodeB/NodesB/[1-3]/A");
+    Config::MatchContainer pathMatches = lookupPath.LookupMatches();
+    NS_TEST_ASSERT_MSG_EQ(pathMatches.GetN(), matches.GetN(), "Wrong number of matches");
+    for (uint32_t i = 0; i < matches.GetN(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(pathMatches.Get(i), matches.Get(i), "Wrong match " << i);
+        NS_TEST_ASSERT_MSG_EQ(pathMatches.GetMatchedPath(i),
+                              matches.GetMatchedPath(i),
+                              "Wrong matched path " << i);
+    }
+    NS_TEST_ASSERT_MSG_EQ(pathMatches.GetPath(), matches.GetPath(), "Wrong path");
+
+    //
+    // Connect, then disconnect, with context
+    //
+    Config::Path tracePath("/NodeA/NodeB/NodesB/[0-1]|3/Source");
+    tracePath.Connect(MakeCallback(&PathConfigTestCase::TraceWithPath, this));
+    m_newValue = 0;
+    objs[3]->SetAttribute("Source", IntegerValue(-4));
+    NS_TEST_ASSERT_MSG_EQ(m_newValue, -4, "Trace 3 did not fire as expected");
+    NS_TEST_ASSERT_MSG_EQ(m_path,
+                          "/NodeA/NodeB/NodesB/3/Source",
+                          "Trace 3 did not provide expected context");
+    m_newValue = 0;
+    objs[2]->SetAttribute("Source", IntegerValue(-3));
+    NS_TEST_ASSERT_MSG_EQ(m_newValue, 0, "Trace 2 fired unexpectedly");
+    tracePath.Disconnect(MakeCallback(&PathConfigTestCase::TraceWithPath, this));
+    objs[0]->SetAttribute("Source", IntegerValue(-1));
+    NS_TEST_ASSERT_MSG_EQ(m_newValue, 0, "Trace 0 fired after being disconnected");
+
+    //
+    // The calls are reported by function and path
+    //
+    std::ostringstream oss;
+    Config::PrintTimingReport(oss);
+    Config::EnableTimingReport(false);
+    std::string report = oss.str();
+    NS_TEST_ASSERT_MSG_NE(report.find("Path::Set /NodeA/NodeB/NodesB/2/A"),
+                          std::string::npos,
+                          "Path::Set not reported");
+    NS_TEST_ASSERT_MSG_NE(report.find("LookupMatches /NodeA/NodeB/NodesB/[1-3]\n"),
+                          std::string::npos,
+                          "LookupMatches not reported");
+    NS_TEST_ASSERT_MSG_EQ(report.find("Path::LookupMatches /NodeA/NodeB/NodesB/[1-3]/\n"),
+                          std::string::npos,
+                          "Nested call reported");
+
+    Config::UnregisterRootNamespaceObject(root);
+}
+
 /**
  * \ingroup config-tests
  * The Test Suite that glues all of the Test Cases together.
@@ -882,6 +1016,7 @@ ConfigTestSuite::ConfigTestSuite()
     AddTestCase(new UnderRootNamespaceConfigTestCase);
     AddTestCase(new ObjectVectorConfigTestCase);
     AddTestCase(new SearchAttributesOfParentObjectsTestCase);
+    AddTestCase(new PathConfigTestCase);
 }
 
 /**
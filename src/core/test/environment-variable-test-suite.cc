@@ -18,6 +18,7 @@
  */
 
 #include "ns3/environment-variable.h"
+#include "ns3/random-variable-stream.h"
 #include "ns3/test.h"
 
 #include <cstdlib> // getenv
@@ -307,6 +308,34 @@ EnvVarTestCase::DoRun()
     // Extra `=`| "key==value"
     SetCheckAndGet("key==", "key==", {{"key", "="}}, "key", {true, "="});
 
+    // The attribute defaults are read again when the cache is cleared
+    auto [defaultFound, defaultValue] = EnvironmentVariable::Get("NS_ATTRIBUTE_DEFAULT");
+    EnvironmentVariable::Unset("NS_ATTRIBUTE_DEFAULT");
+    EnvironmentVariable::Clear();
+    NS_TEST_EXPECT_MSG_EQ(CreateObject<UniformRandomVariable>()->GetMin(),
+                          0,
+                          "attribute default: initial value expected");
+    EnvironmentVariable::Set("NS_ATTRIBUTE_DEFAULT", "ns3::UniformRandomVariable::Min=5");
+    NS_TEST_EXPECT_MSG_EQ(CreateObject<UniformRandomVariable>()->GetMin(),
+                          0,
+                          "attribute default: variable read before the cache was cleared");
+    EnvironmentVariable::Clear();
+    NS_TEST_EXPECT_MSG_EQ(CreateObject<UniformRandomVariable>()->GetMin(),
+                          5,
+                          "attribute default: variable not read again after it was cleared");
+    if (defaultFound)
+    {
+        EnvironmentVariable::Set("NS_ATTRIBUTE_DEFAULT", defaultValue);
+    }
+    else
+    {
+        EnvironmentVariable::Unset("NS_ATTRIBUTE_DEFAULT");
+    }
+    EnvironmentVariable::Clear();
+    NS_TEST_EXPECT_MSG_EQ(CreateObject<UniformRandomVariable>()->GetMin(),
+                          0,
+                          "attribute default: variable not restored");
+
     // Finish last line of verbose output
     std::cout << std::endl;
 }
@@ -0,0 +1,301 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include "ns3/timer-wheel.h"
+#include "ns3/uinteger.h"
+
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup timer
+ * \ingroup timer-tests
+ * TimerWheel test suite.
+ */
+
+namespace ns3
+{
+
+namespace tests
+{
+
+/**
+ * \ingroup timer-tests
+ *  Check that the timers of a TimerWheel expire at their deadline
+ */
+class TimerWheelExpireTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    TimerWheelExpireTestCase();
+    void DoRun() override;
+    /**
+     * Function to invoke when a timer expires.
+     * \param timer The index of the timer.
+     */
+    void Expire(int timer);
+    std::vector<std::pair<int, Time>> m_expired; //!< Timers expired, with the time
+};
+
+TimerWheelExpireTestCase::TimerWheelExpireTestCase()
+    : TestCase("Check that the timers expire at their deadline, in order")
+{
+}
+
+void
+TimerWheelExpireTestCase::Expire(int timer)
+{
+    m_expired.emplace_back(timer, Simulator::Now());
+}
+
+void
+TimerWheelExpireTestCase::DoRun()
+{
+    Ptr<TimerWheel> wheel = CreateObject<TimerWheel>();
+    wheel->SetAttribute("Granularity", TimeValue(MicroSeconds(10)));
+    wheel->SetAttribute("Slots", UintegerValue(8));
+
+    std::vector<TimerWheel::TimerId> ids;
+    for (int i = 0; i < 5; i++)
+    {
+        ids.push_back(wheel->CreateTimer(MakeCallback(&TimerWheelExpireTestCase::Expire, this, i)));
+    }
+
+    // timer 0 and 1 share the deadline and expire in the order of arming;
+    // timer 2 is beyond a turn of the wheel, timer 3 in the same slot as 1
+    wheel->Schedule(ids[1], MicroSeconds(25));
+    wheel->Schedule(ids[0], MicroSeconds(25));
+    wheel->Schedule(ids[2], MicroSeconds(1000));
+    wheel->Schedule(ids[3], MicroSeconds(105));
+    wheel->Schedule(ids[4], MicroSeconds(3));
+    NS_TEST_ASSERT_MSG_EQ(wheel->GetNRunning(), 5, "All the timers should be running");
+    NS_TEST_ASSERT_MSG_EQ(wheel->GetDelayLeft(ids[2]), MicroSeconds(1000), "Wrong delay left");
+
+    // timer 4 is re-armed before expiring, then cancelled
+    Simulator::Schedule(MicroSeconds(2), &TimerWheel::Schedule, wheel, ids[4], MicroSeconds(500));
+    Simulator::Schedule(MicroSeconds(400), &TimerWheel::Cancel, wheel, ids[4]);
+    Simulator::Run();
+
+    std::vector<std::pair<int, Time>> expected = {{1, MicroSeconds(25)},
+                                                  {0, MicroSeconds(25)},
+                                                  {3, MicroSeconds(105)},
+                                                  {2, MicroSeconds(1000)}};
+    NS_TEST_ASSERT_MSG_EQ(m_expired.size(), expected.size(), "Wrong number of expired timers");
+    for (std::size_t i = 0; i < expected.size(); i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_expired[i].first, expected[i].first, "Wrong expired timer");
+        NS_TEST_EXPECT_MSG_EQ(m_expired[i].second, expected[i].second, "Wrong expiration time");
+    }
+    NS_TEST_EXPECT_MSG_EQ(wheel->GetNRunning(), 0, "No timer should be running");
+    NS_TEST_EXPECT_MSG_EQ(wheel->IsRunning(ids[4]), false, "The timer should be cancelled");
+
+    wheel->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup timer-tests
+ *  Check that re-arming a timer does not schedule simulator events
+ */
+class TimerWheelRearmTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    TimerWheelRearmTestCase();
+    void DoRun() override;
+    /**
+     * Re-arm the timer, as a retransmission timer on the arrival of an ACK.
+     * \param count The number of times the timer should still be re-armed.
+     */
+    void Rearm(uint32_t count);
+    /** Function to invoke when the timer expires. */
+    void Expire();
+    Ptr<TimerWheel> m_wheel;     //!< The timer wheel
+    TimerWheel::TimerId m_timer; //!< The timer
+    uint32_t m_nExpired;         //!< Number of expirations of the timer
+    Time m_expiredTime;          //!< Time when the timer expired
+};
+
+TimerWheelRearmTestCase::TimerWheelRearmTestCase()
+    : TestCase("Check that re-arming a timer does not schedule events")
+{
+}
+
+void
+TimerWheelRearmTestCase::Rearm(uint32_t count)
+{
+    m_wheel->Schedule(m_timer, MilliSeconds(200));
+    if (count > 0)
+    {
+        Simulator::Schedule(MicroSeconds(100), &TimerWheelRearmTestCase::Rearm, this, count - 1);
+    }
+}
+
+void
+TimerWheelRearmTestCase::Expire()
+{
+    m_nExpired++;
+    m_expiredTime = Simulator::Now();
+    // the callback can re-arm its own timer
+    if (m_nExpired == 1)
+    {
+        m_wheel->Schedule(m_timer, MilliSeconds(1));
+    }
+}
+
+void
+TimerWheelRearmTestCase::DoRun()
+{
+    m_nExpired = 0;
+    m_wheel = CreateObject<TimerWheel>();
+    m_timer = m_wheel->CreateTimer(MakeCallback(&TimerWheelRearmTestCase::Expire, this));
+
+    // re-armed every 100 us for 1 s
+    Rearm(10000);
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(m_nExpired, 2, "The timer should have expired twice");
+    NS_TEST_ASSERT_MSG_EQ(m_expiredTime, MilliSeconds(1201), "Wrong expiration time");
+    // one event per lifetime of the timer, plus the first expiration
+    NS_TEST_EXPECT_MSG_LT_OR_EQ(m_wheel->GetNEvents(), 10, "Too many events scheduled");
+
+    m_wheel->DestroyTimer(m_timer);
+    NS_TEST_ASSERT_MSG_EQ(m_wheel->CreateTimer(Callback<void>()),
+                          m_timer,
+                          "The identifier should be reused");
+    m_wheel->Dispose();
+    m_wheel = nullptr;
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup timer-tests
+ *  Check a TimerWheelEvent, with and without a timer wheel
+ */
+class TimerWheelEventTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    TimerWheelEventTestCase();
+    void DoRun() override;
+    /**
+     * Function to invoke when a timer expires.
+     * \param timer The index of the timer.
+     */
+    void Expire(int timer);
+    std::vector<std::pair<int, Time>> m_expired; //!< Timers expired, with the time
+};
+
+TimerWheelEventTestCase::TimerWheelEventTestCase()
+    : TestCase("Check TimerWheelEvent, and the wheels with sparse and disposed timers")
+{
+}
+
+void
+TimerWheelEventTestCase::Expire(int timer)
+{
+    m_expired.emplace_back(timer, Simulator::Now());
+}
+
+void
+TimerWheelEventTestCase::DoRun()
+{
+    // the slots span several words of the bitmap of the wheel
+    Ptr<TimerWheel> wheel = CreateObject<TimerWheel>();
+    wheel->SetAttribute("Granularity", TimeValue(MicroSeconds(1)));
+    wheel->SetAttribute("Slots", UintegerValue(200));
+
+    // without a wheel, the timer is a simulator event
+    TimerWheelEvent event0;
+    event0.SetFunction(MakeCallback(&TimerWheelEventTestCase::Expire, this, 0));
+    event0.Schedule(MicroSeconds(10));
+    NS_TEST_ASSERT_MSG_EQ(event0.IsRunning(), true, "The timer should be running");
+    NS_TEST_ASSERT_MSG_EQ(event0.GetDelayLeft(), MicroSeconds(10), "Wrong delay left");
+
+    // a running timer is cancelled when moved to a wheel
+    TimerWheelEvent event1;
+    event1.SetFunction(MakeCallback(&TimerWheelEventTestCase::Expire, this, 1));
+    event1.Schedule(MicroSeconds(5));
+    event1.SetTimerWheel(wheel);
+    NS_TEST_ASSERT_MSG_EQ(event1.IsExpired(), true, "The timer should be cancelled");
+    event1.Schedule(MicroSeconds(150));
+    NS_TEST_ASSERT_MSG_EQ(event1.GetDelayLeft(), MicroSeconds(150), "Wrong delay left");
+
+    TimerWheelEvent event2;
+    event2.SetTimerWheel(wheel);
+    event2.SetFunction(MakeCallback(&TimerWheelEventTestCase::Expire, this, 2));
+    event2.Schedule(MicroSeconds(450));
+
+    // a simulator event assigned to the timer replaces it
+    TimerWheelEvent event3;
+    event3.SetTimerWheel(wheel);
+    event3.SetFunction(MakeCallback(&TimerWheelEventTestCase::Expire, this, 3));
+    event3.Schedule(MicroSeconds(20));
+    event3 = Simulator::Schedule(MicroSeconds(70), &TimerWheelEventTestCase::Expire, this, 3);
+    NS_TEST_ASSERT_MSG_EQ(event3.IsRunning(), true, "The event should be running");
+    NS_TEST_ASSERT_MSG_EQ(wheel->GetNRunning(), 2, "The timer of the wheel should be cancelled");
+
+    // the timers of a disposed wheel are not armed
+    Simulator::Schedule(MicroSeconds(500), &TimerWheel::Dispose, wheel);
+    Simulator::Schedule(MicroSeconds(510), [&]() {
+        event2.SetFunction(MakeCallback(&TimerWheelEventTestCase::Expire, this, 4));
+        event2.Schedule(MicroSeconds(10));
+        NS_TEST_EXPECT_MSG_EQ(event2.IsRunning(), false, "The wheel is disposed");
+    });
+    Simulator::Run();
+
+    std::vector<std::pair<int, Time>> expected = {{0, MicroSeconds(10)},
+                                                  {3, MicroSeconds(70)},
+                                                  {1, MicroSeconds(150)},
+                                                  {2, MicroSeconds(450)}};
+    NS_TEST_ASSERT_MSG_EQ(m_expired.size(), expected.size(), "Wrong number of expired timers");
+    for (std::size_t i = 0; i < expected.size(); i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_expired[i].first, expected[i].first, "Wrong expired timer");
+        NS_TEST_EXPECT_MSG_EQ(m_expired[i].second, expected[i].second, "Wrong expiration time");
+    }
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup timer-tests
+ *  TimerWheel test suite
+ */
+class TimerWheelTestSuite : public TestSuite
+{
+  public:
+    /** Constructor. */
+    TimerWheelTestSuite()
+        : TestSuite("timer-wheel")
+    {
+        AddTestCase(new TimerWheelExpireTestCase());
+        AddTestCase(new TimerWheelRearmTestCase());
+        AddTestCase(new TimerWheelEventTestCase());
+    }
+};
+
+/**
+ * \ingroup timer-tests
+ * TimerWheelTestSuite instance variable.
+ */
+static TimerWheelTestSuite g_timerWheelTestSuite;
+
+} // namespace tests
+
+} // namespace ns3
@@ -20,6 +20,7 @@
 #include "ns3/double.h"
 #include "ns3/integer.h"
 #include "ns3/log.h"
+#include "ns3/object-factory.h"
 #include "ns3/object.h"
 #include "ns3/test.h"
 #include "ns3/traced-value.h"
@@ -343,6 +344,150 @@ DeprecatedAttributeTestCase::DoRun()
               << (tinfo.supportLevel == TypeId::DEPRECATED ? "deprecated" : "error") << std::endl;
 }
 
+/**
+ * \ingroup typeid-tests
+ *
+ * Base class used to test the interned names and the construction lists.
+ */
+class InternedBase : public Object
+{
+  public:
+    int m_value;                 //!< An attribute of the base class.
+    TracedValue<int> m_trace{0}; //!< A TracedValue of the base class.
+
+    /**
+     * \brief Get the type ID.
+     * \return The object TypeId.
+     */
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("InternedBase")
+                                .SetParent<Object>()
+                                .AddConstructor<InternedBase>()
+                                .AddAttribute("Value",
+                                              "the value",
+                                              IntegerValue(1),
+                                              MakeIntegerAccessor(&InternedBase::m_value),
+                                              MakeIntegerChecker<int>())
+                                .AddTraceSource("Trace",
+                                                "the trace",
+                                                MakeTraceSourceAccessor(&InternedBase::m_trace),
+                                                "ns3::TracedValueCallback::Int32");
+        return tid;
+    }
+};
+
+/**
+ * \ingroup typeid-tests
+ *
+ * Derived class used to test the interned names and the construction lists.
+ */
+class InternedDerived : public InternedBase
+{
+  public:
+    int m_other; //!< An attribute of the derived class.
+
+    /**
+     * \brief Get the type ID.
+     * \return The object TypeId.
+     */
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("InternedDerived")
+                                .SetParent<InternedBase>()
+                                .AddConstructor<InternedDerived>()
+                                .AddAttribute("Other",
+                                              "the other value",
+                                              IntegerValue(2),
+                                              MakeIntegerAccessor(&InternedDerived::m_other),
+                                              MakeIntegerChecker<int>());
+        return tid;
+    }
+};
+
+/**
+ * \ingroup typeid-tests
+ *
+ * Check the lookups by interned name and the construction of objects
+ * through the construction lists.
+ */
+class InternedNameTestCase : public TestCase
+{
+  public:
+    InternedNameTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+InternedNameTestCase::InternedNameTestCase()
+    : TestCase("Check the interned names and the construction lists")
+{
+}
+
+void
+InternedNameTestCase::DoRun()
+{
+    TypeId tid = InternedDerived::GetTypeId();
+    TypeId::name_t value = TypeId::InternName("Value");
+    NS_TEST_ASSERT_MSG_EQ(value, TypeId::InternName(std::string("Val") + "ue"), "equal names");
+    NS_TEST_ASSERT_MSG_NE(value, TypeId::InternName("Other"), "different names");
+
+    // Lookups in the TypeId and in its parent
+    TypeId::AttributeInformation ainfo;
+    NS_TEST_ASSERT_MSG_EQ(tid.LookupAttributeByName(value, &ainfo), true, "parent attribute");
+    NS_TEST_EXPECT_MSG_EQ(ainfo.name, "Value", "parent attribute name");
+    NS_TEST_ASSERT_MSG_EQ(tid.LookupAttributeByName(TypeId::InternName("Other"), &ainfo),
+                          true,
+                          "own attribute");
+    NS_TEST_EXPECT_MSG_EQ(ainfo.name, "Other", "own attribute name");
+    NS_TEST_EXPECT_MSG_EQ(InternedBase::GetTypeId().LookupAttributeByName("Other", &ainfo),
+                          false,
+                          "child attribute");
+    NS_TEST_EXPECT_MSG_EQ(tid.LookupAttributeByName("NoSuchAttribute", &ainfo),
+                          false,
+                          "unknown attribute");
+    NS_TEST_EXPECT_MSG_EQ(tid.LookupAttributeByName(TypeId::InternName("Trace"), &ainfo),
+                          false,
+                          "trace source is not an attribute");
+    TypeId::TraceSourceInformation tinfo;
+    NS_TEST_EXPECT_MSG_NE(tid.LookupTraceSourceByName(TypeId::InternName("Trace"), &tinfo),
+                          nullptr,
+                          "parent trace source");
+    NS_TEST_EXPECT_MSG_EQ(tid.LookupTraceSourceByName(value, &tinfo), nullptr, "not a trace");
+
+    // The construction list holds the attributes of the TypeId, then of its parents
+    auto construction = tid.GetConstructionList();
+    NS_TEST_ASSERT_MSG_EQ(construction->size(), 2, "construction list size");
+    NS_TEST_EXPECT_MSG_EQ((*construction)[0].name, "InternedDerived::Other", "first attribute");
+    NS_TEST_EXPECT_MSG_EQ((*construction)[1].name, "InternedBase::Value", "second attribute");
+    NS_TEST_EXPECT_MSG_EQ(tid.GetConstructionList(), construction, "shared construction list");
+
+    // The factory resolves its attributes once for many objects
+    ObjectFactory factory("InternedDerived", "Value", IntegerValue(7));
+    for (int i = 0; i < 3; i++)
+    {
+        Ptr<InternedDerived> object = factory.Create<InternedDerived>();
+        NS_TEST_EXPECT_MSG_EQ(object->m_value, 7, "factory attribute");
+        NS_TEST_EXPECT_MSG_EQ(object->m_other, 2, "initial value");
+    }
+    factory.Set("Value", IntegerValue(8));
+    NS_TEST_EXPECT_MSG_EQ(factory.Create<InternedDerived>()->m_value, 8, "changed attribute");
+
+    // A new initial value rebuilds the construction lists
+    std::size_t other = 0;
+    tid.SetAttributeInitialValue(other, Create<IntegerValue>(9));
+    NS_TEST_EXPECT_MSG_NE(tid.GetConstructionList(), construction, "rebuilt construction list");
+    Ptr<InternedDerived> object = factory.Create<InternedDerived>();
+    NS_TEST_EXPECT_MSG_EQ(object->m_value, 8, "factory attribute after new initial value");
+    NS_TEST_EXPECT_MSG_EQ(object->m_other, 9, "new initial value");
+    object = CreateObject<InternedDerived>();
+    NS_TEST_EXPECT_MSG_EQ(object->m_value, 1, "initial value without factory");
+    NS_TEST_EXPECT_MSG_EQ(object->m_other, 9, "new initial value without factory");
+    tid.SetAttributeInitialValue(other, tid.GetAttribute(other).originalInitialValue);
+    NS_TEST_EXPECT_MSG_EQ(CreateObject<InternedDerived>()->m_other, 2, "restored initial value");
+}
+
 /**
  * \ingroup typeid-tests
  *
@@ -455,6 +600,7 @@ TypeIdTestSuite::TypeIdTestSuite()
     AddTestCase(new UniqueTypeIdTestCase, QUICK);
     AddTestCase(new CollisionTestCase, QUICK);
     AddTestCase(new DeprecatedAttributeTestCase, QUICK);
+    AddTestCase(new InternedNameTestCase, QUICK);
 }
 
 /// Static variable for test initialization.
@@ -20,10 +20,13 @@
 #include "flow-monitor.h"
 
 #include "ns3/double.h"
+#include "ns3/enum.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
 
-#include <fstream>
+#include <algorithm>
 #include <sstream>
 
 #define PERIODIC_CHECK_INTERVAL (Seconds(1))
@@ -35,6 +38,18 @@ NS_LOG_COMPONENT_DEFINE("FlowMonitor");
 
 NS_OBJECT_ENSURE_REGISTERED(FlowMonitor);
 
+/**
+ * \ingroup flow-monitor
+ * \param flowId the flow identifier
+ * \param packetId the packet identifier
+ * \return the key of the packet in the map of the tracked packets
+ */
+static inline uint64_t
+TrackedPacketKey(FlowId flowId, FlowPacketId packetId)
+{
+    return (static_cast<uint64_t>(flowId) << 32) | packetId;
+}
+
 TypeId
 FlowMonitor::GetTypeId()
 {
@@ -80,7 +95,36 @@ FlowMonitor::GetTypeId()
                 ("The minimum inter-arrival time that is considered a flow interruption."),
                 TimeValue(Seconds(0.5)),
                 MakeTimeAccessor(&FlowMonitor::m_flowInterruptionsMinTime),
-                MakeTimeChecker());
+                MakeTimeChecker())
+            .AddAttribute("ExportFileName",
+                          ("The name of the CSV file the flow statistics are periodically "
+                           "streamed to while monitoring. The statistics are not streamed "
+                           "if empty."),
+                          StringValue(""),
+                          MakeStringAccessor(&FlowMonitor::m_exportFileName),
+                          MakeStringChecker())
+            .AddAttribute("ExportInterval",
+                          ("The interval between two exports of the flow statistics."),
+                          TimeValue(Seconds(1)),
+                          MakeTimeAccessor(&FlowMonitor::m_exportInterval),
+                          MakeTimeChecker(TimeStep(1)))
+            .AddAttribute("SamplingRatio",
+                          ("Track one packet out of SamplingRatio to measure the delays and the "
+                           "jitters. The byte and packet counters are not affected, and each "
+                           "tracked packet found lost counts for SamplingRatio lost packets. "
+                           "1 tracks all the packets."),
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&FlowMonitor::m_samplingRatio),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("SamplingMethod",
+                          ("The method used to select the tracked packets, either by their "
+                           "identifier or by a hash of the flow and packet identifiers."),
+                          EnumValue(FlowMonitor::SAMPLE_HASH),
+                          MakeEnumAccessor(&FlowMonitor::m_samplingMethod),
+                          MakeEnumChecker(FlowMonitor::SAMPLE_PACKET_ID,
+                                          "PacketId",
+                                          FlowMonitor::SAMPLE_HASH,
+                                          "Hash"));
     return tid;
 }
 
@@ -102,6 +146,10 @@ FlowMonitor::DoDispose()
     NS_LOG_FUNCTION(this);
     Simulator::Cancel(m_startEvent);
     Simulator::Cancel(m_stopEvent);
+    Simulator::Cancel(m_exportEvent);
+    Simulator::Cancel(m_exportDestroyEvent);
+    FinishExport();
+    m_exportedStats.clear();
     for (std::list<Ptr<FlowClassifier>>::iterator iter = m_classifiers.begin();
          iter != m_classifiers.end();
          iter++)
@@ -120,11 +168,11 @@ inline FlowMonitor::FlowStats&
 FlowMonitor::GetStatsForFlow(FlowId flowId)
 {
     NS_LOG_FUNCTION(this);
-    FlowStatsContainerI iter;
-    iter = m_flowStats.find(flowId);
-    if (iter == m_flowStats.end())
+    auto index = m_flowStatsIndex.find(flowId);
+    if (index == m_flowStatsIndex.end())
     {
         FlowMonitor::FlowStats& ref = m_flowStats[flowId];
+        m_flowStatsIndex[flowId] = &ref;
         ref.delaySum = Seconds(0);
         ref.jitterSum = Seconds(0);
         ref.lastDelay = Seconds(0);
@@ -132,6 +180,7 @@ FlowMonitor::GetStatsForFlow(FlowId flowId)
         ref.rxBytes = 0;
         ref.txPackets = 0;
         ref.rxPackets = 0;
+        ref.sampledPackets = 0;
         ref.lostPackets = 0;
         ref.timesForwarded = 0;
         ref.delayHistogram.SetDefaultBinWidth(m_delayBinWidth);
@@ -142,10 +191,30 @@ FlowMonitor::GetStatsForFlow(FlowId flowId)
     }
     else
     {
-        return iter->second;
+        return *index->second;
     }
 }
 
+bool
+FlowMonitor::IsSampled(FlowId flowId, FlowPacketId packetId) const
+{
+    if (m_samplingRatio <= 1)
+    {
+        return true;
+    }
+    if (m_samplingMethod == SAMPLE_PACKET_ID)
+    {
+        return packetId % m_samplingRatio == 0;
+    }
+    // mix the bits of the key, so that the sample does not follow the
+    // periodic patterns of the packet identifiers
+    uint64_t hash = TrackedPacketKey(flowId, packetId);
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+    hash ^= hash >> 31;
+    return hash % m_samplingRatio == 0;
+}
+
 void
 FlowMonitor::ReportFirstTx(Ptr<FlowProbe> probe,
                            uint32_t flowId,
@@ -159,12 +228,15 @@ FlowMonitor::ReportFirstTx(Ptr<FlowProbe> probe,
         return;
     }
     Time now = Simulator::Now();
-    TrackedPacket& tracked = m_trackedPackets[std::make_pair(flowId, packetId)];
-    tracked.firstSeenTime = now;
-    tracked.lastSeenTime = tracked.firstSeenTime;
-    tracked.timesForwarded = 0;
-    NS_LOG_DEBUG("ReportFirstTx: adding tracked packet (flowId=" << flowId << ", packetId="
-                                                                 << packetId << ").");
+    if (IsSampled(flowId, packetId))
+    {
+        TrackedPacket& tracked = m_trackedPackets[TrackedPacketKey(flowId, packetId)];
+        tracked.firstSeenTime = now;
+        tracked.lastSeenTime = tracked.firstSeenTime;
+        tracked.timesForwarded = 0;
+        NS_LOG_DEBUG("ReportFirstTx: adding tracked packet (flowId=" << flowId << ", packetId="
+                                                                     << packetId << ").");
+    }
 
     probe->AddPacketStats(flowId, packetSize, Seconds(0));
 
@@ -190,8 +262,12 @@ FlowMonitor::ReportForwarding(Ptr<FlowProbe> probe,
         NS_LOG_DEBUG("FlowMonitor not enabled; returning");
         return;
     }
-    std::pair<FlowId, FlowPacketId> key(flowId, packetId);
-    TrackedPacketMap::iterator tracked = m_trackedPackets.find(key);
+    if (!IsSampled(flowId, packetId))
+    {
+        probe->AddPacketStats(flowId, packetSize);
+        return;
+    }
+    TrackedPacketMap::iterator tracked = m_trackedPackets.find(TrackedPacketKey(flowId, packetId));
     if (tracked == m_trackedPackets.end())
     {
         NS_LOG_WARN("Received packet forward report (flowId="
@@ -218,36 +294,56 @@ FlowMonitor::ReportLastRx(Ptr<FlowProbe> probe,
         NS_LOG_DEBUG("FlowMonitor not enabled; returning");
         return;
     }
-    TrackedPacketMap::iterator tracked = m_trackedPackets.find(std::make_pair(flowId, packetId));
-    if (tracked == m_trackedPackets.end())
+    bool sampled = IsSampled(flowId, packetId);
+    TrackedPacketMap::iterator tracked = m_trackedPackets.end();
+    if (sampled)
     {
-        NS_LOG_WARN("Received packet last-tx report (flowId="
-                    << flowId << ", packetId=" << packetId << ") but not known to be transmitted.");
-        return;
+        tracked = m_trackedPackets.find(TrackedPacketKey(flowId, packetId));
+        if (tracked == m_trackedPackets.end())
+        {
+            NS_LOG_WARN("Received packet last-tx report (flowId="
+                        << flowId << ", packetId=" << packetId
+                        << ") but not known to be transmitted.");
+            return;
+        }
     }
 
     Time now = Simulator::Now();
-    Time delay = (now - tracked->second.firstSeenTime);
-    probe->AddPacketStats(flowId, packetSize, delay);
-
     FlowStats& stats = GetStatsForFlow(flowId);
-    stats.delaySum += delay;
-    stats.delayHistogram.AddValue(delay.GetSeconds());
-    if (stats.rxPackets > 0)
+    if (sampled)
     {
-        Time jitter = stats.lastDelay - delay;
-        if (jitter > Seconds(0))
-        {
-            stats.jitterSum += jitter;
-            stats.jitterHistogram.AddValue(jitter.GetSeconds());
-        }
-        else
+        Time delay = (now - tracked->second.firstSeenTime);
+        probe->AddPacketStats(flowId, packetSize, delay);
+
+        stats.delaySum += delay;
+        stats.delayHistogram.AddValue(delay.GetSeconds());
+        if (stats.sampledPackets > 0)
         {
-            stats.jitterSum -= jitter;
-            stats.jitterHistogram.AddValue(-jitter.GetSeconds());
+            Time jitter = stats.lastDelay - delay;
+            if (jitter > Seconds(0))
+            {
+                stats.jitterSum += jitter;
+                stats.jitterHistogram.AddValue(jitter.GetSeconds());
+            }
+            else
+            {
+                stats.jitterSum -= jitter;
+                stats.jitterHistogram.AddValue(-jitter.GetSeconds());
+            }
         }
+        stats.lastDelay = delay;
+        stats.sampledPackets++;
+        stats.timesForwarded += tracked->second.timesForwarded;
+
+        NS_LOG_DEBUG("ReportLastTx: removing tracked packet (flowId=" << flowId << ", packetId="
+                                                                      << packetId << ").");
+
+        m_trackedPackets.erase(tracked); // we don't need to track this packet anymore
+    }
+    else
+    {
+        probe->AddPacketStats(flowId, packetSize);
     }
-    stats.lastDelay = delay;
 
     stats.rxBytes += packetSize;
     stats.packetSizeHistogram.AddValue((double)packetSize);
@@ -266,12 +362,6 @@ FlowMonitor::ReportLastRx(Ptr<FlowProbe> probe,
         }
     }
     stats.timeLastRxPacket = now;
-    stats.timesForwarded += tracked->second.timesForwarded;
-
-    NS_LOG_DEBUG("ReportLastTx: removing tracked packet (flowId=" << flowId << ", packetId="
-                                                                  << packetId << ").");
-
-    m_trackedPackets.erase(tracked); // we don't need to track this packet anymore
 }
 
 void
@@ -302,7 +392,7 @@ FlowMonitor::ReportDrop(Ptr<FlowProbe> probe,
     NS_LOG_DEBUG("++stats.packetsDropped["
                  << reasonCode << "]; // becomes: " << stats.packetsDropped[reasonCode]);
 
-    TrackedPacketMap::iterator tracked = m_trackedPackets.find(std::make_pair(flowId, packetId));
+    TrackedPacketMap::iterator tracked = m_trackedPackets.find(TrackedPacketKey(flowId, packetId));
     if (tracked != m_trackedPackets.end())
     {
         // we don't need to track this packet anymore
@@ -331,12 +421,22 @@ FlowMonitor::CheckForLostPackets(Time maxDelay)
         if (now - iter->second.lastSeenTime >= maxDelay)
         {
             // packet is considered lost, add it to the loss statistics
-            FlowStatsContainerI flow = m_flowStats.find(iter->first.first);
-            NS_ASSERT(flow != m_flowStats.end());
-            flow->second.lostPackets++;
+            auto flow = m_flowStatsIndex.find(iter->first >> 32);
+            NS_ASSERT(flow != m_flowStatsIndex.end());
+            FlowStats& stats = *flow->second;
+            uint32_t lost = 1;
+            if (m_samplingRatio > 1)
+            {
+                // a tracked packet stands for SamplingRatio packets, but no more
+                // than the packets neither received nor already counted as lost
+                int64_t missing = int64_t(stats.txPackets) - stats.rxPackets - stats.lostPackets;
+                lost = static_cast<uint32_t>(
+                    std::max<int64_t>(1, std::min<int64_t>(m_samplingRatio, missing)));
+            }
+            stats.lostPackets += lost;
 
             // we won't track it anymore
-            m_trackedPackets.erase(iter++);
+            iter = m_trackedPackets.erase(iter);
         }
         else
         {
@@ -410,6 +510,21 @@ FlowMonitor::StartRightNow()
         return;
     }
     m_enabled = true;
+
+    if (!m_exportFileName.empty() && !m_exportEvent.IsRunning())
+    {
+        if (!m_exportStream.is_open())
+        {
+            m_exportStream.open(m_exportFileName, std::ios::out | std::ios::binary);
+            NS_ABORT_MSG_UNLESS(m_exportStream.is_open(),
+                                "Could not open the file " << m_exportFileName);
+            m_exportStream << "time,flowId,txBytes,rxBytes,txPackets,rxPackets,lostPackets,"
+                              "timesForwarded,delaySum,jitterSum,sampledPackets\n";
+            m_exportDestroyEvent = Simulator::ScheduleDestroy(&FlowMonitor::FinishExport, this);
+        }
+        m_exportEvent =
+            Simulator::Schedule(m_exportInterval, &FlowMonitor::PeriodicExportFlowStats, this);
+    }
 }
 
 void
@@ -423,6 +538,66 @@ FlowMonitor::StopRightNow()
     }
     m_enabled = false;
     CheckForLostPackets();
+
+    if (m_exportStream.is_open())
+    {
+        m_exportEvent.Cancel();
+        ExportFlowStats();
+        m_exportStream.flush();
+    }
+}
+
+void
+FlowMonitor::ExportFlowStats()
+{
+    NS_LOG_FUNCTION(this);
+    int64_t now = Simulator::Now().GetNanoSeconds();
+
+    for (const auto& [flowId, stats] : m_flowStats)
+    {
+        ExportedStats& last = m_exportedStats[flowId];
+        if (stats.txPackets == last.txPackets && stats.rxPackets == last.rxPackets &&
+            stats.lostPackets == last.lostPackets)
+        {
+            continue;
+        }
+        m_exportStream << now << ',' << flowId << ',' << stats.txBytes - last.txBytes << ','
+                       << stats.rxBytes - last.rxBytes << ',' << stats.txPackets - last.txPackets
+                       << ',' << stats.rxPackets - last.rxPackets << ','
+                       << stats.lostPackets - last.lostPackets << ','
+                       << stats.timesForwarded - last.timesForwarded << ','
+                       << (stats.delaySum - last.delaySum).GetNanoSeconds() << ','
+                       << (stats.jitterSum - last.jitterSum).GetNanoSeconds() << ','
+                       << stats.sampledPackets - last.sampledPackets << '\n';
+        last.delaySum = stats.delaySum;
+        last.jitterSum = stats.jitterSum;
+        last.txBytes = stats.txBytes;
+        last.rxBytes = stats.rxBytes;
+        last.txPackets = stats.txPackets;
+        last.rxPackets = stats.rxPackets;
+        last.lostPackets = stats.lostPackets;
+        last.timesForwarded = stats.timesForwarded;
+        last.sampledPackets = stats.sampledPackets;
+    }
+}
+
+void
+FlowMonitor::FinishExport()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_exportStream.is_open())
+    {
+        ExportFlowStats();
+        m_exportStream.close();
+    }
+}
+
+void
+FlowMonitor::PeriodicExportFlowStats()
+{
+    ExportFlowStats();
+    m_exportEvent =
+        Simulator::Schedule(m_exportInterval, &FlowMonitor::PeriodicExportFlowStats, this);
 }
 
 void
@@ -454,8 +629,12 @@ FlowMonitor::SerializeToXmlStream(std::ostream& os,
                   ATTRIB_TIME(timeLastTxPacket) ATTRIB_TIME(timeLastRxPacket) ATTRIB_TIME(delaySum)
                       ATTRIB_TIME(jitterSum) ATTRIB_TIME(lastDelay) ATTRIB(txBytes) ATTRIB(rxBytes)
                           ATTRIB(txPackets) ATTRIB(rxPackets) ATTRIB(lostPackets)
-                              ATTRIB(timesForwarded)
-           << ">\n";
+                              ATTRIB(timesForwarded);
+        if (m_samplingRatio > 1)
+        {
+            os ATTRIB(sampledPackets);
+        }
+        os << ">\n";
 #undef ATTRIB_TIME
 #undef ATTRIB
 
@@ -549,6 +728,7 @@ FlowMonitor::ResetAllStats()
         flowStat.rxBytes = 0;
         flowStat.txPackets = 0;
         flowStat.rxPackets = 0;
+        flowStat.sampledPackets = 0;
         flowStat.lostPackets = 0;
         flowStat.timesForwarded = 0;
         flowStat.bytesDropped.clear();
@@ -559,6 +739,7 @@ FlowMonitor::ResetAllStats()
         flowStat.packetSizeHistogram.Clear();
         flowStat.flowInterruptionsHistogram.Clear();
     }
+    m_exportedStats.clear();
 }
 
 } // namespace ns3
@@ -28,7 +28,9 @@
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 
+#include <fstream>
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 namespace ns3
@@ -46,10 +48,32 @@ namespace ns3
  * The FlowMonitor class is responsible for coordinating efforts
  * regarding probes, and collects end-to-end flow statistics.
  *
+ * Besides the XML report written on request, the statistics can be
+ * streamed to a CSV file while the simulation runs (see the ExportFileName
+ * attribute): every ExportInterval, a line is written for each flow whose
+ * counters changed, holding the increments of the counters since the
+ * previous line of the flow.
+ *
+ * To reduce the number of packets tracked at the same time, only a sample of
+ * the packets can be tracked (see the SamplingRatio attribute). The sampling
+ * decision depends only on the flow and packet identifiers, so that all the
+ * probes agree on it. The byte and packet counters of the flows stay exact,
+ * while the delays, the jitters and the forwarding counts are measured on the
+ * sampled packets only. The packets found lost because they were not seen for
+ * too long are also detected among the sampled packets, each of them counting
+ * for SamplingRatio lost packets, while the packets dropped by the probes are
+ * always counted exactly.
  */
 class FlowMonitor : public Object
 {
   public:
+    /// Method used to select the tracked packets
+    enum SamplingMethod
+    {
+        SAMPLE_PACKET_ID, //!< Track the packets whose identifier is a multiple of the ratio
+        SAMPLE_HASH,      //!< Track the packets whose hash is a multiple of the ratio
+    };
+
     /// \brief Structure that represents the measured metrics of an individual packet flow
     struct FlowStats
     {
@@ -74,7 +98,7 @@ class FlowMonitor : public Object
 
         /// Contains the sum of all end-to-end delays for all received
         /// packets of the flow.
-        Time delaySum; // delayCount == rxPackets
+        Time delaySum; // delayCount == sampledPackets
 
         /// Contains the sum of all end-to-end delay jitter (delay
         /// variation) values for all received packets of the flow.  Here
@@ -83,7 +107,7 @@ class FlowMonitor : public Object
         /// i.e. \f$Jitter\left\{P_N\right\} = \left|Delay\left\{P_N\right\} -
         /// Delay\left\{P_{N-1}\right\}\right|\f$. This definition is in accordance with the
         /// Type-P-One-way-ipdv as defined in IETF \RFC{3393}.
-        Time jitterSum; // jitterCount == rxPackets - 1
+        Time jitterSum; // jitterCount == sampledPackets - 1
 
         /// Contains the last measured delay of a packet
         /// It is stored to measure the packet's Jitter
@@ -97,16 +121,23 @@ class FlowMonitor : public Object
         uint32_t txPackets;
         /// Total number of received packets for the flow
         uint32_t rxPackets;
+        /// Number of received packets whose delay was measured, i.e.,
+        /// rxPackets unless the packets are sampled
+        uint32_t sampledPackets;
 
         /// Total number of packets that are assumed to be lost,
         /// i.e. those that were transmitted but have not been reportedly
         /// received or forwarded for a long time.  By default, packets
         /// missing for a period of over 10 seconds are assumed to be
-        /// lost, although this value can be easily configured in runtime
+        /// lost, although this value can be easily configured in runtime.
+        /// When the packets are sampled, each tracked packet found lost
+        /// counts for SamplingRatio packets (bounded by the packets neither
+        /// received nor already counted as lost), so that the count remains
+        /// an estimate of the lost packets of the flow
         uint32_t lostPackets;
 
         /// Contains the number of times a packet has been reportedly
-        /// forwarded, summed for all received packets in the flow
+        /// forwarded, summed for all received (sampled) packets in the flow
         uint32_t timesForwarded;
 
         /// Histogram of the packet delays
@@ -289,11 +320,27 @@ class FlowMonitor : public Object
         uint32_t timesForwarded; //!< number of times the packet was reportedly forwarded
     };
 
+    /// Counters of a flow written by the last export
+    struct ExportedStats
+    {
+        Time delaySum;              //!< sum of the delays
+        Time jitterSum;             //!< sum of the jitters
+        uint64_t txBytes{0};        //!< transmitted bytes
+        uint64_t rxBytes{0};        //!< received bytes
+        uint32_t txPackets{0};      //!< transmitted packets
+        uint32_t rxPackets{0};      //!< received packets
+        uint32_t sampledPackets{0}; //!< received packets whose delay was measured
+        uint32_t lostPackets{0};    //!< lost packets
+        uint32_t timesForwarded{0}; //!< number of times the packets were forwarded
+    };
+
     /// FlowId --> FlowStats
     FlowStatsContainer m_flowStats;
+    /// FlowId --> FlowStats of m_flowStats, to find the stats of a flow in constant time
+    std::unordered_map<FlowId, FlowStats*> m_flowStatsIndex;
 
-    /// (FlowId,PacketId) --> TrackedPacket
-    typedef std::map<std::pair<FlowId, FlowPacketId>, TrackedPacket> TrackedPacketMap;
+    /// (FlowId,PacketId) --> TrackedPacket, the FlowId being in the upper 32 bits of the key
+    typedef std::unordered_map<uint64_t, TrackedPacket> TrackedPacketMap;
     TrackedPacketMap m_trackedPackets; //!< Tracked packets
     Time m_maxPerHopDelay;             //!< Minimum per-hop delay
     FlowProbeContainer m_flowProbes;   //!< all the FlowProbes
@@ -309,14 +356,38 @@ class FlowMonitor : public Object
     double m_packetSizeBinWidth;        //!< packet size bin width (for histograms)
     double m_flowInterruptionsBinWidth; //!< Flow interruptions bin width (for histograms)
     Time m_flowInterruptionsMinTime;    //!< Flow interruptions minimum time
+    uint32_t m_samplingRatio;           //!< One packet out of m_samplingRatio is tracked
+    SamplingMethod m_samplingMethod;    //!< Method used to select the tracked packets
+
+    std::string m_exportFileName; //!< Name of the file the statistics are streamed to
+    Time m_exportInterval;        //!< Interval between the exports
+    std::ofstream m_exportStream; //!< Stream the statistics are exported to
+    EventId m_exportEvent;        //!< Next export event
+    EventId m_exportDestroyEvent; //!< Last export, when the simulator is destroyed
+    std::unordered_map<FlowId, ExportedStats> m_exportedStats; //!< Counters of the last export
 
     /// Get the stats for a given flow
     /// \param flowId the Flow identification
     /// \returns the stats of the flow
     FlowStats& GetStatsForFlow(FlowId flowId);
 
+    /// Check if a packet is tracked
+    /// \param flowId the Flow identification
+    /// \param packetId the Packet identification
+    /// \returns true if the packet is tracked
+    bool IsSampled(FlowId flowId, FlowPacketId packetId) const;
+
     /// Periodic function to check for lost packets and prune statistics
     void PeriodicCheckForLostPackets();
+
+    /// Write the increments of the counters of the flows since the last export
+    void ExportFlowStats();
+
+    /// Write the last increments of the counters and close the export file
+    void FinishExport();
+
+    /// Periodic function to export the statistics
+    void PeriodicExportFlowStats();
 };
 
 } // namespace ns3
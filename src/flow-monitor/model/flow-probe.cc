@@ -59,6 +59,15 @@ FlowProbe::AddPacketStats(FlowId flowId, uint32_t packetSize, Time delayFromFirs
     flow.delayFromFirstProbeSum += delayFromFirstProbe;
     flow.bytes += packetSize;
     ++flow.packets;
+    ++flow.sampledPackets;
+}
+
+void
+FlowProbe::AddPacketStats(FlowId flowId, uint32_t packetSize)
+{
+    FlowStats& flow = m_stats[flowId];
+    flow.bytes += packetSize;
+    ++flow.packets;
 }
 
 void
@@ -95,8 +104,12 @@ FlowProbe::SerializeToXmlStream(std::ostream& os, uint16_t indent, uint32_t inde
            << " flowId=\"" << iter->first << "\""
            << " packets=\"" << iter->second.packets << "\""
            << " bytes=\"" << iter->second.bytes << "\""
-           << " delayFromFirstProbeSum=\"" << iter->second.delayFromFirstProbeSum << "\""
-           << " >\n";
+           << " delayFromFirstProbeSum=\"" << iter->second.delayFromFirstProbeSum << "\"";
+        if (iter->second.sampledPackets != iter->second.packets)
+        {
+            os << " sampledPackets=\"" << iter->second.sampledPackets << "\"";
+        }
+        os << " >\n";
         indent += 2;
         for (uint32_t reasonCode = 0; reasonCode < iter->second.packetsDropped.size(); reasonCode++)
         {
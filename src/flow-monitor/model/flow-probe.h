@@ -61,7 +61,8 @@ class FlowProbe : public Object
         FlowStats()
             : delayFromFirstProbeSum(Seconds(0)),
               bytes(0),
-              packets(0)
+              packets(0),
+              sampledPackets(0)
         {
         }
 
@@ -69,13 +70,16 @@ class FlowProbe : public Object
         std::vector<uint32_t> packetsDropped;
         /// bytesDropped[reasonCode] => number of dropped bytes
         std::vector<uint64_t> bytesDropped;
-        /// divide by 'packets' to get the average delay from the
+        /// divide by 'sampledPackets' to get the average delay from the
         /// first (entry) probe up to this one (partial delay)
         Time delayFromFirstProbeSum;
         /// Number of bytes seen of this flow
         uint64_t bytes;
         /// Number of packets seen of this flow
         uint32_t packets;
+        /// Number of packets whose delay was measured, i.e., 'packets'
+        /// unless the FlowMonitor samples the packets
+        uint32_t sampledPackets;
     };
 
     /// Container to map FlowId -> FlowStats
@@ -86,6 +90,10 @@ class FlowProbe : public Object
     /// \param packetSize the packet size
     /// \param delayFromFirstProbe packet delay
     void AddPacketStats(FlowId flowId, uint32_t packetSize, Time delayFromFirstProbe);
+    /// Add the data of a packet whose delay is not measured to the flow stats
+    /// \param flowId the flow Identifier
+    /// \param packetSize the packet size
+    void AddPacketStats(FlowId flowId, uint32_t packetSize);
     /// Add a packet drop data to the flow stats
     /// \param flowId the flow Identifier
     /// \param packetSize the packet size
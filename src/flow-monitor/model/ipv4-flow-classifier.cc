@@ -91,6 +91,16 @@ operator==(const Ipv4FlowClassifier::FiveTuple& t1, const Ipv4FlowClassifier::Fi
             t1.sourcePort == t2.sourcePort && t1.destinationPort == t2.destinationPort);
 }
 
+std::size_t
+Ipv4FlowClassifier::FiveTupleHash::operator()(const FiveTuple& tuple) const
+{
+    uint64_t addresses = (static_cast<uint64_t>(tuple.sourceAddress.Get()) << 32) |
+                         tuple.destinationAddress.Get();
+    uint64_t ports = (static_cast<uint64_t>(tuple.protocol) << 32) |
+                     (static_cast<uint32_t>(tuple.sourcePort) << 16) | tuple.destinationPort;
+    return std::hash<uint64_t>()(addresses ^ (ports * 0x9e3779b97f4a7c15ULL));
+}
+
 Ipv4FlowClassifier::Ipv4FlowClassifier()
 {
 }
@@ -145,55 +155,57 @@ Ipv4FlowClassifier::Classify(const Ipv4Header& ipHeader,
     tuple.destinationPort = dstPort;
 
     // try to insert the tuple, but check if it already exists
-    std::pair<std::map<FiveTuple, FlowId>::iterator, bool> insert =
-        m_flowMap.insert(std::pair<FiveTuple, FlowId>(tuple, 0));
+    auto [flowI, inserted] = m_flowMap.try_emplace(tuple, 0);
 
     // if the insertion succeeded, we need to assign this tuple a new flow identifier
-    if (insert.second)
+    if (inserted)
     {
-        FlowId newFlowId = GetNewFlowId();
-        insert.first->second = newFlowId;
-        m_flowPktIdMap[newFlowId] = 0;
-        m_flowDscpMap[newFlowId];
+        flowI->second = GetNewFlowId();
+        NS_ASSERT_MSG(flowI->second == m_flows.size() + 1, "Unexpected flow identifier");
+        m_flows.push_back({tuple, 0, {}});
     }
     else
     {
-        m_flowPktIdMap[insert.first->second]++;
+        m_flows[flowI->second - 1].lastPacketId++;
     }
+    FlowInfo& flow = m_flows[flowI->second - 1];
 
     // increment the counter of packets with the same DSCP value
     Ipv4Header::DscpType dscp = ipHeader.GetDscp();
-    std::pair<std::map<Ipv4Header::DscpType, uint32_t>::iterator, bool> dscpInserter =
-        m_flowDscpMap[insert.first->second].insert(
-            std::pair<Ipv4Header::DscpType, uint32_t>(dscp, 1));
-
-    // if the insertion did not succeed, we need to increment the counter
-    if (!dscpInserter.second)
+    auto dscpI = std::lower_bound(flow.dscpCounts.begin(),
+                                  flow.dscpCounts.end(),
+                                  dscp,
+                                  [](const std::pair<Ipv4Header::DscpType, uint32_t>& count,
+                                     Ipv4Header::DscpType value) { return count.first < value; });
+    if (dscpI != flow.dscpCounts.end() && dscpI->first == dscp)
+    {
+        dscpI->second++;
+    }
+    else
     {
-        m_flowDscpMap[insert.first->second][dscp]++;
+        flow.dscpCounts.insert(dscpI, std::make_pair(dscp, 1));
     }
 
-    *out_flowId = insert.first->second;
-    *out_packetId = m_flowPktIdMap[*out_flowId];
+    *out_flowId = flowI->second;
+    *out_packetId = flow.lastPacketId;
 
     return true;
 }
 
-Ipv4FlowClassifier::FiveTuple
-Ipv4FlowClassifier::FindFlow(FlowId flowId) const
+const Ipv4FlowClassifier::FlowInfo&
+Ipv4FlowClassifier::GetFlowInfo(FlowId flowId) const
 {
-    for (std::map<FiveTuple, FlowId>::const_iterator iter = m_flowMap.begin();
-         iter != m_flowMap.end();
-         iter++)
+    if (flowId == 0 || flowId > m_flows.size())
     {
-        if (iter->second == flowId)
-        {
-            return iter->first;
-        }
+        NS_FATAL_ERROR("Could not find the flow with ID " << flowId);
     }
-    NS_FATAL_ERROR("Could not find the flow with ID " << flowId);
-    FiveTuple retval = {Ipv4Address::GetZero(), Ipv4Address::GetZero(), 0, 0, 0};
-    return retval;
+    return m_flows[flowId - 1];
+}
+
+Ipv4FlowClassifier::FiveTuple
+Ipv4FlowClassifier::FindFlow(FlowId flowId) const
+{
+    return GetFlowInfo(flowId).tuple;
 }
 
 bool
@@ -206,16 +218,7 @@ Ipv4FlowClassifier::SortByCount::operator()(std::pair<Ipv4Header::DscpType, uint
 std::vector<std::pair<Ipv4Header::DscpType, uint32_t>>
 Ipv4FlowClassifier::GetDscpCounts(FlowId flowId) const
 {
-    std::map<FlowId, std::map<Ipv4Header::DscpType, uint32_t>>::const_iterator flow =
-        m_flowDscpMap.find(flowId);
-
-    if (flow == m_flowDscpMap.end())
-    {
-        NS_FATAL_ERROR("Could not find the flow with ID " << flowId);
-    }
-
-    std::vector<std::pair<Ipv4Header::DscpType, uint32_t>> v(flow->second.begin(),
-                                                             flow->second.end());
+    std::vector<std::pair<Ipv4Header::DscpType, uint32_t>> v = GetFlowInfo(flowId).dscpCounts;
     std::sort(v.begin(), v.end(), SortByCount());
     return v;
 }
@@ -226,33 +229,35 @@ Ipv4FlowClassifier::SerializeToXmlStream(std::ostream& os, uint16_t indent) cons
     Indent(os, indent);
     os << "<Ipv4FlowClassifier>\n";
 
+    // write the flows in the order of their FiveTuple
+    std::vector<FlowId> flowIds;
+    flowIds.reserve(m_flows.size());
+    for (FlowId flowId = 1; flowId <= m_flows.size(); flowId++)
+    {
+        flowIds.push_back(flowId);
+    }
+    std::sort(flowIds.begin(), flowIds.end(), [this](FlowId a, FlowId b) {
+        return m_flows[a - 1].tuple < m_flows[b - 1].tuple;
+    });
+
     indent += 2;
-    for (std::map<FiveTuple, FlowId>::const_iterator iter = m_flowMap.begin();
-         iter != m_flowMap.end();
-         iter++)
+    for (FlowId flowId : flowIds)
     {
+        const FlowInfo& flow = m_flows[flowId - 1];
         Indent(os, indent);
-        os << "<Flow flowId=\"" << iter->second << "\""
-           << " sourceAddress=\"" << iter->first.sourceAddress << "\""
-           << " destinationAddress=\"" << iter->first.destinationAddress << "\""
-           << " protocol=\"" << int(iter->first.protocol) << "\""
-           << " sourcePort=\"" << iter->first.sourcePort << "\""
-           << " destinationPort=\"" << iter->first.destinationPort << "\">\n";
+        os << "<Flow flowId=\"" << flowId << "\""
+           << " sourceAddress=\"" << flow.tuple.sourceAddress << "\""
+           << " destinationAddress=\"" << flow.tuple.destinationAddress << "\""
+           << " protocol=\"" << int(flow.tuple.protocol) << "\""
+           << " sourcePort=\"" << flow.tuple.sourcePort << "\""
+           << " destinationPort=\"" << flow.tuple.destinationPort << "\">\n";
 
         indent += 2;
-        std::map<FlowId, std::map<Ipv4Header::DscpType, uint32_t>>::const_iterator flow =
-            m_flowDscpMap.find(iter->second);
-
-        if (flow != m_flowDscpMap.end())
+        for (const auto& dscpCount : flow.dscpCounts)
         {
-            for (std::map<Ipv4Header::DscpType, uint32_t>::const_iterator i = flow->second.begin();
-                 i != flow->second.end();
-                 i++)
-            {
-                Indent(os, indent);
-                os << "<Dscp value=\"0x" << std::hex << static_cast<uint32_t>(i->first) << "\""
-                   << " packets=\"" << std::dec << i->second << "\" />\n";
-            }
+            Indent(os, indent);
+            os << "<Dscp value=\"0x" << std::hex << static_cast<uint32_t>(dscpCount.first) << "\""
+               << " packets=\"" << std::dec << dscpCount.second << "\" />\n";
         }
 
         indent -= 2;
@@ -24,8 +24,9 @@
 #include "ns3/flow-classifier.h"
 #include "ns3/ipv6-header.h"
 
-#include <map>
 #include <stdint.h>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -93,12 +94,31 @@ class Ipv6FlowClassifier : public FlowClassifier
     void SerializeToXmlStream(std::ostream& os, uint16_t indent) const override;
 
   private:
+    /// Hash function of the FiveTuple
+    struct FiveTupleHash
+    {
+        /// \param tuple the FiveTuple
+        /// \return the hash of the FiveTuple
+        std::size_t operator()(const FiveTuple& tuple) const;
+    };
+
+    /// Structure holding the packet counters of a flow
+    struct FlowInfo
+    {
+        FiveTuple tuple;           //!< Flow identification
+        FlowPacketId lastPacketId; //!< Identifier of the last packet of the flow
+        /// (DSCP value, packet count) pairs, sorted by DSCP value
+        std::vector<std::pair<Ipv6Header::DscpType, uint32_t>> dscpCounts;
+    };
+
     /// Map to Flows Identifiers to FlowIds
-    std::map<FiveTuple, FlowId> m_flowMap;
-    /// Map to FlowIds to FlowPacketId
-    std::map<FlowId, FlowPacketId> m_flowPktIdMap;
-    /// Map FlowIds to (DSCP value, packet count) pairs
-    std::map<FlowId, std::map<Ipv6Header::DscpType, uint32_t>> m_flowDscpMap;
+    std::unordered_map<FiveTuple, FlowId, FiveTupleHash> m_flowMap;
+    /// Flows, indexed by FlowId - 1
+    std::vector<FlowInfo> m_flows;
+
+    /// \param flowId the FlowId
+    /// \returns the flow with the given FlowId
+    const FlowInfo& GetFlowInfo(FlowId flowId) const;
 };
 
 /**
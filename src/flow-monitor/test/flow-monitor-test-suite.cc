@@ -0,0 +1,518 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/data-rate.h"
+#include "ns3/enum.h"
+#include "ns3/error-model.h"
+#include "ns3/flow-monitor-helper.h"
+#include "ns3/flow-monitor.h"
+#include "ns3/flow-probe.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv6-address-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/pointer.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/string.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup flow-monitor
+ * \ingroup tests
+ * \defgroup flow-monitor-test Flow Monitor module tests
+ */
+
+/**
+ * \ingroup flow-monitor-test
+ *
+ * \brief A flow probe through which the tests report the packets to the FlowMonitor.
+ */
+class TestFlowProbe : public FlowProbe
+{
+  public:
+    /**
+     * Constructor
+     * \param monitor the FlowMonitor the probe reports to
+     */
+    TestFlowProbe(Ptr<FlowMonitor> monitor)
+        : FlowProbe(monitor)
+    {
+    }
+};
+
+/**
+ * \ingroup flow-monitor-test
+ *
+ * \brief Check the lines of the CSV file the flow statistics are streamed to.
+ */
+class FlowMonitorExportTestCase : public TestCase
+{
+  public:
+    FlowMonitorExportTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Report packets to the FlowMonitor
+     * \param report the FlowMonitor function reporting a packet
+     * \param flowId the flow identifier
+     * \param firstPacketId the identifier of the first packet
+     * \param nPackets the number of packets
+     * \param packetSize the size of the packets
+     */
+    void Report(void (FlowMonitor::*report)(Ptr<FlowProbe>, uint32_t, uint32_t, uint32_t),
+                FlowId flowId,
+                FlowPacketId firstPacketId,
+                uint32_t nPackets,
+                uint32_t packetSize);
+
+    Ptr<FlowMonitor> m_monitor; //!< the FlowMonitor
+    Ptr<FlowProbe> m_probe;     //!< the probe
+};
+
+FlowMonitorExportTestCase::FlowMonitorExportTestCase()
+    : TestCase("Check the flow statistics streamed to a CSV file")
+{
+}
+
+void
+FlowMonitorExportTestCase::Report(
+    void (FlowMonitor::*report)(Ptr<FlowProbe>, uint32_t, uint32_t, uint32_t),
+    FlowId flowId,
+    FlowPacketId firstPacketId,
+    uint32_t nPackets,
+    uint32_t packetSize)
+{
+    for (FlowPacketId packetId = firstPacketId; packetId < firstPacketId + nPackets; packetId++)
+    {
+        ((*m_monitor).*report)(m_probe, flowId, packetId, packetSize);
+    }
+}
+
+void
+FlowMonitorExportTestCase::DoRun()
+{
+    std::string fileName = CreateTempDirFilename("flow-monitor-export.csv");
+    m_monitor = CreateObjectWithAttributes<FlowMonitor>("ExportFileName",
+                                                        StringValue(fileName),
+                                                        "ExportInterval",
+                                                        TimeValue(Seconds(1)));
+    m_probe = CreateObject<TestFlowProbe>(m_monitor);
+    m_monitor->Start(Seconds(0));
+    m_monitor->Stop(Seconds(2.5));
+
+    auto firstTx = &FlowMonitor::ReportFirstTx;
+    auto forwarding = &FlowMonitor::ReportForwarding;
+    auto lastRx = &FlowMonitor::ReportLastRx;
+    auto at = [this](double time,
+                     void (FlowMonitor::*report)(Ptr<FlowProbe>, uint32_t, uint32_t, uint32_t),
+                     FlowId flowId,
+                     FlowPacketId firstPacketId,
+                     uint32_t nPackets) {
+        Simulator::Schedule(Seconds(time),
+                            &FlowMonitorExportTestCase::Report,
+                            this,
+                            report,
+                            flowId,
+                            firstPacketId,
+                            nPackets,
+                            flowId * 100);
+    };
+
+    // flow 1: 10 packets of 100 bytes received after 100 ms in the first interval
+    at(0.1, firstTx, 1, 0, 10);
+    at(0.2, lastRx, 1, 0, 10);
+    // flow 2: a packet of 200 bytes still in flight at the end of the first interval
+    at(0.3, firstTx, 2, 0, 1);
+    // flow 1: 5 packets forwarded, 4 of them received after 200 ms and one dropped,
+    // in the second interval
+    at(1.4, firstTx, 1, 10, 5);
+    at(1.5, forwarding, 1, 10, 5);
+    at(1.6, lastRx, 1, 10, 4);
+    Simulator::Schedule(Seconds(1.6), &FlowMonitor::ReportDrop, m_monitor, m_probe, 1, 14, 100, 0);
+    // no change after the second interval: no line is written when the
+    // monitoring stops and when the simulator is destroyed
+
+    Simulator::Stop(Seconds(3));
+    Simulator::Run();
+    Simulator::Destroy();
+
+    std::vector<std::string> expected = {
+        "time,flowId,txBytes,rxBytes,txPackets,rxPackets,lostPackets,timesForwarded,delaySum,"
+        "jitterSum,sampledPackets",
+        "1000000000,1,1000,1000,10,10,0,0,1000000000,0,10",
+        "1000000000,2,200,0,1,0,0,0,0,0,0",
+        "2000000000,1,500,400,5,4,1,4,800000000,100000000,4",
+    };
+    std::ifstream in(fileName);
+    NS_TEST_ASSERT_MSG_EQ(in.is_open(), true, "The export file was not written");
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(in, line))
+    {
+        lines.push_back(line);
+    }
+    NS_TEST_ASSERT_MSG_EQ(lines.size(), expected.size(), "Wrong number of lines");
+    for (std::size_t i = 0; i < expected.size(); i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(lines[i], expected[i], "Wrong line " << i);
+    }
+
+    // the flows are listed in the order of their identifiers
+    const FlowMonitor::FlowStatsContainer& stats = m_monitor->GetFlowStats();
+    NS_TEST_ASSERT_MSG_EQ(stats.size(), 2, "Wrong number of flows");
+    NS_TEST_EXPECT_MSG_EQ(stats.begin()->first, 1, "The flows are not sorted");
+    NS_TEST_EXPECT_MSG_EQ(stats.begin()->second.txPackets, 15, "Wrong number of packets");
+
+    m_monitor->Dispose();
+    m_monitor = nullptr;
+    m_probe = nullptr;
+}
+
+/**
+ * \ingroup flow-monitor-test
+ *
+ * \brief Check the flow statistics when only a sample of the packets is tracked.
+ *
+ * 100 packets of a flow are transmitted. The first 80 packets are received
+ * after 100 ms, one of the others is dropped by a probe and the rest is never
+ * seen again. The byte and packet counters must be exact, the delays must be
+ * measured on the tracked packets, and the lost packets must be estimated
+ * from the tracked packets found lost.
+ */
+class FlowMonitorSamplingTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     * \param method the sampling method
+     */
+    FlowMonitorSamplingTestCase(FlowMonitor::SamplingMethod method);
+
+  private:
+    void DoRun() override;
+
+    FlowMonitor::SamplingMethod m_method; //!< the sampling method
+};
+
+FlowMonitorSamplingTestCase::FlowMonitorSamplingTestCase(FlowMonitor::SamplingMethod method)
+    : TestCase(std::string("Check the flow statistics of sampled packets, sampled by ") +
+               (method == FlowMonitor::SAMPLE_PACKET_ID ? "packet id" : "hash")),
+      m_method(method)
+{
+}
+
+void
+FlowMonitorSamplingTestCase::DoRun()
+{
+    const uint32_t ratio = 4;
+    Ptr<FlowMonitor> monitor = CreateObjectWithAttributes<FlowMonitor>("SamplingRatio",
+                                                                       UintegerValue(ratio),
+                                                                       "SamplingMethod",
+                                                                       EnumValue(m_method),
+                                                                       "MaxPerHopDelay",
+                                                                       TimeValue(Seconds(1)));
+    Ptr<FlowProbe> probe = CreateObject<TestFlowProbe>(monitor);
+    monitor->Start(Seconds(0));
+    monitor->Stop(Seconds(5));
+
+    for (FlowPacketId packetId = 0; packetId < 100; packetId++)
+    {
+        Simulator::Schedule(Seconds(0.1),
+                            &FlowMonitor::ReportFirstTx,
+                            monitor,
+                            probe,
+                            1,
+                            packetId,
+                            100);
+        if (packetId < 80)
+        {
+            Simulator::Schedule(Seconds(0.2),
+                                &FlowMonitor::ReportLastRx,
+                                monitor,
+                                probe,
+                                1,
+                                packetId,
+                                100);
+        }
+    }
+    Simulator::Schedule(Seconds(0.3), &FlowMonitor::ReportDrop, monitor, probe, 1, 81, 100, 0);
+
+    Simulator::Stop(Seconds(6));
+    Simulator::Run();
+
+    const FlowMonitor::FlowStats& stats = monitor->GetFlowStats().at(1);
+    NS_TEST_EXPECT_MSG_EQ(stats.txPackets, 100, "The transmitted packets are not exact");
+    NS_TEST_EXPECT_MSG_EQ(stats.txBytes, 10000, "The transmitted bytes are not exact");
+    NS_TEST_EXPECT_MSG_EQ(stats.rxPackets, 80, "The received packets are not exact");
+    NS_TEST_EXPECT_MSG_EQ(stats.rxBytes, 8000, "The received bytes are not exact");
+    NS_TEST_EXPECT_MSG_EQ(stats.delaySum,
+                          MilliSeconds(100 * stats.sampledPackets),
+                          "The delays are not measured on the tracked packets");
+    NS_TEST_EXPECT_MSG_EQ(stats.jitterSum, Seconds(0), "Wrong jitter");
+    NS_TEST_EXPECT_MSG_EQ(stats.packetsDropped.at(0), 1, "The dropped packets are not exact");
+
+    uint32_t sampledRx = 0;
+    uint32_t sampledLost = 0;
+    for (FlowPacketId packetId = 0; packetId < 100; packetId++)
+    {
+        // same sampling as FlowMonitor::IsSampled
+        uint64_t key = (uint64_t(1) << 32) | packetId;
+        if (m_method == FlowMonitor::SAMPLE_HASH)
+        {
+            key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+            key ^= key >> 31;
+        }
+        else
+        {
+            key = packetId;
+        }
+        if (key % ratio == 0)
+        {
+            if (packetId < 80)
+            {
+                sampledRx++;
+            }
+            else if (packetId != 81)
+            {
+                sampledLost++;
+            }
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ(stats.sampledPackets, sampledRx, "Wrong number of tracked packets");
+    uint32_t lost = std::min(1 + sampledLost * ratio, 20U);
+    NS_TEST_EXPECT_MSG_EQ(stats.lostPackets, lost, "Wrong estimate of the lost packets");
+    if (m_method == FlowMonitor::SAMPLE_PACKET_ID)
+    {
+        NS_TEST_EXPECT_MSG_EQ(stats.sampledPackets, 20, "Wrong number of tracked packets");
+        NS_TEST_EXPECT_MSG_EQ(stats.lostPackets, 20, "Wrong estimate of the lost packets");
+    }
+
+    Simulator::Destroy();
+    monitor->Dispose();
+}
+
+/**
+ * \ingroup flow-monitor-test
+ *
+ * \brief Check that the flow statistics of a TCP transfer do not change when
+ * the segmentation offload is emulated.
+ *
+ * The super-segments built by TCP are split after the traffic control layer,
+ * where the "SendOutgoing" trace of the IP layer is fired for each segment,
+ * hence the probes see the segments. A bulk transfer over a lossy link is run
+ * without and with the emulation, and the statistics of its flows must be the
+ * same.
+ */
+class FlowMonitorGsoTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     * \param useIpv6 use IPv6 instead of IPv4
+     */
+    FlowMonitorGsoTestCase(bool useIpv6);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Run the bulk transfer
+     * \param gsoMaxSize the GsoMaxSize attribute of the sender
+     * \return the flow statistics
+     */
+    std::map<FlowId, FlowMonitor::FlowStats> RunTransfer(uint32_t gsoMaxSize);
+
+    /**
+     * Fill the Tx buffer of the sender
+     * \param socket the sender socket
+     * \param available the space available in the Tx buffer
+     */
+    void SendData(Ptr<Socket> socket, uint32_t available);
+
+    bool m_useIpv6;                //!< use IPv6 instead of IPv4
+    uint32_t m_totalBytes{300000}; //!< bytes to transfer
+    uint32_t m_sentBytes{0};       //!< bytes handed to the sender socket
+};
+
+FlowMonitorGsoTestCase::FlowMonitorGsoTestCase(bool useIpv6)
+    : TestCase(std::string("Check the flow statistics of TCP super-segments over ") +
+               (useIpv6 ? "IPv6" : "IPv4")),
+      m_useIpv6(useIpv6)
+{
+}
+
+void
+FlowMonitorGsoTestCase::SendData(Ptr<Socket> socket, uint32_t available)
+{
+    while (m_sentBytes < m_totalBytes && socket->GetTxAvailable() > 0)
+    {
+        uint32_t size = std::min(socket->GetTxAvailable(), m_totalBytes - m_sentBytes);
+        int sent = socket->Send(Create<Packet>(size));
+        if (sent <= 0)
+        {
+            break;
+        }
+        m_sentBytes += sent;
+    }
+}
+
+std::map<FlowId, FlowMonitor::FlowStats>
+FlowMonitorGsoTestCase::RunTransfer(uint32_t gsoMaxSize)
+{
+    m_sentBytes = 0;
+
+    NodeContainer nodes;
+    nodes.Create(2);
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    internet.AssignStreams(nodes, 10);
+
+    SimpleNetDeviceHelper simple;
+    simple.SetDeviceAttribute("DataRate", DataRateValue(DataRate("100Mbps")));
+    simple.SetChannelAttribute("Delay", TimeValue(MilliSeconds(10)));
+    NetDeviceContainer devices = simple.Install(nodes);
+    devices.Get(0)->SetMtu(1500);
+    devices.Get(1)->SetMtu(1500);
+
+    Ptr<RateErrorModel> errorModel = CreateObject<RateErrorModel>();
+    errorModel->SetUnit(RateErrorModel::ERROR_UNIT_PACKET);
+    errorModel->SetRate(0.01);
+    errorModel->AssignStreams(1);
+    devices.Get(1)->SetAttribute("ReceiveErrorModel", PointerValue(errorModel));
+
+    Address serverAddress;
+    if (m_useIpv6)
+    {
+        Ipv6AddressHelper ipv6;
+        ipv6.SetBase(Ipv6Address("2001:db8::"), Ipv6Prefix(64));
+        Ipv6InterfaceContainer interfaces = ipv6.Assign(devices);
+        serverAddress = Inet6SocketAddress(interfaces.GetAddress(1, 1), 50000);
+    }
+    else
+    {
+        Ipv4AddressHelper ipv4;
+        ipv4.SetBase(Ipv4Address("10.0.0.0"), Ipv4Mask("255.255.255.0"));
+        Ipv4InterfaceContainer interfaces = ipv4.Assign(devices);
+        serverAddress = InetSocketAddress(interfaces.GetAddress(1), 50000);
+    }
+
+    FlowMonitorHelper flowMonitorHelper;
+    Ptr<FlowMonitor> monitor = flowMonitorHelper.InstallAll();
+
+    // the received data is left in the buffer of the receiver, which keeps
+    // advertising a window larger than the transfer
+    Ptr<Socket> server = Socket::CreateSocket(nodes.Get(1), TcpSocketFactory::GetTypeId());
+    server->SetAttribute("RcvBufSize", UintegerValue(2 * m_totalBytes));
+    if (m_useIpv6)
+    {
+        server->Bind(Inet6SocketAddress(Ipv6Address::GetAny(), 50000));
+    }
+    else
+    {
+        server->Bind(InetSocketAddress(Ipv4Address::GetAny(), 50000));
+    }
+    server->Listen();
+
+    Ptr<Socket> client = Socket::CreateSocket(nodes.Get(0), TcpSocketFactory::GetTypeId());
+    client->SetAttribute("SegmentSize", UintegerValue(1000));
+    client->SetAttribute("GsoMaxSize", UintegerValue(gsoMaxSize));
+    client->SetSendCallback(MakeCallback(&FlowMonitorGsoTestCase::SendData, this));
+    if (m_useIpv6)
+    {
+        client->Bind6();
+    }
+    else
+    {
+        client->Bind();
+    }
+    // leave time to the duplicate address detection
+    Simulator::Schedule(Seconds(3), [client, serverAddress]() { client->Connect(serverAddress); });
+
+    Simulator::Stop(Seconds(30));
+    Simulator::Run();
+    monitor->CheckForLostPackets();
+    std::map<FlowId, FlowMonitor::FlowStats> stats = monitor->GetFlowStats();
+    Simulator::Destroy();
+
+    NS_TEST_EXPECT_MSG_EQ(m_sentBytes, m_totalBytes, "All the data should be sent");
+    return stats;
+}
+
+void
+FlowMonitorGsoTestCase::DoRun()
+{
+    std::map<FlowId, FlowMonitor::FlowStats> reference = RunTransfer(0);
+    std::map<FlowId, FlowMonitor::FlowStats> stats = RunTransfer(64000);
+
+    NS_TEST_ASSERT_MSG_EQ(reference.size(), 2, "Expected the data and the ACK flows");
+    NS_TEST_ASSERT_MSG_EQ(stats.size(), reference.size(), "Wrong number of flows");
+    for (const auto& [flowId, expected] : reference)
+    {
+        const FlowMonitor::FlowStats& flow = stats.at(flowId);
+        NS_TEST_EXPECT_MSG_EQ(flow.txPackets, expected.txPackets, "Flow " << flowId);
+        NS_TEST_EXPECT_MSG_EQ(flow.txBytes, expected.txBytes, "Flow " << flowId);
+        NS_TEST_EXPECT_MSG_EQ(flow.rxPackets, expected.rxPackets, "Flow " << flowId);
+        NS_TEST_EXPECT_MSG_EQ(flow.rxBytes, expected.rxBytes, "Flow " << flowId);
+        NS_TEST_EXPECT_MSG_EQ(flow.lostPackets, expected.lostPackets, "Flow " << flowId);
+        NS_TEST_EXPECT_MSG_EQ(flow.delaySum, expected.delaySum, "Flow " << flowId);
+        NS_TEST_EXPECT_MSG_EQ(flow.jitterSum, expected.jitterSum, "Flow " << flowId);
+    }
+    NS_TEST_EXPECT_MSG_GT(reference.begin()->second.lostPackets +
+                              std::next(reference.begin())->second.lostPackets,
+                          0,
+                          "Some packets should be lost");
+}
+
+/**
+ * \ingroup flow-monitor-test
+ *
+ * \brief Flow Monitor TestSuite
+ */
+class FlowMonitorTestSuite : public TestSuite
+{
+  public:
+    FlowMonitorTestSuite();
+};
+
+FlowMonitorTestSuite::FlowMonitorTestSuite()
+    : TestSuite("flow-monitor", UNIT)
+{
+    AddTestCase(new FlowMonitorExportTestCase(), TestCase::QUICK);
+    AddTestCase(new FlowMonitorSamplingTestCase(FlowMonitor::SAMPLE_PACKET_ID), TestCase::QUICK);
+    AddTestCase(new FlowMonitorSamplingTestCase(FlowMonitor::SAMPLE_HASH), TestCase::QUICK);
+    AddTestCase(new FlowMonitorGsoTestCase(false), TestCase::QUICK);
+    AddTestCase(new FlowMonitorGsoTestCase(true), TestCase::QUICK);
+}
+
+/// Static variable for test initialization
+static FlowMonitorTestSuite g_flowMonitorTestSuite;
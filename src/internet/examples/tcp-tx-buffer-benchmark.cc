@@ -0,0 +1,118 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * This program measures the time needed by the TcpTxBuffer to manage a large
+ * window of segments in flight with SACK loss recovery, as it happens in a
+ * flow with a large bandwidth-delay product.
+ * In each round a window of numSegments segments is sent, and one segment
+ * every lossInterval is lost. For each segment received by the other end,
+ * the sender processes a SACK block (as TcpSocketBase does when it receives a
+ * duplicate ACK), asks the next segment to send and retransmits it if it is
+ * lost. At the end of the round the whole window is acknowledged.
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/packet.h"
+#include "ns3/tcp-tx-buffer.h"
+
+#include <chrono>
+#include <iostream>
+#include <limits>
+
+using namespace ns3;
+
+/**
+ * \return the receiver window, which does not limit the sender
+ */
+static uint32_t
+GetRWnd()
+{
+    return std::numeric_limits<uint32_t>::max();
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t numSegments = 10000; // segments in flight in each round
+    uint32_t lossInterval = 100;  // one segment every lossInterval is lost
+    uint32_t numRounds = 10;      // number of windows sent
+    uint32_t segmentSize = 1448;  // segment size in bytes
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("numSegments", "The number of segments in flight in each round", numSegments);
+    cmd.AddValue("lossInterval", "One segment every lossInterval is lost", lossInterval);
+    cmd.AddValue("numRounds", "The number of rounds", numRounds);
+    cmd.AddValue("segmentSize", "The segment size in bytes", segmentSize);
+    cmd.Parse(argc, argv);
+
+    Ptr<TcpTxBuffer> txBuffer = CreateObject<TcpTxBuffer>(1);
+    txBuffer->SetMaxBufferSize(numSegments * segmentSize);
+    txBuffer->SetSegmentSize(segmentSize);
+    txBuffer->SetDupAckThresh(3);
+    txBuffer->SetRWndCallback(MakeCallback(&GetRWnd));
+
+    uint64_t retransmissions = 0;
+    uint64_t sackBlocks = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t round = 0; round < numRounds; round++)
+    {
+        SequenceNumber32 head = txBuffer->HeadSequence();
+        for (uint32_t i = 0; i < numSegments; i++)
+        {
+            txBuffer->Add(Create<Packet>(segmentSize));
+        }
+        for (uint32_t i = 0; i < numSegments; i++)
+        {
+            txBuffer->CopyFromSequence(segmentSize, head + i * segmentSize);
+        }
+
+        for (uint32_t i = 0; i < numSegments; i++)
+        {
+            if (i % lossInterval == 0)
+            {
+                continue;
+            }
+            // the block of contiguous segments received after the last hole
+            TcpOptionSack::SackList sackList;
+            sackList.emplace_back(head + (i - i % lossInterval + 1) * segmentSize,
+                                  head + (i + 1) * segmentSize);
+            txBuffer->Update(sackList);
+            sackBlocks++;
+
+            SequenceNumber32 seq;
+            SequenceNumber32 seqHigh;
+            if (txBuffer->NextSeg(&seq, &seqHigh, true) && txBuffer->IsLost(seq))
+            {
+                txBuffer->CopyFromSequence(segmentSize, seq);
+                retransmissions++;
+            }
+        }
+
+        // the retransmissions are received, the whole window is acknowledged
+        txBuffer->DiscardUpTo(head + numSegments * segmentSize);
+    }
+    auto end = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    double bytes = static_cast<double>(numRounds) * numSegments * segmentSize;
+    std::cout << numRounds << " rounds of " << numSegments << " segments: " << sackBlocks
+              << " SACK blocks and " << retransmissions << " retransmissions in " << elapsed
+              << " ms (" << bytes * 8 / elapsed / 1e3 << " Mbit of data per second of CPU time)"
+              << std::endl;
+
+    return 0;
+}
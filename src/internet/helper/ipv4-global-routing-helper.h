@@ -88,6 +88,16 @@ class Ipv4GlobalRoutingHelper : public Ipv4RoutingHelper
      *
      */
     static void RecomputeRoutingTables();
+    /**
+     * \brief Update the routing tables after a change of the topology.
+     *
+     * Like RecomputeRoutingTables(), this method updates the representation of
+     * the global topology, but it only recomputes the routes of the nodes whose
+     * routes may depend on the Link State Advertisements that changed, and
+     * leaves the routes of the other nodes in place.  The resulting routes are
+     * the same as those installed by RecomputeRoutingTables().
+     */
+    static void UpdateRoutingTables();
 };
 
 } // namespace ns3
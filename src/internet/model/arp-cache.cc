@@ -30,6 +30,8 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
 
+#include <vector>
+
 namespace ns3
 {
 
@@ -197,11 +199,14 @@ void
 ArpCache::HandleWaitReplyTimeout()
 {
     NS_LOG_FUNCTION(this);
-    ArpCache::Entry* entry;
     bool restartWaitReplyTimer = false;
-    for (CacheI i = m_arpCache.begin(); i != m_arpCache.end(); i++)
+    // visit only the entries waiting for a reply, in address order; a copy is
+    // needed because marking an entry as dead removes it from the set
+    std::vector<Ipv4Address> waitReplyEntries(m_waitReplyEntries.begin(),
+                                              m_waitReplyEntries.end());
+    for (const auto& address : waitReplyEntries)
     {
-        entry = (*i).second;
+        ArpCache::Entry* entry = Lookup(address);
         if (entry != nullptr && entry->IsWaitReply())
         {
             if (entry->GetRetries() < m_maxRetries)
@@ -250,6 +255,7 @@ ArpCache::Flush()
         delete (*i).second;
     }
     m_arpCache.erase(m_arpCache.begin(), m_arpCache.end());
+    m_waitReplyEntries.clear();
     if (m_waitReplyTimer.IsRunning())
     {
         NS_LOG_LOGIC("Stopping WaitReplyTimer at " << Simulator::Now().GetSeconds()
@@ -264,7 +270,9 @@ ArpCache::PrintArpCache(Ptr<OutputStreamWrapper> stream)
     NS_LOG_FUNCTION(this << stream);
     std::ostream* os = stream->GetStream();
 
-    for (CacheI i = m_arpCache.begin(); i != m_arpCache.end(); i++)
+    // print the entries in address order
+    std::map<Ipv4Address, ArpCache::Entry*> entries(m_arpCache.begin(), m_arpCache.end());
+    for (auto i = entries.begin(); i != entries.end(); i++)
     {
         *os << i->first << " dev ";
         std::string found = Names::FindName(m_device);
@@ -312,7 +320,7 @@ ArpCache::RemoveAutoGeneratedEntries()
         {
             i->second->ClearPendingPacket(); // clear the pending packets for entry's ipaddress
             delete i->second;
-            m_arpCache.erase(i++);
+            i = m_arpCache.erase(i);
             continue;
         }
         i++;
@@ -333,6 +341,9 @@ ArpCache::LookupInverse(Address to)
             entryList.push_back(entry);
         }
     }
+    entryList.sort([](const ArpCache::Entry* a, const ArpCache::Entry* b) {
+        return a->GetIpv4Address() < b->GetIpv4Address();
+    });
     return entryList;
 }
 
@@ -365,15 +376,14 @@ ArpCache::Remove(ArpCache::Entry* entry)
 {
     NS_LOG_FUNCTION(this << entry);
 
-    for (CacheI i = m_arpCache.begin(); i != m_arpCache.end(); i++)
+    CacheI it = m_arpCache.find(entry->GetIpv4Address());
+    if (it != m_arpCache.end() && it->second == entry)
     {
-        if ((*i).second == entry)
-        {
-            m_arpCache.erase(i);
-            entry->ClearPendingPacket(); // clear the pending packets for entry's ipaddress
-            delete entry;
-            return;
-        }
+        m_arpCache.erase(it);
+        m_waitReplyEntries.erase(entry->GetIpv4Address());
+        entry->ClearPendingPacket(); // clear the pending packets for entry's ipaddress
+        delete entry;
+        return;
     }
     NS_LOG_WARN("Entry not found in this ARP Cache");
 }
@@ -426,6 +436,7 @@ ArpCache::Entry::MarkDead()
 {
     NS_LOG_FUNCTION(this);
     NS_ASSERT(m_state == ALIVE || m_state == WAIT_REPLY || m_state == DEAD);
+    m_arp->m_waitReplyEntries.erase(m_ipv4Address);
     m_state = DEAD;
     ClearRetries();
     UpdateSeen();
@@ -437,6 +448,7 @@ ArpCache::Entry::MarkAlive(Address macAddress)
     NS_LOG_FUNCTION(this << macAddress);
     NS_ASSERT(m_state == WAIT_REPLY);
     m_macAddress = macAddress;
+    m_arp->m_waitReplyEntries.erase(m_ipv4Address);
     m_state = ALIVE;
     ClearRetries();
     UpdateSeen();
@@ -448,6 +460,7 @@ ArpCache::Entry::MarkPermanent()
     NS_LOG_FUNCTION(this << m_macAddress);
     NS_ASSERT(!m_macAddress.IsInvalid());
 
+    m_arp->m_waitReplyEntries.erase(m_ipv4Address);
     m_state = PERMANENT;
     ClearRetries();
     UpdateSeen();
@@ -459,6 +472,7 @@ ArpCache::Entry::MarkAutoGenerated()
     NS_LOG_FUNCTION(this << m_macAddress);
     NS_ASSERT(!m_macAddress.IsInvalid());
 
+    m_arp->m_waitReplyEntries.erase(m_ipv4Address);
     m_state = STATIC_AUTOGENERATED;
     ClearRetries();
     UpdateSeen();
@@ -490,6 +504,7 @@ ArpCache::Entry::MarkWaitReply(Ipv4PayloadHeaderPair waiting)
     NS_ASSERT_MSG(waiting.first, "Can not add a null packet to the ARP queue");
 
     m_state = WAIT_REPLY;
+    m_arp->m_waitReplyEntries.insert(m_ipv4Address);
     m_pending.push_back(waiting);
     UpdateSeen();
     m_arp->StartWaitReplyTimer();
@@ -33,7 +33,9 @@
 
 #include <list>
 #include <map>
+#include <set>
 #include <stdint.h>
+#include <unordered_map>
 
 namespace ns3
 {
@@ -321,11 +323,11 @@ class ArpCache : public Object
     /**
      * \brief ARP Cache container
      */
-    typedef std::map<Ipv4Address, ArpCache::Entry*> Cache;
+    typedef std::unordered_map<Ipv4Address, ArpCache::Entry*, Ipv4AddressHash> Cache;
     /**
      * \brief ARP Cache container iterator
      */
-    typedef std::map<Ipv4Address, ArpCache::Entry*>::iterator CacheI;
+    typedef std::unordered_map<Ipv4Address, ArpCache::Entry*, Ipv4AddressHash>::iterator CacheI;
 
     void DoDispose() override;
 
@@ -345,8 +347,9 @@ class ArpCache : public Object
      * If there are no Arp requests pending, this event is not scheduled.
      */
     void HandleWaitReplyTimeout();
-    uint32_t m_pendingQueueSize; //!< number of packets waiting for a resolution
-    Cache m_arpCache;            //!< the ARP cache
+    uint32_t m_pendingQueueSize;              //!< number of packets waiting for a resolution
+    Cache m_arpCache;                         //!< the ARP cache
+    std::set<Ipv4Address> m_waitReplyEntries; //!< addresses of the entries waiting for a reply
     TracedCallback<Ptr<const Packet>>
         m_dropTrace; //!< trace for packets dropped by the ARP cache queue
 };
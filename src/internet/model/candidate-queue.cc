@@ -58,22 +58,23 @@ operator<<(std::ostream& os, const SPFVertex::VertexType& t)
 std::ostream&
 operator<<(std::ostream& os, const CandidateQueue& q)
 {
-    typedef CandidateQueue::CandidateList_t List_t;
-    typedef List_t::const_iterator CIter_t;
-    const CandidateQueue::CandidateList_t& list = q.m_candidates;
+    // print the candidates in the order in which they would be popped
+    CandidateQueue::CandidateList_t list = q.m_candidates;
+    std::sort_heap(list.begin(), list.end(), &CandidateQueue::CompareCandidates);
 
     os << "*** CandidateQueue Begin (<id, distance, LSA-type>) ***" << std::endl;
-    for (CIter_t iter = list.begin(); iter != list.end(); iter++)
+    for (auto iter = list.rbegin(); iter != list.rend(); iter++)
     {
-        os << "<" << (*iter)->GetVertexId() << ", " << (*iter)->GetDistanceFromRoot() << ", "
-           << (*iter)->GetVertexType() << ">" << std::endl;
+        os << "<" << iter->vertex->GetVertexId() << ", " << iter->vertex->GetDistanceFromRoot()
+           << ", " << iter->vertex->GetVertexType() << ">" << std::endl;
     }
     os << "*** CandidateQueue End ***";
     return os;
 }
 
 CandidateQueue::CandidateQueue()
-    : m_candidates()
+    : m_candidates(),
+      m_nextOrder(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -101,11 +102,9 @@ CandidateQueue::Push(SPFVertex* vNew)
 {
     NS_LOG_FUNCTION(this << vNew);
 
-    CandidateList_t::iterator i = std::upper_bound(m_candidates.begin(),
-                                                   m_candidates.end(),
-                                                   vNew,
-                                                   &CandidateQueue::CompareSPFVertex);
-    m_candidates.insert(i, vNew);
+    m_candidates.push_back({vNew, vNew->GetDistanceFromRoot(), m_nextOrder++});
+    std::push_heap(m_candidates.begin(), m_candidates.end(), &CandidateQueue::CompareCandidates);
+    m_vertices.emplace(vNew->GetVertexId(), vNew);
 }
 
 SPFVertex*
@@ -117,8 +116,14 @@ CandidateQueue::Pop()
         return nullptr;
     }
 
-    SPFVertex* v = m_candidates.front();
-    m_candidates.pop_front();
+    std::pop_heap(m_candidates.begin(), m_candidates.end(), &CandidateQueue::CompareCandidates);
+    SPFVertex* v = m_candidates.back().vertex;
+    m_candidates.pop_back();
+    auto it = m_vertices.find(v->GetVertexId());
+    if (it != m_vertices.end() && it->second == v)
+    {
+        m_vertices.erase(it);
+    }
     return v;
 }
 
@@ -131,7 +136,7 @@ CandidateQueue::Top() const
         return nullptr;
     }
 
-    return m_candidates.front();
+    return m_candidates.front().vertex;
 }
 
 bool
@@ -152,18 +157,8 @@ SPFVertex*
 CandidateQueue::Find(const Ipv4Address addr) const
 {
     NS_LOG_FUNCTION(this);
-    CandidateList_t::const_iterator i = m_candidates.begin();
-
-    for (; i != m_candidates.end(); i++)
-    {
-        SPFVertex* v = *i;
-        if (v->GetVertexId() == addr)
-        {
-            return v;
-        }
-    }
-
-    return nullptr;
+    auto it = m_vertices.find(addr);
+    return it == m_vertices.end() ? nullptr : it->second;
 }
 
 void
@@ -171,11 +166,35 @@ CandidateQueue::Reorder()
 {
     NS_LOG_FUNCTION(this);
 
-    m_candidates.sort(&CandidateQueue::CompareSPFVertex);
+    // the vertices whose distance changed are ordered after the vertices
+    // already having the same priority, as if they were pushed again
+    for (auto& candidate : m_candidates)
+    {
+        if (candidate.distance != candidate.vertex->GetDistanceFromRoot())
+        {
+            candidate.distance = candidate.vertex->GetDistanceFromRoot();
+            candidate.order = m_nextOrder++;
+        }
+    }
+    std::make_heap(m_candidates.begin(), m_candidates.end(), &CandidateQueue::CompareCandidates);
     NS_LOG_LOGIC("After reordering the CandidateQueue");
     NS_LOG_LOGIC(*this);
 }
 
+bool
+CandidateQueue::CompareCandidates(const Candidate& c1, const Candidate& c2)
+{
+    if (CompareSPFVertex(c1.vertex, c2.vertex))
+    {
+        return false;
+    }
+    if (CompareSPFVertex(c2.vertex, c1.vertex))
+    {
+        return true;
+    }
+    return c1.order > c2.order;
+}
+
 /*
  * In this implementation, SPFVertex follows the ordering where
  * a vertex is ranked first if its GetDistanceFromRoot () is smaller;
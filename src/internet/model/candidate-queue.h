@@ -22,8 +22,9 @@
 
 #include "ns3/ipv4-address.h"
 
-#include <list>
 #include <stdint.h>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -48,6 +49,10 @@ class SPFVertex;
  * for a Find () operation, the dynamic nature of the data and the derived
  * requirement for a Reorder () operation led us to implement this simple
  * enhanced priority queue.
+ *
+ * The vertices are stored in a binary heap, and indexed by vertex ID for
+ * Find (). Vertices with the same priority are popped in the order in which
+ * they were pushed, or in which their distance was last changed.
  */
 class CandidateQueue
 {
@@ -173,8 +178,31 @@ class CandidateQueue
      */
     static bool CompareSPFVertex(const SPFVertex* v1, const SPFVertex* v2);
 
-    typedef std::list<SPFVertex*> CandidateList_t; //!< container of SPFVertex pointers
-    CandidateList_t m_candidates;                  //!< SPFVertex candidates
+    /// A vertex stored in the queue
+    struct Candidate
+    {
+        SPFVertex* vertex; //!< the vertex
+        uint32_t distance; //!< the distance of the vertex when it was last ordered
+        uint64_t order;    //!< sequence number, ordering the vertices with the same priority
+    };
+
+    /**
+     * \brief return true if c1 has to be popped after c2
+     *
+     * This is the ordering of the binary heap, which holds at its front the
+     * candidate to be popped first.
+     *
+     * \param c1 first operand
+     * \param c2 second operand
+     * \return True if c1 should be popped after c2; false otherwise
+     */
+    static bool CompareCandidates(const Candidate& c1, const Candidate& c2);
+
+    typedef std::vector<Candidate> CandidateList_t; //!< container of SPFVertex candidates
+    CandidateList_t m_candidates;                   //!< SPFVertex candidates, as a binary heap
+    /// SPFVertex candidates, indexed by vertex ID
+    std::unordered_map<Ipv4Address, SPFVertex*, Ipv4AddressHash> m_vertices;
+    uint64_t m_nextOrder; //!< sequence number of the next vertex pushed or reordered
 
     /**
      * \brief Stream insertion operator.
@@ -30,13 +30,17 @@
 
 #include "ns3/assert.h"
 #include "ns3/fatal-error.h"
+#include "ns3/global-value.h"
 #include "ns3/log.h"
 #include "ns3/node-list.h"
 #include "ns3/simulator.h"
+#include "ns3/uinteger.h"
 
 #include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <queue>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -45,6 +49,97 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("GlobalRouteManagerImpl");
 
+/**
+ * \ingroup globalrouting
+ * The number of threads running the SPF calculations of the routers.
+ */
+static GlobalValue g_spfThreads("GlobalRoutingSpfThreads",
+                                "The number of threads running the SPF calculations of the "
+                                "global routing (0 for the number of hardware threads)",
+                                UintegerValue(1),
+                                MakeUintegerChecker<uint32_t>());
+
+/**
+ * \brief Test if two LSAs advertise the same links.
+ *
+ * \param lsa1 the first LSA
+ * \param lsa2 the second LSA
+ * \returns true if the LSAs only differ by their SPF status
+ */
+static bool
+IsSameLSA(const GlobalRoutingLSA* lsa1, const GlobalRoutingLSA* lsa2)
+{
+    if (lsa1->GetLSType() != lsa2->GetLSType() ||
+        lsa1->GetLinkStateId() != lsa2->GetLinkStateId() ||
+        lsa1->GetAdvertisingRouter() != lsa2->GetAdvertisingRouter() ||
+        lsa1->GetNetworkLSANetworkMask() != lsa2->GetNetworkLSANetworkMask() ||
+        lsa1->GetNLinkRecords() != lsa2->GetNLinkRecords() ||
+        lsa1->GetNAttachedRouters() != lsa2->GetNAttachedRouters())
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < lsa1->GetNLinkRecords(); i++)
+    {
+        GlobalRoutingLinkRecord* l1 = lsa1->GetLinkRecord(i);
+        GlobalRoutingLinkRecord* l2 = lsa2->GetLinkRecord(i);
+        if (l1->GetLinkType() != l2->GetLinkType() || l1->GetLinkId() != l2->GetLinkId() ||
+            l1->GetLinkData() != l2->GetLinkData() || l1->GetMetric() != l2->GetMetric())
+        {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < lsa1->GetNAttachedRouters(); i++)
+    {
+        if (lsa1->GetAttachedRouter(i) != lsa2->GetAttachedRouter(i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * \brief Add the link data of the TransitNetwork link records of an LSA, that is
+ * the addresses under which GlobalRouteManagerLSDB::GetLSAByLinkData finds it.
+ *
+ * \param lsa the LSA
+ * \param addresses the set of addresses
+ */
+static void
+AddTransitLinkData(const GlobalRoutingLSA* lsa, std::set<Ipv4Address>& addresses)
+{
+    for (uint32_t i = 0; i < lsa->GetNLinkRecords(); i++)
+    {
+        GlobalRoutingLinkRecord* l = lsa->GetLinkRecord(i);
+        if (l->GetLinkType() == GlobalRoutingLinkRecord::TransitNetwork)
+        {
+            addresses.insert(l->GetLinkData());
+        }
+    }
+}
+
+/**
+ * \brief Test if two sets of addresses have an address in common.
+ *
+ * \param a the first set
+ * \param b the second set
+ * \returns true if an address is in both sets
+ */
+static bool
+Intersects(const std::set<Ipv4Address>& a, const std::set<Ipv4Address>& b)
+{
+    const std::set<Ipv4Address>& small = a.size() < b.size() ? a : b;
+    const std::set<Ipv4Address>& large = a.size() < b.size() ? b : a;
+    for (const auto& address : small)
+    {
+        if (large.find(address) != large.end())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 /**
  * \brief Stream insertion operator.
  *
@@ -428,7 +523,8 @@ SPFVertex::ClearVertexProcessed()
 
 GlobalRouteManagerLSDB::GlobalRouteManagerLSDB()
     : m_database(),
-      m_extdatabase()
+      m_extdatabase(),
+      m_linkDataIndexValid(false)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -476,6 +572,7 @@ GlobalRouteManagerLSDB::Insert(Ipv4Address addr, GlobalRoutingLSA* lsa)
     else
     {
         m_database.insert(LSDBPair_t(addr, lsa));
+        m_linkDataIndexValid = false;
     }
 }
 
@@ -500,15 +597,8 @@ GlobalRouteManagerLSDB::GetLSA(Ipv4Address addr) const
     //
     // Look up an LSA by its address.
     //
-    LSDBMap_t::const_iterator i;
-    for (i = m_database.begin(); i != m_database.end(); i++)
-    {
-        if (i->first == addr)
-        {
-            return i->second;
-        }
-    }
-    return nullptr;
+    auto i = m_database.find(addr);
+    return i == m_database.end() ? nullptr : i->second;
 }
 
 GlobalRoutingLSA*
@@ -518,22 +608,105 @@ GlobalRouteManagerLSDB::GetLSAByLinkData(Ipv4Address addr) const
     //
     // Look up an LSA by its address.
     //
-    LSDBMap_t::const_iterator i;
-    for (i = m_database.begin(); i != m_database.end(); i++)
+    // The index of the TransitNetwork link records is built on the first lookup
+    // after the database changed.  The LSAs are scanned in the same order used
+    // by the former linear search, and only the first LSA found for an address
+    // is kept, hence the lookup returns the same LSA.
+    //
+    if (!m_linkDataIndexValid)
     {
-        GlobalRoutingLSA* temp = i->second;
-        // Iterate among temp's Link Records
-        for (uint32_t j = 0; j < temp->GetNLinkRecords(); j++)
+        m_linkDataIndex.clear();
+        for (auto i = m_database.begin(); i != m_database.end(); i++)
         {
-            GlobalRoutingLinkRecord* lr = temp->GetLinkRecord(j);
-            if (lr->GetLinkType() == GlobalRoutingLinkRecord::TransitNetwork &&
-                lr->GetLinkData() == addr)
+            GlobalRoutingLSA* temp = i->second;
+            // Iterate among temp's Link Records
+            for (uint32_t j = 0; j < temp->GetNLinkRecords(); j++)
             {
-                return temp;
+                GlobalRoutingLinkRecord* lr = temp->GetLinkRecord(j);
+                if (lr->GetLinkType() == GlobalRoutingLinkRecord::TransitNetwork)
+                {
+                    m_linkDataIndex.emplace(lr->GetLinkData(), temp);
+                }
             }
         }
+        m_linkDataIndexValid = true;
     }
-    return nullptr;
+    auto i = m_linkDataIndex.find(addr);
+    return i == m_linkDataIndex.end() ? nullptr : i->second;
+}
+
+std::vector<GlobalRoutingLSA*>
+GlobalRouteManagerLSDB::GetLSAs() const
+{
+    NS_LOG_FUNCTION(this);
+    std::vector<GlobalRoutingLSA*> lsas;
+    lsas.reserve(m_database.size());
+    for (auto i = m_database.begin(); i != m_database.end(); i++)
+    {
+        lsas.push_back(i->second);
+    }
+    return lsas;
+}
+
+// ---------------------------------------------------------------------------
+//
+// GlobalRouteManagerImpl::LSDBSnapshot Implementation
+//
+// ---------------------------------------------------------------------------
+
+GlobalRouteManagerImpl::LSDBSnapshot::LSDBSnapshot(const GlobalRouteManagerLSDB& lsdb)
+    : lsas(lsdb.GetLSAs())
+{
+    NS_LOG_FUNCTION(this << &lsdb);
+    numbers.reserve(lsas.size());
+    for (uint32_t i = 0; i < lsas.size(); i++)
+    {
+        numbers.emplace(lsas[i], i);
+    }
+    auto getNumber = [this](const GlobalRoutingLSA* lsa) {
+        return lsa ? GetNumber(lsa) : NO_LSA;
+    };
+    //
+    // The links are those examined by SPFNext: the point-to-point and transit
+    // network link records of a router LSA, and the routers attached to a
+    // network LSA, which are looked up by link data and skipped if not found.
+    //
+    firstLink.reserve(lsas.size() + 1);
+    for (GlobalRoutingLSA* lsa : lsas)
+    {
+        firstLink.push_back(links.size());
+        if (lsa->GetLSType() == GlobalRoutingLSA::RouterLSA)
+        {
+            for (uint32_t i = 0; i < lsa->GetNLinkRecords(); i++)
+            {
+                GlobalRoutingLinkRecord* l = lsa->GetLinkRecord(i);
+                if (l->GetLinkType() != GlobalRoutingLinkRecord::StubNetwork)
+                {
+                    links.push_back({getNumber(lsdb.GetLSA(l->GetLinkId())), l});
+                }
+            }
+        }
+        else if (lsa->GetLSType() == GlobalRoutingLSA::NetworkLSA)
+        {
+            for (uint32_t i = 0; i < lsa->GetNAttachedRouters(); i++)
+            {
+                GlobalRoutingLSA* w_lsa = lsdb.GetLSAByLinkData(lsa->GetAttachedRouter(i));
+                if (w_lsa)
+                {
+                    links.push_back({getNumber(w_lsa), nullptr});
+                }
+            }
+        }
+    }
+    firstLink.push_back(links.size());
+}
+
+uint32_t
+GlobalRouteManagerImpl::LSDBSnapshot::GetNumber(const GlobalRoutingLSA* lsa) const
+{
+    auto i = numbers.find(lsa);
+    NS_ASSERT_MSG(i != numbers.end(), "LSA not in the snapshot of the LSDB");
+    return i->second;
 }
 
 // ---------------------------------------------------------------------------
@@ -543,7 +716,7 @@ GlobalRouteManagerLSDB::GetLSAByLinkData(Ipv4Address addr) const
 // ---------------------------------------------------------------------------
 
 GlobalRouteManagerImpl::GlobalRouteManagerImpl()
-    : m_spfroot(nullptr)
+    : m_routesComputed(false)
 {
     NS_LOG_FUNCTION(this);
     m_lsdb = new GlobalRouteManagerLSDB();
@@ -576,25 +749,7 @@ GlobalRouteManagerImpl::DeleteGlobalRoutes()
     NodeList::Iterator listEnd = NodeList::End();
     for (NodeList::Iterator i = NodeList::Begin(); i != listEnd; i++)
     {
-        Ptr<Node> node = *i;
-        Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-        if (!router)
-        {
-            continue;
-        }
-        Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-        uint32_t j = 0;
-        uint32_t nRoutes = gr->GetNRoutes();
-        NS_LOG_LOGIC("Deleting " << gr->GetNRoutes() << " routes from node " << node->GetId());
-        // Each time we delete route 0, the route index shifts downward
-        // We can delete all routes if we delete the route numbered 0
-        // nRoutes times
-        for (j = 0; j < nRoutes; j++)
-        {
-            NS_LOG_LOGIC("Deleting global route " << j << " from node " << node->GetId());
-            gr->RemoveRoute(0);
-        }
-        NS_LOG_LOGIC("Deleted " << j << " global routes from node " << node->GetId());
+        DeleteNodeRoutes(*i);
     }
     if (m_lsdb)
     {
@@ -602,6 +757,32 @@ GlobalRouteManagerImpl::DeleteGlobalRoutes()
         delete m_lsdb;
         m_lsdb = new GlobalRouteManagerLSDB();
     }
+    m_spfCalculations.clear();
+    m_routesComputed = false;
+}
+
+void
+GlobalRouteManagerImpl::DeleteNodeRoutes(Ptr<Node> node) const
+{
+    NS_LOG_FUNCTION(this << node);
+    Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
+    if (!router)
+    {
+        return;
+    }
+    Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
+    uint32_t j = 0;
+    uint32_t nRoutes = gr->GetNRoutes();
+    NS_LOG_LOGIC("Deleting " << gr->GetNRoutes() << " routes from node " << node->GetId());
+    // Each time we delete route 0, the route index shifts downward
+    // We can delete all routes if we delete the route numbered 0
+    // nRoutes times
+    for (j = 0; j < nRoutes; j++)
+    {
+        NS_LOG_LOGIC("Deleting global route " << j << " from node " << node->GetId());
+        gr->RemoveRoute(0);
+    }
+    NS_LOG_LOGIC("Deleted " << j << " global routes from node " << node->GetId());
 }
 
 //
@@ -696,6 +877,11 @@ GlobalRouteManagerImpl::BuildGlobalRoutingDatabase()
 // algorithm then iterates again.  It terminates when the candidate
 // list becomes empty.
 //
+// The calculations of the different roots are independent: each of them
+// has its own candidate queue and LSA status, and only reads the LSDB,
+// so they are run on a pool of threads, and the routes they find are then
+// written in the forwarding tables by this thread.
+//
 void
 GlobalRouteManagerImpl::InitializeRoutes()
 {
@@ -704,6 +890,7 @@ GlobalRouteManagerImpl::InitializeRoutes()
     // Walk the list of nodes in the system.
     //
     NS_LOG_INFO("About to start SPF calculation");
+    std::vector<SPFCalculation> calcs;
     NodeList::Iterator listEnd = NodeList::End();
     for (NodeList::Iterator i = NodeList::Begin(); i != listEnd; i++)
     {
@@ -727,12 +914,248 @@ GlobalRouteManagerImpl::InitializeRoutes()
         //
         if (rtr && rtr->GetNumLSAs())
         {
-            SPFCalculate(rtr->GetRouterId());
+            calcs.push_back(PrepareSPFCalculation(rtr->GetRouterId(), node));
         }
     }
+    RunSPFCalculations(calcs);
+    m_spfCalculations.clear();
+    for (auto& calc : calcs)
+    {
+        uint32_t nodeId = calc.node->GetId();
+        calc.node = nullptr;
+        m_spfCalculations[nodeId] = std::move(calc);
+    }
+    m_routesComputed = true;
     NS_LOG_INFO("Finished SPF calculation");
 }
 
+//
+// An SPF calculation only depends on the LSAs of the vertices of its tree, on
+// the LSAs found by link data from the network vertices of its tree, on the AS
+// external LSAs and on the addresses of the interfaces of its root: a change
+// elsewhere cannot reach the root, since the vertex linking it to the tree
+// would have changed too.  Hence only the calculations depending on a changed
+// LSA are run again.
+//
+void
+GlobalRouteManagerImpl::UpdateRoutes()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_routesComputed)
+    {
+        DeleteGlobalRoutes();
+        BuildGlobalRoutingDatabase();
+        InitializeRoutes();
+        return;
+    }
+    //
+    // Build the new LSDB, and find the LSAs that changed.
+    //
+    GlobalRouteManagerLSDB* oldLsdb = m_lsdb;
+    m_lsdb = new GlobalRouteManagerLSDB();
+    BuildGlobalRoutingDatabase();
+
+    std::set<Ipv4Address> changedLsas;
+    std::set<Ipv4Address> changedLinkData;
+    for (GlobalRoutingLSA* lsa : oldLsdb->GetLSAs())
+    {
+        GlobalRoutingLSA* newLsa = m_lsdb->GetLSA(lsa->GetLinkStateId());
+        if (!newLsa || !IsSameLSA(lsa, newLsa))
+        {
+            changedLsas.insert(lsa->GetLinkStateId());
+            AddTransitLinkData(lsa, changedLinkData);
+        }
+    }
+    for (GlobalRoutingLSA* lsa : m_lsdb->GetLSAs())
+    {
+        GlobalRoutingLSA* oldLsa = oldLsdb->GetLSA(lsa->GetLinkStateId());
+        if (!oldLsa || !IsSameLSA(lsa, oldLsa))
+        {
+            changedLsas.insert(lsa->GetLinkStateId());
+            AddTransitLinkData(lsa, changedLinkData);
+        }
+    }
+    bool externalsChanged = oldLsdb->GetNumExtLSAs() != m_lsdb->GetNumExtLSAs();
+    for (uint32_t i = 0; !externalsChanged && i < m_lsdb->GetNumExtLSAs(); i++)
+    {
+        externalsChanged = !IsSameLSA(oldLsdb->GetExtLSA(i), m_lsdb->GetExtLSA(i));
+    }
+    delete oldLsdb;
+    NS_LOG_LOGIC(changedLsas.size() << " LSAs changed, AS external LSAs changed: "
+                                    << externalsChanged);
+    //
+    // Walk the list of nodes in the system, and prepare the calculations of
+    // the routers depending on a change.
+    //
+    std::vector<SPFCalculation> calcs;
+    std::map<uint32_t, SPFCalculation> spfCalculations;
+    NodeList::Iterator listEnd = NodeList::End();
+    for (NodeList::Iterator i = NodeList::Begin(); i != listEnd; i++)
+    {
+        Ptr<Node> node = *i;
+        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
+
+        uint32_t systemId = Simulator::GetSystemId();
+        // Ignore nodes that are not assigned to our systemId (distributed sim)
+        if (node->GetSystemId() != systemId)
+        {
+            continue;
+        }
+
+        auto previous = m_spfCalculations.find(node->GetId());
+        if (!rtr || !rtr->GetNumLSAs())
+        {
+            if (previous != m_spfCalculations.end())
+            {
+                DeleteNodeRoutes(node);
+            }
+            continue;
+        }
+        SPFCalculation calc = PrepareSPFCalculation(rtr->GetRouterId(), node);
+        if (previous != m_spfCalculations.end())
+        {
+            const SPFCalculation& prev = previous->second;
+            if (!externalsChanged && prev.root == calc.root && prev.interfaces == calc.interfaces &&
+                !Intersects(prev.lsas, changedLsas) && !Intersects(prev.linkData, changedLinkData))
+            {
+                NS_LOG_LOGIC("Keeping the routes of node " << node->GetId());
+                spfCalculations[node->GetId()] = std::move(previous->second);
+                continue;
+            }
+            DeleteNodeRoutes(node);
+        }
+        NS_LOG_LOGIC("Recomputing the routes of node " << node->GetId());
+        calcs.push_back(std::move(calc));
+    }
+    NS_LOG_INFO("About to start SPF calculation for " << calcs.size() << " routers");
+    RunSPFCalculations(calcs);
+    for (auto& calc : calcs)
+    {
+        uint32_t nodeId = calc.node->GetId();
+        calc.node = nullptr;
+        spfCalculations[nodeId] = std::move(calc);
+    }
+    m_spfCalculations = std::move(spfCalculations);
+    NS_LOG_INFO("Finished SPF calculation");
+}
+
+GlobalRouteManagerImpl::SPFCalculation
+GlobalRouteManagerImpl::PrepareSPFCalculation(Ipv4Address root, Ptr<Node> node) const
+{
+    NS_LOG_FUNCTION(this << root << node);
+    SPFCalculation calc;
+    calc.root = root;
+    calc.node = node;
+    calc.spfroot = nullptr;
+    if (node)
+    {
+        //
+        // This is the node we're building the routing table for.  Since this
+        // node is participating in routing IP version 4 packets, it certainly
+        // must have an Ipv4 interface.
+        //
+        Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+        NS_ASSERT_MSG(ipv4,
+                      "GlobalRouteManagerImpl::PrepareSPFCalculation (): "
+                      "GetObject for <Ipv4> interface failed");
+        for (uint32_t i = 0; i < ipv4->GetNInterfaces(); i++)
+        {
+            for (uint32_t j = 0; j < ipv4->GetNAddresses(i); j++)
+            {
+                calc.interfaces.emplace_back(ipv4->GetAddress(i, j).GetLocal(), i);
+            }
+        }
+    }
+    return calc;
+}
+
+void
+GlobalRouteManagerImpl::RunSPFCalculations(std::vector<SPFCalculation>& calcs) const
+{
+    NS_LOG_FUNCTION(this << calcs.size());
+    LSDBSnapshot snapshot(*m_lsdb);
+
+    UintegerValue spfThreads;
+    g_spfThreads.GetValue(spfThreads);
+    std::size_t nThreads = spfThreads.Get();
+    if (nThreads == 0)
+    {
+        nThreads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    nThreads = std::min(nThreads, calcs.size());
+
+    if (nThreads <= 1)
+    {
+        for (auto& calc : calcs)
+        {
+            SPFCalculate(calc, snapshot);
+        }
+    }
+    else
+    {
+        NS_LOG_INFO("Running " << calcs.size() << " SPF calculations on " << nThreads
+                               << " threads");
+        // each thread takes the next calculation not started yet
+        std::atomic<std::size_t> next(0);
+        auto worker = [this, &calcs, &snapshot, &next]() {
+            for (std::size_t i = next++; i < calcs.size(); i = next++)
+            {
+                SPFCalculate(calcs[i], snapshot);
+            }
+        };
+        std::vector<std::thread> threads;
+        for (std::size_t i = 1; i < nThreads; i++)
+        {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    for (auto& calc : calcs)
+    {
+        InstallRoutes(calc);
+        // only the dependencies are needed once the routes are written
+        calc.routes.clear();
+        calc.routes.shrink_to_fit();
+    }
+}
+
+void
+GlobalRouteManagerImpl::InstallRoutes(const SPFCalculation& calc) const
+{
+    NS_LOG_FUNCTION(this << calc.root);
+    if (!calc.node)
+    {
+        return;
+    }
+    Ptr<GlobalRouter> router = calc.node->GetObject<GlobalRouter>();
+    if (!router)
+    {
+        return;
+    }
+    Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
+    NS_ASSERT(gr);
+    for (const auto& route : calc.routes)
+    {
+        switch (route.type)
+        {
+        case SPFRoute::HOST:
+            gr->AddHostRouteTo(route.dest, route.nextHop, route.outIf);
+            break;
+        case SPFRoute::NETWORK:
+            gr->AddNetworkRouteTo(route.dest, route.mask, route.nextHop, route.outIf);
+            break;
+        case SPFRoute::EXTERNAL:
+            gr->AddASExternalRouteTo(route.dest, route.mask, route.nextHop, route.outIf);
+            break;
+        }
+    }
+}
+
 //
 // This method is derived from quagga ospf_spf_next ().  See RFC2328 Section
 // 16.1 (2) for further details.
@@ -747,7 +1170,10 @@ GlobalRouteManagerImpl::InitializeRoutes()
 // vertex already on the candidate list, store the new (lower) cost.
 //
 void
-GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
+GlobalRouteManagerImpl::SPFNext(SPFVertex* v,
+                                CandidateQueue& candidate,
+                                const LSDBSnapshot& snapshot,
+                                SPFCalculation& calc) const
 {
     NS_LOG_FUNCTION(this << v << &candidate);
 
@@ -755,59 +1181,39 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
     GlobalRoutingLSA* w_lsa = nullptr;
     GlobalRoutingLinkRecord* l = nullptr;
     uint32_t distance = 0;
-    uint32_t numRecordsInVertex = 0;
     //
     // V points to a Router-LSA or Network-LSA
     // Loop over the links in router LSA or attached routers in Network LSA
     //
-    if (v->GetVertexType() == SPFVertex::VertexRouter)
-    {
-        numRecordsInVertex = v->GetLSA()->GetNLinkRecords();
-    }
-    if (v->GetVertexType() == SPFVertex::VertexNetwork)
-    {
-        numRecordsInVertex = v->GetLSA()->GetNAttachedRouters();
-    }
-
-    for (uint32_t i = 0; i < numRecordsInVertex; i++)
+    // The snapshot of the LSDB holds the vertices reached through the transit
+    // links of a Router-LSA, and through the attached routers of a Network-LSA
+    // found by link data.  Links to stub networks are not in the snapshot:
+    // they will be considered in the second stage of the shortest path
+    // calculation.
+    //
+    uint32_t vNumber = snapshot.GetNumber(v->GetLSA());
+    for (uint32_t i = snapshot.firstLink[vNumber]; i < snapshot.firstLink[vNumber + 1]; i++)
     {
+        const LSDBSnapshot::Link& link = snapshot.links[i];
+        NS_ASSERT(link.lsa != LSDBSnapshot::NO_LSA);
+        w_lsa = snapshot.lsas[link.lsa];
         // Get w_lsa:  In case of V is Router-LSA
         if (v->GetVertexType() == SPFVertex::VertexRouter)
         {
-            NS_LOG_LOGIC("Examining link " << i << " of " << v->GetVertexId() << "'s "
-                                           << v->GetLSA()->GetNLinkRecords() << " link records");
             //
-            // (a) If this is a link to a stub network, examine the next link in V's LSA.
-            // Links to stub networks will be considered in the second stage of the
-            // shortest path calculation.
-            //
-            l = v->GetLSA()->GetLinkRecord(i);
-            NS_ASSERT(l != nullptr);
-            if (l->GetLinkType() == GlobalRoutingLinkRecord::StubNetwork)
-            {
-                NS_LOG_LOGIC("Found a Stub record to " << l->GetLinkId());
-                continue;
-            }
-            //
-            // (b) Otherwise, W is a transit vertex (router or transit network).  Look up
-            // the vertex W's LSA (router-LSA or network-LSA) in Area A's link state
+            // (b) W is a transit vertex (router or transit network), whose LSA
+            // (router-LSA or network-LSA) was looked up in Area A's link state
             // database.
             //
+            l = link.record;
+            NS_ASSERT(l != nullptr);
             if (l->GetLinkType() == GlobalRoutingLinkRecord::PointToPoint)
             {
-                //
-                // Lookup the link state advertisement of the new link -- we call it <w> in
-                // the link state database.
-                //
-                w_lsa = m_lsdb->GetLSA(l->GetLinkId());
-                NS_ASSERT(w_lsa);
                 NS_LOG_LOGIC("Found a P2P record from " << v->GetVertexId() << " to "
                                                         << w_lsa->GetLinkStateId());
             }
             else if (l->GetLinkType() == GlobalRoutingLinkRecord::TransitNetwork)
             {
-                w_lsa = m_lsdb->GetLSA(l->GetLinkId());
-                NS_ASSERT(w_lsa);
                 NS_LOG_LOGIC("Found a Transit record from " << v->GetVertexId() << " to "
                                                             << w_lsa->GetLinkStateId());
             }
@@ -819,11 +1225,6 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
         // Get w_lsa:  In case of V is Network-LSA
         if (v->GetVertexType() == SPFVertex::VertexNetwork)
         {
-            w_lsa = m_lsdb->GetLSAByLinkData(v->GetLSA()->GetAttachedRouter(i));
-            if (!w_lsa)
-            {
-                continue;
-            }
             NS_LOG_LOGIC("Found a Network LSA from " << v->GetVertexId() << " to "
                                                      << w_lsa->GetLinkStateId());
         }
@@ -836,7 +1237,7 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
         // If the link is to a router that is already in the shortest path first tree
         // then we have it covered -- ignore it.
         //
-        if (w_lsa->GetStatus() == GlobalRoutingLSA::LSA_SPF_IN_SPFTREE)
+        if (calc.status[link.lsa] == GlobalRoutingLSA::LSA_SPF_IN_SPFTREE)
         {
             NS_LOG_LOGIC("Skipping ->  LSA " << w_lsa->GetLinkStateId() << " already in SPF tree");
             continue;
@@ -860,7 +1261,7 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
         NS_LOG_LOGIC("Considering w_lsa " << w_lsa->GetLinkStateId());
 
         // Is there already vertex w in candidate list?
-        if (w_lsa->GetStatus() == GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED)
+        if (calc.status[link.lsa] == GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED)
         {
             // Calculate nexthop to w
             // We need to figure out how to actually get to the new router represented
@@ -870,9 +1271,9 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
 
             // prepare vertex w
             w = new SPFVertex(w_lsa);
-            if (SPFNexthopCalculation(v, w, l, distance))
+            if (SPFNexthopCalculation(v, w, l, distance, calc))
             {
-                w_lsa->SetStatus(GlobalRoutingLSA::LSA_SPF_CANDIDATE);
+                calc.status[link.lsa] = GlobalRoutingLSA::LSA_SPF_CANDIDATE;
                 //
                 // Push this new vertex onto the priority queue (ordered by distance from the
                 // root node).
@@ -889,7 +1290,7 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
                                   << "return false, but it does now!");
             }
         }
-        else if (w_lsa->GetStatus() == GlobalRoutingLSA::LSA_SPF_CANDIDATE)
+        else if (calc.status[link.lsa] == GlobalRoutingLSA::LSA_SPF_CANDIDATE)
         {
             //
             // We have already considered the link represented by <w>.  What wse have to
@@ -936,7 +1337,7 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
 
                 // prepare vertex w
                 w = new SPFVertex(w_lsa);
-                SPFNexthopCalculation(v, w, l, distance);
+                SPFNexthopCalculation(v, w, l, distance, calc);
                 cw->MergeRootExitDirections(w);
                 cw->MergeParent(w);
                 // SPFVertexAddParent (w) is necessary as the destructor of
@@ -955,7 +1356,7 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
                 // N.B. the nexthop_calculation is conditional, if it finds a valid nexthop
                 // it will call spf_add_parents, which will flush the old parents
                 //
-                if (SPFNexthopCalculation(v, cw, l, distance))
+                if (SPFNexthopCalculation(v, cw, l, distance, calc))
                 {
                     //
                     // If we've changed the cost to get to the vertex represented by <w>, we
@@ -982,7 +1383,8 @@ int
 GlobalRouteManagerImpl::SPFNexthopCalculation(SPFVertex* v,
                                               SPFVertex* w,
                                               GlobalRoutingLinkRecord* l,
-                                              uint32_t distance)
+                                              uint32_t distance,
+                                              const SPFCalculation& calc) const
 {
     NS_LOG_FUNCTION(this << v << w << l << distance);
     //
@@ -995,7 +1397,7 @@ GlobalRouteManagerImpl::SPFNexthopCalculation(SPFVertex* v,
     */
 
     //
-    // The vertex m_spfroot is a distinguished vertex representing the node at
+    // The vertex calc.spfroot is a distinguished vertex representing the node at
     // the root of the calculations.  That is, it is the node for which we are
     // calculating the routes.
     //
@@ -1017,7 +1419,7 @@ GlobalRouteManagerImpl::SPFNexthopCalculation(SPFVertex* v,
     // The point-to-point link information is only useful in this calculation when
     // we are examining the root node.
     //
-    if (v == m_spfroot)
+    if (v == calc.spfroot)
     {
         //
         // In this case <v> is the root node, which means it is the starting point
@@ -1062,7 +1464,7 @@ GlobalRouteManagerImpl::SPFNexthopCalculation(SPFVertex* v,
             // from the perspective of <v> -- remember that <l> is the link "from"
             // <v> "to" <w>.
             //
-            uint32_t outIf = FindOutgoingInterfaceId(l->GetLinkData());
+            uint32_t outIf = FindOutgoingInterfaceId(l->GetLinkData(), Ipv4Mask::GetOnes(), calc);
 
             w->SetRootExitDirection(nextHop, outIf);
             w->SetDistanceFromRoot(distance);
@@ -1079,8 +1481,9 @@ GlobalRouteManagerImpl::SPFNexthopCalculation(SPFVertex* v,
             GlobalRoutingLSA* w_lsa = w->GetLSA();
             NS_ASSERT(w_lsa->GetLSType() == GlobalRoutingLSA::NetworkLSA);
             // Find outgoing interface ID for this network
-            uint32_t outIf =
-                FindOutgoingInterfaceId(w_lsa->GetLinkStateId(), w_lsa->GetNetworkLSANetworkMask());
+            uint32_t outIf = FindOutgoingInterfaceId(w_lsa->GetLinkStateId(),
+                                                     w_lsa->GetNetworkLSANetworkMask(),
+                                                     calc);
             // Set the next hop to 0.0.0.0 meaning "not exist"
             Ipv4Address nextHop = Ipv4Address::GetZero();
             w->SetRootExitDirection(nextHop, outIf);
@@ -1095,7 +1498,7 @@ GlobalRouteManagerImpl::SPFNexthopCalculation(SPFVertex* v,
     else if (v->GetVertexType() == SPFVertex::VertexNetwork)
     {
         // See if any of v's parents are the root
-        if (v->GetParent() == m_spfroot)
+        if (v->GetParent() == calc.spfroot)
         {
             // 16.1.1 para 5. ...the parent vertex is a network that
             // directly connects the calculating router to the destination
@@ -1165,7 +1568,7 @@ GlobalRouteManagerImpl::SPFNexthopCalculation(SPFVertex* v,
 GlobalRoutingLinkRecord*
 GlobalRouteManagerImpl::SPFGetNextLink(SPFVertex* v,
                                        SPFVertex* w,
-                                       GlobalRoutingLinkRecord* prev_link)
+                                       GlobalRoutingLinkRecord* prev_link) const
 {
     NS_LOG_FUNCTION(this << v << w << prev_link);
 
@@ -1243,7 +1646,9 @@ void
 GlobalRouteManagerImpl::DebugSPFCalculate(Ipv4Address root)
 {
     NS_LOG_FUNCTION(this << root);
-    SPFCalculate(root);
+    std::vector<SPFCalculation> calcs;
+    calcs.push_back(PrepareSPFCalculation(root, FindRouterNode(root)));
+    RunSPFCalculations(calcs);
 }
 
 //
@@ -1253,8 +1658,9 @@ GlobalRouteManagerImpl::DebugSPFCalculate(Ipv4Address root)
 // to be run
 //
 bool
-GlobalRouteManagerImpl::CheckForStubNode(Ipv4Address root)
+GlobalRouteManagerImpl::CheckForStubNode(SPFCalculation& calc) const
 {
+    Ipv4Address root = calc.root;
     NS_LOG_FUNCTION(this << root);
     GlobalRoutingLSA* rlsa = m_lsdb->GetLSA(root);
     Ipv4Address myRouterId = rlsa->GetLinkStateId();
@@ -1301,6 +1707,7 @@ GlobalRouteManagerImpl::CheckForStubNode(Ipv4Address root)
             // The link record LinkID is the router ID of the peer.
             // The Link Data is the local IP interface address
             GlobalRoutingLSA* w_lsa = m_lsdb->GetLSA(transitLink->GetLinkId());
+            calc.lsas.insert(w_lsa->GetLinkStateId());
             uint32_t nLinkRecords = w_lsa->GetNLinkRecords();
             for (uint32_t j = 0; j < nLinkRecords; ++j)
             {
@@ -1316,18 +1723,17 @@ GlobalRouteManagerImpl::CheckForStubNode(Ipv4Address root)
                 if (lr->GetLinkId() == myRouterId)
                 {
                     // Next hop is stored in the LinkID field of lr
-                    Ptr<GlobalRouter> router = rlsa->GetNode()->GetObject<GlobalRouter>();
-                    NS_ASSERT(router);
-                    Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-                    NS_ASSERT(gr);
-                    gr->AddNetworkRouteTo(Ipv4Address("0.0.0.0"),
-                                          Ipv4Mask("0.0.0.0"),
-                                          lr->GetLinkData(),
-                                          FindOutgoingInterfaceId(transitLink->GetLinkData()));
+                    int32_t outIf = FindOutgoingInterfaceId(transitLink->GetLinkData(),
+                                                            Ipv4Mask::GetOnes(),
+                                                            calc);
+                    calc.routes.push_back({SPFRoute::NETWORK,
+                                           Ipv4Address("0.0.0.0"),
+                                           Ipv4Mask("0.0.0.0"),
+                                           lr->GetLinkData(),
+                                           static_cast<uint32_t>(outIf)});
                     NS_LOG_LOGIC("Inserting default route for node "
                                  << myRouterId << " to next hop " << lr->GetLinkData()
-                                 << " via interface "
-                                 << FindOutgoingInterfaceId(transitLink->GetLinkData()));
+                                 << " via interface " << outIf);
                     return true;
                 }
             }
@@ -1336,17 +1742,42 @@ GlobalRouteManagerImpl::CheckForStubNode(Ipv4Address root)
     return false;
 }
 
+Ptr<Node>
+GlobalRouteManagerImpl::FindRouterNode(Ipv4Address routerId) const
+{
+    NS_LOG_FUNCTION(this << routerId);
+    //
+    // The router ID is accessible through the GlobalRouter interface, so we need
+    // to QI for that interface.  If there's no GlobalRouter interface, the node
+    // in question cannot be the router we want, so we continue.
+    //
+    NodeList::Iterator listEnd = NodeList::End();
+    for (NodeList::Iterator i = NodeList::Begin(); i != listEnd; i++)
+    {
+        Ptr<Node> node = *i;
+        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
+        if (rtr && rtr->GetRouterId() == routerId)
+        {
+            return node;
+        }
+    }
+    return nullptr;
+}
+
 // quagga ospf_spf_calculate
 void
-GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
+GlobalRouteManagerImpl::SPFCalculate(SPFCalculation& calc, const LSDBSnapshot& snapshot) const
 {
+    Ipv4Address root = calc.root;
     NS_LOG_FUNCTION(this << root);
 
     SPFVertex* v;
     //
-    // Initialize the Link State Database.
+    // Initialize the status of the LSAs.  The status is kept in the calculation,
+    // so that the calculations of different roots share the snapshot of the
+    // Link State Database.
     //
-    m_lsdb->Initialize();
+    calc.status.assign(snapshot.lsas.size(), GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED);
     //
     // The candidate queue is a priority queue of SPFVertex objects, with the top
     // of the queue being the closest vertex in terms of distance from the root
@@ -1364,9 +1795,12 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
     // This vertex is the root of the SPF tree and it is distance 0 from the root.
     // We also mark this vertex as being in the SPF tree.
     //
-    m_spfroot = v;
+    calc.spfroot = v;
     v->SetDistanceFromRoot(0);
-    v->GetLSA()->SetStatus(GlobalRoutingLSA::LSA_SPF_IN_SPFTREE);
+    calc.status[snapshot.GetNumber(v->GetLSA())] = GlobalRoutingLSA::LSA_SPF_IN_SPFTREE;
+    calc.lsas.clear();
+    calc.linkData.clear();
+    calc.lsas.insert(root);
     NS_LOG_LOGIC("Starting SPFCalculate for node " << root);
 
     //
@@ -1374,12 +1808,16 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
     // We do not need to calculate SPF for every node in the network if this
     // node has only one interface through which another router can be
     // reached.  Instead, short-circuit this computation and just install
-    // a default route in the CheckForStubNode() method.
+    // a default route in the CheckForStubNode() method.  The unit tests
+    // calculate routes without nodes, hence without interfaces.
     //
-    if (NodeList::GetNNodes() > 0 && CheckForStubNode(root))
+    if (calc.node && CheckForStubNode(calc))
     {
         NS_LOG_LOGIC("SPFCalculate truncated for stub node " << root);
-        delete m_spfroot;
+        delete calc.spfroot;
+        calc.spfroot = nullptr;
+        calc.status.clear();
+        calc.status.shrink_to_fit();
         return;
     }
 
@@ -1399,7 +1837,7 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
         // shortest path).  If the new vertices represent shorter paths, we use them
         // and update the path cost.
         //
-        SPFNext(v, candidate);
+        SPFNext(v, candidate, snapshot, calc);
         //
         // RFC2328 16.1. (3).
         //
@@ -1427,7 +1865,16 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
         // Update the status field of the vertex to indicate that it is in the SPF
         // tree.
         //
-        v->GetLSA()->SetStatus(GlobalRoutingLSA::LSA_SPF_IN_SPFTREE);
+        calc.status[snapshot.GetNumber(v->GetLSA())] = GlobalRoutingLSA::LSA_SPF_IN_SPFTREE;
+        //
+        // The routes of the root depend on the LSA of the vertex, and on the
+        // LSAs found by link data from a network vertex.
+        //
+        calc.lsas.insert(v->GetVertexId());
+        for (uint32_t i = 0; i < v->GetLSA()->GetNAttachedRouters(); i++)
+        {
+            calc.linkData.insert(v->GetLSA()->GetAttachedRouter(i));
+        }
         //
         // The current vertex has a parent pointer.  By calling this rather oddly
         // named method (blame quagga) we add the current vertex to the list of
@@ -1466,11 +1913,11 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
         //
         if (v->GetVertexType() == SPFVertex::VertexRouter)
         {
-            SPFIntraAddRouter(v);
+            SPFIntraAddRouter(v, calc);
         }
         else if (v->GetVertexType() == SPFVertex::VertexNetwork)
         {
-            SPFIntraAddTransit(v);
+            SPFIntraAddTransit(v, calc);
         }
         else
         {
@@ -1485,13 +1932,13 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
     } // end for loop
 
     // Second stage of SPF calculation procedure
-    SPFProcessStubs(m_spfroot);
+    SPFProcessStubs(calc.spfroot, calc);
     for (uint32_t i = 0; i < m_lsdb->GetNumExtLSAs(); i++)
     {
-        m_spfroot->ClearVertexProcessed();
+        calc.spfroot->ClearVertexProcessed();
         GlobalRoutingLSA* extlsa = m_lsdb->GetExtLSA(i);
         NS_LOG_LOGIC("Processing External LSA with id " << extlsa->GetLinkStateId());
-        ProcessASExternals(m_spfroot, extlsa);
+        ProcessASExternals(calc.spfroot, extlsa, calc);
     }
 
     //
@@ -1499,12 +1946,16 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
     // the SPF tree.  Delete all of the vertices and corresponding resources.  Go
     // possibly do it again for the next router.
     //
-    delete m_spfroot;
-    m_spfroot = nullptr;
+    delete calc.spfroot;
+    calc.spfroot = nullptr;
+    calc.status.clear();
+    calc.status.shrink_to_fit();
 }
 
 void
-GlobalRouteManagerImpl::ProcessASExternals(SPFVertex* v, GlobalRoutingLSA* extlsa)
+GlobalRouteManagerImpl::ProcessASExternals(SPFVertex* v,
+                                           GlobalRoutingLSA* extlsa,
+                                           SPFCalculation& calc) const
 {
     NS_LOG_FUNCTION(this << v << extlsa);
     NS_LOG_LOGIC("Processing external for destination "
@@ -1517,7 +1968,7 @@ GlobalRouteManagerImpl::ProcessASExternals(SPFVertex* v, GlobalRoutingLSA* extls
         if ((rlsa->GetLinkStateId()) == (extlsa->GetAdvertisingRouter()))
         {
             NS_LOG_LOGIC("Found advertising router to destination");
-            SPFAddASExternal(extlsa, v);
+            SPFAddASExternal(extlsa, v, calc);
         }
     }
     for (uint32_t i = 0; i < v->GetNChildren(); i++)
@@ -1525,7 +1976,7 @@ GlobalRouteManagerImpl::ProcessASExternals(SPFVertex* v, GlobalRoutingLSA* extls
         if (!v->GetChild(i)->IsVertexProcessed())
         {
             NS_LOG_LOGIC("Vertex's child " << i << " not yet processed, processing...");
-            ProcessASExternals(v->GetChild(i), extlsa);
+            ProcessASExternals(v->GetChild(i), extlsa, calc);
             v->GetChild(i)->SetVertexProcessed(true);
         }
     }
@@ -1537,15 +1988,18 @@ GlobalRouteManagerImpl::ProcessASExternals(SPFVertex* v, GlobalRoutingLSA* extls
 //
 
 void
-GlobalRouteManagerImpl::SPFAddASExternal(GlobalRoutingLSA* extlsa, SPFVertex* v)
+GlobalRouteManagerImpl::SPFAddASExternal(GlobalRoutingLSA* extlsa,
+                                         SPFVertex* v,
+                                         SPFCalculation& calc) const
 {
     NS_LOG_FUNCTION(this << extlsa << v);
 
-    NS_ASSERT_MSG(m_spfroot, "GlobalRouteManagerImpl::SPFAddASExternal (): Root pointer not set");
+    NS_ASSERT_MSG(calc.spfroot,
+                  "GlobalRouteManagerImpl::SPFAddASExternal (): Root pointer not set");
     // Two cases to consider: We are advertising the external ourselves
     // => No need to add anything
     // OR find best path to the advertising router
-    if (v->GetVertexId() == m_spfroot->GetVertexId())
+    if (v->GetVertexId() == calc.spfroot->GetVertexId())
     {
         NS_LOG_LOGIC("External is on local host: " << v->GetVertexId() << "; returning");
         return;
@@ -1553,116 +2007,73 @@ GlobalRouteManagerImpl::SPFAddASExternal(GlobalRoutingLSA* extlsa, SPFVertex* v)
     NS_LOG_LOGIC("External is on remote host: " << extlsa->GetAdvertisingRouter()
                                                 << "; installing");
 
-    Ipv4Address routerId = m_spfroot->GetVertexId();
+    Ipv4Address routerId = calc.spfroot->GetVertexId();
 
     NS_LOG_LOGIC("Vertex ID = " << routerId);
+    const Ptr<Node>& node = calc.node;
+    if (!node)
+    {
+        NS_LOG_LOGIC("Can't find root node " << routerId);
+        return;
+    }
+    NS_LOG_LOGIC("Setting routes for node " << node->GetId());
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // Get the Global Router Link State Advertisement from the vertex we're
+    // adding the routes to.  The LSA will have a number of attached Global Router
+    // Link Records corresponding to links off of that vertex / node.  We're going
+    // to be interested in the records corresponding to point-to-point links.
     //
-    NodeList::Iterator i = NodeList::Begin();
-    NodeList::Iterator listEnd = NodeList::End();
-    for (; i != listEnd; i++)
-    {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to QI for that interface.  If there's no GlobalRouter interface, the node
-        // in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
+    NS_ASSERT_MSG(v->GetLSA(),
+                  "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                  "Expected valid LSA in SPFVertex* v");
+    Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask();
+    Ipv4Address tempip = extlsa->GetLinkStateId();
+    tempip = tempip.CombineMask(tempmask);
 
-        if (!rtr)
+    //
+    // Here's why we did all of that work.  We're going to add a host route to the
+    // host address found in the m_linkData field of the point-to-point link
+    // record.  In the case of a point-to-point link, this is the local IP address
+    // of the node connected to the link.  Each of these point-to-point links
+    // will correspond to a local interface that has an IP address to which
+    // the node at the root of the SPF tree can send packets.  The vertex <v>
+    // (corresponding to the node that has these links and interfaces) has
+    // an m_nextHop address precalculated for us that is the address to which the
+    // root node should send packets to be forwarded to these IP addresses.
+    // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
+    // which the packets should be send for forwarding.
+    //
+    // walk through all next-hop-IPs and out-going-interfaces for reaching
+    // the stub network gateway 'v' from the root node
+    for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
+    {
+        SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
+        Ipv4Address nextHop = exit.first;
+        int32_t outIf = exit.second;
+        if (outIf >= 0)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
-            continue;
+            calc.routes.push_back(
+                {SPFRoute::EXTERNAL, tempip, tempmask, nextHop, static_cast<uint32_t>(outIf)});
+            NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
+                                   << " add external network route to " << tempip
+                                   << " using next hop " << nextHop << " via interface "
+                                   << outIf);
         }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
+        else
         {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to QI
-            // for that interface.  If the node is acting as an IP version 4 router, it
-            // should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "QI for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            NS_ASSERT_MSG(v->GetLSA(),
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask();
-            Ipv4Address tempip = extlsa->GetLinkStateId();
-            tempip = tempip.CombineMask(tempmask);
-
-            //
-            // Here's why we did all of that work.  We're going to add a host route to the
-            // host address found in the m_linkData field of the point-to-point link
-            // record.  In the case of a point-to-point link, this is the local IP address
-            // of the node connected to the link.  Each of these point-to-point links
-            // will correspond to a local interface that has an IP address to which
-            // the node at the root of the SPF tree can send packets.  The vertex <v>
-            // (corresponding to the node that has these links and interfaces) has
-            // an m_nextHop address precalculated for us that is the address to which the
-            // root node should send packets to be forwarded to these IP addresses.
-            // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-            // which the packets should be send for forwarding.
-            //
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
-            {
-                continue;
-            }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all next-hop-IPs and out-going-interfaces for reaching
-            // the stub network gateway 'v' from the root node
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-            {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-                if (outIf >= 0)
-                {
-                    gr->AddASExternalRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add external network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
-                {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative");
-                }
-            }
-            return;
-        } // if
-    }     // for
+            NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
+                                   << " NOT able to add network route to " << tempip
+                                   << " using next hop " << nextHop
+                                   << " since outgoing interface id is negative");
+        }
+    }
 }
 
 // Processing logic from RFC 2328, page 166 and quagga ospf_spf_process_stubs ()
 // stub link records will exist for point-to-point interfaces and for
 // broadcast interfaces for which no neighboring router can be found
 void
-GlobalRouteManagerImpl::SPFProcessStubs(SPFVertex* v)
+GlobalRouteManagerImpl::SPFProcessStubs(SPFVertex* v, SPFCalculation& calc) const
 {
     NS_LOG_FUNCTION(this << v);
     NS_LOG_LOGIC("Processing stubs for " << v->GetVertexId());
@@ -1678,7 +2089,7 @@ GlobalRouteManagerImpl::SPFProcessStubs(SPFVertex* v)
             if (l->GetLinkType() == GlobalRoutingLinkRecord::StubNetwork)
             {
                 NS_LOG_LOGIC("Found a Stub record to " << l->GetLinkId());
-                SPFIntraAddStub(l, v);
+                SPFIntraAddStub(l, v, calc);
                 continue;
             }
         }
@@ -1687,7 +2098,7 @@ GlobalRouteManagerImpl::SPFProcessStubs(SPFVertex* v)
     {
         if (!v->GetChild(i)->IsVertexProcessed())
         {
-            SPFProcessStubs(v->GetChild(i));
+            SPFProcessStubs(v->GetChild(i), calc);
             v->GetChild(i)->SetVertexProcessed(true);
         }
     }
@@ -1695,18 +2106,20 @@ GlobalRouteManagerImpl::SPFProcessStubs(SPFVertex* v)
 
 // RFC2328 16.1. second stage.
 void
-GlobalRouteManagerImpl::SPFIntraAddStub(GlobalRoutingLinkRecord* l, SPFVertex* v)
+GlobalRouteManagerImpl::SPFIntraAddStub(GlobalRoutingLinkRecord* l,
+                                        SPFVertex* v,
+                                        SPFCalculation& calc) const
 {
     NS_LOG_FUNCTION(this << l << v);
 
-    NS_ASSERT_MSG(m_spfroot, "GlobalRouteManagerImpl::SPFIntraAddStub (): Root pointer not set");
+    NS_ASSERT_MSG(calc.spfroot, "GlobalRouteManagerImpl::SPFIntraAddStub (): Root pointer not set");
 
     // XXX simplified logic for the moment.  There are two cases to consider:
     // 1) the stub network is on this router; do nothing for now
     //    (already handled above)
     // 2) the stub network is on a remote router, so I should use the
     // same next hop that I use to get to vertex v
-    if (v->GetVertexId() == m_spfroot->GetVertexId())
+    if (v->GetVertexId() == calc.spfroot->GetVertexId())
     {
         NS_LOG_LOGIC("Stub is on local host: " << v->GetVertexId() << "; returning");
         return;
@@ -1719,185 +2132,103 @@ GlobalRouteManagerImpl::SPFIntraAddStub(GlobalRoutingLinkRecord* l, SPFVertex* v
     // going to use this ID to discover which node it is that we're actually going
     // to update.
     //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
+    Ipv4Address routerId = calc.spfroot->GetVertexId();
 
     NS_LOG_LOGIC("Vertex ID = " << routerId);
+    const Ptr<Node>& node = calc.node;
+    if (!node)
+    {
+        NS_LOG_LOGIC("Can't find root node " << routerId);
+        return;
+    }
+    NS_LOG_LOGIC("Setting routes for node " << node->GetId());
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // Get the Global Router Link State Advertisement from the vertex we're
+    // adding the routes to.  The LSA will have a number of attached Global Router
+    // Link Records corresponding to links off of that vertex / node.  We're going
+    // to be interested in the records corresponding to point-to-point links.
+    //
+    NS_ASSERT_MSG(v->GetLSA(),
+                  "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                  "Expected valid LSA in SPFVertex* v");
+    Ipv4Mask tempmask(l->GetLinkData().Get());
+    Ipv4Address tempip = l->GetLinkId();
+    tempip = tempip.CombineMask(tempmask);
+    //
+    // Here's why we did all of that work.  We're going to add a host route to the
+    // host address found in the m_linkData field of the point-to-point link
+    // record.  In the case of a point-to-point link, this is the local IP address
+    // of the node connected to the link.  Each of these point-to-point links
+    // will correspond to a local interface that has an IP address to which
+    // the node at the root of the SPF tree can send packets.  The vertex <v>
+    // (corresponding to the node that has these links and interfaces) has
+    // an m_nextHop address precalculated for us that is the address to which the
+    // root node should send packets to be forwarded to these IP addresses.
+    // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
+    // which the packets should be send for forwarding.
     //
-    NodeList::Iterator i = NodeList::Begin();
-    NodeList::Iterator listEnd = NodeList::End();
-    for (; i != listEnd; i++)
-    {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to QI for that interface.  If there's no GlobalRouter interface, the node
-        // in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
 
-        if (!rtr)
+    // walk through all next-hop-IPs and out-going-interfaces for reaching
+    // the stub network gateway 'v' from the root node
+    for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
+    {
+        SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
+        Ipv4Address nextHop = exit.first;
+        int32_t outIf = exit.second;
+        if (outIf >= 0)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
-            continue;
+            calc.routes.push_back(
+                {SPFRoute::NETWORK, tempip, tempmask, nextHop, static_cast<uint32_t>(outIf)});
+            NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
+                                   << " add network route to " << tempip
+                                   << " using next hop " << nextHop << " via interface "
+                                   << outIf);
         }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
+        else
         {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to QI
-            // for that interface.  If the node is acting as an IP version 4 router, it
-            // should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "QI for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            NS_ASSERT_MSG(v->GetLSA(),
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask(l->GetLinkData().Get());
-            Ipv4Address tempip = l->GetLinkId();
-            tempip = tempip.CombineMask(tempmask);
-            //
-            // Here's why we did all of that work.  We're going to add a host route to the
-            // host address found in the m_linkData field of the point-to-point link
-            // record.  In the case of a point-to-point link, this is the local IP address
-            // of the node connected to the link.  Each of these point-to-point links
-            // will correspond to a local interface that has an IP address to which
-            // the node at the root of the SPF tree can send packets.  The vertex <v>
-            // (corresponding to the node that has these links and interfaces) has
-            // an m_nextHop address precalculated for us that is the address to which the
-            // root node should send packets to be forwarded to these IP addresses.
-            // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-            // which the packets should be send for forwarding.
-            //
-
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
-            {
-                continue;
-            }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all next-hop-IPs and out-going-interfaces for reaching
-            // the stub network gateway 'v' from the root node
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-            {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-                if (outIf >= 0)
-                {
-                    gr->AddNetworkRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
-                {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative");
-                }
-            }
-            return;
-        } // if
-    }     // for
+            NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
+                                   << " NOT able to add network route to " << tempip
+                                   << " using next hop " << nextHop
+                                   << " since outgoing interface id is negative");
+        }
+    }
 }
 
 //
 // Return the interface number corresponding to a given IP address and mask
-// This is a wrapper around GetInterfaceForPrefix(), but we first
-// have to find the right node pointer to pass to that function.
+// This is equivalent to GetInterfaceForPrefix() on the node at the root, but
+// the addresses of its interfaces were copied in the SPF calculation, so that
+// the calculation does not access the node.
 // If no such interface is found, return -1 (note:  unit test framework
 // for routing assumes -1 to be a legal return value)
 //
 int32_t
-GlobalRouteManagerImpl::FindOutgoingInterfaceId(Ipv4Address a, Ipv4Mask amask)
+GlobalRouteManagerImpl::FindOutgoingInterfaceId(Ipv4Address a,
+                                                Ipv4Mask amask,
+                                                const SPFCalculation& calc) const
 {
     NS_LOG_FUNCTION(this << a << amask);
     //
     // We have an IP address <a> and a vertex ID of the root of the SPF tree.
     // The question is what interface index does this address correspond to.
-    // The answer is a little complicated since we have to find a pointer to
-    // the node corresponding to the vertex ID, find the Ipv4 interface on that
-    // node in order to iterate the interfaces and find the one corresponding to
-    // the address in question.
     //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
+    if (!calc.node)
+    {
+        NS_LOG_LOGIC("FindOutgoingInterfaceId():Can't find root node " << calc.root);
+        return -1;
+    }
     //
-    // Walk the list of nodes in the system looking for the one corresponding to
-    // the node at the root of the SPF tree.  This is the node for which we are
-    // building the routing table.
+    // Look through the interfaces on this node for one that has the IP address
+    // we're looking for.  If we find one, return the corresponding interface
+    // index, or -1 if not found.
     //
-    NodeList::Iterator i = NodeList::Begin();
-    NodeList::Iterator listEnd = NodeList::End();
-    for (; i != listEnd; i++)
+    for (const auto& address : calc.interfaces)
     {
-        Ptr<Node> node = *i;
-
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-        //
-        // If the node doesn't have a GlobalRouter interface it can't be the one
-        // we're interested in.
-        //
-        if (!rtr)
-        {
-            continue;
-        }
-
-        if (rtr->GetRouterId() == routerId)
+        if (address.first.CombineMask(amask) == a.CombineMask(amask))
         {
-            //
-            // This is the node we're building the routing table for.  We're going to need
-            // the Ipv4 interface to look for the ipv4 interface index.  Since this node
-            // is participating in routing IP version 4 packets, it certainly must have
-            // an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::FindOutgoingInterfaceId (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Look through the interfaces on this node for one that has the IP address
-            // we're looking for.  If we find one, return the corresponding interface
-            // index, or -1 if not found.
-            //
-            int32_t interface = ipv4->GetInterfaceForPrefix(a, amask);
-
-#if 0
-          if (interface < 0)
-            {
-              NS_FATAL_ERROR ("GlobalRouteManagerImpl::FindOutgoingInterfaceId(): "
-                              "Expected an interface associated with address a:" << a);
-            }
-#endif
-            return interface;
+            return address.second;
         }
     }
-    //
-    // Couldn't find it.
-    //
-    NS_LOG_LOGIC("FindOutgoingInterfaceId():Can't find root node " << routerId);
     return -1;
 }
 
@@ -1918,11 +2249,12 @@ GlobalRouteManagerImpl::FindOutgoingInterfaceId(Ipv4Address a, Ipv4Mask amask)
 // route.
 //
 void
-GlobalRouteManagerImpl::SPFIntraAddRouter(SPFVertex* v)
+GlobalRouteManagerImpl::SPFIntraAddRouter(SPFVertex* v, SPFCalculation& calc) const
 {
     NS_LOG_FUNCTION(this << v);
 
-    NS_ASSERT_MSG(m_spfroot, "GlobalRouteManagerImpl::SPFIntraAddRouter (): Root pointer not set");
+    NS_ASSERT_MSG(calc.spfroot,
+                  "GlobalRouteManagerImpl::SPFIntraAddRouter (): Root pointer not set");
     //
     // The root of the Shortest Path First tree is the router to which we are
     // going to write the actual routing table entries.  The vertex corresponding
@@ -1930,143 +2262,105 @@ GlobalRouteManagerImpl::SPFIntraAddRouter(SPFVertex* v)
     // going to use this ID to discover which node it is that we're actually going
     // to update.
     //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
+    Ipv4Address routerId = calc.spfroot->GetVertexId();
 
     NS_LOG_LOGIC("Vertex ID = " << routerId);
+    const Ptr<Node>& node = calc.node;
+    if (!node)
+    {
+        NS_LOG_LOGIC("Can't find root node " << routerId);
+        return;
+    }
+    NS_LOG_LOGIC("Setting routes for node " << node->GetId());
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // Get the Global Router Link State Advertisement from the vertex we're
+    // adding the routes to.  The LSA will have a number of attached Global Router
+    // Link Records corresponding to links off of that vertex / node.  We're going
+    // to be interested in the records corresponding to point-to-point links.
     //
-    NodeList::Iterator i = NodeList::Begin();
-    NodeList::Iterator listEnd = NodeList::End();
-    for (; i != listEnd; i++)
+    GlobalRoutingLSA* lsa = v->GetLSA();
+    NS_ASSERT_MSG(lsa,
+                  "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                  "Expected valid LSA in SPFVertex* v");
+
+    uint32_t nLinkRecords = lsa->GetNLinkRecords();
+    //
+    // Iterate through the link records on the vertex to which we're going to add
+    // routes.  To make sure we're being clear, we're going to add routing table
+    // entries to the tables on the node corresping to the root of the SPF tree.
+    // These entries will have routes to the IP addresses we find from looking at
+    // the local side of the point-to-point links found on the node described by
+    // the vertex <v>.
+    //
+    NS_LOG_LOGIC(" Node " << node->GetId() << " found " << nLinkRecords
+                          << " link records in LSA " << lsa << "with LinkStateId "
+                          << lsa->GetLinkStateId());
+    for (uint32_t j = 0; j < nLinkRecords; ++j)
     {
-        Ptr<Node> node = *i;
         //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to GetObject for that interface.  If there's no GlobalRouter interface,
-        // the node in question cannot be the router we want, so we continue.
+        // We are only concerned about point-to-point links
         //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-
-        if (!rtr)
+        GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
+        if (lr->GetLinkType() != GlobalRoutingLinkRecord::PointToPoint)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
             continue;
         }
         //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
+        // Here's why we did all of that work.  We're going to add a host route to the
+        // host address found in the m_linkData field of the point-to-point link
+        // record.  In the case of a point-to-point link, this is the local IP address
+        // of the node connected to the link.  Each of these point-to-point links
+        // will correspond to a local interface that has an IP address to which
+        // the node at the root of the SPF tree can send packets.  The vertex <v>
+        // (corresponding to the node that has these links and interfaces) has
+        // an m_nextHop address precalculated for us that is the address to which the
+        // root node should send packets to be forwarded to these IP addresses.
+        // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
+        // which the packets should be send for forwarding.
         //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
+        // walk through all available exit directions due to ECMP,
+        // and add host route for each of the exit direction toward
+        // the vertex 'v'
+        for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
         {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to
-            // GetObject for that interface.  If the node is acting as an IP version 4
-            // router, it should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            GlobalRoutingLSA* lsa = v->GetLSA();
-            NS_ASSERT_MSG(lsa,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-
-            uint32_t nLinkRecords = lsa->GetNLinkRecords();
-            //
-            // Iterate through the link records on the vertex to which we're going to add
-            // routes.  To make sure we're being clear, we're going to add routing table
-            // entries to the tables on the node corresping to the root of the SPF tree.
-            // These entries will have routes to the IP addresses we find from looking at
-            // the local side of the point-to-point links found on the node described by
-            // the vertex <v>.
-            //
-            NS_LOG_LOGIC(" Node " << node->GetId() << " found " << nLinkRecords
-                                  << " link records in LSA " << lsa << "with LinkStateId "
-                                  << lsa->GetLinkStateId());
-            for (uint32_t j = 0; j < nLinkRecords; ++j)
+            SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
+            Ipv4Address nextHop = exit.first;
+            int32_t outIf = exit.second;
+            if (outIf >= 0)
             {
-                //
-                // We are only concerned about point-to-point links
-                //
-                GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
-                if (lr->GetLinkType() != GlobalRoutingLinkRecord::PointToPoint)
-                {
-                    continue;
-                }
-                //
-                // Here's why we did all of that work.  We're going to add a host route to the
-                // host address found in the m_linkData field of the point-to-point link
-                // record.  In the case of a point-to-point link, this is the local IP address
-                // of the node connected to the link.  Each of these point-to-point links
-                // will correspond to a local interface that has an IP address to which
-                // the node at the root of the SPF tree can send packets.  The vertex <v>
-                // (corresponding to the node that has these links and interfaces) has
-                // an m_nextHop address precalculated for us that is the address to which the
-                // root node should send packets to be forwarded to these IP addresses.
-                // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-                // which the packets should be send for forwarding.
-                //
-                Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-                if (!router)
-                {
-                    continue;
-                }
-                Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-                NS_ASSERT(gr);
-                // walk through all available exit directions due to ECMP,
-                // and add host route for each of the exit direction toward
-                // the vertex 'v'
-                for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-                {
-                    SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                    Ipv4Address nextHop = exit.first;
-                    int32_t outIf = exit.second;
-                    if (outIf >= 0)
-                    {
-                        gr->AddHostRouteTo(lr->GetLinkData(), nextHop, outIf);
-                        NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                               << " adding host route to " << lr->GetLinkData()
-                                               << " using next hop " << nextHop
-                                               << " and outgoing interface " << outIf);
-                    }
-                    else
-                    {
-                        NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                               << " NOT able to add host route to "
-                                               << lr->GetLinkData() << " using next hop " << nextHop
-                                               << " since outgoing interface id is negative "
-                                               << outIf);
-                    }
-                } // for all routes from the root the vertex 'v'
+                calc.routes.push_back({SPFRoute::HOST,
+                                       lr->GetLinkData(),
+                                       Ipv4Mask::GetOnes(),
+                                       nextHop,
+                                       static_cast<uint32_t>(outIf)});
+                NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
+                                       << " adding host route to " << lr->GetLinkData()
+                                       << " using next hop " << nextHop
+                                       << " and outgoing interface " << outIf);
             }
-            //
-            // Done adding the routes for the selected node.
-            //
-            return;
-        }
+            else
+            {
+                NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
+                                       << " NOT able to add host route to "
+                                       << lr->GetLinkData() << " using next hop " << nextHop
+                                       << " since outgoing interface id is negative "
+                                       << outIf);
+            }
+        } // for all routes from the root the vertex 'v'
     }
+    //
+    // Done adding the routes for the selected node.
+    //
+    return;
 }
 
 void
-GlobalRouteManagerImpl::SPFIntraAddTransit(SPFVertex* v)
+GlobalRouteManagerImpl::SPFIntraAddTransit(SPFVertex* v, SPFCalculation& calc) const
 {
     NS_LOG_FUNCTION(this << v);
 
-    NS_ASSERT_MSG(m_spfroot, "GlobalRouteManagerImpl::SPFIntraAddTransit (): Root pointer not set");
+    NS_ASSERT_MSG(calc.spfroot,
+                  "GlobalRouteManagerImpl::SPFIntraAddTransit (): Root pointer not set");
     //
     // The root of the Shortest Path First tree is the router to which we are
     // going to write the actual routing table entries.  The vertex corresponding
@@ -2074,95 +2368,53 @@ GlobalRouteManagerImpl::SPFIntraAddTransit(SPFVertex* v)
     // going to use this ID to discover which node it is that we're actually going
     // to update.
     //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
+    Ipv4Address routerId = calc.spfroot->GetVertexId();
 
     NS_LOG_LOGIC("Vertex ID = " << routerId);
+    const Ptr<Node>& node = calc.node;
+    if (!node)
+    {
+        NS_LOG_LOGIC("Can't find root node " << routerId);
+        return;
+    }
+    NS_LOG_LOGIC("setting routes for node " << node->GetId());
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // Get the Global Router Link State Advertisement from the vertex we're
+    // adding the routes to.  The LSA will have a number of attached Global Router
+    // Link Records corresponding to links off of that vertex / node.  We're going
+    // to be interested in the records corresponding to point-to-point links.
     //
-    NodeList::Iterator i = NodeList::Begin();
-    NodeList::Iterator listEnd = NodeList::End();
-    for (; i != listEnd; i++)
+    GlobalRoutingLSA* lsa = v->GetLSA();
+    NS_ASSERT_MSG(lsa,
+                  "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
+                  "Expected valid LSA in SPFVertex* v");
+    Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask();
+    Ipv4Address tempip = lsa->GetLinkStateId();
+    tempip = tempip.CombineMask(tempmask);
+    // walk through all available exit directions due to ECMP,
+    // and add host route for each of the exit direction toward
+    // the vertex 'v'
+    for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
     {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to GetObject for that interface.  If there's no GlobalRouter interface,
-        // the node in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
+        SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
+        Ipv4Address nextHop = exit.first;
+        int32_t outIf = exit.second;
 
-        if (!rtr)
+        if (outIf >= 0)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
-            continue;
+            calc.routes.push_back(
+                {SPFRoute::NETWORK, tempip, tempmask, nextHop, static_cast<uint32_t>(outIf)});
+            NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
+                                   << " add network route to " << tempip
+                                   << " using next hop " << nextHop << " via interface "
+                                   << outIf);
         }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
+        else
         {
-            NS_LOG_LOGIC("setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to
-            // GetObject for that interface.  If the node is acting as an IP version 4
-            // router, it should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            GlobalRoutingLSA* lsa = v->GetLSA();
-            NS_ASSERT_MSG(lsa,
-                          "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask();
-            Ipv4Address tempip = lsa->GetLinkStateId();
-            tempip = tempip.CombineMask(tempmask);
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
-            {
-                continue;
-            }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all available exit directions due to ECMP,
-            // and add host route for each of the exit direction toward
-            // the vertex 'v'
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-            {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-
-                if (outIf >= 0)
-                {
-                    gr->AddNetworkRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
-                {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative " << outIf);
-                }
-            }
+            NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
+                                   << " NOT able to add network route to " << tempip
+                                   << " using next hop " << nextHop
+                                   << " since outgoing interface id is negative " << outIf);
         }
     }
 }
@@ -2177,7 +2429,7 @@ GlobalRouteManagerImpl::SPFIntraAddTransit(SPFVertex* v)
 // already has set and adds itself to that vertex's list of children.
 //
 void
-GlobalRouteManagerImpl::SPFVertexAddParent(SPFVertex* v)
+GlobalRouteManagerImpl::SPFVertexAddParent(SPFVertex* v) const
 {
     NS_LOG_FUNCTION(this << v);
 
@@ -30,7 +30,9 @@
 #include <list>
 #include <map>
 #include <queue>
+#include <set>
 #include <stdint.h>
+#include <unordered_map>
 #include <vector>
 
 namespace ns3
@@ -639,6 +641,13 @@ class GlobalRouteManagerLSDB
      */
     GlobalRoutingLSA* GetLSAByLinkData(Ipv4Address addr) const;
 
+    /**
+     * @brief Get the router and network LSAs of the database.
+     *
+     * @returns The Link State Advertisements, sorted by link state ID.
+     */
+    std::vector<GlobalRoutingLSA*> GetLSAs() const;
+
     /**
      * @brief Set all LSA flags to an initialized state, for SPF computation
      *
@@ -681,6 +690,9 @@ class GlobalRouteManagerLSDB
     LSDBMap_t m_database; //!< database of IPv4 addresses / Link State Advertisements
     std::vector<GlobalRoutingLSA*>
         m_extdatabase; //!< database of External Link State Advertisements
+    /// index of the LSAs by the LinkData field of their TransitNetwork link records
+    mutable std::unordered_map<Ipv4Address, GlobalRoutingLSA*, Ipv4AddressHash> m_linkDataIndex;
+    mutable bool m_linkDataIndexValid; //!< whether m_linkDataIndex reflects the database
 };
 
 /**
@@ -692,6 +704,13 @@ class GlobalRouteManagerLSDB
  * Then, it can compute shortest paths on a per-node basis to all routers,
  * and finally configure each of the node's forwarding tables.
  *
+ * The SPF calculations of the routers only read a snapshot of the database
+ * and the addresses of the interfaces of the router at the root, and keep
+ * the routes they find until all of them are done; the routes are then
+ * written in the forwarding tables, one router after the other.  Hence the
+ * calculations can run on a pool of threads, whose size is set by the
+ * global value GlobalRoutingSpfThreads (1 by default).
+ *
  * The design is guided by OSPFv2 \RFC{2328} section 16.1.1 and quagga ospfd.
  */
 class GlobalRouteManagerImpl
@@ -725,6 +744,20 @@ class GlobalRouteManagerImpl
      */
     virtual void InitializeRoutes();
 
+    /**
+     * @brief Rebuild the routing database, and recompute the routes of the
+     * routers affected by the changes of the Link State Advertisements.
+     *
+     * The routes of a router are recomputed if one of the LSAs its SPF tree
+     * was built from changed, if an LSA it looked up by link data changed, if
+     * an AS external LSA changed, or if the addresses of its interfaces changed.
+     * The routes of the other routers are left untouched, since their SPF
+     * calculation would find them again.  If the routes were not computed
+     * before, this is equivalent to DeleteGlobalRoutes (),
+     * BuildGlobalRoutingDatabase () and InitializeRoutes ().
+     */
+    virtual void UpdateRoutes();
+
     /**
      * @brief Debugging routine; allow client code to supply a pre-built LSDB
      * @param lsdb the pre-built LSDB
@@ -738,8 +771,142 @@ class GlobalRouteManagerImpl
     void DebugSPFCalculate(Ipv4Address root);
 
   private:
-    SPFVertex* m_spfroot;           //!< the root node
+    /**
+     * \brief A compact, read-only snapshot of the router and network LSAs of
+     * the LSDB, shared by the SPF calculations.
+     *
+     * The LSAs are numbered, and the vertices reached from each of them in the
+     * first stage of the SPF calculation are stored in a flat array, so that
+     * SPFNext neither walks the lists of the LSAs nor searches the database.
+     * The snapshot is not modified by the SPF calculations, which keep the
+     * status of the LSAs in a vector of their own, indexed by LSA number.
+     */
+    struct LSDBSnapshot
+    {
+        /**
+         * \brief Build the snapshot of a database.
+         * \param lsdb the database
+         */
+        explicit LSDBSnapshot(const GlobalRouteManagerLSDB& lsdb);
+
+        /**
+         * \brief Get the number of an LSA of the snapshot.
+         * \param lsa the LSA
+         * \returns the number of the LSA
+         */
+        uint32_t GetNumber(const GlobalRoutingLSA* lsa) const;
+
+        /// A link to a vertex reached from an LSA
+        struct Link
+        {
+            /// the number of the LSA reached, or NO_LSA if it is not in the database
+            uint32_t lsa;
+            /// the link record, for the links of a router LSA, or nullptr
+            GlobalRoutingLinkRecord* record;
+        };
+
+        static const uint32_t NO_LSA = 0xffffffff; //!< number of the LSAs not in the database
+
+        std::vector<GlobalRoutingLSA*> lsas; //!< the LSAs, by number
+        std::vector<uint32_t> firstLink;     //!< index in links of the first link of each LSA
+        std::vector<Link> links;             //!< the links of all the LSAs
+        /// the number of each LSA
+        std::unordered_map<const GlobalRoutingLSA*, uint32_t> numbers;
+    };
+
+    /// A route found by an SPF calculation, written in the forwarding table of its root
+    struct SPFRoute
+    {
+        /// The kind of route
+        enum Type
+        {
+            HOST,    //!< host route
+            NETWORK, //!< network route
+            EXTERNAL //!< AS external route
+        };
+
+        Type type;           //!< the kind of route
+        Ipv4Address dest;    //!< the destination
+        Ipv4Mask mask;       //!< the network mask of the destination
+        Ipv4Address nextHop; //!< the next hop
+        uint32_t outIf;      //!< the outgoing interface
+    };
+
+    /// The addresses of the interfaces of a node, with the index of their interface
+    typedef std::vector<std::pair<Ipv4Address, uint32_t>> InterfaceAddresses_t;
+
+    /**
+     * \brief The state of the SPF calculation rooted at a router.
+     *
+     * The state is private to the calculation, and keeps the routes found
+     * until they are written in the forwarding table of the router.  Once
+     * the routes are written, the root, the interface addresses and the
+     * dependencies on the LSDB are kept, to find the routers affected by the
+     * changes of the LSDB in UpdateRoutes ().
+     */
+    struct SPFCalculation
+    {
+        Ipv4Address root;                //!< the router ID of the root
+        Ptr<Node> node;                  //!< the node at the root, if any
+        InterfaceAddresses_t interfaces; //!< the addresses of the interfaces of the root
+        SPFVertex* spfroot;              //!< the root vertex of the SPF tree
+        std::vector<uint8_t> status;     //!< the GlobalRoutingLSA::SPFStatus of the LSAs
+        std::vector<SPFRoute> routes;    //!< the routes found
+        std::set<Ipv4Address> lsas;      //!< link state IDs of the LSAs the routes depend on
+        std::set<Ipv4Address> linkData;  //!< addresses looked up in the link data of the LSAs
+    };
+
     GlobalRouteManagerLSDB* m_lsdb; //!< the Link State DataBase (LSDB) of the Global Route Manager
+    /// the SPF calculations whose routes are in the forwarding tables, by node ID
+    std::map<uint32_t, SPFCalculation> m_spfCalculations;
+    bool m_routesComputed; //!< whether the routes of the LSDB were computed
+
+    /**
+     * \brief Find the node whose GlobalRouter has the given router ID.
+     *
+     * \param routerId the router ID
+     * \returns the node, or nullptr if no node has the router ID
+     */
+    Ptr<Node> FindRouterNode(Ipv4Address routerId) const;
+
+    /**
+     * \brief Delete the routes of a node written by the global routing.
+     *
+     * \param node the node
+     */
+    void DeleteNodeRoutes(Ptr<Node> node) const;
+
+    /**
+     * \brief Prepare the SPF calculation rooted at a router.
+     *
+     * The addresses of the interfaces of the node are copied into the
+     * calculation, which does not access the node.
+     *
+     * \param root the router ID of the root
+     * \param node the node at the root, or nullptr
+     * \returns the calculation
+     */
+    SPFCalculation PrepareSPFCalculation(Ipv4Address root, Ptr<Node> node) const;
+
+    /**
+     * \brief Run SPF calculations, on a pool of threads if the global value
+     * GlobalRoutingSpfThreads allows it, and write the routes they found in
+     * the forwarding tables of their root.
+     *
+     * The routes are written by the calling thread once all the calculations
+     * are done, in the order of the calculations.
+     *
+     * \param calcs the calculations
+     */
+    void RunSPFCalculations(std::vector<SPFCalculation>& calcs) const;
+
+    /**
+     * \brief Write the routes found by an SPF calculation in the forwarding
+     * table of its root.
+     *
+     * \param calc the calculation
+     */
+    void InstallRoutes(const SPFCalculation& calc) const;
 
     /**
      * \brief Test if a node is a stub, from an OSPF sense.
@@ -748,18 +915,19 @@ class GlobalRouteManagerImpl
      * can safely be added to the next-hop router and SPF does not need
      * to be run
      *
-     * \param root the root node
+     * \param calc the SPF calculation
      * \returns true if the node is a stub
      */
-    bool CheckForStubNode(Ipv4Address root);
+    bool CheckForStubNode(SPFCalculation& calc) const;
 
     /**
      * \brief Calculate the shortest path first (SPF) tree
      *
      * Equivalent to quagga ospf_spf_calculate
-     * \param root the root node
+     * \param calc the SPF calculation
+     * \param snapshot the snapshot of the LSDB
      */
-    void SPFCalculate(Ipv4Address root);
+    void SPFCalculate(SPFCalculation& calc, const LSDBSnapshot& snapshot) const;
 
     /**
      * \brief Process Stub nodes
@@ -769,16 +937,18 @@ class GlobalRouteManagerImpl
      * broadcast interfaces for which no neighboring router can be found
      *
      * \param v vertex to be processed
+     * \param calc the SPF calculation
      */
-    void SPFProcessStubs(SPFVertex* v);
+    void SPFProcessStubs(SPFVertex* v, SPFCalculation& calc) const;
 
     /**
      * \brief Process Autonomous Systems (AS) External LSA
      *
      * \param v vertex to be processed
      * \param extlsa external LSA
+     * \param calc the SPF calculation
      */
-    void ProcessASExternals(SPFVertex* v, GlobalRoutingLSA* extlsa);
+    void ProcessASExternals(SPFVertex* v, GlobalRoutingLSA* extlsa, SPFCalculation& calc) const;
 
     /**
      * \brief Examine the links in v's LSA and update the list of candidates with any
@@ -800,8 +970,13 @@ class GlobalRouteManagerImpl
      *
      * \param v the vertex
      * \param candidate the SPF candidate queue
+     * \param snapshot the snapshot of the LSDB
+     * \param calc the SPF calculation
      */
-    void SPFNext(SPFVertex* v, CandidateQueue& candidate);
+    void SPFNext(SPFVertex* v,
+                 CandidateQueue& candidate,
+                 const LSDBSnapshot& snapshot,
+                 SPFCalculation& calc) const;
 
     /**
      * \brief Calculate nexthop from root through V (parent) to vertex W (destination)
@@ -814,12 +989,14 @@ class GlobalRouteManagerImpl
      * \param w the destination
      * \param l the link record
      * \param distance the target distance
+     * \param calc the SPF calculation
      * \returns 1 on success
      */
     int SPFNexthopCalculation(SPFVertex* v,
                               SPFVertex* w,
                               GlobalRoutingLinkRecord* l,
-                              uint32_t distance);
+                              uint32_t distance,
+                              const SPFCalculation& calc) const;
 
     /**
      * \brief Adds a vertex to the list of children *in* each of its parents
@@ -835,7 +1012,7 @@ class GlobalRouteManagerImpl
      *
      * \param v the vertex
      */
-    void SPFVertexAddParent(SPFVertex* v);
+    void SPFVertexAddParent(SPFVertex* v) const;
 
     /**
      * \brief Search for a link between two vertices.
@@ -858,7 +1035,7 @@ class GlobalRouteManagerImpl
      */
     GlobalRoutingLinkRecord* SPFGetNextLink(SPFVertex* v,
                                             SPFVertex* w,
-                                            GlobalRoutingLinkRecord* prev_link);
+                                            GlobalRoutingLinkRecord* prev_link) const;
 
     /**
      * \brief Add a host route to the routing tables
@@ -880,46 +1057,53 @@ class GlobalRouteManagerImpl
      * route.
      *
      * \param v the vertex
+     * \param calc the SPF calculation
      *
      */
-    void SPFIntraAddRouter(SPFVertex* v);
+    void SPFIntraAddRouter(SPFVertex* v, SPFCalculation& calc) const;
 
     /**
      * \brief Add a transit to the routing tables
      *
      * \param v the vertex
+     * \param calc the SPF calculation
      */
-    void SPFIntraAddTransit(SPFVertex* v);
+    void SPFIntraAddTransit(SPFVertex* v, SPFCalculation& calc) const;
 
     /**
      * \brief Add a stub to the routing tables
      *
      * \param l the global routing link record
      * \param v the vertex
+     * \param calc the SPF calculation
      */
-    void SPFIntraAddStub(GlobalRoutingLinkRecord* l, SPFVertex* v);
+    void SPFIntraAddStub(GlobalRoutingLinkRecord* l, SPFVertex* v, SPFCalculation& calc) const;
 
     /**
      * \brief Add an external route to the routing tables
      *
      * \param extlsa the external LSA
      * \param v the vertex
+     * \param calc the SPF calculation
      */
-    void SPFAddASExternal(GlobalRoutingLSA* extlsa, SPFVertex* v);
+    void SPFAddASExternal(GlobalRoutingLSA* extlsa, SPFVertex* v, SPFCalculation& calc) const;
 
     /**
      * \brief Return the interface number corresponding to a given IP address and mask
      *
-     * This is a wrapper around GetInterfaceForPrefix(), but we first
-     * have to find the right node pointer to pass to that function.
+     * This is equivalent to GetInterfaceForPrefix() on the node at the root,
+     * applied to the interface addresses copied in the SPF calculation.
      * If no such interface is found, return -1 (note:  unit test framework
      * for routing assumes -1 to be a legal return value)
      *
      * \param a the target IP address
      * \param amask the target subnet mask
+     * \param calc the SPF calculation
      * \return the outgoing interface number
      */
-    int32_t FindOutgoingInterfaceId(Ipv4Address a, Ipv4Mask amask = Ipv4Mask("255.255.255.255"));
+    int32_t FindOutgoingInterfaceId(Ipv4Address a,
+                                    Ipv4Mask amask,
+                                    const SPFCalculation& calc) const;
 };
 
 } // namespace ns3
@@ -70,6 +70,14 @@ class GlobalRouteManager
      * per-node forwarding tables
      */
     static void InitializeRoutes();
+
+    /**
+     * @brief Rebuild the routing database, and recompute the routes of the
+     * routers affected by the changes of the Link State Advertisements
+     *
+     * The routes of the other routers are left in their forwarding tables.
+     */
+    static void UpdateRoutes();
 };
 
 } // namespace ns3
@@ -22,8 +22,10 @@
 
 #include "ip-l4-protocol.h"
 
+#include "ns3/abort.h"
 #include "ns3/integer.h"
 #include "ns3/log.h"
+#include "ns3/packet.h"
 
 namespace ns3
 {
@@ -82,4 +84,16 @@ IpL4Protocol::ReceiveIcmp(Ipv6Address icmpSource,
                          << icmpInfo << payloadSource << payloadDestination << payload);
 }
 
+std::vector<Ptr<Packet>>
+IpL4Protocol::SegmentGso(Ptr<Packet> packet,
+                         uint16_t segmentSize,
+                         const Address& source,
+                         const Address& destination) const
+{
+    NS_LOG_FUNCTION(this << packet << segmentSize << source << destination);
+    NS_ABORT_MSG("Protocol " << GetProtocolNumber()
+                              << " does not support the segmentation offload");
+    return {};
+}
+
 } // namespace ns3
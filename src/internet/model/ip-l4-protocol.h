@@ -29,10 +29,13 @@
 #include "ns3/callback.h"
 #include "ns3/object.h"
 
+#include <vector>
+
 namespace ns3
 {
 
 class Packet;
+class Address;
 class Ipv4Address;
 class Ipv4Interface;
 class Ipv6Address;
@@ -146,6 +149,26 @@ class IpL4Protocol : public Object
                              Ipv6Address payloadDestination,
                              const uint8_t payload[8]);
 
+    /**
+     * \brief Called from lower-level layers to split a super-segment into the
+     * segments it carries.
+     *
+     * The super-segments are built by the protocols emulating a generic
+     * segmentation offload, which mark them with a GsoTag. The default
+     * implementation aborts, as the protocols that build no super-segments
+     * need not implement it.
+     *
+     * \param packet the super-segment, with its transport header and without the GsoTag
+     * \param segmentSize the payload size of the segments
+     * \param source the source address, used for the checksum
+     * \param destination the destination address, used for the checksum
+     * \return the segments, in order, with their transport header
+     */
+    virtual std::vector<Ptr<Packet>> SegmentGso(Ptr<Packet> packet,
+                                                uint16_t segmentSize,
+                                                const Address& source,
+                                                const Address& destination) const;
+
     /**
      * \brief callback to send packets over IPv4
      */
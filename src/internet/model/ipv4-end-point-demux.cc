@@ -24,6 +24,8 @@
 
 #include "ns3/log.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -46,30 +48,29 @@ Ipv4EndPointDemux::~Ipv4EndPointDemux()
         delete endPoint;
     }
     m_endPoints.clear();
+    m_positions.clear();
+    m_localPorts.clear();
 }
 
 bool
 Ipv4EndPointDemux::LookupPortLocal(uint16_t port)
 {
     NS_LOG_FUNCTION(this << port);
-    for (EndPointsI i = m_endPoints.begin(); i != m_endPoints.end(); i++)
-    {
-        if ((*i)->GetLocalPort() == port)
-        {
-            return true;
-        }
-    }
-    return false;
+    return m_localPorts.find(port) != m_localPorts.end();
 }
 
 bool
 Ipv4EndPointDemux::LookupLocal(Ptr<NetDevice> boundNetDevice, Ipv4Address addr, uint16_t port)
 {
     NS_LOG_FUNCTION(this << addr << port);
-    for (EndPointsI i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto endPoints = m_localPorts.find(port);
+    if (endPoints == m_localPorts.end())
     {
-        if ((*i)->GetLocalPort() == port && (*i)->GetLocalAddress() == addr &&
-            (*i)->GetBoundNetDevice() == boundNetDevice)
+        return false;
+    }
+    for (Ipv4EndPoint* endP : endPoints->second)
+    {
+        if (endP->GetLocalAddress() == addr && endP->GetBoundNetDevice() == boundNetDevice)
         {
             return true;
         }
@@ -88,7 +89,7 @@ Ipv4EndPointDemux::Allocate()
         return nullptr;
     }
     Ipv4EndPoint* endPoint = new Ipv4EndPoint(Ipv4Address::GetAny(), port);
-    m_endPoints.push_back(endPoint);
+    AddEndPoint(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -104,7 +105,7 @@ Ipv4EndPointDemux::Allocate(Ipv4Address address)
         return nullptr;
     }
     Ipv4EndPoint* endPoint = new Ipv4EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
+    AddEndPoint(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -127,7 +128,7 @@ Ipv4EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice, Ipv4Address address,
         return nullptr;
     }
     Ipv4EndPoint* endPoint = new Ipv4EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
+    AddEndPoint(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -140,19 +141,21 @@ Ipv4EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice,
                             uint16_t peerPort)
 {
     NS_LOG_FUNCTION(this << localAddress << localPort << peerAddress << peerPort << boundNetDevice);
-    for (EndPointsI i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto tuple = m_fourTuples.find({localAddress, localPort, peerAddress, peerPort});
+    if (tuple != m_fourTuples.end())
     {
-        if ((*i)->GetLocalPort() == localPort && (*i)->GetLocalAddress() == localAddress &&
-            (*i)->GetPeerPort() == peerPort && (*i)->GetPeerAddress() == peerAddress &&
-            ((*i)->GetBoundNetDevice() == boundNetDevice || !(*i)->GetBoundNetDevice()))
+        for (Ipv4EndPoint* endP : tuple->second)
         {
-            NS_LOG_WARN("Duplicated endpoint.");
-            return nullptr;
+            if (endP->GetBoundNetDevice() == boundNetDevice || !endP->GetBoundNetDevice())
+            {
+                NS_LOG_WARN("Duplicated endpoint.");
+                return nullptr;
+            }
         }
     }
     Ipv4EndPoint* endPoint = new Ipv4EndPoint(localAddress, localPort);
     endPoint->SetPeer(peerAddress, peerPort);
-    m_endPoints.push_back(endPoint);
+    AddEndPoint(endPoint);
 
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
 
@@ -163,15 +166,16 @@ void
 Ipv4EndPointDemux::DeAllocate(Ipv4EndPoint* endPoint)
 {
     NS_LOG_FUNCTION(this << endPoint);
-    for (EndPointsI i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto position = m_positions.find(endPoint);
+    if (position == m_positions.end())
     {
-        if (*i == endPoint)
-        {
-            delete endPoint;
-            m_endPoints.erase(i);
-            break;
-        }
+        return;
     }
+    RemoveFromIndex(endPoint);
+    RemoveFromLocalPort(endPoint);
+    m_endPoints.erase(position->second);
+    m_positions.erase(position);
+    delete endPoint;
 }
 
 /*
@@ -205,163 +209,224 @@ Ipv4EndPointDemux::Lookup(Ipv4Address daddr,
 {
     NS_LOG_FUNCTION(this << daddr << dport << saddr << sport << incomingInterface);
 
-    EndPoints retval1; // Matches exact on local port, wildcards on others
-    EndPoints retval2; // Matches exact on local port/adder, wildcards on others
-    EndPoints retval3; // Matches all but local address
-    EndPoints retval4; // Exact match on all 4
-
-    NS_LOG_DEBUG("Looking up endpoint for destination address " << daddr << ":" << dport);
-    for (EndPointsI i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    EndPoints retval;
+    Ipv4EndPoint* endP = LookupEndPoint(daddr, dport, saddr, sport, incomingInterface);
+    if (endP)
     {
-        Ipv4EndPoint* endP = *i;
-
-        NS_LOG_DEBUG("Looking at endpoint dport="
-                     << endP->GetLocalPort() << " daddr=" << endP->GetLocalAddress()
-                     << " sport=" << endP->GetPeerPort() << " saddr=" << endP->GetPeerAddress());
+        retval.push_back(endP);
+    }
+    return retval; // might be empty if no matches
+}
 
-        if (!endP->IsRxEnabled())
-        {
-            NS_LOG_LOGIC("Skipping endpoint " << &endP
-                                              << " because endpoint can not receive packets");
-            continue;
-        }
+Ipv4EndPoint*
+Ipv4EndPointDemux::LookupEndPoint(Ipv4Address daddr,
+                                  uint16_t dport,
+                                  Ipv4Address saddr,
+                                  uint16_t sport,
+                                  Ptr<Ipv4Interface> incomingInterface)
+{
+    NS_LOG_FUNCTION(this << daddr << dport << saddr << sport << incomingInterface);
 
-        if (endP->GetLocalPort() != dport)
+    // First matching endpoint and number of matching endpoints for each case:
+    // 1) Matches exact on local port, wildcards on others
+    // 2) Matches exact on local port/adder, wildcards on others
+    // 3) Matches all but local address
+    // 4) Exact match on all 4
+    Ipv4EndPoint* found[4] = {nullptr, nullptr, nullptr, nullptr};
+    uint32_t nFound[4] = {0, 0, 0, 0};
+
+    // An endpoint can only match if it is bound to the destination port and to
+    // the destination address, to the any address or to a subnet of the
+    // incoming interface, and if it is connected either to the source address
+    // and port or to nothing.  Only these four-tuples are looked up.
+    auto lookupTuple = [&](Ipv4Address localAddress, Ipv4Address peerAddress, uint16_t peerPort) {
+        auto tuple = m_fourTuples.find({localAddress, dport, peerAddress, peerPort});
+        if (tuple == m_fourTuples.end())
         {
-            NS_LOG_LOGIC("Skipping endpoint " << &endP << " because endpoint dport "
-                                              << endP->GetLocalPort()
-                                              << " does not match packet dport " << dport);
-            continue;
+            return;
         }
-        if (endP->GetBoundNetDevice())
+        for (Ipv4EndPoint* endP : tuple->second)
         {
-            if (endP->GetBoundNetDevice() != incomingInterface->GetDevice())
+            uint8_t matches = MatchEndPoint(endP, daddr, saddr, sport, incomingInterface);
+            for (uint8_t i = 0; i < 4; i++)
             {
-                NS_LOG_LOGIC("Skipping endpoint "
-                             << &endP << " because endpoint is bound to specific device and"
-                             << endP->GetBoundNetDevice() << " does not match packet device "
-                             << incomingInterface->GetDevice());
-                continue;
+                if (matches & (1 << i))
+                {
+                    found[i] = (nFound[i] == 0 ? endP : found[i]);
+                    nFound[i]++;
+                }
             }
         }
-
-        bool localAddressMatchesExact = false;
-        bool localAddressIsAny = false;
-        bool localAddressIsSubnetAny = false;
-
-        // We have 3 cases:
-        // 1) Exact local / destination address match
-        // 2) Local endpoint bound to Any -> matches anything
-        // 3) Local endpoint bound to x.y.z.0 -> matches Subnet-directed broadcast packet (e.g.,
-        // x.y.z.255 in a /24 net) and direct destination match.
-
-        if (endP->GetLocalAddress() == daddr)
-        {
-            // Case 1:
-            localAddressMatchesExact = true;
-        }
-        else if (endP->GetLocalAddress() == Ipv4Address::GetAny())
+    };
+    auto lookupLocal = [&](Ipv4Address localAddress) {
+        lookupTuple(localAddress, saddr, sport);
+        if (saddr != Ipv4Address::GetAny() || sport != 0)
         {
-            // Case 2:
-            localAddressIsAny = true;
+            lookupTuple(localAddress, Ipv4Address::GetAny(), 0);
         }
-        else
+    };
+
+    NS_LOG_DEBUG("Looking up endpoint for destination address " << daddr << ":" << dport);
+    lookupLocal(daddr);
+    if (daddr != Ipv4Address::GetAny())
+    {
+        lookupLocal(Ipv4Address::GetAny());
+    }
+    if (incomingInterface)
+    {
+        for (uint32_t i = 0; i < incomingInterface->GetNAddresses(); i++)
         {
-            // Case 3:
-            for (uint32_t i = 0; i < incomingInterface->GetNAddresses(); i++)
+            Ipv4InterfaceAddress addr = incomingInterface->GetAddress(i);
+            Ipv4Address addrNetpart = addr.GetLocal().CombineMask(addr.GetMask());
+            bool duplicate = (addrNetpart == daddr || addrNetpart == Ipv4Address::GetAny());
+            for (uint32_t j = 0; j < i && !duplicate; j++)
             {
-                Ipv4InterfaceAddress addr = incomingInterface->GetAddress(i);
-
-                Ipv4Address addrNetpart = addr.GetLocal().CombineMask(addr.GetMask());
-                if (endP->GetLocalAddress() == addrNetpart)
-                {
-                    NS_LOG_LOGIC("Endpoint is SubnetDirectedAny "
-                                 << endP->GetLocalAddress() << "/"
-                                 << addr.GetMask().GetPrefixLength());
-
-                    Ipv4Address daddrNetPart = daddr.CombineMask(addr.GetMask());
-                    if (addrNetpart == daddrNetPart)
-                    {
-                        localAddressIsSubnetAny = true;
-                    }
-                }
+                Ipv4InterfaceAddress other = incomingInterface->GetAddress(j);
+                duplicate = (other.GetLocal().CombineMask(other.GetMask()) == addrNetpart);
             }
-
-            // if no match here, keep looking
-            if (!localAddressIsSubnetAny)
+            if (!duplicate)
             {
-                continue;
+                lookupLocal(addrNetpart);
             }
         }
+    }
 
-        bool remotePortMatchesExact = endP->GetPeerPort() == sport;
-        bool remotePortMatchesWildCard = endP->GetPeerPort() == 0;
-        bool remoteAddressMatchesExact = endP->GetPeerAddress() == saddr;
-        bool remoteAddressMatchesWildCard = endP->GetPeerAddress() == Ipv4Address::GetAny();
-
-        // If remote does not match either with exact or wildcard,
-        // skip this one
-        if (!(remotePortMatchesExact || remotePortMatchesWildCard))
-        {
-            continue;
-        }
-        if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
+    // Here we find the most exact match
+    for (int i = 3; i >= 0; i--)
+    {
+        if (nFound[i] > 0)
         {
-            continue;
+            NS_ABORT_MSG_IF(nFound[i] > 1,
+                            "Too many endpoints - perhaps you created too many sockets without "
+                            "binding them to different NetDevices.");
+            return found[i];
         }
+    }
+    return nullptr;
+}
 
-        bool localAddressMatchesWildCard = localAddressIsAny || localAddressIsSubnetAny;
+uint8_t
+Ipv4EndPointDemux::MatchEndPoint(Ipv4EndPoint* endP,
+                                 Ipv4Address daddr,
+                                 Ipv4Address saddr,
+                                 uint16_t sport,
+                                 Ptr<Ipv4Interface> incomingInterface) const
+{
+    NS_LOG_DEBUG("Looking at endpoint dport="
+                 << endP->GetLocalPort() << " daddr=" << endP->GetLocalAddress()
+                 << " sport=" << endP->GetPeerPort() << " saddr=" << endP->GetPeerAddress());
 
-        if (localAddressMatchesExact && remoteAddressMatchesExact && remotePortMatchesExact)
-        { // All 4 match - this is the case of an open TCP connection, for example.
-            NS_LOG_LOGIC("Found an endpoint for case 4, adding " << endP->GetLocalAddress() << ":"
-                                                                 << endP->GetLocalPort());
-            retval4.push_back(endP);
-        }
-        if (localAddressMatchesWildCard && remoteAddressMatchesExact && remotePortMatchesExact)
-        { // All but local address - no idea what this case could be.
-            NS_LOG_LOGIC("Found an endpoint for case 3, adding " << endP->GetLocalAddress() << ":"
-                                                                 << endP->GetLocalPort());
-            retval3.push_back(endP);
-        }
-        if (localAddressMatchesExact && remoteAddressMatchesWildCard && remotePortMatchesWildCard)
-        { // Only local port and local address matches exactly - Not yet opened connection
-            NS_LOG_LOGIC("Found an endpoint for case 2, adding " << endP->GetLocalAddress() << ":"
-                                                                 << endP->GetLocalPort());
-            retval2.push_back(endP);
-        }
-        if (localAddressMatchesWildCard && remoteAddressMatchesWildCard &&
-            remotePortMatchesWildCard)
-        { // Only local port matches exactly - Endpoint open to "any" connection
-            NS_LOG_LOGIC("Found an endpoint for case 1, adding " << endP->GetLocalAddress() << ":"
-                                                                 << endP->GetLocalPort());
-            retval1.push_back(endP);
-        }
+    if (!endP->IsRxEnabled())
+    {
+        NS_LOG_LOGIC("Skipping endpoint " << &endP
+                                          << " because endpoint can not receive packets");
+        return 0;
     }
 
-    // Here we find the most exact match
-    EndPoints retval;
-    if (!retval4.empty())
+    if (endP->GetBoundNetDevice())
     {
-        retval = retval4;
+        if (endP->GetBoundNetDevice() != incomingInterface->GetDevice())
+        {
+            NS_LOG_LOGIC("Skipping endpoint "
+                         << &endP << " because endpoint is bound to specific device and"
+                         << endP->GetBoundNetDevice() << " does not match packet device "
+                         << incomingInterface->GetDevice());
+            return 0;
+        }
     }
-    else if (!retval3.empty())
+
+    bool localAddressMatchesExact = false;
+    bool localAddressIsAny = false;
+    bool localAddressIsSubnetAny = false;
+
+    // We have 3 cases:
+    // 1) Exact local / destination address match
+    // 2) Local endpoint bound to Any -> matches anything
+    // 3) Local endpoint bound to x.y.z.0 -> matches Subnet-directed broadcast packet (e.g.,
+    // x.y.z.255 in a /24 net) and direct destination match.
+
+    if (endP->GetLocalAddress() == daddr)
     {
-        retval = retval3;
+        // Case 1:
+        localAddressMatchesExact = true;
     }
-    else if (!retval2.empty())
+    else if (endP->GetLocalAddress() == Ipv4Address::GetAny())
     {
-        retval = retval2;
+        // Case 2:
+        localAddressIsAny = true;
     }
     else
     {
-        retval = retval1;
+        // Case 3:
+        for (uint32_t i = 0; i < incomingInterface->GetNAddresses(); i++)
+        {
+            Ipv4InterfaceAddress addr = incomingInterface->GetAddress(i);
+
+            Ipv4Address addrNetpart = addr.GetLocal().CombineMask(addr.GetMask());
+            if (endP->GetLocalAddress() == addrNetpart)
+            {
+                NS_LOG_LOGIC("Endpoint is SubnetDirectedAny " << endP->GetLocalAddress() << "/"
+                                                              << addr.GetMask().GetPrefixLength());
+
+                Ipv4Address daddrNetPart = daddr.CombineMask(addr.GetMask());
+                if (addrNetpart == daddrNetPart)
+                {
+                    localAddressIsSubnetAny = true;
+                }
+            }
+        }
+
+        // if no match here, keep looking
+        if (!localAddressIsSubnetAny)
+        {
+            return 0;
+        }
+    }
+
+    bool remotePortMatchesExact = endP->GetPeerPort() == sport;
+    bool remotePortMatchesWildCard = endP->GetPeerPort() == 0;
+    bool remoteAddressMatchesExact = endP->GetPeerAddress() == saddr;
+    bool remoteAddressMatchesWildCard = endP->GetPeerAddress() == Ipv4Address::GetAny();
+
+    // If remote does not match either with exact or wildcard,
+    // skip this one
+    if (!(remotePortMatchesExact || remotePortMatchesWildCard))
+    {
+        return 0;
+    }
+    if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
+    {
+        return 0;
     }
 
-    NS_ABORT_MSG_IF(retval.size() > 1,
-                    "Too many endpoints - perhaps you created too many sockets without binding "
-                    "them to different NetDevices.");
-    return retval; // might be empty if no matches
+    bool localAddressMatchesWildCard = localAddressIsAny || localAddressIsSubnetAny;
+
+    uint8_t matches = 0;
+    if (localAddressMatchesExact && remoteAddressMatchesExact && remotePortMatchesExact)
+    { // All 4 match - this is the case of an open TCP connection, for example.
+        NS_LOG_LOGIC("Found an endpoint for case 4, adding " << endP->GetLocalAddress() << ":"
+                                                             << endP->GetLocalPort());
+        matches |= (1 << 3);
+    }
+    if (localAddressMatchesWildCard && remoteAddressMatchesExact && remotePortMatchesExact)
+    { // All but local address - no idea what this case could be.
+        NS_LOG_LOGIC("Found an endpoint for case 3, adding " << endP->GetLocalAddress() << ":"
+                                                             << endP->GetLocalPort());
+        matches |= (1 << 2);
+    }
+    if (localAddressMatchesExact && remoteAddressMatchesWildCard && remotePortMatchesWildCard)
+    { // Only local port and local address matches exactly - Not yet opened connection
+        NS_LOG_LOGIC("Found an endpoint for case 2, adding " << endP->GetLocalAddress() << ":"
+                                                             << endP->GetLocalPort());
+        matches |= (1 << 1);
+    }
+    if (localAddressMatchesWildCard && remoteAddressMatchesWildCard && remotePortMatchesWildCard)
+    { // Only local port matches exactly - Endpoint open to "any" connection
+        NS_LOG_LOGIC("Found an endpoint for case 1, adding " << endP->GetLocalAddress() << ":"
+                                                             << endP->GetLocalPort());
+        matches |= (1 << 0);
+    }
+    return matches;
 }
 
 Ipv4EndPoint*
@@ -372,40 +437,116 @@ Ipv4EndPointDemux::SimpleLookup(Ipv4Address daddr,
 {
     NS_LOG_FUNCTION(this << daddr << dport << saddr << sport);
 
+    auto tuple = m_fourTuples.find({daddr, dport, saddr, sport});
+    if (tuple != m_fourTuples.end())
+    {
+        /* this is an exact match. */
+        return tuple->second.front();
+    }
+
     // this code is a copy/paste version of an old BSD ip stack lookup
     // function.
     uint32_t genericity = 3;
     Ipv4EndPoint* generic = nullptr;
-    for (EndPointsI i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto endPoints = m_localPorts.find(dport);
+    if (endPoints == m_localPorts.end())
+    {
+        return nullptr;
+    }
+    for (Ipv4EndPoint* endP : endPoints->second)
     {
-        if ((*i)->GetLocalPort() != dport)
-        {
-            continue;
-        }
-        if ((*i)->GetLocalAddress() == daddr && (*i)->GetPeerPort() == sport &&
-            (*i)->GetPeerAddress() == saddr)
-        {
-            /* this is an exact match. */
-            return *i;
-        }
         uint32_t tmp = 0;
-        if ((*i)->GetLocalAddress() == Ipv4Address::GetAny())
+        if (endP->GetLocalAddress() == Ipv4Address::GetAny())
         {
             tmp++;
         }
-        if ((*i)->GetPeerAddress() == Ipv4Address::GetAny())
+        if (endP->GetPeerAddress() == Ipv4Address::GetAny())
         {
             tmp++;
         }
         if (tmp < genericity)
         {
-            generic = (*i);
+            generic = endP;
             genericity = tmp;
         }
     }
     return generic;
 }
 
+bool
+Ipv4EndPointDemux::FourTuple::operator==(const FourTuple& other) const
+{
+    return localAddress == other.localAddress && localPort == other.localPort &&
+           peerAddress == other.peerAddress && peerPort == other.peerPort;
+}
+
+size_t
+Ipv4EndPointDemux::FourTupleHash::operator()(const FourTuple& tuple) const
+{
+    uint64_t local = (uint64_t(tuple.localAddress.Get()) << 16) | tuple.localPort;
+    uint64_t peer = (uint64_t(tuple.peerAddress.Get()) << 16) | tuple.peerPort;
+    return std::hash<uint64_t>()(local ^ (peer * 0x9e3779b97f4a7c15ULL));
+}
+
+void
+Ipv4EndPointDemux::AddEndPoint(Ipv4EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    m_positions[endPoint] = m_endPoints.insert(m_endPoints.end(), endPoint);
+    AddToLocalPort(endPoint);
+    AddToIndex(endPoint);
+}
+
+void
+Ipv4EndPointDemux::AddToLocalPort(Ipv4EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    m_localPorts[endPoint->GetLocalPort()].push_back(endPoint);
+}
+
+void
+Ipv4EndPointDemux::RemoveFromLocalPort(Ipv4EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    auto port = m_localPorts.find(endPoint->GetLocalPort());
+    NS_ASSERT_MSG(port != m_localPorts.end(), "End point not found in the demux");
+    auto& endPoints = port->second;
+    endPoints.erase(std::find(endPoints.begin(), endPoints.end(), endPoint));
+    if (endPoints.empty())
+    {
+        m_localPorts.erase(port);
+    }
+}
+
+void
+Ipv4EndPointDemux::AddToIndex(Ipv4EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    endPoint->m_demux = this;
+    m_fourTuples[{endPoint->GetLocalAddress(),
+                  endPoint->GetLocalPort(),
+                  endPoint->GetPeerAddress(),
+                  endPoint->GetPeerPort()}]
+        .push_back(endPoint);
+}
+
+void
+Ipv4EndPointDemux::RemoveFromIndex(Ipv4EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    auto tuple = m_fourTuples.find({endPoint->GetLocalAddress(),
+                                    endPoint->GetLocalPort(),
+                                    endPoint->GetPeerAddress(),
+                                    endPoint->GetPeerPort()});
+    NS_ASSERT_MSG(tuple != m_fourTuples.end(), "End point not found in the demux");
+    auto& endPoints = tuple->second;
+    endPoints.erase(std::find(endPoints.begin(), endPoints.end(), endPoint));
+    if (endPoints.empty())
+    {
+        m_fourTuples.erase(tuple);
+    }
+}
+
 uint16_t
 Ipv4EndPointDemux::AllocateEphemeralPort()
 {
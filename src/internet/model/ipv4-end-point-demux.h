@@ -26,6 +26,8 @@
 
 #include <list>
 #include <stdint.h>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -42,6 +44,11 @@ class Ipv4EndPoint;
  * of endpoints, and has APIs to add and find endpoints in this demux.  This
  * code is shared in common to TCP and UDP protocols in ns3.  This demux
  * sits between ns3's layer four and the socket layer
+ *
+ * The endpoints are also kept in a hash table keyed by their four-tuple,
+ * which the endpoints update when their addresses change.  A lookup probes
+ * only the four-tuples which can match the packet, hence its cost does not
+ * depend on the number of endpoints (e.g., of TCP connections) of the node.
  */
 
 class Ipv4EndPointDemux
@@ -106,6 +113,25 @@ class Ipv4EndPointDemux
                      uint16_t sport,
                      Ptr<Ipv4Interface> incomingInterface);
 
+    /**
+     * \brief lookup for a match with all the parameters.
+     *
+     * This is the same as Lookup, which can return at most one EndPoint,
+     * without building a list.
+     *
+     * \param daddr destination address to test
+     * \param dport destination port to test
+     * \param saddr source address to test
+     * \param sport source port to test
+     * \param incomingInterface the incoming interface
+     * \return the most-matching IPv4EndPoint (nullptr if not found)
+     */
+    Ipv4EndPoint* LookupEndPoint(Ipv4Address daddr,
+                                 uint16_t dport,
+                                 Ipv4Address saddr,
+                                 uint16_t sport,
+                                 Ptr<Ipv4Interface> incomingInterface);
+
     /**
      * \brief simple lookup for a match with all the parameters.
      * \param daddr destination address to test
@@ -171,6 +197,92 @@ class Ipv4EndPointDemux
     void DeAllocate(Ipv4EndPoint* endPoint);
 
   private:
+    friend class Ipv4EndPoint;
+
+    /**
+     * \brief The four-tuple of an end point.
+     */
+    struct FourTuple
+    {
+        Ipv4Address localAddress; //!< the local address
+        uint16_t localPort;       //!< the local port
+        Ipv4Address peerAddress;  //!< the peer address
+        uint16_t peerPort;        //!< the peer port
+
+        /**
+         * \brief Equality operator.
+         * \param other the four-tuple to compare to
+         * \returns true if the four-tuples are equal
+         */
+        bool operator==(const FourTuple& other) const;
+    };
+
+    /**
+     * \brief Hash function class for the four-tuples.
+     */
+    struct FourTupleHash
+    {
+        /**
+         * \brief Returns the hash of a four-tuple.
+         * \param tuple the four-tuple
+         * \returns the hash of the four-tuple
+         */
+        size_t operator()(const FourTuple& tuple) const;
+    };
+
+    /**
+     * \brief Add a new end point to the list of end points and to the lookup tables.
+     * \param endPoint the end point
+     */
+    void AddEndPoint(Ipv4EndPoint* endPoint);
+
+    /**
+     * \brief Add an end point to the end points bound to its local port.
+     * \param endPoint the end point
+     */
+    void AddToLocalPort(Ipv4EndPoint* endPoint);
+
+    /**
+     * \brief Remove an end point from the end points bound to its local port.
+     * \param endPoint the end point
+     */
+    void RemoveFromLocalPort(Ipv4EndPoint* endPoint);
+
+    /**
+     * \brief Add an end point to the lookup tables.
+     * \param endPoint the end point
+     */
+    void AddToIndex(Ipv4EndPoint* endPoint);
+
+    /**
+     * \brief Remove an end point from the lookup tables.
+     *
+     * The end point calls this function before changing its four-tuple, and
+     * AddToIndex afterwards.
+     *
+     * \param endPoint the end point
+     */
+    void RemoveFromIndex(Ipv4EndPoint* endPoint);
+
+    /**
+     * \brief Check whether an end point matches a packet.
+     *
+     * The end point is assumed to be bound to the destination port.
+     *
+     * \param endP the end point
+     * \param daddr destination address to test
+     * \param saddr source address to test
+     * \param sport source port to test
+     * \param incomingInterface the incoming interface
+     * \return a bitmask with bit n-1 set if the end point matches with priority n,
+     * as defined by Lookup (e.g., bit 3 for a full match)
+     */
+    uint8_t MatchEndPoint(Ipv4EndPoint* endP,
+                          Ipv4Address daddr,
+                          Ipv4Address saddr,
+                          uint16_t sport,
+                          Ptr<Ipv4Interface> incomingInterface) const;
+
     /**
      * \brief Allocate an ephemeral port.
      * \returns the ephemeral port
@@ -196,6 +308,21 @@ class Ipv4EndPointDemux
      * \brief A list of IPv4 end points.
      */
     EndPoints m_endPoints;
+
+    /**
+     * \brief The IPv4 end points, by four-tuple.
+     */
+    std::unordered_map<FourTuple, std::vector<Ipv4EndPoint*>, FourTupleHash> m_fourTuples;
+
+    /**
+     * \brief The position of each IPv4 end point in m_endPoints.
+     */
+    std::unordered_map<Ipv4EndPoint*, EndPointsI> m_positions;
+
+    /**
+     * \brief The IPv4 end points bound to each local port, in the order of allocation.
+     */
+    std::unordered_map<uint16_t, std::vector<Ipv4EndPoint*>> m_localPorts;
 };
 
 } // namespace ns3
@@ -32,6 +32,7 @@ namespace ns3
 {
 
 class Header;
+class Ipv4EndPointDemux;
 class Packet;
 
 /**
@@ -190,6 +191,13 @@ class Ipv4EndPoint
     bool IsRxEnabled() const;
 
   private:
+    friend class Ipv4EndPointDemux;
+
+    /**
+     * \brief The demux indexing the end point (if any).
+     */
+    Ipv4EndPointDemux* m_demux;
+
     /**
      * \brief The local address.
      */
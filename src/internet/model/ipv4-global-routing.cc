@@ -30,6 +30,7 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <vector>
 
@@ -64,7 +65,8 @@ Ipv4GlobalRouting::GetTypeId()
 
 Ipv4GlobalRouting::Ipv4GlobalRouting()
     : m_randomEcmpRouting(false),
-      m_respondToInterfaceEvents(false)
+      m_respondToInterfaceEvents(false),
+      m_routesGeneration(1)
 {
     NS_LOG_FUNCTION(this);
 
@@ -83,6 +85,8 @@ Ipv4GlobalRouting::AddHostRouteTo(Ipv4Address dest, Ipv4Address nextHop, uint32_
     Ipv4RoutingTableEntry* route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateHostRouteTo(dest, nextHop, interface);
     m_hostRoutes.push_back(route);
+    m_hostRoutesIndex.Add(route);
+    m_routesGeneration++;
 }
 
 void
@@ -92,6 +96,8 @@ Ipv4GlobalRouting::AddHostRouteTo(Ipv4Address dest, uint32_t interface)
     Ipv4RoutingTableEntry* route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateHostRouteTo(dest, interface);
     m_hostRoutes.push_back(route);
+    m_hostRoutesIndex.Add(route);
+    m_routesGeneration++;
 }
 
 void
@@ -104,6 +110,8 @@ Ipv4GlobalRouting::AddNetworkRouteTo(Ipv4Address network,
     Ipv4RoutingTableEntry* route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, nextHop, interface);
     m_networkRoutes.push_back(route);
+    m_networkRoutesIndex.Add(route);
+    m_routesGeneration++;
 }
 
 void
@@ -113,6 +121,8 @@ Ipv4GlobalRouting::AddNetworkRouteTo(Ipv4Address network, Ipv4Mask networkMask,
     Ipv4RoutingTableEntry* route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, interface);
     m_networkRoutes.push_back(route);
+    m_networkRoutesIndex.Add(route);
+    m_routesGeneration++;
 }
 
 void
@@ -125,6 +135,8 @@ Ipv4GlobalRouting::AddASExternalRouteTo(Ipv4Address network,
     Ipv4RoutingTableEntry* route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, nextHop, interface);
     m_ASexternalRoutes.push_back(route);
+    m_ASexternalRoutesIndex.Add(route);
+    m_routesGeneration++;
 }
 
 Ptr<Ipv4Route>
@@ -138,66 +150,108 @@ Ipv4GlobalRouting::LookupGlobal(Ipv4Address dest, Ptr<NetDevice> oif)
     RouteVec_t allRoutes;
 
     NS_LOG_LOGIC("Number of m_hostRoutes = " << m_hostRoutes.size());
-    for (HostRoutesCI i = m_hostRoutes.begin(); i != m_hostRoutes.end(); i++)
+    const Ipv4RoutingTableIndex::Routes* hostRoutes = m_hostRoutesIndex.Find(dest, 32);
+    if (hostRoutes)
     {
-        NS_ASSERT((*i)->IsHost());
-        if ((*i)->GetDest() == dest)
+        for (const auto& i : *hostRoutes)
         {
-            if (oif)
+            NS_ASSERT(i.entry->IsHost());
+            if (i.entry->GetDest() == dest)
             {
-                if (oif != m_ipv4->GetNetDevice((*i)->GetInterface()))
+                if (oif)
                 {
-                    NS_LOG_LOGIC("Not on requested interface, skipping");
-                    continue;
+                    if (oif != m_ipv4->GetNetDevice(i.entry->GetInterface()))
+                    {
+                        NS_LOG_LOGIC("Not on requested interface, skipping");
+                        continue;
+                    }
                 }
+                allRoutes.push_back(i.entry);
+                NS_LOG_LOGIC(allRoutes.size() << "Found global host route" << i.entry);
             }
-            allRoutes.push_back(*i);
-            NS_LOG_LOGIC(allRoutes.size() << "Found global host route" << *i);
         }
     }
     if (allRoutes.empty()) // if no host route is found
     {
         NS_LOG_LOGIC("Number of m_networkRoutes" << m_networkRoutes.size());
-        for (NetworkRoutesI j = m_networkRoutes.begin(); j != m_networkRoutes.end(); j++)
+        // all the matching network routes are candidates, regardless of their
+        // prefix length, and they are considered in the order they were added
+        std::vector<Ipv4RoutingTableIndex::Route> matchingRoutes;
+        for (int16_t masklen = 32; masklen >= 0; masklen--)
         {
-            Ipv4Mask mask = (*j)->GetDestNetworkMask();
-            Ipv4Address entry = (*j)->GetDestNetwork();
-            if (mask.IsMatch(dest, entry))
+            const Ipv4RoutingTableIndex::Routes* routes =
+                m_networkRoutesIndex.Find(dest, masklen);
+            if (!routes)
             {
-                if (oif)
+                continue;
+            }
+            for (const auto& j : *routes)
+            {
+                Ipv4Mask mask = j.entry->GetDestNetworkMask();
+                Ipv4Address entry = j.entry->GetDestNetwork();
+                if (mask.IsMatch(dest, entry))
                 {
-                    if (oif != m_ipv4->GetNetDevice((*j)->GetInterface()))
+                    if (oif)
                     {
-                        NS_LOG_LOGIC("Not on requested interface, skipping");
-                        continue;
+                        if (oif != m_ipv4->GetNetDevice(j.entry->GetInterface()))
+                        {
+                            NS_LOG_LOGIC("Not on requested interface, skipping");
+                            continue;
+                        }
                     }
+                    matchingRoutes.push_back(j);
                 }
-                allRoutes.push_back(*j);
-                NS_LOG_LOGIC(allRoutes.size() << "Found global network route" << *j);
             }
         }
+        std::sort(matchingRoutes.begin(),
+                  matchingRoutes.end(),
+                  [](const auto& a, const auto& b) { return a.order < b.order; });
+        for (const auto& j : matchingRoutes)
+        {
+            allRoutes.push_back(j.entry);
+            NS_LOG_LOGIC(allRoutes.size() << "Found global network route" << j.entry);
+        }
     }
     if (allRoutes.empty()) // consider external if no host/network found
     {
-        for (ASExternalRoutesI k = m_ASexternalRoutes.begin(); k != m_ASexternalRoutes.end(); k++)
+        // the first matching external route, in the order they were added
+        const Ipv4RoutingTableIndex::Route* external = nullptr;
+        for (int16_t masklen = 32; masklen >= 0; masklen--)
         {
-            Ipv4Mask mask = (*k)->GetDestNetworkMask();
-            Ipv4Address entry = (*k)->GetDestNetwork();
-            if (mask.IsMatch(dest, entry))
+            const Ipv4RoutingTableIndex::Routes* routes =
+                m_ASexternalRoutesIndex.Find(dest, masklen);
+            if (!routes)
             {
-                NS_LOG_LOGIC("Found external route" << *k);
-                if (oif)
+                continue;
+            }
+            for (const auto& k : *routes)
+            {
+                if (external && k.order > external->order)
                 {
-                    if (oif != m_ipv4->GetNetDevice((*k)->GetInterface()))
+                    break;
+                }
+                Ipv4Mask mask = k.entry->GetDestNetworkMask();
+                Ipv4Address entry = k.entry->GetDestNetwork();
+                if (mask.IsMatch(dest, entry))
+                {
+                    NS_LOG_LOGIC("Found external route" << k.entry);
+                    if (oif)
                     {
-                        NS_LOG_LOGIC("Not on requested interface, skipping");
-                        continue;
+                        if (oif != m_ipv4->GetNetDevice(k.entry->GetInterface()))
+                        {
+                            NS_LOG_LOGIC("Not on requested interface, skipping");
+                            continue;
+                        }
                     }
+                    external = &k;
+                    break;
                 }
-                allRoutes.push_back(*k);
-                break;
             }
         }
+        if (external)
+        {
+            allRoutes.push_back(external->entry);
+        }
     }
     if (!allRoutes.empty()) // if route(s) is found
     {
@@ -297,6 +351,8 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
             if (tmp == index)
             {
                 NS_LOG_LOGIC("Removing route " << index << "; size = " << m_hostRoutes.size());
+                m_hostRoutesIndex.Remove(*i);
+                m_routesGeneration++;
                 delete *i;
                 m_hostRoutes.erase(i);
                 NS_LOG_LOGIC("Done removing host route "
@@ -313,6 +369,8 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
         if (tmp == index)
         {
             NS_LOG_LOGIC("Removing route " << index << "; size = " << m_networkRoutes.size());
+            m_networkRoutesIndex.Remove(*j);
+            m_routesGeneration++;
             delete *j;
             m_networkRoutes.erase(j);
             NS_LOG_LOGIC("Done removing network route "
@@ -328,6 +386,8 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
         if (tmp == index)
         {
             NS_LOG_LOGIC("Removing route " << index << "; size = " << m_ASexternalRoutes.size());
+            m_ASexternalRoutesIndex.Remove(*k);
+            m_routesGeneration++;
             delete *k;
             m_ASexternalRoutes.erase(k);
             NS_LOG_LOGIC("Done removing network route "
@@ -351,6 +411,10 @@ void
 Ipv4GlobalRouting::DoDispose()
 {
     NS_LOG_FUNCTION(this);
+    m_hostRoutesIndex.Clear();
+    m_networkRoutesIndex.Clear();
+    m_ASexternalRoutesIndex.Clear();
+    m_routesGeneration++;
     for (HostRoutesI i = m_hostRoutes.begin(); i != m_hostRoutes.end(); i = m_hostRoutes.erase(i))
     {
         delete (*i);
@@ -533,9 +597,7 @@ Ipv4GlobalRouting::NotifyInterfaceUp(uint32_t i)
     NS_LOG_FUNCTION(this << i);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::UpdateRoutes();
     }
 }
 
@@ -545,9 +607,7 @@ Ipv4GlobalRouting::NotifyInterfaceDown(uint32_t i)
     NS_LOG_FUNCTION(this << i);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::UpdateRoutes();
     }
 }
 
@@ -557,9 +617,7 @@ Ipv4GlobalRouting::NotifyAddAddress(uint32_t interface, Ipv4InterfaceAddress add
     NS_LOG_FUNCTION(this << interface << address);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::UpdateRoutes();
     }
 }
 
@@ -569,12 +627,17 @@ Ipv4GlobalRouting::NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress
     NS_LOG_FUNCTION(this << interface << address);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::UpdateRoutes();
     }
 }
 
+uint64_t
+Ipv4GlobalRouting::GetRoutesGeneration() const
+{
+    // the routes chosen at random among the equal-cost paths can not be cached
+    return m_randomEcmpRouting ? 0 : m_routesGeneration;
+}
+
 void
 Ipv4GlobalRouting::SetIpv4(Ptr<Ipv4> ipv4)
 {
@@ -19,6 +19,8 @@
 #ifndef IPV4_GLOBAL_ROUTING_H
 #define IPV4_GLOBAL_ROUTING_H
 
+#include "ipv4-routing-table-index.h"
+
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv4-header.h"
 #include "ns3/ipv4-routing-protocol.h"
@@ -107,6 +109,7 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
     void SetIpv4(Ptr<Ipv4> ipv4) override;
     void PrintRoutingTable(Ptr<OutputStreamWrapper> stream,
                            Time::Unit unit = Time::S) const override;
+    uint64_t GetRoutesGeneration() const override;
 
     /**
      * \brief Add a host route to the global routing table.
@@ -277,7 +280,12 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
     NetworkRoutes m_networkRoutes;       //!< Routes to networks
     ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
+    Ipv4RoutingTableIndex m_hostRoutesIndex;       //!< Index of the routes to hosts
+    Ipv4RoutingTableIndex m_networkRoutesIndex;    //!< Index of the routes to networks
+    Ipv4RoutingTableIndex m_ASexternalRoutesIndex; //!< Index of the external routes
+
     Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
+    uint64_t m_routesGeneration; //!< generation of the routes, changed each time they change
 };
 
 } // Namespace ns3
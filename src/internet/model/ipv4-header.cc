@@ -42,6 +42,7 @@ Ipv4Header::Ipv4Header()
       m_fragmentOffset(0),
       m_checksum(0),
       m_goodChecksum(true),
+      m_checksumValid(false),
       m_headerSize(5 * 4)
 {
 }
@@ -58,6 +59,7 @@ Ipv4Header::SetPayloadSize(uint16_t size)
 {
     NS_LOG_FUNCTION(this << size);
     m_payloadSize = size;
+    m_checksumValid = false;
 }
 
 uint16_t
@@ -79,6 +81,7 @@ Ipv4Header::SetIdentification(uint16_t identification)
 {
     NS_LOG_FUNCTION(this << identification);
     m_identification = identification;
+    m_checksumValid = false;
 }
 
 void
@@ -86,6 +89,7 @@ Ipv4Header::SetTos(uint8_t tos)
 {
     NS_LOG_FUNCTION(this << static_cast<uint32_t>(tos));
     m_tos = tos;
+    m_checksumValid = false;
 }
 
 void
@@ -94,6 +98,7 @@ Ipv4Header::SetDscp(DscpType dscp)
     NS_LOG_FUNCTION(this << dscp);
     m_tos &= 0x3; // Clear out the DSCP part, retain 2 bits of ECN
     m_tos |= (dscp << 2);
+    m_checksumValid = false;
 }
 
 void
@@ -102,6 +107,7 @@ Ipv4Header::SetEcn(EcnType ecn)
     NS_LOG_FUNCTION(this << ecn);
     m_tos &= 0xFC; // Clear out the ECN part, retain 6 bits of DSCP
     m_tos |= ecn;
+    m_checksumValid = false;
 }
 
 Ipv4Header::DscpType
@@ -204,6 +210,7 @@ Ipv4Header::SetMoreFragments()
 {
     NS_LOG_FUNCTION(this);
     m_flags |= MORE_FRAGMENTS;
+    m_checksumValid = false;
 }
 
 void
@@ -211,6 +218,7 @@ Ipv4Header::SetLastFragment()
 {
     NS_LOG_FUNCTION(this);
     m_flags &= ~MORE_FRAGMENTS;
+    m_checksumValid = false;
 }
 
 bool
@@ -225,6 +233,7 @@ Ipv4Header::SetDontFragment()
 {
     NS_LOG_FUNCTION(this);
     m_flags |= DONT_FRAGMENT;
+    m_checksumValid = false;
 }
 
 void
@@ -232,6 +241,7 @@ Ipv4Header::SetMayFragment()
 {
     NS_LOG_FUNCTION(this);
     m_flags &= ~DONT_FRAGMENT;
+    m_checksumValid = false;
 }
 
 bool
@@ -248,6 +258,7 @@ Ipv4Header::SetFragmentOffset(uint16_t offsetBytes)
     // check if the user is trying to set an invalid offset
     NS_ABORT_MSG_IF((offsetBytes & 0x7), "offsetBytes must be multiple of 8 bytes");
     m_fragmentOffset = offsetBytes;
+    m_checksumValid = false;
 }
 
 uint16_t
@@ -267,6 +278,22 @@ void
 Ipv4Header::SetTtl(uint8_t ttl)
 {
     NS_LOG_FUNCTION(this << static_cast<uint32_t>(ttl));
+    if (m_checksumValid)
+    {
+        // Incremental update of the checksum, see RFC 1624, eqn. 3:
+        // HC' = ~(~HC + ~m + m'), where m is the 16-bit word holding
+        // the TTL and the protocol
+        uint16_t oldWord = m_ttl | (m_protocol << 8);
+        uint16_t newWord = ttl | (m_protocol << 8);
+        uint32_t sum = static_cast<uint16_t>(~m_checksum);
+        sum += static_cast<uint16_t>(~oldWord);
+        sum += newWord;
+        while (sum >> 16)
+        {
+            sum = (sum & 0xffff) + (sum >> 16);
+        }
+        m_checksum = ~sum;
+    }
     m_ttl = ttl;
 }
 
@@ -289,6 +316,7 @@ Ipv4Header::SetProtocol(uint8_t protocol)
 {
     NS_LOG_FUNCTION(this << static_cast<uint32_t>(protocol));
     m_protocol = protocol;
+    m_checksumValid = false;
 }
 
 void
@@ -296,6 +324,7 @@ Ipv4Header::SetSource(Ipv4Address source)
 {
     NS_LOG_FUNCTION(this << source);
     m_source = source;
+    m_checksumValid = false;
 }
 
 Ipv4Address
@@ -310,6 +339,7 @@ Ipv4Header::SetDestination(Ipv4Address dst)
 {
     NS_LOG_FUNCTION(this << dst);
     m_destination = dst;
+    m_checksumValid = false;
 }
 
 Ipv4Address
@@ -420,8 +450,12 @@ Ipv4Header::Serialize(Buffer::Iterator start) const
 
     if (m_calcChecksum)
     {
-        i = start;
-        uint16_t checksum = i.CalculateIpChecksum(20);
+        uint16_t checksum = m_checksum;
+        if (!m_checksumValid)
+        {
+            i = start;
+            checksum = i.CalculateIpChecksum(20);
+        }
         NS_LOG_LOGIC("checksum=" << checksum);
         i = start;
         i.Next(10);
@@ -480,6 +514,9 @@ Ipv4Header::Deserialize(Buffer::Iterator start)
 
         m_goodChecksum = (checksum == 0);
     }
+    // the checksum can be updated incrementally only if it covers the
+    // same bytes that Serialize writes, i.e., there are no options
+    m_checksumValid = m_calcChecksum && m_goodChecksum && headerSize == 5 * 4;
     return GetSerializedSize();
 }
 
@@ -148,6 +148,12 @@ class Ipv4Header : public Header
      */
     void SetFragmentOffset(uint16_t offsetBytes);
     /**
+     * \brief Set the TTL
+     *
+     * If the header has been deserialized with a correct checksum, the
+     * checksum is updated incrementally (RFC 1624), so that decrementing
+     * the TTL of a forwarded packet does not require to compute it again.
+     *
      * \param ttl the ipv4 TTL
      */
     void SetTtl(uint8_t ttl);
@@ -262,6 +268,7 @@ class Ipv4Header : public Header
     Ipv4Address m_destination; //!< destination address
     uint16_t m_checksum;       //!< checksum
     bool m_goodChecksum;       //!< true if checksum is correct
+    bool m_checksumValid;      //!< true if m_checksum matches the header fields
     uint16_t m_headerSize;     //!< IP header size
 };
 
@@ -26,12 +26,15 @@
 #include "ipv4-interface.h"
 #include "ipv4-raw-socket-impl.h"
 #include "ipv4-route.h"
+#include "ipv4-queue-disc-item.h"
 #include "loopback-net-device.h"
 
 #include "ns3/boolean.h"
 #include "ns3/callback.h"
+#include "ns3/gso-tag.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/log.h"
+#include "ns3/net-device-queue-interface.h"
 #include "ns3/net-device.h"
 #include "ns3/node.h"
 #include "ns3/object-vector.h"
@@ -820,7 +823,12 @@ Ipv4L3Protocol::Send(Ptr<Packet> packet,
         // 1b) with a valid gateway
         NS_LOG_LOGIC("Ipv4L3Protocol::Send case 1b:  passed in with route and valid gateway");
         int32_t interface = GetInterfaceForDevice(route->GetOutputDevice());
-        m_sendOutgoingTrace(ipHeader, packet, interface);
+        // The trace is fired for the segments of a super-segment when it is split
+        GsoTag gsoTag;
+        if (!packet->PeekPacketTag(gsoTag))
+        {
+            m_sendOutgoingTrace(ipHeader, packet, interface);
+        }
         if (m_enableDpd && ipHeader.GetDestination().IsMulticast())
         {
             UpdateDuplicate(packet, ipHeader);
@@ -1015,6 +1023,46 @@ Ipv4L3Protocol::SendRealOut(Ptr<Ipv4Route> route, Ptr<Packet> packet, const Ipv4
     if (outInterface->IsUp())
     {
         NS_LOG_LOGIC("Send to " << targetLabel << " " << target);
+        GsoTag gsoTag;
+        if (packet->PeekPacketTag(gsoTag))
+        {
+            // A super-segment gets one identification per segment
+            uint32_t payloadSize = packet->GetSize() - gsoTag.GetHeaderSize();
+            uint32_t nSegments = (payloadSize - 1) / gsoTag.GetSegmentSize() + 1;
+            uint64_t src = ipHeader.GetSource().Get();
+            uint64_t dst = ipHeader.GetDestination().Get();
+            uint64_t srcDst = dst | (src << 32);
+            m_identification[std::make_pair(srcDst, ipHeader.GetProtocol())] += nSegments - 1;
+
+            // It crosses the traffic control layer as a single packet and is
+            // split by the device queue interface, unless its segments need to
+            // be fragmented or do not go through the traffic control layer
+            Ptr<NetDeviceQueueInterface> ndqi = outDev->GetObject<NetDeviceQueueInterface>();
+            bool local = false;
+            for (uint32_t i = 0; i < outInterface->GetNAddresses(); i++)
+            {
+                local = local || outInterface->GetAddress(i).GetLocal() == target;
+            }
+            if (ndqi && !local &&
+                gsoTag.GetHeaderSize() + gsoTag.GetSegmentSize() + ipHeader.GetSerializedSize() <=
+                    outDev->GetMtu())
+            {
+                if (!ndqi->HasGsoCallback(PROT_NUMBER))
+                {
+                    ndqi->SetGsoCallback(PROT_NUMBER, [this, interface](Ptr<QueueDiscItem> item) {
+                        return SegmentGsoItem(item, interface);
+                    });
+                }
+                outInterface->Send(packet, ipHeader, target);
+                return;
+            }
+            for (const auto& [segment, segmentHeader] : SegmentGso(packet, ipHeader))
+            {
+                m_sendOutgoingTrace(segmentHeader, segment, interface);
+                SendRealOut(route, segment, segmentHeader);
+            }
+            return;
+        }
         if (packet->GetSize() + ipHeader.GetSerializedSize() > outInterface->GetDevice()->GetMtu())
         {
             std::list<Ipv4PayloadHeaderPair> listFragments;
@@ -1036,6 +1084,56 @@ Ipv4L3Protocol::SendRealOut(Ptr<Ipv4Route> route, Ptr<Packet> packet, const Ipv4
     }
 }
 
+std::vector<Ipv4L3Protocol::Ipv4PayloadHeaderPair>
+Ipv4L3Protocol::SegmentGso(Ptr<Packet> packet, const Ipv4Header& ipHeader) const
+{
+    NS_LOG_FUNCTION(this << packet << ipHeader);
+
+    Ptr<Packet> superSegment = packet->Copy();
+    GsoTag gsoTag;
+    superSegment->RemovePacketTag(gsoTag);
+    Ptr<IpL4Protocol> protocol = GetProtocol(ipHeader.GetProtocol());
+    NS_ASSERT_MSG(protocol, "No protocol to split the super-segment " << packet);
+
+    std::vector<Ipv4PayloadHeaderPair> segments;
+    uint16_t identification = ipHeader.GetIdentification();
+    for (const auto& segment : protocol->SegmentGso(superSegment,
+                                                    gsoTag.GetSegmentSize(),
+                                                    ipHeader.GetSource(),
+                                                    ipHeader.GetDestination()))
+    {
+        Ipv4Header segmentHeader = ipHeader;
+        segmentHeader.SetIdentification(identification++);
+        segmentHeader.SetPayloadSize(segment->GetSize());
+        segments.emplace_back(segment, segmentHeader);
+    }
+    return segments;
+}
+
+std::vector<Ptr<QueueDiscItem>>
+Ipv4L3Protocol::SegmentGsoItem(Ptr<QueueDiscItem> item, uint32_t interface)
+{
+    NS_LOG_FUNCTION(this << item << interface);
+
+    Ptr<Ipv4QueueDiscItem> ipv4Item = DynamicCast<Ipv4QueueDiscItem>(item);
+    NS_ASSERT_MSG(ipv4Item, "The super-segment " << item << " is not an IPv4 packet");
+
+    std::vector<Ptr<QueueDiscItem>> items;
+    for (const auto& [segment, segmentHeader] :
+         SegmentGso(ipv4Item->GetPacket(), ipv4Item->GetHeader()))
+    {
+        m_sendOutgoingTrace(segmentHeader, segment, interface);
+        CallTxTrace(segmentHeader, segment, this, interface);
+        Ptr<QueueDiscItem> segmentItem = Create<Ipv4QueueDiscItem>(segment,
+                                                                   item->GetAddress(),
+                                                                   item->GetProtocol(),
+                                                                   segmentHeader);
+        segmentItem->SetTxQueueIndex(item->GetTxQueueIndex());
+        items.push_back(segmentItem);
+    }
+    return items;
+}
+
 // This function analogous to Linux ip_mr_forward()
 void
 Ipv4L3Protocol::IpMulticastForward(Ptr<Ipv4MulticastRoute> mrtentry,
@@ -52,6 +52,7 @@ class Socket;
 class Ipv4RawSocketImpl;
 class IpL4Protocol;
 class Icmpv4L4Protocol;
+class QueueDiscItem;
 
 /**
  * \ingroup ipv4
@@ -411,6 +412,27 @@ class Ipv4L3Protocol : public Ipv4
                          uint32_t outIfaceMtu,
                          std::list<Ipv4PayloadHeaderPair>& listFragments);
 
+    /**
+     * \brief Split a super-segment into the segments it carries
+     * \param packet the super-segment, with its transport header and its GsoTag
+     * \param ipHeader the IPv4 header of the super-segment
+     * \return the segments and their IPv4 headers, with consecutive identifications
+     */
+    std::vector<Ipv4PayloadHeaderPair> SegmentGso(Ptr<Packet> packet,
+                                                  const Ipv4Header& ipHeader) const;
+
+    /**
+     * \brief Split a super-segment leaving the traffic control layer
+     *
+     * This is the GSO callback set on the NetDeviceQueueInterface of the output
+     * devices. The "SendOutgoing" and "Tx" traces are fired for each segment.
+     *
+     * \param item the Ipv4QueueDiscItem of the super-segment, without its header
+     * \param interface the IP-level interface index
+     * \return the items of the segments
+     */
+    std::vector<Ptr<QueueDiscItem>> SegmentGsoItem(Ptr<QueueDiscItem> item, uint32_t interface);
+
     /**
      * \brief Process a packet fragment
      * \param packet the packet
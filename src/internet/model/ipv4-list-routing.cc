@@ -21,6 +21,7 @@
 #include "ipv4-route.h"
 #include "ipv4.h"
 
+#include "ns3/boolean.h"
 #include "ns3/log.h"
 #include "ns3/node.h"
 
@@ -34,15 +35,25 @@ NS_OBJECT_ENSURE_REGISTERED(Ipv4ListRouting);
 TypeId
 Ipv4ListRouting::GetTypeId()
 {
-    static TypeId tid = TypeId("ns3::Ipv4ListRouting")
-                            .SetParent<Ipv4RoutingProtocol>()
-                            .SetGroupName("Internet")
-                            .AddConstructor<Ipv4ListRouting>();
+    static TypeId tid =
+        TypeId("ns3::Ipv4ListRouting")
+            .SetParent<Ipv4RoutingProtocol>()
+            .SetGroupName("Internet")
+            .AddConstructor<Ipv4ListRouting>()
+            .AddAttribute("RouteCache",
+                          "Cache the routes found by the routing protocols, "
+                          "if they all support it.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&Ipv4ListRouting::m_routeCacheEnabled),
+                          MakeBooleanChecker());
     return tid;
 }
 
 Ipv4ListRouting::Ipv4ListRouting()
-    : m_ipv4(nullptr)
+    : m_ipv4(nullptr),
+      m_routeCacheEnabled(false),
+      m_generation(1),
+      m_routeCacheGeneration(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -66,6 +77,8 @@ Ipv4ListRouting::DoDispose()
         (*rprotoIter).second = nullptr;
     }
     m_routingProtocols.clear();
+    m_outputRoutes.clear();
+    m_forwardRoutes.clear();
     m_ipv4 = nullptr;
 }
 
@@ -108,6 +121,32 @@ Ipv4ListRouting::RouteOutput(Ptr<Packet> p,
                              Socket::SocketErrno& sockerr)
 {
     NS_LOG_FUNCTION(this << p << header.GetDestination() << header.GetSource() << oif << sockerr);
+    if (!RefreshRouteCache())
+    {
+        return LookupRouteOutput(p, header, oif, sockerr);
+    }
+
+    RouteCacheKey key{header.GetDestination(), header.GetTos(), oif};
+    auto it = m_outputRoutes.find(key);
+    if (it == m_outputRoutes.end())
+    {
+        it = m_outputRoutes.emplace(key, LookupRouteOutput(p, header, oif, sockerr)).first;
+    }
+    else
+    {
+        NS_LOG_LOGIC("Found cached route " << it->second);
+    }
+    sockerr = it->second ? Socket::ERROR_NOTERROR : Socket::ERROR_NOROUTETOHOST;
+    return it->second;
+}
+
+Ptr<Ipv4Route>
+Ipv4ListRouting::LookupRouteOutput(Ptr<Packet> p,
+                                   const Ipv4Header& header,
+                                   Ptr<NetDevice> oif,
+                                   Socket::SocketErrno& sockerr)
+{
+    NS_LOG_FUNCTION(this << p << header.GetDestination() << oif);
     Ptr<Ipv4Route> route;
 
     for (Ipv4RoutingProtocolList::const_iterator i = m_routingProtocols.begin();
@@ -167,7 +206,8 @@ Ipv4ListRouting::RouteInput(Ptr<const Packet> p,
             return true;
         }
     }
-    // Check if input device supports IP forwarding
+    // Check if input device supports IP forwarding, before the route cache
+    // lookup: the cached routes do not depend on the forwarding state
     if (!m_ipv4->IsForwarding(iif))
     {
         NS_LOG_LOGIC("Forwarding disabled for this interface");
@@ -182,14 +222,44 @@ Ipv4ListRouting::RouteInput(Ptr<const Packet> p,
     {
         downstreamLcb = MakeNullCallback<void, Ptr<const Packet>, const Ipv4Header&, uint32_t>();
     }
+    // The unicast routes are cached, and recorded on their way to the
+    // forwarding callback on a cache miss
+    UnicastForwardCallback downstreamUcb = ucb;
+    RouteCacheKey key{header.GetDestination(), header.GetTos(), idev};
+    bool cacheRoute = !retVal && !header.GetDestination().IsMulticast() &&
+                      !header.GetDestination().IsBroadcast() && RefreshRouteCache();
+    if (cacheRoute)
+    {
+        auto it = m_forwardRoutes.find(key);
+        if (it != m_forwardRoutes.end())
+        {
+            NS_LOG_LOGIC("Found cached route " << it->second << " to forward packet");
+            ucb(it->second, p, header);
+            return true;
+        }
+        downstreamUcb = MakeCallback(&Ipv4ListRouting::RecordForwardRoute, this);
+    }
     for (Ipv4RoutingProtocolList::const_iterator rprotoIter = m_routingProtocols.begin();
          rprotoIter != m_routingProtocols.end();
          rprotoIter++)
     {
-        if ((*rprotoIter).second->RouteInput(p, header, idev, ucb, mcb, downstreamLcb, ecb))
+        if ((*rprotoIter).second->RouteInput(p,
+                                             header,
+                                             idev,
+                                             downstreamUcb,
+                                             mcb,
+                                             downstreamLcb,
+                                             ecb))
         {
             NS_LOG_LOGIC("Route found to forward packet in protocol "
                          << (*rprotoIter).second->GetInstanceTypeId().GetName());
+            if (m_forwardRoute)
+            {
+                Ptr<Ipv4Route> route = m_forwardRoute;
+                m_forwardRoute = nullptr;
+                m_forwardRoutes.emplace(key, route);
+                ucb(route, p, header);
+            }
             return true;
         }
     }
@@ -197,10 +267,20 @@ Ipv4ListRouting::RouteInput(Ptr<const Packet> p,
     return retVal;
 }
 
+void
+Ipv4ListRouting::RecordForwardRoute(Ptr<Ipv4Route> route,
+                                    Ptr<const Packet> p,
+                                    const Ipv4Header& header)
+{
+    NS_LOG_FUNCTION(this << route << p << header);
+    m_forwardRoute = route;
+}
+
 void
 Ipv4ListRouting::NotifyInterfaceUp(uint32_t interface)
 {
     NS_LOG_FUNCTION(this << interface);
+    m_generation++;
     for (Ipv4RoutingProtocolList::const_iterator rprotoIter = m_routingProtocols.begin();
          rprotoIter != m_routingProtocols.end();
          rprotoIter++)
@@ -213,6 +293,7 @@ void
 Ipv4ListRouting::NotifyInterfaceDown(uint32_t interface)
 {
     NS_LOG_FUNCTION(this << interface);
+    m_generation++;
     for (Ipv4RoutingProtocolList::const_iterator rprotoIter = m_routingProtocols.begin();
          rprotoIter != m_routingProtocols.end();
          rprotoIter++)
@@ -225,6 +306,7 @@ void
 Ipv4ListRouting::NotifyAddAddress(uint32_t interface, Ipv4InterfaceAddress address)
 {
     NS_LOG_FUNCTION(this << interface << address);
+    m_generation++;
     for (Ipv4RoutingProtocolList::const_iterator rprotoIter = m_routingProtocols.begin();
          rprotoIter != m_routingProtocols.end();
          rprotoIter++)
@@ -237,6 +319,7 @@ void
 Ipv4ListRouting::NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress address)
 {
     NS_LOG_FUNCTION(this << interface << address);
+    m_generation++;
     for (Ipv4RoutingProtocolList::const_iterator rprotoIter = m_routingProtocols.begin();
          rprotoIter != m_routingProtocols.end();
          rprotoIter++)
@@ -257,6 +340,42 @@ Ipv4ListRouting::SetIpv4(Ptr<Ipv4> ipv4)
         (*rprotoIter).second->SetIpv4(ipv4);
     }
     m_ipv4 = ipv4;
+    m_generation++;
+}
+
+uint64_t
+Ipv4ListRouting::GetRoutesGeneration() const
+{
+    // the generations only increase, hence their sum changes with any of them
+    uint64_t generation = m_generation;
+    for (const auto& protocol : m_routingProtocols)
+    {
+        uint64_t protocolGeneration = protocol.second->GetRoutesGeneration();
+        if (protocolGeneration == 0)
+        {
+            return 0;
+        }
+        generation += protocolGeneration;
+    }
+    return generation;
+}
+
+bool
+Ipv4ListRouting::RefreshRouteCache()
+{
+    if (!m_routeCacheEnabled)
+    {
+        return false;
+    }
+    uint64_t generation = GetRoutesGeneration();
+    if (generation != m_routeCacheGeneration)
+    {
+        NS_LOG_LOGIC("Flushing the route cache");
+        m_outputRoutes.clear();
+        m_forwardRoutes.clear();
+        m_routeCacheGeneration = generation;
+    }
+    return generation != 0;
 }
 
 void
@@ -269,6 +388,7 @@ Ipv4ListRouting::AddRoutingProtocol(Ptr<Ipv4RoutingProtocol> routingProtocol, in
     {
         routingProtocol->SetIpv4(m_ipv4);
     }
+    m_generation++;
 }
 
 uint32_t
@@ -301,6 +421,20 @@ Ipv4ListRouting::GetRoutingProtocol(uint32_t index, int16_t& priority) const
     return nullptr;
 }
 
+bool
+Ipv4ListRouting::RouteCacheKey::operator==(const RouteCacheKey& other) const
+{
+    return destination == other.destination && tos == other.tos && dev == other.dev;
+}
+
+size_t
+Ipv4ListRouting::RouteCacheKeyHash::operator()(const RouteCacheKey& key) const
+{
+    uint64_t destination = (uint64_t(key.destination.Get()) << 8) | key.tos;
+    return std::hash<uint64_t>()(destination) ^
+           std::hash<const NetDevice*>()(PeekPointer(key.dev));
+}
+
 bool
 Ipv4ListRouting::Compare(const Ipv4RoutingProtocolEntry& a, const Ipv4RoutingProtocolEntry& b)
 {
@@ -23,6 +23,7 @@
 #include "ns3/simulator.h"
 
 #include <list>
+#include <unordered_map>
 
 namespace ns3
 {
@@ -41,6 +42,14 @@ namespace ns3
  * The order by which routing protocols with the same priority value
  * are consulted is undefined.
  *
+ * If the RouteCache attribute is set and all the routing protocols in
+ * the list support it (see Ipv4RoutingProtocol::GetRoutesGeneration),
+ * the routes returned by RouteOutput and the unicast routes passed to the
+ * forwarding callback of RouteInput are cached by destination, TOS and
+ * interface, so that the packets of steady flows skip the lookups in the
+ * routing protocols.  The cache is flushed each time the routes of a
+ * protocol, or the interfaces and addresses of the node, change.
+ *
  */
 class Ipv4ListRouting : public Ipv4RoutingProtocol
 {
@@ -99,6 +108,7 @@ class Ipv4ListRouting : public Ipv4RoutingProtocol
     void SetIpv4(Ptr<Ipv4> ipv4) override;
     void PrintRoutingTable(Ptr<OutputStreamWrapper> stream,
                            Time::Unit unit = Time::S) const override;
+    uint64_t GetRoutesGeneration() const override;
 
   protected:
     void DoDispose() override;
@@ -122,7 +132,79 @@ class Ipv4ListRouting : public Ipv4RoutingProtocol
      * \return true if they are the same, false otherwise
      */
     static bool Compare(const Ipv4RoutingProtocolEntry& a, const Ipv4RoutingProtocolEntry& b);
-    Ptr<Ipv4> m_ipv4; //!< Ipv4 this protocol is associated with.
+
+    /**
+     * \brief Look for a route in the routing protocols, from the highest to
+     * the lowest priority.
+     * \param p packet to be routed
+     * \param header input parameter (used to form key to search for the route)
+     * \param oif Output interface Netdevice.  May be zero, or may be bound via
+     *            socket options to a particular output interface.
+     * \param sockerr Output parameter; socket errno
+     * \returns a code that indicates what happened in the lookup
+     */
+    Ptr<Ipv4Route> LookupRouteOutput(Ptr<Packet> p,
+                                     const Ipv4Header& header,
+                                     Ptr<NetDevice> oif,
+                                     Socket::SocketErrno& sockerr);
+
+    /**
+     * \brief Flush the route cache if the routes changed since it was filled.
+     * \return true if the routes can be cached
+     */
+    bool RefreshRouteCache();
+
+    /**
+     * \brief Record the route passed to the unicast forwarding callback by a
+     * routing protocol, to cache it.
+     * \param route the route
+     * \param p the packet
+     * \param header the IPv4 header of the packet
+     */
+    void RecordForwardRoute(Ptr<Ipv4Route> route, Ptr<const Packet> p, const Ipv4Header& header);
+
+    /**
+     * \brief The key of the cached routes.
+     */
+    struct RouteCacheKey
+    {
+        Ipv4Address destination;  //!< the destination address
+        uint8_t tos;              //!< the TOS
+        Ptr<const NetDevice> dev; //!< the output (or input, when forwarding) device, if any
+
+        /**
+         * \brief Equality operator.
+         * \param other the key to compare to
+         * \returns true if the keys are equal
+         */
+        bool operator==(const RouteCacheKey& other) const;
+    };
+
+    /**
+     * \brief Hash function class for the keys of the cached routes.
+     */
+    struct RouteCacheKeyHash
+    {
+        /**
+         * \brief Returns the hash of a key.
+         * \param key the key
+         * \returns the hash of the key
+         */
+        size_t operator()(const RouteCacheKey& key) const;
+    };
+
+    /**
+     * \brief Container of the cached routes.
+     */
+    typedef std::unordered_map<RouteCacheKey, Ptr<Ipv4Route>, RouteCacheKeyHash> RouteCache;
+
+    Ptr<Ipv4> m_ipv4;                //!< Ipv4 this protocol is associated with.
+    bool m_routeCacheEnabled;        //!< Whether the routes are cached.
+    uint64_t m_generation;           //!< Generation of the interfaces and of the list.
+    uint64_t m_routeCacheGeneration; //!< Generation of the routes in the cache.
+    RouteCache m_outputRoutes;       //!< Cached routes of RouteOutput.
+    RouteCache m_forwardRoutes;      //!< Cached forwarding routes of RouteInput.
+    Ptr<Ipv4Route> m_forwardRoute;   //!< Route recorded by RecordForwardRoute.
 };
 
 } // namespace ns3
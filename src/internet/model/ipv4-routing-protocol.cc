@@ -35,4 +35,10 @@ Ipv4RoutingProtocol::GetTypeId()
     return tid;
 }
 
+uint64_t
+Ipv4RoutingProtocol::GetRoutesGeneration() const
+{
+    return 0;
+}
+
 } // namespace ns3
@@ -0,0 +1,101 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ipv4-routing-table-index.h"
+
+#include "ipv4-routing-table-entry.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("Ipv4RoutingTableIndex");
+
+Ipv4RoutingTableIndex::Ipv4RoutingTableIndex()
+    : m_prefixLengths(0),
+      m_nextOrder(0)
+{
+}
+
+uint32_t
+Ipv4RoutingTableIndex::PrefixMask(uint8_t prefixLength)
+{
+    return prefixLength == 0 ? 0 : 0xffffffff << (32 - prefixLength);
+}
+
+void
+Ipv4RoutingTableIndex::Add(Ipv4RoutingTableEntry* entry, uint32_t metric)
+{
+    NS_LOG_FUNCTION(this << entry << metric);
+    uint8_t prefixLength = entry->GetDestNetworkMask().GetPrefixLength();
+    uint32_t prefix = entry->GetDestNetwork().Get() & PrefixMask(prefixLength);
+    m_routes[prefixLength][prefix].push_back({entry, metric, m_nextOrder++});
+    m_prefixLengths |= (uint64_t(1) << prefixLength);
+}
+
+void
+Ipv4RoutingTableIndex::Remove(const Ipv4RoutingTableEntry* entry)
+{
+    NS_LOG_FUNCTION(this << entry);
+    uint8_t prefixLength = entry->GetDestNetworkMask().GetPrefixLength();
+    uint32_t prefix = entry->GetDestNetwork().Get() & PrefixMask(prefixLength);
+    auto& prefixes = m_routes[prefixLength];
+    auto it = prefixes.find(prefix);
+    NS_ASSERT_MSG(it != prefixes.end(), "Route not found in the index");
+    auto& routes = it->second;
+    auto routeIt = std::find_if(routes.begin(), routes.end(), [entry](const Route& route) {
+        return route.entry == entry;
+    });
+    NS_ASSERT_MSG(routeIt != routes.end(), "Route not found in the index");
+    routes.erase(routeIt);
+    if (routes.empty())
+    {
+        prefixes.erase(it);
+        if (prefixes.empty())
+        {
+            m_prefixLengths &= ~(uint64_t(1) << prefixLength);
+        }
+    }
+}
+
+void
+Ipv4RoutingTableIndex::Clear()
+{
+    NS_LOG_FUNCTION(this);
+    for (auto& prefixes : m_routes)
+    {
+        prefixes.clear();
+    }
+    m_prefixLengths = 0;
+}
+
+const Ipv4RoutingTableIndex::Routes*
+Ipv4RoutingTableIndex::Find(Ipv4Address dest, uint8_t prefixLength) const
+{
+    NS_ASSERT(prefixLength <= 32);
+    if ((m_prefixLengths & (uint64_t(1) << prefixLength)) == 0)
+    {
+        return nullptr;
+    }
+    const auto& prefixes = m_routes[prefixLength];
+    auto it = prefixes.find(dest.Get() & PrefixMask(prefixLength));
+    return it == prefixes.end() ? nullptr : &it->second;
+}
+
+} // namespace ns3
@@ -0,0 +1,109 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef IPV4_ROUTING_TABLE_INDEX_H
+#define IPV4_ROUTING_TABLE_INDEX_H
+
+#include "ns3/ipv4-address.h"
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+class Ipv4RoutingTableEntry;
+
+/**
+ * \ingroup ipv4Routing
+ *
+ * \brief Index of the unicast routes of Ipv4GlobalRouting and
+ * Ipv4StaticRouting by destination prefix.
+ *
+ * The routes are grouped by prefix length (the number of leading ones of
+ * their network mask) and, for each prefix length, kept in a hash table
+ * keyed by the destination prefix. A lookup probes only the prefix lengths
+ * which are in use, hence its cost does not depend on the number of routes.
+ *
+ * The routes sharing the same prefix are kept in the order in which they
+ * were added, and each route carries a sequence number, so that the routing
+ * protocols can return the same route they would find by scanning their
+ * route lists. The index does not own the routes.
+ */
+class Ipv4RoutingTableIndex
+{
+  public:
+    /// A route stored in the index
+    struct Route
+    {
+        Ipv4RoutingTableEntry* entry; //!< the routing table entry
+        uint32_t metric;              //!< the metric of the route
+        uint64_t order;               //!< sequence number, increasing with insertion
+    };
+
+    /// The routes sharing the same destination prefix, in insertion order
+    typedef std::vector<Route> Routes;
+
+    Ipv4RoutingTableIndex();
+
+    /**
+     * Add a route to the index
+     * \param entry the routing table entry
+     * \param metric the metric of the route
+     */
+    void Add(Ipv4RoutingTableEntry* entry, uint32_t metric = 0);
+
+    /**
+     * Remove a route from the index. The route must be removed before being
+     * deleted.
+     * \param entry the routing table entry
+     */
+    void Remove(const Ipv4RoutingTableEntry* entry);
+
+    /**
+     * Remove all the routes from the index
+     */
+    void Clear();
+
+    /**
+     * Get the routes with the given prefix length whose prefix covers an address.
+     *
+     * Only the leading ones of the network mask are used to index a route,
+     * hence the caller has to check the full mask (Ipv4Mask::IsMatch) of the
+     * returned routes if non-contiguous masks are possible.
+     *
+     * \param dest the address
+     * \param prefixLength the prefix length
+     * \return the routes, or nullptr if there are none
+     */
+    const Routes* Find(Ipv4Address dest, uint8_t prefixLength) const;
+
+  private:
+    /**
+     * \param prefixLength the prefix length
+     * \return the network mask corresponding to the prefix length
+     */
+    static uint32_t PrefixMask(uint8_t prefixLength);
+
+    /// the routes, per prefix length and destination prefix
+    std::array<std::unordered_map<uint32_t, Routes>, 33> m_routes;
+    uint64_t m_prefixLengths; //!< bitmap of the prefix lengths in use
+    uint64_t m_nextOrder;     //!< sequence number of the next route added
+};
+
+} // namespace ns3
+
+#endif /* IPV4_ROUTING_TABLE_INDEX_H */
@@ -58,7 +58,8 @@ Ipv4StaticRouting::GetTypeId()
 }
 
 Ipv4StaticRouting::Ipv4StaticRouting()
-    : m_ipv4(nullptr)
+    : m_ipv4(nullptr),
+      m_routesGeneration(1)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -80,6 +81,8 @@ Ipv4StaticRouting::AddNetworkRouteTo(Ipv4Address network,
     {
         Ipv4RoutingTableEntry* routePtr = new Ipv4RoutingTableEntry(route);
         m_networkRoutes.emplace_back(routePtr, metric);
+        m_networkRoutesIndex.Add(routePtr, metric);
+        m_routesGeneration++;
     }
 }
 
@@ -98,6 +101,8 @@ Ipv4StaticRouting::AddNetworkRouteTo(Ipv4Address network,
         Ipv4RoutingTableEntry* routePtr = new Ipv4RoutingTableEntry(route);
 
         m_networkRoutes.emplace_back(routePtr, metric);
+        m_networkRoutesIndex.Add(routePtr, metric);
+        m_routesGeneration++;
     }
 }
 
@@ -139,6 +144,7 @@ Ipv4StaticRouting::AddMulticastRoute(Ipv4Address origin,
                                                                   inputInterface,
                                                                   outputInterfaces);
     m_multicastRoutes.push_back(route);
+    m_routesGeneration++;
 }
 
 // default multicast routes are stored as a network route
@@ -153,6 +159,8 @@ Ipv4StaticRouting::SetDefaultMulticastRoute(uint32_t outputInterface)
     Ipv4Mask networkMask = Ipv4Mask("240.0.0.0");
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, outputInterface);
     m_networkRoutes.emplace_back(route, 0);
+    m_networkRoutesIndex.Add(route, 0);
+    m_routesGeneration++;
 }
 
 uint32_t
@@ -198,6 +206,7 @@ Ipv4StaticRouting::RemoveMulticastRoute(Ipv4Address origin,
         {
             delete *i;
             m_multicastRoutes.erase(i);
+            m_routesGeneration++;
             return true;
         }
     }
@@ -215,6 +224,7 @@ Ipv4StaticRouting::RemoveMulticastRoute(uint32_t index)
         {
             delete *i;
             m_multicastRoutes.erase(i);
+            m_routesGeneration++;
             return;
         }
         tmp++;
@@ -224,14 +234,20 @@ Ipv4StaticRouting::RemoveMulticastRoute(uint32_t index)
 bool
 Ipv4StaticRouting::LookupRoute(const Ipv4RoutingTableEntry& route, uint32_t metric)
 {
-    for (NetworkRoutesI j = m_networkRoutes.begin(); j != m_networkRoutes.end(); j++)
+    const Ipv4RoutingTableIndex::Routes* routes =
+        m_networkRoutesIndex.Find(route.GetDest(), route.GetDestNetworkMask().GetPrefixLength());
+    if (!routes)
+    {
+        return false;
+    }
+    for (const auto& j : *routes)
     {
-        Ipv4RoutingTableEntry* rtentry = j->first;
+        Ipv4RoutingTableEntry* rtentry = j.entry;
 
         if (rtentry->GetDest() == route.GetDest() &&
             rtentry->GetDestNetworkMask() == route.GetDestNetworkMask() &&
             rtentry->GetGateway() == route.GetGateway() &&
-            rtentry->GetInterface() == route.GetInterface() && j->second == metric)
+            rtentry->GetInterface() == route.GetInterface() && j.metric == metric)
         {
             return true;
         }
@@ -244,8 +260,6 @@ Ipv4StaticRouting::LookupStatic(Ipv4Address dest, Ptr<NetDevice> oif)
 {
     NS_LOG_FUNCTION(this << dest << " " << oif);
     Ptr<Ipv4Route> rtentry = nullptr;
-    uint16_t longest_mask = 0;
-    uint32_t shortest_metric = 0xffffffff;
     /* when sending on local multicast, there have to be interface specified */
     if (dest.IsLocalMulticast())
     {
@@ -261,19 +275,31 @@ Ipv4StaticRouting::LookupStatic(Ipv4Address dest, Ptr<NetDevice> oif)
         return rtentry;
     }
 
-    for (NetworkRoutesI i = m_networkRoutes.begin(); i != m_networkRoutes.end(); i++)
+    // Probe the prefix lengths from the longest to the shortest. Among the
+    // routes with the longest matching prefix, pick the one with the lowest
+    // metric (the last one added, in case of ties), except for host routes,
+    // for which the first one added is used.
+    for (int16_t masklen = 32; masklen >= 0 && !rtentry; masklen--)
     {
-        Ipv4RoutingTableEntry* j = i->first;
-        uint32_t metric = i->second;
-        Ipv4Mask mask = (j)->GetDestNetworkMask();
-        uint16_t masklen = mask.GetPrefixLength();
-        Ipv4Address entry = (j)->GetDestNetwork();
-        NS_LOG_LOGIC("Searching for route to " << dest << ", checking against route to " << entry
-                                               << "/" << masklen);
-        if (mask.IsMatch(dest, entry))
+        const Ipv4RoutingTableIndex::Routes* routes = m_networkRoutesIndex.Find(dest, masklen);
+        if (!routes)
         {
+            continue;
+        }
+        const Ipv4RoutingTableIndex::Route* best = nullptr;
+        for (const auto& i : *routes)
+        {
+            Ipv4RoutingTableEntry* j = i.entry;
+            Ipv4Mask mask = j->GetDestNetworkMask();
+            Ipv4Address entry = j->GetDestNetwork();
+            NS_LOG_LOGIC("Searching for route to " << dest << ", checking against route to "
+                                                   << entry << "/" << masklen);
+            if (!mask.IsMatch(dest, entry))
+            {
+                continue;
+            }
             NS_LOG_LOGIC("Found global network route " << j << ", mask length " << masklen
-                                                       << ", metric " << metric);
+                                                       << ", metric " << i.metric);
             if (oif)
             {
                 if (oif != m_ipv4->GetNetDevice(j->GetInterface()))
@@ -282,33 +308,26 @@ Ipv4StaticRouting::LookupStatic(Ipv4Address dest, Ptr<NetDevice> oif)
                     continue;
                 }
             }
-            if (masklen < longest_mask) // Not interested if got shorter mask
+            if (best && i.metric > best->metric)
             {
-                NS_LOG_LOGIC("Previous match longer, skipping");
+                NS_LOG_LOGIC("Equal mask length, but previous metric shorter, skipping");
                 continue;
             }
-            if (masklen > longest_mask) // Reset metric if longer masklen
-            {
-                shortest_metric = 0xffffffff;
-            }
-            longest_mask = masklen;
-            if (metric > shortest_metric)
+            best = &i;
+            if (masklen == 32)
             {
-                NS_LOG_LOGIC("Equal mask length, but previous metric shorter, skipping");
-                continue;
+                break;
             }
-            shortest_metric = metric;
-            Ipv4RoutingTableEntry* route = (j);
+        }
+        if (best)
+        {
+            Ipv4RoutingTableEntry* route = best->entry;
             uint32_t interfaceIdx = route->GetInterface();
             rtentry = Create<Ipv4Route>();
             rtentry->SetDestination(route->GetDest());
             rtentry->SetSource(m_ipv4->SourceAddressSelection(interfaceIdx, route->GetDest()));
             rtentry->SetGateway(route->GetGateway());
             rtentry->SetOutputDevice(m_ipv4->GetNetDevice(interfaceIdx));
-            if (masklen == 32)
-            {
-                break;
-            }
         }
     }
     if (rtentry)
@@ -385,22 +404,18 @@ Ipv4StaticRouting::GetDefaultRoute()
     Ipv4Address dest("0.0.0.0");
     uint32_t shortest_metric = 0xffffffff;
     Ipv4RoutingTableEntry* result = nullptr;
-    for (NetworkRoutesI i = m_networkRoutes.begin(); i != m_networkRoutes.end(); i++)
+    const Ipv4RoutingTableIndex::Routes* routes = m_networkRoutesIndex.Find(dest, 0);
+    if (routes)
     {
-        Ipv4RoutingTableEntry* j = i->first;
-        uint32_t metric = i->second;
-        Ipv4Mask mask = (j)->GetDestNetworkMask();
-        uint16_t masklen = mask.GetPrefixLength();
-        if (masklen != 0)
-        {
-            continue;
-        }
-        if (metric > shortest_metric)
+        for (const auto& i : *routes)
         {
-            continue;
+            if (i.metric > shortest_metric)
+            {
+                continue;
+            }
+            shortest_metric = i.metric;
+            result = i.entry;
         }
-        shortest_metric = metric;
-        result = j;
     }
     if (result)
     {
@@ -457,6 +472,8 @@ Ipv4StaticRouting::RemoveRoute(uint32_t index)
     {
         if (tmp == index)
         {
+            m_networkRoutesIndex.Remove(j->first);
+            m_routesGeneration++;
             delete j->first;
             m_networkRoutes.erase(j);
             return;
@@ -588,6 +605,8 @@ void
 Ipv4StaticRouting::DoDispose()
 {
     NS_LOG_FUNCTION(this);
+    m_networkRoutesIndex.Clear();
+    m_routesGeneration++;
     for (NetworkRoutesI j = m_networkRoutes.begin(); j != m_networkRoutes.end();
          j = m_networkRoutes.erase(j))
     {
@@ -632,6 +651,8 @@ Ipv4StaticRouting::NotifyInterfaceDown(uint32_t i)
     {
         if (it->first->GetInterface() == i)
         {
+            m_networkRoutesIndex.Remove(it->first);
+            m_routesGeneration++;
             delete it->first;
             it = m_networkRoutes.erase(it);
         }
@@ -677,6 +698,8 @@ Ipv4StaticRouting::NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress
             it->first->GetDestNetwork() == networkAddress &&
             it->first->GetDestNetworkMask() == networkMask)
         {
+            m_networkRoutesIndex.Remove(it->first);
+            m_routesGeneration++;
             delete it->first;
             it = m_networkRoutes.erase(it);
         }
@@ -706,6 +729,12 @@ Ipv4StaticRouting::SetIpv4(Ptr<Ipv4> ipv4)
     }
 }
 
+uint64_t
+Ipv4StaticRouting::GetRoutesGeneration() const
+{
+    return m_routesGeneration;
+}
+
 // Formatted like output of "route -n" command
 void
 Ipv4StaticRouting::PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Time::Unit unit) const
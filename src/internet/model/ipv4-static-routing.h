@@ -21,6 +21,8 @@
 #ifndef IPV4_STATIC_ROUTING_H
 #define IPV4_STATIC_ROUTING_H
 
+#include "ipv4-routing-table-index.h"
+
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv4-header.h"
 #include "ns3/ipv4-routing-protocol.h"
@@ -95,6 +97,7 @@ class Ipv4StaticRouting : public Ipv4RoutingProtocol
     void SetIpv4(Ptr<Ipv4> ipv4) override;
     void PrintRoutingTable(Ptr<OutputStreamWrapper> stream,
                            Time::Unit unit = Time::S) const override;
+    uint64_t GetRoutesGeneration() const override;
 
     /**
      * \brief Add a network route to the static routing table.
@@ -410,6 +413,11 @@ class Ipv4StaticRouting : public Ipv4RoutingProtocol
      */
     NetworkRoutes m_networkRoutes;
 
+    /**
+     * \brief the index of m_networkRoutes by destination prefix, used for lookups.
+     */
+    Ipv4RoutingTableIndex m_networkRoutesIndex;
+
     /**
      * \brief the forwarding table for multicast.
      */
@@ -419,6 +427,11 @@ class Ipv4StaticRouting : public Ipv4RoutingProtocol
      * \brief Ipv4 reference.
      */
     Ptr<Ipv4> m_ipv4;
+
+    /**
+     * \brief Generation of the routes, changed each time they change.
+     */
+    uint64_t m_routesGeneration;
 };
 
 } // Namespace ns3
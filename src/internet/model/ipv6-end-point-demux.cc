@@ -23,6 +23,8 @@
 
 #include "ns3/log.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -45,30 +47,29 @@ Ipv6EndPointDemux::~Ipv6EndPointDemux()
         delete endPoint;
     }
     m_endPoints.clear();
+    m_positions.clear();
+    m_localPorts.clear();
 }
 
 bool
 Ipv6EndPointDemux::LookupPortLocal(uint16_t port)
 {
     NS_LOG_FUNCTION(this << port);
-    for (EndPointsI i = m_endPoints.begin(); i != m_endPoints.end(); i++)
-    {
-        if ((*i)->GetLocalPort() == port)
-        {
-            return true;
-        }
-    }
-    return false;
+    return m_localPorts.find(port) != m_localPorts.end();
 }
 
 bool
 Ipv6EndPointDemux::LookupLocal(Ptr<NetDevice> boundNetDevice, Ipv6Address addr, uint16_t port)
 {
     NS_LOG_FUNCTION(this << addr << port);
-    for (EndPointsI i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto endPoints = m_localPorts.find(port);
+    if (endPoints == m_localPorts.end())
+    {
+        return false;
+    }
+    for (Ipv6EndPoint* endP : endPoints->second)
     {
-        if ((*i)->GetLocalPort() == port && (*i)->GetLocalAddress() == addr &&
-            (*i)->GetBoundNetDevice() == boundNetDevice)
+        if (endP->GetLocalAddress() == addr && endP->GetBoundNetDevice() == boundNetDevice)
         {
             return true;
         }
@@ -87,7 +88,7 @@ Ipv6EndPointDemux::Allocate()
         return nullptr;
     }
     Ipv6EndPoint* endPoint = new Ipv6EndPoint(Ipv6Address::GetAny(), port);
-    m_endPoints.push_back(endPoint);
+    AddEndPoint(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -103,7 +104,7 @@ Ipv6EndPointDemux::Allocate(Ipv6Address address)
         return nullptr;
     }
     Ipv6EndPoint* endPoint = new Ipv6EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
+    AddEndPoint(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -126,7 +127,7 @@ Ipv6EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice, Ipv6Address address,
         return nullptr;
     }
     Ipv6EndPoint* endPoint = new Ipv6EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
+    AddEndPoint(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -139,19 +140,21 @@ Ipv6EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice,
                             uint16_t peerPort)
 {
     NS_LOG_FUNCTION(this << boundNetDevice << localAddress << localPort << peerAddress << peerPort);
-    for (EndPointsI i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto tuple = m_fourTuples.find({localAddress, localPort, peerAddress, peerPort});
+    if (tuple != m_fourTuples.end())
     {
-        if ((*i)->GetLocalPort() == localPort && (*i)->GetLocalAddress() == localAddress &&
-            (*i)->GetPeerPort() == peerPort && (*i)->GetPeerAddress() == peerAddress &&
-            ((*i)->GetBoundNetDevice() == boundNetDevice || !(*i)->GetBoundNetDevice()))
+        for (Ipv6EndPoint* endP : tuple->second)
         {
-            NS_LOG_WARN("Duplicated endpoint.");
-            return nullptr;
+            if (endP->GetBoundNetDevice() == boundNetDevice || !endP->GetBoundNetDevice())
+            {
+                NS_LOG_WARN("Duplicated endpoint.");
+                return nullptr;
+            }
         }
     }
     Ipv6EndPoint* endPoint = new Ipv6EndPoint(localAddress, localPort);
     endPoint->SetPeer(peerAddress, peerPort);
-    m_endPoints.push_back(endPoint);
+    AddEndPoint(endPoint);
 
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
 
@@ -161,16 +164,17 @@ Ipv6EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice,
 void
 Ipv6EndPointDemux::DeAllocate(Ipv6EndPoint* endPoint)
 {
-    NS_LOG_FUNCTION(this);
-    for (EndPointsI i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    NS_LOG_FUNCTION(this << endPoint);
+    auto position = m_positions.find(endPoint);
+    if (position == m_positions.end())
     {
-        if (*i == endPoint)
-        {
-            delete endPoint;
-            m_endPoints.erase(i);
-            break;
-        }
+        return;
     }
+    RemoveFromIndex(endPoint);
+    RemoveFromLocalPort(endPoint);
+    m_endPoints.erase(position->second);
+    m_positions.erase(position);
+    delete endPoint;
 }
 
 /*
@@ -187,167 +191,284 @@ Ipv6EndPointDemux::Lookup(Ipv6Address daddr,
 {
     NS_LOG_FUNCTION(this << daddr << dport << saddr << sport << incomingInterface);
 
-    EndPoints retval1; /* Matches exact on local port, wildcards on others */
-    EndPoints retval2; /* Matches exact on local port/adder, wildcards on others */
-    EndPoints retval3; /* Matches all but local address */
-    EndPoints retval4; /* Exact match on all 4 */
-
-    NS_LOG_DEBUG("Looking up endpoint for destination address " << daddr);
-    for (EndPointsI i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    EndPoints retval;
+    Ipv6EndPoint* endP = LookupEndPoint(daddr, dport, saddr, sport, incomingInterface);
+    if (endP)
     {
-        Ipv6EndPoint* endP = *i;
-
-        NS_LOG_DEBUG("Looking at endpoint dport="
-                     << endP->GetLocalPort() << " daddr=" << endP->GetLocalAddress()
-                     << " sport=" << endP->GetPeerPort() << " saddr=" << endP->GetPeerAddress());
+        retval.push_back(endP);
+    }
+    return retval; // might be empty if no matches
+}
 
-        if (!endP->IsRxEnabled())
-        {
-            NS_LOG_LOGIC("Skipping endpoint " << &endP
-                                              << " because endpoint can not receive packets");
-            continue;
-        }
+Ipv6EndPoint*
+Ipv6EndPointDemux::LookupEndPoint(Ipv6Address daddr,
+                                  uint16_t dport,
+                                  Ipv6Address saddr,
+                                  uint16_t sport,
+                                  Ptr<Ipv6Interface> incomingInterface)
+{
+    NS_LOG_FUNCTION(this << daddr << dport << saddr << sport << incomingInterface);
 
-        if (endP->GetLocalPort() != dport)
+    /* First matching endpoint and number of matching endpoints for each case:
+       1) Matches exact on local port, wildcards on others
+       2) Matches exact on local port/adder, wildcards on others
+       3) Matches all but local address
+       4) Exact match on all 4 */
+    Ipv6EndPoint* found[4] = {nullptr, nullptr, nullptr, nullptr};
+    uint32_t nFound[4] = {0, 0, 0, 0};
+
+    /* An endpoint can only match if it is bound to the destination port and to
+       the destination address or to the any address, and if it is connected
+       either to the source address and port or to nothing.  Only these
+       four-tuples are looked up. */
+    auto lookupTuple = [&](Ipv6Address localAddress, Ipv6Address peerAddress, uint16_t peerPort) {
+        auto tuple = m_fourTuples.find({localAddress, dport, peerAddress, peerPort});
+        if (tuple == m_fourTuples.end())
         {
-            NS_LOG_LOGIC("Skipping endpoint " << &endP << " because endpoint dport "
-                                              << endP->GetLocalPort()
-                                              << " does not match packet dport " << dport);
-            continue;
+            return;
         }
-
-        if (endP->GetBoundNetDevice())
+        for (Ipv6EndPoint* endP : tuple->second)
         {
-            if (!incomingInterface)
+            uint8_t matches = MatchEndPoint(endP, daddr, saddr, sport, incomingInterface);
+            for (uint8_t i = 0; i < 4; i++)
             {
-                continue;
-            }
-            if (endP->GetBoundNetDevice() != incomingInterface->GetDevice())
-            {
-                NS_LOG_LOGIC("Skipping endpoint "
-                             << &endP << " because endpoint is bound to specific device and"
-                             << endP->GetBoundNetDevice() << " does not match packet device "
-                             << incomingInterface->GetDevice());
-                continue;
+                if (matches & (1 << i))
+                {
+                    found[i] = (nFound[i] == 0 ? endP : found[i]);
+                    nFound[i]++;
+                }
             }
         }
+    };
+    auto lookupLocal = [&](Ipv6Address localAddress) {
+        lookupTuple(localAddress, saddr, sport);
+        if (saddr != Ipv6Address::GetAny() || sport != 0)
+        {
+            lookupTuple(localAddress, Ipv6Address::GetAny(), 0);
+        }
+    };
 
-        /*    Ipv6Address incomingInterfaceAddr = incomingInterface->GetAddress (); */
-        NS_LOG_DEBUG("dest addr " << daddr);
-
-        bool localAddressMatchesWildCard = endP->GetLocalAddress() == Ipv6Address::GetAny();
-        bool localAddressMatchesExact = endP->GetLocalAddress() == daddr;
-        bool localAddressMatchesAllRouters =
-            endP->GetLocalAddress() == Ipv6Address::GetAllRoutersMulticast();
+    NS_LOG_DEBUG("Looking up endpoint for destination address " << daddr);
+    lookupLocal(daddr);
+    if (daddr != Ipv6Address::GetAny())
+    {
+        lookupLocal(Ipv6Address::GetAny());
+    }
 
-        /* if no match here, keep looking */
-        if (!(localAddressMatchesExact || localAddressMatchesWildCard))
+    // Here we find the most exact match
+    for (int i = 3; i >= 0; i--)
+    {
+        if (nFound[i] > 0)
         {
-            continue;
+            NS_ABORT_MSG_IF(nFound[i] > 1,
+                            "Too many endpoints - perhaps you created too many sockets without "
+                            "binding them to different NetDevices.");
+            return found[i];
         }
-        bool remotePeerMatchesExact = endP->GetPeerPort() == sport;
-        bool remotePeerMatchesWildCard = endP->GetPeerPort() == 0;
-        bool remoteAddressMatchesExact = endP->GetPeerAddress() == saddr;
-        bool remoteAddressMatchesWildCard = endP->GetPeerAddress() == Ipv6Address::GetAny();
-
-        /* If remote does not match either with exact or wildcard,i
-           skip this one */
-        if (!(remotePeerMatchesExact || remotePeerMatchesWildCard))
+    }
+    return nullptr;
+}
+
+uint8_t
+Ipv6EndPointDemux::MatchEndPoint(Ipv6EndPoint* endP,
+                                 Ipv6Address daddr,
+                                 Ipv6Address saddr,
+                                 uint16_t sport,
+                                 Ptr<Ipv6Interface> incomingInterface) const
+{
+    NS_LOG_DEBUG("Looking at endpoint dport="
+                 << endP->GetLocalPort() << " daddr=" << endP->GetLocalAddress()
+                 << " sport=" << endP->GetPeerPort() << " saddr=" << endP->GetPeerAddress());
+
+    if (!endP->IsRxEnabled())
+    {
+        NS_LOG_LOGIC("Skipping endpoint " << &endP
+                                          << " because endpoint can not receive packets");
+        return 0;
+    }
+
+    if (endP->GetBoundNetDevice())
+    {
+        if (!incomingInterface)
         {
-            continue;
+            return 0;
         }
-        if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
+        if (endP->GetBoundNetDevice() != incomingInterface->GetDevice())
         {
-            continue;
-        }
-
-        /* Now figure out which return list to add this one to */
-        if (localAddressMatchesWildCard && remotePeerMatchesWildCard &&
-            remoteAddressMatchesWildCard)
-        { /* Only local port matches exactly */
-            retval1.push_back(endP);
-        }
-        if ((localAddressMatchesExact || (localAddressMatchesAllRouters)) &&
-            remotePeerMatchesWildCard && remoteAddressMatchesWildCard)
-        { /* Only local port and local address matches exactly */
-            retval2.push_back(endP);
-        }
-        if (localAddressMatchesWildCard && remotePeerMatchesExact && remoteAddressMatchesExact)
-        { /* All but local address */
-            retval3.push_back(endP);
-        }
-        if (localAddressMatchesExact && remotePeerMatchesExact && remoteAddressMatchesExact)
-        { /* All 4 match */
-            retval4.push_back(endP);
+            NS_LOG_LOGIC("Skipping endpoint "
+                         << &endP << " because endpoint is bound to specific device and"
+                         << endP->GetBoundNetDevice() << " does not match packet device "
+                         << incomingInterface->GetDevice());
+            return 0;
         }
     }
 
-    // Here we find the most exact match
-    EndPoints retval;
-    if (!retval4.empty())
-    {
-        retval = retval4;
-    }
-    else if (!retval3.empty())
+    /*    Ipv6Address incomingInterfaceAddr = incomingInterface->GetAddress (); */
+    NS_LOG_DEBUG("dest addr " << daddr);
+
+    bool localAddressMatchesWildCard = endP->GetLocalAddress() == Ipv6Address::GetAny();
+    bool localAddressMatchesExact = endP->GetLocalAddress() == daddr;
+    bool localAddressMatchesAllRouters =
+        endP->GetLocalAddress() == Ipv6Address::GetAllRoutersMulticast();
+
+    /* if no match here, keep looking */
+    if (!(localAddressMatchesExact || localAddressMatchesWildCard))
     {
-        retval = retval3;
+        return 0;
     }
-    else if (!retval2.empty())
+    bool remotePeerMatchesExact = endP->GetPeerPort() == sport;
+    bool remotePeerMatchesWildCard = endP->GetPeerPort() == 0;
+    bool remoteAddressMatchesExact = endP->GetPeerAddress() == saddr;
+    bool remoteAddressMatchesWildCard = endP->GetPeerAddress() == Ipv6Address::GetAny();
+
+    /* If remote does not match either with exact or wildcard,i
+       skip this one */
+    if (!(remotePeerMatchesExact || remotePeerMatchesWildCard))
     {
-        retval = retval2;
+        return 0;
     }
-    else
+    if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
     {
-        retval = retval1;
+        return 0;
     }
 
-    NS_ABORT_MSG_IF(retval.size() > 1,
-                    "Too many endpoints - perhaps you created too many sockets without binding "
-                    "them to different NetDevices.");
-    return retval; // might be empty if no matches
+    /* Now figure out which return list to add this one to */
+    uint8_t matches = 0;
+    if (localAddressMatchesWildCard && remotePeerMatchesWildCard && remoteAddressMatchesWildCard)
+    { /* Only local port matches exactly */
+        matches |= (1 << 0);
+    }
+    if ((localAddressMatchesExact || (localAddressMatchesAllRouters)) &&
+        remotePeerMatchesWildCard && remoteAddressMatchesWildCard)
+    { /* Only local port and local address matches exactly */
+        matches |= (1 << 1);
+    }
+    if (localAddressMatchesWildCard && remotePeerMatchesExact && remoteAddressMatchesExact)
+    { /* All but local address */
+        matches |= (1 << 2);
+    }
+    if (localAddressMatchesExact && remotePeerMatchesExact && remoteAddressMatchesExact)
+    { /* All 4 match */
+        matches |= (1 << 3);
+    }
+    return matches;
 }
 
 Ipv6EndPoint*
 Ipv6EndPointDemux::SimpleLookup(Ipv6Address dst, uint16_t dport, Ipv6Address src, uint16_t sport)
 {
+    auto tuple = m_fourTuples.find({dst, dport, src, sport});
+    if (tuple != m_fourTuples.end())
+    {
+        /* this is an exact match. */
+        return tuple->second.front();
+    }
+
     uint32_t genericity = 3;
     Ipv6EndPoint* generic = nullptr;
 
-    for (EndPointsI i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto endPoints = m_localPorts.find(dport);
+    if (endPoints == m_localPorts.end())
+    {
+        return nullptr;
+    }
+    for (Ipv6EndPoint* endP : endPoints->second)
     {
         uint32_t tmp = 0;
 
-        if ((*i)->GetLocalPort() != dport)
-        {
-            continue;
-        }
-
-        if ((*i)->GetLocalAddress() == dst && (*i)->GetPeerPort() == sport &&
-            (*i)->GetPeerAddress() == src)
-        {
-            /* this is an exact match. */
-            return *i;
-        }
-
-        if ((*i)->GetLocalAddress() == Ipv6Address::GetAny())
+        if (endP->GetLocalAddress() == Ipv6Address::GetAny())
         {
             tmp++;
         }
 
-        if ((*i)->GetPeerAddress() == Ipv6Address::GetAny())
+        if (endP->GetPeerAddress() == Ipv6Address::GetAny())
         {
             tmp++;
         }
 
         if (tmp < genericity)
         {
-            generic = (*i);
+            generic = endP;
             genericity = tmp;
         }
     }
     return generic;
 }
 
+bool
+Ipv6EndPointDemux::FourTuple::operator==(const FourTuple& other) const
+{
+    return localAddress == other.localAddress && localPort == other.localPort &&
+           peerAddress == other.peerAddress && peerPort == other.peerPort;
+}
+
+size_t
+Ipv6EndPointDemux::FourTupleHash::operator()(const FourTuple& tuple) const
+{
+    Ipv6AddressHash addressHash;
+    size_t ports = (size_t(tuple.localPort) << 16) | tuple.peerPort;
+    return addressHash(tuple.localAddress) ^ (addressHash(tuple.peerAddress) * 31) ^ ports;
+}
+
+void
+Ipv6EndPointDemux::AddEndPoint(Ipv6EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    m_positions[endPoint] = m_endPoints.insert(m_endPoints.end(), endPoint);
+    AddToLocalPort(endPoint);
+    AddToIndex(endPoint);
+}
+
+void
+Ipv6EndPointDemux::AddToLocalPort(Ipv6EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    m_localPorts[endPoint->GetLocalPort()].push_back(endPoint);
+}
+
+void
+Ipv6EndPointDemux::RemoveFromLocalPort(Ipv6EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    auto port = m_localPorts.find(endPoint->GetLocalPort());
+    NS_ASSERT_MSG(port != m_localPorts.end(), "End point not found in the demux");
+    auto& endPoints = port->second;
+    endPoints.erase(std::find(endPoints.begin(), endPoints.end(), endPoint));
+    if (endPoints.empty())
+    {
+        m_localPorts.erase(port);
+    }
+}
+
+void
+Ipv6EndPointDemux::AddToIndex(Ipv6EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    endPoint->m_demux = this;
+    m_fourTuples[{endPoint->GetLocalAddress(),
+                  endPoint->GetLocalPort(),
+                  endPoint->GetPeerAddress(),
+                  endPoint->GetPeerPort()}]
+        .push_back(endPoint);
+}
+
+void
+Ipv6EndPointDemux::RemoveFromIndex(Ipv6EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    auto tuple = m_fourTuples.find({endPoint->GetLocalAddress(),
+                                    endPoint->GetLocalPort(),
+                                    endPoint->GetPeerAddress(),
+                                    endPoint->GetPeerPort()});
+    NS_ASSERT_MSG(tuple != m_fourTuples.end(), "End point not found in the demux");
+    auto& endPoints = tuple->second;
+    endPoints.erase(std::find(endPoints.begin(), endPoints.end(), endPoint));
+    if (endPoints.empty())
+    {
+        m_fourTuples.erase(tuple);
+    }
+}
+
 uint16_t
 Ipv6EndPointDemux::AllocateEphemeralPort()
 {
@@ -26,6 +26,8 @@
 
 #include <list>
 #include <stdint.h>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -36,6 +38,10 @@ class Ipv6EndPoint;
  * \ingroup ipv6
  *
  * \brief Demultiplexer for end points.
+ *
+ * The end points are kept in a hash table keyed by their four-tuple, which
+ * the end points update when their addresses or ports change, so that the
+ * cost of a lookup does not depend on the number of end points.
  */
 class Ipv6EndPointDemux
 {
@@ -93,6 +99,25 @@ class Ipv6EndPointDemux
                      uint16_t sport,
                      Ptr<Ipv6Interface> incomingInterface);
 
+    /**
+     * \brief lookup for a match with all the parameters.
+     *
+     * This is the same as Lookup, which can return at most one EndPoint,
+     * without building a list.
+     *
+     * \param dst destination address to test
+     * \param dport destination port to test
+     * \param src source address to test
+     * \param sport source port to test
+     * \param incomingInterface the incoming interface
+     * \return the most-matching IPv6EndPoint (nullptr if not found)
+     */
+    Ipv6EndPoint* LookupEndPoint(Ipv6Address dst,
+                                 uint16_t dport,
+                                 Ipv6Address src,
+                                 uint16_t sport,
+                                 Ptr<Ipv6Interface> incomingInterface);
+
     /**
      * \brief Simple lookup for a four-tuple match.
      * \param dst destination address to test
@@ -161,6 +186,92 @@ class Ipv6EndPointDemux
     EndPoints GetEndPoints() const;
 
   private:
+    friend class Ipv6EndPoint;
+
+    /**
+     * \brief The four-tuple of an end point.
+     */
+    struct FourTuple
+    {
+        Ipv6Address localAddress; //!< the local address
+        uint16_t localPort;       //!< the local port
+        Ipv6Address peerAddress;  //!< the peer address
+        uint16_t peerPort;        //!< the peer port
+
+        /**
+         * \brief Equality operator.
+         * \param other the four-tuple to compare to
+         * \returns true if the four-tuples are equal
+         */
+        bool operator==(const FourTuple& other) const;
+    };
+
+    /**
+     * \brief Hash function class for the four-tuples.
+     */
+    struct FourTupleHash
+    {
+        /**
+         * \brief Returns the hash of a four-tuple.
+         * \param tuple the four-tuple
+         * \returns the hash of the four-tuple
+         */
+        size_t operator()(const FourTuple& tuple) const;
+    };
+
+    /**
+     * \brief Add a new end point to the list of end points and to the lookup tables.
+     * \param endPoint the end point
+     */
+    void AddEndPoint(Ipv6EndPoint* endPoint);
+
+    /**
+     * \brief Add an end point to the end points bound to its local port.
+     * \param endPoint the end point
+     */
+    void AddToLocalPort(Ipv6EndPoint* endPoint);
+
+    /**
+     * \brief Remove an end point from the end points bound to its local port.
+     * \param endPoint the end point
+     */
+    void RemoveFromLocalPort(Ipv6EndPoint* endPoint);
+
+    /**
+     * \brief Add an end point to the lookup tables.
+     * \param endPoint the end point
+     */
+    void AddToIndex(Ipv6EndPoint* endPoint);
+
+    /**
+     * \brief Remove an end point from the lookup tables.
+     *
+     * The end point calls this function before changing its four-tuple, and
+     * AddToIndex afterwards.
+     *
+     * \param endPoint the end point
+     */
+    void RemoveFromIndex(Ipv6EndPoint* endPoint);
+
+    /**
+     * \brief Check whether an end point matches a packet.
+     *
+     * The end point is assumed to be bound to the destination port.
+     *
+     * \param endP the end point
+     * \param dst destination address to test
+     * \param src source address to test
+     * \param sport source port to test
+     * \param incomingInterface the incoming interface
+     * \return a bitmask with bit n-1 set if the end point matches with priority n,
+     * as defined by Lookup (e.g., bit 3 for a full match)
+     */
+    uint8_t MatchEndPoint(Ipv6EndPoint* endP,
+                          Ipv6Address dst,
+                          Ipv6Address src,
+                          uint16_t sport,
+                          Ptr<Ipv6Interface> incomingInterface) const;
+
     /**
      * \brief Allocate a ephemeral port.
      * \return a port
@@ -186,6 +297,22 @@ class Ipv6EndPointDemux
      * \brief A list of IPv6 end points.
      */
     EndPoints m_endPoints;
+
+    /**
+     * \brief The IPv6 end points, by four-tuple.
+     */
+    std::unordered_map<FourTuple, std::vector<Ipv6EndPoint*>, FourTupleHash> m_fourTuples;
+
+    /**
+     * \brief The position of each IPv6 end point in m_endPoints.
+     */
+    std::unordered_map<Ipv6EndPoint*, EndPointsI> m_positions;
+
+    /**
+     * \brief The IPv6 end points bound to each local port, in the order in which
+     * they were bound to the port.
+     */
+    std::unordered_map<uint16_t, std::vector<Ipv6EndPoint*>> m_localPorts;
 };
 
 } /* namespace ns3 */
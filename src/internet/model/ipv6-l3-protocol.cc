@@ -26,6 +26,7 @@
 #include "ipv6-interface.h"
 #include "ipv6-option-demux.h"
 #include "ipv6-option.h"
+#include "ipv6-queue-disc-item.h"
 #include "ipv6-raw-socket-factory-impl.h"
 #include "ipv6-raw-socket-impl.h"
 #include "ipv6-route.h"
@@ -35,9 +36,11 @@
 
 #include "ns3/boolean.h"
 #include "ns3/callback.h"
+#include "ns3/gso-tag.h"
 #include "ns3/log.h"
 #include "ns3/mac16-address.h"
 #include "ns3/mac64-address.h"
+#include "ns3/net-device-queue-interface.h"
 #include "ns3/node.h"
 #include "ns3/object-vector.h"
 #include "ns3/trace-source-accessor.h"
@@ -972,6 +975,11 @@ Ipv6L3Protocol::Send(Ptr<Packet> packet,
         tclass = tclassTag.GetTclass();
     }
 
+    // The "SendOutgoing" trace is fired for the segments of a super-segment
+    // when it is split
+    GsoTag gsoTag;
+    bool superSegment = packet->PeekPacketTag(gsoTag);
+
     /* Handle 3 cases:
      * 1) Packet is passed in with a route entry
      * 2) Packet is passed in with a route entry but route->GetGateway is not set (e.g., same
@@ -984,7 +992,10 @@ Ipv6L3Protocol::Send(Ptr<Packet> packet,
         NS_LOG_LOGIC("Ipv6L3Protocol::Send case 1: passed in with a route");
         hdr = BuildHeader(source, destination, protocol, packet->GetSize(), ttl, tclass);
         int32_t interface = GetInterfaceForDevice(route->GetOutputDevice());
-        m_sendOutgoingTrace(hdr, packet, interface);
+        if (!superSegment)
+        {
+            m_sendOutgoingTrace(hdr, packet, interface);
+        }
         SendRealOut(route, packet, hdr);
         return;
     }
@@ -995,7 +1006,10 @@ Ipv6L3Protocol::Send(Ptr<Packet> packet,
         NS_LOG_LOGIC("Ipv6L3Protocol::Send case 2: probably sent to machine on same IPv6 network");
         hdr = BuildHeader(source, destination, protocol, packet->GetSize(), ttl, tclass);
         int32_t interface = GetInterfaceForDevice(route->GetOutputDevice());
-        m_sendOutgoingTrace(hdr, packet, interface);
+        if (!superSegment)
+        {
+            m_sendOutgoingTrace(hdr, packet, interface);
+        }
         SendRealOut(route, packet, hdr);
         return;
     }
@@ -1023,7 +1037,10 @@ Ipv6L3Protocol::Send(Ptr<Packet> packet,
     if (newRoute)
     {
         int32_t interface = GetInterfaceForDevice(newRoute->GetOutputDevice());
-        m_sendOutgoingTrace(hdr, packet, interface);
+        if (!superSegment)
+        {
+            m_sendOutgoingTrace(hdr, packet, interface);
+        }
         SendRealOut(newRoute, packet, hdr);
     }
     else
@@ -1268,6 +1285,42 @@ Ipv6L3Protocol::SendRealOut(Ptr<Ipv6Route> route, Ptr<Packet> packet, const Ipv6
         targetMtu = dev->GetMtu();
     }
 
+    GsoTag gsoTag;
+    if (packet->PeekPacketTag(gsoTag))
+    {
+        // A super-segment crosses the traffic control layer as a single packet
+        // and is split by the device queue interface, unless its segments need
+        // to be fragmented or do not go through the traffic control layer
+        Ipv6Address target = route->GetGateway() != Ipv6Address::GetAny()
+                                 ? route->GetGateway()
+                                 : ipHeader.GetDestination();
+        Ptr<NetDeviceQueueInterface> ndqi = dev->GetObject<NetDeviceQueueInterface>();
+        bool local = false;
+        for (uint32_t i = 0; i < outInterface->GetNAddresses(); i++)
+        {
+            local = local || outInterface->GetAddress(i).GetAddress() == target;
+        }
+        if (ndqi && !local && outInterface->IsUp() &&
+            gsoTag.GetHeaderSize() + gsoTag.GetSegmentSize() + ipHeader.GetSerializedSize() <=
+                targetMtu)
+        {
+            if (!ndqi->HasGsoCallback(PROT_NUMBER))
+            {
+                ndqi->SetGsoCallback(PROT_NUMBER, [this, interface](Ptr<QueueDiscItem> item) {
+                    return SegmentGsoItem(item, interface);
+                });
+            }
+            outInterface->Send(packet, ipHeader, target);
+            return;
+        }
+        for (const auto& [segment, segmentHeader] : SegmentGso(packet, ipHeader))
+        {
+            m_sendOutgoingTrace(segmentHeader, segment, interface);
+            SendRealOut(route, segment, segmentHeader);
+        }
+        return;
+    }
+
     if (packet->GetSize() + ipHeader.GetSerializedSize() > targetMtu)
     {
         // Router => drop
@@ -1355,6 +1408,54 @@ Ipv6L3Protocol::SendRealOut(Ptr<Ipv6Route> route, Ptr<Packet> packet, const Ipv6
     }
 }
 
+std::vector<Ipv6L3Protocol::Ipv6PayloadHeaderPair>
+Ipv6L3Protocol::SegmentGso(Ptr<Packet> packet, const Ipv6Header& ipHeader) const
+{
+    NS_LOG_FUNCTION(this << packet << ipHeader);
+
+    Ptr<Packet> superSegment = packet->Copy();
+    GsoTag gsoTag;
+    superSegment->RemovePacketTag(gsoTag);
+    Ptr<IpL4Protocol> protocol = GetProtocol(ipHeader.GetNextHeader());
+    NS_ASSERT_MSG(protocol, "No protocol to split the super-segment " << packet);
+
+    std::vector<Ipv6PayloadHeaderPair> segments;
+    for (const auto& segment : protocol->SegmentGso(superSegment,
+                                                    gsoTag.GetSegmentSize(),
+                                                    ipHeader.GetSource(),
+                                                    ipHeader.GetDestination()))
+    {
+        Ipv6Header segmentHeader = ipHeader;
+        segmentHeader.SetPayloadLength(segment->GetSize());
+        segments.emplace_back(segment, segmentHeader);
+    }
+    return segments;
+}
+
+std::vector<Ptr<QueueDiscItem>>
+Ipv6L3Protocol::SegmentGsoItem(Ptr<QueueDiscItem> item, uint32_t interface)
+{
+    NS_LOG_FUNCTION(this << item << interface);
+
+    Ptr<Ipv6QueueDiscItem> ipv6Item = DynamicCast<Ipv6QueueDiscItem>(item);
+    NS_ASSERT_MSG(ipv6Item, "The super-segment " << item << " is not an IPv6 packet");
+
+    std::vector<Ptr<QueueDiscItem>> items;
+    for (const auto& [segment, segmentHeader] :
+         SegmentGso(ipv6Item->GetPacket(), ipv6Item->GetHeader()))
+    {
+        m_sendOutgoingTrace(segmentHeader, segment, interface);
+        CallTxTrace(segmentHeader, segment, this, interface);
+        Ptr<QueueDiscItem> segmentItem = Create<Ipv6QueueDiscItem>(segment,
+                                                                   item->GetAddress(),
+                                                                   item->GetProtocol(),
+                                                                   segmentHeader);
+        segmentItem->SetTxQueueIndex(item->GetTxQueueIndex());
+        items.push_back(segmentItem);
+    }
+    return items;
+}
+
 void
 Ipv6L3Protocol::IpForward(Ptr<const NetDevice> idev,
                           Ptr<Ipv6Route> rtentry,
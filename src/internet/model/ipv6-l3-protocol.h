@@ -29,6 +29,7 @@
 #include "ns3/traced-callback.h"
 
 #include <list>
+#include <vector>
 
 class Ipv6L3ProtocolTestCase;
 
@@ -42,6 +43,7 @@ class Ipv6Route;
 class Ipv6MulticastRoute;
 class Ipv6RawSocketImpl;
 class Icmpv6L4Protocol;
+class QueueDiscItem;
 class Ipv6AutoconfiguredPrefix;
 
 /**
@@ -562,6 +564,32 @@ class Ipv6L3Protocol : public Ipv6
                      Ptr<Ipv6> ipv6,
                      uint32_t interface);
 
+    /**
+     * \brief Pair of a packet and an Ipv6 header.
+     */
+    typedef std::pair<Ptr<Packet>, Ipv6Header> Ipv6PayloadHeaderPair;
+
+    /**
+     * \brief Split a super-segment into the segments it carries
+     * \param packet the super-segment, with its transport header and its GsoTag
+     * \param ipHeader the IPv6 header of the super-segment
+     * \return the segments and their IPv6 headers
+     */
+    std::vector<Ipv6PayloadHeaderPair> SegmentGso(Ptr<Packet> packet,
+                                                  const Ipv6Header& ipHeader) const;
+
+    /**
+     * \brief Split a super-segment leaving the traffic control layer
+     *
+     * This is the GSO callback set on the NetDeviceQueueInterface of the output
+     * devices. The "SendOutgoing" and "Tx" traces are fired for each segment.
+     *
+     * \param item the Ipv6QueueDiscItem of the super-segment, without its header
+     * \param interface the IP-level interface index
+     * \return the items of the segments
+     */
+    std::vector<Ptr<QueueDiscItem>> SegmentGsoItem(Ptr<QueueDiscItem> item, uint32_t interface);
+
     /**
      * \brief Callback to trace TX (transmission) packets.
      * \deprecated The non-const \c Ptr<Ipv6> argument is deprecated
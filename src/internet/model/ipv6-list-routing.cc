@@ -21,6 +21,7 @@
 #include "ipv6-route.h"
 #include "ipv6.h"
 
+#include "ns3/boolean.h"
 #include "ns3/log.h"
 #include "ns3/node.h"
 #include "ns3/simulator.h"
@@ -35,15 +36,25 @@ NS_OBJECT_ENSURE_REGISTERED(Ipv6ListRouting);
 TypeId
 Ipv6ListRouting::GetTypeId()
 {
-    static TypeId tid = TypeId("ns3::Ipv6ListRouting")
-                            .SetParent<Ipv6RoutingProtocol>()
-                            .SetGroupName("Internet")
-                            .AddConstructor<Ipv6ListRouting>();
+    static TypeId tid =
+        TypeId("ns3::Ipv6ListRouting")
+            .SetParent<Ipv6RoutingProtocol>()
+            .SetGroupName("Internet")
+            .AddConstructor<Ipv6ListRouting>()
+            .AddAttribute("RouteCache",
+                          "Cache the routes found by the routing protocols, "
+                          "if they all support it.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&Ipv6ListRouting::m_routeCacheEnabled),
+                          MakeBooleanChecker());
     return tid;
 }
 
 Ipv6ListRouting::Ipv6ListRouting()
-    : m_ipv6(nullptr)
+    : m_ipv6(nullptr),
+      m_routeCacheEnabled(false),
+      m_generation(1),
+      m_routeCacheGeneration(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -67,6 +78,8 @@ Ipv6ListRouting::DoDispose()
         (*rprotoIter).second = nullptr;
     }
     m_routingProtocols.clear();
+    m_outputRoutes.clear();
+    m_forwardRoutes.clear();
     m_ipv6 = nullptr;
 }
 
@@ -77,6 +90,32 @@ Ipv6ListRouting::RouteOutput(Ptr<Packet> p,
                              Socket::SocketErrno& sockerr)
 {
     NS_LOG_FUNCTION(this << header.GetDestination() << header.GetSource() << oif);
+    if (!RefreshRouteCache())
+    {
+        return LookupRouteOutput(p, header, oif, sockerr);
+    }
+
+    RouteCacheKey key{header.GetDestination(), header.GetTrafficClass(), oif};
+    auto it = m_outputRoutes.find(key);
+    if (it == m_outputRoutes.end())
+    {
+        it = m_outputRoutes.emplace(key, LookupRouteOutput(p, header, oif, sockerr)).first;
+    }
+    else
+    {
+        NS_LOG_LOGIC("Found cached route " << it->second);
+    }
+    sockerr = it->second ? Socket::ERROR_NOTERROR : Socket::ERROR_NOROUTETOHOST;
+    return it->second;
+}
+
+Ptr<Ipv6Route>
+Ipv6ListRouting::LookupRouteOutput(Ptr<Packet> p,
+                                   const Ipv6Header& header,
+                                   Ptr<NetDevice> oif,
+                                   Socket::SocketErrno& sockerr)
+{
+    NS_LOG_FUNCTION(this << header.GetDestination() << oif);
     Ptr<Ipv6Route> route;
 
     for (Ipv6RoutingProtocolList::const_iterator i = m_routingProtocols.begin();
@@ -118,7 +157,8 @@ Ipv6ListRouting::RouteInput(Ptr<const Packet> p,
     NS_ASSERT(m_ipv6->GetInterfaceForDevice(idev) >= 0);
     Ipv6Address dst = header.GetDestination();
 
-    // Check if input device supports IP forwarding
+    // Check if input device supports IP forwarding, before the route cache
+    // lookup: the cached routes do not depend on the forwarding state
     uint32_t iif = m_ipv6->GetInterfaceForDevice(idev);
     if (!m_ipv6->IsForwarding(iif))
     {
@@ -131,12 +171,36 @@ Ipv6ListRouting::RouteInput(Ptr<const Packet> p,
     ErrorCallback nullEcb =
         MakeNullCallback<void, Ptr<const Packet>, const Ipv6Header&, Socket::SocketErrno>();
 
+    // The unicast routes are cached, and recorded on their way to the
+    // forwarding callback on a cache miss
+    UnicastForwardCallback downstreamUcb = ucb;
+    RouteCacheKey key{dst, header.GetTrafficClass(), idev};
+    bool cacheRoute = !dst.IsMulticast() && RefreshRouteCache();
+    if (cacheRoute)
+    {
+        auto it = m_forwardRoutes.find(key);
+        if (it != m_forwardRoutes.end())
+        {
+            NS_LOG_LOGIC("Found cached route " << it->second << " to forward packet");
+            ucb(idev, it->second, p, header);
+            return true;
+        }
+        downstreamUcb = MakeCallback(&Ipv6ListRouting::RecordForwardRoute, this);
+    }
+
     for (Ipv6RoutingProtocolList::const_iterator rprotoIter = m_routingProtocols.begin();
          rprotoIter != m_routingProtocols.end();
          rprotoIter++)
     {
-        if ((*rprotoIter).second->RouteInput(p, header, idev, ucb, mcb, lcb, nullEcb))
+        if ((*rprotoIter).second->RouteInput(p, header, idev, downstreamUcb, mcb, lcb, nullEcb))
         {
+            if (m_forwardRoute)
+            {
+                Ptr<Ipv6Route> route = m_forwardRoute;
+                m_forwardRoute = nullptr;
+                m_forwardRoutes.emplace(key, route);
+                ucb(idev, route, p, header);
+            }
             return true;
         }
     }
@@ -146,10 +210,21 @@ Ipv6ListRouting::RouteInput(Ptr<const Packet> p,
     return false;
 }
 
+void
+Ipv6ListRouting::RecordForwardRoute(Ptr<const NetDevice> idev,
+                                    Ptr<Ipv6Route> route,
+                                    Ptr<const Packet> p,
+                                    const Ipv6Header& header)
+{
+    NS_LOG_FUNCTION(this << idev << route << p << header);
+    m_forwardRoute = route;
+}
+
 void
 Ipv6ListRouting::NotifyInterfaceUp(uint32_t interface)
 {
     NS_LOG_FUNCTION(this << interface);
+    m_generation++;
     for (Ipv6RoutingProtocolList::const_iterator rprotoIter = m_routingProtocols.begin();
          rprotoIter != m_routingProtocols.end();
          rprotoIter++)
@@ -162,6 +237,7 @@ void
 Ipv6ListRouting::NotifyInterfaceDown(uint32_t interface)
 {
     NS_LOG_FUNCTION(this << interface);
+    m_generation++;
     for (Ipv6RoutingProtocolList::const_iterator rprotoIter = m_routingProtocols.begin();
          rprotoIter != m_routingProtocols.end();
          rprotoIter++)
@@ -174,6 +250,7 @@ void
 Ipv6ListRouting::NotifyAddAddress(uint32_t interface, Ipv6InterfaceAddress address)
 {
     NS_LOG_FUNCTION(this << interface << address);
+    m_generation++;
     for (Ipv6RoutingProtocolList::const_iterator rprotoIter = m_routingProtocols.begin();
          rprotoIter != m_routingProtocols.end();
          rprotoIter++)
@@ -186,6 +263,7 @@ void
 Ipv6ListRouting::NotifyRemoveAddress(uint32_t interface, Ipv6InterfaceAddress address)
 {
     NS_LOG_FUNCTION(this << interface << address);
+    m_generation++;
     for (Ipv6RoutingProtocolList::const_iterator rprotoIter = m_routingProtocols.begin();
          rprotoIter != m_routingProtocols.end();
          rprotoIter++)
@@ -257,6 +335,42 @@ Ipv6ListRouting::SetIpv6(Ptr<Ipv6> ipv6)
         (*rprotoIter).second->SetIpv6(ipv6);
     }
     m_ipv6 = ipv6;
+    m_generation++;
+}
+
+uint64_t
+Ipv6ListRouting::GetRoutesGeneration() const
+{
+    // the generations only increase, hence their sum changes with any of them
+    uint64_t generation = m_generation;
+    for (const auto& protocol : m_routingProtocols)
+    {
+        uint64_t protocolGeneration = protocol.second->GetRoutesGeneration();
+        if (protocolGeneration == 0)
+        {
+            return 0;
+        }
+        generation += protocolGeneration;
+    }
+    return generation;
+}
+
+bool
+Ipv6ListRouting::RefreshRouteCache()
+{
+    if (!m_routeCacheEnabled)
+    {
+        return false;
+    }
+    uint64_t generation = GetRoutesGeneration();
+    if (generation != m_routeCacheGeneration)
+    {
+        NS_LOG_LOGIC("Flushing the route cache");
+        m_outputRoutes.clear();
+        m_forwardRoutes.clear();
+        m_routeCacheGeneration = generation;
+    }
+    return generation != 0;
 }
 
 void
@@ -269,6 +383,7 @@ Ipv6ListRouting::AddRoutingProtocol(Ptr<Ipv6RoutingProtocol> routingProtocol, in
     {
         routingProtocol->SetIpv6(m_ipv6);
     }
+    m_generation++;
 }
 
 uint32_t
@@ -301,6 +416,20 @@ Ipv6ListRouting::GetRoutingProtocol(uint32_t index, int16_t& priority) const
     return nullptr;
 }
 
+bool
+Ipv6ListRouting::RouteCacheKey::operator==(const RouteCacheKey& other) const
+{
+    return destination == other.destination && trafficClass == other.trafficClass &&
+           dev == other.dev;
+}
+
+size_t
+Ipv6ListRouting::RouteCacheKeyHash::operator()(const RouteCacheKey& key) const
+{
+    return Ipv6AddressHash()(key.destination) ^ std::hash<uint8_t>()(key.trafficClass) ^
+           std::hash<const NetDevice*>()(PeekPointer(key.dev));
+}
+
 bool
 Ipv6ListRouting::Compare(const Ipv6RoutingProtocolEntry& a, const Ipv6RoutingProtocolEntry& b)
 {
@@ -34,4 +34,10 @@ Ipv6RoutingProtocol::GetTypeId()
     return tid;
 }
 
+uint64_t
+Ipv6RoutingProtocol::GetRoutesGeneration() const
+{
+    return 0;
+}
+
 } /* namespace ns3 */
@@ -222,6 +222,19 @@ class Ipv6RoutingProtocol : public Object
      */
     virtual void PrintRoutingTable(Ptr<OutputStreamWrapper> stream,
                                    Time::Unit unit = Time::S) const = 0;
+
+    /**
+     * \brief Get the generation of the routes of this protocol.
+     *
+     * Protocols whose routes only depend on the destination, the traffic
+     * class and the interface of the packets (not on their contents or on
+     * random choices) can return a non-zero generation, which they change
+     * each time their routes change, so that Ipv6ListRouting can cache them.
+     * The default implementation returns zero: the routes can not be cached.
+     *
+     * \return the generation of the routes, or zero if they can not be cached
+     */
+    virtual uint64_t GetRoutesGeneration() const;
 };
 
 } // namespace ns3
@@ -49,7 +49,8 @@ Ipv6StaticRouting::GetTypeId()
 }
 
 Ipv6StaticRouting::Ipv6StaticRouting()
-    : m_ipv6(nullptr)
+    : m_ipv6(nullptr),
+      m_routesGeneration(1)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -80,6 +81,12 @@ Ipv6StaticRouting::SetIpv6(Ptr<Ipv6> ipv6)
     }
 }
 
+uint64_t
+Ipv6StaticRouting::GetRoutesGeneration() const
+{
+    return m_routesGeneration;
+}
+
 // Formatted like output of "route -n" command
 void
 Ipv6StaticRouting::PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Time::Unit unit) const
@@ -183,6 +190,7 @@ Ipv6StaticRouting::AddNetworkRouteTo(Ipv6Address network,
     {
         Ipv6RoutingTableEntry* routePtr = new Ipv6RoutingTableEntry(route);
         m_networkRoutes.emplace_back(routePtr, metric);
+        m_routesGeneration++;
     }
 }
 
@@ -210,6 +218,7 @@ Ipv6StaticRouting::AddNetworkRouteTo(Ipv6Address network,
     {
         Ipv6RoutingTableEntry* routePtr = new Ipv6RoutingTableEntry(route);
         m_networkRoutes.emplace_back(routePtr, metric);
+        m_routesGeneration++;
     }
 }
 
@@ -227,6 +236,7 @@ Ipv6StaticRouting::AddNetworkRouteTo(Ipv6Address network,
     {
         Ipv6RoutingTableEntry* routePtr = new Ipv6RoutingTableEntry(route);
         m_networkRoutes.emplace_back(routePtr, metric);
+        m_routesGeneration++;
     }
 }
 
@@ -269,6 +279,7 @@ Ipv6StaticRouting::SetDefaultMulticastRoute(uint32_t outputInterface)
     Ipv6Prefix networkMask = Ipv6Prefix(8);
     *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, outputInterface);
     m_networkRoutes.emplace_back(route, 0);
+    m_routesGeneration++;
 }
 
 uint32_t
@@ -491,6 +502,7 @@ Ipv6StaticRouting::DoDispose()
         delete j->first;
     }
     m_networkRoutes.clear();
+    m_routesGeneration++;
 
     for (MulticastRoutesI i = m_multicastRoutes.begin(); i != m_multicastRoutes.end();
          i = m_multicastRoutes.erase(i))
@@ -650,6 +662,7 @@ Ipv6StaticRouting::RemoveRoute(uint32_t index)
         {
             delete it->first;
             m_networkRoutes.erase(it);
+            m_routesGeneration++;
             return;
         }
         tmp++;
@@ -673,6 +686,7 @@ Ipv6StaticRouting::RemoveRoute(Ipv6Address network,
         {
             delete it->first;
             m_networkRoutes.erase(it);
+            m_routesGeneration++;
             return;
         }
     }
@@ -815,6 +829,7 @@ Ipv6StaticRouting::NotifyInterfaceDown(uint32_t i)
         {
             delete it->first;
             it = m_networkRoutes.erase(it);
+            m_routesGeneration++;
         }
         else
         {
@@ -853,6 +868,7 @@ Ipv6StaticRouting::NotifyRemoveAddress(uint32_t interface, Ipv6InterfaceAddress
         {
             delete it->first;
             it = m_networkRoutes.erase(it);
+            m_routesGeneration++;
         }
         else
         {
@@ -911,6 +927,7 @@ Ipv6StaticRouting::NotifyRemoveRoute(Ipv6Address dst,
             {
                 delete j->first;
                 j = m_networkRoutes.erase(j);
+                m_routesGeneration++;
             }
             else
             {
@@ -279,6 +279,7 @@ class Ipv6StaticRouting : public Ipv6RoutingProtocol
     void SetIpv6(Ptr<Ipv6> ipv6) override;
     void PrintRoutingTable(Ptr<OutputStreamWrapper> stream,
                            Time::Unit unit = Time::S) const override;
+    uint64_t GetRoutesGeneration() const override;
 
   protected:
     /**
@@ -344,6 +345,11 @@ class Ipv6StaticRouting : public Ipv6RoutingProtocol
      * \brief Ipv6 reference.
      */
     Ptr<Ipv6> m_ipv6;
+
+    /**
+     * \brief Generation of the routes, changed each time they change.
+     */
+    uint64_t m_routesGeneration;
 };
 
 } /* namespace ns3 */
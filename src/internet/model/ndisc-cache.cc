@@ -101,9 +101,10 @@ NdiscCache::Lookup(Ipv6Address dst)
 {
     NS_LOG_FUNCTION(this << dst);
 
-    if (m_ndCache.find(dst) != m_ndCache.end())
+    CacheI it = m_ndCache.find(dst);
+    if (it != m_ndCache.end())
     {
-        NdiscCache::Entry* entry = m_ndCache[dst];
+        NdiscCache::Entry* entry = it->second;
         NS_LOG_LOGIC("Found an entry: " << *entry);
 
         return entry;
@@ -127,6 +128,9 @@ NdiscCache::LookupInverse(Address dst)
             entryList.push_back(entry);
         }
     }
+    entryList.sort([](const NdiscCache::Entry* a, const NdiscCache::Entry* b) {
+        return a->GetIpv6Address() < b->GetIpv6Address();
+    });
     return entryList;
 }
 
@@ -147,15 +151,12 @@ NdiscCache::Remove(NdiscCache::Entry* entry)
 {
     NS_LOG_FUNCTION(this << entry);
 
-    for (CacheI i = m_ndCache.begin(); i != m_ndCache.end(); i++)
+    CacheI it = m_ndCache.find(entry->GetIpv6Address());
+    if (it != m_ndCache.end() && it->second == entry)
     {
-        if ((*i).second == entry)
-        {
-            m_ndCache.erase(i);
-            entry->ClearWaitingPacket();
-            delete entry;
-            return;
-        }
+        m_ndCache.erase(it);
+        entry->ClearWaitingPacket();
+        delete entry;
     }
 }
 
@@ -192,7 +193,9 @@ NdiscCache::PrintNdiscCache(Ptr<OutputStreamWrapper> stream)
     NS_LOG_FUNCTION(this << stream);
     std::ostream* os = stream->GetStream();
 
-    for (CacheI i = m_ndCache.begin(); i != m_ndCache.end(); i++)
+    // print the entries in address order
+    std::map<Ipv6Address, NdiscCache::Entry*> entries(m_ndCache.begin(), m_ndCache.end());
+    for (auto i = entries.begin(); i != entries.end(); i++)
     {
         *os << i->first << " dev ";
         std::string found = Names::FindName(m_device);
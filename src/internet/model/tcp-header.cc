@@ -19,9 +19,12 @@
 
 #include "tcp-header.h"
 
+#include "tcp-option-rfc793.h"
+#include "tcp-option-sack-permitted.h"
+#include "tcp-option-ts.h"
+#include "tcp-option-winscale.h"
 #include "tcp-option.h"
 
-#include "ns3/address-utils.h"
 #include "ns3/buffer.h"
 #include "ns3/log.h"
 
@@ -46,7 +49,14 @@ TcpHeader::TcpHeader()
       m_urgentPointer(0),
       m_calcChecksum(false),
       m_goodChecksum(true),
-      m_optionsLen(0)
+      m_optionsLen(0),
+      m_nOptions(0),
+      m_inlineOptions(0),
+      m_mss(0),
+      m_windowScale(0),
+      m_timestamp(0),
+      m_timestampEcho(0),
+      m_nSackBlocks(0)
 {
 }
 
@@ -220,36 +230,38 @@ TcpHeader::CalculateHeaderChecksum(uint16_t size) const
     /* Zero                   3 bytes                                        */
     /* Next header            1 byte                                         */
 
-    uint32_t maxHdrSz = (2 * Address::MAX_SIZE) + 8;
-    Buffer buf = Buffer(maxHdrSz);
-    buf.AddAtStart(maxHdrSz);
-    Buffer::Iterator it = buf.Begin();
-    uint32_t hdrSize = 0;
+    /* The pseudo-header is summed in place, without allocating a Buffer */
 
-    WriteTo(it, m_source);
-    WriteTo(it, m_destination);
+    uint8_t buf[(2 * Address::MAX_SIZE) + 8] = {0};
+    uint32_t hdrSize = m_source.CopyTo(buf);
+    hdrSize += m_destination.CopyTo(buf + hdrSize);
     if (Ipv4Address::IsMatchingType(m_source))
     {
-        it.WriteU8(0);           /* protocol */
-        it.WriteU8(m_protocol);  /* protocol */
-        it.WriteU8(size >> 8);   /* length */
-        it.WriteU8(size & 0xff); /* length */
+        buf[hdrSize + 1] = m_protocol;  /* protocol */
+        buf[hdrSize + 2] = size >> 8;   /* length */
+        buf[hdrSize + 3] = size & 0xff; /* length */
         hdrSize = 12;
     }
     else
     {
-        it.WriteU16(0);
-        it.WriteU8(size >> 8);   /* length */
-        it.WriteU8(size & 0xff); /* length */
-        it.WriteU16(0);
-        it.WriteU8(0);
-        it.WriteU8(m_protocol); /* protocol */
+        buf[hdrSize + 2] = size >> 8;   /* length */
+        buf[hdrSize + 3] = size & 0xff; /* length */
+        buf[hdrSize + 7] = m_protocol;  /* protocol */
         hdrSize = 40;
     }
 
-    it = buf.Begin();
+    /* same sum as Buffer::Iterator::CalculateIpChecksum, see RFC 1071 */
+    uint32_t sum = 0;
+    for (uint32_t j = 0; j < hdrSize; j += 2)
+    {
+        sum += buf[j] | (buf[j + 1] << 8);
+    }
+    while (sum >> 16)
+    {
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
     /* we don't CompleteChecksum ( ~ ) now */
-    return ~(it.CalculateIpChecksum(hdrSize));
+    return sum;
 }
 
 bool
@@ -286,9 +298,10 @@ TcpHeader::Print(std::ostream& os) const
 
     os << " Seq=" << m_sequenceNumber << " Ack=" << m_ackNumber << " Win=" << m_windowSize;
 
+    const TcpOptionList& options = GetOptionList();
     TcpOptionList::const_iterator op;
 
-    for (op = m_options.begin(); op != m_options.end(); ++op)
+    for (op = options.begin(); op != options.end(); ++op)
     {
         os << " " << (*op)->GetInstanceTypeId().GetName() << "(";
         (*op)->Print(os);
@@ -319,12 +332,53 @@ TcpHeader::Serialize(Buffer::Iterator start) const
     // This implementation does not presently try to align options on word
     // boundaries using NOP options
     uint32_t optionLen = 0;
-    TcpOptionList::const_iterator op;
-    for (op = m_options.begin(); op != m_options.end(); ++op)
+    TcpOptionList::const_iterator op = m_otherOptions.begin();
+    for (uint8_t k = 0; k < m_nOptions; ++k)
     {
-        optionLen += (*op)->GetSerializedSize();
-        (*op)->Serialize(i);
-        i.Next((*op)->GetSerializedSize());
+        uint8_t kind = m_optionKinds[k];
+        switch (kind)
+        {
+        case TcpOption::END:
+        case TcpOption::NOP:
+            i.WriteU8(kind);
+            break;
+        case TcpOption::MSS:
+            i.WriteU8(kind);
+            i.WriteU8(4);
+            i.WriteHtonU16(m_mss);
+            break;
+        case TcpOption::WINSCALE:
+            i.WriteU8(kind);
+            i.WriteU8(3);
+            i.WriteU8(m_windowScale);
+            break;
+        case TcpOption::SACKPERMITTED:
+            i.WriteU8(kind);
+            i.WriteU8(2);
+            break;
+        case TcpOption::SACK:
+            i.WriteU8(kind);
+            i.WriteU8(GetInlineOptionSize(kind));
+            for (uint8_t b = 0; b < m_nSackBlocks; ++b)
+            {
+                i.WriteHtonU32(m_sackBlocks[b].first.GetValue());
+                i.WriteHtonU32(m_sackBlocks[b].second.GetValue());
+            }
+            break;
+        case TcpOption::TS:
+            i.WriteU8(kind);
+            i.WriteU8(10);
+            i.WriteHtonU32(m_timestamp);
+            i.WriteHtonU32(m_timestampEcho);
+            break;
+        default:
+            optionLen += (*op)->GetSerializedSize();
+            (*op)->Serialize(i);
+            i.Next((*op)->GetSerializedSize());
+            ++op;
+            continue;
+        }
+        optionLen += GetInlineOptionSize(kind);
     }
 
     // padding to word alignment; add ENDs and/or pad values (they are the same)
@@ -364,6 +418,9 @@ TcpHeader::Deserialize(Buffer::Iterator start)
     m_urgentPointer = i.ReadNtohU16();
 
     // Deserialize options if they exist
+    m_nOptions = 0;
+    m_inlineOptions = 0;
+    m_otherOptions.clear();
     m_options.clear();
     uint32_t optionLen = (m_length - 5) * 4;
     if (optionLen > m_maxOptionsLen)
@@ -376,17 +433,30 @@ TcpHeader::Deserialize(Buffer::Iterator start)
         uint8_t kind = i.PeekU8();
         Ptr<TcpOption> op;
         uint32_t optionSize;
-        if (TcpOption::IsKindKnown(kind))
+        if (TcpOption::IsKindKnown(kind) &&
+            (kind <= TcpOption::NOP || !(m_inlineOptions & (1 << kind))))
         {
-            op = TcpOption::CreateOption(kind);
+            // the first option of each kind is kept inline
+            optionSize = DeserializeInlineOption(i);
         }
         else
         {
-            op = TcpOption::CreateOption(TcpOption::UNKNOWN);
-            NS_LOG_WARN("Option kind " << static_cast<int>(kind) << " unknown, skipping.");
+            if (TcpOption::IsKindKnown(kind))
+            {
+                op = TcpOption::CreateOption(kind);
+            }
+            else
+            {
+                op = TcpOption::CreateOption(TcpOption::UNKNOWN);
+                NS_LOG_WARN("Option kind " << static_cast<int>(kind) << " unknown, skipping.");
+            }
+            optionSize = op->Deserialize(i);
+            if (optionSize != op->GetSerializedSize())
+            {
+                optionSize = 0;
+            }
         }
-        optionSize = op->Deserialize(i);
-        if (optionSize != op->GetSerializedSize())
+        if (optionSize == 0)
         {
             NS_LOG_ERROR("Option did not deserialize correctly");
             break;
@@ -395,7 +465,15 @@ TcpHeader::Deserialize(Buffer::Iterator start)
         {
             optionLen -= optionSize;
             i.Next(optionSize);
-            m_options.emplace_back(op);
+            if (op)
+            {
+                m_optionKinds[m_nOptions++] = TcpOption::UNKNOWN;
+                m_otherOptions.emplace_back(op);
+            }
+            else
+            {
+                AddInlineOption(kind);
+            }
             m_optionsLen += optionSize;
         }
         else
@@ -403,7 +481,7 @@ TcpHeader::Deserialize(Buffer::Iterator start)
             NS_LOG_ERROR("Option exceeds TCP option space; option discarded");
             break;
         }
-        if (op->GetKind() == TcpOption::END)
+        if (kind == TcpOption::END)
         {
             while (optionLen)
             {
@@ -436,11 +514,19 @@ uint8_t
 TcpHeader::CalculateHeaderLength() const
 {
     uint32_t len = 20;
-    TcpOptionList::const_iterator i;
+    TcpOptionList::const_iterator op = m_otherOptions.begin();
 
-    for (i = m_options.begin(); i != m_options.end(); ++i)
+    for (uint8_t k = 0; k < m_nOptions; ++k)
     {
-        len += (*i)->GetSerializedSize();
+        if (m_optionKinds[k] == TcpOption::UNKNOWN)
+        {
+            len += (*op)->GetSerializedSize();
+            ++op;
+        }
+        else
+        {
+            len += GetInlineOptionSize(m_optionKinds[k]);
+        }
     }
     // Option list may not include padding; need to pad up to word boundary
     if (len % 4)
@@ -461,9 +547,19 @@ TcpHeader::AppendOption(Ptr<const TcpOption> option)
             return false;
         }
 
-        if (option->GetKind() != TcpOption::END)
+        uint8_t kind = option->GetKind();
+        if (kind != TcpOption::END)
         {
-            m_options.push_back(option);
+            if (kind == TcpOption::NOP || !(m_inlineOptions & (1 << kind)))
+            {
+                StoreInlineOption(option);
+            }
+            else
+            {
+                m_optionKinds[m_nOptions++] = TcpOption::UNKNOWN;
+                m_otherOptions.push_back(option);
+                m_options.clear();
+            }
             m_optionsLen += option->GetSerializedSize();
 
             uint32_t totalLen = 20 + 3 + m_optionsLen;
@@ -479,15 +575,37 @@ TcpHeader::AppendOption(Ptr<const TcpOption> option)
 const TcpHeader::TcpOptionList&
 TcpHeader::GetOptionList() const
 {
+    if (m_options.empty() && m_nOptions > 0)
+    {
+        TcpOptionList::const_iterator op = m_otherOptions.begin();
+        for (uint8_t k = 0; k < m_nOptions; ++k)
+        {
+            if (m_optionKinds[k] == TcpOption::UNKNOWN)
+            {
+                m_options.push_back(*op);
+                ++op;
+            }
+            else
+            {
+                m_options.push_back(CreateInlineOption(m_optionKinds[k]));
+            }
+        }
+    }
     return m_options;
 }
 
 Ptr<const TcpOption>
 TcpHeader::GetOption(uint8_t kind) const
 {
+    if (TcpOption::IsKindKnown(kind))
+    {
+        // the first option of each known kind is kept inline
+        return (m_inlineOptions & (1 << kind)) ? CreateInlineOption(kind) : nullptr;
+    }
+
     TcpOptionList::const_iterator i;
 
-    for (i = m_options.begin(); i != m_options.end(); ++i)
+    for (i = m_otherOptions.begin(); i != m_otherOptions.end(); ++i)
     {
         if ((*i)->GetKind() == kind)
         {
@@ -501,9 +619,14 @@ TcpHeader::GetOption(uint8_t kind) const
 bool
 TcpHeader::HasOption(uint8_t kind) const
 {
+    if (TcpOption::IsKindKnown(kind))
+    {
+        return (m_inlineOptions & (1 << kind)) != 0;
+    }
+
     TcpOptionList::const_iterator i;
 
-    for (i = m_options.begin(); i != m_options.end(); ++i)
+    for (i = m_otherOptions.begin(); i != m_otherOptions.end(); ++i)
     {
         if ((*i)->GetKind() == kind)
         {
@@ -514,6 +637,258 @@ TcpHeader::HasOption(uint8_t kind) const
     return false;
 }
 
+bool
+TcpHeader::GetWindowScaleOption(uint8_t& scale) const
+{
+    if (!HasOption(TcpOption::WINSCALE))
+    {
+        return false;
+    }
+    scale = m_windowScale;
+    return true;
+}
+
+bool
+TcpHeader::GetTimestampOption(uint32_t& timestamp, uint32_t& echo) const
+{
+    if (!HasOption(TcpOption::TS))
+    {
+        return false;
+    }
+    timestamp = m_timestamp;
+    echo = m_timestampEcho;
+    return true;
+}
+
+bool
+TcpHeader::GetSackOption(TcpOptionSack::SackList& sackList) const
+{
+    if (!HasOption(TcpOption::SACK))
+    {
+        return false;
+    }
+    sackList.assign(m_sackBlocks, m_sackBlocks + m_nSackBlocks);
+    return true;
+}
+
+bool
+TcpHeader::AppendWindowScaleOption(uint8_t scale)
+{
+    if (!ReserveInlineOption(TcpOption::WINSCALE, 3))
+    {
+        return false;
+    }
+    m_windowScale = scale;
+    return true;
+}
+
+bool
+TcpHeader::AppendSackPermittedOption()
+{
+    return ReserveInlineOption(TcpOption::SACKPERMITTED, 2);
+}
+
+bool
+TcpHeader::AppendTimestampOption(uint32_t timestamp, uint32_t echo)
+{
+    if (!ReserveInlineOption(TcpOption::TS, 10))
+    {
+        return false;
+    }
+    m_timestamp = timestamp;
+    m_timestampEcho = echo;
+    return true;
+}
+
+bool
+TcpHeader::AppendSackOption(const TcpOptionSack::SackList& sackList)
+{
+    if (sackList.size() > m_maxSackBlocks ||
+        !ReserveInlineOption(TcpOption::SACK, 2 + 8 * sackList.size()))
+    {
+        return false;
+    }
+    m_nSackBlocks = 0;
+    for (const auto& block : sackList)
+    {
+        m_sackBlocks[m_nSackBlocks++] = block;
+    }
+    return true;
+}
+
+bool
+TcpHeader::ReserveInlineOption(uint8_t kind, uint8_t size)
+{
+    if (m_optionsLen + size > m_maxOptionsLen || (m_inlineOptions & (1 << kind)))
+    {
+        return false;
+    }
+
+    AddInlineOption(kind);
+    m_optionsLen += size;
+
+    uint32_t totalLen = 20 + 3 + m_optionsLen;
+    m_length = totalLen >> 2;
+    return true;
+}
+
+void
+TcpHeader::AddInlineOption(uint8_t kind)
+{
+    m_optionKinds[m_nOptions++] = kind;
+    m_inlineOptions |= (1 << kind);
+    m_options.clear();
+}
+
+void
+TcpHeader::StoreInlineOption(Ptr<const TcpOption> option)
+{
+    uint8_t kind = option->GetKind();
+    switch (kind)
+    {
+    case TcpOption::MSS:
+        m_mss = DynamicCast<const TcpOptionMSS>(option)->GetMSS();
+        break;
+    case TcpOption::WINSCALE:
+        m_windowScale = DynamicCast<const TcpOptionWinScale>(option)->GetScale();
+        break;
+    case TcpOption::SACK: {
+        TcpOptionSack::SackList sackList = DynamicCast<const TcpOptionSack>(option)->GetSackList();
+        m_nSackBlocks = 0;
+        for (const auto& block : sackList)
+        {
+            m_sackBlocks[m_nSackBlocks++] = block;
+        }
+        break;
+    }
+    case TcpOption::TS: {
+        Ptr<const TcpOptionTS> ts = DynamicCast<const TcpOptionTS>(option);
+        m_timestamp = ts->GetTimestamp();
+        m_timestampEcho = ts->GetEcho();
+        break;
+    }
+    default:
+        break;
+    }
+    AddInlineOption(kind);
+}
+
+uint8_t
+TcpHeader::GetInlineOptionSize(uint8_t kind) const
+{
+    switch (kind)
+    {
+    case TcpOption::MSS:
+        return 4;
+    case TcpOption::WINSCALE:
+        return 3;
+    case TcpOption::SACKPERMITTED:
+        return 2;
+    case TcpOption::SACK:
+        return 2 + 8 * m_nSackBlocks;
+    case TcpOption::TS:
+        return 10;
+    default:
+        return 1;
+    }
+}
+
+Ptr<const TcpOption>
+TcpHeader::CreateInlineOption(uint8_t kind) const
+{
+    switch (kind)
+    {
+    case TcpOption::MSS: {
+        Ptr<TcpOptionMSS> mss = CreateObject<TcpOptionMSS>();
+        mss->SetMSS(m_mss);
+        return mss;
+    }
+    case TcpOption::WINSCALE: {
+        Ptr<TcpOptionWinScale> ws = CreateObject<TcpOptionWinScale>();
+        ws->SetScale(m_windowScale);
+        return ws;
+    }
+    case TcpOption::SACK: {
+        Ptr<TcpOptionSack> sack = CreateObject<TcpOptionSack>();
+        for (uint8_t b = 0; b < m_nSackBlocks; ++b)
+        {
+            sack->AddSackBlock(m_sackBlocks[b]);
+        }
+        return sack;
+    }
+    case TcpOption::TS: {
+        Ptr<TcpOptionTS> ts = CreateObject<TcpOptionTS>();
+        ts->SetTimestamp(m_timestamp);
+        ts->SetEcho(m_timestampEcho);
+        return ts;
+    }
+    default:
+        return TcpOption::CreateOption(kind);
+    }
+}
+
+uint32_t
+TcpHeader::DeserializeInlineOption(Buffer::Iterator start)
+{
+    Buffer::Iterator i = start;
+    uint8_t kind = i.ReadU8();
+    if (kind == TcpOption::END || kind == TcpOption::NOP)
+    {
+        return 1;
+    }
+
+    uint8_t size = i.ReadU8();
+    switch (kind)
+    {
+    case TcpOption::MSS:
+        if (size != 4)
+        {
+            NS_LOG_WARN("Malformed MSS option");
+            return 0;
+        }
+        m_mss = i.ReadNtohU16();
+        break;
+    case TcpOption::WINSCALE:
+        if (size != 3)
+        {
+            NS_LOG_WARN("Malformed Window Scale option");
+            return 0;
+        }
+        m_windowScale = i.ReadU8();
+        break;
+    case TcpOption::SACKPERMITTED:
+        if (size != 2)
+        {
+            NS_LOG_WARN("Malformed Sack-Permitted option");
+            return 0;
+        }
+        break;
+    case TcpOption::SACK:
+        if (size < 2 || (size - 2) % 8 != 0 || (size - 2) / 8 > m_maxSackBlocks)
+        {
+            NS_LOG_WARN("Malformed SACK option");
+            return 0;
+        }
+        m_nSackBlocks = (size - 2) / 8;
+        for (uint8_t b = 0; b < m_nSackBlocks; ++b)
+        {
+            m_sackBlocks[b].first = SequenceNumber32(i.ReadNtohU32());
+            m_sackBlocks[b].second = SequenceNumber32(i.ReadNtohU32());
+        }
+        break;
+    case TcpOption::TS:
+        if (size != 10)
+        {
+            NS_LOG_WARN("Malformed Timestamp option");
+            return 0;
+        }
+        m_timestamp = i.ReadNtohU32();
+        m_timestampEcho = i.ReadNtohU32();
+        break;
+    }
+    return GetInlineOptionSize(kind);
+}
+
 bool
 operator==(const TcpHeader& lhs, const TcpHeader& rhs)
 {
@@ -25,6 +25,7 @@
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv6-address.h"
 #include "ns3/sequence-number.h"
+#include "ns3/tcp-option-sack.h"
 #include "ns3/tcp-option.h"
 #include "ns3/tcp-socket-factory.h"
 
@@ -40,6 +41,14 @@ namespace ns3
  * This class has fields corresponding to those in a network TCP header
  * (port numbers, sequence and acknowledgement numbers, flags, etc) as well
  * as methods for serialization to and deserialization from a byte buffer.
+ *
+ * The options with a fixed layout (MSS, window scale, SACK-permitted,
+ * timestamp and SACK) are kept inline in the header, so that serializing
+ * and deserializing them does not create any TcpOption object. Such
+ * objects are built only when requested through GetOption or
+ * GetOptionList; the typed accessors (e.g., GetTimestampOption) read the
+ * inline values directly. The options of other kinds, and the repeated
+ * ones, are kept as TcpOption objects.
  */
 
 class TcpHeader : public Header
@@ -220,6 +229,60 @@ class TcpHeader : public Header
      */
     bool AppendOption(Ptr<const TcpOption> option);
 
+    /**
+     * \brief Get the value of the window scale option
+     * \param [out] scale the shift count carried by the option
+     * \return true if the header has the option, false otherwise
+     */
+    bool GetWindowScaleOption(uint8_t& scale) const;
+
+    /**
+     * \brief Get the values of the timestamp option
+     * \param [out] timestamp the timestamp value carried by the option
+     * \param [out] echo the timestamp echo reply carried by the option
+     * \return true if the header has the option, false otherwise
+     */
+    bool GetTimestampOption(uint32_t& timestamp, uint32_t& echo) const;
+
+    /**
+     * \brief Get the blocks of the SACK option
+     * \param [out] sackList the SACK blocks carried by the option
+     * \return true if the header has the option, false otherwise
+     */
+    bool GetSackOption(TcpOptionSack::SackList& sackList) const;
+
+    /**
+     * \brief Append a window scale option to the TCP header
+     * \param scale the shift count
+     * \return true if option has been appended, false if there is no space
+     *         left or the header has already the option
+     */
+    bool AppendWindowScaleOption(uint8_t scale);
+
+    /**
+     * \brief Append a SACK-permitted option to the TCP header
+     * \return true if option has been appended, false if there is no space
+     *         left or the header has already the option
+     */
+    bool AppendSackPermittedOption();
+
+    /**
+     * \brief Append a timestamp option to the TCP header
+     * \param timestamp the timestamp value
+     * \param echo the timestamp echo reply
+     * \return true if option has been appended, false if there is no space
+     *         left or the header has already the option
+     */
+    bool AppendTimestampOption(uint32_t timestamp, uint32_t echo);
+
+    /**
+     * \brief Append a SACK option to the TCP header
+     * \param sackList the SACK blocks
+     * \return true if option has been appended, false if there is no space
+     *         left or the header has already the option
+     */
+    bool AppendSackOption(const TcpOptionSack::SackList& sackList);
+
     /**
      * \brief Initialize the TCP checksum.
      *
@@ -331,6 +394,52 @@ class TcpHeader : public Header
      */
     uint8_t CalculateHeaderLength() const;
 
+    /**
+     * \brief Reserve the space for an option kept inline in the header
+     * \param kind the kind of the option
+     * \param size the serialized size of the option
+     * \return true if the option can be appended, false if there is no space
+     *         left or the header has already the option
+     */
+    bool ReserveInlineOption(uint8_t kind, uint8_t size);
+
+    /**
+     * \brief Record that the header holds an option inline
+     * \param kind the kind of the option
+     */
+    void AddInlineOption(uint8_t kind);
+
+    /**
+     * \brief Store the values of an option inline in the header
+     * \param option the option
+     */
+    void StoreInlineOption(Ptr<const TcpOption> option);
+
+    /**
+     * \brief Get the serialized size of an option kept inline in the header
+     * \param kind the kind of the option
+     * \return the size of the option
+     */
+    uint8_t GetInlineOptionSize(uint8_t kind) const;
+
+    /**
+     * \brief Build a TcpOption object from an option kept inline in the header
+     * \param kind the kind of the option
+     * \return the option
+     */
+    Ptr<const TcpOption> CreateInlineOption(uint8_t kind) const;
+
+    /**
+     * \brief Deserialize an option to be kept inline in the header
+     *
+     * The values are stored in the inline fields, but the option is not
+     * recorded, see AddInlineOption.
+     *
+     * \param start the buffer iterator pointing at the option
+     * \return the size of the option, or 0 if the option is malformed
+     */
+    uint32_t DeserializeInlineOption(Buffer::Iterator start);
+
     uint16_t m_sourcePort;             //!< Source port
     uint16_t m_destinationPort;        //!< Destination port
     SequenceNumber32 m_sequenceNumber; //!< Sequence number
@@ -348,8 +457,27 @@ class TcpHeader : public Header
     bool m_goodChecksum; //!< Flag to indicate that checksum is correct
 
     static const uint8_t m_maxOptionsLen = 40; //!< Maximum options length
-    TcpOptionList m_options;                   //!< TcpOption present in the header
     uint8_t m_optionsLen;                      //!< Tcp options length.
+
+    /// Maximum number of blocks of a SACK option
+    static const uint8_t m_maxSackBlocks = (m_maxOptionsLen - 2) / 8;
+
+    /**
+     * \brief Kinds of the options, in the order they appear in the header
+     *
+     * The options kept as TcpOption objects are recorded as TcpOption::UNKNOWN.
+     */
+    uint8_t m_optionKinds[m_maxOptionsLen];
+    uint8_t m_nOptions;                                     //!< Number of options
+    uint16_t m_inlineOptions;                               //!< Bitmask of the inline option kinds
+    uint16_t m_mss;                                         //!< MSS option value
+    uint8_t m_windowScale;                                  //!< Window scale option value
+    uint32_t m_timestamp;                                   //!< Timestamp option value
+    uint32_t m_timestampEcho;                               //!< Timestamp option echo reply
+    TcpOptionSack::SackBlock m_sackBlocks[m_maxSackBlocks]; //!< SACK option blocks
+    uint8_t m_nSackBlocks;                                  //!< Number of SACK option blocks
+    TcpOptionList m_otherOptions;                           //!< Options kept as objects
+    mutable TcpOptionList m_options;                        //!< Options built by GetOptionList
 };
 
 } // namespace ns3
@@ -39,6 +39,7 @@
 
 #include "ns3/assert.h"
 #include "ns3/boolean.h"
+#include "ns3/gso-tag.h"
 #include "ns3/log.h"
 #include "ns3/node.h"
 #include "ns3/nstime.h"
@@ -46,6 +47,7 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
 #include <unordered_map>
@@ -472,14 +474,13 @@ TcpL4Protocol::Receive(Ptr<Packet> packet,
         return checksumControl;
     }
 
-    Ipv4EndPointDemux::EndPoints endPoints;
-    endPoints = m_endPoints->Lookup(incomingIpHeader.GetDestination(),
-                                    incomingTcpHeader.GetDestinationPort(),
-                                    incomingIpHeader.GetSource(),
-                                    incomingTcpHeader.GetSourcePort(),
-                                    incomingInterface);
+    Ipv4EndPoint* endPoint = m_endPoints->LookupEndPoint(incomingIpHeader.GetDestination(),
+                                                         incomingTcpHeader.GetDestinationPort(),
+                                                         incomingIpHeader.GetSource(),
+                                                         incomingTcpHeader.GetSourcePort(),
+                                                         incomingInterface);
 
-    if (endPoints.empty())
+    if (!endPoint)
     {
         if (this->GetObject<Ipv6L3Protocol>())
         {
@@ -512,13 +513,14 @@ TcpL4Protocol::Receive(Ptr<Packet> packet,
         return IpL4Protocol::RX_ENDPOINT_CLOSED;
     }
 
-    NS_ASSERT_MSG(endPoints.size() == 1, "Demux returned more than one endpoint");
     NS_LOG_LOGIC("TcpL4Protocol " << this
                                   << " received a packet and"
                                      " now forwarding it up to endpoint/socket");
 
-    (*endPoints.begin())
-        ->ForwardUp(packet, incomingIpHeader, incomingTcpHeader.GetSourcePort(), incomingInterface);
+    endPoint->ForwardUp(packet,
+                        incomingIpHeader,
+                        incomingTcpHeader.GetSourcePort(),
+                        incomingInterface);
 
     return IpL4Protocol::RX_OK;
 }
@@ -548,13 +550,12 @@ TcpL4Protocol::Receive(Ptr<Packet> packet,
         return checksumControl;
     }
 
-    Ipv6EndPointDemux::EndPoints endPoints =
-        m_endPoints6->Lookup(incomingIpHeader.GetDestination(),
-                             incomingTcpHeader.GetDestinationPort(),
-                             incomingIpHeader.GetSource(),
-                             incomingTcpHeader.GetSourcePort(),
-                             interface);
-    if (endPoints.empty())
+    Ipv6EndPoint* endPoint = m_endPoints6->LookupEndPoint(incomingIpHeader.GetDestination(),
+                                                          incomingTcpHeader.GetDestinationPort(),
+                                                          incomingIpHeader.GetSource(),
+                                                          incomingTcpHeader.GetSourcePort(),
+                                                          interface);
+    if (!endPoint)
     {
         NS_LOG_LOGIC("TcpL4Protocol "
                      << this
@@ -572,13 +573,11 @@ TcpL4Protocol::Receive(Ptr<Packet> packet,
         return IpL4Protocol::RX_ENDPOINT_CLOSED;
     }
 
-    NS_ASSERT_MSG(endPoints.size() == 1, "Demux returned more than one endpoint");
     NS_LOG_LOGIC("TcpL4Protocol " << this
                                   << " received a packet and"
                                      " now forwarding it up to endpoint/socket");
 
-    (*endPoints.begin())
-        ->ForwardUp(packet, incomingIpHeader, incomingTcpHeader.GetSourcePort(), interface);
+    endPoint->ForwardUp(packet, incomingIpHeader, incomingTcpHeader.GetSourcePort(), interface);
 
     return IpL4Protocol::RX_OK;
 }
@@ -600,7 +599,9 @@ TcpL4Protocol::SendPacketV4(Ptr<Packet> packet,
     TcpHeader outgoingHeader = outgoing;
     /** \todo UrgentPointer */
     /* outgoingHeader.SetUrgentPointer (0); */
-    if (Node::ChecksumEnabled())
+    // The checksums of a super-segment are computed on its segments
+    GsoTag gsoTag;
+    if (Node::ChecksumEnabled() && !packet->PeekPacketTag(gsoTag))
     {
         outgoingHeader.EnableChecksums();
     }
@@ -659,7 +660,9 @@ TcpL4Protocol::SendPacketV6(Ptr<Packet> packet,
     TcpHeader outgoingHeader = outgoing;
     /** \todo UrgentPointer */
     /* outgoingHeader.SetUrgentPointer (0); */
-    if (Node::ChecksumEnabled())
+    // The checksums of a super-segment are computed on its segments
+    GsoTag gsoTag;
+    if (Node::ChecksumEnabled() && !packet->PeekPacketTag(gsoTag))
     {
         outgoingHeader.EnableChecksums();
     }
@@ -693,6 +696,44 @@ TcpL4Protocol::SendPacketV6(Ptr<Packet> packet,
     }
 }
 
+std::vector<Ptr<Packet>>
+TcpL4Protocol::SegmentGso(Ptr<Packet> packet,
+                          uint16_t segmentSize,
+                          const Address& source,
+                          const Address& destination) const
+{
+    NS_LOG_FUNCTION(this << packet << segmentSize << source << destination);
+    NS_ASSERT(segmentSize > 0);
+
+    TcpHeader header;
+    packet->RemoveHeader(header);
+    uint8_t flags = header.GetFlags();
+    uint32_t size = packet->GetSize();
+
+    std::vector<Ptr<Packet>> segments;
+    segments.reserve((size + segmentSize - 1) / segmentSize);
+    for (uint32_t offset = 0; offset < size; offset += segmentSize)
+    {
+        uint32_t length = std::min<uint32_t>(segmentSize, size - offset);
+        Ptr<Packet> segment = packet->CreateFragment(offset, length);
+
+        TcpHeader segmentHeader = header;
+        segmentHeader.SetSequenceNumber(header.GetSequenceNumber() + SequenceNumber32(offset));
+        if (offset + length < size)
+        {
+            segmentHeader.SetFlags(flags & ~TcpHeader::FIN);
+        }
+        if (Node::ChecksumEnabled())
+        {
+            segmentHeader.EnableChecksums();
+        }
+        segmentHeader.InitializeChecksum(source, destination, PROT_NUMBER);
+        segment->AddHeader(segmentHeader);
+        segments.push_back(segment);
+    }
+    return segments;
+}
+
 void
 TcpL4Protocol::SendPacket(Ptr<Packet> pkt,
                           const TcpHeader& outgoing,
@@ -28,6 +28,7 @@
 
 #include <stdint.h>
 #include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -229,6 +230,27 @@ class TcpL4Protocol : public IpL4Protocol
                     const Address& daddr,
                     Ptr<NetDevice> oif = nullptr) const;
 
+    /**
+     * \brief Split a super-segment into the segments it carries
+     *
+     * The super-segments are built by TcpSocketBase when the segmentation
+     * offload is emulated (see TcpSocketBase attribute GsoMaxSize), and are
+     * marked with a GsoTag. Each segment gets a copy of the header of the
+     * super-segment with its own sequence number and checksum; the FIN flag,
+     * if any, is kept only in the last segment. The tags of the super-segment
+     * are copied to all the segments.
+     *
+     * \param packet the super-segment, with its TCP header and without the GsoTag
+     * \param segmentSize the payload size of the segments
+     * \param source the source address, used for the checksum
+     * \param destination the destination address, used for the checksum
+     * \return the segments, in sequence order
+     */
+    std::vector<Ptr<Packet>> SegmentGso(Ptr<Packet> packet,
+                                        uint16_t segmentSize,
+                                        const Address& source,
+                                        const Address& destination) const override;
+
     /**
      * \brief Make a socket fully operational
      *
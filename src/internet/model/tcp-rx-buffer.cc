@@ -22,6 +22,8 @@
 #include "ns3/log.h"
 #include "ns3/packet.h"
 
+#include <iterator>
+
 namespace ns3
 {
 
@@ -171,15 +173,20 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
             headSeq = tailSeq;
         }
     }
-    // Remove overlapped bytes from packet
-    BufIterator i = m_data.begin();
+    // Remove overlapped bytes from packet. The buffered ranges are disjoint,
+    // hence the ranges before the one preceding headSeq can not overlap
+    BufIterator i = m_data.upper_bound(headSeq);
+    if (i != m_data.begin())
+    {
+        --i;
+    }
     while (i != m_data.end() && i->first <= tailSeq)
     {
         SequenceNumber32 lastByteSeq = i->first + SequenceNumber32(i->second->GetSize());
         if (lastByteSeq > headSeq)
         {
             if (i->first > headSeq && lastByteSeq < tailSeq)
-            { // Rare case: Existing packet is embedded fully in the new packet
+            { // Rare case: Existing range is embedded fully in the new packet
                 m_size -= i->second->GetSize();
                 m_data.erase(i++);
                 continue;
@@ -201,16 +208,17 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
         NS_LOG_LOGIC("Nothing to buffer");
         return false; // Nothing to buffer anyway
     }
-    else
-    {
-        uint32_t start = static_cast<uint32_t>(headSeq - tcph.GetSequenceNumber());
-        uint32_t length = static_cast<uint32_t>(tailSeq - headSeq);
-        p = p->CreateFragment(start, length);
-        NS_ASSERT(length == p->GetSize());
-    }
-    // Insert packet into buffer
+    // The buffer stores its own copy of the data: the packet of the caller is
+    // also seen by the trace sinks, and is never modified
+    uint32_t start = static_cast<uint32_t>(headSeq - tcph.GetSequenceNumber());
+    uint32_t length = static_cast<uint32_t>(tailSeq - headSeq);
+    Ptr<Packet> stored = p->CreateFragment(start, length);
+    NS_ASSERT(length == stored->GetSize());
+    // Insert the copy into buffer. The packet tags are not handed to the
+    // application, and the copy may become part of a larger range
     NS_ASSERT(m_data.find(headSeq) == m_data.end()); // Shouldn't be there yet
-    m_data[headSeq] = p;
+    stored->RemoveAllPacketTags();
+    i = m_data.insert(std::make_pair(headSeq, stored)).first;
 
     if (headSeq > m_nextRxSeq)
     {
@@ -218,22 +226,40 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
         UpdateSackList(headSeq, tailSeq);
     }
 
-    NS_LOG_LOGIC("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize());
+    NS_LOG_LOGIC("Buffered packet of seqno=" << headSeq << " len=" << stored->GetSize());
     // Update variables
-    m_size += p->GetSize(); // Occupancy
-    for (i = m_data.begin(); i != m_data.end(); ++i)
+    m_size += stored->GetSize(); // Occupancy
+
+    // Coalesce the copy with the adjacent ranges. The buffered ranges are
+    // owned by the buffer, hence they are extended in place
+    BufIterator next = std::next(i);
+    if (next != m_data.end() && next->first == tailSeq)
+    {
+        i->second->AddAtEnd(next->second);
+        m_data.erase(next);
+    }
+    if (i != m_data.begin())
     {
-        if (i->first < m_nextRxSeq)
+        BufIterator prev = std::prev(i);
+        if (prev->first + SequenceNumber32(prev->second->GetSize()) == headSeq)
         {
-            continue;
+            prev->second->AddAtEnd(i->second);
+            m_data.erase(i);
         }
-        else if (i->first > m_nextRxSeq)
+    }
+
+    // The range containing m_nextRxSeq, if any, becomes available
+    i = m_data.upper_bound(m_nextRxSeq);
+    if (i != m_data.begin())
+    {
+        --i;
+        SequenceNumber32 lastByteSeq = i->first + SequenceNumber32(i->second->GetSize());
+        if (lastByteSeq > m_nextRxSeq)
         {
-            break;
-        };
-        m_nextRxSeq = i->first + SequenceNumber32(i->second->GetSize());
-        m_availBytes += i->second->GetSize();
-        ClearSackList(m_nextRxSeq);
+            m_availBytes += static_cast<uint32_t>(lastByteSeq - m_nextRxSeq);
+            m_nextRxSeq = lastByteSeq;
+            ClearSackList(m_nextRxSeq);
+        }
     }
     NS_LOG_LOGIC("Updated buffer occupancy=" << m_size << " nextRxSeq=" << m_nextRxSeq);
     if (m_gotFin && m_nextRxSeq == m_finSeq)
@@ -388,18 +414,19 @@ TcpRxBuffer::Extract(uint32_t maxSize)
     {
         return nullptr; // No contiguous block to return
     }
-    NS_ASSERT(!m_data.empty());            // At least we have something to extract
-    Ptr<Packet> outPkt = Create<Packet>(); // The packet that contains all the data to return
+    NS_ASSERT(!m_data.empty()); // At least we have something to extract
+    Ptr<Packet> outPkt;         // The packet that contains all the data to return
     BufIterator i;
     while (extractSize)
     { // Check the buffered data for delivery
         i = m_data.begin();
         NS_ASSERT(i->first <= m_nextRxSeq); // in-sequence data expected
-        // Check if we send the whole pkt or just a partial
+        // Check if we send the whole range or just a partial
         uint32_t pktSize = i->second->GetSize();
+        Ptr<Packet> extracted;
         if (pktSize <= extractSize)
-        { // Whole packet is extracted
-            outPkt->AddAtEnd(i->second);
+        { // Whole range is extracted, without copying it
+            extracted = i->second;
             m_data.erase(i);
             m_size -= pktSize;
             m_availBytes -= pktSize;
@@ -407,14 +434,24 @@ TcpRxBuffer::Extract(uint32_t maxSize)
         }
         else
         { // Partial is extracted and done
-            outPkt->AddAtEnd(i->second->CreateFragment(0, extractSize));
-            m_data[i->first + SequenceNumber32(extractSize)] =
-                i->second->CreateFragment(extractSize, pktSize - extractSize);
+            extracted = i->second->CreateFragment(0, extractSize);
+            Ptr<Packet> remaining = i->second;
+            SequenceNumber32 remainingSeq = i->first + SequenceNumber32(extractSize);
+            remaining->RemoveAtStart(extractSize);
             m_data.erase(i);
+            m_data[remainingSeq] = remaining;
             m_size -= extractSize;
             m_availBytes -= extractSize;
             extractSize = 0;
         }
+        if (!outPkt)
+        {
+            outPkt = extracted;
+        }
+        else
+        {
+            outPkt->AddAtEnd(extracted);
+        }
     }
     if (outPkt->GetSize() == 0)
     {
@@ -54,6 +54,12 @@ class Packet;
  * To store data, use Add; for retrieving a certain amount of ordered data, use
  * the method Extract.
  *
+ * The data is stored as a set of disjoint ranges of sequence numbers, each one
+ * kept in a single packet: a segment adjacent to a buffered range is appended
+ * to (or prepended to) it, so that the buffer does not keep a packet for each
+ * segment received out of order, and Extract usually returns the buffered
+ * range without copying it.
+ *
  * SACK list
  * ---------
  *
@@ -221,7 +227,7 @@ class TcpRxBuffer : public Object
 
     TcpOptionSack::SackList m_sackList; //!< Sack list (updated constantly)
 
-    /// container for data stored in the buffer
+    /// iterator over the ranges of data stored in the buffer
     typedef std::map<SequenceNumber32, Ptr<Packet>>::iterator BufIterator;
     TracedValue<SequenceNumber32>
         m_nextRxSeq;           //!< Seqnum of the first missing byte in data (RCV.NXT)
@@ -230,7 +236,7 @@ class TcpRxBuffer : public Object
     uint32_t m_size;       //!< Number of total data bytes in the buffer, not necessarily contiguous
     uint32_t m_maxBuffer;  //!< Upper bound of the number of data bytes in buffer (RCV.WND)
     uint32_t m_availBytes; //!< Number of bytes available to read, i.e. contiguous block at head
-    std::map<SequenceNumber32, Ptr<Packet>> m_data; //!< Corresponding data (may be null)
+    std::map<SequenceNumber32, Ptr<Packet>> m_data; //!< Disjoint ranges of data, by first seqnum
 };
 
 } // namespace ns3
@@ -38,10 +38,8 @@
 #include "tcp-congestion-ops.h"
 #include "tcp-header.h"
 #include "tcp-l4-protocol.h"
-#include "tcp-option-sack-permitted.h"
 #include "tcp-option-sack.h"
 #include "tcp-option-ts.h"
-#include "tcp-option-winscale.h"
 #include "tcp-rate-ops.h"
 #include "tcp-recovery-ops.h"
 #include "tcp-rx-buffer.h"
@@ -50,6 +48,7 @@
 #include "ns3/abort.h"
 #include "ns3/data-rate.h"
 #include "ns3/double.h"
+#include "ns3/gso-tag.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/inet6-socket-address.h"
 #include "ns3/log.h"
@@ -64,6 +63,7 @@
 
 #include <algorithm>
 #include <math.h>
+#include <vector>
 
 namespace ns3
 {
@@ -161,6 +161,12 @@ TcpSocketBase::GetTypeId()
                           BooleanValue(true),
                           MakeBooleanAccessor(&TcpSocketBase::m_limitedTx),
                           MakeBooleanChecker())
+            .AddAttribute("GsoMaxSize",
+                          "Maximum payload size of the super-segments handed down to the IP "
+                          "layer when the segmentation offload is emulated, 0 to disable it",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&TcpSocketBase::m_gsoMaxSize),
+                          MakeUintegerChecker<uint32_t>(0, 65475))
             .AddAttribute("UseEcn",
                           "Parameter to set ECN functionality",
                           EnumValue(TcpSocketState::Off),
@@ -277,6 +283,9 @@ TcpSocketBase::TcpSocketBase()
 
     m_tcb->m_pacingRate = m_tcb->m_maxPacingRate;
     m_pacingTimer.SetFunction(&TcpSocketBase::NotifyPacingPerformed, this);
+    m_reTxTimeout = MakeCallback(&TcpSocketBase::ReTxTimeout, this);
+    m_retxEvent.SetFunction(m_reTxTimeout);
+    m_delAckEvent.SetFunction(MakeCallback(&TcpSocketBase::DelAckTimeout, this));
 
     m_tcb->m_sendEmptyPacketCallback = MakeCallback(&TcpSocketBase::SendEmptyPacket, this);
 
@@ -372,6 +381,7 @@ TcpSocketBase::TcpSocketBase(const TcpSocketBase& sock)
       m_txTrace(sock.m_txTrace),
       m_rxTrace(sock.m_rxTrace),
       m_pacingTimer(Timer::CANCEL_ON_DESTROY),
+      m_gsoMaxSize(sock.m_gsoMaxSize),
       m_ecnEchoSeq(sock.m_ecnEchoSeq),
       m_ecnCESeq(sock.m_ecnCESeq),
       m_ecnCWRSeq(sock.m_ecnCWRSeq)
@@ -399,6 +409,10 @@ TcpSocketBase::TcpSocketBase(const TcpSocketBase& sock)
 
     m_tcb->m_pacingRate = m_tcb->m_maxPacingRate;
     m_pacingTimer.SetFunction(&TcpSocketBase::NotifyPacingPerformed, this);
+    m_reTxTimeout = MakeCallback(&TcpSocketBase::ReTxTimeout, this);
+    m_retxEvent.SetFunction(m_reTxTimeout);
+    m_delAckEvent.SetFunction(MakeCallback(&TcpSocketBase::DelAckTimeout, this));
+    SetTimerWheel(sock.m_retxEvent.GetTimerWheel());
 
     if (sock.m_congestionControl)
     {
@@ -494,6 +508,7 @@ void
 TcpSocketBase::SetNode(Ptr<Node> node)
 {
     m_node = node;
+    SetTimerWheel(node ? TimerWheel::GetTimerWheel(node) : nullptr);
 }
 
 /* Associate the L4 protocol (e.g. mux/demux) with this socket */
@@ -1344,9 +1359,10 @@ TcpSocketBase::DoForwardUp(Ptr<Packet> packet, const Address& fromAddress, const
          */
         m_rWnd = tcpHeader.GetWindowSize();
 
-        if (tcpHeader.HasOption(TcpOption::WINSCALE) && m_winScalingEnabled)
+        uint8_t scale;
+        if (m_winScalingEnabled && tcpHeader.GetWindowScaleOption(scale))
         {
-            ProcessOptionWScale(tcpHeader.GetOption(TcpOption::WINSCALE));
+            ProcessOptionWScale(scale);
         }
         else
         {
@@ -1355,7 +1371,7 @@ TcpSocketBase::DoForwardUp(Ptr<Packet> packet, const Address& fromAddress, const
 
         if (tcpHeader.HasOption(TcpOption::SACKPERMITTED) && m_sackEnabled)
         {
-            ProcessOptionSackPermitted(tcpHeader.GetOption(TcpOption::SACKPERMITTED));
+            ProcessOptionSackPermitted();
         }
         else
         {
@@ -1364,10 +1380,11 @@ TcpSocketBase::DoForwardUp(Ptr<Packet> packet, const Address& fromAddress, const
         }
 
         // When receiving a <SYN> or <SYN-ACK> we should adapt TS to the other end
-        if (tcpHeader.HasOption(TcpOption::TS) && m_timestampEnabled)
+        uint32_t timestamp;
+        uint32_t echo;
+        if (m_timestampEnabled && tcpHeader.GetTimestampOption(timestamp, echo))
         {
-            ProcessOptionTimestamp(tcpHeader.GetOption(TcpOption::TS),
-                                   tcpHeader.GetSequenceNumber());
+            ProcessOptionTimestamp(timestamp, echo, tcpHeader.GetSequenceNumber());
         }
         else
         {
@@ -1388,9 +1405,11 @@ TcpSocketBase::DoForwardUp(Ptr<Packet> packet, const Address& fromAddress, const
     else if (tcpHeader.GetFlags() & TcpHeader::ACK)
     {
         NS_ASSERT(!(tcpHeader.GetFlags() & TcpHeader::SYN));
+        uint32_t timestamp;
+        uint32_t echo;
         if (m_timestampEnabled)
         {
-            if (!tcpHeader.HasOption(TcpOption::TS))
+            if (!tcpHeader.GetTimestampOption(timestamp, echo))
             {
                 // Ignoring segment without TS, RFC 7323
                 NS_LOG_LOGIC("At state " << TcpStateName[m_state] << " received packet of seq ["
@@ -1400,8 +1419,7 @@ TcpSocketBase::DoForwardUp(Ptr<Packet> packet, const Address& fromAddress, const
             }
             else
             {
-                ProcessOptionTimestamp(tcpHeader.GetOption(TcpOption::TS),
-                                       tcpHeader.GetSequenceNumber());
+                ProcessOptionTimestamp(timestamp, echo, tcpHeader.GetSequenceNumber());
             }
         }
 
@@ -1414,7 +1432,7 @@ TcpSocketBase::DoForwardUp(Ptr<Packet> packet, const Address& fromAddress, const
         NS_LOG_LOGIC(this << " Enter zerowindow persist state");
         NS_LOG_LOGIC(
             this << " Cancelled ReTxTimeout event which was set to expire at "
-                 << (Simulator::Now() + Simulator::GetDelayLeft(m_retxEvent)).GetSeconds());
+                 << (Simulator::Now() + m_retxEvent.GetDelayLeft()).GetSeconds());
         m_retxEvent.Cancel();
         NS_LOG_LOGIC("Schedule persist timeout at time "
                      << Simulator::Now().GetSeconds() << " to expire at time "
@@ -1595,17 +1613,11 @@ TcpSocketBase::ReadOptions(const TcpHeader& tcpHeader, uint32_t* bytesSacked)
 {
     NS_LOG_FUNCTION(this << tcpHeader);
 
-    for (const auto& option : tcpHeader.GetOptionList())
+    // Check only for ACK options here
+    TcpOptionSack::SackList sackList;
+    if (tcpHeader.GetSackOption(sackList))
     {
-        // Check only for ACK options here
-        switch (option->GetKind())
-        {
-        case TcpOption::SACK:
-            *bytesSacked = ProcessOptionSack(option);
-            break;
-        default:
-            continue;
-        }
+        *bytesSacked = ProcessOptionSack(sackList);
     }
 }
 
@@ -2707,7 +2719,7 @@ TcpSocketBase::Destroy()
         m_tcp->RemoveSocket(this);
     }
     NS_LOG_LOGIC(this << " Cancelled ReTxTimeout event which was set to expire at "
-                      << (Simulator::Now() + Simulator::GetDelayLeft(m_retxEvent)).GetSeconds());
+                      << (Simulator::Now() + m_retxEvent.GetDelayLeft()).GetSeconds());
     CancelAllTimers();
 }
 
@@ -2723,7 +2735,7 @@ TcpSocketBase::Destroy6()
         m_tcp->RemoveSocket(this);
     }
     NS_LOG_LOGIC(this << " Cancelled ReTxTimeout event which was set to expire at "
-                      << (Simulator::Now() + Simulator::GetDelayLeft(m_retxEvent)).GetSeconds());
+                      << (Simulator::Now() + m_retxEvent.GetDelayLeft()).GetSeconds());
     CancelAllTimers();
 }
 
@@ -2739,6 +2751,9 @@ TcpSocketBase::SendEmptyPacket(uint8_t flags)
         return;
     }
 
+    // The segments coalesced so far precede this one
+    SendGsoBatch();
+
     Ptr<Packet> p = Create<Packet>();
     TcpHeader header;
     SequenceNumber32 s = m_tcb->m_nextTxSequence;
@@ -2857,7 +2872,8 @@ TcpSocketBase::SendEmptyPacket(uint8_t flags)
         NS_LOG_LOGIC("Schedule retransmission timeout at time "
                      << Simulator::Now().GetSeconds() << " to expire at time "
                      << (Simulator::Now() + m_rto.Get()).GetSeconds());
-        m_retxEvent = Simulator::Schedule(m_rto, &TcpSocketBase::SendEmptyPacket, this, flags);
+        m_retxEvent.SetFunction(MakeCallback(&TcpSocketBase::SendEmptyPacket, this, flags));
+        m_retxEvent.Schedule(m_rto);
     }
 }
 
@@ -3211,12 +3227,19 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
         NS_LOG_LOGIC(this << " SendDataPacket Schedule ReTxTimeout at time "
                           << Simulator::Now().GetSeconds() << " to expire at time "
                           << (Simulator::Now() + m_rto.Get()).GetSeconds());
-        m_retxEvent = Simulator::Schedule(m_rto, &TcpSocketBase::ReTxTimeout, this);
+        m_retxEvent.SetFunction(m_reTxTimeout);
+        m_retxEvent.Schedule(m_rto);
     }
 
     m_txTrace(p, header, this);
 
-    if (m_endPoint)
+    if (m_gsoBatching)
+    {
+        AddToGsoBatch(p, header);
+        NS_LOG_DEBUG("Add segment of size " << sz << " with remaining data " << remainingData
+                                            << " to the super-segment. Header " << header);
+    }
+    else if (m_endPoint)
     {
         m_tcp->SendPacket(p,
                           header,
@@ -3260,6 +3283,90 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
     return sz;
 }
 
+void
+TcpSocketBase::AddToGsoBatch(Ptr<Packet> p, const TcpHeader& header)
+{
+    NS_LOG_FUNCTION(this << p << header);
+
+    if (m_gsoPacket)
+    {
+        // The segment can be appended to the super-segment if it follows its
+        // data, if all the previous segments have the full segment size, if
+        // its header differs only in the sequence number and in the FIN flag,
+        uint32_t gsoSize = m_gsoPacket->GetSize();
+        TcpHeader expected = header;
+        expected.SetSequenceNumber(m_gsoHeader.GetSequenceNumber());
+        expected.SetFlags(header.GetFlags() & ~TcpHeader::FIN);
+        // and if it carries the same packet tags, which the segments of the
+        // super-segment get when it is split
+        if (m_gsoSegmentSize > 0 && gsoSize % m_gsoSegmentSize == 0 &&
+            p->GetSize() <= m_gsoSegmentSize && gsoSize + p->GetSize() <= m_gsoMaxSize &&
+            header.GetSequenceNumber() == m_gsoHeader.GetSequenceNumber() + gsoSize &&
+            (m_gsoHeader.GetFlags() & TcpHeader::FIN) == 0 && expected == m_gsoHeader &&
+            header.GetLength() == m_gsoHeader.GetLength() && HaveSamePacketTags(p, m_gsoPacket))
+        {
+            m_gsoPacket->AddAtEnd(p);
+            m_gsoHeader.SetFlags(header.GetFlags());
+            return;
+        }
+        SendGsoBatch();
+    }
+
+    // the packet may be held by the tracers, hence it is not modified
+    m_gsoPacket = p->Copy();
+    m_gsoHeader = header;
+    m_gsoSegmentSize = p->GetSize();
+}
+
+bool
+TcpSocketBase::HaveSamePacketTags(Ptr<const Packet> p1, Ptr<const Packet> p2)
+{
+    PacketTagIterator i1 = p1->GetPacketTagIterator();
+    PacketTagIterator i2 = p2->GetPacketTagIterator();
+    while (i1.HasNext() && i2.HasNext())
+    {
+        if (!i1.Next().IsEqual(i2.Next()))
+        {
+            return false;
+        }
+    }
+    return !i1.HasNext() && !i2.HasNext();
+}
+
+void
+TcpSocketBase::SendGsoBatch()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (!m_gsoPacket)
+    {
+        return;
+    }
+    if (m_gsoPacket->GetSize() > m_gsoSegmentSize)
+    {
+        NS_LOG_DEBUG("Send super-segment of size " << m_gsoPacket->GetSize() << " split in "
+                                                   << m_gsoSegmentSize << " bytes segments");
+        m_gsoPacket->AddPacketTag(GsoTag(m_gsoSegmentSize, m_gsoHeader.GetSerializedSize()));
+    }
+    if (m_endPoint)
+    {
+        m_tcp->SendPacket(m_gsoPacket,
+                          m_gsoHeader,
+                          m_endPoint->GetLocalAddress(),
+                          m_endPoint->GetPeerAddress(),
+                          m_boundnetdevice);
+    }
+    else
+    {
+        m_tcp->SendPacket(m_gsoPacket,
+                          m_gsoHeader,
+                          m_endPoint6->GetLocalAddress(),
+                          m_endPoint6->GetPeerAddress(),
+                          m_boundnetdevice);
+    }
+    m_gsoPacket = nullptr;
+}
+
 void
 TcpSocketBase::UpdateRttHistory(const SequenceNumber32& seq, uint32_t sz, bool isRetransmission)
 {
@@ -3303,6 +3410,10 @@ TcpSocketBase::SendPendingData(bool withAck)
     uint32_t nPacketsSent = 0;
     uint32_t availableWindow = AvailableWindow();
 
+    // With the segmentation offload emulation, the segments sent below are
+    // coalesced into super-segments, which are split again by the IP layer
+    m_gsoBatching = m_gsoMaxSize > m_tcb->m_segmentSize;
+
     // RFC 6675, Section (C)
     // If cwnd - pipe >= 1 SMSS, the sender SHOULD transmit one or more
     // segments as follows:
@@ -3426,6 +3537,12 @@ TcpSocketBase::SendPendingData(bool withAck)
         // loop again!
     }
 
+    if (m_gsoBatching)
+    {
+        m_gsoBatching = false;
+        SendGsoBatch();
+    }
+
     if (nPacketsSent > 0)
     {
         if (!m_sackEnabled)
@@ -3608,11 +3725,9 @@ TcpSocketBase::ReceivedData(Ptr<Packet> p, const TcpHeader& tcpHeader)
         else if (m_delAckEvent.IsExpired())
         {
             m_congestionControl->CwndEvent(m_tcb, TcpSocketState::CA_EVENT_DELAYED_ACK);
-            m_delAckEvent =
-                Simulator::Schedule(m_delAckTimeout, &TcpSocketBase::DelAckTimeout, this);
-            NS_LOG_LOGIC(
-                this << " scheduled delayed ACK at "
-                     << (Simulator::Now() + Simulator::GetDelayLeft(m_delAckEvent)).GetSeconds());
+            m_delAckEvent.Schedule(m_delAckTimeout);
+            NS_LOG_LOGIC(this << " scheduled delayed ACK at "
+                              << (Simulator::Now() + m_delAckTimeout).GetSeconds());
         }
     }
 }
@@ -3631,11 +3746,11 @@ TcpSocketBase::EstimateRtt(const TcpHeader& tcpHeader)
         RttHistory& h = m_history.front();
         if (!h.retx && ackSeq >= (h.seq + SequenceNumber32(h.count)))
         { // Ok to use this sample
-            if (m_timestampEnabled && tcpHeader.HasOption(TcpOption::TS))
+            uint32_t timestamp;
+            uint32_t echo;
+            if (m_timestampEnabled && tcpHeader.GetTimestampOption(timestamp, echo))
             {
-                Ptr<const TcpOptionTS> ts;
-                ts = DynamicCast<const TcpOptionTS>(tcpHeader.GetOption(TcpOption::TS));
-                m = TcpOptionTS::ElapsedTimeFromTsValue(ts->GetEcho());
+                m = TcpOptionTS::ElapsedTimeFromTsValue(echo);
                 if (m.IsZero())
                 {
                     NS_LOG_LOGIC("TcpSocketBase::EstimateRtt - RTT calculated from TcpOption::TS "
@@ -3688,7 +3803,7 @@ TcpSocketBase::NewAck(const SequenceNumber32& ack, bool resetRTO)
     { // Set RTO unless the ACK is received in SYN_RCVD state
         NS_LOG_LOGIC(
             this << " Cancelled ReTxTimeout event which was set to expire at "
-                 << (Simulator::Now() + Simulator::GetDelayLeft(m_retxEvent)).GetSeconds());
+                 << (Simulator::Now() + m_retxEvent.GetDelayLeft()).GetSeconds());
         m_retxEvent.Cancel();
         // On receiving a "New" ack we restart retransmission timer .. RFC 6298
         // RFC 6298, clause 2.4
@@ -3698,7 +3813,8 @@ TcpSocketBase::NewAck(const SequenceNumber32& ack, bool resetRTO)
         NS_LOG_LOGIC(this << " Schedule ReTxTimeout at time " << Simulator::Now().GetSeconds()
                           << " to expire at time "
                           << (Simulator::Now() + m_rto.Get()).GetSeconds());
-        m_retxEvent = Simulator::Schedule(m_rto, &TcpSocketBase::ReTxTimeout, this);
+        m_retxEvent.SetFunction(m_reTxTimeout);
+        m_retxEvent.Schedule(m_rto);
     }
 
     // Note the highest ACK and tell app to send more
@@ -3717,7 +3833,7 @@ TcpSocketBase::NewAck(const SequenceNumber32& ack, bool resetRTO)
     { // No retransmit timer if no data to retransmit
         NS_LOG_LOGIC(
             this << " Cancelled ReTxTimeout event which was set to expire at "
-                 << (Simulator::Now() + Simulator::GetDelayLeft(m_retxEvent)).GetSeconds());
+                 << (Simulator::Now() + m_retxEvent.GetDelayLeft()).GetSeconds());
         m_retxEvent.Cancel();
     }
 }
@@ -4002,6 +4118,14 @@ TcpSocketBase::CancelAllTimers()
     m_pacingTimer.Cancel();
 }
 
+void
+TcpSocketBase::SetTimerWheel(Ptr<TimerWheel> wheel)
+{
+    NS_LOG_FUNCTION(this << wheel);
+    m_retxEvent.SetTimerWheel(wheel);
+    m_delAckEvent.SetTimerWheel(wheel);
+}
+
 /* Move TCP to Time_Wait state and schedule a transition to Closed state */
 void
 TcpSocketBase::TimeWait()
@@ -4203,15 +4327,13 @@ TcpSocketBase::AddOptions(TcpHeader& header)
 }
 
 void
-TcpSocketBase::ProcessOptionWScale(const Ptr<const TcpOption> option)
+TcpSocketBase::ProcessOptionWScale(uint8_t scale)
 {
-    NS_LOG_FUNCTION(this << option);
-
-    Ptr<const TcpOptionWinScale> ws = DynamicCast<const TcpOptionWinScale>(option);
+    NS_LOG_FUNCTION(this << static_cast<uint32_t>(scale));
 
     // In naming, we do the contrary of RFC 1323. The received scaling factor
     // is Rcv.Wind.Scale (and not Snd.Wind.Scale)
-    m_sndWindShift = ws->GetScale();
+    m_sndWindShift = scale;
 
     if (m_sndWindShift > 14)
     {
@@ -4254,38 +4376,32 @@ TcpSocketBase::AddOptionWScale(TcpHeader& header)
     NS_LOG_FUNCTION(this << header);
     NS_ASSERT(header.GetFlags() & TcpHeader::SYN);
 
-    Ptr<TcpOptionWinScale> option = CreateObject<TcpOptionWinScale>();
-
     // In naming, we do the contrary of RFC 1323. The sended scaling factor
     // is Snd.Wind.Scale (and not Rcv.Wind.Scale)
 
     m_rcvWindShift = CalculateWScale();
-    option->SetScale(m_rcvWindShift);
 
-    header.AppendOption(option);
+    header.AppendWindowScaleOption(m_rcvWindShift);
 
     NS_LOG_INFO(m_node->GetId() << " Send a scaling factor of "
                                 << static_cast<int>(m_rcvWindShift));
 }
 
 uint32_t
-TcpSocketBase::ProcessOptionSack(const Ptr<const TcpOption> option)
+TcpSocketBase::ProcessOptionSack(const TcpOptionSack::SackList& sackList)
 {
-    NS_LOG_FUNCTION(this << option);
+    NS_LOG_FUNCTION(this << sackList.size());
 
-    Ptr<const TcpOptionSack> s = DynamicCast<const TcpOptionSack>(option);
-    return m_txBuffer->Update(s->GetSackList(), MakeCallback(&TcpRateOps::SkbDelivered, m_rateOps));
+    return m_txBuffer->Update(sackList, MakeCallback(&TcpRateOps::SkbDelivered, m_rateOps));
 }
 
 void
-TcpSocketBase::ProcessOptionSackPermitted(const Ptr<const TcpOption> option)
+TcpSocketBase::ProcessOptionSackPermitted()
 {
-    NS_LOG_FUNCTION(this << option);
-
-    Ptr<const TcpOptionSackPermitted> s = DynamicCast<const TcpOptionSackPermitted>(option);
+    NS_LOG_FUNCTION(this);
 
     NS_ASSERT(m_sackEnabled == true);
-    NS_LOG_INFO(m_node->GetId() << " Received a SACK_PERMITTED option " << s);
+    NS_LOG_INFO(m_node->GetId() << " Received a SACK_PERMITTED option");
 }
 
 void
@@ -4294,8 +4410,7 @@ TcpSocketBase::AddOptionSackPermitted(TcpHeader& header)
     NS_LOG_FUNCTION(this << header);
     NS_ASSERT(header.GetFlags() & TcpHeader::SYN);
 
-    Ptr<TcpOptionSackPermitted> option = CreateObject<TcpOptionSackPermitted>();
-    header.AppendOption(option);
+    header.AppendSackPermittedOption();
     NS_LOG_INFO(m_node->GetId() << " Add option SACK-PERMITTED");
 }
 
@@ -4316,44 +4431,39 @@ TcpSocketBase::AddOptionSack(TcpHeader& header)
     }
 
     // Append the allowed number of SACK blocks
-    Ptr<TcpOptionSack> option = CreateObject<TcpOptionSack>();
-    TcpOptionSack::SackList::iterator i;
-    for (i = sackList.begin(); allowedSackBlocks > 0 && i != sackList.end(); ++i)
+    if (sackList.size() > allowedSackBlocks)
     {
-        option->AddSackBlock(*i);
-        allowedSackBlocks--;
+        sackList.resize(allowedSackBlocks);
     }
 
-    header.AppendOption(option);
-    NS_LOG_INFO(m_node->GetId() << " Add option SACK " << *option);
+    header.AppendSackOption(sackList);
+    NS_LOG_INFO(m_node->GetId() << " Add option SACK with " << sackList.size() << " blocks");
 }
 
 void
-TcpSocketBase::ProcessOptionTimestamp(const Ptr<const TcpOption> option,
+TcpSocketBase::ProcessOptionTimestamp(uint32_t timestamp,
+                                      uint32_t echo,
                                       const SequenceNumber32& seq)
 {
-    NS_LOG_FUNCTION(this << option);
-
-    Ptr<const TcpOptionTS> ts = DynamicCast<const TcpOptionTS>(option);
+    NS_LOG_FUNCTION(this << timestamp << echo << seq);
 
     // This is valid only when no overflow occurs. It happens
     // when a connection last longer than 50 days.
-    if (m_tcb->m_rcvTimestampValue > ts->GetTimestamp())
+    if (m_tcb->m_rcvTimestampValue > timestamp)
     {
         // Do not save a smaller timestamp (probably there is reordering)
         return;
     }
 
-    m_tcb->m_rcvTimestampValue = ts->GetTimestamp();
-    m_tcb->m_rcvTimestampEchoReply = ts->GetEcho();
+    m_tcb->m_rcvTimestampValue = timestamp;
+    m_tcb->m_rcvTimestampEchoReply = echo;
 
     if (seq == m_tcb->m_rxBuffer->NextRxSequence() && seq <= m_highTxAck)
     {
-        m_timestampToEcho = ts->GetTimestamp();
+        m_timestampToEcho = timestamp;
     }
 
-    NS_LOG_INFO(m_node->GetId() << " Got timestamp=" << m_timestampToEcho
-                                << " and Echo=" << ts->GetEcho());
+    NS_LOG_INFO(m_node->GetId() << " Got timestamp=" << m_timestampToEcho << " and Echo=" << echo);
 }
 
 void
@@ -4361,13 +4471,9 @@ TcpSocketBase::AddOptionTimestamp(TcpHeader& header)
 {
     NS_LOG_FUNCTION(this << header);
 
-    Ptr<TcpOptionTS> option = CreateObject<TcpOptionTS>();
-
-    option->SetTimestamp(TcpOptionTS::NowToTsValue());
-    option->SetEcho(m_timestampToEcho);
-
-    header.AppendOption(option);
-    NS_LOG_INFO(m_node->GetId() << " Add option TS, ts=" << option->GetTimestamp()
+    uint32_t timestamp = TcpOptionTS::NowToTsValue();
+    header.AppendTimestampOption(timestamp, m_timestampToEcho);
+    NS_LOG_INFO(m_node->GetId() << " Add option TS, ts=" << timestamp
                                 << " echo=" << m_timestampToEcho);
 }
 
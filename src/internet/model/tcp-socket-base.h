@@ -25,8 +25,10 @@
 #include "ns3/ipv6-header.h"
 #include "ns3/node.h"
 #include "ns3/sequence-number.h"
+#include "ns3/tcp-header.h"
 #include "ns3/tcp-socket-state.h"
 #include "ns3/tcp-socket.h"
+#include "ns3/timer-wheel.h"
 #include "ns3/timer.h"
 #include "ns3/traced-value.h"
 
@@ -191,6 +193,11 @@ class RttHistory
  * of sent packet is set as lost entirely, and the transmission is re-started
  * from the SND.UNA sequence number.
  *
+ * The retransmission and the delayed ACK timers, which are re-armed by most
+ * of the segments, are timers of the TimerWheel of the node: re-arming them
+ * moves their deadline, without cancelling and scheduling simulator events.
+ * They are ordinary simulator events until the socket is given a node.
+ *
  * Options management
  * ------------------
  *
@@ -214,6 +221,39 @@ class RttHistory
  * you need more information. The reference paper is
  * https://dl.acm.org/citation.cfm?id=3067666.
  *
+ * Segmentation offload
+ * --------------------
+ *
+ * When the attribute GsoMaxSize is larger than the segment size, the
+ * segmentation offload of the network cards is emulated: the consecutive
+ * segments sent by SendPendingData are coalesced into super-segments, up to
+ * GsoMaxSize bytes of payload, which travel through TcpL4Protocol, the IP
+ * layer and the traffic control layer as a single packet marked with a
+ * GsoTag. The segments of a super-segment carry the same packet tags: a
+ * segment with other tags starts a new super-segment. The super-segment is
+ * split into its segments, with consecutive IPv4 identifications, by the GSO
+ * callback that the IP layer sets on the NetDeviceQueueInterface of the
+ * output device, when it leaves the traffic control layer. Hence the
+ * NetDevices see the same packets as without the emulation, and the
+ * "SendOutgoing" and "Tx" traces of the IP layer are fired for each segment,
+ * when it is handed to the device. The super-segments are split by the IP
+ * layer instead when the device has no NetDeviceQueueInterface (e.g., the
+ * loopback device), when the destination is a local address, and when the
+ * segments need to be fragmented.
+ *
+ * As a consequence, the queue discs enqueue and dequeue a super-segment as a
+ * single item, and their statistics count it as one packet. FlowMonitor
+ * accounts the segments from the time they leave the traffic control layer:
+ * their delay excludes the time spent in the queue disc, and a super-segment
+ * dropped by the queue disc, or by the address resolution, is not seen by
+ * FlowMonitor. All the per-segment state of the socket (the Tx buffer, the
+ * RTT history, the "Tx" trace) is unchanged. The time saved is the
+ * per-packet work of TcpL4Protocol, of the IP layer and of the traffic
+ * control layer, see the tcp-gso-benchmark example.
+ *
+ * The receive offload (GRO) is out of scope: the segments are delivered to
+ * the socket one by one, as without the emulation.
+ *
  */
 class TcpSocketBase : public TcpSocket
 {
@@ -809,6 +849,29 @@ class TcpSocketBase : public TcpSocket
      */
     virtual uint32_t SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withAck);
 
+    /**
+     * \brief Add a segment to the super-segment being built, or send the
+     *        super-segment and start a new one if the segment cannot be appended
+     *
+     * \param p the segment payload, with the socket tags
+     * \param header the segment header
+     */
+    void AddToGsoBatch(Ptr<Packet> p, const TcpHeader& header);
+
+    /**
+     * \brief Send the super-segment being built, if any, to TcpL4Protocol
+     */
+    void SendGsoBatch();
+
+    /**
+     * \brief Check whether two packets carry the same packet tags
+     *
+     * \param p1 the first packet
+     * \param p2 the second packet
+     * \return true if the packets carry the same packet tags, in the same order
+     */
+    static bool HaveSamePacketTags(Ptr<const Packet> p1, Ptr<const Packet> p2);
+
     /**
      * \brief Send a empty packet that carries a flag, e.g., ACK
      *
@@ -883,6 +946,12 @@ class TcpSocketBase : public TcpSocket
      */
     void CancelAllTimers();
 
+    /**
+     * \brief Move the retransmission and delayed ACK timers to a timer wheel
+     * \param wheel the timer wheel, or nullptr to use simulator events
+     */
+    void SetTimerWheel(Ptr<TimerWheel> wheel);
+
     /**
      * \brief Move from CLOSING or FIN_WAIT_2 to TIME_WAIT state
      */
@@ -1151,9 +1220,9 @@ class TcpSocketBase : public TcpSocket
      * Read the window scale option (encoded logarithmically) and save it.
      * Per RFC 1323, the value can't exceed 14.
      *
-     * \param option Window scale option read from the header
+     * \param scale Window scale read from the header
      */
-    void ProcessOptionWScale(const Ptr<const TcpOption> option);
+    void ProcessOptionWScale(uint8_t scale);
     /**
      * \brief Add the window scale option to the header
      *
@@ -1178,18 +1247,16 @@ class TcpSocketBase : public TcpSocket
      *
      * Currently this is a placeholder, since no operations should be done
      * on such option.
-     *
-     * \param option SACK PERMITTED option from the header
      */
-    void ProcessOptionSackPermitted(const Ptr<const TcpOption> option);
+    void ProcessOptionSackPermitted();
 
     /**
      * \brief Read the SACK option
      *
-     * \param option SACK option from the header
+     * \param sackList SACK blocks read from the header
      * \returns the number of bytes sacked by this option
      */
-    uint32_t ProcessOptionSack(const Ptr<const TcpOption> option);
+    uint32_t ProcessOptionSack(const TcpOptionSack::SackList& sackList);
 
     /**
      * \brief Add the SACK PERMITTED option to the header
@@ -1212,10 +1279,11 @@ class TcpSocketBase : public TcpSocket
      * to utilize later to calculate RTT.
      *
      * \see EstimateRtt
-     * \param option Option from the segment
+     * \param timestamp Timestamp value from the segment
+     * \param echo Timestamp echo reply from the segment
      * \param seq Sequence number of the segment
      */
-    void ProcessOptionTimestamp(const Ptr<const TcpOption> option, const SequenceNumber32& seq);
+    void ProcessOptionTimestamp(uint32_t timestamp, uint32_t echo, const SequenceNumber32& seq);
     /**
      * \brief Add the timestamp option to the header
      *
@@ -1275,12 +1343,15 @@ class TcpSocketBase : public TcpSocket
 
   protected:
     // Counters and events
-    EventId m_retxEvent{};     //!< Retransmission event
     EventId m_lastAckEvent{};  //!< Last ACK timeout event
-    EventId m_delAckEvent{};   //!< Delayed ACK timeout event
     EventId m_persistEvent{};  //!< Persist event: Send 1 byte to probe for a non-zero Rx window
     EventId m_timewaitEvent{}; //!< TIME_WAIT expiration event: Move this socket to CLOSED state
 
+    // Events re-armed in the timer wheel of the node
+    TimerWheelEvent m_retxEvent;   //!< Retransmission event
+    TimerWheelEvent m_delAckEvent; //!< Delayed ACK timeout event
+    Callback<void> m_reTxTimeout;  //!< ReTxTimeout, function of the retransmission event
+
     // ACK management
     uint32_t m_dupAckCount{0};    //!< Dupack counter
     uint32_t m_delAckCount{0};    //!< Delayed ACK counter
@@ -1384,6 +1455,13 @@ class TcpSocketBase : public TcpSocket
     // Pacing related variable
     Timer m_pacingTimer{Timer::CANCEL_ON_DESTROY}; //!< Pacing Event
 
+    // Segmentation offload emulation
+    uint32_t m_gsoMaxSize{0};     //!< Maximum payload of a super-segment, 0 if disabled
+    bool m_gsoBatching{false};    //!< True if the segments sent are coalesced
+    Ptr<Packet> m_gsoPacket;      //!< Payload of the super-segment being built
+    TcpHeader m_gsoHeader;        //!< Header of the super-segment being built
+    uint32_t m_gsoSegmentSize{0}; //!< Payload size of the segments of the super-segment
+
     // Parameters related to Explicit Congestion Notification
     TracedValue<SequenceNumber32> m_ecnEchoSeq{
         0}; //!< Sequence number of the last received ECN Echo
@@ -61,7 +61,10 @@ TcpTxBuffer::TcpTxBuffer(uint32_t n)
     : m_maxBuffer(32768),
       m_size(0),
       m_sentSize(0),
-      m_firstByteSeq(n)
+      m_firstByteSeq(n),
+      m_lostMarkedSeq(n),
+      m_lostHighSeq(n),
+      m_lostRetxSeq(n)
 {
     m_rWndCallback = MakeNullCallback<uint32_t>();
 }
@@ -177,6 +180,9 @@ TcpTxBuffer::SetHeadSequence(const SequenceNumber32& seq)
     // if you change the head with data already sent, something bad will happen
     NS_ASSERT(m_sentList.empty());
     m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+    m_lostMarkedSeq = seq;
+    m_lostHighSeq = seq;
+    m_lostRetxSeq = seq;
 }
 
 bool
@@ -297,7 +303,7 @@ TcpTxBuffer::GetNewSegment(uint32_t numBytes)
     NS_ASSERT(it != m_appList.end());
 
     m_appList.erase(it);
-    m_sentList.insert(m_sentList.end(), item);
+    m_sentIndex[item->m_startSeq] = m_sentList.insert(m_sentList.end(), item);
     m_sentSize += item->m_packet->GetSize();
 
     return item;
@@ -311,37 +317,34 @@ TcpTxBuffer::GetTransmittedSegment(uint32_t numBytes, const SequenceNumber32& se
     NS_ASSERT(numBytes <= m_sentSize);
     NS_ASSERT(!m_sentList.empty());
 
-    auto it = m_sentList.begin();
+    auto index = m_sentIndex.find(seq);
     bool listEdited = false;
     uint32_t s = numBytes;
 
     // Avoid to merge different packet for this retransmission if flags are
     // different.
-    for (; it != m_sentList.end(); ++it)
+    if (index != m_sentIndex.end())
     {
-        if ((*it)->m_startSeq == seq)
+        auto it = index->second;
+        auto next = it;
+        next++;
+        if (next != m_sentList.end())
         {
-            auto next = it;
-            next++;
-            if (next != m_sentList.end())
+            // Next is not sacked and have the same value for m_lost ... there is the
+            // possibility to merge
+            if ((!(*next)->m_sacked) && ((*it)->m_lost == (*next)->m_lost))
             {
-                // Next is not sacked and have the same value for m_lost ... there is the
-                // possibility to merge
-                if ((!(*next)->m_sacked) && ((*it)->m_lost == (*next)->m_lost))
-                {
-                    s = std::min(s, (*it)->m_packet->GetSize() + (*next)->m_packet->GetSize());
-                }
-                else
-                {
-                    // Next is sacked... better to retransmit only the first segment
-                    s = std::min(s, (*it)->m_packet->GetSize());
-                }
+                s = std::min(s, (*it)->m_packet->GetSize() + (*next)->m_packet->GetSize());
             }
             else
             {
+                // Next is sacked... better to retransmit only the first segment
                 s = std::min(s, (*it)->m_packet->GetSize());
             }
-            break;
+        }
+        else
+        {
+            s = std::min(s, (*it)->m_packet->GetSize());
         }
     }
 
@@ -378,6 +381,22 @@ TcpTxBuffer::FindHighestSacked() const
     return ret;
 }
 
+std::map<SequenceNumber32, TcpTxBuffer::PacketList::iterator>::const_iterator
+TcpTxBuffer::FindSentItem(const SequenceNumber32& seq) const
+{
+    auto index = m_sentIndex.upper_bound(seq);
+    if (index == m_sentIndex.begin())
+    {
+        return m_sentIndex.end();
+    }
+    --index;
+    if (seq >= index->first + (*index->second)->m_packet->GetSize())
+    {
+        return m_sentIndex.end();
+    }
+    return index;
+}
+
 void
 TcpTxBuffer::SplitItems(TcpTxItem* t1, TcpTxItem* t2, uint32_t size) const
 {
@@ -403,7 +422,7 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                                const SequenceNumber32& listStartFrom,
                                uint32_t numBytes,
                                const SequenceNumber32& seq,
-                               bool* listEdited) const
+                               bool* listEdited)
 {
     NS_LOG_FUNCTION(this << numBytes << seq);
 
@@ -439,12 +458,24 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
     TcpTxItem* outItem = nullptr;
     PacketList::iterator it = list.begin();
     SequenceNumber32 beginOfCurrentPacket = listStartFrom;
+    bool isSentList = (&list == &m_sentList);
+
+    if (isSentList)
+    {
+        // Jump directly to the item which contains seq
+        auto index = FindSentItem(seq);
+        if (index != m_sentIndex.end())
+        {
+            it = index->second;
+            beginOfCurrentPacket = index->first;
+        }
+    }
 
     while (it != list.end())
     {
         currentItem = *it;
         currentPacket = currentItem->m_packet;
-        NS_ASSERT_MSG(list != m_sentList || currentItem->m_startSeq >= m_firstByteSeq,
+        NS_ASSERT_MSG(!isSentList || currentItem->m_startSeq >= m_firstByteSeq,
                       "start: " << m_firstByteSeq
                                 << " currentItem start: " << currentItem->m_startSeq);
 
@@ -473,7 +504,12 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                 SplitItems(firstPart, currentItem, seq - beginOfCurrentPacket);
 
                 // insert firstPart before currentItem
-                list.insert(it, firstPart);
+                auto firstPartIt = list.insert(it, firstPart);
+                if (isSentList)
+                {
+                    m_sentIndex[firstPart->m_startSeq] = firstPartIt;
+                    m_sentIndex[currentItem->m_startSeq] = it;
+                }
                 if (listEdited)
                 {
                     *listEdited = true;
@@ -520,6 +556,14 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                     TcpTxItem* previous = *(--it);
 
                     list.erase(it);
+                    if (isSentList)
+                    {
+                        m_sentIndex.erase(currentItem->m_startSeq);
+                        if (m_lostRetxSeq > previous->m_startSeq)
+                        {
+                            m_lostRetxSeq = previous->m_startSeq;
+                        }
+                    }
 
                     MergeItems(previous, currentItem);
                     delete currentItem;
@@ -539,7 +583,12 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                 SplitItems(firstPart, currentItem, numBytes);
 
                 // insert firstPart before currentItem
-                list.insert(it, firstPart);
+                auto firstPartIt = list.insert(it, firstPart);
+                if (isSentList)
+                {
+                    m_sentIndex[firstPart->m_startSeq] = firstPartIt;
+                    m_sentIndex[currentItem->m_startSeq] = it;
+                }
                 if (listEdited)
                 {
                     *listEdited = true;
@@ -569,6 +618,15 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
 
             MergeItems(currentItem, next);
             list.erase(it);
+            if (isSentList)
+            {
+                // the merge may have reset the retransmitted flag
+                m_sentIndex.erase(next->m_startSeq);
+                if (m_lostRetxSeq > currentItem->m_startSeq)
+                {
+                    m_lostRetxSeq = currentItem->m_startSeq;
+                }
+            }
 
             delete next;
 
@@ -652,16 +710,15 @@ bool
 TcpTxBuffer::IsRetransmittedDataAcked(const SequenceNumber32& ack) const
 {
     NS_LOG_FUNCTION(this);
-    for (const auto& it : m_sentList)
+    // The only candidate is the item which contains the byte before ack
+    auto index = FindSentItem(ack - 1);
+    if (index == m_sentIndex.end())
     {
-        TcpTxItem* item = it;
-        Ptr<Packet> p = item->m_packet;
-        if (item->m_startSeq + p->GetSize() == ack && !item->m_sacked && item->m_retrans)
-        {
-            return true;
-        }
+        return false;
     }
-    return false;
+    TcpTxItem* item = *index->second;
+    Ptr<Packet> p = item->m_packet;
+    return item->m_startSeq + p->GetSize() == ack && !item->m_sacked && item->m_retrans;
 }
 
 void
@@ -709,6 +766,7 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
 
             RemoveFromCounts(item, pktSize);
 
+            m_sentIndex.erase(item->m_startSeq);
             i = m_sentList.erase(i);
             NS_LOG_INFO("Removed " << *item << " lost: " << m_lostOut << " retrans: " << m_retrans
                                    << " sacked: " << m_sackedOut << ". Remaining data " << m_size);
@@ -727,7 +785,9 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
             NS_LOG_INFO(*item);
             // PacketTags are preserved when fragmenting
             item->m_packet = item->m_packet->CreateFragment(offset, pktSize);
+            m_sentIndex.erase(item->m_startSeq);
             item->m_startSeq += offset;
+            m_sentIndex[item->m_startSeq] = i;
             m_size -= offset;
             m_sentSize -= offset;
             m_firstByteSeq += offset;
@@ -772,6 +832,20 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
         m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
     }
 
+    // Keep the marks inside the window, for the comparisons to be meaningful
+    if (m_lostMarkedSeq < m_firstByteSeq)
+    {
+        m_lostMarkedSeq = m_firstByteSeq;
+    }
+    if (m_lostHighSeq < m_firstByteSeq)
+    {
+        m_lostHighSeq = m_firstByteSeq;
+    }
+    if (m_lostRetxSeq < m_firstByteSeq)
+    {
+        m_lostRetxSeq = m_firstByteSeq;
+    }
+
     NS_LOG_DEBUG("Discarded up to " << seq << " lost: " << m_lostOut << " retrans: " << m_retrans
                                     << " sacked: " << m_sackedOut);
     NS_LOG_LOGIC("Buffer status after discarding data " << *this);
@@ -790,15 +864,22 @@ TcpTxBuffer::Update(const TcpOptionSack::SackList& list, const Callback<void, Tc
 
     for (auto option_it = list.begin(); option_it != list.end(); ++option_it)
     {
-        PacketList::iterator item_it = m_sentList.begin();
-        SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-
         if (m_firstByteSeq + m_sentSize < (*option_it).first)
         {
             NS_LOG_INFO("Not updating scoreboard, the option block is outside the sent list");
             return bytesSacked;
         }
 
+        // The items starting before the block can not be sacked by it: start
+        // from the first item starting inside the block
+        auto index = m_sentIndex.lower_bound((*option_it).first);
+        if (index == m_sentIndex.end())
+        {
+            continue;
+        }
+        PacketList::iterator item_it = index->second;
+        SequenceNumber32 beginOfCurrentPacket = index->first;
+
         while (item_it != m_sentList.end())
         {
             uint32_t pktSize = (*item_it)->m_packet->GetSize();
@@ -891,9 +972,19 @@ TcpTxBuffer::UpdateLostCount()
                                                  << *(*m_highestSack.first));
     }
 
+    // End of the highest item marked in this call; all the items before it are
+    // then lost or sacked
+    SequenceNumber32 markedSeq = m_lostMarkedSeq;
+
     for (auto it = m_highestSack.first; it != m_sentList.begin(); --it)
     {
         TcpTxItem* item = *it;
+        if (sacked >= m_dupAckThresh && item->m_startSeq < m_lostMarkedSeq)
+        {
+            // This item and all the previous ones are already lost or sacked
+            break;
+        }
+
         if (item->m_sacked)
         {
             sacked++;
@@ -901,10 +992,12 @@ TcpTxBuffer::UpdateLostCount()
 
         if (sacked >= m_dupAckThresh)
         {
+            markedSeq = std::max(markedSeq, item->m_startSeq + item->m_packet->GetSize());
             if (!item->m_sacked && !item->m_lost)
             {
                 item->m_lost = true;
                 m_lostOut += item->m_packet->GetSize();
+                m_lostRetxSeq = std::min(m_lostRetxSeq, item->m_startSeq);
             }
         }
         beginOfCurrentPacket -= item->m_packet->GetSize();
@@ -917,46 +1010,55 @@ TcpTxBuffer::UpdateLostCount()
         {
             item->m_lost = true;
             m_lostOut += item->m_packet->GetSize();
+            m_lostRetxSeq = item->m_startSeq;
         }
+        m_lostMarkedSeq = markedSeq;
+        m_lostHighSeq = std::max(m_lostHighSeq, markedSeq);
+        m_lostHighSeq = std::max(m_lostHighSeq, item->m_startSeq + item->m_packet->GetSize());
     }
     NS_LOG_INFO("Status after the update: " << *this);
     ConsistencyCheck();
 }
 
+void
+TcpTxBuffer::ResetLostMarks()
+{
+    NS_LOG_FUNCTION(this);
+    m_lostMarkedSeq = m_firstByteSeq;
+    m_lostHighSeq = m_firstByteSeq.Get() + m_sentSize;
+    m_lostRetxSeq = m_firstByteSeq;
+}
+
 bool
 TcpTxBuffer::IsLost(const SequenceNumber32& seq) const
 {
     NS_LOG_FUNCTION(this << seq);
 
-    SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-    PacketList::const_iterator it;
-
     if (seq >= m_highestSack.second)
     {
         return false;
     }
 
-    // In theory, using a map and hints when inserting elements can improve
-    // performance
-    for (it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    // Start from the first item which begins at (or after) seq
+    auto index = m_sentIndex.lower_bound(seq);
+    if (index == m_sentIndex.end())
     {
-        // Search for the right iterator before calling IsLost()
-        if (beginOfCurrentPacket >= seq)
-        {
-            if ((*it)->m_lost)
-            {
-                NS_LOG_INFO("seq=" << seq << " is lost because of lost flag");
-                return true;
-            }
+        return false;
+    }
 
-            if ((*it)->m_sacked)
-            {
-                NS_LOG_INFO("seq=" << seq << " is not lost because of sacked flag");
-                return false;
-            }
+    for (PacketList::const_iterator it = index->second; it != m_sentList.end(); ++it)
+    {
+        if ((*it)->m_lost)
+        {
+            NS_LOG_INFO("seq=" << seq << " is lost because of lost flag");
+            return true;
         }
 
-        beginOfCurrentPacket += (*it)->m_packet->GetSize();
+        if ((*it)->m_sacked)
+        {
+            NS_LOG_INFO("seq=" << seq << " is not lost because of sacked flag");
+            return false;
+        }
     }
 
     return false;
@@ -980,36 +1082,29 @@ TcpTxBuffer::NextSeg(SequenceNumber32* seq, SequenceNumber32* seqHigh, bool isRe
      *
      *     (1.c) IsLost (S2) returns true.
      */
-    PacketList::const_iterator it;
     TcpTxItem* item;
     SequenceNumber32 seqPerRule3;
     bool isSeqPerRule3Valid = false;
-    SequenceNumber32 beginOfCurrentPkt = m_firstByteSeq;
 
-    for (it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    // Condition 1.a , 1.b , and 1.c: the lost items which are not
+    // retransmitted yet start between m_lostRetxSeq and m_lostHighSeq
+    for (auto index = m_sentIndex.lower_bound(m_lostRetxSeq);
+         index != m_sentIndex.end() && index->first < m_lostHighSeq;
+         ++index)
     {
-        item = *it;
-
-        // Condition 1.a , 1.b , and 1.c
-        if (!item->m_retrans && !item->m_sacked)
+        item = *index->second;
+        if (!item->m_retrans && !item->m_sacked && item->m_lost)
         {
-            if (item->m_lost)
-            {
-                NS_LOG_INFO("IsLost, returning" << beginOfCurrentPkt);
-                *seq = beginOfCurrentPkt;
-                *seqHigh = *seq + m_segmentSize;
-                return true;
-            }
-            else if (seqPerRule3.GetValue() == 0 && isRecovery)
-            {
-                NS_LOG_INFO("Saving for rule 3 the seq " << beginOfCurrentPkt);
-                isSeqPerRule3Valid = true;
-                seqPerRule3 = beginOfCurrentPkt;
-            }
+            NS_LOG_INFO("IsLost, returning" << index->first);
+            m_lostRetxSeq = index->first;
+            *seq = index->first;
+            *seqHigh = *seq + m_segmentSize;
+            return true;
         }
-
-        // Nothing found, iterate
-        beginOfCurrentPkt += item->m_packet->GetSize();
+    }
+    if (m_lostRetxSeq < m_lostHighSeq)
+    {
+        m_lostRetxSeq = m_lostHighSeq;
     }
 
     /* (2) If no sequence number 'S2' per rule (1) exists but there
@@ -1043,7 +1138,29 @@ TcpTxBuffer::NextSeg(SequenceNumber32* seq, SequenceNumber32* seqHigh, bool isRe
      *     detecting loss given in steps (1.a) and (1.b) above
      *     (specifically excluding step (1.c)), then one segment of up to
      *     SMSS octets starting with S3 SHOULD be returned.
+     *
+     * The items starting before m_lostMarkedSeq are all lost or sacked, hence
+     * S3 can not be found there.
      */
+    if (isRecovery)
+    {
+        for (auto index = m_sentIndex.lower_bound(m_lostMarkedSeq); index != m_sentIndex.end();
+             ++index)
+        {
+            item = *index->second;
+            if (!item->m_retrans && !item->m_sacked && !item->m_lost)
+            {
+                NS_LOG_INFO("Saving for rule 3 the seq " << index->first);
+                isSeqPerRule3Valid = true;
+                seqPerRule3 = index->first;
+                if (seqPerRule3.GetValue() != 0)
+                {
+                    break;
+                }
+            }
+        }
+    }
+
     if (isSeqPerRule3Valid)
     {
         NS_LOG_INFO("Rule3 valid. " << seqPerRule3);
@@ -1226,6 +1343,7 @@ TcpTxBuffer::ResetRenoSack()
     }
 
     m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+    ResetLostMarks();
 }
 
 void
@@ -1249,12 +1367,14 @@ TcpTxBuffer::ResetSentList()
         m_appList.push_front(item);
         m_sentList.pop_back();
     }
+    m_sentIndex.clear();
 
     m_sentSize = 0;
     m_lostOut = 0;
     m_retrans = 0;
     m_sackedOut = 0;
     m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+    ResetLostMarks();
 }
 
 void
@@ -1266,6 +1386,9 @@ TcpTxBuffer::ResetLastSegmentSent()
         TcpTxItem* item = m_sentList.back();
 
         m_sentList.pop_back();
+        m_sentIndex.erase(item->m_startSeq);
+        m_lostMarkedSeq = std::min(m_lostMarkedSeq, item->m_startSeq);
+        m_lostRetxSeq = std::min(m_lostRetxSeq, item->m_startSeq);
         m_sentSize -= item->m_packet->GetSize();
         if (item->m_retrans)
         {
@@ -1318,6 +1441,11 @@ TcpTxBuffer::SetSentListLost(bool resetSack)
         (*it)->m_retrans = false;
     }
 
+    // All the items are now lost or sacked, and none is retransmitted
+    m_lostMarkedSeq = m_firstByteSeq.Get() + m_sentSize;
+    m_lostHighSeq = m_lostMarkedSeq;
+    m_lostRetxSeq = m_firstByteSeq;
+
     NS_LOG_INFO("Set sent list lost, status: " << *this);
     NS_ASSERT_MSG(m_sentSize >= m_sackedOut + m_lostOut, *this);
     ConsistencyCheck();
@@ -1350,6 +1478,7 @@ TcpTxBuffer::DeleteRetransmittedFlagFromHead()
     {
         m_sentList.front()->m_retrans = false;
         m_retrans -= m_sentList.front()->m_packet->GetSize();
+        ResetLostMarks();
     }
     ConsistencyCheck();
 }
@@ -1379,6 +1508,12 @@ TcpTxBuffer::MarkHeadAsLost()
             m_sentList.front()->m_lost = true;
             m_lostOut += m_sentList.front()->m_packet->GetSize();
         }
+
+        // Only the head changed, and it is now lost and not retransmitted:
+        // the marks of the lost items must just let NextSeg find it
+        m_lostHighSeq = std::max(m_lostHighSeq,
+                                 m_firstByteSeq.Get() + m_sentList.front()->m_packet->GetSize());
+        m_lostRetxSeq = m_firstByteSeq;
     }
     ConsistencyCheck();
 }
@@ -1460,6 +1595,8 @@ TcpTxBuffer::ConsistencyCheck() const
     NS_ASSERT_MSG(lost == m_lostOut, " Counted lost: " << lost << " stored lost: " << m_lostOut);
     NS_ASSERT_MSG(retrans == m_retrans,
                   " Counted retrans: " << retrans << " stored retrans: " << m_retrans);
+    NS_ASSERT_MSG(m_sentIndex.size() == m_sentList.size(),
+                  " Indexed items: " << m_sentIndex.size() << " sent items: " << m_sentList.size());
 }
 
 std::ostream&
@@ -27,6 +27,10 @@
 #include "ns3/tcp-tx-item.h"
 #include "ns3/traced-value.h"
 
+#include <map>
+
+class TcpTxBufferNextSegTestCase;
+
 namespace ns3
 {
 class Packet;
@@ -73,6 +77,11 @@ class Packet;
  * documentation) and maintaining the scoreboard is a matter of travelling the
  * list and set the SACK flag on the corresponding segment sent.
  *
+ * To avoid walking the sent list from its head for each SACK block,
+ * retransmission or loss query, the items of the SentList are also indexed by
+ * their starting sequence number. The index is kept in sync each time an item
+ * is sent, fragmented, merged or discarded.
+ *
  * Item properties
  * ---------------
  *
@@ -409,6 +418,11 @@ class TcpTxBuffer : public Object
 
   private:
     friend std::ostream& operator<<(std::ostream& os, const TcpTxBuffer& tcpTxBuf);
+    /**
+     * \brief TcpTxBufferNextSegTestCase test case.
+     * \relates TcpTxBufferNextSegTestCase
+     */
+    friend class ::TcpTxBufferNextSegTestCase;
 
     typedef std::list<TcpTxItem*> PacketList; //!< container for data stored in the buffer
 
@@ -433,6 +447,15 @@ class TcpTxBuffer : public Object
      */
     void UpdateLostCount();
 
+    /**
+     * \brief Reset the marks of the lost items to cover the whole sent list
+     *
+     * Called when the lost, sacked or retransmitted flags of the sent items
+     * are cleared, since the marks may then skip items which NextSeg and
+     * UpdateLostCount must consider again.
+     */
+    void ResetLostMarks();
+
     /**
      * \brief Remove the size specified from the lostOut, retrans, sacked count
      *
@@ -563,7 +586,7 @@ class TcpTxBuffer : public Object
                                  const SequenceNumber32& startingSeq,
                                  uint32_t numBytes,
                                  const SequenceNumber32& requestedSeq,
-                                 bool* listEdited = nullptr) const;
+                                 bool* listEdited = nullptr);
 
     /**
      * \brief Merge two TcpTxItem
@@ -601,8 +624,18 @@ class TcpTxBuffer : public Object
      */
     std::pair<TcpTxBuffer::PacketList::const_iterator, SequenceNumber32> FindHighestSacked() const;
 
+    /**
+     * \brief Find the item of the sent list which contains a sequence number
+     * \param seq the sequence number
+     * \return an iterator inside m_sentIndex, or m_sentIndex.end() if there is no such item
+     */
+    std::map<SequenceNumber32, PacketList::iterator>::const_iterator FindSentItem(
+        const SequenceNumber32& seq) const;
+
     PacketList m_appList;              //!< Buffer for application data
     PacketList m_sentList;             //!< Buffer for sent (but not acked) data
+    /// Items of the sent list, indexed by their starting sequence number
+    std::map<SequenceNumber32, PacketList::iterator> m_sentIndex;
     uint32_t m_maxBuffer;              //!< Max number of data bytes in buffer (SND.WND)
     uint32_t m_size;                   //!< Size of all data in this buffer
     uint32_t m_sentSize;               //!< Size of sent (and not discarded) segments
@@ -615,6 +648,12 @@ class TcpTxBuffer : public Object
     uint32_t m_lostOut{0};   //!< Number of lost bytes
     uint32_t m_sackedOut{0}; //!< Number of sacked bytes
     uint32_t m_retrans{0};   //!< Number of retransmitted bytes
+    /// The sent items starting before this sequence number are all lost or sacked
+    SequenceNumber32 m_lostMarkedSeq{0};
+    /// The sent items starting from this sequence number on are not lost
+    SequenceNumber32 m_lostHighSeq{0};
+    /// The lost sent items starting before this sequence number are all retransmitted
+    mutable SequenceNumber32 m_lostRetxSeq{0};
 
     uint32_t m_dupAckThresh{0}; //!< Duplicate Ack threshold from TcpSocketBase
     uint32_t m_segmentSize{0};  //!< Segment size from TcpSocketBase
@@ -75,6 +75,12 @@ TcpTxItem::IsRetrans() const
     return m_retrans;
 }
 
+bool
+TcpTxItem::IsLost() const
+{
+    return m_lost;
+}
+
 Ptr<Packet>
 TcpTxItem::GetPacketCopy() const
 {
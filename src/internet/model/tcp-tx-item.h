@@ -60,6 +60,12 @@ class TcpTxItem
      */
     bool IsRetrans() const;
 
+    /**
+     * \brief Is the item lost?
+     * \return true if the item is marked as lost
+     */
+    bool IsLost() const;
+
     /**
      * \brief Get a copy of the Packet underlying this item
      * \return a copy of the Packet
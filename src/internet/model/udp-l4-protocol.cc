@@ -358,12 +358,12 @@ UdpL4Protocol::Receive(Ptr<Packet> packet, const Ipv4Header& header, Ptr<Ipv4Int
 
     NS_LOG_DEBUG("Looking up dst " << header.GetDestination() << " port "
                                    << udpHeader.GetDestinationPort());
-    Ipv4EndPointDemux::EndPoints endPoints = m_endPoints->Lookup(header.GetDestination(),
-                                                                 udpHeader.GetDestinationPort(),
-                                                                 header.GetSource(),
-                                                                 udpHeader.GetSourcePort(),
-                                                                 interface);
-    if (endPoints.empty())
+    Ipv4EndPoint* endPoint = m_endPoints->LookupEndPoint(header.GetDestination(),
+                                                         udpHeader.GetDestinationPort(),
+                                                         header.GetSource(),
+                                                         udpHeader.GetSourcePort(),
+                                                         interface);
+    if (!endPoint)
     {
         if (this->GetObject<Ipv6>())
         {
@@ -382,11 +382,7 @@ UdpL4Protocol::Receive(Ptr<Packet> packet, const Ipv4Header& header, Ptr<Ipv4Int
     }
 
     packet->RemoveHeader(udpHeader);
-    for (Ipv4EndPointDemux::EndPointsI endPoint = endPoints.begin(); endPoint != endPoints.end();
-         endPoint++)
-    {
-        (*endPoint)->ForwardUp(packet->Copy(), header, udpHeader.GetSourcePort(), interface);
-    }
+    endPoint->ForwardUp(packet->Copy(), header, udpHeader.GetSourcePort(), interface);
     return IpL4Protocol::RX_OK;
 }
 
@@ -412,21 +408,17 @@ UdpL4Protocol::Receive(Ptr<Packet> packet, const Ipv6Header& header, Ptr<Ipv6Int
 
     NS_LOG_DEBUG("Looking up dst " << header.GetDestination() << " port "
                                    << udpHeader.GetDestinationPort());
-    Ipv6EndPointDemux::EndPoints endPoints = m_endPoints6->Lookup(header.GetDestination(),
-                                                                  udpHeader.GetDestinationPort(),
-                                                                  header.GetSource(),
-                                                                  udpHeader.GetSourcePort(),
-                                                                  interface);
-    if (endPoints.empty())
+    Ipv6EndPoint* endPoint = m_endPoints6->LookupEndPoint(header.GetDestination(),
+                                                          udpHeader.GetDestinationPort(),
+                                                          header.GetSource(),
+                                                          udpHeader.GetSourcePort(),
+                                                          interface);
+    if (!endPoint)
     {
         NS_LOG_LOGIC("RX_ENDPOINT_UNREACH");
         return IpL4Protocol::RX_ENDPOINT_UNREACH;
     }
-    for (Ipv6EndPointDemux::EndPointsI endPoint = endPoints.begin(); endPoint != endPoints.end();
-         endPoint++)
-    {
-        (*endPoint)->ForwardUp(packet->Copy(), header, udpHeader.GetSourcePort(), interface);
-    }
+    endPoint->ForwardUp(packet->Copy(), header, udpHeader.GetSourcePort(), interface);
     return IpL4Protocol::RX_OK;
 }
 
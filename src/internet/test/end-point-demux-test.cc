@@ -0,0 +1,245 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv6-end-point-demux.h"
+#include "ns3/ipv6-end-point.h"
+#include "ns3/log.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("EndPointDemuxTest");
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Ipv4EndPointDemux lookup test.
+ *
+ * Check that the lookups return the most specific end point, also after the
+ * end points change their addresses, and that deallocated end points are
+ * no longer found.
+ */
+class Ipv4EndPointDemuxTestCase : public TestCase
+{
+  public:
+    Ipv4EndPointDemuxTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+Ipv4EndPointDemuxTestCase::Ipv4EndPointDemuxTestCase()
+    : TestCase("Check the lookups of the Ipv4EndPointDemux")
+{
+}
+
+void
+Ipv4EndPointDemuxTestCase::DoRun()
+{
+    Ipv4EndPointDemux demux;
+    Ipv4Address local("10.0.0.1");
+    Ipv4Address peer("10.0.0.2");
+
+    Ipv4EndPoint* listener = demux.Allocate(nullptr, 80);
+    NS_TEST_ASSERT_MSG_NE(listener, nullptr, "The listener should be allocated");
+    NS_TEST_ASSERT_MSG_EQ(demux.Allocate(nullptr, 80), nullptr, "The port is already bound");
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupPortLocal(80), true, "The port should be in use");
+
+    // many connections accepted by the listener
+    std::vector<Ipv4EndPoint*> connections;
+    for (uint16_t port = 1000; port < 1100; port++)
+    {
+        connections.push_back(demux.Allocate(nullptr, local, 80, peer, port));
+    }
+    NS_TEST_ASSERT_MSG_EQ(demux.Allocate(nullptr, local, 80, peer, 1000),
+                          nullptr,
+                          "The connection already exists");
+
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupEndPoint(local, 80, peer, 1042, nullptr),
+                          connections[42],
+                          "The connection should match exactly");
+    NS_TEST_ASSERT_MSG_EQ(demux.Lookup(local, 80, peer, 1042, nullptr).front(),
+                          connections[42],
+                          "The connection should match exactly");
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupEndPoint(local, 80, peer, 2000, nullptr),
+                          listener,
+                          "A new connection should match the listener");
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupEndPoint(local, 81, peer, 1042, nullptr),
+                          nullptr,
+                          "No end point is bound to the port");
+    NS_TEST_ASSERT_MSG_EQ(demux.SimpleLookup(local, 80, peer, 1042),
+                          connections[42],
+                          "The connection should match exactly");
+
+    // a listener bound to the address takes precedence over the wildcard one
+    Ipv4EndPoint* boundListener = demux.Allocate(nullptr, local, 8080);
+    Ipv4EndPoint* anyListener = demux.Allocate(nullptr, 8080);
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupEndPoint(local, 8080, peer, 2000, nullptr),
+                          boundListener,
+                          "A new connection should match the listener bound to the address");
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupEndPoint(peer, 8080, local, 2000, nullptr),
+                          anyListener,
+                          "A new connection should match the wildcard listener");
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupLocal(nullptr, local, 8080),
+                          true,
+                          "The address and port should be in use");
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupLocal(nullptr, peer, 8080),
+                          false,
+                          "The address and port should be free");
+    NS_TEST_ASSERT_MSG_EQ(demux.Allocate(nullptr, local, 8080),
+                          nullptr,
+                          "The listener already exists");
+    NS_TEST_ASSERT_MSG_EQ(demux.SimpleLookup(peer, 8080, local, 2000),
+                          boundListener,
+                          "The least generic end point bound to the port should be found");
+
+    // end points disabled for reception are skipped
+    connections[42]->SetRxEnabled(false);
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupEndPoint(local, 80, peer, 1042, nullptr),
+                          listener,
+                          "A disabled connection should be skipped");
+    connections[42]->SetRxEnabled(true);
+
+    // a client connecting from an ephemeral port
+    Ipv4EndPoint* client = demux.Allocate();
+    uint16_t clientPort = client->GetLocalPort();
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupEndPoint(local, clientPort, peer, 80, nullptr),
+                          client,
+                          "The unconnected client should match");
+    client->SetPeer(peer, 80);
+    client->SetLocalAddress(local);
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupEndPoint(local, clientPort, peer, 80, nullptr),
+                          client,
+                          "The connected client should match");
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupEndPoint(local, clientPort, peer, 81, nullptr),
+                          nullptr,
+                          "The connected client should not match another peer");
+
+    demux.DeAllocate(connections[42]);
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupEndPoint(local, 80, peer, 1042, nullptr),
+                          listener,
+                          "A deallocated connection should not be found");
+    NS_TEST_ASSERT_MSG_EQ(demux.SimpleLookup(local, 80, peer, 2000),
+                          connections[0],
+                          "The first least generic end point bound to the port should be found");
+    demux.DeAllocate(connections[0]);
+    NS_TEST_ASSERT_MSG_EQ(demux.SimpleLookup(local, 80, peer, 2000),
+                          connections[1],
+                          "The first least generic end point bound to the port should be found");
+    demux.DeAllocate(client);
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupPortLocal(clientPort),
+                          false,
+                          "The port of the client should be free");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Ipv6EndPointDemux lookup test.
+ *
+ * Check that the lookups return the most specific end point, also after the
+ * end points change their addresses, and that deallocated end points are
+ * no longer found.
+ */
+class Ipv6EndPointDemuxTestCase : public TestCase
+{
+  public:
+    Ipv6EndPointDemuxTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+Ipv6EndPointDemuxTestCase::Ipv6EndPointDemuxTestCase()
+    : TestCase("Check the lookups of the Ipv6EndPointDemux")
+{
+}
+
+void
+Ipv6EndPointDemuxTestCase::DoRun()
+{
+    Ipv6EndPointDemux demux;
+    Ipv6Address local("2001:db8::1");
+    Ipv6Address peer("2001:db8::2");
+
+    Ipv6EndPoint* listener = demux.Allocate(nullptr, 80);
+    NS_TEST_ASSERT_MSG_NE(listener, nullptr, "The listener should be allocated");
+
+    std::vector<Ipv6EndPoint*> connections;
+    for (uint16_t port = 1000; port < 1100; port++)
+    {
+        connections.push_back(demux.Allocate(nullptr, local, 80, peer, port));
+    }
+    NS_TEST_ASSERT_MSG_EQ(demux.Allocate(nullptr, local, 80, peer, 1000),
+                          nullptr,
+                          "The connection already exists");
+
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupEndPoint(local, 80, peer, 1042, nullptr),
+                          connections[42],
+                          "The connection should match exactly");
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupEndPoint(local, 80, peer, 2000, nullptr),
+                          listener,
+                          "A new connection should match the listener");
+    NS_TEST_ASSERT_MSG_EQ(demux.SimpleLookup(local, 80, peer, 1042),
+                          connections[42],
+                          "The connection should match exactly");
+
+    Ipv6EndPoint* client = demux.Allocate();
+    uint16_t clientPort = client->GetLocalPort();
+    client->SetPeer(peer, 80);
+    client->SetLocalAddress(local);
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupEndPoint(local, clientPort, peer, 80, nullptr),
+                          client,
+                          "The connected client should match");
+    client->SetLocalPort(5000);
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupPortLocal(clientPort),
+                          false,
+                          "The previous port of the client should be free");
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupLocal(nullptr, local, 5000),
+                          true,
+                          "The new port of the client should be in use");
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupEndPoint(local, 5000, peer, 80, nullptr),
+                          client,
+                          "The client should match on its new port");
+
+    demux.DeAllocate(connections[42]);
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupEndPoint(local, 80, peer, 1042, nullptr),
+                          listener,
+                          "A deallocated connection should not be found");
+    demux.DeAllocate(client);
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupPortLocal(5000),
+                          false,
+                          "The port of the client should be free");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief End point demux TestSuite
+ */
+class EndPointDemuxTestSuite : public TestSuite
+{
+  public:
+    EndPointDemuxTestSuite()
+        : TestSuite("end-point-demux", UNIT)
+    {
+        AddTestCase(new Ipv4EndPointDemuxTestCase, TestCase::QUICK);
+        AddTestCase(new Ipv6EndPointDemuxTestCase, TestCase::QUICK);
+    }
+};
+
+static EndPointDemuxTestSuite g_endPointDemuxTestSuite; //!< Static variable for test initialization
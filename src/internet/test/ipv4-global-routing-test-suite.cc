@@ -41,6 +41,7 @@
 #include "ns3/udp-socket-factory.h"
 #include "ns3/uinteger.h"
 
+#include <sstream>
 #include <vector>
 
 using namespace ns3;
@@ -1313,6 +1314,163 @@ Ipv4GlobalRoutingSlash32TestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 GlobalRouting parallel and incremental SPF test
+ *
+ * Checks that the routes computed on several threads match the serial ones,
+ * that an incremental update gives the same routes as a full recomputation
+ * and that it leaves alone the routers that do not reach the change.
+ */
+class Ipv4GlobalRoutingUpdateTestCase : public TestCase
+{
+  public:
+    Ipv4GlobalRoutingUpdateTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Get the global routes of a node.
+     * \param node The node.
+     * \return The routing table entries of the node, one per line.
+     */
+    std::string GetRoutes(Ptr<Node> node) const;
+    /**
+     * \brief Get the global routes of all the nodes.
+     * \return The routing table entries of the nodes, one per line.
+     */
+    std::string GetAllRoutes() const;
+
+    NodeContainer m_nodes; //!< Nodes used in the test.
+};
+
+Ipv4GlobalRoutingUpdateTestCase::Ipv4GlobalRoutingUpdateTestCase()
+    : TestCase("Parallel and incremental global routing")
+{
+}
+
+std::string
+Ipv4GlobalRoutingUpdateTestCase::GetRoutes(Ptr<Node> node) const
+{
+    Ptr<Ipv4RoutingProtocol> routing = node->GetObject<Ipv4>()->GetRoutingProtocol();
+    Ptr<Ipv4GlobalRouting> globalRouting = routing->GetObject<Ipv4GlobalRouting>();
+    std::ostringstream oss;
+    for (uint32_t i = 0; i < globalRouting->GetNRoutes(); i++)
+    {
+        Ipv4RoutingTableEntry* route = globalRouting->GetRoute(i);
+        if (route->GetDest() != Ipv4Address("192.168.0.1"))
+        {
+            oss << node->GetId() << ": " << *route << std::endl;
+        }
+    }
+    return oss.str();
+}
+
+std::string
+Ipv4GlobalRoutingUpdateTestCase::GetAllRoutes() const
+{
+    std::string routes;
+    for (auto i = m_nodes.Begin(); i != m_nodes.End(); i++)
+    {
+        routes += GetRoutes(*i);
+    }
+    return routes;
+}
+
+// Two disconnected networks.  The first one is a triangle of routers with
+// a LAN between n0, n4 and n9 and the stub routers n3 and n5; the second one
+// is a chain of three routers.
+//
+//      n5
+//      |
+//      n1 ------- n2 ------- n3          n6 ------- n7 ------- n8
+//        \       /
+//         \     /
+//           n0                           LAN: n0, n4, n9
+//
+void
+Ipv4GlobalRoutingUpdateTestCase::DoRun()
+{
+    m_nodes.Create(10);
+
+    InternetStackHelper internet;
+    Ipv4GlobalRoutingHelper ipv4RoutingHelper;
+    internet.SetRoutingHelper(ipv4RoutingHelper);
+    internet.Install(m_nodes);
+
+    SimpleNetDeviceHelper p2pHelper;
+    p2pHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.1.0", "255.255.255.252");
+    const uint32_t links[][2] = {{0, 1}, {1, 2}, {2, 0}, {2, 3}, {1, 5}, {6, 7}, {7, 8}};
+    for (const auto& link : links)
+    {
+        NodeContainer pair(m_nodes.Get(link[0]), m_nodes.Get(link[1]));
+        ipv4.Assign(p2pHelper.Install(pair));
+        ipv4.NewNetwork();
+    }
+
+    SimpleNetDeviceHelper lanHelper;
+    ipv4.SetBase("10.2.1.0", "255.255.255.0");
+    ipv4.Assign(lanHelper.Install(NodeContainer(m_nodes.Get(0), m_nodes.Get(4), m_nodes.Get(9))));
+
+    Config::SetGlobal("GlobalRoutingSpfThreads", UintegerValue(1));
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    std::string serialRoutes = GetAllRoutes();
+
+    Config::SetGlobal("GlobalRoutingSpfThreads", UintegerValue(4));
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    NS_TEST_ASSERT_MSG_EQ(GetAllRoutes(),
+                          serialRoutes,
+                          "Parallel SPF did not compute the serial routes");
+
+    // Mark the routing tables of the stub router n5 and of n7 to check that
+    // an update of the first network does not recompute them.
+    for (uint32_t id : {5, 7})
+    {
+        Ptr<Ipv4RoutingProtocol> routing = m_nodes.Get(id)->GetObject<Ipv4>()->GetRoutingProtocol();
+        routing->GetObject<Ipv4GlobalRouting>()->AddHostRouteTo(Ipv4Address("192.168.0.1"), 1);
+    }
+    std::string stubRoutes = GetRoutes(m_nodes.Get(5));
+    std::string otherRoutes = GetRoutes(m_nodes.Get(7));
+
+    // Bring down the link between n0 and n2; the interface 2 of n0 faces n2.
+    Ptr<Ipv4> ipv40 = m_nodes.Get(0)->GetObject<Ipv4>();
+    ipv40->SetDown(2);
+    Ipv4GlobalRoutingHelper::UpdateRoutingTables();
+    for (uint32_t id : {5, 7})
+    {
+        Ptr<Ipv4RoutingProtocol> routing = m_nodes.Get(id)->GetObject<Ipv4>()->GetRoutingProtocol();
+        Ptr<Ipv4GlobalRouting> globalRouting = routing->GetObject<Ipv4GlobalRouting>();
+        bool marked = false;
+        for (uint32_t i = 0; i < globalRouting->GetNRoutes(); i++)
+        {
+            marked |= globalRouting->GetRoute(i)->GetDest() == Ipv4Address("192.168.0.1");
+        }
+        NS_TEST_ASSERT_MSG_EQ(marked, true, "Incremental update recomputed the routes of " << id);
+    }
+    NS_TEST_ASSERT_MSG_EQ(GetRoutes(m_nodes.Get(5)), stubRoutes, "Stub routes changed");
+    NS_TEST_ASSERT_MSG_EQ(GetRoutes(m_nodes.Get(7)), otherRoutes, "Unrelated routes changed");
+    std::string updatedRoutes = GetAllRoutes();
+    NS_TEST_ASSERT_MSG_NE(updatedRoutes, serialRoutes, "Incremental update changed no route");
+
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    NS_TEST_ASSERT_MSG_EQ(updatedRoutes,
+                          GetAllRoutes(),
+                          "Incremental update did not compute the full routes");
+
+    ipv40->SetUp(2);
+    Ipv4GlobalRoutingHelper::UpdateRoutingTables();
+    NS_TEST_ASSERT_MSG_EQ(GetAllRoutes(),
+                          serialRoutes,
+                          "Incremental update did not restore the initial routes");
+
+    Config::SetGlobal("GlobalRoutingSpfThreads", UintegerValue(1));
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -1335,6 +1493,7 @@ Ipv4GlobalRoutingTestSuite::Ipv4GlobalRoutingTestSuite()
     AddTestCase(new TwoBridgeTest, TestCase::QUICK);
     AddTestCase(new Ipv4DynamicGlobalRoutingTestCase, TestCase::QUICK);
     AddTestCase(new Ipv4GlobalRoutingSlash32TestCase, TestCase::QUICK);
+    AddTestCase(new Ipv4GlobalRoutingUpdateTestCase, TestCase::QUICK);
 }
 
 static Ipv4GlobalRoutingTestSuite
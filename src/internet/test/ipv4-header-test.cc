@@ -290,6 +290,84 @@ Ipv4HeaderTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 Header checksum update test.
+ *
+ * Check that the checksum of a deserialized header, updated incrementally
+ * when the TTL is decremented, matches the one computed from scratch.
+ */
+class Ipv4HeaderChecksumTest : public TestCase
+{
+  public:
+    Ipv4HeaderChecksumTest();
+
+  private:
+    void DoRun() override;
+};
+
+Ipv4HeaderChecksumTest::Ipv4HeaderChecksumTest()
+    : TestCase("IPv4 Header Checksum Update Test")
+{
+}
+
+void
+Ipv4HeaderChecksumTest::DoRun()
+{
+    const uint8_t protocols[] = {0, 6, 17, 255};
+    for (uint8_t protocol : protocols)
+    {
+        for (uint32_t ttl = 1; ttl < 256; ttl++)
+        {
+            Ipv4Header header;
+            header.EnableChecksum();
+            header.SetSource(Ipv4Address("10.1.2.3"));
+            header.SetDestination(Ipv4Address("192.168.255.254"));
+            header.SetProtocol(protocol);
+            header.SetPayloadSize(1000 + ttl);
+            header.SetIdentification(ttl * 257);
+            header.SetTtl(ttl);
+
+            Buffer buffer;
+            buffer.AddAtStart(header.GetSerializedSize());
+            header.Serialize(buffer.Begin());
+
+            Ipv4Header forwarded;
+            forwarded.EnableChecksum();
+            forwarded.Deserialize(buffer.Begin());
+            NS_TEST_ASSERT_MSG_EQ(forwarded.IsChecksumOk(), true, "Wrong checksum");
+            forwarded.SetTtl(ttl - 1);
+
+            Buffer forwardedBuffer;
+            forwardedBuffer.AddAtStart(forwarded.GetSerializedSize());
+            forwarded.Serialize(forwardedBuffer.Begin());
+
+            header.SetTtl(ttl - 1);
+            Buffer expectedBuffer;
+            expectedBuffer.AddAtStart(header.GetSerializedSize());
+            header.Serialize(expectedBuffer.Begin());
+
+            Buffer::Iterator i = forwardedBuffer.Begin();
+            Buffer::Iterator j = expectedBuffer.Begin();
+            i.Next(10);
+            j.Next(10);
+            NS_TEST_ASSERT_MSG_EQ(i.ReadNtohU16(),
+                                  j.ReadNtohU16(),
+                                  "Wrong updated checksum for TTL " << ttl << " and protocol "
+                                                                    << +protocol);
+
+            // changing another field requires to compute the checksum again
+            forwarded.SetTos(ttl);
+            forwarded.Serialize(forwardedBuffer.Begin());
+            Ipv4Header received;
+            received.EnableChecksum();
+            received.Deserialize(forwardedBuffer.Begin());
+            NS_TEST_ASSERT_MSG_EQ(received.IsChecksumOk(), true, "Wrong recomputed checksum");
+        }
+    }
+}
+
 /**
  * \ingroup internet-test
  *
@@ -302,6 +380,7 @@ class Ipv4HeaderTestSuite : public TestSuite
         : TestSuite("ipv4-header", UNIT)
     {
         AddTestCase(new Ipv4HeaderTest, TestCase::QUICK);
+        AddTestCase(new Ipv4HeaderChecksumTest, TestCase::QUICK);
     }
 };
 
@@ -16,8 +16,13 @@
  *
  */
 
+#include "ns3/boolean.h"
+#include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-list-routing.h"
+#include "ns3/ipv4-route.h"
 #include "ns3/ipv4-routing-protocol.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
 #include "ns3/test.h"
 
 namespace ns3
@@ -127,6 +132,211 @@ class Ipv4BRouting : public Ipv4RoutingProtocol
     }
 };
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 dummy routing class whose routes can be cached, counting the lookups.
+ */
+class Ipv4CachedRouting : public Ipv4ARouting
+{
+  public:
+    Ptr<Ipv4Route> RouteOutput(Ptr<Packet> p,
+                               const Ipv4Header& header,
+                               Ptr<NetDevice> oif,
+                               Socket::SocketErrno& sockerr) override
+    {
+        m_lookups++;
+        Ptr<Ipv4Route> route = Create<Ipv4Route>();
+        route->SetDestination(header.GetDestination());
+        sockerr = Socket::ERROR_NOTERROR;
+        return route;
+    }
+
+    bool RouteInput(Ptr<const Packet> p,
+                    const Ipv4Header& header,
+                    Ptr<const NetDevice> idev,
+                    const UnicastForwardCallback& ucb,
+                    const MulticastForwardCallback& mcb,
+                    const LocalDeliverCallback& lcb,
+                    const ErrorCallback& ecb) override
+    {
+        m_lookups++;
+        Ptr<Ipv4Route> route = Create<Ipv4Route>();
+        route->SetDestination(header.GetDestination());
+        ucb(route, p, header);
+        return true;
+    }
+
+    uint64_t GetRoutesGeneration() const override
+    {
+        return m_generation;
+    }
+
+    uint32_t m_lookups{0};    //!< Number of lookups
+    uint64_t m_generation{1}; //!< Generation of the routes
+};
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 ListRouting route cache test.
+ */
+class Ipv4ListRoutingCacheTestCase : public TestCase
+{
+  public:
+    Ipv4ListRoutingCacheTestCase();
+    void DoRun() override;
+};
+
+Ipv4ListRoutingCacheTestCase::Ipv4ListRoutingCacheTestCase()
+    : TestCase("Check the route cache")
+{
+}
+
+void
+Ipv4ListRoutingCacheTestCase::DoRun()
+{
+    Ptr<Ipv4ListRouting> lr = CreateObject<Ipv4ListRouting>();
+    lr->SetAttribute("RouteCache", BooleanValue(true));
+    Ptr<Ipv4CachedRouting> cRouting = CreateObject<Ipv4CachedRouting>();
+    lr->AddRoutingProtocol(cRouting, 0);
+
+    Ipv4Header header;
+    header.SetDestination(Ipv4Address("10.0.0.1"));
+    Socket::SocketErrno sockerr;
+    Ptr<Ipv4Route> route = lr->RouteOutput(Create<Packet>(), header, nullptr, sockerr);
+    NS_TEST_ASSERT_MSG_EQ(lr->RouteOutput(Create<Packet>(), header, nullptr, sockerr),
+                          route,
+                          "The cached route should be returned");
+    NS_TEST_ASSERT_MSG_EQ(sockerr, Socket::ERROR_NOTERROR, "The route should be found");
+    NS_TEST_ASSERT_MSG_EQ(cRouting->m_lookups, 1, "The route should be looked up once");
+
+    header.SetTos(4);
+    lr->RouteOutput(Create<Packet>(), header, nullptr, sockerr);
+    header.SetTos(0);
+    header.SetDestination(Ipv4Address("10.0.0.2"));
+    lr->RouteOutput(Create<Packet>(), header, nullptr, sockerr);
+    NS_TEST_ASSERT_MSG_EQ(cRouting->m_lookups, 3, "Other TOS and destinations are looked up");
+
+    // a change of the routes flushes the cache
+    cRouting->m_generation++;
+    header.SetDestination(Ipv4Address("10.0.0.1"));
+    NS_TEST_ASSERT_MSG_NE(lr->RouteOutput(Create<Packet>(), header, nullptr, sockerr),
+                          route,
+                          "The route should be looked up again");
+    NS_TEST_ASSERT_MSG_EQ(cRouting->m_lookups, 4, "The route should be looked up again");
+
+    // the routes of the other protocols can not be cached
+    lr->AddRoutingProtocol(CreateObject<Ipv4ARouting>(), 10);
+    lr->RouteOutput(Create<Packet>(), header, nullptr, sockerr);
+    lr->RouteOutput(Create<Packet>(), header, nullptr, sockerr);
+    NS_TEST_ASSERT_MSG_EQ(cRouting->m_lookups, 6, "The routes should not be cached");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 ListRouting forward route cache test.
+ */
+class Ipv4ListRoutingForwardCacheTestCase : public TestCase
+{
+  public:
+    Ipv4ListRoutingForwardCacheTestCase();
+    void DoRun() override;
+
+  private:
+    /**
+     * Count a forwarded packet.
+     * \param route the route
+     * \param p the packet
+     * \param header the IPv4 header
+     */
+    void Forward(Ptr<Ipv4Route> route, Ptr<const Packet> p, const Ipv4Header& header);
+    /**
+     * Count a packet not forwarded.
+     * \param p the packet
+     * \param header the IPv4 header
+     * \param sockerr the error
+     */
+    void Error(Ptr<const Packet> p, const Ipv4Header& header, Socket::SocketErrno sockerr);
+
+    uint32_t m_forwarded{0}; //!< Number of packets forwarded
+    uint32_t m_errors{0};    //!< Number of packets not forwarded
+};
+
+Ipv4ListRoutingForwardCacheTestCase::Ipv4ListRoutingForwardCacheTestCase()
+    : TestCase("Check the forward route cache")
+{
+}
+
+void
+Ipv4ListRoutingForwardCacheTestCase::Forward(Ptr<Ipv4Route> route,
+                                             Ptr<const Packet> p,
+                                             const Ipv4Header& header)
+{
+    m_forwarded++;
+}
+
+void
+Ipv4ListRoutingForwardCacheTestCase::Error(Ptr<const Packet> p,
+                                           const Ipv4Header& header,
+                                           Socket::SocketErrno sockerr)
+{
+    m_errors++;
+}
+
+void
+Ipv4ListRoutingForwardCacheTestCase::DoRun()
+{
+    Ptr<Node> node = CreateObject<Node>();
+    InternetStackHelper internet;
+    internet.SetIpv6StackInstall(false);
+    internet.Install(node);
+    Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice>();
+    device->SetAddress(Mac48Address::Allocate());
+    node->AddDevice(device);
+    Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+    uint32_t iif = ipv4->AddInterface(device);
+    ipv4->AddAddress(iif, Ipv4InterfaceAddress("10.1.0.1", "255.255.255.0"));
+    ipv4->SetUp(iif);
+    ipv4->SetForwarding(iif, true);
+
+    Ptr<Ipv4ListRouting> lr = CreateObject<Ipv4ListRouting>();
+    lr->SetAttribute("RouteCache", BooleanValue(true));
+    Ptr<Ipv4CachedRouting> cRouting = CreateObject<Ipv4CachedRouting>();
+    lr->AddRoutingProtocol(cRouting, 0);
+    lr->SetIpv4(ipv4);
+
+    Ipv4Header header;
+    header.SetDestination(Ipv4Address("10.0.0.1"));
+    auto routeInput = [&]() {
+        lr->RouteInput(Create<Packet>(),
+                       header,
+                       device,
+                       MakeCallback(&Ipv4ListRoutingForwardCacheTestCase::Forward, this),
+                       Ipv4RoutingProtocol::MulticastForwardCallback(),
+                       Ipv4RoutingProtocol::LocalDeliverCallback(),
+                       MakeCallback(&Ipv4ListRoutingForwardCacheTestCase::Error, this));
+    };
+    routeInput();
+    routeInput();
+    NS_TEST_ASSERT_MSG_EQ(m_forwarded, 2, "The packets should be forwarded");
+    NS_TEST_ASSERT_MSG_EQ(cRouting->m_lookups, 1, "The route should be looked up once");
+
+    // the cached routes are not used on an interface which does not forward
+    ipv4->SetForwarding(iif, false);
+    routeInput();
+    NS_TEST_ASSERT_MSG_EQ(m_forwarded, 2, "The packet should not be forwarded");
+    NS_TEST_ASSERT_MSG_EQ(m_errors, 1, "The packet should be dropped");
+
+    ipv4->SetForwarding(iif, true);
+    routeInput();
+    NS_TEST_ASSERT_MSG_EQ(m_forwarded, 3, "The packet should be forwarded again");
+    NS_TEST_ASSERT_MSG_EQ(cRouting->m_lookups, 1, "The cached route should be used");
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -213,6 +423,8 @@ class Ipv4ListRoutingTestSuite : public TestSuite
     {
         AddTestCase(new Ipv4ListRoutingPositiveTestCase(), TestCase::QUICK);
         AddTestCase(new Ipv4ListRoutingNegativeTestCase(), TestCase::QUICK);
+        AddTestCase(new Ipv4ListRoutingCacheTestCase(), TestCase::QUICK);
+        AddTestCase(new Ipv4ListRoutingForwardCacheTestCase(), TestCase::QUICK);
     }
 };
 
@@ -20,6 +20,9 @@
 #include "ns3/inet-socket-address.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/ipv4-static-routing-helper.h"
 #include "ns3/node-container.h"
 #include "ns3/node.h"
@@ -207,6 +210,148 @@ Ipv4StaticRoutingSlash32TestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 StaticRouting route selection Test
+ *
+ * Checks that the route with the longest matching prefix is selected, that
+ * the route with the lowest metric (the last one added, in case of ties) is
+ * selected among the ones with the same prefix, except for host routes, for
+ * which the first one added is selected, and that removed routes are no
+ * longer used.
+ */
+class Ipv4StaticRoutingLookupTestCase : public TestCase
+{
+  public:
+    Ipv4StaticRoutingLookupTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Get the gateway of the route to a destination.
+     * \param routing The static routing protocol.
+     * \param dest The destination address.
+     * \return The gateway of the route, or 255.255.255.255 if there is no route.
+     */
+    Ipv4Address GetGateway(Ptr<Ipv4StaticRouting> routing, std::string dest);
+};
+
+Ipv4StaticRoutingLookupTestCase::Ipv4StaticRoutingLookupTestCase()
+    : TestCase("Static routing route selection")
+{
+}
+
+Ipv4Address
+Ipv4StaticRoutingLookupTestCase::GetGateway(Ptr<Ipv4StaticRouting> routing, std::string dest)
+{
+    Ipv4Header header;
+    header.SetDestination(Ipv4Address(dest.c_str()));
+    Socket::SocketErrno sockerr;
+    Ptr<Ipv4Route> route = routing->RouteOutput(Create<Packet>(), header, nullptr, sockerr);
+    return route ? route->GetGateway() : Ipv4Address::GetBroadcast();
+}
+
+void
+Ipv4StaticRoutingLookupTestCase::DoRun()
+{
+    Ptr<Node> node = CreateObject<Node>();
+    InternetStackHelper internet;
+    internet.Install(node);
+    SimpleNetDeviceHelper devHelper;
+    NetDeviceContainer devices = devHelper.Install(node);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("1.0.0.0", "255.255.255.0");
+    ipv4.Assign(devices);
+
+    Ipv4StaticRoutingHelper ipv4RoutingHelper;
+    Ptr<Ipv4StaticRouting> routing =
+        ipv4RoutingHelper.GetStaticRouting(node->GetObject<Ipv4>());
+    routing->SetDefaultRoute(Ipv4Address("1.0.0.8"), 1);
+    routing->AddNetworkRouteTo(Ipv4Address("10.0.0.0"),
+                               Ipv4Mask("255.0.0.0"),
+                               Ipv4Address("1.0.0.2"),
+                               1);
+    routing->AddNetworkRouteTo(Ipv4Address("10.1.0.0"),
+                               Ipv4Mask("255.255.0.0"),
+                               Ipv4Address("1.0.0.3"),
+                               1,
+                               5);
+    routing->AddNetworkRouteTo(Ipv4Address("10.1.0.0"),
+                               Ipv4Mask("255.255.0.0"),
+                               Ipv4Address("1.0.0.4"),
+                               1,
+                               2);
+    routing->AddNetworkRouteTo(Ipv4Address("10.1.0.0"),
+                               Ipv4Mask("255.255.0.0"),
+                               Ipv4Address("1.0.0.5"),
+                               1,
+                               2);
+    routing->AddHostRouteTo(Ipv4Address("10.1.2.3"), Ipv4Address("1.0.0.6"), 1, 3);
+    routing->AddHostRouteTo(Ipv4Address("10.1.2.3"), Ipv4Address("1.0.0.7"), 1, 1);
+
+    // adding an existing route has no effect
+    uint32_t nRoutes = routing->GetNRoutes();
+    routing->AddHostRouteTo(Ipv4Address("10.1.2.3"), Ipv4Address("1.0.0.7"), 1, 1);
+    NS_TEST_EXPECT_MSG_EQ(routing->GetNRoutes(), nRoutes, "Duplicate route added");
+
+    NS_TEST_EXPECT_MSG_EQ(GetGateway(routing, "10.1.2.3"),
+                          Ipv4Address("1.0.0.6"),
+                          "The first host route should be selected");
+    NS_TEST_EXPECT_MSG_EQ(GetGateway(routing, "10.1.9.9"),
+                          Ipv4Address("1.0.0.5"),
+                          "The last /16 route with the lowest metric should be selected");
+    NS_TEST_EXPECT_MSG_EQ(GetGateway(routing, "10.2.0.1"),
+                          Ipv4Address("1.0.0.2"),
+                          "The /8 route should be selected");
+    NS_TEST_EXPECT_MSG_EQ(GetGateway(routing, "192.0.2.1"),
+                          Ipv4Address("1.0.0.8"),
+                          "The default route should be selected");
+    NS_TEST_EXPECT_MSG_EQ(GetGateway(routing, "1.0.0.9"),
+                          Ipv4Address("0.0.0.0"),
+                          "The route to the directly connected network should be selected");
+    NS_TEST_EXPECT_MSG_EQ(routing->GetDefaultRoute().GetGateway(),
+                          Ipv4Address("1.0.0.8"),
+                          "Wrong default route");
+
+    // remove the selected routes, one at a time
+    for (uint32_t i = 0; i < routing->GetNRoutes(); i++)
+    {
+        Ipv4RoutingTableEntry route = routing->GetRoute(i);
+        if (route.GetGateway() == Ipv4Address("1.0.0.5") ||
+            route.GetGateway() == Ipv4Address("1.0.0.6"))
+        {
+            routing->RemoveRoute(i--);
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ(GetGateway(routing, "10.1.2.3"),
+                          Ipv4Address("1.0.0.7"),
+                          "The remaining host route should be selected");
+    NS_TEST_EXPECT_MSG_EQ(GetGateway(routing, "10.1.9.9"),
+                          Ipv4Address("1.0.0.4"),
+                          "The remaining /16 route with the lowest metric should be selected");
+
+    // the default multicast route is used for the multicast destinations,
+    // until it is removed
+    routing->SetDefaultMulticastRoute(1);
+    NS_TEST_EXPECT_MSG_EQ(GetGateway(routing, "225.1.2.3"),
+                          Ipv4Address("0.0.0.0"),
+                          "The default multicast route should be selected");
+    for (uint32_t i = 0; i < routing->GetNRoutes(); i++)
+    {
+        if (routing->GetRoute(i).GetDestNetwork() == Ipv4Address("224.0.0.0"))
+        {
+            routing->RemoveRoute(i--);
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ(GetGateway(routing, "225.1.2.3"),
+                          Ipv4Address("1.0.0.8"),
+                          "The default route should be selected once the multicast one is removed");
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -222,6 +367,7 @@ Ipv4StaticRoutingTestSuite::Ipv4StaticRoutingTestSuite()
     : TestSuite("ipv4-static-routing", UNIT)
 {
     AddTestCase(new Ipv4StaticRoutingSlash32TestCase, TestCase::QUICK);
+    AddTestCase(new Ipv4StaticRoutingLookupTestCase, TestCase::QUICK);
 }
 
 static Ipv4StaticRoutingTestSuite
@@ -16,9 +16,13 @@
  *
  */
 
+#include "ns3/boolean.h"
+#include "ns3/internet-stack-helper.h"
 #include "ns3/ipv6-list-routing.h"
 #include "ns3/ipv6-route.h"
 #include "ns3/ipv6-routing-protocol.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
 #include "ns3/test.h"
 
 namespace ns3
@@ -156,6 +160,209 @@ class Ipv6BRouting : public Ipv6RoutingProtocol
     void PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Time::Unit unit) const override{};
 };
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv6 dummy routing class whose routes can be cached, counting the lookups.
+ */
+class Ipv6CachedRouting : public Ipv6ARouting
+{
+  public:
+    Ptr<Ipv6Route> RouteOutput(Ptr<Packet> p,
+                               const Ipv6Header& header,
+                               Ptr<NetDevice> oif,
+                               Socket::SocketErrno& sockerr) override
+    {
+        m_lookups++;
+        Ptr<Ipv6Route> route = Create<Ipv6Route>();
+        route->SetDestination(header.GetDestination());
+        sockerr = Socket::ERROR_NOTERROR;
+        return route;
+    }
+
+    bool RouteInput(Ptr<const Packet> p,
+                    const Ipv6Header& header,
+                    Ptr<const NetDevice> idev,
+                    const UnicastForwardCallback& ucb,
+                    const MulticastForwardCallback& mcb,
+                    const LocalDeliverCallback& lcb,
+                    const ErrorCallback& ecb) override
+    {
+        m_lookups++;
+        Ptr<Ipv6Route> route = Create<Ipv6Route>();
+        route->SetDestination(header.GetDestination());
+        ucb(idev, route, p, header);
+        return true;
+    }
+
+    uint64_t GetRoutesGeneration() const override
+    {
+        return m_generation;
+    }
+
+    uint32_t m_lookups{0};    //!< Number of lookups
+    uint64_t m_generation{1}; //!< Generation of the routes
+};
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv6 ListRouting route cache test.
+ */
+class Ipv6ListRoutingCacheTestCase : public TestCase
+{
+  public:
+    Ipv6ListRoutingCacheTestCase();
+    void DoRun() override;
+};
+
+Ipv6ListRoutingCacheTestCase::Ipv6ListRoutingCacheTestCase()
+    : TestCase("Check the route cache")
+{
+}
+
+void
+Ipv6ListRoutingCacheTestCase::DoRun()
+{
+    Ptr<Ipv6ListRouting> lr = CreateObject<Ipv6ListRouting>();
+    lr->SetAttribute("RouteCache", BooleanValue(true));
+    Ptr<Ipv6CachedRouting> cRouting = CreateObject<Ipv6CachedRouting>();
+    lr->AddRoutingProtocol(cRouting, 0);
+
+    Ipv6Header header;
+    header.SetDestination(Ipv6Address("2001:db8::1"));
+    Socket::SocketErrno sockerr;
+    Ptr<Ipv6Route> route = lr->RouteOutput(Create<Packet>(), header, nullptr, sockerr);
+    NS_TEST_ASSERT_MSG_EQ(lr->RouteOutput(Create<Packet>(), header, nullptr, sockerr),
+                          route,
+                          "The cached route should be returned");
+    NS_TEST_ASSERT_MSG_EQ(cRouting->m_lookups, 1, "The route should be looked up once");
+
+    header.SetDestination(Ipv6Address("2001:db8::2"));
+    lr->RouteOutput(Create<Packet>(), header, nullptr, sockerr);
+    NS_TEST_ASSERT_MSG_EQ(cRouting->m_lookups, 2, "Other destinations are looked up");
+
+    // a change of the routes flushes the cache
+    cRouting->m_generation++;
+    lr->RouteOutput(Create<Packet>(), header, nullptr, sockerr);
+    NS_TEST_ASSERT_MSG_EQ(cRouting->m_lookups, 3, "The route should be looked up again");
+
+    // the routes of the other protocols can not be cached
+    lr->AddRoutingProtocol(CreateObject<Ipv6ARouting>(), 10);
+    lr->RouteOutput(Create<Packet>(), header, nullptr, sockerr);
+    lr->RouteOutput(Create<Packet>(), header, nullptr, sockerr);
+    NS_TEST_ASSERT_MSG_EQ(cRouting->m_lookups, 5, "The routes should not be cached");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv6 ListRouting forward route cache test.
+ */
+class Ipv6ListRoutingForwardCacheTestCase : public TestCase
+{
+  public:
+    Ipv6ListRoutingForwardCacheTestCase();
+    void DoRun() override;
+
+  private:
+    /**
+     * Count a forwarded packet.
+     * \param idev the input device
+     * \param route the route
+     * \param p the packet
+     * \param header the IPv6 header
+     */
+    void Forward(Ptr<const NetDevice> idev,
+                 Ptr<Ipv6Route> route,
+                 Ptr<const Packet> p,
+                 const Ipv6Header& header);
+    /**
+     * Count a packet not forwarded.
+     * \param p the packet
+     * \param header the IPv6 header
+     * \param sockerr the error
+     */
+    void Error(Ptr<const Packet> p, const Ipv6Header& header, Socket::SocketErrno sockerr);
+
+    uint32_t m_forwarded{0}; //!< Number of packets forwarded
+    uint32_t m_errors{0};    //!< Number of packets not forwarded
+};
+
+Ipv6ListRoutingForwardCacheTestCase::Ipv6ListRoutingForwardCacheTestCase()
+    : TestCase("Check the forward route cache")
+{
+}
+
+void
+Ipv6ListRoutingForwardCacheTestCase::Forward(Ptr<const NetDevice> idev,
+                                             Ptr<Ipv6Route> route,
+                                             Ptr<const Packet> p,
+                                             const Ipv6Header& header)
+{
+    m_forwarded++;
+}
+
+void
+Ipv6ListRoutingForwardCacheTestCase::Error(Ptr<const Packet> p,
+                                           const Ipv6Header& header,
+                                           Socket::SocketErrno sockerr)
+{
+    m_errors++;
+}
+
+void
+Ipv6ListRoutingForwardCacheTestCase::DoRun()
+{
+    Ptr<Node> node = CreateObject<Node>();
+    InternetStackHelper internet;
+    internet.SetIpv4StackInstall(false);
+    internet.Install(node);
+    Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice>();
+    device->SetAddress(Mac48Address::Allocate());
+    node->AddDevice(device);
+    Ptr<Ipv6> ipv6 = node->GetObject<Ipv6>();
+    uint32_t iif = ipv6->AddInterface(device);
+    ipv6->AddAddress(iif, Ipv6InterfaceAddress("2001:db8:1::1", Ipv6Prefix(64)));
+    ipv6->SetUp(iif);
+    ipv6->SetForwarding(iif, true);
+
+    Ptr<Ipv6ListRouting> lr = CreateObject<Ipv6ListRouting>();
+    lr->SetAttribute("RouteCache", BooleanValue(true));
+    Ptr<Ipv6CachedRouting> cRouting = CreateObject<Ipv6CachedRouting>();
+    lr->AddRoutingProtocol(cRouting, 0);
+    lr->SetIpv6(ipv6);
+
+    Ipv6Header header;
+    header.SetDestination(Ipv6Address("2001:db8::1"));
+    auto routeInput = [&]() {
+        lr->RouteInput(Create<Packet>(),
+                       header,
+                       device,
+                       MakeCallback(&Ipv6ListRoutingForwardCacheTestCase::Forward, this),
+                       Ipv6RoutingProtocol::MulticastForwardCallback(),
+                       Ipv6RoutingProtocol::LocalDeliverCallback(),
+                       MakeCallback(&Ipv6ListRoutingForwardCacheTestCase::Error, this));
+    };
+    routeInput();
+    routeInput();
+    NS_TEST_ASSERT_MSG_EQ(m_forwarded, 2, "The packets should be forwarded");
+    NS_TEST_ASSERT_MSG_EQ(cRouting->m_lookups, 1, "The route should be looked up once");
+
+    // the cached routes are not used on an interface which does not forward
+    ipv6->SetForwarding(iif, false);
+    routeInput();
+    NS_TEST_ASSERT_MSG_EQ(m_forwarded, 2, "The packet should not be forwarded");
+    NS_TEST_ASSERT_MSG_EQ(m_errors, 1, "The packet should be dropped");
+
+    ipv6->SetForwarding(iif, true);
+    routeInput();
+    NS_TEST_ASSERT_MSG_EQ(m_forwarded, 3, "The packet should be forwarded again");
+    NS_TEST_ASSERT_MSG_EQ(cRouting->m_lookups, 1, "The cached route should be used");
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -242,6 +449,8 @@ class Ipv6ListRoutingTestSuite : public TestSuite
     {
         AddTestCase(new Ipv6ListRoutingPositiveTestCase(), TestCase::QUICK);
         AddTestCase(new Ipv6ListRoutingNegativeTestCase(), TestCase::QUICK);
+        AddTestCase(new Ipv6ListRoutingCacheTestCase(), TestCase::QUICK);
+        AddTestCase(new Ipv6ListRoutingForwardCacheTestCase(), TestCase::QUICK);
     }
 };
 
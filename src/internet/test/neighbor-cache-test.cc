@@ -17,16 +17,19 @@
  * Author: Zhiheng Dong <dzh2077@gmail.com>
  */
 
+#include "ns3/arp-cache.h"
 #include "ns3/icmpv4-l4-protocol.h"
 #include "ns3/icmpv6-l4-protocol.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-header.h"
 #include "ns3/ipv4-l3-protocol.h"
 #include "ns3/ipv4-routing-helper.h"
 #include "ns3/ipv6-address-helper.h"
 #include "ns3/ipv6-l3-protocol.h"
 #include "ns3/ipv6-routing-helper.h"
 #include "ns3/neighbor-cache-helper.h"
+#include "ns3/node.h"
 #include "ns3/simple-channel.h"
 #include "ns3/simple-net-device-helper.h"
 #include "ns3/simple-net-device.h"
@@ -1221,6 +1224,133 @@ DynamicPartialTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief ArpCache wait reply and lookup test.
+ *
+ * Check that the ARP requests are retransmitted for the entries waiting for a
+ * reply only, in address order, that the entries are marked as dead after the
+ * maximum number of retries, and that the lookups and removals find the
+ * right entries.
+ */
+class ArpCacheTest : public TestCase
+{
+  public:
+    ArpCacheTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Record an ARP request sent by the cache.
+     * \param cache the ARP cache
+     * \param address the address to resolve
+     */
+    void ArpRequest(Ptr<const ArpCache> cache, Ipv4Address address);
+
+    /**
+     * \brief Count a packet dropped by the cache.
+     * \param packet the dropped packet
+     */
+    void Drop(Ptr<const Packet> packet);
+
+    std::vector<Ipv4Address> m_requests; //!< Addresses of the ARP requests
+    uint32_t m_drops{0};                 //!< Number of dropped packets
+};
+
+ArpCacheTest::ArpCacheTest()
+    : TestCase("The ArpCache retransmits the requests and finds the entries")
+{
+}
+
+void
+ArpCacheTest::ArpRequest(Ptr<const ArpCache> cache, Ipv4Address address)
+{
+    m_requests.push_back(address);
+}
+
+void
+ArpCacheTest::Drop(Ptr<const Packet> packet)
+{
+    m_drops++;
+}
+
+void
+ArpCacheTest::DoRun()
+{
+    Ptr<Node> node = CreateObject<Node>();
+    Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice>();
+    node->AddDevice(device);
+
+    Ptr<ArpCache> cache = CreateObject<ArpCache>();
+    cache->SetDevice(device, nullptr);
+    cache->SetWaitReplyTimeout(Seconds(1));
+    cache->SetAttribute("MaxRetries", UintegerValue(3));
+    cache->SetArpRequestCallback(MakeCallback(&ArpCacheTest::ArpRequest, this));
+    cache->TraceConnectWithoutContext("Drop", MakeCallback(&ArpCacheTest::Drop, this));
+
+    Address mac = Mac48Address("00:00:00:00:00:01");
+    std::vector<Ipv4Address> addresses{Ipv4Address("10.0.0.3"),
+                                       Ipv4Address("10.0.0.1"),
+                                       Ipv4Address("10.0.0.2")};
+    for (const auto& address : addresses)
+    {
+        cache->Add(address)->MarkWaitReply(std::make_pair(Create<Packet>(10), Ipv4Header()));
+    }
+    // 10.0.0.2 replies before the first retransmission
+    Simulator::Schedule(MilliSeconds(500),
+                        &ArpCache::Entry::MarkAlive,
+                        cache->Lookup(Ipv4Address("10.0.0.2")),
+                        mac);
+    Simulator::Run();
+
+    std::vector<Ipv4Address> expected;
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        expected.emplace_back("10.0.0.1");
+        expected.emplace_back("10.0.0.3");
+    }
+    NS_TEST_EXPECT_MSG_EQ((m_requests == expected),
+                          true,
+                          "The requests should be retransmitted in address order");
+    NS_TEST_EXPECT_MSG_EQ(m_drops, 2, "The pending packets of the dead entries should be dropped");
+    NS_TEST_EXPECT_MSG_EQ(cache->Lookup(Ipv4Address("10.0.0.1"))->IsDead(),
+                          true,
+                          "The entry should be dead after the maximum number of retries");
+    NS_TEST_EXPECT_MSG_EQ(cache->Lookup(Ipv4Address("10.0.0.2"))->IsAlive(),
+                          true,
+                          "The entry should be alive");
+
+    for (const auto& address : {Ipv4Address("10.0.0.9"), Ipv4Address("10.0.0.5")})
+    {
+        ArpCache::Entry* entry = cache->Add(address);
+        entry->SetMacAddress(mac);
+        entry->MarkPermanent();
+    }
+    std::list<ArpCache::Entry*> entries = cache->LookupInverse(mac);
+    std::vector<Ipv4Address> found;
+    for (const auto entry : entries)
+    {
+        found.push_back(entry->GetIpv4Address());
+    }
+    expected = {Ipv4Address("10.0.0.2"), Ipv4Address("10.0.0.5"), Ipv4Address("10.0.0.9")};
+    NS_TEST_EXPECT_MSG_EQ((found == expected),
+                          true,
+                          "The inverse lookup should return the entries in address order");
+
+    cache->Remove(cache->Lookup(Ipv4Address("10.0.0.5")));
+    NS_TEST_EXPECT_MSG_EQ(cache->Lookup(Ipv4Address("10.0.0.5")),
+                          nullptr,
+                          "The removed entry should not be found");
+    NS_TEST_EXPECT_MSG_NE(cache->Lookup(Ipv4Address("10.0.0.9")),
+                          nullptr,
+                          "The other entries should still be found");
+
+    cache->Flush();
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -1239,6 +1369,7 @@ class NeighborCacheTestSuite : public TestSuite
         AddTestCase(new FlushTest, TestCase::QUICK);
         AddTestCase(new DuplicateTest, TestCase::QUICK);
         AddTestCase(new DynamicPartialTest, TestCase::QUICK);
+        AddTestCase(new ArpCacheTest, TestCase::QUICK);
     }
 };
 
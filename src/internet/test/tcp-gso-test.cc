@@ -0,0 +1,503 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/boolean.h"
+#include "ns3/data-rate.h"
+#include "ns3/error-model.h"
+#include "ns3/flow-id-tag.h"
+#include "ns3/global-value.h"
+#include "ns3/gso-tag.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv6-address-helper.h"
+#include "ns3/ipv6-header.h"
+#include "ns3/ipv6-l3-protocol.h"
+#include "ns3/ipv6-route.h"
+#include "ns3/log.h"
+#include "ns3/node-container.h"
+#include "ns3/pointer.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/test.h"
+#include "ns3/traffic-control-helper.h"
+#include "ns3/uinteger.h"
+
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("TcpGsoTest");
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check that the TCP segmentation offload emulation does not change
+ * the packets on the wire.
+ *
+ * A bulk transfer over a lossy link is run twice, without and with the
+ * segmentation offload emulation. The TCP packets received by the IP layer of
+ * both nodes, with their IP header and checksums, their packet tags and their
+ * reception times must be the same in both runs, and the super-segments must
+ * have been used in the second run. The application tags the data it sends,
+ * with a tag that changes every 8 segments, so that the segments of a burst
+ * carry different tags. The MTU of the link is either larger than the
+ * segments, which are split from the super-segments by the device queue
+ * interface after the traffic control layer, or smaller, and the segments are
+ * fragmented by the IP layer. The devices have a queue disc or none. The
+ * packets seen by the "Tx" trace of the IP layer of the sender must be
+ * segments, not super-segments.
+ */
+class TcpGsoTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param useIpv6 use IPv6 instead of IPv4
+     * \param mtu the MTU of the link
+     * \param queueDisc install a queue disc on the devices
+     */
+    TcpGsoTestCase(bool useIpv6, uint16_t mtu, bool queueDisc);
+
+  private:
+    void DoRun() override;
+
+    /// A packet received by the IP layer
+    struct WirePacket
+    {
+        Time time;                  //!< the reception time
+        uint32_t node;              //!< the receiving node
+        std::vector<uint8_t> bytes; //!< the packet, with its IP header
+        std::string tags;           //!< the packet tags
+    };
+
+    /**
+     * \brief Run the bulk transfer
+     * \param gsoMaxSize the GsoMaxSize attribute of the sender
+     * \return the TCP packets received by the IP layer of the nodes
+     */
+    std::vector<WirePacket> RunTransfer(uint32_t gsoMaxSize);
+
+    /**
+     * \brief Record a packet received by the IPv4 layer
+     * \param node the receiving node
+     * \param packet the packet
+     * \param ipv4 the IPv4 layer
+     * \param interface the interface
+     */
+    void Ipv4Rx(uint32_t node, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
+
+    /**
+     * \brief Record a packet received by the IPv6 layer
+     * \param node the receiving node
+     * \param packet the packet
+     * \param ipv6 the IPv6 layer
+     * \param interface the interface
+     */
+    void Ipv6Rx(uint32_t node, Ptr<const Packet> packet, Ptr<Ipv6> ipv6, uint32_t interface);
+
+    /**
+     * \brief Check a packet sent by the IPv4 layer
+     * \param packet the packet, with its IP header
+     * \param ipv4 the IPv4 layer
+     * \param interface the interface
+     */
+    void Ipv4Tx(Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
+
+    /**
+     * \brief Check a packet sent by the IPv6 layer
+     * \param packet the packet, with its IP header
+     * \param ipv6 the IPv6 layer
+     * \param interface the interface
+     */
+    void Ipv6Tx(Ptr<const Packet> packet, Ptr<Ipv6> ipv6, uint32_t interface);
+
+    /**
+     * \brief Count the super-segments sent by TCP over IPv4, and send them
+     * \param packet the packet
+     * \param source the source address
+     * \param destination the destination address
+     * \param protocol the protocol number
+     * \param route the route
+     */
+    void Ipv4Down(Ptr<Packet> packet,
+                  Ipv4Address source,
+                  Ipv4Address destination,
+                  uint8_t protocol,
+                  Ptr<Ipv4Route> route);
+
+    /**
+     * \brief Count the super-segments sent by TCP over IPv6, and send them
+     * \param packet the packet
+     * \param source the source address
+     * \param destination the destination address
+     * \param protocol the protocol number
+     * \param route the route
+     */
+    void Ipv6Down(Ptr<Packet> packet,
+                  Ipv6Address source,
+                  Ipv6Address destination,
+                  uint8_t protocol,
+                  Ptr<Ipv6Route> route);
+
+    /**
+     * \brief Fill the Tx buffer of the sender
+     * \param socket the sender socket
+     * \param available the space available in the Tx buffer
+     */
+    void SendData(Ptr<Socket> socket, uint32_t available);
+
+    /**
+     * \brief Accept a connection
+     * \param socket the new socket
+     * \param from the address of the peer
+     */
+    void Accept(Ptr<Socket> socket, const Address& from);
+
+    /**
+     * \brief Read the data received
+     * \param socket the receiver socket
+     */
+    void ReceiveData(Ptr<Socket> socket);
+
+    bool m_useIpv6;                            //!< use IPv6 instead of IPv4
+    uint16_t m_mtu;                            //!< the MTU of the link
+    bool m_queueDisc;                          //!< install a queue disc on the devices
+    uint32_t m_txSuperSegments{0};             //!< super-segments seen by the "Tx" trace
+    uint32_t m_totalBytes{560000};             //!< bytes to transfer
+    uint32_t m_segmentSize{1400};              //!< the segment size of the sender
+    uint32_t m_sentBytes{0};                   //!< bytes handed to the sender socket
+    uint32_t m_receivedBytes{0};               //!< bytes read from the receiver socket
+    uint32_t m_superSegments{0};               //!< super-segments sent by TCP
+    std::vector<WirePacket> m_packets;         //!< the TCP packets received
+    IpL4Protocol::DownTargetCallback m_down;   //!< the IPv4 down target of TCP
+    IpL4Protocol::DownTargetCallback6 m_down6; //!< the IPv6 down target of TCP
+};
+
+TcpGsoTestCase::TcpGsoTestCase(bool useIpv6, uint16_t mtu, bool queueDisc)
+    : TestCase(std::string("Check that the TCP segmentation offload emulation does not change "
+                           "the packets on the wire over ") +
+               (useIpv6 ? "IPv6" : "IPv4") + ", MTU " + std::to_string(mtu) +
+               (queueDisc ? ", with" : ", without") + " queue disc"),
+      m_useIpv6(useIpv6),
+      m_mtu(mtu),
+      m_queueDisc(queueDisc)
+{
+}
+
+void
+TcpGsoTestCase::Ipv4Tx(Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+    GsoTag gsoTag;
+    if (packet->PeekPacketTag(gsoTag) || packet->GetSize() > m_mtu)
+    {
+        m_txSuperSegments++;
+    }
+}
+
+void
+TcpGsoTestCase::Ipv6Tx(Ptr<const Packet> packet, Ptr<Ipv6> ipv6, uint32_t interface)
+{
+    GsoTag gsoTag;
+    if (packet->PeekPacketTag(gsoTag) || packet->GetSize() > m_mtu)
+    {
+        m_txSuperSegments++;
+    }
+}
+
+void
+TcpGsoTestCase::Ipv4Rx(uint32_t node, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+    Ipv4Header header;
+    packet->PeekHeader(header);
+    if (header.GetProtocol() == TcpL4Protocol::PROT_NUMBER)
+    {
+        std::vector<uint8_t> bytes(packet->GetSize());
+        packet->CopyData(bytes.data(), bytes.size());
+        std::ostringstream tags;
+        packet->PrintPacketTags(tags);
+        m_packets.push_back({Simulator::Now(), node, bytes, tags.str()});
+    }
+}
+
+void
+TcpGsoTestCase::Ipv6Rx(uint32_t node, Ptr<const Packet> packet, Ptr<Ipv6> ipv6, uint32_t interface)
+{
+    Ipv6Header header;
+    packet->PeekHeader(header);
+    if (header.GetNextHeader() == TcpL4Protocol::PROT_NUMBER)
+    {
+        std::vector<uint8_t> bytes(packet->GetSize());
+        packet->CopyData(bytes.data(), bytes.size());
+        std::ostringstream tags;
+        packet->PrintPacketTags(tags);
+        m_packets.push_back({Simulator::Now(), node, bytes, tags.str()});
+    }
+}
+
+void
+TcpGsoTestCase::Ipv4Down(Ptr<Packet> packet,
+                         Ipv4Address source,
+                         Ipv4Address destination,
+                         uint8_t protocol,
+                         Ptr<Ipv4Route> route)
+{
+    GsoTag gsoTag;
+    if (packet->PeekPacketTag(gsoTag))
+    {
+        m_superSegments++;
+    }
+    m_down(packet, source, destination, protocol, route);
+}
+
+void
+TcpGsoTestCase::Ipv6Down(Ptr<Packet> packet,
+                         Ipv6Address source,
+                         Ipv6Address destination,
+                         uint8_t protocol,
+                         Ptr<Ipv6Route> route)
+{
+    GsoTag gsoTag;
+    if (packet->PeekPacketTag(gsoTag))
+    {
+        m_superSegments++;
+    }
+    m_down6(packet, source, destination, protocol, route);
+}
+
+void
+TcpGsoTestCase::SendData(Ptr<Socket> socket, uint32_t available)
+{
+    // the data is sent in segments, tagged in groups of 8 segments
+    while (m_sentBytes < m_totalBytes && socket->GetTxAvailable() >= m_segmentSize)
+    {
+        Ptr<Packet> packet = Create<Packet>(m_segmentSize);
+        packet->AddPacketTag(FlowIdTag(m_sentBytes / (8 * m_segmentSize)));
+        int sent = socket->Send(packet);
+        if (sent <= 0)
+        {
+            break;
+        }
+        m_sentBytes += sent;
+    }
+    if (m_sentBytes == m_totalBytes)
+    {
+        socket->SetSendCallback(MakeNullCallback<void, Ptr<Socket>, uint32_t>());
+        socket->Close();
+    }
+}
+
+void
+TcpGsoTestCase::Accept(Ptr<Socket> socket, const Address& from)
+{
+    socket->SetRecvCallback(MakeCallback(&TcpGsoTestCase::ReceiveData, this));
+}
+
+void
+TcpGsoTestCase::ReceiveData(Ptr<Socket> socket)
+{
+    while (Ptr<Packet> packet = socket->Recv())
+    {
+        if (packet->GetSize() == 0)
+        {
+            break;
+        }
+        m_receivedBytes += packet->GetSize();
+    }
+}
+
+std::vector<TcpGsoTestCase::WirePacket>
+TcpGsoTestCase::RunTransfer(uint32_t gsoMaxSize)
+{
+    m_sentBytes = 0;
+    m_receivedBytes = 0;
+    m_superSegments = 0;
+    m_txSuperSegments = 0;
+    m_packets.clear();
+
+    NodeContainer nodes;
+    nodes.Create(2);
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    // the random delays of the stack (e.g., the ARP jitter) are the same in both runs
+    internet.AssignStreams(nodes, 10);
+
+    SimpleNetDeviceHelper simple;
+    simple.SetDeviceAttribute("DataRate", DataRateValue(DataRate("100Mbps")));
+    simple.SetChannelAttribute("Delay", TimeValue(MilliSeconds(10)));
+    NetDeviceContainer devices = simple.Install(nodes);
+    for (uint32_t i = 0; i < devices.GetN(); i++)
+    {
+        devices.Get(i)->SetMtu(m_mtu);
+    }
+
+    // the data segments are lost at random, in the same way in both runs
+    Ptr<RateErrorModel> errorModel = CreateObject<RateErrorModel>();
+    errorModel->SetUnit(RateErrorModel::ERROR_UNIT_PACKET);
+    errorModel->SetRate(0.01);
+    errorModel->AssignStreams(1);
+    devices.Get(1)->SetAttribute("ReceiveErrorModel", PointerValue(errorModel));
+
+    Ptr<TcpL4Protocol> tcp = nodes.Get(0)->GetObject<TcpL4Protocol>();
+    Address serverAddress;
+    if (m_useIpv6)
+    {
+        Ipv6AddressHelper ipv6;
+        ipv6.SetBase(Ipv6Address("2001:db8::"), Ipv6Prefix(64));
+        Ipv6InterfaceContainer interfaces = ipv6.Assign(devices);
+        serverAddress = Inet6SocketAddress(interfaces.GetAddress(1, 1), 50000);
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            nodes.Get(i)->GetObject<Ipv6L3Protocol>()->TraceConnectWithoutContext(
+                "Rx",
+                MakeCallback(&TcpGsoTestCase::Ipv6Rx, this).Bind(i));
+        }
+        nodes.Get(0)->GetObject<Ipv6L3Protocol>()->TraceConnectWithoutContext(
+            "Tx",
+            MakeCallback(&TcpGsoTestCase::Ipv6Tx, this));
+        m_down6 = tcp->GetDownTarget6();
+        tcp->SetDownTarget6(MakeCallback(&TcpGsoTestCase::Ipv6Down, this));
+    }
+    else
+    {
+        Ipv4AddressHelper ipv4;
+        ipv4.SetBase(Ipv4Address("10.0.0.0"), Ipv4Mask("255.255.255.0"));
+        Ipv4InterfaceContainer interfaces = ipv4.Assign(devices);
+        serverAddress = InetSocketAddress(interfaces.GetAddress(1), 50000);
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            nodes.Get(i)->GetObject<Ipv4L3Protocol>()->TraceConnectWithoutContext(
+                "Rx",
+                MakeCallback(&TcpGsoTestCase::Ipv4Rx, this).Bind(i));
+        }
+        nodes.Get(0)->GetObject<Ipv4L3Protocol>()->TraceConnectWithoutContext(
+            "Tx",
+            MakeCallback(&TcpGsoTestCase::Ipv4Tx, this));
+        m_down = tcp->GetDownTarget();
+        tcp->SetDownTarget(MakeCallback(&TcpGsoTestCase::Ipv4Down, this));
+    }
+
+    if (!m_queueDisc)
+    {
+        TrafficControlHelper().Uninstall(devices);
+    }
+
+    Ptr<Socket> server = Socket::CreateSocket(nodes.Get(1), TcpSocketFactory::GetTypeId());
+    if (m_useIpv6)
+    {
+        server->Bind(Inet6SocketAddress(Ipv6Address::GetAny(), 50000));
+    }
+    else
+    {
+        server->Bind(InetSocketAddress(Ipv4Address::GetAny(), 50000));
+    }
+    server->Listen();
+    server->SetAcceptCallback(MakeNullCallback<bool, Ptr<Socket>, const Address&>(),
+                              MakeCallback(&TcpGsoTestCase::Accept, this));
+
+    Ptr<Socket> client = Socket::CreateSocket(nodes.Get(0), TcpSocketFactory::GetTypeId());
+    client->SetAttribute("SegmentSize", UintegerValue(m_segmentSize));
+    client->SetAttribute("GsoMaxSize", UintegerValue(gsoMaxSize));
+    client->SetSendCallback(MakeCallback(&TcpGsoTestCase::SendData, this));
+    if (m_useIpv6)
+    {
+        client->Bind6();
+    }
+    else
+    {
+        client->Bind();
+    }
+    // leave time to the duplicate address detection
+    Simulator::Schedule(Seconds(3), [client, serverAddress]() { client->Connect(serverAddress); });
+
+    Simulator::Stop(Seconds(60));
+    Simulator::Run();
+    Simulator::Destroy();
+
+    NS_TEST_EXPECT_MSG_EQ(m_receivedBytes, m_totalBytes, "All the data should be received");
+    NS_TEST_EXPECT_MSG_EQ(m_txSuperSegments, 0, "The Tx trace should see the segments only");
+    if (gsoMaxSize > 0)
+    {
+        NS_TEST_EXPECT_MSG_GT(m_superSegments, 0, "Super-segments should have been sent");
+    }
+    else
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_superSegments, 0, "No super-segment should have been sent");
+    }
+    return m_packets;
+}
+
+void
+TcpGsoTestCase::DoRun()
+{
+    // the checksums of the segments are checked by the receiver
+    BooleanValue checksumEnabled;
+    GlobalValue::GetValueByName("ChecksumEnabled", checksumEnabled);
+    GlobalValue::Bind("ChecksumEnabled", BooleanValue(true));
+
+    std::vector<WirePacket> reference = RunTransfer(0);
+    std::vector<WirePacket> packets = RunTransfer(64000);
+
+    GlobalValue::Bind("ChecksumEnabled", checksumEnabled);
+
+    NS_TEST_ASSERT_MSG_EQ(packets.size(),
+                          reference.size(),
+                          "The same number of packets should be received");
+    for (std::size_t i = 0; i < packets.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(packets[i].time,
+                              reference[i].time,
+                              "Packet " << i << " should be received at the same time");
+        NS_TEST_ASSERT_MSG_EQ(packets[i].node,
+                              reference[i].node,
+                              "Packet " << i << " should be received by the same node");
+        NS_TEST_ASSERT_MSG_EQ((packets[i].bytes == reference[i].bytes),
+                              true,
+                              "Packet " << i << " should have the same content");
+        NS_TEST_ASSERT_MSG_EQ(packets[i].tags,
+                              reference[i].tags,
+                              "Packet " << i << " should have the same packet tags");
+    }
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief TCP segmentation offload emulation TestSuite
+ */
+class TcpGsoTestSuite : public TestSuite
+{
+  public:
+    TcpGsoTestSuite()
+        : TestSuite("tcp-gso", UNIT)
+    {
+        AddTestCase(new TcpGsoTestCase(false, 1500, true), TestCase::QUICK);
+        AddTestCase(new TcpGsoTestCase(true, 1500, true), TestCase::QUICK);
+        AddTestCase(new TcpGsoTestCase(false, 1280, true), TestCase::QUICK);
+        AddTestCase(new TcpGsoTestCase(true, 1280, true), TestCase::QUICK);
+        AddTestCase(new TcpGsoTestCase(false, 1500, false), TestCase::QUICK);
+        AddTestCase(new TcpGsoTestCase(true, 1500, false), TestCase::QUICK);
+    }
+};
+
+static TcpGsoTestSuite g_tcpGsoTestSuite; //!< Static variable for test initialization
@@ -21,6 +21,10 @@
 #include "ns3/core-module.h"
 #include "ns3/tcp-header.h"
 #include "ns3/tcp-option-rfc793.h"
+#include "ns3/tcp-option-sack-permitted.h"
+#include "ns3/tcp-option-sack.h"
+#include "ns3/tcp-option-ts.h"
+#include "ns3/tcp-option-winscale.h"
 #include "ns3/test.h"
 
 #include <stdint.h>
@@ -451,6 +455,190 @@ TcpHeaderFlagsToString::DoRun()
     NS_TEST_ASSERT_MSG_EQ(str, target, "str " << str << " does not equal target " << target);
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief TCP header inline options test.
+ *
+ * Check that the options appended through the typed functions are
+ * serialized as the equivalent TcpOption objects, and that the options are
+ * read back both through the typed functions and as TcpOption objects,
+ * also when they are unknown or repeated, and that a malformed SACK option
+ * is rejected.
+ */
+class TcpHeaderInlineOptionsTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param name Test description.
+     */
+    TcpHeaderInlineOptionsTestCase(std::string name);
+
+  private:
+    void DoRun() override;
+};
+
+TcpHeaderInlineOptionsTestCase::TcpHeaderInlineOptionsTestCase(std::string name)
+    : TestCase(name)
+{
+}
+
+void
+TcpHeaderInlineOptionsTestCase::DoRun()
+{
+    TcpOptionSack::SackList sackList;
+    sackList.emplace_back(SequenceNumber32(1000), SequenceNumber32(2000));
+    sackList.emplace_back(SequenceNumber32(3000), SequenceNumber32(4000));
+
+    TcpHeader inlineHeader;
+    inlineHeader.AppendOption(CreateObject<TcpOptionNOP>());
+    inlineHeader.AppendWindowScaleOption(7);
+    inlineHeader.AppendSackPermittedOption();
+    inlineHeader.AppendTimestampOption(100, 200);
+    inlineHeader.AppendSackOption(sackList);
+    NS_TEST_ASSERT_MSG_EQ(inlineHeader.AppendTimestampOption(300, 400),
+                          false,
+                          "The timestamp option has been appended twice");
+    NS_TEST_ASSERT_MSG_EQ(inlineHeader.AppendSackOption(sackList),
+                          false,
+                          "The SACK option has been appended twice");
+
+    TcpHeader objectHeader;
+    objectHeader.AppendOption(CreateObject<TcpOptionNOP>());
+    Ptr<TcpOptionWinScale> ws = CreateObject<TcpOptionWinScale>();
+    ws->SetScale(7);
+    objectHeader.AppendOption(ws);
+    objectHeader.AppendOption(CreateObject<TcpOptionSackPermitted>());
+    Ptr<TcpOptionTS> ts = CreateObject<TcpOptionTS>();
+    ts->SetTimestamp(100);
+    ts->SetEcho(200);
+    objectHeader.AppendOption(ts);
+    Ptr<TcpOptionSack> sack = CreateObject<TcpOptionSack>();
+    for (const auto& block : sackList)
+    {
+        sack->AddSackBlock(block);
+    }
+    objectHeader.AppendOption(sack);
+
+    NS_TEST_ASSERT_MSG_EQ(inlineHeader.GetSerializedSize(), 56, "Wrong header size");
+    NS_TEST_ASSERT_MSG_EQ(inlineHeader.GetOptionLength(), 34, "Wrong option length");
+    NS_TEST_ASSERT_MSG_EQ(objectHeader.GetSerializedSize(),
+                          inlineHeader.GetSerializedSize(),
+                          "The headers have different sizes");
+
+    Buffer inlineBuffer;
+    inlineBuffer.AddAtStart(inlineHeader.GetSerializedSize());
+    inlineHeader.Serialize(inlineBuffer.Begin());
+    Buffer objectBuffer;
+    objectBuffer.AddAtStart(objectHeader.GetSerializedSize());
+    objectHeader.Serialize(objectBuffer.Begin());
+    Buffer::Iterator i = inlineBuffer.Begin();
+    Buffer::Iterator j = objectBuffer.Begin();
+    for (uint32_t k = 0; k < inlineBuffer.GetSize(); ++k)
+    {
+        NS_TEST_ASSERT_MSG_EQ(static_cast<uint32_t>(i.ReadU8()),
+                              static_cast<uint32_t>(j.ReadU8()),
+                              "The headers differ at byte " << k);
+    }
+
+    TcpHeader header;
+    header.Deserialize(inlineBuffer.Begin());
+    uint8_t scale = 0;
+    uint32_t timestamp = 0;
+    uint32_t echo = 0;
+    TcpOptionSack::SackList readSackList;
+    NS_TEST_ASSERT_MSG_EQ(header.GetWindowScaleOption(scale), true, "Window scale not found");
+    NS_TEST_ASSERT_MSG_EQ(static_cast<uint32_t>(scale), 7, "Wrong window scale");
+    NS_TEST_ASSERT_MSG_EQ(header.HasOption(TcpOption::SACKPERMITTED),
+                          true,
+                          "SACK-permitted not found");
+    NS_TEST_ASSERT_MSG_EQ(header.GetTimestampOption(timestamp, echo), true, "Timestamp not found");
+    NS_TEST_ASSERT_MSG_EQ(timestamp, 100, "Wrong timestamp");
+    NS_TEST_ASSERT_MSG_EQ(echo, 200, "Wrong timestamp echo");
+    NS_TEST_ASSERT_MSG_EQ(header.GetSackOption(readSackList), true, "SACK not found");
+    NS_TEST_ASSERT_MSG_EQ((readSackList == sackList), true, "Wrong SACK blocks");
+    NS_TEST_ASSERT_MSG_EQ(header.HasOption(TcpOption::MSS), false, "Unexpected MSS option");
+
+    Ptr<const TcpOptionTS> readTs = DynamicCast<const TcpOptionTS>(header.GetOption(TcpOption::TS));
+    NS_TEST_ASSERT_MSG_NE(readTs, nullptr, "Timestamp object not found");
+    NS_TEST_ASSERT_MSG_EQ(readTs->GetTimestamp(), 100, "Wrong timestamp object");
+
+    // the header was padded with an END option
+    const uint8_t kinds[] = {TcpOption::NOP,
+                             TcpOption::WINSCALE,
+                             TcpOption::SACKPERMITTED,
+                             TcpOption::TS,
+                             TcpOption::SACK,
+                             TcpOption::END};
+    const TcpHeader::TcpOptionList& options = header.GetOptionList();
+    NS_TEST_ASSERT_MSG_EQ(options.size(), 6, "Wrong number of options");
+    uint32_t k = 0;
+    for (const auto& option : options)
+    {
+        NS_TEST_ASSERT_MSG_EQ(static_cast<uint32_t>(option->GetKind()),
+                              static_cast<uint32_t>(kinds[k]),
+                              "Wrong option at position " << k);
+        ++k;
+    }
+
+    // a repeated option is kept as an object, after the inline one
+    TcpHeader repeatedHeader;
+    repeatedHeader.AppendTimestampOption(100, 200);
+    ts->SetTimestamp(300);
+    repeatedHeader.AppendOption(ts);
+    Buffer repeatedBuffer;
+    repeatedBuffer.AddAtStart(repeatedHeader.GetSerializedSize());
+    repeatedHeader.Serialize(repeatedBuffer.Begin());
+    header.Deserialize(repeatedBuffer.Begin());
+    NS_TEST_ASSERT_MSG_EQ(header.GetOptionList().size(), 2, "Wrong number of options");
+    NS_TEST_ASSERT_MSG_EQ(header.GetTimestampOption(timestamp, echo), true, "Timestamp not found");
+    NS_TEST_ASSERT_MSG_EQ(timestamp, 100, "The first timestamp option should be returned");
+    readTs = DynamicCast<const TcpOptionTS>(header.GetOptionList().back());
+    NS_TEST_ASSERT_MSG_EQ(readTs->GetTimestamp(), 300, "Wrong repeated timestamp");
+    NS_TEST_ASSERT_MSG_EQ(header.GetSerializedSize(),
+                          repeatedBuffer.GetSize(),
+                          "Wrong size of the header with the repeated option");
+
+    // an unknown option is kept as an object
+    TcpHeader unknownHeader;
+    unknownHeader.AppendTimestampOption(100, 200);
+    for (uint32_t n = 0; n < 6; ++n)
+    {
+        unknownHeader.AppendOption(CreateObject<TcpOptionNOP>());
+    }
+    Buffer unknownBuffer;
+    unknownBuffer.AddAtStart(unknownHeader.GetSerializedSize());
+    unknownHeader.Serialize(unknownBuffer.Begin());
+    i = unknownBuffer.Begin();
+    i.Next(30);
+    i.WriteU8(30);
+    i.WriteU8(4);
+    header.Deserialize(unknownBuffer.Begin());
+    NS_TEST_ASSERT_MSG_EQ(header.HasOption(30), true, "Unknown option not found");
+    NS_TEST_ASSERT_MSG_EQ(header.GetOption(30)->GetSerializedSize(), 4, "Wrong unknown option");
+    NS_TEST_ASSERT_MSG_EQ(header.GetOptionList().size(), 4, "Wrong number of options");
+    NS_TEST_ASSERT_MSG_EQ(header.GetTimestampOption(timestamp, echo), true, "Timestamp not found");
+
+    // a SACK option whose length is not a whole number of blocks is rejected,
+    // its blocks are not read as options
+    TcpHeader malformedHeader;
+    malformedHeader.AppendSackOption({sackList.front()});
+    malformedHeader.AppendTimestampOption(100, 200);
+    Buffer malformedBuffer;
+    malformedBuffer.AddAtStart(malformedHeader.GetSerializedSize());
+    malformedHeader.Serialize(malformedBuffer.Begin());
+    i = malformedBuffer.Begin();
+    i.Next(21);
+    i.WriteU8(9);
+    header.Deserialize(malformedBuffer.Begin());
+    NS_TEST_ASSERT_MSG_EQ(header.HasOption(TcpOption::SACK), false, "Malformed SACK accepted");
+    NS_TEST_ASSERT_MSG_EQ(header.GetSackOption(readSackList), false, "Malformed SACK read");
+    NS_TEST_ASSERT_MSG_EQ(header.GetOptionList().size(),
+                          0,
+                          "Options read after the malformed SACK option");
+}
+
 /**
  * \ingroup internet-test
  *
@@ -466,6 +654,8 @@ class TcpHeaderTestSuite : public TestSuite
         AddTestCase(new TcpHeaderWithRFC793OptionTestCase("Test for options in RFC 793"),
                     TestCase::QUICK);
         AddTestCase(new TcpHeaderFlagsToString("Test flags to string function"), TestCase::QUICK);
+        AddTestCase(new TcpHeaderInlineOptionsTestCase("Test for options kept inline"),
+                    TestCase::QUICK);
     }
 };
 
@@ -14,11 +14,14 @@
  *
  */
 
+#include "ns3/flow-id-tag.h"
 #include "ns3/log.h"
 #include "ns3/packet.h"
 #include "ns3/tcp-rx-buffer.h"
 #include "ns3/test.h"
 
+#include <vector>
+
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("TcpRxBufferTestSuite");
@@ -42,6 +45,11 @@ class TcpRxBufferTestCase : public TestCase
      * \brief Test the SACK list update.
      */
     void TestUpdateSACKList();
+
+    /**
+     * \brief Test the reassembly of overlapping and out-of-order segments.
+     */
+    void TestReassembly();
 };
 
 TcpRxBufferTestCase::TcpRxBufferTestCase()
@@ -53,6 +61,7 @@ void
 TcpRxBufferTestCase::DoRun()
 {
     TestUpdateSACKList();
+    TestReassembly();
 }
 
 void
@@ -289,6 +298,89 @@ TcpRxBufferTestCase::TestUpdateSACKList()
     NS_TEST_ASSERT_MSG_EQ(sackList.size(), 0, "SACK list should contain no element");
 }
 
+void
+TcpRxBufferTestCase::TestReassembly()
+{
+    TcpRxBuffer rxBuf;
+    TcpHeader h;
+    rxBuf.SetMaxBufferSize(10000);
+    rxBuf.SetNextRxSequence(SequenceNumber32(1));
+
+    // the content of the byte with sequence number seq is (seq % 256)
+    auto createSegment = [&h](uint32_t seq, uint32_t size) {
+        std::vector<uint8_t> data(size);
+        for (uint32_t i = 0; i < size; i++)
+        {
+            data[i] = static_cast<uint8_t>(seq + i);
+        }
+        h.SetSequenceNumber(SequenceNumber32(seq));
+        return Create<Packet>(data.data(), size);
+    };
+
+    // segments received in reverse order, then some duplicates overlapping
+    // the buffered ranges. The segments are kept, as a trace sink would do,
+    // with a packet tag
+    std::vector<Ptr<Packet>> added;
+    for (uint32_t seq = 901; seq > 100; seq -= 100)
+    {
+        Ptr<Packet> segment = createSegment(seq, 100);
+        segment->AddPacketTag(FlowIdTag(seq));
+        rxBuf.Add(segment, h);
+        added.push_back(segment);
+    }
+    rxBuf.Add(createSegment(151, 200), h);
+    rxBuf.Add(createSegment(951, 150), h);
+
+    // the buffered ranges were coalesced without modifying the segments
+    for (uint32_t i = 0; i < added.size(); i++)
+    {
+        FlowIdTag tag;
+        NS_TEST_ASSERT_MSG_EQ(added[i]->GetSize(), 100, "Segment " << i << " was modified");
+        NS_TEST_ASSERT_MSG_EQ(added[i]->PeekPacketTag(tag),
+                              true,
+                              "Segment " << i << " lost its tag");
+        NS_TEST_ASSERT_MSG_EQ(tag.GetFlowId(), 901 - 100 * i, "Wrong tag of segment " << i);
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.NextRxSequence(),
+                          SequenceNumber32(1),
+                          "Sequence number differs from expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(), 1000, "Wrong amount of buffered data");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Available(), 0, "No data should be available");
+    TcpOptionSack::SackList sackList = rxBuf.GetSackList();
+    NS_TEST_ASSERT_MSG_EQ(sackList.size(), 1, "SACK list should contain one element");
+    NS_TEST_ASSERT_MSG_EQ(sackList.front().first,
+                          SequenceNumber32(101),
+                          "SACK block different than expected");
+    NS_TEST_ASSERT_MSG_EQ(sackList.front().second,
+                          SequenceNumber32(1101),
+                          "SACK block different than expected");
+
+    // the missing segment is received, everything becomes available
+    rxBuf.Add(createSegment(1, 100), h);
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.NextRxSequence(),
+                          SequenceNumber32(1101),
+                          "Sequence number differs from expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Available(), 1100, "All the data should be available");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.GetSackListSize(), 0, "SACK list should be empty");
+
+    std::vector<uint8_t> data(1100);
+    Ptr<Packet> p = rxBuf.Extract(250);
+    NS_TEST_ASSERT_MSG_EQ(p->GetSize(), 250, "Wrong size of the extracted data");
+    p->CopyData(data.data(), 250);
+    p = rxBuf.Extract(2000);
+    NS_TEST_ASSERT_MSG_EQ(p->GetSize(), 850, "Wrong size of the extracted data");
+    p->CopyData(data.data() + 250, 850);
+    for (uint32_t i = 0; i < data.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(static_cast<uint32_t>(data[i]),
+                              static_cast<uint32_t>(static_cast<uint8_t>(i + 1)),
+                              "Wrong content of byte " << i + 1);
+    }
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(), 0, "The buffer should be empty");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Extract(100), nullptr, "No data should be extracted");
+}
+
 void
 TcpRxBufferTestCase::DoTeardown()
 {
@@ -16,11 +16,14 @@
 
 #include "ns3/log.h"
 #include "ns3/packet.h"
+#include "ns3/random-variable-stream.h"
 #include "ns3/simulator.h"
 #include "ns3/tcp-tx-buffer.h"
 #include "ns3/test.h"
 
+#include <algorithm>
 #include <limits>
+#include <string>
 
 using namespace ns3;
 
@@ -430,6 +433,194 @@ TcpTxBufferTestCase::DoTeardown()
 {
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check NextSeg against a walk of the whole sent list
+ *
+ * Random sequences of transmissions, SACKs, cumulative ACKs, retransmission
+ * timeouts and changes of the flags of the head are applied to a buffer. After each
+ * of them, NextSeg, which only scans the items between the marks of the lost
+ * items, must return the segment found by a walk of the whole sent list.
+ */
+class TcpTxBufferNextSegTestCase : public TestCase
+{
+  public:
+    /** \brief Constructor */
+    TcpTxBufferNextSegTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief NextSeg, walking the whole sent list
+     * \param txBuf the buffer
+     * \param seq the first sequence number of the segment found
+     * \param isRecovery whether the sender is in loss recovery
+     * \returns true if a segment is found
+     */
+    bool LinearNextSeg(Ptr<const TcpTxBuffer> txBuf, SequenceNumber32* seq, bool isRecovery) const;
+
+    /**
+     * \brief Check NextSeg against LinearNextSeg, in and out of recovery
+     * \param txBuf the buffer
+     * \param step the description of the last operation
+     */
+    void Check(Ptr<const TcpTxBuffer> txBuf, const std::string& step);
+
+    /**
+     * \brief Callback to provide a value of receiver window
+     * \returns the receiver window size
+     */
+    uint32_t GetRWnd() const;
+};
+
+TcpTxBufferNextSegTestCase::TcpTxBufferNextSegTestCase()
+    : TestCase("Check NextSeg against a walk of the whole sent list")
+{
+}
+
+uint32_t
+TcpTxBufferNextSegTestCase::GetRWnd() const
+{
+    return std::numeric_limits<uint32_t>::max();
+}
+
+bool
+TcpTxBufferNextSegTestCase::LinearNextSeg(Ptr<const TcpTxBuffer> txBuf,
+                                          SequenceNumber32* seq,
+                                          bool isRecovery) const
+{
+    // Rules (1) and (3) of RFC 6675, on the first items which qualify
+    bool isSeqPerRule3Valid = false;
+    SequenceNumber32 seqPerRule3;
+    SequenceNumber32 beginOfCurrentPkt = txBuf->HeadSequence();
+    for (const TcpTxItem* item : txBuf->m_sentList)
+    {
+        if (!item->IsRetrans() && !item->IsSacked())
+        {
+            if (item->IsLost())
+            {
+                *seq = beginOfCurrentPkt;
+                return true;
+            }
+            else if (!isSeqPerRule3Valid && isRecovery)
+            {
+                isSeqPerRule3Valid = true;
+                seqPerRule3 = beginOfCurrentPkt;
+            }
+        }
+        beginOfCurrentPkt += item->GetSeqSize();
+    }
+
+    // Rule (2), with an unlimited receiver window
+    if (txBuf->SizeFromSequence(beginOfCurrentPkt) > 0)
+    {
+        *seq = beginOfCurrentPkt;
+        return true;
+    }
+
+    if (isSeqPerRule3Valid)
+    {
+        *seq = seqPerRule3;
+        return true;
+    }
+    return false;
+}
+
+void
+TcpTxBufferNextSegTestCase::Check(Ptr<const TcpTxBuffer> txBuf, const std::string& step)
+{
+    for (bool isRecovery : {false, true})
+    {
+        SequenceNumber32 seq;
+        SequenceNumber32 seqHigh;
+        SequenceNumber32 expected;
+        bool found = txBuf->NextSeg(&seq, &seqHigh, isRecovery);
+        NS_TEST_ASSERT_MSG_EQ(found,
+                              LinearNextSeg(txBuf, &expected, isRecovery),
+                              "NextSeg found a different segment after " << step);
+        if (found)
+        {
+            NS_TEST_ASSERT_MSG_EQ(seq,
+                                  expected,
+                                  "NextSeg found a different segment after " << step);
+        }
+    }
+}
+
+void
+TcpTxBufferNextSegTestCase::DoRun()
+{
+    const uint32_t segmentSize = 100;
+    Ptr<TcpTxBuffer> txBuf = CreateObject<TcpTxBuffer>();
+    txBuf->SetRWndCallback(MakeCallback(&TcpTxBufferNextSegTestCase::GetRWnd, this));
+    txBuf->SetHeadSequence(SequenceNumber32(1));
+    txBuf->SetSegmentSize(segmentSize);
+    txBuf->SetDupAckThresh(3);
+    txBuf->SetMaxBufferSize(1000000);
+    txBuf->Add(Create<Packet>(1000000));
+
+    Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable>();
+    random->SetStream(1);
+
+    // the segment of the sent list starting n segments after the head
+    auto segment = [&](uint32_t n) { return txBuf->HeadSequence() + n * segmentSize; };
+    auto nSent = [&]() { return txBuf->m_sentSize / segmentSize; };
+
+    for (uint32_t i = 0; i < 3000; i++)
+    {
+        uint32_t operation = random->GetInteger(0, 20);
+        std::string step;
+        SequenceNumber32 seq;
+        SequenceNumber32 seqHigh;
+        if ((operation <= 9 || nSent() < 2) && txBuf->NextSeg(&seq, &seqHigh, true))
+        {
+            // transmit the next segment, new or retransmitted
+            step = "the transmission of " + std::to_string(seq.GetValue());
+            txBuf->CopyFromSequence(segmentSize, seq);
+        }
+        else if (operation <= 16 && nSent() >= 2)
+        {
+            // SACK a segment other than the head
+            SequenceNumber32 begin = segment(random->GetInteger(1, nSent() - 1));
+            step = "a SACK of " + std::to_string(begin.GetValue());
+            TcpOptionSack::SackList sackList;
+            sackList.emplace_back(begin, begin + segmentSize);
+            txBuf->Update(sackList);
+        }
+        else if (operation == 17 && nSent() >= 2)
+        {
+            // cumulative ACK of a few segments, up to a segment which is not sacked
+            uint32_t n = random->GetInteger(1, std::min<uint32_t>(3, nSent() - 1));
+            while (n < nSent() && (*txBuf->m_sentIndex.at(segment(n)))->IsSacked())
+            {
+                n++;
+            }
+            step = "an ACK of " + std::to_string(segment(n).GetValue());
+            txBuf->DiscardUpTo(segment(n));
+        }
+        else if (operation == 18)
+        {
+            step = "the reset of the retransmitted flag of the head";
+            txBuf->DeleteRetransmittedFlagFromHead();
+        }
+        else if (operation == 19)
+        {
+            step = "the loss of the head";
+            txBuf->MarkHeadAsLost();
+        }
+        else if (nSent() > 0)
+        {
+            // retransmission timeout
+            bool resetSack = random->GetInteger(0, 1) == 1;
+            step = resetSack ? "an RTO resetting the SACKs" : "an RTO";
+            txBuf->SetSentListLost(resetSack);
+        }
+        Check(txBuf, step);
+    }
+}
+
 /**
  * \ingroup internet-test
  *
@@ -442,6 +633,7 @@ class TcpTxBufferTestSuite : public TestSuite
         : TestSuite("tcp-tx-buffer", UNIT)
     {
         AddTestCase(new TcpTxBufferTestCase, TestCase::QUICK);
+        AddTestCase(new TcpTxBufferNextSegTestCase, TestCase::QUICK);
     }
 };
 
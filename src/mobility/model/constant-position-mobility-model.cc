@@ -60,4 +60,15 @@ ConstantPositionMobilityModel::DoGetVelocity() const
     return Vector(0.0, 0.0, 0.0);
 }
 
+bool
+ConstantPositionMobilityModel::DoGetLinearTrajectory(Vector& position,
+                                                     Vector& velocity,
+                                                     Time& end) const
+{
+    position = m_position;
+    velocity = Vector(0.0, 0.0, 0.0);
+    end = Time::Max();
+    return true;
+}
+
 } // namespace ns3
@@ -48,6 +48,7 @@ class ConstantPositionMobilityModel : public MobilityModel
     Vector DoGetPosition() const override;
     void DoSetPosition(const Vector& position) override;
     Vector DoGetVelocity() const override;
+    bool DoGetLinearTrajectory(Vector& position, Vector& velocity, Time& end) const override;
 
     Vector m_position; //!< the constant position
 };
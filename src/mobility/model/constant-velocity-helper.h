@@ -69,6 +69,12 @@ class ConstantVelocityHelper
      * \param vel Velocity vector
      */
     void SetVelocity(const Vector& vel);
+    /**
+     * Set new velocity vector, at a given time
+     * \param vel Velocity vector
+     * \param now Time of the change, not before the time of last update
+     */
+    void SetVelocity(const Vector& vel, const Time& now);
     /**
      * Pause mobility at current position
      */
@@ -84,15 +90,36 @@ class ConstantVelocityHelper
      * the rectangle
      */
     void UpdateWithBounds(const Rectangle& rectangle) const;
+    /**
+     * Update position, if not paused, from last position and time of last update
+     * \param rectangle 2D bounding rectangle for resulting position; object will not move outside
+     * the rectangle
+     * \param now Time of the update, not before the time of last update
+     */
+    void UpdateWithBounds(const Rectangle& rectangle, const Time& now) const;
     /**
      * Update position, if not paused, from last position and time of last update
      * \param bounds 3D bounding box for resulting position; object will not move outside the box
      */
     void UpdateWithBounds(const Box& bounds) const;
+    /**
+     * Update position, if not paused, from last position and time of last update
+     * \param bounds 3D bounding box for resulting position; object will not move outside the box
+     * \param now Time of the update, not before the time of last update
+     */
+    void UpdateWithBounds(const Box& bounds, const Time& now) const;
     /**
      * Update position, if not paused, from last position and time of last update
      */
     void Update() const;
+    /**
+     * Update position, if not paused, from last position and time of last update
+     * \param now Time of the update, not before the time of last update
+     *
+     * The mobility models computing their trajectory lazily use the
+     * methods taking the time to compute the past steps of the trajectory.
+     */
+    void Update(const Time& now) const;
 
   private:
     mutable Time m_lastUpdate; //!< time of last update
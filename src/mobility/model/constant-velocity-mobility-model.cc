@@ -72,4 +72,15 @@ ConstantVelocityMobilityModel::DoGetVelocity() const
     return m_helper.GetVelocity();
 }
 
+bool
+ConstantVelocityMobilityModel::DoGetLinearTrajectory(Vector& position,
+                                                     Vector& velocity,
+                                                     Time& end) const
+{
+    position = DoGetPosition();
+    velocity = m_helper.GetVelocity();
+    end = Time::Max();
+    return true;
+}
+
 } // namespace ns3
@@ -62,6 +62,7 @@ class ConstantVelocityMobilityModel : public MobilityModel
     Vector DoGetPosition() const override;
     void DoSetPosition(const Vector& position) override;
     Vector DoGetVelocity() const override;
+    bool DoGetLinearTrajectory(Vector& position, Vector& velocity, Time& end) const override;
     ConstantVelocityHelper m_helper; //!< helper object for this model
 };
 
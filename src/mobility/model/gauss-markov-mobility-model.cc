@@ -20,6 +20,7 @@
 
 #include "position-allocator.h"
 
+#include "ns3/boolean.h"
 #include "ns3/double.h"
 #include "ns3/pointer.h"
 #include "ns3/simulator.h"
@@ -89,7 +90,13 @@ GaussMarkovMobilityModel::GetTypeId()
                 "A gaussian random variable used to calculate the next pitch value.",
                 StringValue("ns3::NormalRandomVariable[Mean=0.0|Variance=1.0|Bound=10.0]"),
                 MakePointerAccessor(&GaussMarkovMobilityModel::m_normalPitch),
-                MakePointerChecker<NormalRandomVariable>());
+                MakePointerChecker<NormalRandomVariable>())
+            .AddAttribute("Lazy",
+                          "Compute the trajectory when the position is queried, instead of "
+                          "in scheduled events.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&GaussMarkovMobilityModel::m_lazy),
+                          MakeBooleanChecker());
 
     return tid;
 }
@@ -99,12 +106,27 @@ GaussMarkovMobilityModel::GaussMarkovMobilityModel()
     m_meanVelocity = 0.0;
     m_meanDirection = 0.0;
     m_meanPitch = 0.0;
-    m_event = Simulator::ScheduleNow(&GaussMarkovMobilityModel::Start, this);
+    m_lazy = false;
+    m_advancing = false;
+    m_stepTime = Simulator::Now();
+    m_event = Simulator::ScheduleNow(&GaussMarkovMobilityModel::Start, this, m_stepTime);
     m_helper.Unpause();
 }
 
 void
-GaussMarkovMobilityModel::Start()
+GaussMarkovMobilityModel::NotifyConstructionCompleted()
+{
+    if (m_lazy)
+    {
+        // the first time step is computed when queried
+        Simulator::Remove(m_event);
+        ScheduleStep(m_stepTime, Seconds(0));
+    }
+    MobilityModel::NotifyConstructionCompleted();
+}
+
+void
+GaussMarkovMobilityModel::Start(Time now)
 {
     if (m_meanVelocity == 0.0)
     {
@@ -122,9 +144,10 @@ GaussMarkovMobilityModel::Start()
         m_Pitch = m_meanPitch;
         // Set the velocity vector to give to the constant velocity helper
         m_helper.SetVelocity(
-            Vector(m_Velocity * cosD * cosP, m_Velocity * sinD * cosP, m_Velocity * sinP));
+            Vector(m_Velocity * cosD * cosP, m_Velocity * sinD * cosP, m_Velocity * sinP),
+            now);
     }
-    m_helper.Update();
+    m_helper.Update(now);
 
     // Get the next values from the gaussian distributions for velocity, direction, and pitch
     double rv = m_normalVelocity->GetValue();
@@ -148,17 +171,17 @@ GaussMarkovMobilityModel::Start()
     double vx = m_Velocity * cosDir * cosPit;
     double vy = m_Velocity * sinDir * cosPit;
     double vz = m_Velocity * sinPit;
-    m_helper.SetVelocity(Vector(vx, vy, vz));
+    m_helper.SetVelocity(Vector(vx, vy, vz), now);
 
     m_helper.Unpause();
 
-    DoWalk(m_timeStep);
+    DoWalk(now, m_timeStep);
 }
 
 void
-GaussMarkovMobilityModel::DoWalk(Time delayLeft)
+GaussMarkovMobilityModel::DoWalk(Time now, Time delayLeft)
 {
-    m_helper.UpdateWithBounds(m_bounds);
+    m_helper.UpdateWithBounds(m_bounds, now);
     Vector position = m_helper.GetCurrentPosition();
     Vector speed = m_helper.GetVelocity();
     Vector nextPosition = position;
@@ -175,7 +198,7 @@ GaussMarkovMobilityModel::DoWalk(Time delayLeft)
     // in bounds
     if (m_bounds.IsInside(nextPosition))
     {
-        m_event = Simulator::Schedule(delayLeft, &GaussMarkovMobilityModel::Start, this);
+        ScheduleStep(now, delayLeft);
     }
     else
     {
@@ -199,13 +222,53 @@ GaussMarkovMobilityModel::DoWalk(Time delayLeft)
 
         m_Direction = m_meanDirection;
         m_Pitch = m_meanPitch;
-        m_helper.SetVelocity(speed);
+        m_helper.SetVelocity(speed, now);
         m_helper.Unpause();
-        m_event = Simulator::Schedule(delayLeft, &GaussMarkovMobilityModel::Start, this);
+        ScheduleStep(now, delayLeft);
     }
     NotifyCourseChange();
 }
 
+void
+GaussMarkovMobilityModel::ScheduleStep(Time now, Time delay)
+{
+    m_stepTime = now + delay;
+    if (!m_lazy)
+    {
+        m_event = Simulator::Schedule(delay, &GaussMarkovMobilityModel::Start, this, m_stepTime);
+    }
+    else if (!m_advancing && HasCourseChangeListeners())
+    {
+        // notify the listeners on time
+        m_event.Cancel();
+        m_event = Simulator::Schedule(m_stepTime - Simulator::Now(),
+                                      &GaussMarkovMobilityModel::Advance,
+                                      this);
+    }
+}
+
+void
+GaussMarkovMobilityModel::Advance()
+{
+    if (m_advancing)
+    {
+        return;
+    }
+    m_advancing = true;
+    Time now = Simulator::Now();
+    while (m_stepTime <= now)
+    {
+        Start(m_stepTime);
+    }
+    m_advancing = false;
+    m_event.Cancel();
+    if (HasCourseChangeListeners())
+    {
+        // notify the listeners on time
+        m_event = Simulator::Schedule(m_stepTime - now, &GaussMarkovMobilityModel::Advance, this);
+    }
+}
+
 void
 GaussMarkovMobilityModel::DoDispose()
 {
@@ -216,6 +279,15 @@ GaussMarkovMobilityModel::DoDispose()
 Vector
 GaussMarkovMobilityModel::DoGetPosition() const
 {
+    if (m_lazy)
+    {
+        if (m_advancing)
+        {
+            // queried by a course change listener, at the time of a step
+            return m_helper.GetCurrentPosition();
+        }
+        const_cast<GaussMarkovMobilityModel*>(this)->Advance();
+    }
     m_helper.Update();
     return m_helper.GetCurrentPosition();
 }
@@ -225,15 +297,33 @@ GaussMarkovMobilityModel::DoSetPosition(const Vector& position)
 {
     m_helper.SetPosition(position);
     m_event.Cancel();
-    m_event = Simulator::ScheduleNow(&GaussMarkovMobilityModel::Start, this);
+    ScheduleStep(Simulator::Now(), Seconds(0));
 }
 
 Vector
 GaussMarkovMobilityModel::DoGetVelocity() const
 {
+    if (m_lazy && !m_advancing)
+    {
+        const_cast<GaussMarkovMobilityModel*>(this)->Advance();
+    }
     return m_helper.GetVelocity();
 }
 
+bool
+GaussMarkovMobilityModel::DoGetLinearTrajectory(Vector& position, Vector& velocity, Time& end) const
+{
+    if (m_advancing)
+    {
+        return false;
+    }
+    position = DoGetPosition();
+    velocity = m_helper.GetVelocity();
+    // in lazy mode, the next step is computed when queried
+    end = m_lazy ? m_stepTime : Time::Max();
+    return true;
+}
+
 int64_t
 GaussMarkovMobilityModel::DoAssignStreams(int64_t stream)
 {
@@ -77,6 +77,13 @@ namespace ns3
  * [1] Tracy Camp, Jeff Boleng, Vanessa Davies, "A Survey of Mobility Models
  * for Ad Hoc Network Research", Wireless Communications and Mobile Computing,
  * Wiley, vol.2 iss.5, September 2002, pp.483-502
+ *
+ * If the "Lazy" attribute is true, the model schedules no event: the time
+ * steps are computed, in the same order and with the same random values,
+ * when the position or the velocity is queried.  The course changes are
+ * then notified when the position or the velocity is queried, unless the
+ * CourseChange trace source has listeners, in which case the model
+ * schedules an event at each time step to notify them on time.
  */
 class GaussMarkovMobilityModel : public MobilityModel
 {
@@ -91,17 +98,31 @@ class GaussMarkovMobilityModel : public MobilityModel
   private:
     /**
      * Initialize the model and calculate new velocity, direction, and pitch
+     * \param now the time of the time step
      */
-    void Start();
+    void Start(Time now);
     /**
      * Perform a walk operation
+     * \param now the time of the time step
      * \param timeLeft time until Start method is called again
      */
-    void DoWalk(Time timeLeft);
+    void DoWalk(Time now, Time timeLeft);
+    /**
+     * Schedule the next time step, or record it in lazy mode
+     * \param now the time of the current time step
+     * \param delay the delay until the next time step
+     */
+    void ScheduleStep(Time now, Time delay);
+    /**
+     * In lazy mode, compute the time steps until now
+     */
+    void Advance();
+    void NotifyConstructionCompleted() override;
     void DoDispose() override;
     Vector DoGetPosition() const override;
     void DoSetPosition(const Vector& position) override;
     Vector DoGetVelocity() const override;
+    bool DoGetLinearTrajectory(Vector& position, Vector& velocity, Time& end) const override;
     int64_t DoAssignStreams(int64_t) override;
     ConstantVelocityHelper m_helper; //!< constant velocity helper
     Time m_timeStep;                 //!< duraiton after which direction and speed should change
@@ -120,6 +141,9 @@ class GaussMarkovMobilityModel : public MobilityModel
     Ptr<NormalRandomVariable> m_normalPitch;      //!< Gaussian rv for next pitch
     EventId m_event;                              //!< event id of scheduled start
     Box m_bounds;                                 //!< bounding box
+    bool m_lazy;                                  //!< compute the trajectory when queried
+    Time m_stepTime;                              //!< time of the next step, in lazy mode
+    bool m_advancing;                             //!< true while computing the steps
 };
 
 } // namespace ns3
@@ -0,0 +1,290 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mobility-manager.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MobilityManager");
+
+MobilityManager::MobilityManager()
+    : m_lastUpdate(Time::Min()),
+      m_anyChanged(false)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MobilityManager**
+MobilityManager::DoGet()
+{
+    static MobilityManager* manager = nullptr;
+    return &manager;
+}
+
+MobilityManager*
+MobilityManager::Get()
+{
+    MobilityManager** manager = DoGet();
+    if (*manager == nullptr)
+    {
+        *manager = new MobilityManager();
+        Simulator::ScheduleDestroy(&MobilityManager::Delete);
+    }
+    return *manager;
+}
+
+void
+MobilityManager::Delete()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    MobilityManager** manager = DoGet();
+    for (auto& model : (*manager)->m_models)
+    {
+        if (model)
+        {
+            model->m_managerIndex = NOT_REGISTERED;
+        }
+    }
+    delete *manager;
+    *manager = nullptr;
+}
+
+void
+MobilityManager::Add(Ptr<MobilityModel> model)
+{
+    NS_LOG_FUNCTION(model);
+    Ptr<Node> node = model->GetObject<Node>();
+    NS_ASSERT_MSG(node, "The mobility model is not aggregated to a node");
+    MobilityManager* manager = Get();
+    manager->Resize(node->GetId() + 1);
+    manager->DoAdd(model, node);
+}
+
+MobilityManager::Vectors
+MobilityManager::GetPositions(const NodeContainer& nodes)
+{
+    MobilityManager* manager = Get();
+    bool consecutive = manager->Prepare(nodes);
+    manager->Update();
+    return manager->GetVectors(nodes, consecutive, manager->m_x, manager->m_y, manager->m_z);
+}
+
+MobilityManager::Vectors
+MobilityManager::GetVelocities(const NodeContainer& nodes)
+{
+    MobilityManager* manager = Get();
+    bool consecutive = manager->Prepare(nodes);
+    manager->Update();
+    return manager->GetVectors(nodes, consecutive, manager->m_vx, manager->m_vy, manager->m_vz);
+}
+
+void
+MobilityManager::NotifyCourseChange(uint32_t index)
+{
+    MobilityManager* manager = *DoGet();
+    NS_ASSERT(manager != nullptr && index < manager->m_changed.size());
+    manager->m_changed[index] = true;
+    manager->m_anyChanged = true;
+}
+
+void
+MobilityManager::DoAdd(Ptr<MobilityModel> model, Ptr<Node> node)
+{
+    NS_LOG_FUNCTION(this << model << node);
+    uint32_t index = node->GetId();
+    if (m_models[index] == model)
+    {
+        return;
+    }
+    if (m_models[index])
+    {
+        m_models[index]->m_managerIndex = NOT_REGISTERED;
+    }
+    NS_ASSERT_MSG(model->m_managerIndex == NOT_REGISTERED,
+                  "The mobility model is registered for another node");
+    model->m_managerIndex = index;
+    m_models[index] = model;
+    m_changed[index] = true;
+    m_anyChanged = true;
+}
+
+void
+MobilityManager::Resize(uint32_t size)
+{
+    if (size <= m_models.size())
+    {
+        return;
+    }
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    m_models.resize(size);
+    m_x0.resize(size, nan);
+    m_y0.resize(size, nan);
+    m_z0.resize(size, nan);
+    m_t0.resize(size, 0.0);
+    m_vx.resize(size, 0.0);
+    m_vy.resize(size, 0.0);
+    m_vz.resize(size, 0.0);
+    m_x.resize(size, nan);
+    m_y.resize(size, nan);
+    m_z.resize(size, nan);
+    m_end.resize(size, Time::Max());
+    m_changed.resize(size, false);
+}
+
+bool
+MobilityManager::Prepare(const NodeContainer& nodes)
+{
+    if (nodes.GetN() == 0)
+    {
+        return true;
+    }
+    uint32_t first = nodes.Get(0)->GetId();
+    uint32_t maxId = 0;
+    bool consecutive = true;
+    uint32_t i = 0;
+    for (auto it = nodes.Begin(); it != nodes.End(); ++it, ++i)
+    {
+        uint32_t id = (*it)->GetId();
+        consecutive = consecutive && id == first + i;
+        maxId = std::max(maxId, id);
+    }
+    Resize(maxId + 1);
+    for (auto it = nodes.Begin(); it != nodes.End(); ++it)
+    {
+        if (!m_models[(*it)->GetId()])
+        {
+            Ptr<MobilityModel> model = (*it)->GetObject<MobilityModel>();
+            if (model)
+            {
+                DoAdd(model, *it);
+            }
+        }
+    }
+    return consecutive;
+}
+
+void
+MobilityManager::Update()
+{
+    Time now = Simulator::Now();
+    if (now == m_lastUpdate && !m_anyChanged)
+    {
+        return;
+    }
+    NS_LOG_FUNCTION(this << now);
+    uint32_t size = m_models.size();
+    for (uint32_t i = 0; i < size; i++)
+    {
+        if (m_models[i] && (m_changed[i] || m_end[i] <= now))
+        {
+            Refresh(i, now);
+        }
+    }
+    m_anyChanged = false;
+
+    // Advance all the positions along their linear trajectories
+    const double t = now.GetSeconds();
+    const double* x0 = m_x0.data();
+    const double* y0 = m_y0.data();
+    const double* z0 = m_z0.data();
+    const double* t0 = m_t0.data();
+    const double* vx = m_vx.data();
+    const double* vy = m_vy.data();
+    const double* vz = m_vz.data();
+    double* x = m_x.data();
+    double* y = m_y.data();
+    double* z = m_z.data();
+    for (uint32_t i = 0; i < size; i++)
+    {
+        double dt = t - t0[i];
+        x[i] = x0[i] + vx[i] * dt;
+        y[i] = y0[i] + vy[i] * dt;
+        z[i] = z0[i] + vz[i] * dt;
+    }
+    m_lastUpdate = now;
+}
+
+void
+MobilityManager::Refresh(uint32_t index, Time now)
+{
+    Ptr<MobilityModel> model = m_models[index];
+    Vector position;
+    Vector velocity;
+    Time end;
+    if (!model->GetLinearTrajectory(position, velocity, end))
+    {
+        // query the model at each update
+        position = model->GetPosition();
+        velocity = model->GetVelocity();
+        end = now;
+    }
+    m_x0[index] = position.x;
+    m_y0[index] = position.y;
+    m_z0[index] = position.z;
+    m_t0[index] = now.GetSeconds();
+    m_vx[index] = velocity.x;
+    m_vy[index] = velocity.y;
+    m_vz[index] = velocity.z;
+    m_end[index] = end;
+    m_changed[index] = false;
+}
+
+MobilityManager::Vectors
+MobilityManager::GetVectors(const NodeContainer& nodes,
+                            bool consecutive,
+                            const std::vector<double>& x,
+                            const std::vector<double>& y,
+                            const std::vector<double>& z)
+{
+    Vectors vectors{nullptr, nullptr, nullptr, nodes.GetN()};
+    if (vectors.size == 0)
+    {
+        return vectors;
+    }
+    if (consecutive)
+    {
+        uint32_t first = nodes.Get(0)->GetId();
+        vectors.x = x.data() + first;
+        vectors.y = y.data() + first;
+        vectors.z = z.data() + first;
+        return vectors;
+    }
+    for (auto& buffer : m_buffer)
+    {
+        buffer.resize(vectors.size);
+    }
+    uint32_t i = 0;
+    for (auto it = nodes.Begin(); it != nodes.End(); ++it, ++i)
+    {
+        uint32_t id = (*it)->GetId();
+        m_buffer[0][i] = x[id];
+        m_buffer[1][i] = y[id];
+        m_buffer[2][i] = z[id];
+    }
+    vectors.x = m_buffer[0].data();
+    vectors.y = m_buffer[1].data();
+    vectors.z = m_buffer[2].data();
+    return vectors;
+}
+
+} // namespace ns3
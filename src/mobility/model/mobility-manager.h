@@ -0,0 +1,172 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MOBILITY_MANAGER_H
+#define MOBILITY_MANAGER_H
+
+#include "mobility-model.h"
+
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include <limits>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup mobility
+ * \brief Keep the positions and velocities of the nodes in arrays.
+ *
+ * The MobilityManager keeps the position and the velocity of the mobility
+ * model of each registered node, indexed by node id, in one array per
+ * coordinate.  The positions are advanced all at once, when they are
+ * requested at a new simulation time: the position of a model moving in a
+ * straight line (see MobilityModel::GetLinearTrajectory) is computed from
+ * its last course change, in a loop over the arrays, and only the other
+ * models are queried through MobilityModel::GetPosition.
+ *
+ * The positions of the nodes of a NodeContainer are returned as pointers
+ * into the arrays when the ids of the nodes are consecutive, which is the
+ * case of the nodes created by NodeContainer::Create; otherwise, they are
+ * copied into a buffer.  Consumers computing distances between many nodes,
+ * such as channels, can then loop over plain arrays of doubles.
+ *
+ * The mobility models of the nodes are registered when their positions
+ * are first requested, or with MobilityManager::Add.  A registered model
+ * notifies the manager of its course changes, without using the
+ * CourseChange trace source.  The manager is reset by Simulator::Destroy.
+ */
+class MobilityManager
+{
+  public:
+    /// Index of a mobility model which is not registered.
+    static const uint32_t NOT_REGISTERED = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * \brief A view on the coordinates of the positions or velocities of
+     * nodes, valid until the next call to the MobilityManager.
+     */
+    struct Vectors
+    {
+        const double* x; //!< the x coordinates
+        const double* y; //!< the y coordinates
+        const double* z; //!< the z coordinates
+        uint32_t size;   //!< the number of nodes
+    };
+
+    /**
+     * \param model the mobility model to register, aggregated to a node
+     *
+     * Register the mobility model of a node.  Registering a model twice
+     * has no effect.
+     */
+    static void Add(Ptr<MobilityModel> model);
+    /**
+     * \param nodes the nodes
+     * \returns the current positions of the nodes, in the order of the
+     * container.  The coordinates of the nodes without mobility model are NaN.
+     */
+    static Vectors GetPositions(const NodeContainer& nodes);
+    /**
+     * \param nodes the nodes
+     * \returns the current velocities of the nodes, in the order of the
+     * container.  The coordinates of the nodes without mobility model are 0.
+     */
+    static Vectors GetVelocities(const NodeContainer& nodes);
+    /**
+     * \param index the index of the model, i.e., the id of its node
+     *
+     * Called by the registered mobility models when their course changes.
+     */
+    static void NotifyCourseChange(uint32_t index);
+
+  private:
+    MobilityManager();
+
+    /**
+     * \returns the manager of the simulation, created on demand
+     */
+    static MobilityManager* Get();
+    /**
+     * \returns a pointer to the manager of the simulation
+     */
+    static MobilityManager** DoGet();
+    /**
+     * Delete the manager and unregister its models, when the simulation is destroyed.
+     */
+    static void Delete();
+
+    /**
+     * \param model the mobility model to register
+     * \param node the node of the model
+     */
+    void DoAdd(Ptr<MobilityModel> model, Ptr<Node> node);
+    /**
+     * \param size the number of nodes to make room for
+     */
+    void Resize(uint32_t size);
+    /**
+     * Register the models of the nodes
+     * \param nodes the nodes
+     * \returns true if the ids of the nodes are consecutive
+     */
+    bool Prepare(const NodeContainer& nodes);
+    /**
+     * Advance the positions of all the models to now
+     */
+    void Update();
+    /**
+     * Get the trajectory of a model from now
+     * \param index the index of the model
+     * \param now the current time
+     */
+    void Refresh(uint32_t index, Time now);
+    /**
+     * \param nodes the nodes
+     * \param consecutive true if the ids of the nodes are consecutive
+     * \param x the x coordinates of all the nodes
+     * \param y the y coordinates of all the nodes
+     * \param z the z coordinates of all the nodes
+     * \returns the coordinates of the nodes
+     */
+    Vectors GetVectors(const NodeContainer& nodes,
+                       bool consecutive,
+                       const std::vector<double>& x,
+                       const std::vector<double>& y,
+                       const std::vector<double>& z);
+
+    std::vector<Ptr<MobilityModel>> m_models; //!< the models, by node id
+    std::vector<double> m_x0;                 //!< x coordinates at the last course change
+    std::vector<double> m_y0;                 //!< y coordinates at the last course change
+    std::vector<double> m_z0;                 //!< z coordinates at the last course change
+    std::vector<double> m_t0;                 //!< times of the last course change, in seconds
+    std::vector<double> m_vx;                 //!< x coordinates of the velocities
+    std::vector<double> m_vy;                 //!< y coordinates of the velocities
+    std::vector<double> m_vz;                 //!< z coordinates of the velocities
+    std::vector<double> m_x;                  //!< x coordinates of the positions
+    std::vector<double> m_y;                  //!< y coordinates of the positions
+    std::vector<double> m_z;                  //!< z coordinates of the positions
+    std::vector<Time> m_end;                  //!< end times of the linear trajectories
+    std::vector<bool> m_changed;              //!< course changed since the last update
+    std::vector<double> m_buffer[3];          //!< coordinates of non consecutive nodes
+    Time m_lastUpdate;                        //!< time of the last update
+    bool m_anyChanged;                        //!< any course changed since the last update
+};
+
+} // namespace ns3
+
+#endif /* MOBILITY_MANAGER_H */
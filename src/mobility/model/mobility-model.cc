@@ -19,6 +19,8 @@
 
 #include "mobility-model.h"
 
+#include "mobility-manager.h"
+
 #include "ns3/trace-source-accessor.h"
 
 #include <cmath>
@@ -56,6 +58,7 @@ MobilityModel::GetTypeId()
 }
 
 MobilityModel::MobilityModel()
+    : m_managerIndex(MobilityManager::NOT_REGISTERED)
 {
 }
 
@@ -92,6 +95,11 @@ void
 MobilityModel::SetPosition(const Vector& position)
 {
     DoSetPosition(position);
+    if (m_managerIndex != MobilityManager::NOT_REGISTERED)
+    {
+        // some models notify the course change in a later event
+        MobilityManager::NotifyCourseChange(m_managerIndex);
+    }
 }
 
 double
@@ -111,9 +119,19 @@ MobilityModel::GetRelativeSpeed(Ptr<const MobilityModel> other) const
 void
 MobilityModel::NotifyCourseChange() const
 {
+    if (m_managerIndex != MobilityManager::NOT_REGISTERED)
+    {
+        MobilityManager::NotifyCourseChange(m_managerIndex);
+    }
     m_courseChangeTrace(this);
 }
 
+bool
+MobilityModel::HasCourseChangeListeners() const
+{
+    return !m_courseChangeTrace.IsEmpty();
+}
+
 int64_t
 MobilityModel::AssignStreams(int64_t start)
 {
@@ -127,4 +145,17 @@ MobilityModel::DoAssignStreams(int64_t start)
     return 0;
 }
 
+bool
+MobilityModel::GetLinearTrajectory(Vector& position, Vector& velocity, Time& end) const
+{
+    return DoGetLinearTrajectory(position, velocity, end);
+}
+
+// Default implementation: the trajectory is unknown
+bool
+MobilityModel::DoGetLinearTrajectory(Vector& position, Vector& velocity, Time& end) const
+{
+    return false;
+}
+
 } // namespace ns3
@@ -19,6 +19,7 @@
 #ifndef MOBILITY_MODEL_H
 #define MOBILITY_MODEL_H
 
+#include "ns3/nstime.h"
 #include "ns3/object.h"
 #include "ns3/traced-callback.h"
 #include "ns3/vector.h"
@@ -26,6 +27,8 @@
 namespace ns3
 {
 
+class MobilityManager;
+
 /**
  * \ingroup mobility
  * \brief Keep track of the current position and velocity of an object.
@@ -90,6 +93,18 @@ class MobilityModel : public Object
      * \return the number of stream indices assigned by this model
      */
     int64_t AssignStreams(int64_t stream);
+    /**
+     * Get the current position and velocity, if the object moves in a
+     * straight line at this velocity until the next course change.
+     *
+     * \param [out] position the current position
+     * \param [out] velocity the current velocity
+     * \param [out] end the time before which the velocity may change only
+     * with a course change notification
+     * \return false if the trajectory of the model is not piecewise linear
+     * \sa ns3::MobilityManager
+     */
+    bool GetLinearTrajectory(Vector& position, Vector& velocity, Time& end) const;
 
     /**
      *  TracedCallback signature.
@@ -104,6 +119,13 @@ class MobilityModel : public Object
      * position changes to notify course change listeners.
      */
     void NotifyCourseChange() const;
+    /**
+     * \return true if the CourseChange trace source has listeners.
+     *
+     * Subclasses computing their trajectory lazily use it to schedule
+     * course change events only when someone listens to them.
+     */
+    bool HasCourseChangeListeners() const;
 
   private:
     /**
@@ -143,6 +165,23 @@ class MobilityModel : public Object
      * \return the number of streams used
      */
     virtual int64_t DoAssignStreams(int64_t start);
+    /**
+     * \param [out] position the current position
+     * \param [out] velocity the current velocity
+     * \param [out] end the time before which the velocity may change only
+     * with a course change notification
+     * \return false if the trajectory of the model is not piecewise linear
+     *
+     * The default implementation returns false.  Subclasses moving at
+     * constant velocity between their course changes are expected to
+     * override this, to let the MobilityManager compute their positions.
+     */
+    virtual bool DoGetLinearTrajectory(Vector& position, Vector& velocity, Time& end) const;
+
+    friend class MobilityManager;
+
+    /// Index of the model in the MobilityManager, if registered
+    uint32_t m_managerIndex;
 
     /**
      * Used to alert subscribers that a change in direction, velocity,
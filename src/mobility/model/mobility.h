@@ -31,6 +31,9 @@
  *  - a "course change notifier" trace source which can be used to register
  *    listeners to the course changes of a mobility model
  *
+ *  - a MobilityManager which keeps the positions and velocities of the
+ *    nodes in arrays, for the consumers of many positions at once
+ *
  *  - a number of helper classes which are used to place nodes and setup
  *    mobility models (including parsers for some mobility definition formats).
  */
@@ -160,6 +160,17 @@ RandomDirection2dMobilityModel::DoGetVelocity() const
     return m_helper.GetVelocity();
 }
 
+bool
+RandomDirection2dMobilityModel::DoGetLinearTrajectory(Vector& position,
+                                                      Vector& velocity,
+                                                      Time& end) const
+{
+    position = DoGetPosition();
+    velocity = m_helper.GetVelocity();
+    end = Time::Max();
+    return true;
+}
+
 int64_t
 RandomDirection2dMobilityModel::DoAssignStreams(int64_t stream)
 {
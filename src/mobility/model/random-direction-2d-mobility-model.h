@@ -75,6 +75,7 @@ class RandomDirection2dMobilityModel : public MobilityModel
     Vector DoGetPosition() const override;
     void DoSetPosition(const Vector& position) override;
     Vector DoGetVelocity() const override;
+    bool DoGetLinearTrajectory(Vector& position, Vector& velocity, Time& end) const override;
     int64_t DoAssignStreams(int64_t) override;
 
     Ptr<UniformRandomVariable> m_direction; //!< rv to control direction
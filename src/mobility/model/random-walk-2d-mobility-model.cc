@@ -18,6 +18,7 @@
  */
 #include "random-walk-2d-mobility-model.h"
 
+#include "ns3/boolean.h"
 #include "ns3/double.h"
 #include "ns3/enum.h"
 #include "ns3/log.h"
@@ -75,25 +76,31 @@ RandomWalk2dMobilityModel::GetTypeId()
                           "A random variable used to pick the speed (m/s).",
                           StringValue("ns3::UniformRandomVariable[Min=2.0|Max=4.0]"),
                           MakePointerAccessor(&RandomWalk2dMobilityModel::m_speed),
-                          MakePointerChecker<RandomVariableStream>());
+                          MakePointerChecker<RandomVariableStream>())
+            .AddAttribute("Lazy",
+                          "Compute the trajectory when the position is queried, instead of "
+                          "in scheduled events.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&RandomWalk2dMobilityModel::m_lazy),
+                          MakeBooleanChecker());
     return tid;
 }
 
 void
 RandomWalk2dMobilityModel::DoInitialize()
 {
-    DoInitializePrivate();
+    DoInitializePrivate(Simulator::Now());
     MobilityModel::DoInitialize();
 }
 
 void
-RandomWalk2dMobilityModel::DoInitializePrivate()
+RandomWalk2dMobilityModel::DoInitializePrivate(Time now)
 {
-    m_helper.Update();
+    m_helper.Update(now);
     double speed = m_speed->GetValue();
     double direction = m_direction->GetValue();
     Vector vector(std::cos(direction) * speed, std::sin(direction) * speed, 0.0);
-    m_helper.SetVelocity(vector);
+    m_helper.SetVelocity(vector, now);
     m_helper.Unpause();
 
     Time delayLeft;
@@ -105,39 +112,35 @@ RandomWalk2dMobilityModel::DoInitializePrivate()
     {
         delayLeft = Seconds(m_modeDistance / speed);
     }
-    DoWalk(delayLeft);
+    DoWalk(now, delayLeft);
 }
 
 void
-RandomWalk2dMobilityModel::DoWalk(Time delayLeft)
+RandomWalk2dMobilityModel::DoWalk(Time now, Time delayLeft)
 {
     Vector position = m_helper.GetCurrentPosition();
     Vector speed = m_helper.GetVelocity();
     Vector nextPosition = position;
     nextPosition.x += speed.x * delayLeft.GetSeconds();
     nextPosition.y += speed.y * delayLeft.GetSeconds();
-    m_event.Cancel();
     if (m_bounds.IsInside(nextPosition))
     {
-        m_event =
-            Simulator::Schedule(delayLeft, &RandomWalk2dMobilityModel::DoInitializePrivate, this);
+        ScheduleStep(now, delayLeft, &RandomWalk2dMobilityModel::DoInitializePrivate);
     }
     else
     {
         nextPosition = m_bounds.CalculateIntersection(position, speed);
         Time delay = Seconds((nextPosition.x - position.x) / speed.x);
-        m_event = Simulator::Schedule(delay,
-                                      &RandomWalk2dMobilityModel::Rebound,
-                                      this,
-                                      delayLeft - delay);
+        m_timeLeft = delayLeft - delay;
+        ScheduleStep(now, delay, &RandomWalk2dMobilityModel::Rebound);
     }
     NotifyCourseChange();
 }
 
 void
-RandomWalk2dMobilityModel::Rebound(Time delayLeft)
+RandomWalk2dMobilityModel::Rebound(Time now)
 {
-    m_helper.UpdateWithBounds(m_bounds);
+    m_helper.UpdateWithBounds(m_bounds, now);
     Vector position = m_helper.GetCurrentPosition();
     Vector speed = m_helper.GetVelocity();
     switch (m_bounds.GetClosestSide(position))
@@ -151,9 +154,55 @@ RandomWalk2dMobilityModel::Rebound(Time delayLeft)
         speed.y = -speed.y;
         break;
     }
-    m_helper.SetVelocity(speed);
+    m_helper.SetVelocity(speed, now);
     m_helper.Unpause();
-    DoWalk(delayLeft);
+    DoWalk(now, m_timeLeft);
+}
+
+void
+RandomWalk2dMobilityModel::ScheduleStep(Time now,
+                                        Time delay,
+                                        void (RandomWalk2dMobilityModel::*step)(Time))
+{
+    m_event.Cancel();
+    if (!m_lazy)
+    {
+        m_event = Simulator::Schedule(delay, step, this, now + delay);
+        return;
+    }
+    m_stepTime = now + delay;
+    m_step = step;
+    if (!m_advancing && HasCourseChangeListeners())
+    {
+        // notify the listeners on time
+        m_event = Simulator::Schedule(m_stepTime - Simulator::Now(),
+                                      &RandomWalk2dMobilityModel::Advance,
+                                      this);
+    }
+}
+
+void
+RandomWalk2dMobilityModel::Advance()
+{
+    if (m_advancing)
+    {
+        return;
+    }
+    m_advancing = true;
+    Time now = Simulator::Now();
+    while (m_step && m_stepTime <= now)
+    {
+        auto step = m_step;
+        m_step = nullptr;
+        (this->*step)(m_stepTime);
+    }
+    m_advancing = false;
+    m_event.Cancel();
+    if (m_step && HasCourseChangeListeners())
+    {
+        // notify the listeners on time
+        m_event = Simulator::Schedule(m_stepTime - now, &RandomWalk2dMobilityModel::Advance, this);
+    }
 }
 
 void
@@ -166,6 +215,15 @@ RandomWalk2dMobilityModel::DoDispose()
 Vector
 RandomWalk2dMobilityModel::DoGetPosition() const
 {
+    if (m_lazy)
+    {
+        if (m_advancing)
+        {
+            // queried by a course change listener, at the time of a step
+            return m_helper.GetCurrentPosition();
+        }
+        const_cast<RandomWalk2dMobilityModel*>(this)->Advance();
+    }
     m_helper.UpdateWithBounds(m_bounds);
     return m_helper.GetCurrentPosition();
 }
@@ -175,16 +233,35 @@ RandomWalk2dMobilityModel::DoSetPosition(const Vector& position)
 {
     NS_ASSERT(m_bounds.IsInside(position));
     m_helper.SetPosition(position);
-    m_event.Cancel();
-    m_event = Simulator::ScheduleNow(&RandomWalk2dMobilityModel::DoInitializePrivate, this);
+    ScheduleStep(Simulator::Now(), Seconds(0), &RandomWalk2dMobilityModel::DoInitializePrivate);
 }
 
 Vector
 RandomWalk2dMobilityModel::DoGetVelocity() const
 {
+    if (m_lazy && !m_advancing)
+    {
+        const_cast<RandomWalk2dMobilityModel*>(this)->Advance();
+    }
     return m_helper.GetVelocity();
 }
 
+bool
+RandomWalk2dMobilityModel::DoGetLinearTrajectory(Vector& position,
+                                                 Vector& velocity,
+                                                 Time& end) const
+{
+    if (m_advancing)
+    {
+        return false;
+    }
+    position = DoGetPosition();
+    velocity = m_helper.GetVelocity();
+    // in lazy mode, the next step is computed when queried
+    end = (m_lazy && m_step) ? m_stepTime : Time::Max();
+    return true;
+}
+
 int64_t
 RandomWalk2dMobilityModel::DoAssignStreams(int64_t stream)
 {
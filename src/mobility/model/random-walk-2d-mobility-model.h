@@ -42,6 +42,13 @@ namespace ns3
  * of the model, we rebound on the boundary with a reflexive angle
  * and speed. This model is often identified as a brownian motion
  * model.
+ *
+ * If the "Lazy" attribute is true, the model schedules no event: the walks
+ * and rebounds are computed, in the same order and with the same random
+ * values, when the position or the velocity is queried.  The course changes
+ * are then notified when the position or the velocity is queried, unless
+ * the CourseChange trace source has listeners, in which case the model
+ * schedules an event at each course change to notify them on time.
  */
 class RandomWalk2dMobilityModel : public MobilityModel
 {
@@ -61,25 +68,40 @@ class RandomWalk2dMobilityModel : public MobilityModel
 
   private:
     /**
-     * \brief Performs the rebound of the node if it reaches a boundary
-     * \param timeLeft The remaining time of the walk
+     * \brief Performs the rebound of the node if it reaches a boundary,
+     * and walks for the remaining time of the walk
+     * \param now The time of the rebound
      */
-    void Rebound(Time timeLeft);
+    void Rebound(Time now);
     /**
      * Walk according to position and velocity, until distance is reached,
      * time is reached, or intersection with the bounding box
+     * \param now The time of the walk
      * \param timeLeft The remaining time of the walk
      */
-    void DoWalk(Time timeLeft);
+    void DoWalk(Time now, Time timeLeft);
     /**
      * Perform initialization of the object before MobilityModel::DoInitialize ()
+     * \param now The time of the initialization
+     */
+    void DoInitializePrivate(Time now);
+    /**
+     * Schedule the next step of the trajectory, or record it in lazy mode
+     * \param now the time of the current step
+     * \param delay the delay until the next step
+     * \param step the next step
+     */
+    void ScheduleStep(Time now, Time delay, void (RandomWalk2dMobilityModel::*step)(Time));
+    /**
+     * In lazy mode, compute the steps of the trajectory until now
      */
-    void DoInitializePrivate();
+    void Advance();
     void DoDispose() override;
     void DoInitialize() override;
     Vector DoGetPosition() const override;
     void DoSetPosition(const Vector& position) override;
     Vector DoGetVelocity() const override;
+    bool DoGetLinearTrajectory(Vector& position, Vector& velocity, Time& end) const override;
     int64_t DoAssignStreams(int64_t) override;
 
     ConstantVelocityHelper m_helper;       //!< helper for this object
@@ -90,6 +112,11 @@ class RandomWalk2dMobilityModel : public MobilityModel
     Ptr<RandomVariableStream> m_speed;     //!< rv for picking speed
     Ptr<RandomVariableStream> m_direction; //!< rv for picking direction
     Rectangle m_bounds;                    //!< Bounds of the area to cruise
+    Time m_timeLeft;                       //!< Remaining time of the walk after a rebound
+    bool m_lazy;                           //!< compute the trajectory when queried
+    Time m_stepTime;                       //!< time of the next step, in lazy mode
+    void (RandomWalk2dMobilityModel::*m_step)(Time){nullptr}; //!< next step, in lazy mode
+    bool m_advancing{false}; //!< true while computing the steps, in lazy mode
 };
 
 } // namespace ns3
@@ -20,11 +20,13 @@
 
 #include "position-allocator.h"
 
+#include "ns3/boolean.h"
 #include "ns3/pointer.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/simulator.h"
 #include "ns3/string.h"
 
+#include <algorithm>
 #include <cmath>
 
 namespace ns3
@@ -32,6 +34,14 @@ namespace ns3
 
 NS_OBJECT_ENSURE_REGISTERED(RandomWaypointMobilityModel);
 
+std::map<const PositionAllocator*, Ptr<RandomWaypointMobilityModel::LazyQueue>>&
+RandomWaypointMobilityModel::GetLazyQueues()
+{
+    // never destroyed, the models may outlive the static objects
+    static auto queues = new std::map<const PositionAllocator*, Ptr<LazyQueue>>;
+    return *queues;
+}
+
 TypeId
 RandomWaypointMobilityModel::GetTypeId()
 {
@@ -54,53 +64,218 @@ RandomWaypointMobilityModel::GetTypeId()
                           "The position model used to pick a destination point.",
                           PointerValue(),
                           MakePointerAccessor(&RandomWaypointMobilityModel::m_position),
-                          MakePointerChecker<PositionAllocator>());
+                          MakePointerChecker<PositionAllocator>())
+            .AddAttribute("Lazy",
+                          "Compute the trajectory when the position is queried, instead of "
+                          "in scheduled events.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&RandomWaypointMobilityModel::m_lazy),
+                          MakeBooleanChecker());
 
     return tid;
 }
 
+RandomWaypointMobilityModel::RandomWaypointMobilityModel()
+{
+}
+
+RandomWaypointMobilityModel::~RandomWaypointMobilityModel()
+{
+    LeaveLazyQueue();
+}
+
 void
-RandomWaypointMobilityModel::BeginWalk()
+RandomWaypointMobilityModel::BeginWalk(Time now)
 {
-    m_helper.Update();
+    m_helper.Update(now);
     Vector m_current = m_helper.GetCurrentPosition();
-    NS_ASSERT_MSG(m_position, "No position allocator added before using this model");
-    Vector destination = m_position->GetNext();
+    Vector destination = GetNextDestination(now);
     double speed = m_speed->GetValue();
     double dx = (destination.x - m_current.x);
     double dy = (destination.y - m_current.y);
     double dz = (destination.z - m_current.z);
     double k = speed / std::sqrt(dx * dx + dy * dy + dz * dz);
 
-    m_helper.SetVelocity(Vector(k * dx, k * dy, k * dz));
+    m_helper.SetVelocity(Vector(k * dx, k * dy, k * dz), now);
     m_helper.Unpause();
     Time travelDelay = Seconds(CalculateDistance(destination, m_current) / speed);
-    m_event.Cancel();
-    m_event =
-        Simulator::Schedule(travelDelay, &RandomWaypointMobilityModel::DoInitializePrivate, this);
+    ScheduleStep(now, travelDelay, &RandomWaypointMobilityModel::DoInitializePrivate);
     NotifyCourseChange();
 }
 
 void
 RandomWaypointMobilityModel::DoInitialize()
 {
-    DoInitializePrivate();
+    if (m_lazy)
+    {
+        JoinLazyQueue();
+    }
+    DoInitializePrivate(Simulator::Now());
     MobilityModel::DoInitialize();
 }
 
 void
-RandomWaypointMobilityModel::DoInitializePrivate()
+RandomWaypointMobilityModel::DoDispose()
 {
-    m_helper.Update();
+    LeaveLazyQueue();
+    MobilityModel::DoDispose();
+}
+
+void
+RandomWaypointMobilityModel::JoinLazyQueue()
+{
+    NS_ASSERT_MSG(m_position, "No position allocator added before using this model");
+    Ptr<LazyQueue>& queue = GetLazyQueues()[PeekPointer(m_position)];
+    if (!queue)
+    {
+        queue = Create<LazyQueue>();
+        queue->position = m_position;
+    }
+    m_lazyQueue = queue;
+    m_lazyRank = queue->nextRank++;
+    queue->nModels++;
+}
+
+void
+RandomWaypointMobilityModel::LeaveLazyQueue()
+{
+    if (!m_lazyQueue)
+    {
+        return;
+    }
+    if (m_step)
+    {
+        m_lazyQueue->steps.erase({m_stepTime, m_lazyRank, this});
+        m_step = nullptr;
+    }
+    if (--m_lazyQueue->nModels == 0)
+    {
+        GetLazyQueues().erase(PeekPointer(m_lazyQueue->position));
+    }
+    m_lazyQueue = nullptr;
+}
+
+void
+RandomWaypointMobilityModel::DoInitializePrivate(Time now)
+{
+    m_helper.Update(now);
     m_helper.Pause();
     Time pause = Seconds(m_pause->GetValue());
-    m_event = Simulator::Schedule(pause, &RandomWaypointMobilityModel::BeginWalk, this);
+    ScheduleStep(now, pause, &RandomWaypointMobilityModel::BeginWalk);
     NotifyCourseChange();
 }
 
+void
+RandomWaypointMobilityModel::ScheduleStep(Time now,
+                                          Time delay,
+                                          void (RandomWaypointMobilityModel::*step)(Time))
+{
+    m_event.Cancel();
+    if (!m_lazy)
+    {
+        m_event = Simulator::Schedule(delay, step, this, now + delay);
+        return;
+    }
+    if (m_lazyQueue && m_step)
+    {
+        m_lazyQueue->steps.erase({m_stepTime, m_lazyRank, this});
+    }
+    m_stepTime = now + delay;
+    m_step = step;
+    if (m_lazyQueue)
+    {
+        m_lazyQueue->steps.insert({m_stepTime, m_lazyRank, this});
+    }
+    if (!m_advancing)
+    {
+        ScheduleNotification();
+    }
+}
+
+void
+RandomWaypointMobilityModel::RunNextStep()
+{
+    if (m_lazyQueue)
+    {
+        m_lazyQueue->steps.erase({m_stepTime, m_lazyRank, this});
+    }
+    auto step = m_step;
+    m_step = nullptr;
+    (this->*step)(m_stepTime);
+}
+
+void
+RandomWaypointMobilityModel::Advance()
+{
+    if (m_advancing)
+    {
+        return;
+    }
+    m_advancing = true;
+    Time now = Simulator::Now();
+    while (m_step && m_stepTime <= now)
+    {
+        RunNextStep();
+    }
+    m_advancing = false;
+    ScheduleNotification();
+}
+
+void
+RandomWaypointMobilityModel::ScheduleNotification()
+{
+    m_event.Cancel();
+    if (m_step && HasCourseChangeListeners())
+    {
+        // notify the listeners on time, or now if they were connected late
+        Time now = Simulator::Now();
+        m_event = Simulator::Schedule(std::max(m_stepTime, now) - now,
+                                      &RandomWaypointMobilityModel::Advance,
+                                      this);
+    }
+}
+
+Vector
+RandomWaypointMobilityModel::GetNextDestination(Time now)
+{
+    NS_ASSERT_MSG(m_position, "No position allocator added before using this model");
+    if (m_lazyQueue && !m_lazyQueue->draining)
+    {
+        // The destinations drawn before this one by the models sharing the
+        // position allocator in the default mode are drawn first.  The steps
+        // are computed in order, the nested queries do not drain the queue.
+        m_lazyQueue->draining = true;
+        LazyQueue::Step self{now, m_lazyRank, nullptr};
+        while (!m_lazyQueue->steps.empty() && *m_lazyQueue->steps.begin() < self)
+        {
+            RandomWaypointMobilityModel* model = std::get<2>(*m_lazyQueue->steps.begin());
+            if (model->m_advancing)
+            {
+                // queried by a course change listener of that model
+                break;
+            }
+            model->m_advancing = true;
+            model->RunNextStep();
+            model->m_advancing = false;
+            model->ScheduleNotification();
+        }
+        m_lazyQueue->draining = false;
+    }
+    return m_position->GetNext();
+}
+
 Vector
 RandomWaypointMobilityModel::DoGetPosition() const
 {
+    if (m_lazy)
+    {
+        if (m_advancing)
+        {
+            // queried by a course change listener, at the time of a step
+            return m_helper.GetCurrentPosition();
+        }
+        const_cast<RandomWaypointMobilityModel*>(this)->Advance();
+    }
     m_helper.Update();
     return m_helper.GetCurrentPosition();
 }
@@ -109,16 +284,35 @@ void
 RandomWaypointMobilityModel::DoSetPosition(const Vector& position)
 {
     m_helper.SetPosition(position);
-    m_event.Cancel();
-    m_event = Simulator::ScheduleNow(&RandomWaypointMobilityModel::DoInitializePrivate, this);
+    ScheduleStep(Simulator::Now(), Seconds(0), &RandomWaypointMobilityModel::DoInitializePrivate);
 }
 
 Vector
 RandomWaypointMobilityModel::DoGetVelocity() const
 {
+    if (m_lazy && !m_advancing)
+    {
+        const_cast<RandomWaypointMobilityModel*>(this)->Advance();
+    }
     return m_helper.GetVelocity();
 }
 
+bool
+RandomWaypointMobilityModel::DoGetLinearTrajectory(Vector& position,
+                                                   Vector& velocity,
+                                                   Time& end) const
+{
+    if (m_advancing)
+    {
+        return false;
+    }
+    position = DoGetPosition();
+    velocity = m_helper.GetVelocity();
+    // in lazy mode, the next step is computed when queried
+    end = (m_lazy && m_step) ? m_stepTime : Time::Max();
+    return true;
+}
+
 int64_t
 RandomWaypointMobilityModel::DoAssignStreams(int64_t stream)
 {
@@ -25,6 +25,11 @@
 
 #include "ns3/ptr.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/simple-ref-count.h"
+
+#include <map>
+#include <set>
+#include <tuple>
 
 namespace ns3
 {
@@ -49,6 +54,25 @@ namespace ns3
  * a 3d random waypoint position model to this mobility model, the model
  * will still work. There is no 3d position allocator for now but it should
  * be trivial to add one.
+ *
+ * If the "Lazy" attribute is true, the model schedules no event: the
+ * pauses and walks are computed, in the same order and with the same random
+ * values, when the position or the velocity is queried.  The course
+ * changes are then notified when the position or the velocity is queried,
+ * unless the CourseChange trace source has listeners, in which case the
+ * model schedules an event at each course change to notify them on time.
+ * The listeners connected while the model waits for its next course change
+ * are notified of it late, at the next query, and on time afterwards.
+ *
+ * In lazy mode, the models sharing a PositionAllocator draw their
+ * destinations in the same order as in the default mode: the next steps of
+ * these models are kept in a queue ordered by time, and by order of
+ * initialization for the steps at the same time.  Before a model draws a
+ * destination, the earlier steps of the queue are computed, one at a time.
+ * Their trajectories do not depend on the times of the queries, and each
+ * step is computed once, but a query may compute the pending steps of all
+ * these models.  A PositionAllocator must not be shared by lazy and non-lazy
+ * models, and the Speed and Pause random variables must not be shared.
  */
 class RandomWaypointMobilityModel : public MobilityModel
 {
@@ -59,21 +83,81 @@ class RandomWaypointMobilityModel : public MobilityModel
      */
     static TypeId GetTypeId();
 
+    RandomWaypointMobilityModel();
+    ~RandomWaypointMobilityModel() override;
+
   protected:
     void DoInitialize() override;
+    void DoDispose() override;
 
   private:
+    /**
+     * The next steps of the lazy models sharing a PositionAllocator
+     */
+    struct LazyQueue : public SimpleRefCount<LazyQueue>
+    {
+        /// A step: its time, the rank of the model, and the model
+        using Step = std::tuple<Time, uint32_t, RandomWaypointMobilityModel*>;
+
+        Ptr<PositionAllocator> position; //!< the shared PositionAllocator
+        uint32_t nextRank{0};            //!< the rank of the next model initialized
+        uint32_t nModels{0};             //!< the number of models in the queue
+        bool draining{false};            //!< true while computing the steps of the queue
+        std::set<Step> steps;            //!< the next step of each model, in time order
+    };
+
     /**
      * Get next position, begin moving towards it, schedule future pause event
+     * \param now the time of the walk
      */
-    void BeginWalk();
+    void BeginWalk(Time now);
     /**
      * Begin current pause event, schedule future walk event
+     * \param now the time of the pause
+     */
+    void DoInitializePrivate(Time now);
+    /**
+     * Schedule the next step of the trajectory, or record it in lazy mode
+     * \param now the time of the current step
+     * \param delay the delay until the next step
+     * \param step the next step
+     */
+    void ScheduleStep(Time now, Time delay, void (RandomWaypointMobilityModel::*step)(Time));
+    /**
+     * In lazy mode, compute the next step of the trajectory
+     */
+    void RunNextStep();
+    /**
+     * In lazy mode, compute the steps of the trajectory until now
+     */
+    void Advance();
+    /**
+     * In lazy mode, notify the CourseChange listeners of the next step on
+     * time, if any
+     */
+    void ScheduleNotification();
+    /**
+     * Draw the next destination from the position allocator
+     * \param now the time of the walk
+     * \return the destination
+     */
+    Vector GetNextDestination(Time now);
+    /**
+     * In lazy mode, join the queue of the models sharing the PositionAllocator
+     */
+    void JoinLazyQueue();
+    /**
+     * In lazy mode, leave the queue of the models sharing the PositionAllocator
+     */
+    void LeaveLazyQueue();
+    /**
+     * \return the queues of the lazy models, by PositionAllocator
      */
-    void DoInitializePrivate();
+    static std::map<const PositionAllocator*, Ptr<LazyQueue>>& GetLazyQueues();
     Vector DoGetPosition() const override;
     void DoSetPosition(const Vector& position) override;
     Vector DoGetVelocity() const override;
+    bool DoGetLinearTrajectory(Vector& position, Vector& velocity, Time& end) const override;
     int64_t DoAssignStreams(int64_t) override;
 
     ConstantVelocityHelper m_helper;   //!< helper for velocity computations
@@ -81,6 +165,12 @@ class RandomWaypointMobilityModel : public MobilityModel
     Ptr<RandomVariableStream> m_speed; //!< random variable to generate speeds
     Ptr<RandomVariableStream> m_pause; //!< random variable to generate pauses
     EventId m_event;                   //!< event ID of next scheduled event
+    bool m_lazy;                       //!< compute the trajectory when queried
+    Time m_stepTime;                   //!< time of the next step, in lazy mode
+    void (RandomWaypointMobilityModel::*m_step)(Time){nullptr}; //!< next step, in lazy mode
+    bool m_advancing{false}; //!< true while computing the steps, in lazy mode
+    Ptr<LazyQueue> m_lazyQueue; //!< the queue of the models sharing m_position, in lazy mode
+    uint32_t m_lazyRank{0};     //!< the rank of the model in m_lazyQueue
 };
 
 } // namespace ns3
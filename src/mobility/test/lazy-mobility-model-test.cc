@@ -0,0 +1,323 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/mobility-model.h"
+#include "ns3/nstime.h"
+#include "ns3/object-factory.h"
+#include "ns3/pointer.h"
+#include "ns3/position-allocator.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup mobility-test
+ *
+ * \brief Check that the lazy mode of a mobility model computes the same
+ * trajectory as the default mode, without scheduling events.
+ */
+class LazyMobilityModelTest : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     * \param typeId the TypeId of the mobility model
+     */
+    LazyMobilityModelTest(std::string typeId);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Create and initialize a mobility model
+     * \param lazy the value of the Lazy attribute
+     * \return the mobility model
+     */
+    Ptr<MobilityModel> CreateModel(bool lazy);
+    /**
+     * Compare the positions and velocities of the models
+     * \param eager the model in the default mode
+     * \param lazy the model in the lazy mode
+     */
+    void Compare(Ptr<MobilityModel> eager, Ptr<MobilityModel> lazy);
+    /**
+     * Course change callback
+     * \param times the times of the course changes
+     * \param model the mobility model
+     */
+    static void CourseChange(std::vector<Time>* times, Ptr<const MobilityModel> model);
+
+    std::string m_typeId; //!< the TypeId of the mobility model
+};
+
+LazyMobilityModelTest::LazyMobilityModelTest(std::string typeId)
+    : TestCase("Check the lazy mode of " + typeId),
+      m_typeId(typeId)
+{
+}
+
+Ptr<MobilityModel>
+LazyMobilityModelTest::CreateModel(bool lazy)
+{
+    ObjectFactory factory(m_typeId, "Lazy", BooleanValue(lazy));
+    if (m_typeId == "ns3::RandomWaypointMobilityModel")
+    {
+        // Each model has its own position allocator
+        Ptr<RandomRectanglePositionAllocator> allocator =
+            CreateObject<RandomRectanglePositionAllocator>();
+        allocator->SetX(CreateObjectWithAttributes<UniformRandomVariable>("Max", DoubleValue(100)));
+        allocator->SetY(CreateObjectWithAttributes<UniformRandomVariable>("Max", DoubleValue(100)));
+        factory.Set("PositionAllocator", PointerValue(allocator));
+        factory.Set("Speed", StringValue("ns3::UniformRandomVariable[Min=1.0|Max=10.0]"));
+    }
+    else if (m_typeId == "ns3::RandomWalk2dMobilityModel")
+    {
+        factory.Set("Mode", StringValue("Time"), "Time", TimeValue(Seconds(7)));
+    }
+    else if (m_typeId == "ns3::GaussMarkovMobilityModel")
+    {
+        factory.Set("TimeStep", TimeValue(Seconds(0.5)), "Alpha", DoubleValue(0.85));
+        factory.Set("MeanVelocity",
+                    StringValue("ns3::UniformRandomVariable[Min=5.0|Max=10.0]"));
+    }
+    Ptr<MobilityModel> model = factory.Create<MobilityModel>();
+    model->AssignStreams(1);
+    model->SetPosition(Vector(50.0, 50.0, 50.0));
+    model->Initialize();
+    return model;
+}
+
+void
+LazyMobilityModelTest::Compare(Ptr<MobilityModel> eager, Ptr<MobilityModel> lazy)
+{
+    Vector expected = eager->GetPosition();
+    Vector position = lazy->GetPosition();
+    NS_TEST_EXPECT_MSG_EQ_TOL(position.x, expected.x, 1e-6, "Wrong x at " << Simulator::Now());
+    NS_TEST_EXPECT_MSG_EQ_TOL(position.y, expected.y, 1e-6, "Wrong y at " << Simulator::Now());
+    NS_TEST_EXPECT_MSG_EQ_TOL(position.z, expected.z, 1e-6, "Wrong z at " << Simulator::Now());
+    expected = eager->GetVelocity();
+    Vector velocity = lazy->GetVelocity();
+    NS_TEST_EXPECT_MSG_EQ_TOL(velocity.x, expected.x, 1e-6, "Wrong speed at " << Simulator::Now());
+    NS_TEST_EXPECT_MSG_EQ_TOL(velocity.y, expected.y, 1e-6, "Wrong speed at " << Simulator::Now());
+}
+
+void
+LazyMobilityModelTest::CourseChange(std::vector<Time>* times, Ptr<const MobilityModel> model)
+{
+    times->push_back(Simulator::Now());
+}
+
+void
+LazyMobilityModelTest::DoRun()
+{
+    // Same trajectory, whatever the times of the queries.  The queries are
+    // not simultaneous with the steps, whose order with the queries differs
+    Ptr<MobilityModel> eager = CreateModel(false);
+    Ptr<MobilityModel> lazy = CreateModel(true);
+    for (double t = 0.35; t < 100.0; t += 3.7)
+    {
+        Simulator::Schedule(Seconds(t), &LazyMobilityModelTest::Compare, this, eager, lazy);
+    }
+    Simulator::Stop(Seconds(100));
+    Simulator::Run();
+    Simulator::Destroy();
+
+    // No event is scheduled in lazy mode, without course change listeners
+    lazy = CreateModel(true);
+    Simulator::Stop(Seconds(100));
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(Simulator::GetEventCount(), 1, "Only the stop event is expected");
+    Simulator::Destroy();
+
+    // The course change listeners are notified on time
+    std::vector<Time> eagerTimes;
+    std::vector<Time> lazyTimes;
+    eager = CreateModel(false);
+    lazy = CreateModel(true);
+    eager->TraceConnectWithoutContext("CourseChange",
+                                      MakeBoundCallback(&CourseChange, &eagerTimes));
+    lazy->TraceConnectWithoutContext("CourseChange", MakeBoundCallback(&CourseChange, &lazyTimes));
+    // The listener is connected after the initialization: the next query
+    // schedules the notification events
+    lazy->GetPosition();
+    Simulator::Stop(Seconds(100));
+    Simulator::Run();
+    Simulator::Destroy();
+    NS_TEST_EXPECT_MSG_GT(lazyTimes.size(), 2, "Too few course changes");
+    NS_TEST_EXPECT_MSG_EQ((lazyTimes == eagerTimes), true, "Course changes not notified on time");
+}
+
+/**
+ * \ingroup mobility-test
+ *
+ * \brief Check that the lazy random waypoint models sharing a position
+ * allocator compute the same trajectories as in the default mode, whatever
+ * the order of the queries, and after other lazy models were destroyed.
+ */
+class LazySharedAllocatorTest : public TestCase
+{
+  public:
+    LazySharedAllocatorTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Create and initialize random waypoint models sharing a position allocator
+     * \param lazy the value of the Lazy attribute
+     * \return the mobility models
+     */
+    std::vector<Ptr<MobilityModel>> CreateModels(bool lazy);
+    /**
+     * Compare the position and velocity of a model in both modes
+     * \param eager the model in the default mode
+     * \param lazy the model in the lazy mode
+     */
+    void Compare(Ptr<MobilityModel> eager, Ptr<MobilityModel> lazy);
+};
+
+LazySharedAllocatorTest::LazySharedAllocatorTest()
+    : TestCase("Check the lazy random waypoint models sharing a position allocator")
+{
+}
+
+std::vector<Ptr<MobilityModel>>
+LazySharedAllocatorTest::CreateModels(bool lazy)
+{
+    Ptr<RandomRectanglePositionAllocator> allocator =
+        CreateObject<RandomRectanglePositionAllocator>();
+    allocator->SetX(CreateObjectWithAttributes<UniformRandomVariable>("Max", DoubleValue(100)));
+    allocator->SetY(CreateObjectWithAttributes<UniformRandomVariable>("Max", DoubleValue(100)));
+
+    std::vector<Ptr<MobilityModel>> models;
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        // The models start walking at the same time, after the same pause
+        ObjectFactory factory("ns3::RandomWaypointMobilityModel",
+                              "Lazy",
+                              BooleanValue(lazy),
+                              "PositionAllocator",
+                              PointerValue(allocator));
+        factory.Set("Speed", StringValue("ns3::UniformRandomVariable[Min=1.0|Max=10.0]"));
+        Ptr<MobilityModel> model = factory.Create<MobilityModel>();
+        model->SetPosition(Vector(50.0, 50.0, 0.0));
+        model->Initialize();
+        models.push_back(model);
+    }
+    // The speeds and pauses of each model have their own streams, which
+    // also assign the streams of the shared allocator
+    for (uint32_t i = 0; i < models.size(); i++)
+    {
+        models[i]->AssignStreams(10 * (i + 1));
+    }
+    allocator->AssignStreams(1);
+    return models;
+}
+
+void
+LazySharedAllocatorTest::Compare(Ptr<MobilityModel> eager, Ptr<MobilityModel> lazy)
+{
+    Vector expected = eager->GetPosition();
+    Vector position = lazy->GetPosition();
+    NS_TEST_EXPECT_MSG_EQ_TOL(position.x, expected.x, 1e-6, "Wrong x at " << Simulator::Now());
+    NS_TEST_EXPECT_MSG_EQ_TOL(position.y, expected.y, 1e-6, "Wrong y at " << Simulator::Now());
+    expected = eager->GetVelocity();
+    Vector velocity = lazy->GetVelocity();
+    NS_TEST_EXPECT_MSG_EQ_TOL(velocity.x, expected.x, 1e-6, "Wrong speed at " << Simulator::Now());
+    NS_TEST_EXPECT_MSG_EQ_TOL(velocity.y, expected.y, 1e-6, "Wrong speed at " << Simulator::Now());
+}
+
+void
+LazySharedAllocatorTest::DoRun()
+{
+    // The lazy models of the first run are destroyed without being disposed,
+    // the models of the second run must not see them
+    for (uint32_t run = 0; run < 2; run++)
+    {
+        std::vector<Ptr<MobilityModel>> eager = CreateModels(false);
+        std::vector<Ptr<MobilityModel>> lazy = CreateModels(true);
+
+        // The last models are queried first, and the first ones only at the end
+        for (double t = 0.35; t < 100.0; t += 3.7)
+        {
+            Simulator::Schedule(Seconds(t),
+                                &LazySharedAllocatorTest::Compare,
+                                this,
+                                eager[3],
+                                lazy[3]);
+        }
+        for (double t = 20.15; t < 100.0; t += 11.3)
+        {
+            Simulator::Schedule(Seconds(t),
+                                &LazySharedAllocatorTest::Compare,
+                                this,
+                                eager[2],
+                                lazy[2]);
+        }
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            Simulator::Schedule(Seconds(99.9),
+                                &LazySharedAllocatorTest::Compare,
+                                this,
+                                eager[i],
+                                lazy[i]);
+        }
+        Simulator::Stop(Seconds(100));
+        Simulator::Run();
+        for (const auto& model : eager)
+        {
+            model->Dispose();
+        }
+        if (run == 0)
+        {
+            lazy.clear();
+        }
+        for (const auto& model : lazy)
+        {
+            model->Dispose();
+        }
+        Simulator::Destroy();
+    }
+}
+
+/**
+ * \ingroup mobility-test
+ *
+ * \brief Lazy Mobility Model Test Suite
+ */
+class LazyMobilityModelTestSuite : public TestSuite
+{
+  public:
+    LazyMobilityModelTestSuite();
+};
+
+LazyMobilityModelTestSuite::LazyMobilityModelTestSuite()
+    : TestSuite("lazy-mobility-model", UNIT)
+{
+    AddTestCase(new LazyMobilityModelTest("ns3::RandomWaypointMobilityModel"), TestCase::QUICK);
+    AddTestCase(new LazyMobilityModelTest("ns3::RandomWalk2dMobilityModel"), TestCase::QUICK);
+    AddTestCase(new LazyMobilityModelTest("ns3::GaussMarkovMobilityModel"), TestCase::QUICK);
+    AddTestCase(new LazySharedAllocatorTest, TestCase::QUICK);
+}
+
+/// Static variable for test initialization
+static LazyMobilityModelTestSuite g_lazyMobilityModelTestSuite;
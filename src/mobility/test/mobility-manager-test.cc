@@ -0,0 +1,187 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/boolean.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/double.h"
+#include "ns3/mobility-manager.h"
+#include "ns3/node-container.h"
+#include "ns3/pointer.h"
+#include "ns3/position-allocator.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/random-waypoint-mobility-model.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include "ns3/waypoint-mobility-model.h"
+
+#include <cmath>
+
+using namespace ns3;
+
+/**
+ * \ingroup mobility-test
+ *
+ * \brief Check the positions and velocities kept by the MobilityManager
+ * against those of the mobility models.
+ */
+class MobilityManagerTest : public TestCase
+{
+  public:
+    MobilityManagerTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Compare the positions and velocities of the manager with those of the models
+     */
+    void Compare();
+
+    NodeContainer m_nodes; //!< the nodes
+};
+
+MobilityManagerTest::MobilityManagerTest()
+    : TestCase("Check the positions and velocities of the MobilityManager")
+{
+}
+
+void
+MobilityManagerTest::Compare()
+{
+    MobilityManager::Vectors positions = MobilityManager::GetPositions(m_nodes);
+    NS_TEST_ASSERT_MSG_EQ(positions.size, m_nodes.GetN(), "Wrong number of positions");
+    for (uint32_t i = 0; i < m_nodes.GetN(); i++)
+    {
+        Ptr<MobilityModel> model = m_nodes.Get(i)->GetObject<MobilityModel>();
+        if (!model)
+        {
+            NS_TEST_EXPECT_MSG_EQ(std::isnan(positions.x[i]), true, "Position of node " << i);
+            continue;
+        }
+        Vector position = model->GetPosition();
+        NS_TEST_EXPECT_MSG_EQ_TOL(positions.x[i], position.x, 1e-6, "Node " << i);
+        NS_TEST_EXPECT_MSG_EQ_TOL(positions.y[i], position.y, 1e-6, "Node " << i);
+        NS_TEST_EXPECT_MSG_EQ_TOL(positions.z[i], position.z, 1e-6, "Node " << i);
+    }
+
+    MobilityManager::Vectors velocities = MobilityManager::GetVelocities(m_nodes);
+    for (uint32_t i = 0; i < m_nodes.GetN(); i++)
+    {
+        Ptr<MobilityModel> model = m_nodes.Get(i)->GetObject<MobilityModel>();
+        Vector velocity = model ? model->GetVelocity() : Vector(0.0, 0.0, 0.0);
+        NS_TEST_EXPECT_MSG_EQ_TOL(velocities.x[i], velocity.x, 1e-6, "Node " << i);
+        NS_TEST_EXPECT_MSG_EQ_TOL(velocities.y[i], velocity.y, 1e-6, "Node " << i);
+        NS_TEST_EXPECT_MSG_EQ_TOL(velocities.z[i], velocity.z, 1e-6, "Node " << i);
+    }
+
+    // The positions of consecutive nodes are not copied
+    NodeContainer consecutive(m_nodes.Get(2), m_nodes.Get(3), m_nodes.Get(4));
+    MobilityManager::Vectors all = MobilityManager::GetPositions(m_nodes);
+    positions = MobilityManager::GetPositions(consecutive);
+    NS_TEST_EXPECT_MSG_EQ(positions.x, all.x + 2, "The positions should not be copied");
+    NS_TEST_EXPECT_MSG_EQ(positions.size, 3, "Wrong number of positions");
+
+    // The positions of other nodes are copied, in the order of the container
+    NodeContainer reversed(m_nodes.Get(4), m_nodes.Get(1), m_nodes.Get(0));
+    positions = MobilityManager::GetPositions(reversed);
+    for (uint32_t i = 0; i < reversed.GetN(); i++)
+    {
+        Vector position = reversed.Get(i)->GetObject<MobilityModel>()->GetPosition();
+        NS_TEST_EXPECT_MSG_EQ_TOL(positions.x[i], position.x, 1e-6, "Node " << i);
+        NS_TEST_EXPECT_MSG_EQ_TOL(positions.y[i], position.y, 1e-6, "Node " << i);
+    }
+}
+
+void
+MobilityManagerTest::DoRun()
+{
+    m_nodes.Create(6);
+
+    // A node which does not move
+    Ptr<ConstantPositionMobilityModel> fixed = CreateObject<ConstantPositionMobilityModel>();
+    fixed->SetPosition(Vector(1.0, 2.0, 3.0));
+    m_nodes.Get(0)->AggregateObject(fixed);
+
+    // A node whose velocity changes
+    Ptr<ConstantVelocityMobilityModel> constant = CreateObject<ConstantVelocityMobilityModel>();
+    constant->SetVelocity(Vector(1.0, 2.0, 0.0));
+    m_nodes.Get(1)->AggregateObject(constant);
+    Simulator::Schedule(Seconds(5),
+                        &ConstantVelocityMobilityModel::SetVelocity,
+                        constant,
+                        Vector(-1.0, 0.0, 0.5));
+    Simulator::Schedule(Seconds(12),
+                        &MobilityModel::SetPosition,
+                        constant,
+                        Vector(10.0, 10.0, 10.0));
+
+    // Random waypoint models, computing their trajectory in events or when queried
+    for (uint32_t i = 2; i < 4; i++)
+    {
+        Ptr<RandomRectanglePositionAllocator> allocator =
+            CreateObject<RandomRectanglePositionAllocator>();
+        allocator->SetX(CreateObjectWithAttributes<UniformRandomVariable>("Max", DoubleValue(100)));
+        allocator->SetY(CreateObjectWithAttributes<UniformRandomVariable>("Max", DoubleValue(100)));
+        Ptr<RandomWaypointMobilityModel> model = CreateObjectWithAttributes<
+            RandomWaypointMobilityModel>("PositionAllocator",
+                                         PointerValue(allocator),
+                                         "Lazy",
+                                         BooleanValue(i == 3));
+        model->AssignStreams(i * 10);
+        m_nodes.Get(i)->AggregateObject(model);
+    }
+
+    // A model whose trajectory is not known by the manager
+    Ptr<WaypointMobilityModel> waypoints = CreateObject<WaypointMobilityModel>();
+    waypoints->AddWaypoint(Waypoint(Seconds(0), Vector(0.0, 0.0, 0.0)));
+    waypoints->AddWaypoint(Waypoint(Seconds(10), Vector(10.0, 0.0, 0.0)));
+    waypoints->AddWaypoint(Waypoint(Seconds(20), Vector(10.0, 10.0, 0.0)));
+    m_nodes.Get(4)->AggregateObject(waypoints);
+
+    // The last node has no mobility model
+
+    for (double t = 0.0; t < 50.0; t += 1.7)
+    {
+        Simulator::Schedule(Seconds(t), &MobilityManagerTest::Compare, this);
+    }
+    // Queries at the times of the course changes
+    Simulator::Schedule(Seconds(5), &MobilityManagerTest::Compare, this);
+    Simulator::Schedule(Seconds(12), &MobilityManagerTest::Compare, this);
+    Simulator::Stop(Seconds(50));
+    Simulator::Run();
+    Simulator::Destroy();
+    m_nodes = NodeContainer();
+}
+
+/**
+ * \ingroup mobility-test
+ *
+ * \brief Mobility Manager Test Suite
+ */
+class MobilityManagerTestSuite : public TestSuite
+{
+  public:
+    MobilityManagerTestSuite();
+};
+
+MobilityManagerTestSuite::MobilityManagerTestSuite()
+    : TestSuite("mobility-manager", UNIT)
+{
+    AddTestCase(new MobilityManagerTest(), TestCase::QUICK);
+}
+
+/// Static variable for test initialization
+static MobilityManagerTestSuite g_mobilityManagerTestSuite;
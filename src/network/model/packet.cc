@@ -23,6 +23,7 @@
 #include "ns3/simulator.h"
 
 #include <cstdarg>
+#include <cstring>
 #include <string>
 
 namespace ns3
@@ -127,6 +128,14 @@ PacketTagIterator::Item::GetTag(Tag& tag) const
     tag.Deserialize(TagBuffer((uint8_t*)m_data->data, (uint8_t*)m_data->data + m_data->size));
 }
 
+bool
+PacketTagIterator::Item::IsEqual(const Item& other) const
+{
+    return m_data == other.m_data ||
+           (m_data->tid == other.m_data->tid && m_data->size == other.m_data->size &&
+            std::memcmp(m_data->data, other.m_data->data, m_data->size) == 0);
+}
+
 Ptr<Packet>
 Packet::Copy() const
 {
@@ -154,6 +154,14 @@ class PacketTagIterator
          * by the user does not match the type of the underlying tag.
          */
         void GetTag(Tag& tag) const;
+        /**
+         * Compare two packet tags without deserializing them.
+         *
+         * \param other the packet tag to compare with.
+         * \returns true if the two tags have the same type and the same
+         *          serialized content.
+         */
+        bool IsEqual(const Item& other) const;
 
       private:
         /// Friend class
@@ -22,8 +22,15 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <sstream>
+#include <vector>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
 
 using namespace ns3;
 
@@ -1375,6 +1382,238 @@ DiffTestCase::DoRun()
     NS_TEST_EXPECT_MSG_EQ(usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+/**
+ * Write the known packets to a file, with the current write mode of the file.
+ *
+ * \param f the file
+ * \param filename the name of the file
+ * \param nanosecMode whether the timestamps are in nanoseconds
+ * \return true if an operation on the file failed
+ */
+static bool
+WriteKnownPackets(PcapFile& f, std::string filename, bool nanosecMode = false)
+{
+    f.Open(filename, std::ios::out);
+    f.Init(1, N_PACKET_BYTES, PcapFile::ZONE_DEFAULT, false, nanosecMode);
+    for (uint32_t i = 0; i < N_KNOWN_PACKETS; ++i)
+    {
+        const PacketEntry& p = knownPackets[i];
+        f.Write(p.tsSec, p.tsUsec, (const uint8_t*)p.data, p.origLen);
+    }
+    bool fail = f.Fail();
+    f.Close();
+    return fail;
+}
+
+/**
+ * Read the content of a file.
+ *
+ * \param filename the name of the file
+ * \return the bytes of the file
+ */
+static std::vector<uint8_t>
+ReadFileBytes(std::string filename)
+{
+    std::ifstream in(filename, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(in),
+                                std::istreambuf_iterator<char>());
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that the buffered writes, synchronous or
+ * asynchronous, produce the same file as the default writes.
+ */
+class BufferedWriteTestCase : public TestCase
+{
+  public:
+    BufferedWriteTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+BufferedWriteTestCase::BufferedWriteTestCase()
+    : TestCase("Check that the buffered writes produce the same file as the default writes")
+{
+}
+
+void
+BufferedWriteTestCase::DoRun()
+{
+    std::string reference = CreateTempDirFilename("reference.pcap");
+    PcapFile f;
+    NS_TEST_ASSERT_MSG_EQ(WriteKnownPackets(f, reference), false, "Default write fails");
+    std::vector<uint8_t> expected = ReadFileBytes(reference);
+
+    for (bool async : {false, true})
+    {
+        // a buffer smaller than a record is written, or handed to the I/O
+        // thread, for every record
+        for (uint32_t bufferSize : {8U, 1048576U})
+        {
+            std::string filename = CreateTempDirFilename("buffered.pcap");
+            PcapFile g;
+            g.SetWriteMode(PcapFile::PCAP, PcapFile::NO_COMPRESSION, async, bufferSize);
+            NS_TEST_ASSERT_MSG_EQ(WriteKnownPackets(g, filename), false, "Buffered write fails");
+            NS_TEST_EXPECT_MSG_EQ((ReadFileBytes(filename) == expected),
+                                  true,
+                                  "Buffered write (async " << async << ", buffer " << bufferSize
+                                                           << ") differs from default write");
+
+            uint32_t sec(0);
+            uint32_t usec(0);
+            uint32_t packets(0);
+            bool diff = PcapFile::Diff(reference, filename, sec, usec, packets);
+            NS_TEST_EXPECT_MSG_EQ(diff, false, "Buffered write is not a valid pcap file");
+            NS_TEST_EXPECT_MSG_EQ(packets, N_KNOWN_PACKETS, "Wrong number of packets");
+        }
+    }
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that several PcapFile objects can write to
+ * the same pcapng file, each one as a separate interface.
+ */
+class PcapNgTestCase : public TestCase
+{
+  public:
+    PcapNgTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+PcapNgTestCase::PcapNgTestCase()
+    : TestCase("Check that several PcapFile objects can share a pcapng file")
+{
+}
+
+void
+PcapNgTestCase::DoRun()
+{
+    std::string filename = CreateTempDirFilename("shared.pcapng");
+
+    PcapFile f[2];
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        f[i].SetWriteMode(PcapFile::PCAPNG, PcapFile::NO_COMPRESSION, i == 1);
+        f[i].Open(filename, std::ios::out);
+        f[i].Init(1, N_PACKET_BYTES, PcapFile::ZONE_DEFAULT, false, i == 1);
+        NS_TEST_ASSERT_MSG_EQ(f[i].Fail(), false, "Init of interface " << i << " fails");
+    }
+    for (uint32_t i = 0; i < N_KNOWN_PACKETS; ++i)
+    {
+        const PacketEntry& p = knownPackets[i];
+        f[i % 2].Write(p.tsSec, p.tsUsec, (const uint8_t*)p.data, p.origLen);
+    }
+    NS_TEST_ASSERT_MSG_EQ(f[0].Fail() || f[1].Fail(), false, "Write fails");
+    // the file is written when both objects are closed
+    f[0].Close();
+    f[1].Close();
+
+    //
+    // Walk through the blocks of the file: a section header, the two
+    // interface descriptions, then an enhanced packet block per packet.
+    //
+    std::vector<uint8_t> bytes = ReadFileBytes(filename);
+    auto u32 = [&bytes](std::size_t offset) {
+        uint32_t val;
+        std::memcpy(&val, &bytes[offset], sizeof(val));
+        return val;
+    };
+    std::vector<uint32_t> types;
+    std::size_t offset = 0;
+    uint32_t packet = 0;
+    while (offset + 12 <= bytes.size())
+    {
+        uint32_t type = u32(offset);
+        uint32_t len = u32(offset + 4);
+        NS_TEST_ASSERT_MSG_EQ(len % 4, 0, "Block length not a multiple of 4");
+        NS_TEST_ASSERT_MSG_LT_OR_EQ(offset + len, bytes.size(), "Block beyond the end of file");
+        NS_TEST_ASSERT_MSG_EQ(u32(offset + len - 4), len, "Trailing block length mismatch");
+        types.push_back(type);
+        if (type == 0x0a0d0d0a)
+        {
+            NS_TEST_EXPECT_MSG_EQ(u32(offset + 8), 0x1a2b3c4d, "Wrong byte order magic");
+        }
+        else if (type == 6)
+        {
+            const PacketEntry& p = knownPackets[packet];
+            uint64_t ts = (uint64_t(u32(offset + 12)) << 32) | u32(offset + 16);
+            uint64_t expectedTs = uint64_t(p.tsSec) * (packet % 2 ? 1000000000 : 1000000);
+            NS_TEST_EXPECT_MSG_EQ(u32(offset + 8), packet % 2, "Wrong interface");
+            NS_TEST_EXPECT_MSG_EQ(ts, expectedTs + p.tsUsec, "Wrong timestamp");
+            NS_TEST_EXPECT_MSG_EQ(u32(offset + 20), N_PACKET_BYTES, "Wrong captured length");
+            NS_TEST_EXPECT_MSG_EQ(u32(offset + 24), p.origLen, "Wrong original length");
+            NS_TEST_EXPECT_MSG_EQ(std::memcmp(&bytes[offset + 28], p.data, N_PACKET_BYTES),
+                                  0,
+                                  "Wrong packet data");
+            packet++;
+        }
+        offset += len;
+    }
+    NS_TEST_EXPECT_MSG_EQ(offset, bytes.size(), "Trailing data after the last block");
+    std::vector<uint32_t> expectedTypes = {0x0a0d0d0a, 1, 1, 6, 6, 6, 6, 6, 6};
+    NS_TEST_EXPECT_MSG_EQ((types == expectedTypes), true, "Wrong blocks in the pcapng file");
+}
+
+#ifdef HAVE_ZLIB
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that the gzip compressed files hold the
+ * same pcap file as the default writes.
+ */
+class GzipWriteTestCase : public TestCase
+{
+  public:
+    GzipWriteTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+GzipWriteTestCase::GzipWriteTestCase()
+    : TestCase("Check that the compressed files decompress to the default writes")
+{
+}
+
+void
+GzipWriteTestCase::DoRun()
+{
+    std::string reference = CreateTempDirFilename("reference.pcap");
+    PcapFile f;
+    NS_TEST_ASSERT_MSG_EQ(WriteKnownPackets(f, reference), false, "Default write fails");
+    std::vector<uint8_t> expected = ReadFileBytes(reference);
+
+    for (bool async : {false, true})
+    {
+        std::string filename = CreateTempDirFilename("compressed.pcap.gz");
+        PcapFile g;
+        g.SetWriteMode(PcapFile::PCAP, PcapFile::GZIP, async, 64);
+        NS_TEST_ASSERT_MSG_EQ(WriteKnownPackets(g, filename), false, "Compressed write fails");
+
+        gzFile in = gzopen(filename.c_str(), "rb");
+        NS_TEST_ASSERT_MSG_NE(in, nullptr, "Cannot open the compressed file");
+        std::vector<uint8_t> bytes(expected.size() + 1);
+        int len = gzread(in, bytes.data(), bytes.size());
+        gzclose(in);
+        bytes.resize(std::max(len, 0));
+        NS_TEST_EXPECT_MSG_EQ((bytes == expected),
+                              true,
+                              "Compressed write (async " << async
+                                                         << ") differs from default write");
+    }
+}
+#endif
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1398,6 +1637,11 @@ PcapFileTestSuite::PcapFileTestSuite()
     AddTestCase(new RecordHeaderTestCase, TestCase::QUICK);
     AddTestCase(new ReadFileTestCase, TestCase::QUICK);
     AddTestCase(new DiffTestCase, TestCase::QUICK);
+    AddTestCase(new BufferedWriteTestCase, TestCase::QUICK);
+    AddTestCase(new PcapNgTestCase, TestCase::QUICK);
+#ifdef HAVE_ZLIB
+    AddTestCase(new GzipWriteTestCase, TestCase::QUICK);
+#endif
 }
 
 static PcapFileTestSuite pcapFileTestSuite; //!< Static variable for test initialization
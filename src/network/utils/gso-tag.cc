@@ -0,0 +1,101 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "gso-tag.h"
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(GsoTag);
+
+GsoTag::GsoTag()
+    : m_segmentSize(0),
+      m_headerSize(0)
+{
+}
+
+GsoTag::GsoTag(uint16_t segmentSize, uint16_t headerSize)
+    : m_segmentSize(segmentSize),
+      m_headerSize(headerSize)
+{
+}
+
+void
+GsoTag::SetSegmentSize(uint16_t segmentSize)
+{
+    m_segmentSize = segmentSize;
+}
+
+uint16_t
+GsoTag::GetSegmentSize() const
+{
+    return m_segmentSize;
+}
+
+void
+GsoTag::SetHeaderSize(uint16_t headerSize)
+{
+    m_headerSize = headerSize;
+}
+
+uint16_t
+GsoTag::GetHeaderSize() const
+{
+    return m_headerSize;
+}
+
+TypeId
+GsoTag::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::GsoTag")
+                            .SetParent<Tag>()
+                            .SetGroupName("Network")
+                            .AddConstructor<GsoTag>();
+    return tid;
+}
+
+TypeId
+GsoTag::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+uint32_t
+GsoTag::GetSerializedSize() const
+{
+    return 2 * sizeof(uint16_t);
+}
+
+void
+GsoTag::Serialize(TagBuffer i) const
+{
+    i.WriteU16(m_segmentSize);
+    i.WriteU16(m_headerSize);
+}
+
+void
+GsoTag::Deserialize(TagBuffer i)
+{
+    m_segmentSize = i.ReadU16();
+    m_headerSize = i.ReadU16();
+}
+
+void
+GsoTag::Print(std::ostream& os) const
+{
+    os << "GsoTag [SegmentSize: " << m_segmentSize << ", HeaderSize: " << m_headerSize << "]";
+}
+
+} // namespace ns3
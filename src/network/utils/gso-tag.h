@@ -0,0 +1,94 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef GSO_TAG_H
+#define GSO_TAG_H
+
+#include "ns3/tag.h"
+
+namespace ns3
+{
+
+/**
+ * \ingroup network
+ *
+ * \brief Tag marking a super-segment built by an emulated generic
+ * segmentation offload (GSO).
+ *
+ * A super-segment carries the payload of several consecutive segments behind
+ * a single transport header. The tag carries the size of the transport header
+ * and the size of the payload of each segment (the last one may be smaller).
+ * A super-segment crosses the network layer and the traffic control layer as
+ * a single packet, and is split by the GSO callback of the
+ * NetDeviceQueueInterface of the output device, see
+ * NetDeviceQueueInterface::SplitGso.
+ */
+class GsoTag : public Tag
+{
+  public:
+    GsoTag();
+
+    /**
+     * \brief Constructor
+     * \param segmentSize the payload size of the segments
+     * \param headerSize the size of the transport header
+     */
+    GsoTag(uint16_t segmentSize, uint16_t headerSize);
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Set the payload size of the segments
+     * \param segmentSize the payload size of the segments
+     */
+    void SetSegmentSize(uint16_t segmentSize);
+
+    /**
+     * \brief Get the payload size of the segments
+     * \returns the payload size of the segments
+     */
+    uint16_t GetSegmentSize() const;
+
+    /**
+     * \brief Set the size of the transport header
+     * \param headerSize the size of the transport header
+     */
+    void SetHeaderSize(uint16_t headerSize);
+
+    /**
+     * \brief Get the size of the transport header
+     * \returns the size of the transport header
+     */
+    uint16_t GetHeaderSize() const;
+
+    // inherited functions, no doc necessary
+    TypeId GetInstanceTypeId() const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(TagBuffer i) const override;
+    void Deserialize(TagBuffer i) override;
+    void Print(std::ostream& os) const override;
+
+  private:
+    uint16_t m_segmentSize; //!< the payload size of the segments
+    uint16_t m_headerSize;  //!< the size of the transport header
+};
+
+} // namespace ns3
+
+#endif /* GSO_TAG_H */
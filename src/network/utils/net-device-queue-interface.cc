@@ -20,6 +20,7 @@
 #include "ns3/net-device-queue-interface.h"
 
 #include "ns3/abort.h"
+#include "ns3/gso-tag.h"
 #include "ns3/queue-item.h"
 #include "ns3/queue-limits.h"
 #include "ns3/uinteger.h"
@@ -228,6 +229,7 @@ NetDeviceQueueInterface::DoDispose()
     NS_LOG_FUNCTION(this);
 
     m_txQueuesVector.clear();
+    m_gsoCallbacks.clear();
     Object::DoDispose();
 }
 
@@ -284,4 +286,35 @@ NetDeviceQueueInterface::GetSelectQueueCallback() const
     return m_selectQueueCallback;
 }
 
+void
+NetDeviceQueueInterface::SetGsoCallback(uint16_t protocol, GsoCallback cb)
+{
+    NS_LOG_FUNCTION(this << protocol);
+    m_gsoCallbacks[protocol] = cb;
+}
+
+bool
+NetDeviceQueueInterface::HasGsoCallback(uint16_t protocol) const
+{
+    return m_gsoCallbacks.find(protocol) != m_gsoCallbacks.end();
+}
+
+std::vector<Ptr<QueueDiscItem>>
+NetDeviceQueueInterface::SplitGso(Ptr<QueueDiscItem> item) const
+{
+    if (m_gsoCallbacks.empty())
+    {
+        return {};
+    }
+    auto it = m_gsoCallbacks.find(item->GetProtocol());
+    GsoTag gsoTag;
+    if (it == m_gsoCallbacks.end() || !item->GetPacket()->PeekPacketTag(gsoTag))
+    {
+        return {};
+    }
+    NS_LOG_DEBUG("Split super-segment " << item << " in " << gsoTag.GetSegmentSize()
+                                        << " bytes segments");
+    return it->second(item);
+}
+
 } // namespace ns3
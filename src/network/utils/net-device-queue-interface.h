@@ -28,6 +28,7 @@
 #include "ns3/simulator.h"
 
 #include <functional>
+#include <map>
 #include <vector>
 
 namespace ns3
@@ -36,6 +37,7 @@ namespace ns3
 class QueueLimits;
 class NetDeviceQueueInterface;
 class QueueItem;
+class QueueDiscItem;
 
 /**
  * \ingroup network
@@ -299,6 +301,40 @@ class NetDeviceQueueInterface : public Object
      */
     SelectQueueCallback GetSelectQueueCallback() const;
 
+    /// Callback invoked to split a super-segment into the segments it carries
+    typedef std::function<std::vector<Ptr<QueueDiscItem>>(Ptr<QueueDiscItem>)> GsoCallback;
+
+    /**
+     * \brief Set the GSO callback for the given protocol.
+     * \param protocol the L3 protocol number of the items to split.
+     * \param cb the callback to set.
+     *
+     * This method is called by the network layer protocols to set the method
+     * used to split their super-segments (packets marked with a GsoTag), so that
+     * a super-segment crosses the traffic control layer as a single item and
+     * the device receives the segments it carries.
+     */
+    void SetGsoCallback(uint16_t protocol, GsoCallback cb);
+
+    /**
+     * \brief Check whether a GSO callback is set for the given protocol.
+     * \param protocol the L3 protocol number.
+     * \return true if a GSO callback is set for the given protocol.
+     */
+    bool HasGsoCallback(uint16_t protocol) const;
+
+    /**
+     * \brief Split a super-segment into the segments it carries.
+     * \param item the item to split, before its header is added.
+     * \return the items of the segments, in order, or an empty vector if the
+     *         item is not a super-segment.
+     *
+     * Called by the traffic control layer before handing an item to the device.
+     * The items returned have the address, the protocol and the transmission
+     * queue index of the item to split, and their header is not added yet.
+     */
+    std::vector<Ptr<QueueDiscItem>> SplitGso(Ptr<QueueDiscItem> item) const;
+
   protected:
     /**
      * \brief Dispose of the object
@@ -313,6 +349,7 @@ class NetDeviceQueueInterface : public Object
     ObjectFactory m_txQueues;                          //!< Device transmission queues TypeId
     std::vector<Ptr<NetDeviceQueue>> m_txQueuesVector; //!< Device transmission queues
     SelectQueueCallback m_selectQueueCallback;         //!< Select queue callback
+    std::map<uint16_t, GsoCallback> m_gsoCallbacks;    //!< GSO callbacks, per protocol
 };
 
 /**
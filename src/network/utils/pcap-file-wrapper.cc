@@ -19,6 +19,7 @@
 
 #include "ns3/boolean.h"
 #include "ns3/buffer.h"
+#include "ns3/enum.h"
 #include "ns3/header.h"
 #include "ns3/log.h"
 #include "ns3/uinteger.h"
@@ -48,7 +49,30 @@ PcapFileWrapper::GetTypeId()
                           "microseconds(default).",
                           BooleanValue(false),
                           MakeBooleanAccessor(&PcapFileWrapper::m_nanosecMode),
-                          MakeBooleanChecker());
+                          MakeBooleanChecker())
+            .AddAttribute("Format",
+                          "Format of the written file.  The pcapng files opened by several "
+                          "wrappers are shared, each wrapper writing a separate interface.",
+                          EnumValue(PcapFile::PCAP),
+                          MakeEnumAccessor(&PcapFileWrapper::m_format),
+                          MakeEnumChecker(PcapFile::PCAP, "Pcap", PcapFile::PCAPNG, "PcapNg"))
+            .AddAttribute("Compression",
+                          "Compression of the written file (Gzip requires zlib support).",
+                          EnumValue(PcapFile::NO_COMPRESSION),
+                          MakeEnumAccessor(&PcapFileWrapper::m_compression),
+                          MakeEnumChecker(PcapFile::NO_COMPRESSION, "None", PcapFile::GZIP, "Gzip"))
+            .AddAttribute("AsyncWrite",
+                          "Whether the written file is buffered and written by a background "
+                          "I/O thread, instead of by the simulation.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&PcapFileWrapper::m_asyncWrite),
+                          MakeBooleanChecker())
+            .AddAttribute("BufferSize",
+                          "Size of the buffers of a written file that is not a plain and "
+                          "synchronously written pcap file.",
+                          UintegerValue(PcapFile::BUFFER_SIZE_DEFAULT),
+                          MakeUintegerAccessor(&PcapFileWrapper::m_bufferSize),
+                          MakeUintegerChecker<uint32_t>(1));
     return tid;
 }
 
@@ -95,6 +119,10 @@ void
 PcapFileWrapper::Open(const std::string& filename, std::ios::openmode mode)
 {
     NS_LOG_FUNCTION(this << filename << mode);
+    if (!(mode & std::ios::in))
+    {
+        m_file.SetWriteMode(m_format, m_compression, m_asyncWrite, m_bufferSize);
+    }
     m_file.Open(filename, mode);
 }
 
@@ -222,9 +222,13 @@ class PcapFileWrapper : public Object
     uint32_t GetDataLinkType();
 
   private:
-    PcapFile m_file;    //!< Pcap file
-    uint32_t m_snapLen; //!< max length of saved packets
-    bool m_nanosecMode; //!< Timestamps in nanosecond mode
+    PcapFile m_file;                     //!< Pcap file
+    uint32_t m_snapLen;                  //!< max length of saved packets
+    bool m_nanosecMode;                  //!< Timestamps in nanosecond mode
+    PcapFile::Format m_format;           //!< Format of the written file
+    PcapFile::Compression m_compression; //!< Compression of the written file
+    bool m_asyncWrite;                   //!< Whether the file is written by an I/O thread
+    uint32_t m_bufferSize;               //!< Size of the write buffers
 };
 
 } // namespace ns3
@@ -19,6 +19,7 @@
 
 #include "pcap-file.h"
 
+#include "ns3/abort.h"
 #include "ns3/assert.h"
 #include "ns3/buffer.h"
 #include "ns3/build-profile.h"
@@ -28,8 +29,19 @@
 #include "ns3/log.h"
 #include "ns3/packet.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
 
 //
 // This file is used as part of the ns-3 test framework, so please refrain from
@@ -51,10 +63,279 @@ const uint32_t NS_SWAPPED_MAGIC = 0x4d3cb2a1; /**< Looks this way if byte swappi
 const uint16_t VERSION_MAJOR = 2; /**< Major version of supported pcap file format */
 const uint16_t VERSION_MINOR = 4; /**< Minor version of supported pcap file format */
 
+const uint32_t PCAPNG_SHB_TYPE = 0x0a0d0d0a; /**< Type of the pcapng Section Header Block */
+const uint32_t PCAPNG_IDB_TYPE = 1; /**< Type of the pcapng Interface Description Block */
+const uint32_t PCAPNG_EPB_TYPE = 6; /**< Type of the pcapng Enhanced Packet Block */
+const uint32_t PCAPNG_BYTE_ORDER_MAGIC = 0x1a2b3c4d; /**< Byte order magic of pcapng sections */
+const uint16_t PCAPNG_VERSION_MAJOR = 1; /**< Major version of the written pcapng files */
+const uint16_t PCAPNG_VERSION_MINOR = 0; /**< Minor version of the written pcapng files */
+
+/**
+ * \brief Buffered writer of a file
+ *
+ * The data is appended to a buffer, which is written to the file when it is
+ * full and when the writer is destroyed.  In the asynchronous mode, the full
+ * buffers are handed to a background I/O thread, which writes (and
+ * compresses) them while the simulation goes on; the simulation waits only
+ * when the thread is MAX_PENDING buffers behind.  The buffers written by the
+ * thread are reused.
+ */
+class PcapFile::Writer
+{
+  public:
+    /**
+     * Open the file for writing, discarding its content
+     *
+     * \param filename the name of the file
+     * \param compression the compression of the file
+     * \param async whether the buffers are written by a background I/O thread
+     * \param bufferSize the size of the buffers
+     */
+    Writer(const std::string& filename, Compression compression, bool async, uint32_t bufferSize);
+    /**
+     * Write the buffered data and close the file
+     */
+    ~Writer();
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    /**
+     * \return true if the file could not be opened or written
+     */
+    bool Fail() const;
+
+    /**
+     * \brief Append data to the buffer
+     *
+     * \param size the size of the data
+     * \return the place where the data has to be copied
+     */
+    uint8_t* Reserve(uint32_t size);
+
+    /**
+     * \brief Append data to the buffer
+     *
+     * \param data the data
+     * \param size the size of the data
+     */
+    void Write(const void* data, uint32_t size);
+
+    /**
+     * \brief Add an interface to a pcapng file
+     *
+     * \return the identifier of the interface
+     */
+    uint32_t AddInterface();
+
+  private:
+    /// Maximum number of buffers waiting for the I/O thread
+    static const std::size_t MAX_PENDING = 4;
+
+    /**
+     * \brief Write the buffer to the file, or hand it to the I/O thread
+     */
+    void Submit();
+
+    /**
+     * \brief Write a buffer to the file
+     *
+     * \param buffer the buffer
+     */
+    void Output(const std::vector<uint8_t>& buffer);
+
+    /**
+     * \brief Main loop of the I/O thread
+     */
+    void Run();
+
+    std::ofstream m_stream; //!< Stream of the file, if it is not compressed
+#ifdef HAVE_ZLIB
+    gzFile m_gzFile; //!< Compressed file, if any
+#endif
+    uint32_t m_bufferSize;                      //!< Size of the buffers
+    std::vector<uint8_t> m_buffer;              //!< Buffer being filled
+    std::atomic<bool> m_fail;                   //!< Whether an error occurred
+    uint32_t m_nInterfaces;                     //!< Number of pcapng interfaces
+    bool m_async;                               //!< Whether there is an I/O thread
+    std::thread m_thread;                       //!< The I/O thread
+    std::mutex m_mutex;                         //!< Protects the following members
+    std::condition_variable m_cvWork;           //!< Signals buffers to the I/O thread
+    std::condition_variable m_cvDone;           //!< Signals written buffers
+    std::deque<std::vector<uint8_t>> m_pending; //!< Buffers waiting for the I/O thread
+    std::vector<std::vector<uint8_t>> m_free;   //!< Written buffers, to be reused
+    bool m_stop;                                //!< Whether the I/O thread has to exit
+};
+
+PcapFile::Writer::Writer(const std::string& filename,
+                         Compression compression,
+                         bool async,
+                         uint32_t bufferSize)
+    : m_bufferSize(bufferSize),
+      m_fail(false),
+      m_nInterfaces(0),
+      m_async(async),
+      m_stop(false)
+{
+    NS_LOG_FUNCTION(this << filename << compression << async << bufferSize);
+#ifdef HAVE_ZLIB
+    m_gzFile = nullptr;
+    if (compression == GZIP)
+    {
+        m_gzFile = gzopen(filename.c_str(), "wb");
+        m_fail = (m_gzFile == nullptr);
+    }
+    else
+#endif
+    {
+        NS_ABORT_MSG_IF(compression != NO_COMPRESSION, "Compression requires zlib support");
+        m_stream.open(filename, std::ios::out | std::ios::trunc | std::ios::binary);
+        m_fail = m_stream.fail();
+    }
+    m_buffer.reserve(m_bufferSize);
+    if (m_async)
+    {
+        m_thread = std::thread(&Writer::Run, this);
+    }
+}
+
+PcapFile::Writer::~Writer()
+{
+    NS_LOG_FUNCTION(this);
+    Submit();
+    if (m_async)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_cvWork.notify_one();
+        m_thread.join();
+    }
+#ifdef HAVE_ZLIB
+    if (m_gzFile != nullptr)
+    {
+        gzclose(m_gzFile);
+    }
+#endif
+    m_stream.close();
+}
+
+bool
+PcapFile::Writer::Fail() const
+{
+    return m_fail;
+}
+
+uint8_t*
+PcapFile::Writer::Reserve(uint32_t size)
+{
+    std::size_t used = m_buffer.size();
+    if (used + size > m_bufferSize && used > 0)
+    {
+        Submit();
+        used = 0;
+    }
+    m_buffer.resize(used + size);
+    return m_buffer.data() + used;
+}
+
+void
+PcapFile::Writer::Write(const void* data, uint32_t size)
+{
+    std::memcpy(Reserve(size), data, size);
+}
+
+uint32_t
+PcapFile::Writer::AddInterface()
+{
+    return m_nInterfaces++;
+}
+
+void
+PcapFile::Writer::Submit()
+{
+    if (m_buffer.empty())
+    {
+        return;
+    }
+    if (!m_async)
+    {
+        Output(m_buffer);
+        m_buffer.clear();
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cvDone.wait(lock, [this] { return m_pending.size() < MAX_PENDING; });
+    m_pending.push_back(std::move(m_buffer));
+    if (m_free.empty())
+    {
+        m_buffer = std::vector<uint8_t>();
+        m_buffer.reserve(m_bufferSize);
+    }
+    else
+    {
+        m_buffer = std::move(m_free.back());
+        m_free.pop_back();
+    }
+    lock.unlock();
+    m_cvWork.notify_one();
+}
+
+void
+PcapFile::Writer::Output(const std::vector<uint8_t>& buffer)
+{
+    if (m_fail)
+    {
+        return;
+    }
+#ifdef HAVE_ZLIB
+    if (m_gzFile != nullptr)
+    {
+        int written = gzwrite(m_gzFile, buffer.data(), buffer.size());
+        m_fail = (written != static_cast<int>(buffer.size()));
+        return;
+    }
+#endif
+    m_stream.write((const char*)buffer.data(), buffer.size());
+    m_fail = m_stream.fail();
+}
+
+void
+PcapFile::Writer::Run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_cvWork.wait(lock, [this] { return m_stop || !m_pending.empty(); });
+        if (m_pending.empty())
+        {
+            break;
+        }
+        std::vector<uint8_t> buffer = std::move(m_pending.front());
+        m_pending.pop_front();
+        lock.unlock();
+
+        Output(buffer);
+        buffer.clear();
+
+        lock.lock();
+        m_free.push_back(std::move(buffer));
+        m_cvDone.notify_one();
+    }
+}
+
 PcapFile::PcapFile()
     : m_file(),
       m_swapMode(false),
-      m_nanosecMode(false)
+      m_nanosecMode(false),
+      m_format(PCAP),
+      m_compression(NO_COMPRESSION),
+      m_async(false),
+      m_bufferSize(BUFFER_SIZE_DEFAULT),
+      m_interfaceId(0)
 {
     NS_LOG_FUNCTION(this);
     FatalImpl::RegisterStream(&m_file);
@@ -67,10 +348,28 @@ PcapFile::~PcapFile()
     Close();
 }
 
+void
+PcapFile::SetWriteMode(Format format, Compression compression, bool async, uint32_t bufferSize)
+{
+    NS_LOG_FUNCTION(this << format << compression << async << bufferSize);
+#ifndef HAVE_ZLIB
+    NS_ABORT_MSG_IF(compression != NO_COMPRESSION, "Compression requires zlib support");
+#endif
+    NS_ABORT_MSG_IF(bufferSize == 0, "The buffer size must be positive");
+    m_format = format;
+    m_compression = compression;
+    m_async = async;
+    m_bufferSize = bufferSize;
+}
+
 bool
 PcapFile::Fail() const
 {
     NS_LOG_FUNCTION(this);
+    if (m_writer)
+    {
+        return m_writer->Fail();
+    }
     return m_file.fail();
 }
 
@@ -92,6 +391,8 @@ void
 PcapFile::Close()
 {
     NS_LOG_FUNCTION(this);
+    // the file of a writer is closed when the last PcapFile sharing it is closed
+    m_writer = nullptr;
     m_file.close();
 }
 
@@ -209,9 +510,12 @@ PcapFile::WriteFileHeader()
     NS_LOG_FUNCTION(this);
     //
     // If we're initializing the file, we need to write the pcap file header
-    // at the start of the file.
+    // at the start of the file.  A buffered writer is at the start of the file.
     //
-    m_file.seekp(0, std::ios::beg);
+    if (!m_writer)
+    {
+        m_file.seekp(0, std::ios::beg);
+    }
 
     //
     // We have the ability to write out the pcap file header in a foreign endian
@@ -239,13 +543,72 @@ PcapFile::WriteFileHeader()
     // Watch out for memory alignment differences between machines, so write
     // them all individually.
     //
-    m_file.write((const char*)&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
-    m_file.write((const char*)&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
-    m_file.write((const char*)&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
-    m_file.write((const char*)&headerOut->m_zone, sizeof(headerOut->m_zone));
-    m_file.write((const char*)&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
-    m_file.write((const char*)&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
-    m_file.write((const char*)&headerOut->m_type, sizeof(headerOut->m_type));
+    WriteData(&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
+    WriteData(&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
+    WriteData(&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
+    WriteData(&headerOut->m_zone, sizeof(headerOut->m_zone));
+    WriteData(&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
+    WriteData(&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
+    WriteData(&headerOut->m_type, sizeof(headerOut->m_type));
+}
+
+void
+PcapFile::WriteSectionHeader()
+{
+    NS_LOG_FUNCTION(this);
+    //
+    // The blocks of a pcapng file are written in the byte order of the running
+    // system, which the readers find out from the byte order magic.
+    //
+    const uint32_t blockLen = 28;
+    const uint32_t sectionLen = 0xffffffff; // unspecified (-1) section length
+    WriteData(&PCAPNG_SHB_TYPE, sizeof(PCAPNG_SHB_TYPE));
+    WriteData(&blockLen, sizeof(blockLen));
+    WriteData(&PCAPNG_BYTE_ORDER_MAGIC, sizeof(PCAPNG_BYTE_ORDER_MAGIC));
+    WriteData(&PCAPNG_VERSION_MAJOR, sizeof(PCAPNG_VERSION_MAJOR));
+    WriteData(&PCAPNG_VERSION_MINOR, sizeof(PCAPNG_VERSION_MINOR));
+    WriteData(&sectionLen, sizeof(sectionLen));
+    WriteData(&sectionLen, sizeof(sectionLen));
+    WriteData(&blockLen, sizeof(blockLen));
+}
+
+void
+PcapFile::WriteInterfaceDescription()
+{
+    NS_LOG_FUNCTION(this);
+    //
+    // The timestamps are in microseconds unless the if_tsresol option says
+    // they are in nanoseconds.
+    //
+    const uint32_t blockLen = m_nanosecMode ? 32 : 20;
+    const uint16_t linkType = m_fileHeader.m_type;
+    const uint16_t reserved = 0;
+    WriteData(&PCAPNG_IDB_TYPE, sizeof(PCAPNG_IDB_TYPE));
+    WriteData(&blockLen, sizeof(blockLen));
+    WriteData(&linkType, sizeof(linkType));
+    WriteData(&reserved, sizeof(reserved));
+    WriteData(&m_fileHeader.m_snapLen, sizeof(m_fileHeader.m_snapLen));
+    if (m_nanosecMode)
+    {
+        // if_tsresol (code 9, length 1, 10^-9 s, padded), then opt_endofopt
+        const uint8_t options[] = {9, 0, 1, 0, 9, 0, 0, 0, 0, 0, 0, 0};
+        WriteData(options, sizeof(options));
+    }
+    WriteData(&blockLen, sizeof(blockLen));
+    m_interfaceId = m_writer->AddInterface();
+}
+
+void
+PcapFile::WriteData(const void* data, uint32_t size)
+{
+    if (m_writer)
+    {
+        m_writer->Write(data, size);
+    }
+    else
+    {
+        m_file.write((const char*)data, size);
+    }
 }
 
 void
@@ -339,6 +702,29 @@ PcapFile::Open(const std::string& filename, std::ios::openmode mode)
     mode |= std::ios::binary;
 
     m_filename = filename;
+    if (m_format != PCAP || m_compression != NO_COMPRESSION || m_async)
+    {
+        NS_ABORT_MSG_IF(mode & std::ios::in, "Only uncompressed pcap files can be read");
+        //
+        // The PcapFile objects opening the same pcapng file share its writer,
+        // which is closed by the last one.
+        //
+        static std::map<std::string, std::weak_ptr<Writer>> sharedWriters;
+        if (m_format == PCAPNG)
+        {
+            m_writer = sharedWriters[filename].lock();
+        }
+        if (!m_writer)
+        {
+            m_writer = std::make_shared<Writer>(filename, m_compression, m_async, m_bufferSize);
+            if (m_format == PCAPNG)
+            {
+                sharedWriters[filename] = m_writer;
+                WriteSectionHeader();
+            }
+        }
+        return;
+    }
     m_file.open(filename, mode);
     if (mode & std::ios::in)
     {
@@ -406,17 +792,42 @@ PcapFile::Init(uint32_t dataLinkType,
     //
     m_swapMode = swapMode | bigEndian;
 
-    WriteFileHeader();
+    if (m_format == PCAPNG)
+    {
+        m_fileHeader.m_magicNumber = PCAPNG_SHB_TYPE;
+        m_fileHeader.m_versionMajor = PCAPNG_VERSION_MAJOR;
+        m_fileHeader.m_versionMinor = PCAPNG_VERSION_MINOR;
+        m_swapMode = false;
+        WriteInterfaceDescription();
+    }
+    else
+    {
+        WriteFileHeader();
+    }
 }
 
 uint32_t
 PcapFile::WritePacketHeader(uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
 {
     NS_LOG_FUNCTION(this << tsSec << tsUsec << totalLen);
-    NS_ASSERT(m_file.good());
+    NS_ASSERT(m_writer ? !m_writer->Fail() : m_file.good());
 
     uint32_t inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
 
+    if (m_format == PCAPNG)
+    {
+        uint64_t ts = uint64_t(tsSec) * (m_nanosecMode ? 1000000000 : 1000000) + tsUsec;
+        uint32_t block[] = {PCAPNG_EPB_TYPE,
+                            32 + ((inclLen + 3) & ~3U),
+                            m_interfaceId,
+                            uint32_t(ts >> 32),
+                            uint32_t(ts),
+                            inclLen,
+                            totalLen};
+        WriteData(block, sizeof(block));
+        return inclLen;
+    }
+
     PcapRecordHeader header;
     header.m_tsSec = tsSec;
     header.m_tsUsec = tsUsec;
@@ -432,21 +843,40 @@ PcapFile::WritePacketHeader(uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
     // Watch out for memory alignment differences between machines, so write
     // them all individually.
     //
-    m_file.write((const char*)&header.m_tsSec, sizeof(header.m_tsSec));
-    m_file.write((const char*)&header.m_tsUsec, sizeof(header.m_tsUsec));
-    m_file.write((const char*)&header.m_inclLen, sizeof(header.m_inclLen));
-    m_file.write((const char*)&header.m_origLen, sizeof(header.m_origLen));
-    NS_BUILD_DEBUG(m_file.flush());
+    WriteData(&header.m_tsSec, sizeof(header.m_tsSec));
+    WriteData(&header.m_tsUsec, sizeof(header.m_tsUsec));
+    WriteData(&header.m_inclLen, sizeof(header.m_inclLen));
+    WriteData(&header.m_origLen, sizeof(header.m_origLen));
+    if (!m_writer)
+    {
+        NS_BUILD_DEBUG(m_file.flush());
+    }
     return inclLen;
 }
 
+void
+PcapFile::WritePacketTrailer(uint32_t inclLen)
+{
+    if (m_format == PCAPNG)
+    {
+        const uint8_t padding[3] = {0, 0, 0};
+        uint32_t blockLen = 32 + ((inclLen + 3) & ~3U);
+        WriteData(padding, blockLen - 32 - inclLen);
+        WriteData(&blockLen, sizeof(blockLen));
+    }
+    else if (!m_writer)
+    {
+        NS_BUILD_DEBUG(m_file.flush());
+    }
+}
+
 void
 PcapFile::Write(uint32_t tsSec, uint32_t tsUsec, const uint8_t* const data, uint32_t totalLen)
 {
     NS_LOG_FUNCTION(this << tsSec << tsUsec << &data << totalLen);
     uint32_t inclLen = WritePacketHeader(tsSec, tsUsec, totalLen);
-    m_file.write((const char*)data, inclLen);
-    NS_BUILD_DEBUG(m_file.flush());
+    WriteData(data, inclLen);
+    WritePacketTrailer(inclLen);
 }
 
 void
@@ -454,8 +884,15 @@ PcapFile::Write(uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(this << tsSec << tsUsec << p);
     uint32_t inclLen = WritePacketHeader(tsSec, tsUsec, p->GetSize());
-    p->CopyData(&m_file, inclLen);
-    NS_BUILD_DEBUG(m_file.flush());
+    if (m_writer)
+    {
+        p->CopyData(m_writer->Reserve(inclLen), inclLen);
+    }
+    else
+    {
+        p->CopyData(&m_file, inclLen);
+    }
+    WritePacketTrailer(inclLen);
 }
 
 void
@@ -470,9 +907,19 @@ PcapFile::Write(uint32_t tsSec, uint32_t tsUsec, const Header& header, Ptr<const
     headerBuffer.AddAtStart(headerSize);
     header.Serialize(headerBuffer.Begin());
     uint32_t toCopy = std::min(headerSize, inclLen);
-    headerBuffer.CopyData(&m_file, toCopy);
-    inclLen -= toCopy;
-    p->CopyData(&m_file, inclLen);
+    uint32_t left = inclLen - toCopy;
+    if (m_writer)
+    {
+        uint8_t* data = m_writer->Reserve(inclLen);
+        headerBuffer.CopyData(data, toCopy);
+        p->CopyData(data + toCopy, left);
+    }
+    else
+    {
+        headerBuffer.CopyData(&m_file, toCopy);
+        p->CopyData(&m_file, left);
+    }
+    WritePacketTrailer(inclLen);
 }
 
 void
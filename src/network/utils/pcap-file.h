@@ -23,6 +23,7 @@
 #include "ns3/ptr.h"
 
 #include <fstream>
+#include <memory>
 #include <stdint.h>
 #include <string>
 
@@ -38,6 +39,14 @@ class Header;
  * A class representing a pcap file.  This allows easy creation, writing and
  * reading of files composed of stored packets; which may be viewed using
  * standard tools.
+ *
+ * By default, a file is written through a std::fstream.  A file opened for
+ * writing can instead be written in large buffers, optionally drained by a
+ * background I/O thread, optionally compressed with gzip, and in the pcapng
+ * format (see SetWriteMode).  The pcapng files can be shared: the PcapFile
+ * objects that open the same file name in the pcapng format write to the same
+ * file, each one as a separate interface.  Only the pcap files that are not
+ * compressed can be read.
  */
 class PcapFile
 {
@@ -45,11 +54,46 @@ class PcapFile
     static const int32_t ZONE_DEFAULT = 0; //!< Time zone offset for current location
     static const uint32_t SNAPLEN_DEFAULT =
         65535; //!< Default value for maximum octets to save per packet
+    static const uint32_t BUFFER_SIZE_DEFAULT =
+        1048576; //!< Default size of the buffers of the written files
+
+    /// Format of the written file
+    enum Format
+    {
+        PCAP,   //!< Pcap file
+        PCAPNG, //!< Pcapng file, with an interface per PcapFile object
+    };
+
+    /// Compression of the written file
+    enum Compression
+    {
+        NO_COMPRESSION, //!< The file is not compressed
+        GZIP,           //!< The file is compressed with gzip (requires zlib)
+    };
 
   public:
     PcapFile();
     ~PcapFile();
 
+    /**
+     * \brief Set how the file is written
+     *
+     * This method must be called before opening the file.  Unless the format
+     * is PCAP, the file is not compressed and the writes are synchronous, the
+     * packets are written to a buffer of bufferSize bytes, which is written to
+     * the file when it is full and when the file is closed.
+     *
+     * \param format the format of the file
+     * \param compression the compression of the file
+     * \param async whether the buffers are written to the file by a background
+     * I/O thread, so that the simulation does not wait for the writes
+     * \param bufferSize the size of the buffers
+     */
+    void SetWriteMode(Format format,
+                      Compression compression = NO_COMPRESSION,
+                      bool async = false,
+                      uint32_t bufferSize = BUFFER_SIZE_DEFAULT);
+
     /**
      * \return true if the 'fail' bit is set in the underlying iostream, false otherwise.
      */
@@ -113,7 +157,8 @@ class PcapFile
      * system. Default to false.
      *
      * \warning Calling this method on an existing file will result in the loss
-     * any existing data.
+     * any existing data.  In the pcapng format, this method adds an interface
+     * to the file instead, and the swap mode is ignored.
      */
     void Init(uint32_t dataLinkType,
               uint32_t snapLen = SNAPLEN_DEFAULT,
@@ -293,6 +338,9 @@ class PcapFile
                      uint32_t snapLen = SNAPLEN_DEFAULT);
 
   private:
+    /// Buffered writer of a file, which may be shared by several PcapFile objects
+    class Writer;
+
     /**
      * \brief Pcap file header
      */
@@ -367,17 +415,45 @@ class PcapFile
      * \returns the length of the packet to write in the Pcap file
      */
     uint32_t WritePacketHeader(uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen);
+    /**
+     * \brief Write the end of a packet record, i.e., the padding and the length
+     * of a pcapng block
+     *
+     * \param inclLen the length of the packet written in the file
+     */
+    void WritePacketTrailer(uint32_t inclLen);
+    /**
+     * \brief Write the Section Header Block of a pcapng file
+     */
+    void WriteSectionHeader();
+    /**
+     * \brief Write the Interface Description Block of a pcapng file
+     */
+    void WriteInterfaceDescription();
+    /**
+     * \brief Write data to the file
+     *
+     * \param data the data
+     * \param size the size of the data
+     */
+    void WriteData(const void* data, uint32_t size);
 
     /**
      * \brief Read and verify a Pcap file header
      */
     void ReadAndVerifyFileHeader();
 
-    std::string m_filename;      //!< file name
-    std::fstream m_file;         //!< file stream
-    PcapFileHeader m_fileHeader; //!< file header
-    bool m_swapMode;             //!< swap mode
-    bool m_nanosecMode;          //!< nanosecond timestamp mode
+    std::string m_filename;           //!< file name
+    std::fstream m_file;              //!< file stream
+    PcapFileHeader m_fileHeader;      //!< file header
+    bool m_swapMode;                  //!< swap mode
+    bool m_nanosecMode;               //!< nanosecond timestamp mode
+    Format m_format;                  //!< format of the written file
+    Compression m_compression;        //!< compression of the written file
+    bool m_async;                     //!< whether the buffers are written by an I/O thread
+    uint32_t m_bufferSize;            //!< size of the buffers
+    std::shared_ptr<Writer> m_writer; //!< buffered writer, if any
+    uint32_t m_interfaceId;           //!< pcapng interface of this object
 };
 
 } // namespace ns3
@@ -0,0 +1,245 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * This program measures the time needed by the MultiModelSpectrumChannel to
+ * deliver a transmission to many receivers.
+ * The scenario mimics the downlink of an LTE cell: a base station transmits
+ * over 100 resource blocks of 180 kHz at 2.12 GHz towards numUes receivers
+ * randomly placed around it. When rxRbWidth differs from 180 kHz the
+ * receivers use a different SpectrumModel, so that the transmitted PSD has to
+ * be converted for them.
+ */
+
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/core-module.h"
+#include "ns3/multi-model-spectrum-channel.h"
+#include "ns3/net-device.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/spectrum-phy.h"
+#include "ns3/spectrum-signal-parameters.h"
+#include "ns3/spectrum-value.h"
+
+#include <chrono>
+#include <iostream>
+
+using namespace ns3;
+
+/**
+ * A SpectrumPhy which only counts the received signals
+ */
+class BenchmarkSpectrumPhy : public SpectrumPhy
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * Set the SpectrumModel used for reception
+     * \param model the SpectrumModel
+     */
+    void SetRxSpectrumModel(Ptr<const SpectrumModel> model);
+
+    /**
+     * \return the number of received signals
+     */
+    uint64_t GetRxCount() const;
+
+    void SetDevice(Ptr<NetDevice> d) override;
+    Ptr<NetDevice> GetDevice() const override;
+    void SetMobility(Ptr<MobilityModel> m) override;
+    Ptr<MobilityModel> GetMobility() const override;
+    void SetChannel(Ptr<SpectrumChannel> c) override;
+    Ptr<const SpectrumModel> GetRxSpectrumModel() const override;
+    Ptr<Object> GetAntenna() const override;
+    void StartRx(Ptr<SpectrumSignalParameters> params) override;
+
+  private:
+    Ptr<MobilityModel> m_mobility;      //!< the mobility model
+    Ptr<const SpectrumModel> m_rxModel; //!< the SpectrumModel used for reception
+    uint64_t m_rxCount{0};              //!< the number of received signals
+};
+
+TypeId
+BenchmarkSpectrumPhy::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::BenchmarkSpectrumPhy")
+                            .SetParent<SpectrumPhy>()
+                            .AddConstructor<BenchmarkSpectrumPhy>();
+    return tid;
+}
+
+void
+BenchmarkSpectrumPhy::SetRxSpectrumModel(Ptr<const SpectrumModel> model)
+{
+    m_rxModel = model;
+}
+
+uint64_t
+BenchmarkSpectrumPhy::GetRxCount() const
+{
+    return m_rxCount;
+}
+
+void
+BenchmarkSpectrumPhy::SetDevice(Ptr<NetDevice> d)
+{
+}
+
+Ptr<NetDevice>
+BenchmarkSpectrumPhy::GetDevice() const
+{
+    return nullptr;
+}
+
+void
+BenchmarkSpectrumPhy::SetMobility(Ptr<MobilityModel> m)
+{
+    m_mobility = m;
+}
+
+Ptr<MobilityModel>
+BenchmarkSpectrumPhy::GetMobility() const
+{
+    return m_mobility;
+}
+
+void
+BenchmarkSpectrumPhy::SetChannel(Ptr<SpectrumChannel> c)
+{
+}
+
+Ptr<const SpectrumModel>
+BenchmarkSpectrumPhy::GetRxSpectrumModel() const
+{
+    return m_rxModel;
+}
+
+Ptr<Object>
+BenchmarkSpectrumPhy::GetAntenna() const
+{
+    return nullptr;
+}
+
+void
+BenchmarkSpectrumPhy::StartRx(Ptr<SpectrumSignalParameters> params)
+{
+    m_rxCount++;
+}
+
+/**
+ * Create a SpectrumModel made of contiguous bands of equal width
+ * \param centerFrequency the center frequency in Hz
+ * \param bandwidth the total bandwidth in Hz
+ * \param rbWidth the width of each band in Hz
+ * \return the SpectrumModel
+ */
+static Ptr<SpectrumModel>
+CreateSpectrumModel(double centerFrequency, double bandwidth, double rbWidth)
+{
+    Bands bands;
+    uint32_t numBands = std::round(bandwidth / rbWidth);
+    for (uint32_t i = 0; i < numBands; i++)
+    {
+        BandInfo band;
+        band.fl = centerFrequency - bandwidth / 2 + i * rbWidth;
+        band.fc = band.fl + rbWidth / 2;
+        band.fh = band.fl + rbWidth;
+        bands.push_back(band);
+    }
+    return Create<SpectrumModel>(bands);
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t numUes = 200;          // number of receivers
+    uint32_t numTx = 10000;         // number of transmissions
+    double rxRbWidth = 180e3;       // width of the bands of the receivers' SpectrumModel
+    double cellRadius = 500;        // radius of the area in which the receivers are placed
+    double frequency = 2.12e9;      // center frequency in Hz
+    double bandwidth = 100 * 180e3; // occupied bandwidth in Hz
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("numUes", "The number of receivers", numUes);
+    cmd.AddValue("numTx", "The number of transmissions", numTx);
+    cmd.AddValue("rxRbWidth",
+                 "The width of the bands of the receivers' SpectrumModel in Hz",
+                 rxRbWidth);
+    cmd.AddValue("cellRadius", "The radius of the cell in meters", cellRadius);
+    cmd.Parse(argc, argv);
+
+    Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel>();
+    channel->AddPropagationLossModel(CreateObject<FriisPropagationLossModel>());
+
+    Ptr<SpectrumModel> txModel = CreateSpectrumModel(frequency, bandwidth, 180e3);
+    Ptr<SpectrumModel> rxModel =
+        (rxRbWidth == 180e3) ? txModel : CreateSpectrumModel(frequency, bandwidth, rxRbWidth);
+
+    Ptr<BenchmarkSpectrumPhy> enb = CreateObject<BenchmarkSpectrumPhy>();
+    Ptr<MobilityModel> enbMobility = CreateObject<ConstantPositionMobilityModel>();
+    enbMobility->SetPosition(Vector(0, 0, 25));
+    enb->SetMobility(enbMobility);
+    enb->SetRxSpectrumModel(txModel);
+
+    Ptr<UniformRandomVariable> position = CreateObject<UniformRandomVariable>();
+    std::vector<Ptr<BenchmarkSpectrumPhy>> ues;
+    for (uint32_t i = 0; i < numUes; i++)
+    {
+        Ptr<BenchmarkSpectrumPhy> ue = CreateObject<BenchmarkSpectrumPhy>();
+        Ptr<MobilityModel> ueMobility = CreateObject<ConstantPositionMobilityModel>();
+        ueMobility->SetPosition(Vector(position->GetValue(-cellRadius, cellRadius),
+                                       position->GetValue(-cellRadius, cellRadius),
+                                       1.5));
+        ue->SetMobility(ueMobility);
+        ue->SetRxSpectrumModel(rxModel);
+        channel->AddRx(ue);
+        ues.push_back(ue);
+    }
+
+    Ptr<SpectrumSignalParameters> txParams = Create<SpectrumSignalParameters>();
+    txParams->psd = Create<SpectrumValue>(txModel);
+    *(txParams->psd) = 1e-12;
+    txParams->duration = MicroSeconds(100);
+    txParams->txPhy = enb;
+    for (uint32_t i = 0; i < numTx; i++)
+    {
+        Simulator::Schedule(MilliSeconds(i),
+                            &MultiModelSpectrumChannel::StartTx,
+                            channel,
+                            txParams);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Simulator::Run();
+    auto end = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    uint64_t rxCount = 0;
+    for (const auto& ue : ues)
+    {
+        rxCount += ue->GetRxCount();
+    }
+    std::cout << numTx << " transmissions to " << numUes << " receivers"
+              << (rxModel == txModel ? "" : " (with spectrum conversion)") << ": " << rxCount
+              << " receptions in " << elapsed << " ms (" << elapsed * 1e3 / rxCount
+              << " us per reception)" << std::endl;
+
+    Simulator::Destroy();
+    return 0;
+}
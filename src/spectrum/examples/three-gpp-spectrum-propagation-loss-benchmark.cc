@@ -0,0 +1,175 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * This program measures the time needed by the
+ * ThreeGppSpectrumPropagationLossModel to compute the received PSD.
+ * The default configuration corresponds to a typical 3GPP UMa deployment,
+ * in which both the tx and the rx nodes are equipped with a 8x8 uniform
+ * planar array (64 antenna elements) and the signal occupies 275 resource
+ * blocks (12 subcarriers each, 30 kHz subcarrier spacing) at 3.5 GHz.
+ *
+ * When updateBeams is true the beamforming vectors are changed at every
+ * iteration, so that the cached long term component cannot be reused and
+ * both CalcLongTerm and CalcBeamformingGain are measured.
+ */
+
+#include "ns3/channel-condition-model.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/core-module.h"
+#include "ns3/node-container.h"
+#include "ns3/node.h"
+#include "ns3/spectrum-model.h"
+#include "ns3/spectrum-signal-parameters.h"
+#include "ns3/spectrum-value.h"
+#include "ns3/three-gpp-channel-model.h"
+#include "ns3/three-gpp-spectrum-propagation-loss-model.h"
+#include "ns3/uniform-planar-array.h"
+
+#include <chrono>
+#include <iostream>
+
+using namespace ns3;
+
+/**
+ * Set the beamforming vector of an antenna array using the DFT beamforming
+ * method, pointing the beam towards the given direction
+ * \param antenna the antenna array
+ * \param angle the direction of the beam
+ */
+static void
+SetDftBeam(Ptr<PhasedArrayModel> antenna, const Angles& angle)
+{
+    uint64_t numElements = antenna->GetNumberOfElements();
+    PhasedArrayModel::ComplexVector weights(numElements);
+    double power = 1.0 / sqrt(numElements);
+    double sinInclination = sin(angle.GetInclination());
+    double cosInclination = cos(angle.GetInclination());
+    for (uint64_t ind = 0; ind < numElements; ind++)
+    {
+        Vector loc = antenna->GetElementLocation(ind);
+        double phase = -2 * M_PI *
+                       (sinInclination * cos(angle.GetAzimuth()) * loc.x +
+                        sinInclination * sin(angle.GetAzimuth()) * loc.y + cosInclination * loc.z);
+        weights[ind] = std::polar(power, phase);
+    }
+    antenna->SetBeamformingVector(weights);
+}
+
+int
+main(int argc, char* argv[])
+{
+    double frequency = 3.5e9;     // center frequency in Hz
+    uint32_t numRbs = 275;        // number of resource blocks
+    double rbWidth = 12 * 30e3;   // resource block width in Hz
+    uint32_t numRows = 8;         // number of rows of each antenna array
+    uint32_t numColumns = 8;      // number of columns of each antenna array
+    double distance = 200.0;      // 2D distance between tx and rx nodes in meters
+    uint32_t iterations = 1000;   // number of received PSDs to compute
+    bool updateBeams = true;      // change the beams at every iteration
+    std::string scenario = "UMa"; // 3GPP propagation scenario
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("frequency", "The center frequency in Hz", frequency);
+    cmd.AddValue("numRbs", "The number of resource blocks", numRbs);
+    cmd.AddValue("rbWidth", "The width of each resource block in Hz", rbWidth);
+    cmd.AddValue("numRows", "The number of rows of the antenna arrays", numRows);
+    cmd.AddValue("numColumns", "The number of columns of the antenna arrays", numColumns);
+    cmd.AddValue("distance", "The 2D distance between the nodes in meters", distance);
+    cmd.AddValue("iterations", "The number of received PSDs to compute", iterations);
+    cmd.AddValue("updateBeams", "Change the beamforming vectors at every iteration", updateBeams);
+    cmd.AddValue("scenario", "The 3GPP propagation scenario", scenario);
+    cmd.Parse(argc, argv);
+
+    RngSeedManager::SetSeed(1);
+    RngSeedManager::SetRun(1);
+
+    Ptr<ThreeGppSpectrumPropagationLossModel> spectrumLossModel =
+        CreateObject<ThreeGppSpectrumPropagationLossModel>();
+    spectrumLossModel->SetChannelModelAttribute("Frequency", DoubleValue(frequency));
+    spectrumLossModel->SetChannelModelAttribute("Scenario", StringValue(scenario));
+    spectrumLossModel->SetChannelModelAttribute(
+        "ChannelConditionModel",
+        PointerValue(CreateObject<AlwaysLosChannelConditionModel>()));
+
+    NodeContainer nodes;
+    nodes.Create(2);
+    Ptr<MobilityModel> txMob = CreateObject<ConstantPositionMobilityModel>();
+    txMob->SetPosition(Vector(0.0, 0.0, 25.0));
+    Ptr<MobilityModel> rxMob = CreateObject<ConstantPositionMobilityModel>();
+    rxMob->SetPosition(Vector(distance, 0.0, 1.5));
+    nodes.Get(0)->AggregateObject(txMob);
+    nodes.Get(1)->AggregateObject(rxMob);
+
+    Ptr<PhasedArrayModel> txAntenna =
+        CreateObjectWithAttributes<UniformPlanarArray>("NumColumns",
+                                                       UintegerValue(numColumns),
+                                                       "NumRows",
+                                                       UintegerValue(numRows));
+    Ptr<PhasedArrayModel> rxAntenna =
+        CreateObjectWithAttributes<UniformPlanarArray>("NumColumns",
+                                                       UintegerValue(numColumns),
+                                                       "NumRows",
+                                                       UintegerValue(numRows));
+    Angles txToRx(rxMob->GetPosition(), txMob->GetPosition());
+    Angles rxToTx(txMob->GetPosition(), rxMob->GetPosition());
+    SetDftBeam(txAntenna, txToRx);
+    SetDftBeam(rxAntenna, rxToTx);
+
+    // create the spectrum model and a flat tx PSD
+    Bands bands;
+    double startFrequency = frequency - numRbs * rbWidth / 2;
+    for (uint32_t i = 0; i < numRbs; i++)
+    {
+        BandInfo band;
+        band.fl = startFrequency + i * rbWidth;
+        band.fc = band.fl + rbWidth / 2;
+        band.fh = band.fl + rbWidth;
+        bands.push_back(band);
+    }
+    Ptr<SpectrumSignalParameters> txParams = Create<SpectrumSignalParameters>();
+    txParams->psd = Create<SpectrumValue>(Create<SpectrumModel>(bands));
+    *(txParams->psd) = 1.0;
+
+    double totalPower = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        if (updateBeams)
+        {
+            // steer the tx beam slightly off the rx direction, so that the
+            // beamforming vector differs from the one of the previous iteration
+            double offset = (i % 2) * 0.01;
+            SetDftBeam(txAntenna, Angles(txToRx.GetAzimuth() + offset, txToRx.GetInclination()));
+        }
+        Ptr<SpectrumValue> rxPsd = spectrumLossModel->CalcRxPowerSpectralDensity(txParams,
+                                                                                 txMob,
+                                                                                 rxMob,
+                                                                                 txAntenna,
+                                                                                 rxAntenna);
+        totalPower += Sum(*rxPsd);
+    }
+    auto end = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double, std::micro>(end - start).count();
+
+    std::cout << scenario << ", " << numRows * numColumns << " antenna elements, " << numRbs
+              << " RBs, updateBeams " << updateBeams << std::endl;
+    std::cout << "Computed " << iterations << " PSDs in " << elapsed / 1e3 << " ms ("
+              << elapsed / iterations << " us per PSD)" << std::endl;
+    std::cout << "Average rx power " << 10 * log10(totalPower / iterations) << " dB" << std::endl;
+
+    Simulator::Destroy();
+    return 0;
+}
@@ -81,7 +81,9 @@ RxSpectrumModelInfo::RxSpectrumModelInfo(Ptr<const SpectrumModel> rxSpectrumMode
 }
 
 MultiModelSpectrumChannel::MultiModelSpectrumChannel()
-    : m_numDevices{0}
+    : m_numDevices{0},
+      m_numOutOfBandPruned{0},
+      m_numBelowThresholdPruned{0}
 {
     NS_LOG_FUNCTION(this);
 }
@@ -102,11 +104,49 @@ MultiModelSpectrumChannel::GetTypeId()
                             .SetParent<SpectrumChannel>()
                             .SetGroupName("Spectrum")
                             .AddConstructor<MultiModelSpectrumChannel>()
-
-        ;
+                            .AddAttribute("PruningThreshold",
+                                          "Receptions whose power, computed from the tx PSD "
+                                          "and the scalar PropagationLossModel, is below this "
+                                          "threshold (in dBm) are not delivered to the "
+                                          "receiving PHY. Frequency-dependent losses and gains "
+                                          "(e.g., beamforming gains) applied by the "
+                                          "SpectrumPropagationLossModel are not accounted for, "
+                                          "so leave enough margin when setting this value. "
+                                          "The default value disables the pruning.",
+                                          DoubleValue(-1.0e9),
+                                          MakeDoubleAccessor(
+                                              &MultiModelSpectrumChannel::SetPruningThreshold,
+                                              &MultiModelSpectrumChannel::GetPruningThreshold),
+                                          MakeDoubleChecker<double>());
     return tid;
 }
 
+void
+MultiModelSpectrumChannel::SetPruningThreshold(double thresholdDbm)
+{
+    NS_LOG_FUNCTION(this << thresholdDbm);
+    m_pruningThresholdDbm = thresholdDbm;
+    m_pruningThresholdW = std::pow(10.0, (thresholdDbm - 30) / 10.0);
+}
+
+double
+MultiModelSpectrumChannel::GetPruningThreshold() const
+{
+    return m_pruningThresholdDbm;
+}
+
+uint64_t
+MultiModelSpectrumChannel::GetNumOutOfBandPruned() const
+{
+    return m_numOutOfBandPruned;
+}
+
+uint64_t
+MultiModelSpectrumChannel::GetNumBelowThresholdPruned() const
+{
+    return m_numBelowThresholdPruned;
+}
+
 void
 MultiModelSpectrumChannel::RemoveRx(Ptr<SpectrumPhy> phy)
 {
@@ -237,10 +277,13 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
 
     NS_ASSERT(txParams->txPhy);
     NS_ASSERT(txParams->psd);
-    Ptr<SpectrumSignalParameters> txParamsTrace =
-        txParams->Copy(); // copy it since traced value cannot be const (because of potential
-                          // underlying DynamicCasts)
-    m_txSigParamsTrace(txParamsTrace);
+    if (!m_txSigParamsTrace.IsEmpty())
+    {
+        Ptr<SpectrumSignalParameters> txParamsTrace =
+            txParams->Copy(); // copy it since traced value cannot be const (because of potential
+                              // underlying DynamicCasts)
+        m_txSigParamsTrace(txParamsTrace);
+    }
 
     Ptr<MobilityModel> txMobility = txParams->txPhy->GetMobility();
     SpectrumModelUid_t txSpectrumModelUid = txParams->psd->GetSpectrumModelUid();
@@ -264,16 +307,9 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
         SpectrumModelUid_t rxSpectrumModelUid = rxInfoIterator->second.m_rxSpectrumModel->GetUid();
         NS_LOG_LOGIC("rxSpectrumModelUids " << rxSpectrumModelUid);
 
-        Ptr<SpectrumValue> convertedTxPowerSpectrum;
-        if (txSpectrumModelUid == rxSpectrumModelUid)
+        const SpectrumConverter* converter = nullptr;
+        if (txSpectrumModelUid != rxSpectrumModelUid)
         {
-            NS_LOG_LOGIC("no spectrum conversion needed");
-            convertedTxPowerSpectrum = txParams->psd;
-        }
-        else
-        {
-            NS_LOG_LOGIC("converting txPowerSpectrum SpectrumModelUids "
-                         << txSpectrumModelUid << " --> " << rxSpectrumModelUid);
             SpectrumConverterMap_t::const_iterator rxConverterIterator =
                 txInfoIteratorerator->second.m_spectrumConverterMap.find(rxSpectrumModelUid);
             if (rxConverterIterator == txInfoIteratorerator->second.m_spectrumConverterMap.end())
@@ -281,9 +317,15 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
                 // No converter means TX SpectrumModel is orthogonal to RX SpectrumModel
                 continue;
             }
-            convertedTxPowerSpectrum = rxConverterIterator->second.Convert(txParams->psd);
+            converter = &rxConverterIterator->second;
         }
 
+        // the PSD is converted to the RX SpectrumModel, and its power in the
+        // bands of the receivers evaluated, only when the first receiver of
+        // this SpectrumModel that is not filtered out is found
+        Ptr<SpectrumValue> convertedTxPowerSpectrum;
+        bool outOfBand = false;
+        double inBandPowerW = 0;
         for (auto rxPhyIterator = rxInfoIterator->second.m_rxPhys.begin();
              rxPhyIterator != rxInfoIterator->second.m_rxPhys.end();
              ++rxPhyIterator)
@@ -314,10 +356,36 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
                     continue;
                 }
 
-                NS_LOG_LOGIC("copying signal parameters " << txParams);
-                Ptr<SpectrumSignalParameters> rxParams = txParams->Copy();
-                rxParams->psd = Copy<SpectrumValue>(convertedTxPowerSpectrum);
+                if (!convertedTxPowerSpectrum)
+                {
+                    if (converter)
+                    {
+                        NS_LOG_LOGIC("converting txPowerSpectrum SpectrumModelUids "
+                                     << txSpectrumModelUid << " --> " << rxSpectrumModelUid);
+                        convertedTxPowerSpectrum = converter->Convert(txParams->psd);
+                    }
+                    else
+                    {
+                        NS_LOG_LOGIC("no spectrum conversion needed");
+                        convertedTxPowerSpectrum = txParams->psd;
+                    }
+                    outOfBand = std::all_of(convertedTxPowerSpectrum->ConstValuesBegin(),
+                                            convertedTxPowerSpectrum->ConstValuesEnd(),
+                                            [](double v) { return v == 0; });
+                    if (!outOfBand && m_pruningThresholdW > 0)
+                    {
+                        inBandPowerW = Integral(*convertedTxPowerSpectrum);
+                    }
+                }
+                if (outOfBand)
+                {
+                    NS_LOG_LOGIC("no power in the bands of the receiver");
+                    m_numOutOfBandPruned++;
+                    continue;
+                }
+
                 Time delay = MicroSeconds(0);
+                double pathGainLinear = 1.0;
 
                 Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility();
 
@@ -327,10 +395,10 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
                     double rxAntennaGain = 0;
                     double propagationGainDb = 0;
                     double pathLossDb = 0;
-                    if (rxParams->txAntenna)
+                    if (txParams->txAntenna)
                     {
                         Angles txAngles(receiverMobility->GetPosition(), txMobility->GetPosition());
-                        txAntennaGain = rxParams->txAntenna->GetGainDb(txAngles);
+                        txAntennaGain = txParams->txAntenna->GetGainDb(txAngles);
                         NS_LOG_LOGIC("txAntennaGain = " << txAntennaGain << " dB");
                         pathLossDb -= txAntennaGain;
                     }
@@ -365,8 +433,13 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
                         // beyond range
                         continue;
                     }
-                    double pathGainLinear = std::pow(10.0, (-pathLossDb) / 10.0);
-                    *(rxParams->psd) *= pathGainLinear;
+                    pathGainLinear = std::pow(10.0, (-pathLossDb) / 10.0);
+                    if (inBandPowerW * pathGainLinear < m_pruningThresholdW)
+                    {
+                        NS_LOG_LOGIC("rx power below the pruning threshold");
+                        m_numBelowThresholdPruned++;
+                        continue;
+                    }
 
                     if (m_propagationDelay)
                     {
@@ -374,6 +447,19 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
                     }
                 }
 
+                // the signal parameters are copied only for the receivers in range; the
+                // copy already holds its own PSD when no spectrum conversion is needed
+                NS_LOG_LOGIC("copying signal parameters " << txParams);
+                Ptr<SpectrumSignalParameters> rxParams = txParams->Copy();
+                if (convertedTxPowerSpectrum != txParams->psd)
+                {
+                    rxParams->psd = Copy<SpectrumValue>(convertedTxPowerSpectrum);
+                }
+                if (pathGainLinear != 1.0)
+                {
+                    *(rxParams->psd) *= pathGainLinear;
+                }
+
                 if (rxNetDevice)
                 {
                     // the receiver has a NetDevice, so we expect that it is attached to a Node
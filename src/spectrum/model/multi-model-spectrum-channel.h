@@ -98,6 +98,15 @@ typedef std::map<SpectrumModelUid_t, RxSpectrumModelInfo> RxSpectrumModelInfoMap
  * for this to work is that, after the SpectrumPhy switched its
  * SpectrumModel,  MultiModelSpectrumChannel::AddRx () is
  * called again passing the pointer to that SpectrumPhy.
+ *
+ * The PSD of a transmission is converted to the SpectrumModel of a group
+ * of receivers only when the first receiver of the group which is in range
+ * is found. Receptions whose converted PSD carries no power (i.e., the
+ * transmission does not overlap the bands of the receiver) are not
+ * delivered, and neither are those whose received power, computed from the
+ * scalar propagation loss, is below the PruningThreshold attribute. The
+ * number of receptions skipped for each reason can be retrieved with
+ * GetNumOutOfBandPruned () and GetNumBelowThresholdPruned ().
  */
 class MultiModelSpectrumChannel : public SpectrumChannel
 {
@@ -119,6 +128,30 @@ class MultiModelSpectrumChannel : public SpectrumChannel
     std::size_t GetNDevices() const override;
     Ptr<NetDevice> GetDevice(std::size_t i) const override;
 
+    /**
+     * Set the threshold below which receptions are not delivered
+     *
+     * \param thresholdDbm the threshold in dBm
+     */
+    void SetPruningThreshold(double thresholdDbm);
+
+    /**
+     * \return the threshold below which receptions are not delivered, in dBm
+     */
+    double GetPruningThreshold() const;
+
+    /**
+     * \return the number of receptions not delivered because the transmitted
+     *         PSD has no power in the bands of the receiver
+     */
+    uint64_t GetNumOutOfBandPruned() const;
+
+    /**
+     * \return the number of receptions not delivered because the received
+     *         power is below the pruning threshold
+     */
+    uint64_t GetNumBelowThresholdPruned() const;
+
   protected:
     void DoDispose() override;
 
@@ -162,6 +195,11 @@ class MultiModelSpectrumChannel : public SpectrumChannel
      * Number of devices connected to the channel.
      */
     std::size_t m_numDevices;
+
+    double m_pruningThresholdDbm;       //!< the pruning threshold in dBm
+    double m_pruningThresholdW;         //!< the pruning threshold in W
+    uint64_t m_numOutOfBandPruned;      //!< receptions pruned for lack of band overlap
+    uint64_t m_numBelowThresholdPruned; //!< receptions pruned for low received power
 };
 
 } // namespace ns3
@@ -39,6 +39,7 @@ SpectrumConverter::SpectrumConverter(Ptr<const SpectrumModel> fromSpectrumModel,
     m_fromSpectrumModel = fromSpectrumModel;
     m_toSpectrumModel = toSpectrumModel;
 
+    m_conversionRowPtr.reserve(toSpectrumModel->GetNumBands());
     size_t rowPtr = 0;
     for (Bands::const_iterator toit = toSpectrumModel->Begin(); toit != toSpectrumModel->End();
          ++toit)
@@ -82,21 +83,25 @@ SpectrumConverter::Convert(Ptr<const SpectrumValue> fvvf) const
 
     Ptr<SpectrumValue> tvvf = Create<SpectrumValue>(m_toSpectrumModel);
 
-    Values::iterator tvit = tvvf->ValuesBegin();
-    size_t i = 0; // Index of conversion coefficient
+    // The loop below runs for every converted signal, hence it works on the
+    // raw arrays instead of going through the bounds-checked accessors, so
+    // that the multiply-accumulate of each row compiles to a tight loop.
+    Values::const_iterator fromValues = fvvf->ConstValuesBegin();
+    Values::iterator toValues = tvvf->ValuesBegin();
+    const double* coefficients = m_conversionMatrix.data();
+    const size_t* columns = m_conversionColInd.data();
+    const size_t numRows = m_conversionRowPtr.size();
 
-    for (std::vector<size_t>::const_iterator convIt = m_conversionRowPtr.begin();
-         convIt != m_conversionRowPtr.end();
-         ++convIt)
+    size_t i = 0; // Index of conversion coefficient
+    for (size_t row = 0; row < numRows; ++row)
     {
+        const size_t rowEnd = m_conversionRowPtr[row];
         double sum = 0;
-        while (i < *convIt)
+        for (; i < rowEnd; ++i)
         {
-            sum += (*fvvf)[m_conversionColInd.at(i)] * m_conversionMatrix.at(i);
-            i++;
+            sum += fromValues[columns[i]] * coefficients[i];
         }
-        *tvit = sum;
-        ++tvit;
+        toValues[row] = sum;
     }
 
     return tvvf;
@@ -145,8 +145,6 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
 {
     NS_LOG_FUNCTION(this);
 
-    Ptr<SpectrumValue> tempPsd = Copy<SpectrumValue>(txPsd);
-
     // channel[cluster][rx][tx]
     uint16_t numCluster = channelMatrix->m_channel.GetNumPages();
 
@@ -155,7 +153,6 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
     // each cluster in to consideration.
     double slotTime = Simulator::Now().GetSeconds();
     double factor = 2 * M_PI * slotTime * GetFrequency() / 3e8;
-    PhasedArrayModel::ComplexVector doppler(numCluster);
 
     // The following asserts might seem paranoic, but it is important to
     // make sure that all the structures that are passed to this function
@@ -164,6 +161,7 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
     // and [] operators, ...
     NS_ASSERT(numCluster <= channelParams->m_alpha.size());
     NS_ASSERT(numCluster <= channelParams->m_D.size());
+    NS_ASSERT(numCluster <= channelParams->m_delay.size());
     NS_ASSERT(numCluster <= channelParams->m_angle[MatrixBasedChannelModel::ZOA_INDEX].size());
     NS_ASSERT(numCluster <= channelParams->m_angle[MatrixBasedChannelModel::ZOD_INDEX].size());
     NS_ASSERT(numCluster <= channelParams->m_angle[MatrixBasedChannelModel::AOA_INDEX].size());
@@ -173,30 +171,23 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
     // check if channelParams structure is generated in direction s-to-u or u-to-s
     bool isSameDirection = (channelParams->m_nodeIds == channelMatrix->m_nodeIds);
 
-    MatrixBasedChannelModel::DoubleVector zoa;
-    MatrixBasedChannelModel::DoubleVector zod;
-    MatrixBasedChannelModel::DoubleVector aoa;
-    MatrixBasedChannelModel::DoubleVector aod;
-
     // if channel params is generated in the same direction in which we
     // generate the channel matrix, angles and zenith od departure and arrival are ok,
     // just set them to corresponding variable that will be used for the generation
     // of channel matrix, otherwise we need to flip angles and zeniths of departure and arrival
-    if (isSameDirection)
-    {
-        zoa = channelParams->m_angle[MatrixBasedChannelModel::ZOA_INDEX];
-        zod = channelParams->m_angle[MatrixBasedChannelModel::ZOD_INDEX];
-        aoa = channelParams->m_angle[MatrixBasedChannelModel::AOA_INDEX];
-        aod = channelParams->m_angle[MatrixBasedChannelModel::AOD_INDEX];
-    }
-    else
-    {
-        zod = channelParams->m_angle[MatrixBasedChannelModel::ZOA_INDEX];
-        zoa = channelParams->m_angle[MatrixBasedChannelModel::ZOD_INDEX];
-        aod = channelParams->m_angle[MatrixBasedChannelModel::AOA_INDEX];
-        aoa = channelParams->m_angle[MatrixBasedChannelModel::AOD_INDEX];
-    }
-
+    const auto& zoa = channelParams->m_angle[isSameDirection ? MatrixBasedChannelModel::ZOA_INDEX
+                                                             : MatrixBasedChannelModel::ZOD_INDEX];
+    const auto& zod = channelParams->m_angle[isSameDirection ? MatrixBasedChannelModel::ZOD_INDEX
+                                                             : MatrixBasedChannelModel::ZOA_INDEX];
+    const auto& aoa = channelParams->m_angle[isSameDirection ? MatrixBasedChannelModel::AOA_INDEX
+                                                             : MatrixBasedChannelModel::AOD_INDEX];
+    const auto& aod = channelParams->m_angle[isSameDirection ? MatrixBasedChannelModel::AOD_INDEX
+                                                             : MatrixBasedChannelModel::AOA_INDEX];
+
+    // The per-cluster weights are the long term component multiplied by the
+    // Doppler term. They do not depend on the sub-band, hence they are computed
+    // only once and then combined with the per sub-band delay terms below
+    PhasedArrayModel::ComplexVector clusterWeights(numCluster);
     for (uint16_t cIndex = 0; cIndex < numCluster; cIndex++)
     {
         // Compute alpha and D as described in 3GPP TR 37.885 v15.3.0, Sec. 6.2.3
@@ -214,41 +205,59 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
         double D = channelParams->m_D[cIndex];
 
         // cluster angle angle[direction][n], where direction = 0(aoa), 1(zoa).
+        double sinZoa = sin(zoa[cIndex] * M_PI / 180);
+        double sinZod = sin(zod[cIndex] * M_PI / 180);
         double tempDoppler =
-            factor * ((sin(zoa[cIndex] * M_PI / 180) * cos(aoa[cIndex] * M_PI / 180) * uSpeed.x +
-                       sin(zoa[cIndex] * M_PI / 180) * sin(aoa[cIndex] * M_PI / 180) * uSpeed.y +
+            factor * ((sinZoa * cos(aoa[cIndex] * M_PI / 180) * uSpeed.x +
+                       sinZoa * sin(aoa[cIndex] * M_PI / 180) * uSpeed.y +
                        cos(zoa[cIndex] * M_PI / 180) * uSpeed.z) +
-                      (sin(zod[cIndex] * M_PI / 180) * cos(aod[cIndex] * M_PI / 180) * sSpeed.x +
-                       sin(zod[cIndex] * M_PI / 180) * sin(aod[cIndex] * M_PI / 180) * sSpeed.y +
+                      (sinZod * cos(aod[cIndex] * M_PI / 180) * sSpeed.x +
+                       sinZod * sin(aod[cIndex] * M_PI / 180) * sSpeed.y +
                        cos(zod[cIndex] * M_PI / 180) * sSpeed.z) +
                       2 * alpha * D);
-        doppler[cIndex] = std::complex<double>(cos(tempDoppler), sin(tempDoppler));
+        clusterWeights[cIndex] =
+            longTerm[cIndex] * std::complex<double>(cos(tempDoppler), sin(tempDoppler));
+    }
+
+    // collect the sub-bands carrying power, the others are left untouched
+    std::vector<size_t> activeBands;
+    activeBands.reserve(txPsd->GetValuesN());
+    for (size_t bIndex = 0; bIndex < txPsd->GetValuesN(); bIndex++)
+    {
+        if ((*txPsd)[bIndex] != 0.00)
+        {
+            activeBands.push_back(bIndex);
+        }
+    }
+    if (activeBands.empty())
+    {
+        return txPsd;
     }
 
-    NS_ASSERT(numCluster <= doppler.GetSize());
+    // build the matrix of the propagation delay terms, with one row per active
+    // sub-band and one column per cluster, so that the gain of all the sub-bands
+    // is obtained with a single matrix-vector product (which is delegated to
+    // Eigen, when available)
+    ComplexMatrixArray delayTerms(activeBands.size(), numCluster);
+    auto bands = txPsd->ConstBandsBegin();
+    for (uint16_t cIndex = 0; cIndex < numCluster; cIndex++)
+    {
+        double delayFactor = -2 * M_PI * channelParams->m_delay[cIndex];
+        for (size_t row = 0; row < activeBands.size(); row++)
+        {
+            double delay = delayFactor * bands[activeBands[row]].fc;
+            delayTerms(row, cIndex) = std::complex<double>(cos(delay), sin(delay));
+        }
+    }
+    PhasedArrayModel::ComplexVector subbandGains = delayTerms * clusterWeights;
 
     // apply the doppler term and the propagation delay to the long term component
     // to obtain the beamforming gain
-    auto vit = tempPsd->ValuesBegin();      // psd iterator
-    auto sbit = tempPsd->ConstBandsBegin(); // band iterator
-    while (vit != tempPsd->ValuesEnd())
+    for (size_t row = 0; row < activeBands.size(); row++)
     {
-        if ((*vit) != 0.00)
-        {
-            std::complex<double> subsbandGain(0.0, 0.0);
-            double fsb = (*sbit).fc; // center frequency of the sub-band
-            for (uint16_t cIndex = 0; cIndex < numCluster; cIndex++)
-            {
-                double delay = -2 * M_PI * fsb * (channelParams->m_delay[cIndex]);
-                subsbandGain = subsbandGain + longTerm[cIndex] * doppler[cIndex] *
-                                                  std::complex<double>(cos(delay), sin(delay));
-            }
-            *vit = (*vit) * (norm(subsbandGain));
-        }
-        vit++;
-        sbit++;
+        (*txPsd)[activeBands[row]] *= norm(subbandGains[row]);
     }
-    return tempPsd;
+    return txPsd;
 }
 
 PhasedArrayModel::ComplexVector
@@ -174,7 +174,7 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
 
     /**
      * Computes the beamforming gain and applies it to the tx PSD
-     * \param txPsd the tx PSD
+     * \param txPsd the tx PSD, which is scaled in place
      * \param longTerm the long term component
      * \param channelMatrix The channel matrix structure
      * \param channelParams The channel params structure
@@ -10,7 +10,9 @@ cpp_examples = [
     ("adhoc-aloha-ideal-phy", "True", "True"),
     ("adhoc-aloha-ideal-phy-with-microwave-oven", "True", "True"),
     ("adhoc-aloha-ideal-phy-matrix-propagation-loss-model", "True", "True"),
-    ("three-gpp-channel-example", "True", "True")
+    ("three-gpp-channel-example", "True", "True"),
+    ("three-gpp-spectrum-propagation-loss-benchmark --iterations=10", "True", "False"),
+    ("multi-model-spectrum-channel-benchmark --numTx=10", "True", "False"),
 ]
 
 # A list of Python examples to run in order to ensure that they remain
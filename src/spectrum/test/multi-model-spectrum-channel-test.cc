@@ -0,0 +1,328 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/double.h>
+#include <ns3/log.h>
+#include <ns3/multi-model-spectrum-channel.h>
+#include <ns3/net-device.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/simulator.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/test.h>
+
+#include <cmath>
+
+NS_LOG_COMPONENT_DEFINE("MultiModelSpectrumChannelTest");
+
+using namespace ns3;
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief A SpectrumPhy which stores the power of the received signals
+ */
+class MultiModelTestSpectrumPhy : public SpectrumPhy
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * Set the SpectrumModel used for reception
+     * \param model the SpectrumModel
+     */
+    void SetRxSpectrumModel(Ptr<const SpectrumModel> model);
+
+    /**
+     * \return the number of received signals
+     */
+    uint32_t GetRxCount() const;
+
+    /**
+     * \return the power of the last received signal in W
+     */
+    double GetLastRxPower() const;
+
+    void SetDevice(Ptr<NetDevice> d) override;
+    Ptr<NetDevice> GetDevice() const override;
+    void SetMobility(Ptr<MobilityModel> m) override;
+    Ptr<MobilityModel> GetMobility() const override;
+    void SetChannel(Ptr<SpectrumChannel> c) override;
+    Ptr<const SpectrumModel> GetRxSpectrumModel() const override;
+    Ptr<Object> GetAntenna() const override;
+    void StartRx(Ptr<SpectrumSignalParameters> params) override;
+
+  private:
+    Ptr<MobilityModel> m_mobility;      //!< the mobility model
+    Ptr<const SpectrumModel> m_rxModel; //!< the SpectrumModel used for reception
+    uint32_t m_rxCount{0};              //!< the number of received signals
+    double m_lastRxPower{0};            //!< the power of the last received signal in W
+};
+
+TypeId
+MultiModelTestSpectrumPhy::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::MultiModelTestSpectrumPhy")
+                            .SetParent<SpectrumPhy>()
+                            .AddConstructor<MultiModelTestSpectrumPhy>();
+    return tid;
+}
+
+void
+MultiModelTestSpectrumPhy::SetRxSpectrumModel(Ptr<const SpectrumModel> model)
+{
+    m_rxModel = model;
+}
+
+uint32_t
+MultiModelTestSpectrumPhy::GetRxCount() const
+{
+    return m_rxCount;
+}
+
+double
+MultiModelTestSpectrumPhy::GetLastRxPower() const
+{
+    return m_lastRxPower;
+}
+
+void
+MultiModelTestSpectrumPhy::SetDevice(Ptr<NetDevice> d)
+{
+}
+
+Ptr<NetDevice>
+MultiModelTestSpectrumPhy::GetDevice() const
+{
+    return nullptr;
+}
+
+void
+MultiModelTestSpectrumPhy::SetMobility(Ptr<MobilityModel> m)
+{
+    m_mobility = m;
+}
+
+Ptr<MobilityModel>
+MultiModelTestSpectrumPhy::GetMobility() const
+{
+    return m_mobility;
+}
+
+void
+MultiModelTestSpectrumPhy::SetChannel(Ptr<SpectrumChannel> c)
+{
+}
+
+Ptr<const SpectrumModel>
+MultiModelTestSpectrumPhy::GetRxSpectrumModel() const
+{
+    return m_rxModel;
+}
+
+Ptr<Object>
+MultiModelTestSpectrumPhy::GetAntenna() const
+{
+    return nullptr;
+}
+
+void
+MultiModelTestSpectrumPhy::StartRx(Ptr<SpectrumSignalParameters> params)
+{
+    m_rxCount++;
+    m_lastRxPower = Integral(*params->psd);
+}
+
+/**
+ * Create a SpectrumModel made of contiguous bands of equal width
+ * \param fl the lower frequency of the first band in Hz
+ * \param fh the upper frequency of the last band in Hz
+ * \param numBands the number of bands
+ * \return the SpectrumModel
+ */
+static Ptr<SpectrumModel>
+CreateSpectrumModel(double fl, double fh, uint32_t numBands)
+{
+    Bands bands;
+    double width = (fh - fl) / numBands;
+    for (uint32_t i = 0; i < numBands; i++)
+    {
+        BandInfo band;
+        band.fl = fl + i * width;
+        band.fc = band.fl + width / 2;
+        band.fh = band.fl + width;
+        bands.push_back(band);
+    }
+    return Create<SpectrumModel>(bands);
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Check that the MultiModelSpectrumChannel does not deliver the
+ * transmissions which carry no power in the bands of the receiver or whose
+ * received power is below the pruning threshold, and that it delivers the
+ * other ones unchanged.
+ */
+class MultiModelSpectrumChannelPruningTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param thresholdDbm the pruning threshold in dBm
+     */
+    MultiModelSpectrumChannelPruningTestCase(double thresholdDbm);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Create a receiver and attach it to the channel
+     * \param channel the channel
+     * \param model the SpectrumModel of the receiver
+     * \param distance the distance of the receiver from the transmitter in meters
+     * \return the receiver
+     */
+    Ptr<MultiModelTestSpectrumPhy> CreateRx(Ptr<MultiModelSpectrumChannel> channel,
+                                            Ptr<const SpectrumModel> model,
+                                            double distance) const;
+
+    double m_thresholdDbm; //!< the pruning threshold in dBm
+};
+
+MultiModelSpectrumChannelPruningTestCase::MultiModelSpectrumChannelPruningTestCase(
+    double thresholdDbm)
+    : TestCase("Check the pruning of receptions with threshold " + std::to_string(thresholdDbm) +
+               " dBm"),
+      m_thresholdDbm(thresholdDbm)
+{
+}
+
+Ptr<MultiModelTestSpectrumPhy>
+MultiModelSpectrumChannelPruningTestCase::CreateRx(Ptr<MultiModelSpectrumChannel> channel,
+                                                   Ptr<const SpectrumModel> model,
+                                                   double distance) const
+{
+    Ptr<MultiModelTestSpectrumPhy> phy = CreateObject<MultiModelTestSpectrumPhy>();
+    Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel>();
+    mobility->SetPosition(Vector(distance, 0, 0));
+    phy->SetMobility(mobility);
+    phy->SetRxSpectrumModel(model);
+    channel->AddRx(phy);
+    return phy;
+}
+
+void
+MultiModelSpectrumChannelPruningTestCase::DoRun()
+{
+    Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel>();
+    channel->SetAttribute("PruningThreshold", DoubleValue(m_thresholdDbm));
+    Ptr<FriisPropagationLossModel> loss = CreateObject<FriisPropagationLossModel>();
+    channel->AddPropagationLossModel(loss);
+
+    // the tx model has ten 1 MHz bands from 2000 to 2010 MHz, and the tx PSD
+    // has power only in the lower five bands
+    Ptr<SpectrumModel> txModel = CreateSpectrumModel(2000e6, 2010e6, 10);
+    Ptr<SpectrumModel> wideModel = CreateSpectrumModel(2000e6, 2010e6, 5);
+    Ptr<SpectrumModel> upperModel = CreateSpectrumModel(2006e6, 2010e6, 4);
+
+    Ptr<MultiModelTestSpectrumPhy> tx = CreateRx(channel, txModel, 0);
+    Ptr<MultiModelTestSpectrumPhy> sameModelRx = CreateRx(channel, txModel, 10);
+    Ptr<MultiModelTestSpectrumPhy> wideModelRx = CreateRx(channel, wideModel, 10);
+    Ptr<MultiModelTestSpectrumPhy> upperModelRx = CreateRx(channel, upperModel, 10);
+    Ptr<MultiModelTestSpectrumPhy> farRx = CreateRx(channel, txModel, 10000);
+
+    Ptr<SpectrumSignalParameters> txParams = Create<SpectrumSignalParameters>();
+    txParams->psd = Create<SpectrumValue>(txModel);
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        (*txParams->psd)[i] = 1e-9; // 1 mW in each band
+    }
+    txParams->duration = MicroSeconds(100);
+    txParams->txPhy = tx;
+    Simulator::Schedule(Seconds(1), &MultiModelSpectrumChannel::StartTx, channel, txParams);
+    Simulator::Run();
+
+    double txPowerW = 5e-3;
+    double nearGain =
+        std::pow(10.0, loss->CalcRxPower(0, tx->GetMobility(), sameModelRx->GetMobility()) / 10);
+    double farGain =
+        std::pow(10.0, loss->CalcRxPower(0, tx->GetMobility(), farRx->GetMobility()) / 10);
+    double farRxPowerW = txPowerW * farGain;
+    bool farRxPruned = 10 * std::log10(farRxPowerW) + 30 < m_thresholdDbm;
+
+    NS_TEST_ASSERT_MSG_EQ(tx->GetRxCount(), 0, "The transmitter should not receive its signal");
+    NS_TEST_ASSERT_MSG_EQ(sameModelRx->GetRxCount(), 1, "The signal should be received");
+    NS_TEST_ASSERT_MSG_EQ_TOL(sameModelRx->GetLastRxPower(),
+                              txPowerW * nearGain,
+                              txPowerW * nearGain * 1e-9,
+                              "Wrong received power");
+    NS_TEST_ASSERT_MSG_EQ(wideModelRx->GetRxCount(), 1, "The converted signal should be received");
+    NS_TEST_ASSERT_MSG_EQ_TOL(wideModelRx->GetLastRxPower(),
+                              txPowerW * nearGain,
+                              txPowerW * nearGain * 1e-9,
+                              "Wrong received power after the spectrum conversion");
+    NS_TEST_ASSERT_MSG_EQ(upperModelRx->GetRxCount(),
+                          0,
+                          "The signal has no power in the bands of the receiver");
+    NS_TEST_ASSERT_MSG_EQ(channel->GetNumOutOfBandPruned(),
+                          1,
+                          "Wrong number of receptions pruned for lack of band overlap");
+    NS_TEST_ASSERT_MSG_EQ(farRx->GetRxCount(),
+                          (farRxPruned ? 0 : 1),
+                          "Wrong number of receptions at the far receiver");
+    if (!farRxPruned)
+    {
+        NS_TEST_ASSERT_MSG_EQ_TOL(farRx->GetLastRxPower(),
+                                  farRxPowerW,
+                                  farRxPowerW * 1e-9,
+                                  "Wrong received power at the far receiver");
+    }
+    NS_TEST_ASSERT_MSG_EQ(channel->GetNumBelowThresholdPruned(),
+                          (farRxPruned ? 1 : 0),
+                          "Wrong number of receptions pruned for low received power");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief MultiModelSpectrumChannel TestSuite
+ */
+class MultiModelSpectrumChannelTestSuite : public TestSuite
+{
+  public:
+    MultiModelSpectrumChannelTestSuite();
+};
+
+MultiModelSpectrumChannelTestSuite::MultiModelSpectrumChannelTestSuite()
+    : TestSuite("multi-model-spectrum-channel", UNIT)
+{
+    // the default threshold disables the pruning for low received power, while
+    // -90 dBm prunes the receiver placed 10 km away from the transmitter
+    AddTestCase(new MultiModelSpectrumChannelPruningTestCase(-1.0e9), TestCase::QUICK);
+    AddTestCase(new MultiModelSpectrumChannelPruningTestCase(-90), TestCase::QUICK);
+}
+
+/// Static variable for test initialization
+static MultiModelSpectrumChannelTestSuite g_multiModelSpectrumChannelTestSuite;
@@ -0,0 +1,208 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "columnar-aggregator.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <fstream>
+#include <string>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ColumnarAggregator");
+
+NS_OBJECT_ENSURE_REGISTERED(ColumnarAggregator);
+
+/// Magic string at the start of the files.
+static const char COLUMNAR_MAGIC[8] = {'N', 'S', '3', 'C', 'O', 'L', 'S', '\0'};
+/// Version of the format of the files.
+static const uint32_t COLUMNAR_VERSION = 1;
+/// Type of the records describing a dataset.
+static const uint32_t COLUMNAR_DATASET = 1;
+/// Type of the records holding a chunk of a dataset.
+static const uint32_t COLUMNAR_CHUNK = 2;
+
+TypeId
+ColumnarAggregator::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::ColumnarAggregator").SetParent<DataCollectionObject>().SetGroupName("Stats");
+
+    return tid;
+}
+
+ColumnarAggregator::ColumnarAggregator(const std::string& outputFileName)
+    : m_outputFileName(outputFileName),
+      m_chunkSize(CHUNK_SIZE_DEFAULT)
+{
+    NS_LOG_FUNCTION(this << outputFileName);
+
+    m_file.open(m_outputFileName, std::ios::out | std::ios::binary);
+    NS_ABORT_MSG_UNLESS(m_file.is_open(), "Unable to open file " << m_outputFileName);
+
+    const uint32_t reserved = 0;
+    m_file.write(COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC));
+    m_file.write((const char*)&COLUMNAR_VERSION, sizeof(COLUMNAR_VERSION));
+    m_file.write((const char*)&reserved, sizeof(reserved));
+}
+
+ColumnarAggregator::~ColumnarAggregator()
+{
+    NS_LOG_FUNCTION(this);
+    Flush();
+    m_file.close();
+}
+
+void
+ColumnarAggregator::SetChunkSize(uint32_t chunkSize)
+{
+    NS_LOG_FUNCTION(this << chunkSize);
+    NS_ABORT_MSG_IF(chunkSize == 0, "The chunks must have at least one row");
+    m_chunkSize = chunkSize;
+}
+
+void
+ColumnarAggregator::Flush()
+{
+    NS_LOG_FUNCTION(this);
+    for (Dataset* dataset : m_datasetsById)
+    {
+        WriteChunk(*dataset);
+    }
+    m_file.flush();
+}
+
+void
+ColumnarAggregator::Append(const std::string& context, const double* values, uint32_t nValues)
+{
+    auto it = m_datasets.find(context);
+    if (it == m_datasets.end())
+    {
+        // Describe the new dataset in the file.
+        uint32_t id = m_datasetsById.size();
+        uint32_t contextLength = context.size();
+        uint32_t padding = (8 - (3 * sizeof(uint32_t) + contextLength) % 8) % 8;
+        uint32_t length = 3 * sizeof(uint32_t) + contextLength + padding;
+        const char zeros[8] = {};
+        m_file.write((const char*)&COLUMNAR_DATASET, sizeof(COLUMNAR_DATASET));
+        m_file.write((const char*)&length, sizeof(length));
+        m_file.write((const char*)&id, sizeof(id));
+        m_file.write((const char*)&nValues, sizeof(nValues));
+        m_file.write((const char*)&contextLength, sizeof(contextLength));
+        m_file.write(context.data(), contextLength);
+        m_file.write(zeros, padding);
+
+        it = m_datasets.emplace(context, Dataset()).first;
+        it->second.id = id;
+        it->second.columns.resize(nValues);
+        m_datasetsById.push_back(&it->second);
+    }
+
+    std::vector<std::vector<double>>& columns = it->second.columns;
+    NS_ABORT_MSG_IF(columns.size() != nValues,
+                    "Dataset " << context << " has " << columns.size() << " columns, not "
+                               << nValues);
+    if (columns[0].empty())
+    {
+        for (auto& column : columns)
+        {
+            column.reserve(m_chunkSize);
+        }
+    }
+    for (uint32_t i = 0; i < nValues; i++)
+    {
+        columns[i].push_back(values[i]);
+    }
+    if (columns[0].size() >= m_chunkSize)
+    {
+        WriteChunk(it->second);
+    }
+}
+
+void
+ColumnarAggregator::WriteChunk(Dataset& dataset)
+{
+    NS_LOG_FUNCTION(this << dataset.id);
+    uint32_t nRows = dataset.columns[0].size();
+    if (nRows == 0)
+    {
+        return;
+    }
+
+    uint32_t length = 2 * sizeof(uint32_t) + dataset.columns.size() * nRows * sizeof(double);
+    m_file.write((const char*)&COLUMNAR_CHUNK, sizeof(COLUMNAR_CHUNK));
+    m_file.write((const char*)&length, sizeof(length));
+    m_file.write((const char*)&dataset.id, sizeof(dataset.id));
+    m_file.write((const char*)&nRows, sizeof(nRows));
+    for (auto& column : dataset.columns)
+    {
+        m_file.write((const char*)column.data(), nRows * sizeof(double));
+        // Keep the capacity for the next chunk.
+        column.clear();
+    }
+}
+
+void
+ColumnarAggregator::Write1d(std::string context, double v1)
+{
+    NS_LOG_FUNCTION(this << context << v1);
+
+    if (m_enabled)
+    {
+        const double values[] = {v1};
+        Append(context, values, 1);
+    }
+}
+
+void
+ColumnarAggregator::Write2d(std::string context, double v1, double v2)
+{
+    NS_LOG_FUNCTION(this << context << v1 << v2);
+
+    if (m_enabled)
+    {
+        const double values[] = {v1, v2};
+        Append(context, values, 2);
+    }
+}
+
+void
+ColumnarAggregator::Write3d(std::string context, double v1, double v2, double v3)
+{
+    NS_LOG_FUNCTION(this << context << v1 << v2 << v3);
+
+    if (m_enabled)
+    {
+        const double values[] = {v1, v2, v3};
+        Append(context, values, 3);
+    }
+}
+
+void
+ColumnarAggregator::Write4d(std::string context, double v1, double v2, double v3, double v4)
+{
+    NS_LOG_FUNCTION(this << context << v1 << v2 << v3 << v4);
+
+    if (m_enabled)
+    {
+        const double values[] = {v1, v2, v3, v4};
+        Append(context, values, 4);
+    }
+}
+
+} // namespace ns3
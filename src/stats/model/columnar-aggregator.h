@@ -0,0 +1,175 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef COLUMNAR_AGGREGATOR_H
+#define COLUMNAR_AGGREGATOR_H
+
+#include "ns3/data-collection-object.h"
+
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup aggregator
+ *
+ * This aggregator sends values it receives to a binary file, in columns.
+ *
+ * The values of each dataset, i.e., of each context, are kept in memory
+ * column by column, and written to the file in chunks of ChunkSize rows,
+ * each column of a chunk in a single block.  The remaining rows are written
+ * when the aggregator is flushed or destroyed.  The file can be read with
+ * the Python module ``ns.columnar`` (bindings/python/ns_columnar.py).
+ *
+ * The file starts with the 8 bytes "NS3COLS\0", then a version number
+ * (currently 1) and a reserved field, both uint32_t.  It is followed by
+ * records made of a uint32_t type, a uint32_t length of the payload, then
+ * the payload:
+ *
+ * - DATASET (type 1): the uint32_t identifier and number of columns of a
+ *   dataset, the uint32_t length of its context, then the context, padded
+ *   with zeros to make the length of the payload a multiple of 8 bytes.
+ * - CHUNK (type 2): the uint32_t identifier of a dataset and number of rows
+ *   of the chunk, then the doubles of each column of the chunk, one column
+ *   after the other.
+ *
+ * All the numbers are written in the byte order of the machine running the
+ * simulation, which the readers detect from the version number.
+ **/
+class ColumnarAggregator : public DataCollectionObject
+{
+  public:
+    /// The default number of rows of a chunk.
+    static const uint32_t CHUNK_SIZE_DEFAULT = 4096;
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * \param outputFileName name of the file to write.
+     *
+     * Constructs a columnar aggregator that will create a file named
+     * outputFileName.
+     */
+    ColumnarAggregator(const std::string& outputFileName);
+
+    ~ColumnarAggregator() override;
+
+    /**
+     * \param chunkSize the number of rows of a chunk.
+     *
+     * \brief Sets the number of rows of the datasets that are kept in
+     * memory before being written to the file.
+     */
+    void SetChunkSize(uint32_t chunkSize);
+
+    /**
+     * \brief Writes the rows kept in memory to the file.
+     */
+    void Flush();
+
+    // Below are hooked to connectors exporting data
+    // They are not overloaded since it confuses the compiler when made
+    // into callbacks
+
+    /**
+     * \param context specifies the 1D dataset these values came from.
+     * \param v1 value for the new data point.
+     *
+     * \brief Writes 1 value to the file.
+     */
+    void Write1d(std::string context, double v1);
+
+    /**
+     * \param context specifies the 2D dataset these values came from.
+     * \param v1 first value for the new data point.
+     * \param v2 second value for the new data point.
+     *
+     * \brief Writes 2 values to the file.
+     */
+    void Write2d(std::string context, double v1, double v2);
+
+    /**
+     * \param context specifies the 3D dataset these values came from.
+     * \param v1 first value for the new data point.
+     * \param v2 second value for the new data point.
+     * \param v3 third value for the new data point.
+     *
+     * \brief Writes 3 values to the file.
+     */
+    void Write3d(std::string context, double v1, double v2, double v3);
+
+    /**
+     * \param context specifies the 4D dataset these values came from.
+     * \param v1 first value for the new data point.
+     * \param v2 second value for the new data point.
+     * \param v3 third value for the new data point.
+     * \param v4 fourth value for the new data point.
+     *
+     * \brief Writes 4 values to the file.
+     */
+    void Write4d(std::string context, double v1, double v2, double v3, double v4);
+
+  private:
+    /// The values of a context, not yet written to the file.
+    struct Dataset
+    {
+        uint32_t id;                              //!< Identifier of the dataset in the file
+        std::vector<std::vector<double>> columns; //!< Values kept in memory, by column
+    };
+
+    /**
+     * \param context the context of the data point.
+     * \param values the values of the data point.
+     * \param nValues the number of values.
+     *
+     * \brief Appends a data point to its dataset.
+     */
+    void Append(const std::string& context, const double* values, uint32_t nValues);
+
+    /**
+     * \param dataset the dataset.
+     *
+     * \brief Writes the rows of a dataset kept in memory to the file.
+     */
+    void WriteChunk(Dataset& dataset);
+
+    /// The file name.
+    std::string m_outputFileName;
+
+    /// Used to write values to the file.
+    std::ofstream m_file;
+
+    /// The number of rows of a chunk.
+    uint32_t m_chunkSize;
+
+    /// The datasets, by context.
+    std::unordered_map<std::string, Dataset> m_datasets;
+
+    /// The datasets, by identifier.
+    std::vector<Dataset*> m_datasetsById;
+
+}; // class ColumnarAggregator
+
+} // namespace ns3
+
+#endif // COLUMNAR_AGGREGATOR_H
@@ -23,8 +23,10 @@
 #include "data-collector.h"
 #include "sqlite-output.h"
 
+#include "ns3/boolean.h"
 #include "ns3/log.h"
 #include "ns3/nstime.h"
+#include "ns3/uinteger.h"
 
 #include <sstream>
 
@@ -33,6 +35,11 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("SqliteDataOutput");
 
+/// Command writing a row of the Singletons table
+static const std::string INSERT_SINGLETON = "INSERT INTO Singletons "
+                                            "(run, name, variable, value)"
+                                            "values (?, ?, ?, ?)";
+
 SqliteDataOutput::SqliteDataOutput()
     : DataOutputInterface()
 {
@@ -53,7 +60,22 @@ SqliteDataOutput::GetTypeId()
     static TypeId tid = TypeId("ns3::SqliteDataOutput")
                             .SetParent<DataOutputInterface>()
                             .SetGroupName("Stats")
-                            .AddConstructor<SqliteDataOutput>();
+                            .AddConstructor<SqliteDataOutput>()
+                            .AddAttribute("BatchSize",
+                                          "The number of rows committed in a transaction.",
+                                          UintegerValue(1000),
+                                          MakeUintegerAccessor(&SqliteDataOutput::m_batchSize),
+                                          MakeUintegerChecker<uint32_t>(1))
+                            .AddAttribute("WalMode",
+                                          "Whether the database uses a write-ahead log "
+                                          "(WAL) as journal, without waiting for the data "
+                                          "to reach the disk. Faster, but the data may be "
+                                          "lost if the system crashes, the WAL does not "
+                                          "work on network filesystems, and the -wal and "
+                                          "-shm files are left next to the database.",
+                                          BooleanValue(false),
+                                          MakeBooleanAccessor(&SqliteDataOutput::m_walMode),
+                                          MakeBooleanChecker());
     return tid;
 }
 
@@ -67,77 +89,56 @@ SqliteDataOutput::Output(DataCollector& dc)
     std::string run = dc.GetRunLabel();
     bool res;
 
-    m_sqliteOut = new SQLiteOutput(m_dbFile);
+    m_sqliteOut = Create<SQLiteOutput>(m_dbFile);
+    if (m_walMode)
+    {
+        m_sqliteOut->SetWalMode();
+    }
 
+    // Create the tables before the first row, so that they are not part of
+    // the transactions of the rows
     res = m_sqliteOut->SpinExec("CREATE TABLE IF NOT EXISTS Experiments (run, experiment, "
                                 "strategy, input, description text)");
     NS_ASSERT(res);
-
-    sqlite3_stmt* stmt;
-    res = m_sqliteOut->WaitPrepare(&stmt,
-                                   "INSERT INTO Experiments "
-                                   "(run, experiment, strategy, input, description)"
-                                   "values (?, ?, ?, ?, ?)");
-    NS_ASSERT(res);
-
-    // Create temporary strings to hold their value
-    // throughout the lifetime of the Bind and Step
-    // procedures
-    //
-    // DataCollector could return const std::string&,
-    // but that could break the python bindings
-    res = m_sqliteOut->Bind(stmt, 1, run);
-    NS_ASSERT(res);
-    std::string experimentLabel = dc.GetExperimentLabel();
-    res = m_sqliteOut->Bind(stmt, 2, experimentLabel);
-    NS_ASSERT(res);
-    std::string strategyLabel = dc.GetStrategyLabel();
-    res = m_sqliteOut->Bind(stmt, 3, strategyLabel);
-    NS_ASSERT(res);
-    std::string inputLabel = dc.GetInputLabel();
-    res = m_sqliteOut->Bind(stmt, 4, inputLabel);
-    NS_ASSERT(res);
-    std::string description = dc.GetDescription();
-    res = m_sqliteOut->Bind(stmt, 5, description);
-    NS_ASSERT(res);
-
-    res = m_sqliteOut->SpinStep(stmt);
-    NS_ASSERT(res);
-    res = m_sqliteOut->SpinFinalize(stmt);
-    NS_ASSERT(res == 0);
-
     res = m_sqliteOut->WaitExec("CREATE TABLE IF NOT EXISTS "
                                 "Metadata ( run text, key text, value)");
     NS_ASSERT(res);
+    res = m_sqliteOut->WaitExec("CREATE TABLE IF NOT EXISTS Singletons "
+                                "( run text, name text, variable text, value )");
+    NS_ASSERT(res);
 
-    res = m_sqliteOut->WaitPrepare(&stmt,
-                                   "INSERT INTO Metadata "
-                                   "(run, key, value)"
-                                   "values (?, ?, ?)");
+    m_sqliteOut->SetBatchSize(m_batchSize);
+
+    res = m_sqliteOut->Insert("INSERT INTO Experiments "
+                              "(run, experiment, strategy, input, description)"
+                              "values (?, ?, ?, ?, ?)",
+                              run,
+                              dc.GetExperimentLabel(),
+                              dc.GetStrategyLabel(),
+                              dc.GetInputLabel(),
+                              dc.GetDescription());
     NS_ASSERT(res);
 
     for (MetadataList::iterator i = dc.MetadataBegin(); i != dc.MetadataEnd(); i++)
     {
         std::pair<std::string, std::string> blob = (*i);
-        m_sqliteOut->SpinReset(stmt);
-        m_sqliteOut->Bind(stmt, 1, run);
-        m_sqliteOut->Bind(stmt, 2, blob.first);
-        m_sqliteOut->Bind(stmt, 3, blob.second);
-        m_sqliteOut->SpinStep(stmt);
+        m_sqliteOut->Insert("INSERT INTO Metadata "
+                            "(run, key, value)"
+                            "values (?, ?, ?)",
+                            run,
+                            blob.first,
+                            blob.second);
     }
 
-    m_sqliteOut->SpinFinalize(stmt);
-
-    m_sqliteOut->SpinExec("BEGIN");
     SqliteOutputCallback callback(m_sqliteOut, run);
     for (DataCalculatorList::iterator i = dc.DataCalculatorBegin(); i != dc.DataCalculatorEnd();
          i++)
     {
         (*i)->Output(callback);
     }
-    m_sqliteOut->SpinExec("COMMIT");
+    // The destructor of the database commits the last rows
+    m_sqliteOut = nullptr;
     // end SqliteDataOutput::Output
-    m_sqliteOut->Unref();
 }
 
 SqliteDataOutput::SqliteOutputCallback::SqliteOutputCallback(const Ptr<SQLiteOutput>& db,
@@ -146,20 +147,10 @@ SqliteDataOutput::SqliteOutputCallback::SqliteOutputCallback(const Ptr<SQLiteOut
       m_runLabel(run)
 {
     NS_LOG_FUNCTION(this << db << run);
-
-    m_db->WaitExec("CREATE TABLE IF NOT EXISTS Singletons "
-                   "( run text, name text, variable text, value )");
-
-    m_db->WaitPrepare(&m_insertSingletonStatement,
-                      "INSERT INTO Singletons "
-                      "(run, name, variable, value)"
-                      "values (?, ?, ?, ?)");
-    m_db->Bind(m_insertSingletonStatement, 1, m_runLabel);
 }
 
 SqliteDataOutput::SqliteOutputCallback::~SqliteOutputCallback()
 {
-    m_db->SpinFinalize(m_insertSingletonStatement);
 }
 
 void
@@ -199,11 +190,7 @@ SqliteDataOutput::SqliteOutputCallback::OutputSingleton(std::string key,
 {
     NS_LOG_FUNCTION(this << key << variable << val);
 
-    m_db->SpinReset(m_insertSingletonStatement);
-    m_db->Bind(m_insertSingletonStatement, 2, key);
-    m_db->Bind(m_insertSingletonStatement, 3, variable);
-    m_db->Bind(m_insertSingletonStatement, 4, val);
-    m_db->SpinStep(m_insertSingletonStatement);
+    m_db->Insert(INSERT_SINGLETON, m_runLabel, key, variable, val);
 }
 
 void
@@ -213,11 +200,7 @@ SqliteDataOutput::SqliteOutputCallback::OutputSingleton(std::string key,
 {
     NS_LOG_FUNCTION(this << key << variable << val);
 
-    m_db->SpinReset(m_insertSingletonStatement);
-    m_db->Bind(m_insertSingletonStatement, 2, key);
-    m_db->Bind(m_insertSingletonStatement, 3, variable);
-    m_db->Bind(m_insertSingletonStatement, 4, val);
-    m_db->SpinStep(m_insertSingletonStatement);
+    m_db->Insert(INSERT_SINGLETON, m_runLabel, key, variable, val);
 }
 
 void
@@ -227,11 +210,7 @@ SqliteDataOutput::SqliteOutputCallback::OutputSingleton(std::string key,
 {
     NS_LOG_FUNCTION(this << key << variable << val);
 
-    m_db->SpinReset(m_insertSingletonStatement);
-    m_db->Bind(m_insertSingletonStatement, 2, key);
-    m_db->Bind(m_insertSingletonStatement, 3, variable);
-    m_db->Bind(m_insertSingletonStatement, 4, val);
-    m_db->SpinStep(m_insertSingletonStatement);
+    m_db->Insert(INSERT_SINGLETON, m_runLabel, key, variable, val);
 }
 
 void
@@ -241,11 +220,7 @@ SqliteDataOutput::SqliteOutputCallback::OutputSingleton(std::string key,
 {
     NS_LOG_FUNCTION(this << key << variable << val);
 
-    m_db->SpinReset(m_insertSingletonStatement);
-    m_db->Bind(m_insertSingletonStatement, 2, key);
-    m_db->Bind(m_insertSingletonStatement, 3, variable);
-    m_db->Bind(m_insertSingletonStatement, 4, val);
-    m_db->SpinStep(m_insertSingletonStatement);
+    m_db->Insert(INSERT_SINGLETON, m_runLabel, key, variable, val);
 }
 
 void
@@ -255,11 +230,7 @@ SqliteDataOutput::SqliteOutputCallback::OutputSingleton(std::string key,
 {
     NS_LOG_FUNCTION(this << key << variable << val);
 
-    m_db->SpinReset(m_insertSingletonStatement);
-    m_db->Bind(m_insertSingletonStatement, 2, key);
-    m_db->Bind(m_insertSingletonStatement, 3, variable);
-    m_db->Bind(m_insertSingletonStatement, 4, val.GetTimeStep());
-    m_db->SpinStep(m_insertSingletonStatement);
+    m_db->Insert(INSERT_SINGLETON, m_runLabel, key, variable, val.GetTimeStep());
 }
 
 } // namespace ns3
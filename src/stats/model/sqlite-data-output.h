@@ -24,8 +24,6 @@
 
 #include "ns3/nstime.h"
 
-struct sqlite3_stmt;
-
 namespace ns3
 {
 
@@ -37,6 +35,9 @@ class SQLiteOutput;
  * \ingroup dataoutput
  * \class SqliteDataOutput
  * \brief Outputs data in a format compatible with SQLite
+ *
+ * The rows are committed in transactions of BatchSize rows; the last
+ * transaction is committed at the end of Output.
  */
 class SqliteDataOutput : public DataOutputInterface
 {
@@ -126,12 +127,11 @@ class SqliteDataOutput : public DataOutputInterface
       private:
         Ptr<SQLiteOutput> m_db; //!< Db
         std::string m_runLabel; //!< Run label
-
-        /// Pointer to a Sqlite3 singleton statement
-        sqlite3_stmt* m_insertSingletonStatement;
     };
 
     Ptr<SQLiteOutput> m_sqliteOut; //!< Database
+    uint32_t m_batchSize;          //!< Number of rows of a transaction
+    bool m_walMode;                //!< Whether the journal is a write-ahead log
 };
 
 // end namespace ns3
@@ -20,6 +20,7 @@
 #include "ns3/abort.h"
 #include "ns3/log.h"
 #include "ns3/nstime.h"
+#include "ns3/simulator.h"
 
 #include <fcntl.h>
 #include <sys/stat.h>
@@ -39,6 +40,13 @@ SQLiteOutput::~SQLiteOutput()
 {
     int rc = SQLITE_FAIL;
 
+    m_destroyEvent.Cancel();
+    Flush();
+    for (const auto& statement : m_statements)
+    {
+        SpinFinalize(statement.second);
+    }
+
     rc = sqlite3_close_v2(m_db);
     NS_ABORT_MSG_UNLESS(rc == SQLITE_OK, "Failed to close DB");
 }
@@ -50,6 +58,116 @@ SQLiteOutput::SetJournalInMemory()
     SpinExec("PRAGMA journal_mode = MEMORY");
 }
 
+void
+SQLiteOutput::SetWalMode()
+{
+    NS_LOG_FUNCTION(this);
+    // The pragmas return a row, which sqlite3_exec discards
+    int rc = sqlite3_exec(m_db, "PRAGMA journal_mode = WAL", nullptr, nullptr, nullptr);
+    CheckError(m_db, rc, "PRAGMA journal_mode = WAL", false);
+    rc = sqlite3_exec(m_db, "PRAGMA synchronous = OFF", nullptr, nullptr, nullptr);
+    CheckError(m_db, rc, "PRAGMA synchronous = OFF", false);
+}
+
+void
+SQLiteOutput::SetBatchSize(uint32_t batchSize)
+{
+    NS_LOG_FUNCTION(this << batchSize);
+    NS_ABORT_MSG_IF(batchSize == 0, "The batch size must be positive");
+
+    std::unique_lock lock{m_mutex};
+    m_batchSize = batchSize;
+    if (m_pendingRows >= m_batchSize)
+    {
+        Commit();
+    }
+    // Commit the last rows on Simulator::Destroy, even if the object is never
+    // destroyed
+    if (m_batchSize > 1 && m_destroyEvent.IsExpired())
+    {
+        m_destroyEvent = Simulator::ScheduleDestroy(&SQLiteOutput::Flush, this);
+    }
+}
+
+void
+SQLiteOutput::Flush()
+{
+    NS_LOG_FUNCTION(this);
+    std::unique_lock lock{m_mutex};
+    Commit();
+}
+
+void
+SQLiteOutput::Commit()
+{
+    if (m_inTransaction)
+    {
+        int rc = SpinExec(m_db, "COMMIT");
+        CheckError(m_db, rc, "COMMIT", true);
+        m_inTransaction = false;
+        m_pendingRows = 0;
+    }
+}
+
+sqlite3_stmt*
+SQLiteOutput::GetStatement(const std::string& cmd)
+{
+    std::unique_lock lock{m_mutex};
+    return GetCachedStatement(cmd);
+}
+
+sqlite3_stmt*
+SQLiteOutput::GetCachedStatement(const std::string& cmd)
+{
+    auto it = m_statements.find(cmd);
+    if (it != m_statements.end())
+    {
+        return it->second;
+    }
+
+    sqlite3_stmt* stmt = nullptr;
+    int rc = SpinPrepare(m_db, &stmt, cmd);
+    if (CheckError(m_db, rc, cmd, false))
+    {
+        return nullptr;
+    }
+    m_statements.emplace(cmd, stmt);
+    return stmt;
+}
+
+sqlite3_stmt*
+SQLiteOutput::StartInsert(const std::string& cmd)
+{
+    if (m_batchSize > 1 && !m_inTransaction)
+    {
+        int rc = SpinExec(m_db, "BEGIN");
+        if (CheckError(m_db, rc, "BEGIN", false))
+        {
+            return nullptr;
+        }
+        m_inTransaction = true;
+    }
+
+    sqlite3_stmt* stmt = GetCachedStatement(cmd);
+    if (stmt != nullptr)
+    {
+        SpinReset(stmt);
+    }
+    return stmt;
+}
+
+bool
+SQLiteOutput::EndInsert(sqlite3_stmt* stmt, const std::string& cmd)
+{
+    int rc = SpinStep(stmt);
+    bool error = CheckError(m_db, rc, cmd, false);
+    if (m_inTransaction && ++m_pendingRows >= m_batchSize)
+    {
+        Commit();
+    }
+    return !error;
+}
+
 bool
 SQLiteOutput::SpinExec(const std::string& cmd) const
 {
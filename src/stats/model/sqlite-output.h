@@ -18,11 +18,13 @@
 #ifndef SQLITE_OUTPUT_H
 #define SQLITE_OUTPUT_H
 
+#include "ns3/event-id.h"
 #include "ns3/simple-ref-count.h"
 
 #include <mutex>
 #include <sqlite3.h>
 #include <string>
+#include <unordered_map>
 
 namespace ns3
 {
@@ -41,6 +43,12 @@ namespace ns3
  * recommended to use the "Wait" prefixed methods. Otherwise, if the access to
  * the database is unique, using "Spin" methods will speed up database access.
  *
+ * The rows written with Insert can be grouped in transactions of BatchSize
+ * rows (see SetBatchSize), instead of being committed one at a time, and the
+ * statements they use are prepared once and cached.  The transaction in
+ * progress is committed by Flush, on Simulator::Destroy, and by the
+ * destructor.
+ *
  * The database is opened in the constructor, and closed in the deconstructor.
  */
 class SQLiteOutput : public SimpleRefCount<SQLiteOutput>
@@ -63,6 +71,58 @@ class SQLiteOutput : public SimpleRefCount<SQLiteOutput>
      */
     void SetJournalInMemory();
 
+    /**
+     * \brief Instruct SQLite to use a write-ahead log (WAL) as journal, and
+     * to hand the data to the operating system without waiting for it to reach
+     * the disk (synchronous = OFF). May lead to data losses in case of a crash
+     * of the operating system.
+     */
+    void SetWalMode();
+
+    /**
+     * \brief Group the rows written with Insert in transactions
+     *
+     * The transaction is committed once it holds batchSize rows, by Flush, on
+     * Simulator::Destroy, and by the destructor. The statements executed by
+     * the other methods in the meantime are part of the transaction. With a
+     * batch size of 1 (the default), each row is committed on its own.
+     *
+     * \param batchSize the number of rows of a transaction
+     */
+    void SetBatchSize(uint32_t batchSize);
+
+    /**
+     * \brief Commit the transaction of the rows written with Insert, if any
+     */
+    void Flush();
+
+    /**
+     * \brief Get a prepared statement from the cache of the statements,
+     * waiting on a mutex
+     *
+     * The statement is prepared on the first call; it is finalized by the
+     * destructor and must not be finalized by the caller. The caller has to
+     * reset the statement before reusing it.
+     *
+     * \param cmd Command to prepare inside the statement
+     * \return the statement, or nullptr if the command cannot be prepared
+     */
+    sqlite3_stmt* GetStatement(const std::string& cmd);
+
+    /**
+     * \brief Write a row, waiting on a mutex
+     *
+     * The statement is prepared once and cached, and the row is part of the
+     * current transaction (see SetBatchSize).
+     *
+     * \param cmd The command writing the row, with a parameter per value,
+     * e.g., "INSERT INTO results VALUES (?, ?)"
+     * \param values The values to bind to the parameters
+     * \return true in case of success
+     */
+    template <typename... Ts>
+    bool Insert(const std::string& cmd, const Ts&... values);
+
     /**
      * \brief Execute a command until the return value is OK or an ERROR
      *
@@ -227,10 +287,62 @@ class SQLiteOutput : public SimpleRefCount<SQLiteOutput>
     static bool CheckError(sqlite3* db, int rc, const std::string& cmd, bool hardExit);
 
   private:
-    std::string m_dBname;       //!< Database name
-    mutable std::mutex m_mutex; //!< Mutex
-    sqlite3* m_db{nullptr};     //!< Database pointer
+    /**
+     * \brief Get a prepared statement from the cache of the statements, with
+     * the mutex held
+     * \param cmd Command to prepare inside the statement
+     * \return the statement, or nullptr if the command cannot be prepared
+     */
+    sqlite3_stmt* GetCachedStatement(const std::string& cmd);
+
+    /**
+     * \brief Get the statement of a row to write, starting a transaction if
+     * needed
+     * \param cmd Command writing the row
+     * \return the statement, reset, or nullptr in case of error
+     */
+    sqlite3_stmt* StartInsert(const std::string& cmd);
+
+    /**
+     * \brief Execute the statement of a row, and commit the transaction if it
+     * is full
+     * \param stmt Statement, with its values bound
+     * \param cmd Command of the statement
+     * \return true in case of success
+     */
+    bool EndInsert(sqlite3_stmt* stmt, const std::string& cmd);
+
+    /**
+     * \brief Commit the current transaction, if any, with the mutex held
+     */
+    void Commit();
+
+    std::string m_dBname;        //!< Database name
+    mutable std::mutex m_mutex;  //!< Mutex
+    sqlite3* m_db{nullptr};      //!< Database pointer
+    uint32_t m_batchSize{1};     //!< Number of rows of a transaction
+    uint32_t m_pendingRows{0};   //!< Number of rows of the current transaction
+    bool m_inTransaction{false}; //!< Whether a transaction was started by Insert
+    EventId m_destroyEvent;      //!< Commits the transaction on Simulator::Destroy
+    /// Prepared statements, by command
+    std::unordered_map<std::string, sqlite3_stmt*> m_statements;
 };
 
+template <typename... Ts>
+bool
+SQLiteOutput::Insert(const std::string& cmd, const Ts&... values)
+{
+    std::unique_lock lock{m_mutex};
+
+    sqlite3_stmt* stmt = StartInsert(cmd);
+    if (stmt == nullptr)
+    {
+        return false;
+    }
+    int pos = 0;
+    bool ok = (Bind(stmt, ++pos, values) && ...);
+    return ok && EndInsert(stmt, cmd);
+}
+
 } // namespace ns3
 #endif
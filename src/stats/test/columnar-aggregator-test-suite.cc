@@ -0,0 +1,183 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/columnar-aggregator.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include "ns3/time-series-adaptor.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup stats-tests
+ *
+ * \brief ColumnarAggregator class - Test case for writing and reading back
+ * the datasets.
+ */
+class ColumnarAggregatorTestCase : public TestCase
+{
+  public:
+    ColumnarAggregatorTestCase();
+
+  private:
+    void DoRun() override;
+
+    /// The columns of the datasets read from a file, by context.
+    typedef std::map<std::string, std::vector<std::vector<double>>> Datasets;
+
+    /**
+     * Read a columnar file.
+     * \param fileName the name of the file.
+     * \param [out] datasets the datasets of the file.
+     * \param [out] nChunks the number of chunks of the file.
+     */
+    void ReadFile(const std::string& fileName, Datasets& datasets, uint32_t& nChunks);
+};
+
+ColumnarAggregatorTestCase::ColumnarAggregatorTestCase()
+    : TestCase("columnar aggregator test case")
+{
+}
+
+void
+ColumnarAggregatorTestCase::ReadFile(const std::string& fileName,
+                                     Datasets& datasets,
+                                     uint32_t& nChunks)
+{
+    std::ifstream in(fileName, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    auto u32 = [&bytes](std::size_t offset) {
+        uint32_t val;
+        std::memcpy(&val, &bytes[offset], sizeof(val));
+        return val;
+    };
+
+    NS_TEST_ASSERT_MSG_GT_OR_EQ(bytes.size(), 16, "File header missing");
+    NS_TEST_ASSERT_MSG_EQ(std::memcmp(bytes.data(), "NS3COLS", 8), 0, "Wrong magic");
+    NS_TEST_ASSERT_MSG_EQ(u32(8), 1, "Wrong version");
+
+    std::map<uint32_t, std::string> contexts;
+    nChunks = 0;
+    std::size_t offset = 16;
+    while (offset < bytes.size())
+    {
+        uint32_t type = u32(offset);
+        uint32_t length = u32(offset + 4);
+        std::size_t payload = offset + 8;
+        NS_TEST_ASSERT_MSG_LT_OR_EQ(payload + length, bytes.size(), "Truncated record");
+        if (type == 1)
+        {
+            uint32_t id = u32(payload);
+            contexts[id] = std::string(&bytes[payload + 12], u32(payload + 8));
+            datasets[contexts[id]].resize(u32(payload + 4));
+            NS_TEST_EXPECT_MSG_EQ(length % 8, 0, "Dataset record not padded");
+        }
+        else
+        {
+            NS_TEST_ASSERT_MSG_EQ(type, 2, "Unknown record type");
+            nChunks++;
+            uint32_t nRows = u32(payload + 4);
+            std::size_t start = payload + 8;
+            for (auto& column : datasets[contexts[u32(payload)]])
+            {
+                for (uint32_t i = 0; i < nRows; i++, start += sizeof(double))
+                {
+                    double value;
+                    std::memcpy(&value, &bytes[start], sizeof(value));
+                    column.push_back(value);
+                }
+            }
+            NS_TEST_EXPECT_MSG_EQ(start, payload + length, "Wrong chunk length");
+        }
+        offset = payload + length;
+    }
+}
+
+void
+ColumnarAggregatorTestCase::DoRun()
+{
+    std::string fileName = CreateTempDirFilename("columnar-aggregator.bin");
+    Ptr<ColumnarAggregator> aggregator = CreateObject<ColumnarAggregator>(fileName);
+    aggregator->SetChunkSize(3);
+    aggregator->Enable();
+
+    // Two interleaved datasets, one filling two chunks and a partial one
+    for (int i = 0; i < 7; i++)
+    {
+        aggregator->Write2d("first", i, i * i);
+        if (i % 2 == 0)
+        {
+            aggregator->Write1d("second", -i);
+        }
+    }
+    aggregator->Disable();
+    aggregator->Write1d("second", 1000);
+    aggregator->Enable();
+
+    // A dataset fed through a time series adaptor, as the helpers do
+    Ptr<TimeSeriesAdaptor> adaptor = CreateObject<TimeSeriesAdaptor>();
+    adaptor->TraceConnect("Output",
+                          "adaptor",
+                          MakeCallback(&ColumnarAggregator::Write2d, aggregator));
+    Simulator::Schedule(Seconds(1), &TimeSeriesAdaptor::TraceSinkDouble, adaptor, 0.0, 5.0);
+    Simulator::Schedule(Seconds(2), &TimeSeriesAdaptor::TraceSinkDouble, adaptor, 5.0, 7.0);
+    Simulator::Run();
+    Simulator::Destroy();
+
+    // The aggregator writes the remaining rows when it is destroyed
+    aggregator = nullptr;
+    adaptor = nullptr;
+
+    Datasets datasets;
+    uint32_t nChunks = 0;
+    ReadFile(fileName, datasets, nChunks);
+    NS_TEST_ASSERT_MSG_EQ(datasets.size(), 3, "Wrong number of datasets");
+    // first: 3 + 3 + 1 rows, second: 3 + 1 rows, adaptor: 2 rows
+    NS_TEST_EXPECT_MSG_EQ(nChunks, 6, "Wrong number of chunks");
+
+    std::vector<std::vector<double>> first = {{0, 1, 2, 3, 4, 5, 6}, {0, 1, 4, 9, 16, 25, 36}};
+    std::vector<std::vector<double>> second = {{0, -2, -4, -6}};
+    std::vector<std::vector<double>> series = {{1, 2}, {5, 7}};
+    NS_TEST_EXPECT_MSG_EQ((datasets["first"] == first), true, "Wrong first dataset");
+    NS_TEST_EXPECT_MSG_EQ((datasets["second"] == second), true, "Wrong second dataset");
+    NS_TEST_EXPECT_MSG_EQ((datasets["adaptor"] == series), true, "Wrong adaptor dataset");
+}
+
+/**
+ * \ingroup stats-tests
+ *
+ * \brief ColumnarAggregator TestSuite
+ */
+class ColumnarAggregatorTestSuite : public TestSuite
+{
+  public:
+    ColumnarAggregatorTestSuite();
+};
+
+ColumnarAggregatorTestSuite::ColumnarAggregatorTestSuite()
+    : TestSuite("columnar-aggregator", UNIT)
+{
+    AddTestCase(new ColumnarAggregatorTestCase, TestCase::QUICK);
+}
+
+/// Static variable for test initialization
+static ColumnarAggregatorTestSuite g_columnarAggregatorTestSuite;
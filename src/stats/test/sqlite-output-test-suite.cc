@@ -0,0 +1,239 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/data-calculator.h"
+#include "ns3/data-collector.h"
+#include "ns3/simulator.h"
+#include "ns3/sqlite-data-output.h"
+#include "ns3/sqlite-output.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup stats-tests
+ *
+ * \brief SQLiteOutput class - Test case for the batched inserts.
+ */
+class SQLiteOutputBatchTestCase : public TestCase
+{
+  public:
+    SQLiteOutputBatchTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Count the committed rows of the table, through another connection.
+     * \param dbName the name of the database.
+     * \return the number of rows, or -1 in case of error.
+     */
+    int CountRows(const std::string& dbName);
+};
+
+SQLiteOutputBatchTestCase::SQLiteOutputBatchTestCase()
+    : TestCase("sqlite output batch test case")
+{
+}
+
+int
+SQLiteOutputBatchTestCase::CountRows(const std::string& dbName)
+{
+    Ptr<SQLiteOutput> reader = Create<SQLiteOutput>(dbName);
+    sqlite3_stmt* stmt = reader->GetStatement("SELECT COUNT(*) FROM results");
+    int count = -1;
+    if (stmt != nullptr && SQLiteOutput::SpinStep(stmt) == SQLITE_ROW)
+    {
+        count = reader->RetrieveColumn<int>(stmt, 0);
+    }
+    return count;
+}
+
+void
+SQLiteOutputBatchTestCase::DoRun()
+{
+    std::string dbName = CreateTempDirFilename("sqlite-output-batch.db");
+    std::remove(dbName.c_str());
+
+    Ptr<SQLiteOutput> db = Create<SQLiteOutput>(dbName);
+    db->SetWalMode();
+    bool res = db->SpinExec("CREATE TABLE IF NOT EXISTS results (flow, name, value)");
+    NS_TEST_ASSERT_MSG_EQ(res, true, "Cannot create the table");
+
+    db->SetBatchSize(10);
+    const std::string cmd = "INSERT INTO results VALUES (?, ?, ?)";
+    for (uint32_t flow = 0; flow < 25; flow++)
+    {
+        std::string name = "flow-" + std::to_string(flow);
+        res = db->Insert(cmd, flow, name, flow * 0.5);
+        NS_TEST_ASSERT_MSG_EQ(res, true, "Cannot insert row " << flow);
+    }
+    NS_TEST_EXPECT_MSG_EQ(db->GetStatement(cmd),
+                          db->GetStatement(cmd),
+                          "The statement should be cached");
+
+    // The last 5 rows wait for their transaction to be committed
+    NS_TEST_EXPECT_MSG_EQ(CountRows(dbName), 20, "Wrong number of committed rows");
+    Simulator::Destroy();
+    NS_TEST_EXPECT_MSG_EQ(CountRows(dbName), 25, "Rows not committed on Simulator::Destroy");
+
+    res = db->Insert(cmd, 100, std::string("last"), 1.0);
+    NS_TEST_ASSERT_MSG_EQ(res, true, "Cannot insert the last row");
+    db = nullptr;
+    NS_TEST_EXPECT_MSG_EQ(CountRows(dbName), 26, "Rows not committed by the destructor");
+}
+
+/**
+ * \ingroup stats-tests
+ *
+ * \brief DataCalculator writing singletons, and counting the rows committed
+ * to the database after each of them.
+ */
+class CountingDataCalculator : public DataCalculator
+{
+  public:
+    /**
+     * Constructor
+     * \param dbName the name of the database.
+     * \param nSingletons the number of singletons to write.
+     */
+    CountingDataCalculator(const std::string& dbName, uint32_t nSingletons);
+
+    void Output(DataOutputCallback& callback) const override;
+
+    /// The number of rows committed after each singleton
+    mutable std::vector<int> m_committed;
+
+  private:
+    std::string m_dbName;   //!< The name of the database
+    uint32_t m_nSingletons; //!< The number of singletons to write
+};
+
+CountingDataCalculator::CountingDataCalculator(const std::string& dbName, uint32_t nSingletons)
+    : m_dbName(dbName),
+      m_nSingletons(nSingletons)
+{
+}
+
+void
+CountingDataCalculator::Output(DataOutputCallback& callback) const
+{
+    for (uint32_t i = 0; i < m_nSingletons; i++)
+    {
+        callback.OutputSingleton("counting", "value-" + std::to_string(i), i);
+
+        Ptr<SQLiteOutput> reader = Create<SQLiteOutput>(m_dbName);
+        sqlite3_stmt* stmt = reader->GetStatement("SELECT (SELECT COUNT(*) FROM Experiments) + "
+                                                  "(SELECT COUNT(*) FROM Metadata) + "
+                                                  "(SELECT COUNT(*) FROM Singletons)");
+        int count = -1;
+        if (stmt != nullptr && SQLiteOutput::SpinStep(stmt) == SQLITE_ROW)
+        {
+            count = reader->RetrieveColumn<int>(stmt, 0);
+        }
+        m_committed.push_back(count);
+    }
+}
+
+/**
+ * \ingroup stats-tests
+ *
+ * \brief SqliteDataOutput class - Test case for the rows committed in batches.
+ */
+class SqliteDataOutputBatchTestCase : public TestCase
+{
+  public:
+    SqliteDataOutputBatchTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+SqliteDataOutputBatchTestCase::SqliteDataOutputBatchTestCase()
+    : TestCase("sqlite data output batch test case")
+{
+}
+
+void
+SqliteDataOutputBatchTestCase::DoRun()
+{
+    std::string prefix = CreateTempDirFilename("sqlite-data-output-batch");
+    std::string dbName = prefix + ".db";
+    std::remove(dbName.c_str());
+
+    DataCollector dc;
+    dc.DescribeRun("experiment", "strategy", "input", "run-1");
+    dc.AddMetadata("first", "1");
+    dc.AddMetadata("second", "2");
+    const uint32_t nSingletons = 10;
+    Ptr<CountingDataCalculator> calculator =
+        CreateObject<CountingDataCalculator>(dbName, nSingletons);
+    dc.AddDataCalculator(calculator);
+
+    Ptr<SqliteDataOutput> output = CreateObject<SqliteDataOutput>();
+    output->SetFilePrefix(prefix);
+    output->SetAttribute("BatchSize", UintegerValue(4));
+    output->Output(dc);
+
+    // The experiment and the two metadata rows are written before the
+    // singletons: only the full transactions of 4 rows are committed
+    NS_TEST_ASSERT_MSG_EQ(calculator->m_committed.size(), nSingletons, "Missing singletons");
+    for (uint32_t i = 0; i < nSingletons; i++)
+    {
+        int written = 3 + static_cast<int>(i) + 1;
+        NS_TEST_EXPECT_MSG_EQ(calculator->m_committed[i],
+                              written / 4 * 4,
+                              "Wrong number of committed rows after singleton " << i);
+    }
+
+    // The last row is committed at the end of Output
+    Ptr<SQLiteOutput> reader = Create<SQLiteOutput>(dbName);
+    sqlite3_stmt* stmt = reader->GetStatement("SELECT COUNT(*) FROM Singletons");
+    int count = -1;
+    if (stmt != nullptr && SQLiteOutput::SpinStep(stmt) == SQLITE_ROW)
+    {
+        count = reader->RetrieveColumn<int>(stmt, 0);
+    }
+    NS_TEST_EXPECT_MSG_EQ(count, static_cast<int>(nSingletons), "Rows not committed by Output");
+
+    calculator->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup stats-tests
+ *
+ * \brief SQLiteOutput TestSuite
+ */
+class SQLiteOutputTestSuite : public TestSuite
+{
+  public:
+    SQLiteOutputTestSuite();
+};
+
+SQLiteOutputTestSuite::SQLiteOutputTestSuite()
+    : TestSuite("sqlite-output", UNIT)
+{
+    AddTestCase(new SQLiteOutputBatchTestCase, TestCase::QUICK);
+    AddTestCase(new SqliteDataOutputBatchTestCase, TestCase::QUICK);
+}
+
+/// Static variable for test initialization
+static SQLiteOutputTestSuite g_sqliteOutputTestSuite;
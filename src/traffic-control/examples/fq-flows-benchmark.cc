@@ -0,0 +1,188 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * This program measures the time needed by the flow queuing queue discs
+ * (FqCoDel, FqPie and FqCobalt) to enqueue and dequeue packets belonging to a
+ * large number of flows, as it happens on a bottleneck shared by many flows.
+ * The queue disc is configured with as many flow queues as flows. In each
+ * round, one packet of each flow is enqueued, in a random order of the flows,
+ * then all the packets are dequeued. The first round, which creates the flow
+ * queues, is not measured. The measurements run in a simulation event, as
+ * the queue discs do in a simulation.
+ * The program is run for 1000, 10000 and 100000 flows, unless the number of
+ * flows is given on the command line.
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/packet.h"
+#include "ns3/traffic-control-module.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * A queue disc item whose flow hash is given.
+ */
+class FlowItem : public QueueDiscItem
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param p the packet
+     * \param flowHash the hash of the flow of the packet
+     */
+    FlowItem(Ptr<Packet> p, uint32_t flowHash)
+        : QueueDiscItem(p, Address(), 0),
+          m_flowHash(flowHash)
+    {
+    }
+
+    void AddHeader() override
+    {
+    }
+
+    bool Mark() override
+    {
+        return false;
+    }
+
+    uint32_t Hash(uint32_t perturbation) const override
+    {
+        return m_flowHash;
+    }
+
+  private:
+    uint32_t m_flowHash; //!< the hash of the flow of the packet
+};
+
+/**
+ * Enqueue and dequeue the packets of numFlows flows through a queue disc.
+ *
+ * \param queueDiscType the TypeId of the queue disc
+ * \param numFlows the number of flows
+ * \param numRounds the number of rounds
+ * \param packetSize the packet size in bytes
+ * \return the average time to enqueue and dequeue a packet, in nanoseconds
+ */
+static double
+RunBenchmark(std::string queueDiscType, uint32_t numFlows, uint32_t numRounds, uint32_t packetSize)
+{
+    ObjectFactory factory(queueDiscType);
+    factory.Set("Flows", UintegerValue(numFlows));
+    factory.Set("MaxSize", QueueSizeValue(QueueSize(QueueSizeUnit::PACKETS, 2 * numFlows)));
+    Ptr<QueueDisc> queueDisc = factory.Create<QueueDisc>();
+    if (auto fqCoDel = DynamicCast<FqCoDelQueueDisc>(queueDisc))
+    {
+        fqCoDel->SetQuantum(packetSize);
+    }
+    else if (auto fqPie = DynamicCast<FqPieQueueDisc>(queueDisc))
+    {
+        fqPie->SetQuantum(packetSize);
+    }
+    else if (auto fqCobalt = DynamicCast<FqCobaltQueueDisc>(queueDisc))
+    {
+        fqCobalt->SetQuantum(packetSize);
+    }
+    queueDisc->Initialize();
+
+    std::vector<uint32_t> order(numFlows);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937(1));
+
+    std::vector<Ptr<QueueDiscItem>> items;
+    items.reserve(numFlows);
+    uint64_t packets = 0;
+    std::chrono::steady_clock::duration elapsed{0};
+
+    auto runRound = [&]() {
+        items.clear();
+        for (uint32_t flow : order)
+        {
+            items.push_back(Create<FlowItem>(Create<Packet>(packetSize), flow));
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (auto& item : items)
+        {
+            queueDisc->Enqueue(item);
+        }
+        while (queueDisc->Dequeue())
+        {
+            packets++;
+        }
+        elapsed += std::chrono::steady_clock::now() - start;
+    };
+
+    // The first round creates the flow queues, hence it is not measured
+    runRound();
+    packets = 0;
+    elapsed = std::chrono::steady_clock::duration::zero();
+
+    for (uint32_t round = 0; round < numRounds; round++)
+    {
+        runRound();
+    }
+
+    NS_ABORT_MSG_IF(packets != uint64_t(numFlows) * numRounds, "Packets lost in the queue disc");
+    queueDisc->Dispose();
+    return std::chrono::duration<double, std::nano>(elapsed).count() / packets;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t numFlows = 0;      // number of flows, 0 for 1000, 10000 and 100000
+    uint32_t numRounds = 10;    // number of packets of each flow
+    uint32_t packetSize = 1000; // packet size in bytes
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("numFlows", "The number of flows (0 for 1000, 10000 and 100000)", numFlows);
+    cmd.AddValue("numRounds", "The number of packets of each flow", numRounds);
+    cmd.AddValue("packetSize", "The packet size in bytes", packetSize);
+    cmd.Parse(argc, argv);
+
+    std::vector<uint32_t> flows = {1000, 10000, 100000};
+    if (numFlows)
+    {
+        flows = {numFlows};
+    }
+
+    std::cout << "queue disc\tflows\tns/packet" << std::endl;
+    auto runAll = [&]() {
+        for (std::string type :
+             {"ns3::FqCoDelQueueDisc", "ns3::FqPieQueueDisc", "ns3::FqCobaltQueueDisc"})
+        {
+            for (uint32_t n : flows)
+            {
+                double time = RunBenchmark(type, n, numRounds, packetSize);
+                std::cout << type << "\t" << n << "\t" << time << std::endl;
+            }
+        }
+    };
+    // Run the benchmarks in an event: until the simulation starts, the Time
+    // objects are recorded in case the time resolution changes, and this
+    // bookkeeping would dominate the time spent in the queue discs
+    Simulator::ScheduleNow(runAll);
+    Simulator::Run();
+    Simulator::Destroy();
+    return 0;
+}
@@ -44,16 +44,13 @@ TypeId
 FqCobaltFlow::GetTypeId()
 {
     static TypeId tid = TypeId("ns3::FqCobaltFlow")
-                            .SetParent<QueueDiscClass>()
+                            .SetParent<FqFlow>()
                             .SetGroupName("TrafficControl")
                             .AddConstructor<FqCobaltFlow>();
     return tid;
 }
 
 FqCobaltFlow::FqCobaltFlow()
-    : m_deficit(0),
-      m_status(INACTIVE),
-      m_index(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -63,54 +60,6 @@ FqCobaltFlow::~FqCobaltFlow()
     NS_LOG_FUNCTION(this);
 }
 
-void
-FqCobaltFlow::SetDeficit(uint32_t deficit)
-{
-    NS_LOG_FUNCTION(this << deficit);
-    m_deficit = deficit;
-}
-
-int32_t
-FqCobaltFlow::GetDeficit() const
-{
-    NS_LOG_FUNCTION(this);
-    return m_deficit;
-}
-
-void
-FqCobaltFlow::IncreaseDeficit(int32_t deficit)
-{
-    NS_LOG_FUNCTION(this << deficit);
-    m_deficit += deficit;
-}
-
-void
-FqCobaltFlow::SetStatus(FlowStatus status)
-{
-    NS_LOG_FUNCTION(this);
-    m_status = status;
-}
-
-FqCobaltFlow::FlowStatus
-FqCobaltFlow::GetStatus() const
-{
-    NS_LOG_FUNCTION(this);
-    return m_status;
-}
-
-void
-FqCobaltFlow::SetIndex(uint32_t index)
-{
-    NS_LOG_FUNCTION(this);
-    m_index = index;
-}
-
-uint32_t
-FqCobaltFlow::GetIndex() const
-{
-    return m_index;
-}
-
 NS_OBJECT_ENSURE_REGISTERED(FqCobaltQueueDisc);
 
 TypeId
@@ -225,36 +174,6 @@ FqCobaltQueueDisc::GetQuantum() const
     return m_quantum;
 }
 
-uint32_t
-FqCobaltQueueDisc::SetAssociativeHash(uint32_t flowHash)
-{
-    NS_LOG_FUNCTION(this << flowHash);
-
-    uint32_t h = (flowHash % m_flows);
-    uint32_t innerHash = h % m_setWays;
-    uint32_t outerHash = h - innerHash;
-
-    for (uint32_t i = outerHash; i < outerHash + m_setWays; i++)
-    {
-        auto it = m_flowsIndices.find(i);
-
-        if (it == m_flowsIndices.end() ||
-            (m_tags.find(i) != m_tags.end() && m_tags[i] == flowHash) ||
-            StaticCast<FqCobaltFlow>(GetQueueDiscClass(it->second))->GetStatus() ==
-                FqCobaltFlow::INACTIVE)
-        {
-            // this queue has not been created yet or is associated with this flow
-            // or is inactive, hence we can use it
-            m_tags[i] = flowHash;
-            return i;
-        }
-    }
-
-    // all the queues of the set are used. Use the first queue of the set
-    m_tags[outerHash] = flowHash;
-    return outerHash;
-}
-
 bool
 FqCobaltQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
 {
@@ -283,20 +202,13 @@ FqCobaltQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         }
     }
 
-    if (m_enableSetAssociativeHash)
-    {
-        h = SetAssociativeHash(flowHash);
-    }
-    else
-    {
-        h = flowHash % m_flows;
-    }
+    h = m_flowTable.GetBucket(flowHash);
 
-    Ptr<FqCobaltFlow> flow;
-    if (m_flowsIndices.find(h) == m_flowsIndices.end())
+    uint32_t index = m_flowTable.GetFlowIndex(h);
+    if (index == FqFlowTable::NO_FLOW)
     {
         NS_LOG_DEBUG("Creating a new flow queue with index " << h);
-        flow = m_flowFactory.Create<FqCobaltFlow>();
+        Ptr<FqCobaltFlow> flow = m_flowFactory.Create<FqCobaltFlow>();
         Ptr<QueueDisc> qd = m_queueDiscFactory.Create<QueueDisc>();
         // If Cobalt, Set values of CobaltQueueDisc to match this QueueDisc
         Ptr<CobaltQueueDisc> cobalt = qd->GetObject<CobaltQueueDisc>();
@@ -312,23 +224,13 @@ FqCobaltQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         flow->SetIndex(h);
         AddQueueDiscClass(flow);
 
-        m_flowsIndices[h] = GetNQueueDiscClasses() - 1;
-    }
-    else
-    {
-        flow = StaticCast<FqCobaltFlow>(GetQueueDiscClass(m_flowsIndices[h]));
-    }
-
-    if (flow->GetStatus() == FqCobaltFlow::INACTIVE)
-    {
-        flow->SetStatus(FqCobaltFlow::NEW_FLOW);
-        flow->SetDeficit(m_quantum);
-        m_newFlows.push_back(flow);
+        index = m_flowTable.AddFlow(h, flow);
     }
 
-    flow->GetQueueDisc()->Enqueue(item);
+    m_flowTable.Activate(index, m_quantum);
+    m_flowTable.GetQueueDisc(index)->Enqueue(item);
 
-    NS_LOG_DEBUG("Packet enqueued into flow " << h << "; flow index " << m_flowsIndices[h]);
+    NS_LOG_DEBUG("Packet enqueued into flow " << h << "; flow index " << index);
 
     if (GetCurrentSize() > GetMaxSize())
     {
@@ -344,82 +246,7 @@ FqCobaltQueueDisc::DoDequeue()
 {
     NS_LOG_FUNCTION(this);
 
-    Ptr<FqCobaltFlow> flow;
-    Ptr<QueueDiscItem> item;
-
-    do
-    {
-        bool found = false;
-
-        while (!found && !m_newFlows.empty())
-        {
-            flow = m_newFlows.front();
-
-            if (flow->GetDeficit() <= 0)
-            {
-                NS_LOG_DEBUG("Increase deficit for new flow index " << flow->GetIndex());
-                flow->IncreaseDeficit(m_quantum);
-                flow->SetStatus(FqCobaltFlow::OLD_FLOW);
-                m_oldFlows.push_back(flow);
-                m_newFlows.pop_front();
-            }
-            else
-            {
-                NS_LOG_DEBUG("Found a new flow " << flow->GetIndex() << " with positive deficit");
-                found = true;
-            }
-        }
-
-        while (!found && !m_oldFlows.empty())
-        {
-            flow = m_oldFlows.front();
-
-            if (flow->GetDeficit() <= 0)
-            {
-                NS_LOG_DEBUG("Increase deficit for old flow index " << flow->GetIndex());
-                flow->IncreaseDeficit(m_quantum);
-                m_oldFlows.push_back(flow);
-                m_oldFlows.pop_front();
-            }
-            else
-            {
-                NS_LOG_DEBUG("Found an old flow " << flow->GetIndex() << " with positive deficit");
-                found = true;
-            }
-        }
-
-        if (!found)
-        {
-            NS_LOG_DEBUG("No flow found to dequeue a packet");
-            return nullptr;
-        }
-
-        item = flow->GetQueueDisc()->Dequeue();
-
-        if (!item)
-        {
-            NS_LOG_DEBUG("Could not get a packet from the selected flow queue");
-            if (!m_newFlows.empty())
-            {
-                flow->SetStatus(FqCobaltFlow::OLD_FLOW);
-                m_oldFlows.push_back(flow);
-                m_newFlows.pop_front();
-            }
-            else
-            {
-                flow->SetStatus(FqCobaltFlow::INACTIVE);
-                m_oldFlows.pop_front();
-            }
-        }
-        else
-        {
-            NS_LOG_DEBUG("Dequeued packet " << item->GetPacket());
-        }
-    } while (!item);
-
-    flow->IncreaseDeficit(item->GetSize() * -1);
-
-    return item;
+    return m_flowTable.Dequeue(m_quantum);
 }
 
 bool
@@ -483,6 +310,7 @@ FqCobaltQueueDisc::InitializeParams()
     NS_LOG_FUNCTION(this);
 
     m_flowFactory.SetTypeId("ns3::FqCobaltFlow");
+    m_flowTable.SetBuckets(m_flows, m_enableSetAssociativeHash ? m_setWays : 0);
 
     m_queueDiscFactory.SetTypeId("ns3::CobaltQueueDisc");
     m_queueDiscFactory.Set("MaxSize", QueueSizeValue(GetMaxSize()));
@@ -498,27 +326,14 @@ FqCobaltQueueDisc::FqCobaltDrop()
 {
     NS_LOG_FUNCTION(this);
 
-    uint32_t maxBacklog = 0;
-    uint32_t index = 0;
-    Ptr<QueueDisc> qd;
-
     /* Queue is full! Find the fat flow and drop packet(s) from it */
-    for (uint32_t i = 0; i < GetNQueueDiscClasses(); i++)
-    {
-        qd = GetQueueDiscClass(i)->GetQueueDisc();
-        uint32_t bytes = qd->GetNBytes();
-        if (bytes > maxBacklog)
-        {
-            maxBacklog = bytes;
-            index = i;
-        }
-    }
+    uint32_t index = m_flowTable.GetFatFlow();
+    QueueDisc* qd = m_flowTable.GetQueueDisc(index);
 
     /* Our goal is to drop half of this fat flow backlog */
     uint32_t len = 0;
     uint32_t count = 0;
-    uint32_t threshold = maxBacklog >> 1;
-    qd = GetQueueDiscClass(index)->GetQueueDisc();
+    uint32_t threshold = qd->GetNBytes() >> 1;
     Ptr<QueueDiscItem> item;
 
     do
@@ -27,11 +27,9 @@
 #ifndef FQ_COBALT_QUEUE_DISC
 #define FQ_COBALT_QUEUE_DISC
 
-#include "ns3/object-factory.h"
-#include "ns3/queue-disc.h"
+#include "fq-flow-table.h"
 
-#include <list>
-#include <map>
+#include "ns3/object-factory.h"
 
 namespace ns3
 {
@@ -42,7 +40,7 @@ namespace ns3
  * \brief A flow queue used by the FqCobalt queue disc
  */
 
-class FqCobaltFlow : public QueueDiscClass
+class FqCobaltFlow : public FqFlow
 {
   public:
     /**
@@ -56,58 +54,6 @@ class FqCobaltFlow : public QueueDiscClass
     FqCobaltFlow();
 
     ~FqCobaltFlow() override;
-
-    /**
-     * \enum FlowStatus
-     * \brief Used to determine the status of this flow queue
-     */
-    enum FlowStatus
-    {
-        INACTIVE,
-        NEW_FLOW,
-        OLD_FLOW
-    };
-
-    /**
-     * \brief Set the deficit for this flow
-     * \param deficit the deficit for this flow
-     */
-    void SetDeficit(uint32_t deficit);
-    /**
-     * \brief Get the deficit for this flow
-     * \return the deficit for this flow
-     */
-    int32_t GetDeficit() const;
-    /**
-     * \brief Increase the deficit for this flow
-     * \param deficit the amount by which the deficit is to be increased
-     */
-    void IncreaseDeficit(int32_t deficit);
-    /**
-     * \brief Set the status for this flow
-     * \param status the status for this flow
-     */
-    void SetStatus(FlowStatus status);
-    /**
-     * \brief Get the status of this flow
-     * \return the status of this flow
-     */
-    FlowStatus GetStatus() const;
-    /**
-     * \brief Set the index for this flow
-     * \param index the index for this flow
-     */
-    void SetIndex(uint32_t index);
-    /**
-     * \brief Get the index of this flow
-     * \return the index of this flow
-     */
-    uint32_t GetIndex() const;
-
-  private:
-    int32_t m_deficit;   //!< the deficit for this flow
-    FlowStatus m_status; //!< the status of this flow
-    uint32_t m_index;    //!< the index for this flow
 };
 
 /**
@@ -164,15 +110,6 @@ class FqCobaltQueueDisc : public QueueDisc
      */
     uint32_t FqCobaltDrop();
 
-    /**
-     * Compute the index of the queue for the flow having the given flowHash,
-     * according to the set associative hash approach.
-     *
-     * \param flowHash the hash of the flow 5-tuple
-     * \return the index of the queue for the given flow
-     */
-    uint32_t SetAssociativeHash(uint32_t flowHash);
-
     std::string m_interval;   //!< CoDel interval attribute
     std::string m_target;     //!< CoDel target attribute
     uint32_t m_quantum;       //!< Deficit assigned to flows at each round
@@ -189,11 +126,7 @@ class FqCobaltQueueDisc : public QueueDisc
     double m_Pdrop;       //!< Drop Probability
     Time m_blueThreshold; //!< Threshold to enable blue enhancement
 
-    std::list<Ptr<FqCobaltFlow>> m_newFlows; //!< The list of new flows
-    std::list<Ptr<FqCobaltFlow>> m_oldFlows; //!< The list of old flows
-
-    std::map<uint32_t, uint32_t> m_flowsIndices; //!< Map with the index of class for each flow
-    std::map<uint32_t, uint32_t> m_tags;         //!< Tags used by set associative hash
+    FqFlowTable m_flowTable; //!< The flows and their scheduler
 
     ObjectFactory m_flowFactory;      //!< Factory to create a new flow
     ObjectFactory m_queueDiscFactory; //!< Factory to create a new queue
@@ -38,16 +38,13 @@ TypeId
 FqCoDelFlow::GetTypeId()
 {
     static TypeId tid = TypeId("ns3::FqCoDelFlow")
-                            .SetParent<QueueDiscClass>()
+                            .SetParent<FqFlow>()
                             .SetGroupName("TrafficControl")
                             .AddConstructor<FqCoDelFlow>();
     return tid;
 }
 
 FqCoDelFlow::FqCoDelFlow()
-    : m_deficit(0),
-      m_status(INACTIVE),
-      m_index(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -57,54 +54,6 @@ FqCoDelFlow::~FqCoDelFlow()
     NS_LOG_FUNCTION(this);
 }
 
-void
-FqCoDelFlow::SetDeficit(uint32_t deficit)
-{
-    NS_LOG_FUNCTION(this << deficit);
-    m_deficit = deficit;
-}
-
-int32_t
-FqCoDelFlow::GetDeficit() const
-{
-    NS_LOG_FUNCTION(this);
-    return m_deficit;
-}
-
-void
-FqCoDelFlow::IncreaseDeficit(int32_t deficit)
-{
-    NS_LOG_FUNCTION(this << deficit);
-    m_deficit += deficit;
-}
-
-void
-FqCoDelFlow::SetStatus(FlowStatus status)
-{
-    NS_LOG_FUNCTION(this);
-    m_status = status;
-}
-
-FqCoDelFlow::FlowStatus
-FqCoDelFlow::GetStatus() const
-{
-    NS_LOG_FUNCTION(this);
-    return m_status;
-}
-
-void
-FqCoDelFlow::SetIndex(uint32_t index)
-{
-    NS_LOG_FUNCTION(this);
-    m_index = index;
-}
-
-uint32_t
-FqCoDelFlow::GetIndex() const
-{
-    return m_index;
-}
-
 NS_OBJECT_ENSURE_REGISTERED(FqCoDelQueueDisc);
 
 TypeId
@@ -199,36 +148,6 @@ FqCoDelQueueDisc::GetQuantum() const
     return m_quantum;
 }
 
-uint32_t
-FqCoDelQueueDisc::SetAssociativeHash(uint32_t flowHash)
-{
-    NS_LOG_FUNCTION(this << flowHash);
-
-    uint32_t h = (flowHash % m_flows);
-    uint32_t innerHash = h % m_setWays;
-    uint32_t outerHash = h - innerHash;
-
-    for (uint32_t i = outerHash; i < outerHash + m_setWays; i++)
-    {
-        auto it = m_flowsIndices.find(i);
-
-        if (it == m_flowsIndices.end() ||
-            (m_tags.find(i) != m_tags.end() && m_tags[i] == flowHash) ||
-            StaticCast<FqCoDelFlow>(GetQueueDiscClass(it->second))->GetStatus() ==
-                FqCoDelFlow::INACTIVE)
-        {
-            // this queue has not been created yet or is associated with this flow
-            // or is inactive, hence we can use it
-            m_tags[i] = flowHash;
-            return i;
-        }
-    }
-
-    // all the queues of the set are used. Use the first queue of the set
-    m_tags[outerHash] = flowHash;
-    return outerHash;
-}
-
 bool
 FqCoDelQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
 {
@@ -257,20 +176,13 @@ FqCoDelQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         }
     }
 
-    if (m_enableSetAssociativeHash)
-    {
-        h = SetAssociativeHash(flowHash);
-    }
-    else
-    {
-        h = flowHash % m_flows;
-    }
+    h = m_flowTable.GetBucket(flowHash);
 
-    Ptr<FqCoDelFlow> flow;
-    if (m_flowsIndices.find(h) == m_flowsIndices.end())
+    uint32_t index = m_flowTable.GetFlowIndex(h);
+    if (index == FqFlowTable::NO_FLOW)
     {
         NS_LOG_DEBUG("Creating a new flow queue with index " << h);
-        flow = m_flowFactory.Create<FqCoDelFlow>();
+        Ptr<FqCoDelFlow> flow = m_flowFactory.Create<FqCoDelFlow>();
         Ptr<QueueDisc> qd = m_queueDiscFactory.Create<QueueDisc>();
         // If CoDel, Set values of CoDelQueueDisc to match this QueueDisc
         Ptr<CoDelQueueDisc> codel = qd->GetObject<CoDelQueueDisc>();
@@ -285,23 +197,13 @@ FqCoDelQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         flow->SetIndex(h);
         AddQueueDiscClass(flow);
 
-        m_flowsIndices[h] = GetNQueueDiscClasses() - 1;
-    }
-    else
-    {
-        flow = StaticCast<FqCoDelFlow>(GetQueueDiscClass(m_flowsIndices[h]));
-    }
-
-    if (flow->GetStatus() == FqCoDelFlow::INACTIVE)
-    {
-        flow->SetStatus(FqCoDelFlow::NEW_FLOW);
-        flow->SetDeficit(m_quantum);
-        m_newFlows.push_back(flow);
+        index = m_flowTable.AddFlow(h, flow);
     }
 
-    flow->GetQueueDisc()->Enqueue(item);
+    m_flowTable.Activate(index, m_quantum);
+    m_flowTable.GetQueueDisc(index)->Enqueue(item);
 
-    NS_LOG_DEBUG("Packet enqueued into flow " << h << "; flow index " << m_flowsIndices[h]);
+    NS_LOG_DEBUG("Packet enqueued into flow " << h << "; flow index " << index);
 
     if (GetCurrentSize() > GetMaxSize())
     {
@@ -317,80 +219,7 @@ FqCoDelQueueDisc::DoDequeue()
 {
     NS_LOG_FUNCTION(this);
 
-    Ptr<FqCoDelFlow> flow;
-    Ptr<QueueDiscItem> item;
-
-    do
-    {
-        bool found = false;
-
-        while (!found && !m_newFlows.empty())
-        {
-            flow = m_newFlows.front();
-
-            if (flow->GetDeficit() <= 0)
-            {
-                NS_LOG_DEBUG("Increase deficit for new flow index " << flow->GetIndex());
-                flow->IncreaseDeficit(m_quantum);
-                flow->SetStatus(FqCoDelFlow::OLD_FLOW);
-                m_oldFlows.splice(m_oldFlows.end(), m_newFlows, m_newFlows.begin());
-            }
-            else
-            {
-                NS_LOG_DEBUG("Found a new flow " << flow->GetIndex() << " with positive deficit");
-                found = true;
-            }
-        }
-
-        while (!found && !m_oldFlows.empty())
-        {
-            flow = m_oldFlows.front();
-
-            if (flow->GetDeficit() <= 0)
-            {
-                NS_LOG_DEBUG("Increase deficit for old flow index " << flow->GetIndex());
-                flow->IncreaseDeficit(m_quantum);
-                m_oldFlows.splice(m_oldFlows.end(), m_oldFlows, m_oldFlows.begin());
-            }
-            else
-            {
-                NS_LOG_DEBUG("Found an old flow " << flow->GetIndex() << " with positive deficit");
-                found = true;
-            }
-        }
-
-        if (!found)
-        {
-            NS_LOG_DEBUG("No flow found to dequeue a packet");
-            return nullptr;
-        }
-
-        item = flow->GetQueueDisc()->Dequeue();
-
-        if (!item)
-        {
-            NS_LOG_DEBUG("Could not get a packet from the selected flow queue");
-            if (!m_newFlows.empty())
-            {
-                flow->SetStatus(FqCoDelFlow::OLD_FLOW);
-                m_oldFlows.push_back(flow);
-                m_newFlows.pop_front();
-            }
-            else
-            {
-                flow->SetStatus(FqCoDelFlow::INACTIVE);
-                m_oldFlows.pop_front();
-            }
-        }
-        else
-        {
-            NS_LOG_DEBUG("Dequeued packet " << item->GetPacket());
-        }
-    } while (!item);
-
-    flow->IncreaseDeficit(item->GetSize() * -1);
-
-    return item;
+    return m_flowTable.Dequeue(m_quantum);
 }
 
 bool
@@ -454,6 +283,7 @@ FqCoDelQueueDisc::InitializeParams()
     NS_LOG_FUNCTION(this);
 
     m_flowFactory.SetTypeId("ns3::FqCoDelFlow");
+    m_flowTable.SetBuckets(m_flows, m_enableSetAssociativeHash ? m_setWays : 0);
 
     m_queueDiscFactory.SetTypeId("ns3::CoDelQueueDisc");
     m_queueDiscFactory.Set("MaxSize", QueueSizeValue(GetMaxSize()));
@@ -466,27 +296,14 @@ FqCoDelQueueDisc::FqCoDelDrop()
 {
     NS_LOG_FUNCTION(this);
 
-    uint32_t maxBacklog = 0;
-    uint32_t index = 0;
-    Ptr<QueueDisc> qd;
-
     /* Queue is full! Find the fat flow and drop packet(s) from it */
-    for (uint32_t i = 0; i < GetNQueueDiscClasses(); i++)
-    {
-        qd = GetQueueDiscClass(i)->GetQueueDisc();
-        uint32_t bytes = qd->GetNBytes();
-        if (bytes > maxBacklog)
-        {
-            maxBacklog = bytes;
-            index = i;
-        }
-    }
+    uint32_t index = m_flowTable.GetFatFlow();
+    QueueDisc* qd = m_flowTable.GetQueueDisc(index);
 
     /* Our goal is to drop half of this fat flow backlog */
     uint32_t len = 0;
     uint32_t count = 0;
-    uint32_t threshold = maxBacklog >> 1;
-    qd = GetQueueDiscClass(index)->GetQueueDisc();
+    uint32_t threshold = qd->GetNBytes() >> 1;
     Ptr<QueueDiscItem> item;
 
     do
@@ -0,0 +1,321 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "fq-flow-table.h"
+
+#include "ns3/log.h"
+#include "ns3/packet.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("FqFlowTable");
+
+NS_OBJECT_ENSURE_REGISTERED(FqFlow);
+
+TypeId
+FqFlow::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::FqFlow")
+                            .SetParent<QueueDiscClass>()
+                            .SetGroupName("TrafficControl")
+                            .AddConstructor<FqFlow>();
+    return tid;
+}
+
+FqFlow::FqFlow()
+    : m_deficit(0),
+      m_status(INACTIVE),
+      m_index(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+FqFlow::~FqFlow()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+FqFlow::SetDeficit(uint32_t deficit)
+{
+    NS_LOG_FUNCTION(this << deficit);
+    m_deficit = deficit;
+}
+
+int32_t
+FqFlow::GetDeficit() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_deficit;
+}
+
+void
+FqFlow::IncreaseDeficit(int32_t deficit)
+{
+    NS_LOG_FUNCTION(this << deficit);
+    m_deficit += deficit;
+}
+
+void
+FqFlow::SetStatus(FlowStatus status)
+{
+    NS_LOG_FUNCTION(this);
+    m_status = status;
+}
+
+FqFlow::FlowStatus
+FqFlow::GetStatus() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_status;
+}
+
+void
+FqFlow::SetIndex(uint32_t index)
+{
+    NS_LOG_FUNCTION(this);
+    m_index = index;
+}
+
+uint32_t
+FqFlow::GetIndex() const
+{
+    return m_index;
+}
+
+FqFlowTable::FqFlowTable()
+    : m_setWays(0),
+      m_newFlows{NO_FLOW, NO_FLOW},
+      m_oldFlows{NO_FLOW, NO_FLOW}
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+FqFlowTable::SetBuckets(uint32_t nBuckets, uint32_t setWays)
+{
+    NS_LOG_FUNCTION(this << nBuckets << setWays);
+    m_flows.clear();
+    m_buckets.assign(nBuckets, NO_FLOW);
+    m_tags.assign(setWays ? nBuckets : 0, 0);
+    m_tagged.assign(setWays ? nBuckets : 0, false);
+    m_setWays = setWays;
+    m_newFlows = {NO_FLOW, NO_FLOW};
+    m_oldFlows = {NO_FLOW, NO_FLOW};
+}
+
+uint32_t
+FqFlowTable::GetBucket(uint32_t flowHash)
+{
+    uint32_t h = flowHash % m_buckets.size();
+    if (m_setWays == 0)
+    {
+        return h;
+    }
+
+    uint32_t innerHash = h % m_setWays;
+    uint32_t outerHash = h - innerHash;
+
+    for (uint32_t i = outerHash; i < outerHash + m_setWays; i++)
+    {
+        if (m_buckets[i] == NO_FLOW || (m_tagged[i] && m_tags[i] == flowHash) ||
+            m_flows[m_buckets[i]].flow->GetStatus() == FqFlow::INACTIVE)
+        {
+            // this queue has not been created yet or is associated with this flow
+            // or is inactive, hence we can use it
+            m_tags[i] = flowHash;
+            m_tagged[i] = true;
+            return i;
+        }
+    }
+
+    // all the queues of the set are used. Use the first queue of the set
+    m_tags[outerHash] = flowHash;
+    m_tagged[outerHash] = true;
+    return outerHash;
+}
+
+uint32_t
+FqFlowTable::GetFlowIndex(uint32_t bucket) const
+{
+    return m_buckets[bucket];
+}
+
+uint32_t
+FqFlowTable::AddFlow(uint32_t bucket, Ptr<FqFlow> flow)
+{
+    NS_LOG_FUNCTION(this << bucket << flow);
+    NS_ASSERT(m_buckets[bucket] == NO_FLOW);
+    uint32_t index = m_flows.size();
+    m_flows.push_back({flow, PeekPointer(flow->GetQueueDisc()), NO_FLOW});
+    m_buckets[bucket] = index;
+    return index;
+}
+
+FqFlow*
+FqFlowTable::GetFlow(uint32_t index) const
+{
+    return PeekPointer(m_flows[index].flow);
+}
+
+QueueDisc*
+FqFlowTable::GetQueueDisc(uint32_t index) const
+{
+    return m_flows[index].queueDisc;
+}
+
+void
+FqFlowTable::Activate(uint32_t index, uint32_t quantum)
+{
+    FqFlow* flow = PeekPointer(m_flows[index].flow);
+    if (flow->GetStatus() == FqFlow::INACTIVE)
+    {
+        flow->SetStatus(FqFlow::NEW_FLOW);
+        flow->SetDeficit(quantum);
+        PushBack(m_newFlows, index);
+    }
+}
+
+Ptr<QueueDiscItem>
+FqFlowTable::Dequeue(uint32_t quantum)
+{
+    NS_LOG_FUNCTION(this << quantum);
+
+    FqFlow* flow = nullptr;
+    uint32_t index = NO_FLOW;
+    Ptr<QueueDiscItem> item;
+
+    do
+    {
+        bool found = false;
+
+        while (!found && m_newFlows.head != NO_FLOW)
+        {
+            index = m_newFlows.head;
+            flow = PeekPointer(m_flows[index].flow);
+
+            if (flow->GetDeficit() <= 0)
+            {
+                NS_LOG_DEBUG("Increase deficit for new flow index " << flow->GetIndex());
+                flow->IncreaseDeficit(quantum);
+                flow->SetStatus(FqFlow::OLD_FLOW);
+                PushBack(m_oldFlows, PopFront(m_newFlows));
+            }
+            else
+            {
+                NS_LOG_DEBUG("Found a new flow " << flow->GetIndex() << " with positive deficit");
+                found = true;
+            }
+        }
+
+        while (!found && m_oldFlows.head != NO_FLOW)
+        {
+            index = m_oldFlows.head;
+            flow = PeekPointer(m_flows[index].flow);
+
+            if (flow->GetDeficit() <= 0)
+            {
+                NS_LOG_DEBUG("Increase deficit for old flow index " << flow->GetIndex());
+                flow->IncreaseDeficit(quantum);
+                PushBack(m_oldFlows, PopFront(m_oldFlows));
+            }
+            else
+            {
+                NS_LOG_DEBUG("Found an old flow " << flow->GetIndex() << " with positive deficit");
+                found = true;
+            }
+        }
+
+        if (!found)
+        {
+            NS_LOG_DEBUG("No flow found to dequeue a packet");
+            return nullptr;
+        }
+
+        item = m_flows[index].queueDisc->Dequeue();
+
+        if (!item)
+        {
+            NS_LOG_DEBUG("Could not get a packet from the selected flow queue");
+            if (m_newFlows.head != NO_FLOW)
+            {
+                flow->SetStatus(FqFlow::OLD_FLOW);
+                PushBack(m_oldFlows, PopFront(m_newFlows));
+            }
+            else
+            {
+                flow->SetStatus(FqFlow::INACTIVE);
+                PopFront(m_oldFlows);
+            }
+        }
+        else
+        {
+            NS_LOG_DEBUG("Dequeued packet " << item->GetPacket());
+        }
+    } while (!item);
+
+    flow->IncreaseDeficit(item->GetSize() * -1);
+
+    return item;
+}
+
+uint32_t
+FqFlowTable::GetFatFlow() const
+{
+    uint32_t maxBacklog = 0;
+    uint32_t index = 0;
+
+    for (uint32_t i = 0; i < m_flows.size(); i++)
+    {
+        uint32_t bytes = m_flows[i].queueDisc->GetNBytes();
+        if (bytes > maxBacklog)
+        {
+            maxBacklog = bytes;
+            index = i;
+        }
+    }
+    return index;
+}
+
+void
+FqFlowTable::PushBack(List& list, uint32_t index)
+{
+    m_flows[index].next = NO_FLOW;
+    if (list.tail == NO_FLOW)
+    {
+        list.head = index;
+    }
+    else
+    {
+        m_flows[list.tail].next = index;
+    }
+    list.tail = index;
+}
+
+uint32_t
+FqFlowTable::PopFront(List& list)
+{
+    NS_ASSERT(list.head != NO_FLOW);
+    uint32_t index = list.head;
+    list.head = m_flows[index].next;
+    if (list.head == NO_FLOW)
+    {
+        list.tail = NO_FLOW;
+    }
+    return index;
+}
+
+} // namespace ns3
@@ -0,0 +1,215 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FQ_FLOW_TABLE_H
+#define FQ_FLOW_TABLE_H
+
+#include "queue-disc.h"
+
+#include <limits>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A flow queue used by the flow queuing (FQ) queue discs
+ */
+class FqFlow : public QueueDiscClass
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    /**
+     * \brief FqFlow constructor
+     */
+    FqFlow();
+
+    ~FqFlow() override;
+
+    /**
+     * \enum FlowStatus
+     * \brief Used to determine the status of this flow queue
+     */
+    enum FlowStatus
+    {
+        INACTIVE,
+        NEW_FLOW,
+        OLD_FLOW
+    };
+
+    /**
+     * \brief Set the deficit for this flow
+     * \param deficit the deficit for this flow
+     */
+    void SetDeficit(uint32_t deficit);
+    /**
+     * \brief Get the deficit for this flow
+     * \return the deficit for this flow
+     */
+    int32_t GetDeficit() const;
+    /**
+     * \brief Increase the deficit for this flow
+     * \param deficit the amount by which the deficit is to be increased
+     */
+    void IncreaseDeficit(int32_t deficit);
+    /**
+     * \brief Set the status for this flow
+     * \param status the status for this flow
+     */
+    void SetStatus(FlowStatus status);
+    /**
+     * \brief Get the status of this flow
+     * \return the status of this flow
+     */
+    FlowStatus GetStatus() const;
+    /**
+     * \brief Set the index for this flow
+     * \param index the index for this flow
+     */
+    void SetIndex(uint32_t index);
+    /**
+     * \brief Get the index of this flow
+     * \return the index of this flow
+     */
+    uint32_t GetIndex() const;
+
+  private:
+    int32_t m_deficit;   //!< the deficit for this flow
+    FlowStatus m_status; //!< the status of this flow
+    uint32_t m_index;    //!< the index for this flow
+};
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief The flows of a flow queuing (FQ) queue disc, and their deficit
+ * round robin scheduler.
+ *
+ * The flows are kept in an array, in the order in which they are created,
+ * which is also the order of the classes of the queue disc.  The hash
+ * buckets are mapped to the flows by an array indexed by bucket, and the
+ * lists of new and old flows are linked through the array of flows, so that
+ * enqueuing and dequeuing a packet neither searches a map nor allocates
+ * memory.  This class is shared by FqCoDelQueueDisc, FqPieQueueDisc and
+ * FqCobaltQueueDisc.
+ */
+class FqFlowTable
+{
+  public:
+    /// The index of no flow
+    static constexpr uint32_t NO_FLOW = std::numeric_limits<uint32_t>::max();
+
+    FqFlowTable();
+
+    /**
+     * \brief Set the number of hash buckets, and remove all the flows
+     * \param nBuckets the number of buckets, i.e., the maximum number of flows
+     * \param setWays the size of a set of buckets used by set associative
+     *        hash, or 0 to map the flow hashes directly to the buckets
+     */
+    void SetBuckets(uint32_t nBuckets, uint32_t setWays);
+    /**
+     * \brief Compute the bucket of a flow, according to the set associative
+     * hash approach if enabled.
+     * \param flowHash the hash of the flow 5-tuple
+     * \return the bucket of the flow
+     */
+    uint32_t GetBucket(uint32_t flowHash);
+    /**
+     * \param bucket the bucket
+     * \return the index of the flow of the bucket, or NO_FLOW if the flow
+     * has not been created yet
+     */
+    uint32_t GetFlowIndex(uint32_t bucket) const;
+    /**
+     * \brief Add the flow of a bucket, after the queue disc added it to its classes.
+     * \param bucket the bucket
+     * \param flow the flow, with its queue disc
+     * \return the index of the flow
+     */
+    uint32_t AddFlow(uint32_t bucket, Ptr<FqFlow> flow);
+    /**
+     * \param index the index of a flow
+     * \return the flow
+     */
+    FqFlow* GetFlow(uint32_t index) const;
+    /**
+     * \param index the index of a flow
+     * \return the queue disc of the flow
+     */
+    QueueDisc* GetQueueDisc(uint32_t index) const;
+    /**
+     * \brief Add an inactive flow to the new flows, with a deficit of one quantum.
+     * \param index the index of the flow
+     * \param quantum the quantum
+     */
+    void Activate(uint32_t index, uint32_t quantum);
+    /**
+     * \brief Dequeue a packet from the flows, with the deficit round robin
+     * scheduler giving the priority to the new flows.
+     * \param quantum the deficit added to the flows at each round
+     * \return the packet, or nullptr if the flows are empty
+     */
+    Ptr<QueueDiscItem> Dequeue(uint32_t quantum);
+    /**
+     * \return the index of the flow with the largest backlog in bytes
+     */
+    uint32_t GetFatFlow() const;
+
+  private:
+    /// A flow, and its link in the list of new or old flows
+    struct Flow
+    {
+        Ptr<FqFlow> flow;     //!< the flow
+        QueueDisc* queueDisc; //!< the queue disc of the flow
+        uint32_t next;        //!< the next flow in its list
+    };
+
+    /// A list of flows
+    struct List
+    {
+        uint32_t head; //!< the first flow
+        uint32_t tail; //!< the last flow
+    };
+
+    /**
+     * \param list the list
+     * \param index the flow to append to the list
+     */
+    void PushBack(List& list, uint32_t index);
+    /**
+     * \param list the list, not empty
+     * \return the flow removed from the head of the list
+     */
+    uint32_t PopFront(List& list);
+
+    std::vector<Flow> m_flows;       //!< the flows, by index
+    std::vector<uint32_t> m_buckets; //!< the index of the flow of each bucket
+    std::vector<uint32_t> m_tags;    //!< the flow hash of each bucket, for set associative hash
+    std::vector<bool> m_tagged;      //!< whether each bucket has a tag
+    uint32_t m_setWays;              //!< the size of a set of buckets, or 0
+    List m_newFlows;                 //!< the list of new flows
+    List m_oldFlows;                 //!< the list of old flows
+};
+
+} // namespace ns3
+
+#endif /* FQ_FLOW_TABLE_H */
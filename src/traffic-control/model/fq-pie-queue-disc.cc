@@ -43,16 +43,13 @@ TypeId
 FqPieFlow::GetTypeId()
 {
     static TypeId tid = TypeId("ns3::FqPieFlow")
-                            .SetParent<QueueDiscClass>()
+                            .SetParent<FqFlow>()
                             .SetGroupName("TrafficControl")
                             .AddConstructor<FqPieFlow>();
     return tid;
 }
 
 FqPieFlow::FqPieFlow()
-    : m_deficit(0),
-      m_status(INACTIVE),
-      m_index(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -62,54 +59,6 @@ FqPieFlow::~FqPieFlow()
     NS_LOG_FUNCTION(this);
 }
 
-void
-FqPieFlow::SetDeficit(uint32_t deficit)
-{
-    NS_LOG_FUNCTION(this << deficit);
-    m_deficit = deficit;
-}
-
-int32_t
-FqPieFlow::GetDeficit() const
-{
-    NS_LOG_FUNCTION(this);
-    return m_deficit;
-}
-
-void
-FqPieFlow::IncreaseDeficit(int32_t deficit)
-{
-    NS_LOG_FUNCTION(this << deficit);
-    m_deficit += deficit;
-}
-
-void
-FqPieFlow::SetStatus(FlowStatus status)
-{
-    NS_LOG_FUNCTION(this);
-    m_status = status;
-}
-
-FqPieFlow::FlowStatus
-FqPieFlow::GetStatus() const
-{
-    NS_LOG_FUNCTION(this);
-    return m_status;
-}
-
-void
-FqPieFlow::SetIndex(uint32_t index)
-{
-    NS_LOG_FUNCTION(this);
-    m_index = index;
-}
-
-uint32_t
-FqPieFlow::GetIndex() const
-{
-    return m_index;
-}
-
 NS_OBJECT_ENSURE_REGISTERED(FqPieQueueDisc);
 
 TypeId
@@ -254,36 +203,6 @@ FqPieQueueDisc::GetQuantum() const
     return m_quantum;
 }
 
-uint32_t
-FqPieQueueDisc::SetAssociativeHash(uint32_t flowHash)
-{
-    NS_LOG_FUNCTION(this << flowHash);
-
-    uint32_t h = (flowHash % m_flows);
-    uint32_t innerHash = h % m_setWays;
-    uint32_t outerHash = h - innerHash;
-
-    for (uint32_t i = outerHash; i < outerHash + m_setWays; i++)
-    {
-        auto it = m_flowsIndices.find(i);
-
-        if (it == m_flowsIndices.end() ||
-            (m_tags.find(i) != m_tags.end() && m_tags[i] == flowHash) ||
-            StaticCast<FqPieFlow>(GetQueueDiscClass(it->second))->GetStatus() ==
-                FqPieFlow::INACTIVE)
-        {
-            // this queue has not been created yet or is associated with this flow
-            // or is inactive, hence we can use it
-            m_tags[i] = flowHash;
-            return i;
-        }
-    }
-
-    // all the queues of the set are used. Use the first queue of the set
-    m_tags[outerHash] = flowHash;
-    return outerHash;
-}
-
 bool
 FqPieQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
 {
@@ -312,20 +231,13 @@ FqPieQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         }
     }
 
-    if (m_enableSetAssociativeHash)
-    {
-        h = SetAssociativeHash(flowHash);
-    }
-    else
-    {
-        h = flowHash % m_flows;
-    }
+    h = m_flowTable.GetBucket(flowHash);
 
-    Ptr<FqPieFlow> flow;
-    if (m_flowsIndices.find(h) == m_flowsIndices.end())
+    uint32_t index = m_flowTable.GetFlowIndex(h);
+    if (index == FqFlowTable::NO_FLOW)
     {
         NS_LOG_DEBUG("Creating a new flow queue with index " << h);
-        flow = m_flowFactory.Create<FqPieFlow>();
+        Ptr<FqPieFlow> flow = m_flowFactory.Create<FqPieFlow>();
         Ptr<QueueDisc> qd = m_queueDiscFactory.Create<QueueDisc>();
         // If Pie, Set values of PieQueueDisc to match this QueueDisc
         Ptr<PieQueueDisc> pie = qd->GetObject<PieQueueDisc>();
@@ -340,23 +252,13 @@ FqPieQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         flow->SetIndex(h);
         AddQueueDiscClass(flow);
 
-        m_flowsIndices[h] = GetNQueueDiscClasses() - 1;
-    }
-    else
-    {
-        flow = StaticCast<FqPieFlow>(GetQueueDiscClass(m_flowsIndices[h]));
-    }
-
-    if (flow->GetStatus() == FqPieFlow::INACTIVE)
-    {
-        flow->SetStatus(FqPieFlow::NEW_FLOW);
-        flow->SetDeficit(m_quantum);
-        m_newFlows.push_back(flow);
+        index = m_flowTable.AddFlow(h, flow);
     }
 
-    flow->GetQueueDisc()->Enqueue(item);
+    m_flowTable.Activate(index, m_quantum);
+    m_flowTable.GetQueueDisc(index)->Enqueue(item);
 
-    NS_LOG_DEBUG("Packet enqueued into flow " << h << "; flow index " << m_flowsIndices[h]);
+    NS_LOG_DEBUG("Packet enqueued into flow " << h << "; flow index " << index);
 
     if (GetCurrentSize() > GetMaxSize())
     {
@@ -372,82 +274,7 @@ FqPieQueueDisc::DoDequeue()
 {
     NS_LOG_FUNCTION(this);
 
-    Ptr<FqPieFlow> flow;
-    Ptr<QueueDiscItem> item;
-
-    do
-    {
-        bool found = false;
-
-        while (!found && !m_newFlows.empty())
-        {
-            flow = m_newFlows.front();
-
-            if (flow->GetDeficit() <= 0)
-            {
-                NS_LOG_DEBUG("Increase deficit for new flow index " << flow->GetIndex());
-                flow->IncreaseDeficit(m_quantum);
-                flow->SetStatus(FqPieFlow::OLD_FLOW);
-                m_oldFlows.push_back(flow);
-                m_newFlows.pop_front();
-            }
-            else
-            {
-                NS_LOG_DEBUG("Found a new flow " << flow->GetIndex() << " with positive deficit");
-                found = true;
-            }
-        }
-
-        while (!found && !m_oldFlows.empty())
-        {
-            flow = m_oldFlows.front();
-
-            if (flow->GetDeficit() <= 0)
-            {
-                NS_LOG_DEBUG("Increase deficit for old flow index " << flow->GetIndex());
-                flow->IncreaseDeficit(m_quantum);
-                m_oldFlows.push_back(flow);
-                m_oldFlows.pop_front();
-            }
-            else
-            {
-                NS_LOG_DEBUG("Found an old flow " << flow->GetIndex() << " with positive deficit");
-                found = true;
-            }
-        }
-
-        if (!found)
-        {
-            NS_LOG_DEBUG("No flow found to dequeue a packet");
-            return nullptr;
-        }
-
-        item = flow->GetQueueDisc()->Dequeue();
-
-        if (!item)
-        {
-            NS_LOG_DEBUG("Could not get a packet from the selected flow queue");
-            if (!m_newFlows.empty())
-            {
-                flow->SetStatus(FqPieFlow::OLD_FLOW);
-                m_oldFlows.push_back(flow);
-                m_newFlows.pop_front();
-            }
-            else
-            {
-                flow->SetStatus(FqPieFlow::INACTIVE);
-                m_oldFlows.pop_front();
-            }
-        }
-        else
-        {
-            NS_LOG_DEBUG("Dequeued packet " << item->GetPacket());
-        }
-    } while (!item);
-
-    flow->IncreaseDeficit(item->GetSize() * -1);
-
-    return item;
+    return m_flowTable.Dequeue(m_quantum);
 }
 
 bool
@@ -511,6 +338,7 @@ FqPieQueueDisc::InitializeParams()
     NS_LOG_FUNCTION(this);
 
     m_flowFactory.SetTypeId("ns3::FqPieFlow");
+    m_flowTable.SetBuckets(m_flows, m_enableSetAssociativeHash ? m_setWays : 0);
 
     m_queueDiscFactory.SetTypeId("ns3::PieQueueDisc");
     m_queueDiscFactory.Set("MaxSize", QueueSizeValue(GetMaxSize()));
@@ -532,27 +360,14 @@ FqPieQueueDisc::FqPieDrop()
 {
     NS_LOG_FUNCTION(this);
 
-    uint32_t maxBacklog = 0;
-    uint32_t index = 0;
-    Ptr<QueueDisc> qd;
-
     /* Queue is full! Find the fat flow and drop packet(s) from it */
-    for (uint32_t i = 0; i < GetNQueueDiscClasses(); i++)
-    {
-        qd = GetQueueDiscClass(i)->GetQueueDisc();
-        uint32_t bytes = qd->GetNBytes();
-        if (bytes > maxBacklog)
-        {
-            maxBacklog = bytes;
-            index = i;
-        }
-    }
+    uint32_t index = m_flowTable.GetFatFlow();
+    QueueDisc* qd = m_flowTable.GetQueueDisc(index);
 
     /* Our goal is to drop half of this fat flow backlog */
     uint32_t len = 0;
     uint32_t count = 0;
-    uint32_t threshold = maxBacklog >> 1;
-    qd = GetQueueDiscClass(index)->GetQueueDisc();
+    uint32_t threshold = qd->GetNBytes() >> 1;
     Ptr<QueueDiscItem> item;
 
     do
@@ -385,6 +385,7 @@ QueueDisc::DoDispose()
     m_devQueueIface = nullptr;
     m_send = nullptr;
     m_requeued = nullptr;
+    m_gsoSegments.clear();
     m_internalQueueDbeFunctor = nullptr;
     m_internalQueueDadFunctor = nullptr;
     m_childQueueDiscDbeFunctor = nullptr;
@@ -1032,6 +1033,15 @@ QueueDisc::DequeuePacket()
             }
         }
     }
+    else if (!m_gsoSegments.empty())
+    {
+        // The next segment of a super-segment is kept in m_gsoSegments until it
+        // is sent to the device
+        if (!m_devQueueIface->GetTxQueue(m_gsoSegments.front()->GetTxQueueIndex())->IsStopped())
+        {
+            item = m_gsoSegments.front();
+        }
+    }
     else
     {
         // If the device is multi-queue (actually, Linux checks if the queue disc has
@@ -1043,8 +1053,25 @@ QueueDisc::DequeuePacket()
             !m_devQueueIface->GetTxQueue(0)->IsStopped())
         {
             item = Dequeue();
+            // If the item is a super-segment, the device queue interface splits
+            // it into the segments it carries, which are transmitted in order
+            // before dequeuing other packets
+            std::vector<Ptr<QueueDiscItem>> segments;
+            if (item && m_devQueueIface)
+            {
+                segments = m_devQueueIface->SplitGso(item);
+            }
+            if (!segments.empty())
+            {
+                for (auto& segment : segments)
+                {
+                    segment->AddHeader();
+                    m_gsoSegments.push_back(segment);
+                }
+                item = m_gsoSegments.front();
+            }
             // If the item is not null, add the header to the packet.
-            if (item)
+            else if (item)
             {
                 item->AddHeader();
             }
@@ -1076,9 +1103,14 @@ QueueDisc::Transmit(Ptr<QueueDiscItem> item)
     // if the device queue is stopped, requeue the packet and return false.
     // Note that if the underlying device is tc-unaware, packets are never
     // requeued because the queues of tc-unaware devices are never stopped
+    // A segment of a super-segment is not requeued, it stays in m_gsoSegments
+    bool gsoSegment = !m_gsoSegments.empty() && m_gsoSegments.front() == item;
     if (m_devQueueIface && m_devQueueIface->GetTxQueue(item->GetTxQueueIndex())->IsStopped())
     {
-        Requeue(item);
+        if (!gsoSegment)
+        {
+            Requeue(item);
+        }
         return false;
     }
 
@@ -1091,6 +1123,10 @@ QueueDisc::Transmit(Ptr<QueueDiscItem> item)
     }
     NS_ASSERT_MSG(m_send, "Send callback not set");
     m_send(item);
+    if (gsoSegment)
+    {
+        m_gsoSegments.pop_front();
+    }
 
     // the behavior here slightly diverges from Linux. In Linux, it is advised that
     // the function called when a packet needs to be transmitted (ndo_start_xmit)
@@ -1109,7 +1145,7 @@ QueueDisc::Transmit(Ptr<QueueDiscItem> item)
     // if the queue disc is empty or the device queue is now stopped, return false so
     // that the Run method does not attempt to dequeue other packets and exits
     return !(
-        GetNPackets() == 0 ||
+        (GetNPackets() == 0 && m_gsoSegments.empty()) ||
         (m_devQueueIface && m_devQueueIface->GetTxQueue(item->GetTxQueueIndex())->IsStopped()));
 }
 
@@ -28,6 +28,7 @@
 #include "ns3/traced-callback.h"
 #include "ns3/traced-value.h"
 
+#include <deque>
 #include <functional>
 #include <map>
 #include <string>
@@ -650,7 +651,11 @@ class QueueDisc : public Object
 
     /**
      * Modelled after the Linux function dequeue_skb (net/sched/sch_generic.c)
-     * \return the requeued packet, if any, or the packet dequeued by the queue disc, otherwise.
+     * A super-segment dequeued by the queue disc is split by the device queue
+     * interface (see NetDeviceQueueInterface::SplitGso) and its segments are
+     * returned one at a time by the following calls, as Linux does with gso_skb.
+     * \return the requeued packet, if any, the next segment of a super-segment, if any,
+     *         or the packet dequeued by the queue disc, otherwise.
      */
     Ptr<QueueDiscItem> DequeuePacket();
 
@@ -702,6 +707,7 @@ class QueueDisc : public Object
     SendCallback m_send;           //!< Callback used to send a packet to the receiving object
     bool m_running;                //!< The queue disc is performing multiple dequeue operations
     Ptr<QueueDiscItem> m_requeued; //!< The last packet that failed to be transmitted
+    std::deque<Ptr<QueueDiscItem>> m_gsoSegments; //!< Segments of a super-segment to transmit
     bool m_peeked;                 //!< A packet was dequeued because Peek was called
     std::string m_childQueueDiscDropMsg; //!< Reason why a packet was dropped by a child queue disc
     std::string m_childQueueDiscMarkMsg; //!< Reason why a packet was marked by a child queue disc
@@ -388,22 +388,36 @@ TrafficControlLayer::Send(Ptr<NetDevice> device, Ptr<QueueDiscItem> item)
 
     if (ndi == m_netDevices.end() || !ndi->second.m_rootQueueDisc)
     {
-        // The device has no attached queue disc, thus add the header to the packet and
-        // send it directly to the device if the selected queue is not stopped
-        item->AddHeader();
-        if (!devQueueIface || !devQueueIface->GetTxQueue(txq)->IsStopped())
+        // The device has no attached queue disc, thus split the packet if it is a
+        // super-segment, add the header to the packets and send them directly to
+        // the device if the selected queue is not stopped
+        item->SetTxQueueIndex(txq);
+        std::vector<Ptr<QueueDiscItem>> items;
+        if (devQueueIface)
         {
-            // a single queue device makes no use of the priority tag
-            if (!devQueueIface || devQueueIface->GetNTxQueues() == 1)
-            {
-                SocketPriorityTag priorityTag;
-                item->GetPacket()->RemovePacketTag(priorityTag);
-            }
-            device->Send(item->GetPacket(), item->GetAddress(), item->GetProtocol());
+            items = devQueueIface->SplitGso(item);
         }
-        else
+        if (items.empty())
         {
-            m_dropped(item->GetPacket());
+            items.push_back(item);
+        }
+        for (auto& toSend : items)
+        {
+            toSend->AddHeader();
+            if (!devQueueIface || !devQueueIface->GetTxQueue(txq)->IsStopped())
+            {
+                // a single queue device makes no use of the priority tag
+                if (!devQueueIface || devQueueIface->GetNTxQueues() == 1)
+                {
+                    SocketPriorityTag priorityTag;
+                    toSend->GetPacket()->RemovePacketTag(priorityTag);
+                }
+                device->Send(toSend->GetPacket(), toSend->GetAddress(), toSend->GetProtocol());
+            }
+            else
+            {
+                m_dropped(toSend->GetPacket());
+            }
         }
     }
     else
@@ -0,0 +1,190 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+
+#include <iostream>
+#include <limits>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Benchmark of the retransmission timers of a set of flows.
+ *
+ * Each flow receives an acknowledgment every Interval, which re-arms its
+ * retransmission timer to Rto; the timers never expire. The timers are
+ * either simulator events, cancelled and scheduled again by each
+ * acknowledgment, or the timers of a TimerWheel, re-armed in place.
+ */
+class Bench
+{
+  public:
+    /**
+     * Constructor
+     * \param [in] flows The number of flows.
+     * \param [in] interval The interval between the acknowledgments of a flow.
+     * \param [in] rto The retransmission timeout.
+     * \param [in] useWheel Whether to use a TimerWheel.
+     */
+    Bench(uint32_t flows, Time interval, Time rto, bool useWheel)
+        : m_flows(flows),
+          m_interval(interval),
+          m_rto(rto),
+          m_useWheel(useWheel),
+          m_nAcks(0),
+          m_nExpired(0)
+    {
+    }
+
+    /**
+     * Run the benchmark.
+     * \param [in] stop The simulation time of the run.
+     * \return The elapsed wall clock time, in ms.
+     */
+    uint64_t Run(Time stop)
+    {
+        m_events.resize(m_flows);
+        if (m_useWheel)
+        {
+            m_wheel = CreateObject<TimerWheel>();
+            for (uint32_t i = 0; i < m_flows; i++)
+            {
+                m_timers.push_back(m_wheel->CreateTimer(MakeCallback(&Bench::Expire, this)));
+            }
+        }
+        for (uint32_t i = 0; i < m_flows; i++)
+        {
+            // spread the acknowledgments of the flows over the interval
+            Simulator::Schedule(m_interval * i / m_flows, &Bench::Ack, this, i);
+        }
+        Simulator::Stop(stop);
+
+        SystemWallClockMs time;
+        time.Start();
+        Simulator::Run();
+        uint64_t elapsed = time.End();
+
+        if (m_wheel)
+        {
+            m_wheel->Dispose();
+            m_wheel = nullptr;
+        }
+        Simulator::Destroy();
+        return elapsed;
+    }
+
+    /** \return The number of acknowledgments processed. */
+    uint64_t GetNAcks() const
+    {
+        return m_nAcks;
+    }
+
+    /** \return The number of timers expired, which should be zero. */
+    uint64_t GetNExpired() const
+    {
+        return m_nExpired;
+    }
+
+  private:
+    /**
+     * Receive an acknowledgment and re-arm the timer of a flow.
+     * \param [in] flow The index of the flow.
+     */
+    void Ack(uint32_t flow)
+    {
+        m_nAcks++;
+        if (m_useWheel)
+        {
+            m_wheel->Schedule(m_timers[flow], m_rto);
+        }
+        else
+        {
+            m_events[flow].Cancel();
+            m_events[flow] = Simulator::Schedule(m_rto, &Bench::Expire, this);
+        }
+        Simulator::Schedule(m_interval, &Bench::Ack, this, flow);
+    }
+
+    /** Function invoked when a timer expires. */
+    void Expire()
+    {
+        m_nExpired++;
+    }
+
+    uint32_t m_flows;                          //!< Number of flows
+    Time m_interval;                           //!< Interval between the acknowledgments
+    Time m_rto;                                //!< Retransmission timeout
+    bool m_useWheel;                           //!< Whether to use a TimerWheel
+    uint64_t m_nAcks;                          //!< Number of acknowledgments
+    uint64_t m_nExpired;                       //!< Number of timers expired
+    std::vector<EventId> m_events;             //!< Timers as simulator events
+    Ptr<TimerWheel> m_wheel;                   //!< The timer wheel
+    std::vector<TimerWheel::TimerId> m_timers; //!< Timers of the wheel
+};
+
+/**
+ * Run the benchmark several times and report the minimum time.
+ * \param [in] flows The number of flows.
+ * \param [in] interval The interval between the acknowledgments of a flow.
+ * \param [in] rto The retransmission timeout.
+ * \param [in] stop The simulation time of a run.
+ * \param [in] iterations The number of runs.
+ * \param [in] useWheel Whether to use a TimerWheel.
+ */
+static void
+RunBench(uint32_t flows, Time interval, Time rto, Time stop, uint32_t iterations, bool useWheel)
+{
+    uint64_t minDelay = std::numeric_limits<uint64_t>::max();
+    uint64_t acks = 0;
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        Bench bench(flows, interval, rto, useWheel);
+        minDelay = std::min(minDelay, bench.Run(stop));
+        acks = bench.GetNAcks();
+        NS_ABORT_MSG_IF(bench.GetNExpired() != 0, "No timer should expire");
+    }
+    double rate = acks * 1000.0 / std::max<uint64_t>(minDelay, 1);
+    std::cout << rate << " acks/s"
+              << " (" << minDelay << " ms elapsed)\t" << (useWheel ? "TimerWheel" : "EventId")
+              << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t flows = 1000;
+    Time interval = MicroSeconds(100);
+    Time rto = MilliSeconds(200);
+    Time stop = Seconds(1);
+    uint32_t iterations = 3;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the re-arming of retransmission timers");
+    cmd.AddValue("flows", "number of flows", flows);
+    cmd.AddValue("interval", "interval between the acknowledgments of a flow", interval);
+    cmd.AddValue("rto", "retransmission timeout", rto);
+    cmd.AddValue("stop", "simulation time of a run", stop);
+    cmd.AddValue("iterations", "number of runs to minimize the time over", iterations);
+    cmd.Parse(argc, argv);
+
+    std::cout << "Running bench-timer-wheel with " << flows << " flows, an ack every "
+              << interval.As(Time::US) << " and rto " << rto.As(Time::MS) << std::endl;
+
+    RunBench(flows, interval, rto, stop, iterations, false);
+    RunBench(flows, interval, rto, stop, iterations, true);
+
+    return 0;
+}